@@ -0,0 +1,46 @@
+#include <zephyr.h>
+#include <string.h>
+
+#include "arena.h"
+
+void arena_init(struct arena *arena, void *buf, size_t size)
+{
+	memset(arena, 0, sizeof(*arena));
+	arena->buf = buf;
+	arena->size = size;
+}
+
+void *arena_alloc(struct arena *arena, size_t size)
+{
+	void *ptr;
+
+	size = ROUND_UP(size, ARENA_ALIGN);
+
+	if (size == 0 || size > arena->size - arena->used) {
+		arena->fail_count++;
+		return NULL;
+	}
+
+	ptr = &arena->buf[arena->used];
+	arena->used += size;
+	arena->alloc_count++;
+
+	if (arena->used > arena->hwm) {
+		arena->hwm = arena->used;
+	}
+
+	return ptr;
+}
+
+bool arena_owns(const struct arena *arena, const void *ptr)
+{
+	return (const uint8_t *)ptr >= arena->buf &&
+		(const uint8_t *)ptr < arena->buf + arena->size;
+}
+
+/* Releases every allocation at once. The high-water mark and counters are left for the
+ * caller to sample and clear. */
+void arena_reset(struct arena *arena)
+{
+	arena->used = 0;
+}
@@ -0,0 +1,38 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARENA_ALIGN 8
+
+struct arena {
+	uint8_t *buf;
+	size_t size;
+	size_t used;
+	size_t hwm;
+	uint32_t alloc_count;
+	uint32_t fail_count;
+};
+
+void arena_init(struct arena *arena, void *buf, size_t size);
+
+void *arena_alloc(struct arena *arena, size_t size);
+
+bool arena_owns(const struct arena *arena, const void *ptr);
+
+void arena_reset(struct arena *arena);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ARENA_H_ */
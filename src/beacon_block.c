@@ -0,0 +1,444 @@
+#include <zephyr.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+#include <logging/log.h>
+#include <settings/settings.h>
+
+#include "beacon_block.h"
+
+/* Blocked UUIDs are stored in pages of BLOCK_PAGE_LEN slots, each page one settings value
+ * "bblock/<page>":
+ *
+ *   format version, bitmap of the used slots, UUID of every used slot
+ *
+ * so that blocking a list of UUIDs rewrites a few values rather than one per UUID.
+ */
+#define BLOCK_VERSION 1
+#define BLOCK_SETTINGS_ROOT "bblock"
+#define BLOCK_KEY_LEN sizeof(BLOCK_SETTINGS_ROOT "/65535")
+#define BLOCK_PAGE_LEN 8
+#define BLOCK_PAGE_COUNT DIV_ROUND_UP(CONFIG_GATEWAY_BEACON_BLOCK_MAX, BLOCK_PAGE_LEN)
+#define BLOCK_VALUE_MAX (2 + BLOCK_PAGE_LEN * UUID_LEN)
+#define BLOCK_NONE UINT16_MAX
+#define HASH_SIZE CONFIG_GATEWAY_BEACON_BLOCK_MAX
+
+
+LOG_MODULE_REGISTER(app_beacon_block, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+/* Blocked UUIDs are found through a hash of the UUID, and kept in UUID order by an index
+ * array for listing */
+struct blocked {
+	uint8_t uuid[UUID_LEN];
+	bool used;
+	/* Next entry in the same hash bucket, or in the free list */
+	uint16_t next;
+};
+
+BUILD_ASSERT(CONFIG_GATEWAY_BEACON_BLOCK_MAX < BLOCK_NONE);
+
+K_MUTEX_DEFINE(block_lock);
+/* Orders the settings writes, so the last write of a page always stores its latest content.
+ * Taken before block_lock, never while holding it. */
+K_MUTEX_DEFINE(store_lock);
+
+static struct blocked entries[CONFIG_GATEWAY_BEACON_BLOCK_MAX];
+static uint16_t buckets[HASH_SIZE];
+static uint16_t sorted[CONFIG_GATEWAY_BEACON_BLOCK_MAX];
+/* Zero until the stored blocklist is loaded */
+static size_t count;
+static uint16_t free_head;
+/* Pages changed since they were last stored */
+static uint8_t dirty[DIV_ROUND_UP(BLOCK_PAGE_COUNT, 8)];
+
+static void block_key(size_t page, char key[BLOCK_KEY_LEN])
+{
+	snprintk(key, BLOCK_KEY_LEN, BLOCK_SETTINGS_ROOT "/%u", (unsigned int)page);
+}
+
+static uint32_t uuid_hash(const uint8_t uuid[UUID_LEN])
+{
+	return util_uuid_hash(uuid) % HASH_SIZE;
+}
+
+static uint16_t lookup(const uint8_t uuid[UUID_LEN])
+{
+	uint16_t idx;
+
+	if (count == 0) {
+		return BLOCK_NONE;
+	}
+
+	for (idx = buckets[uuid_hash(uuid)]; idx != BLOCK_NONE; idx = entries[idx].next) {
+		if (!util_uuid_cmp(entries[idx].uuid, uuid)) {
+			return idx;
+		}
+	}
+
+	return BLOCK_NONE;
+}
+
+/* Position of uuid in sorted, or where it would be inserted */
+static size_t sorted_search(const uint8_t uuid[UUID_LEN])
+{
+	bool found;
+
+	return util_uuid_search(entries[0].uuid, sizeof(entries[0]), sorted, count, uuid, &found);
+}
+
+static void index_add(uint16_t idx)
+{
+	size_t pos;
+	uint32_t bucket;
+
+	bucket = uuid_hash(entries[idx].uuid);
+	entries[idx].next = buckets[bucket];
+	buckets[bucket] = idx;
+
+	pos = sorted_search(entries[idx].uuid);
+	memmove(&sorted[pos + 1], &sorted[pos], (count - pos) * sizeof(sorted[0]));
+	sorted[pos] = idx;
+	count++;
+}
+
+static void mark_dirty(uint16_t idx)
+{
+	size_t page;
+
+	page = idx / BLOCK_PAGE_LEN;
+	dirty[page / 8] |= BIT(page % 8);
+}
+
+/* Rebuilds the hash buckets, the sorted index and the free list from the used entries */
+static void index_build(void)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(buckets); i++) {
+		buckets[i] = BLOCK_NONE;
+	}
+
+	count = 0;
+	free_head = BLOCK_NONE;
+
+	for (i = ARRAY_SIZE(entries); i-- > 0;) {
+		if (entries[i].used && lookup(entries[i].uuid) != BLOCK_NONE) {
+			/* Stored twice, the page is rewritten without it on the next change */
+			entries[i].used = false;
+			mark_dirty(i);
+		}
+
+		if (entries[i].used) {
+			index_add(i);
+		} else {
+			entries[i].next = free_head;
+			free_head = i;
+		}
+	}
+}
+
+static int insert(const uint8_t uuid[UUID_LEN])
+{
+	uint16_t idx;
+
+	if (free_head == BLOCK_NONE) {
+		return -ENOMEM;
+	}
+
+	idx = free_head;
+	free_head = entries[idx].next;
+
+	memcpy(entries[idx].uuid, uuid, UUID_LEN);
+	entries[idx].used = true;
+	index_add(idx);
+	mark_dirty(idx);
+
+	return 0;
+}
+
+static void erase(uint16_t idx)
+{
+	size_t pos;
+	uint16_t *next;
+
+	next = &buckets[uuid_hash(entries[idx].uuid)];
+
+	while (*next != idx) {
+		next = &entries[*next].next;
+	}
+
+	*next = entries[idx].next;
+
+	pos = sorted_search(entries[idx].uuid);
+	memmove(&sorted[pos], &sorted[pos + 1], (count - pos - 1) * sizeof(sorted[0]));
+	count--;
+
+	entries[idx].used = false;
+	entries[idx].next = free_head;
+	free_head = idx;
+	mark_dirty(idx);
+}
+
+/* Encodes the used slots of page, called with block_lock held. Returns the slot bitmap. */
+static uint8_t page_encode(size_t page, struct net_buf_simple *buf)
+{
+	size_t i;
+	uint8_t *bitmap;
+
+	net_buf_simple_reset(buf);
+	net_buf_simple_add_u8(buf, BLOCK_VERSION);
+	bitmap = net_buf_simple_add(buf, 1);
+	*bitmap = 0;
+
+	for (i = 0; i < BLOCK_PAGE_LEN && page * BLOCK_PAGE_LEN + i < ARRAY_SIZE(entries); i++) {
+		if (entries[page * BLOCK_PAGE_LEN + i].used) {
+			*bitmap |= BIT(i);
+			net_buf_simple_add_mem(buf, entries[page * BLOCK_PAGE_LEN + i].uuid, UUID_LEN);
+		}
+	}
+
+	return *bitmap;
+}
+
+/* Writes the dirty pages. Each page is copied under block_lock and written without it, so
+ * lookups from the scanner do not wait for flash. */
+static int store(void)
+{
+	int err;
+	int ret;
+	size_t page;
+	bool pending;
+	uint8_t bitmap;
+	char key[BLOCK_KEY_LEN];
+
+	NET_BUF_SIMPLE_DEFINE(buf, BLOCK_VALUE_MAX);
+
+	ret = 0;
+	k_mutex_lock(&store_lock, K_FOREVER);
+
+	for (page = 0; page < BLOCK_PAGE_COUNT; page++) {
+		k_mutex_lock(&block_lock, K_FOREVER);
+		pending = dirty[page / 8] & BIT(page % 8);
+
+		if (pending) {
+			dirty[page / 8] &= ~BIT(page % 8);
+			bitmap = page_encode(page, &buf);
+		}
+
+		k_mutex_unlock(&block_lock);
+
+		if (!pending) {
+			continue;
+		}
+
+		block_key(page, key);
+
+		if (bitmap) {
+			err = settings_save_one(key, buf.data, buf.len);
+		} else {
+			err = settings_delete(key);
+		}
+
+		if (err) {
+			LOG_ERR("Failed to store blocklist page %u: %d", (unsigned int)page, err);
+			ret = ret ? ret : err;
+
+			/* Tried again on the next change */
+			k_mutex_lock(&block_lock, K_FOREVER);
+			dirty[page / 8] |= BIT(page % 8);
+			k_mutex_unlock(&block_lock);
+		}
+	}
+
+	k_mutex_unlock(&store_lock);
+
+	return ret;
+}
+
+int beacon_block_update(const uint8_t (*uuids)[UUID_LEN], size_t uuid_count, bool block,
+		size_t *changed)
+{
+	int err;
+	int ret;
+	size_t i;
+	uint16_t idx;
+
+	err = 0;
+	*changed = 0;
+
+	k_mutex_lock(&block_lock, K_FOREVER);
+
+	for (i = 0; i < uuid_count; i++) {
+		idx = lookup(uuids[i]);
+
+		if (block && idx == BLOCK_NONE) {
+			err = insert(uuids[i]);
+
+			if (err) {
+				break;
+			}
+		} else if (!block && idx != BLOCK_NONE) {
+			erase(idx);
+		} else {
+			continue;
+		}
+
+		(*changed)++;
+	}
+
+	k_mutex_unlock(&block_lock);
+	ret = store();
+
+	return err ? err : ret;
+}
+
+int beacon_block_add(const uint8_t uuid[UUID_LEN])
+{
+	int err;
+	size_t changed;
+
+	err = beacon_block_update((const uint8_t (*)[UUID_LEN])uuid, 1, true, &changed);
+
+	if (!err && !changed) {
+		return -EALREADY;
+	}
+
+	return err;
+}
+
+int beacon_block_remove(const uint8_t uuid[UUID_LEN])
+{
+	int err;
+	size_t changed;
+
+	err = beacon_block_update((const uint8_t (*)[UUID_LEN])uuid, 1, false, &changed);
+
+	if (!err && !changed) {
+		return -ENOENT;
+	}
+
+	return err;
+}
+
+bool beacon_block_contains(const uint8_t uuid[UUID_LEN])
+{
+	bool ret;
+
+	k_mutex_lock(&block_lock, K_FOREVER);
+	ret = lookup(uuid) != BLOCK_NONE;
+	k_mutex_unlock(&block_lock);
+
+	return ret;
+}
+
+int beacon_block_get(size_t idx, uint8_t uuid[UUID_LEN])
+{
+	int err;
+
+	k_mutex_lock(&block_lock, K_FOREVER);
+	err = idx < count ? 0 : -ENOENT;
+
+	if (!err) {
+		memcpy(uuid, entries[sorted[idx]].uuid, UUID_LEN);
+	}
+
+	k_mutex_unlock(&block_lock);
+
+	return err;
+}
+
+void beacon_block_init(void)
+{
+	k_mutex_lock(&block_lock, K_FOREVER);
+	index_build();
+	k_mutex_unlock(&block_lock);
+}
+
+size_t beacon_block_count(void)
+{
+	size_t ret;
+
+	k_mutex_lock(&block_lock, K_FOREVER);
+	ret = count;
+	k_mutex_unlock(&block_lock);
+
+	return ret;
+}
+
+static int block_set(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+	char *end;
+	size_t i;
+	size_t slot;
+	unsigned long page;
+	ssize_t read_len;
+	uint8_t bitmap;
+
+	NET_BUF_SIMPLE_DEFINE(buf, BLOCK_VALUE_MAX);
+
+	page = strtoul(key, &end, 10);
+
+	if (*end != '\0' || page >= BLOCK_PAGE_COUNT) {
+		return -ENOENT;
+	}
+
+	for (i = 0; i < BLOCK_PAGE_LEN && page * BLOCK_PAGE_LEN + i < ARRAY_SIZE(entries); i++) {
+		entries[page * BLOCK_PAGE_LEN + i].used = false;
+	}
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if (len > BLOCK_VALUE_MAX) {
+		return -EINVAL;
+	}
+
+	read_len = read_cb(cb_arg, net_buf_simple_add(&buf, len), len);
+
+	if (read_len < 0) {
+		return read_len;
+	}
+
+	if (read_len != len || len < 2 || net_buf_simple_pull_u8(&buf) != BLOCK_VERSION) {
+		return -EINVAL;
+	}
+
+	bitmap = net_buf_simple_pull_u8(&buf);
+
+	if (buf.len != __builtin_popcount(bitmap) * UUID_LEN) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < BLOCK_PAGE_LEN; i++) {
+		if (!(bitmap & BIT(i))) {
+			continue;
+		}
+
+		slot = page * BLOCK_PAGE_LEN + i;
+
+		if (slot >= ARRAY_SIZE(entries)) {
+			return -EINVAL;
+		}
+
+		memcpy(entries[slot].uuid, net_buf_simple_pull_mem(&buf, UUID_LEN), UUID_LEN);
+		entries[slot].used = true;
+	}
+
+	return 0;
+}
+
+/* Builds the index from the loaded entries */
+static int block_commit(void)
+{
+	k_mutex_lock(&block_lock, K_FOREVER);
+	index_build();
+	k_mutex_unlock(&block_lock);
+
+	LOG_INF("%u blocked beacons", (unsigned int)count);
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(beacon_block, BLOCK_SETTINGS_ROOT, NULL, block_set,
+		block_commit, NULL);
@@ -0,0 +1,43 @@
+#ifndef BEACON_BLOCK_H_
+#define BEACON_BLOCK_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util.h"
+
+/* Block or unblock a list of UUIDs, storing the change once for the whole list. UUIDs that
+ * are already blocked, or not blocked, are skipped, changed is the number of UUIDs that were
+ * not. Stops with -ENOMEM when the blocklist is full. */
+int beacon_block_update(const uint8_t (*uuids)[UUID_LEN], size_t uuid_count, bool block,
+		size_t *changed);
+
+/* Returns -EALREADY if the UUID is blocked and -ENOMEM if the blocklist is full */
+int beacon_block_add(const uint8_t uuid[UUID_LEN]);
+
+/* Returns -ENOENT if the UUID is not blocked */
+int beacon_block_remove(const uint8_t uuid[UUID_LEN]);
+
+bool beacon_block_contains(const uint8_t uuid[UUID_LEN]);
+
+/* Blocked UUIDs in order. Returns -ENOENT past the last one. */
+int beacon_block_get(size_t idx, uint8_t uuid[UUID_LEN]);
+
+size_t beacon_block_count(void);
+
+/* Empty blocklist until the stored one is loaded by settings_load() */
+void beacon_block_init(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* BEACON_BLOCK_H_ */
@@ -0,0 +1,115 @@
+#include <zephyr.h>
+#include <string.h>
+
+#include "beacon_events.h"
+#include "gateway.h"
+
+/* Changes are sent at most once per CONFIG_GATEWAY_BEACON_EVENTS_INTERVAL_MS. The first
+ * change after a quiet interval goes out at once, changes in a burst are collected into the
+ * next batch. A beacon that is lost before its found event was sent, or found again before
+ * its lost event was sent, is not reported at all. */
+
+K_MUTEX_DEFINE(events_lock);
+
+static struct beacon_event pending[CONFIG_GATEWAY_BEACON_EVENTS_BATCH];
+static size_t pending_count;
+static bool pending_overflow;
+static bool enabled;
+static int64_t last_sent = -CONFIG_GATEWAY_BEACON_EVENTS_INTERVAL_MS;
+
+static void batch_send(struct k_work *work)
+{
+	k_mutex_lock(&events_lock, K_FOREVER);
+	last_sent = k_uptime_get();
+	k_mutex_unlock(&events_lock);
+
+	gateway_beacon_events();
+}
+
+K_WORK_DELAYABLE_DEFINE(send_work, batch_send);
+
+static void add(const struct beacon_info *beacon, bool found)
+{
+	size_t i;
+	int64_t delay;
+
+	k_mutex_lock(&events_lock, K_FOREVER);
+
+	if (!enabled) {
+		k_mutex_unlock(&events_lock);
+		return;
+	}
+
+	/* A beacon is never waiting twice, so a waiting change is the opposite one */
+	for (i = 0; i < pending_count; i++) {
+		if (!util_uuid_cmp(pending[i].beacon.uuid, beacon->uuid)) {
+			memmove(&pending[i], &pending[i + 1],
+					(pending_count - i - 1) * sizeof(pending[0]));
+			pending_count--;
+			k_mutex_unlock(&events_lock);
+			return;
+		}
+	}
+
+	if (pending_count == ARRAY_SIZE(pending)) {
+		pending_overflow = true;
+	} else {
+		pending[pending_count].beacon = *beacon;
+		pending[pending_count].found = found;
+		pending_count++;
+	}
+
+	delay = last_sent + CONFIG_GATEWAY_BEACON_EVENTS_INTERVAL_MS - k_uptime_get();
+
+	/* Does nothing if the batch is already scheduled */
+	k_work_schedule(&send_work, K_MSEC(MAX(delay, 0)));
+
+	k_mutex_unlock(&events_lock);
+}
+
+void beacon_events_enable(bool enable)
+{
+	k_mutex_lock(&events_lock, K_FOREVER);
+
+	enabled = enable;
+
+	if (!enable) {
+		pending_count = 0;
+		pending_overflow = false;
+	}
+
+	k_mutex_unlock(&events_lock);
+}
+
+void beacon_events_found(const struct beacon_info *beacon)
+{
+	add(beacon, true);
+}
+
+void beacon_events_lost(const uint8_t uuid[UUID_LEN])
+{
+	struct beacon_info beacon;
+
+	memset(&beacon, 0, sizeof(beacon));
+	memcpy(beacon.uuid, uuid, UUID_LEN);
+
+	add(&beacon, false);
+}
+
+size_t beacon_events_take(struct beacon_event *events, bool *overflow)
+{
+	size_t count;
+
+	k_mutex_lock(&events_lock, K_FOREVER);
+
+	count = pending_count;
+	memcpy(events, pending, count * sizeof(pending[0]));
+	*overflow = pending_overflow;
+
+	pending_count = 0;
+	pending_overflow = false;
+
+	k_mutex_unlock(&events_lock);
+
+	return count;
+}
@@ -0,0 +1,42 @@
+#ifndef BEACON_EVENTS_H_
+#define BEACON_EVENTS_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "beacon_table.h"
+#include "util.h"
+
+struct beacon_event {
+	struct beacon_info beacon;
+	/* Lost beacons only carry the UUID */
+	bool found;
+};
+
+/* Events are off until the cloud turns them on. Turning them off drops the changes that are
+ * waiting. */
+void beacon_events_enable(bool enable);
+
+/* Called by the beacon table for every beacon it lists and every beacon that expires */
+void beacon_events_found(const struct beacon_info *beacon);
+
+void beacon_events_lost(const uint8_t uuid[UUID_LEN]);
+
+/* Take the changes since the last batch, at most CONFIG_GATEWAY_BEACON_EVENTS_BATCH.
+ * overflow is set if changes were dropped since the last batch, in which case only the
+ * beacon list is complete. */
+size_t beacon_events_take(struct beacon_event *events, bool *overflow);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* BEACON_EVENTS_H_ */
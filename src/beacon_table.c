@@ -0,0 +1,270 @@
+#include <zephyr.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+
+#if defined(CONFIG_GATEWAY_BEACON_EVENTS)
+#include "beacon_events.h"
+#endif // defined(CONFIG_GATEWAY_BEACON_EVENTS)
+#include "beacon_table.h"
+
+/* One second more than the zephyr defined unprovisioned device beacon period */
+#define BEACON_TIMEOUT_MS 6000
+#define BEACON_NONE UINT16_MAX
+#define HASH_SIZE CONFIG_GATEWAY_BEACON_MAX
+
+
+/* Beacons are found through a hash of their UUID, kept in UUID order by an index array for
+ * listing, and expire in the order they were last seen. As every beacon has the same
+ * timeout, that order is kept by moving a refreshed beacon to the end of one list, and a
+ * single delayed work item removes beacons from the front as they expire. */
+struct beacon {
+	uint8_t uuid[UUID_LEN];
+	bt_mesh_prov_oob_info_t oob_info;
+	bool uri_hash_set;
+	uint32_t uri_hash;
+	int64_t expiry;
+	/* Next beacon in the same hash bucket, or in the free list */
+	uint16_t hash_next;
+	/* Neighbours in order of expiry */
+	uint16_t prev;
+	uint16_t next;
+};
+
+BUILD_ASSERT(CONFIG_GATEWAY_BEACON_MAX < BEACON_NONE);
+
+K_MUTEX_DEFINE(beacon_lock);
+
+static struct beacon beacons[CONFIG_GATEWAY_BEACON_MAX];
+static uint16_t buckets[HASH_SIZE];
+static uint16_t sorted[CONFIG_GATEWAY_BEACON_MAX];
+static size_t count;
+static uint16_t free_head;
+static uint16_t expiry_head;
+static uint16_t expiry_tail;
+
+static uint32_t uuid_hash(const uint8_t uuid[UUID_LEN])
+{
+	return util_uuid_hash(uuid) % HASH_SIZE;
+}
+
+static uint16_t lookup(const uint8_t uuid[UUID_LEN])
+{
+	uint16_t idx;
+
+	for (idx = buckets[uuid_hash(uuid)]; idx != BEACON_NONE; idx = beacons[idx].hash_next) {
+		if (!util_uuid_cmp(beacons[idx].uuid, uuid)) {
+			return idx;
+		}
+	}
+
+	return BEACON_NONE;
+}
+
+/* Position of uuid in sorted, or where it would be inserted */
+static size_t sorted_search(const uint8_t uuid[UUID_LEN], bool *found)
+{
+	return util_uuid_search(beacons[0].uuid, sizeof(beacons[0]), sorted, count, uuid, found);
+}
+
+static void expiry_unlink(uint16_t idx)
+{
+	if (beacons[idx].prev == BEACON_NONE) {
+		expiry_head = beacons[idx].next;
+	} else {
+		beacons[beacons[idx].prev].next = beacons[idx].next;
+	}
+
+	if (beacons[idx].next == BEACON_NONE) {
+		expiry_tail = beacons[idx].prev;
+	} else {
+		beacons[beacons[idx].next].prev = beacons[idx].prev;
+	}
+}
+
+static void expiry_append(uint16_t idx)
+{
+	beacons[idx].prev = expiry_tail;
+	beacons[idx].next = BEACON_NONE;
+
+	if (expiry_tail == BEACON_NONE) {
+		expiry_head = idx;
+	} else {
+		beacons[expiry_tail].next = idx;
+	}
+
+	expiry_tail = idx;
+}
+
+static void beacon_remove(uint16_t idx)
+{
+	bool found;
+	size_t pos;
+	uint16_t *link;
+
+	link = &buckets[uuid_hash(beacons[idx].uuid)];
+
+	while (*link != idx) {
+		link = &beacons[*link].hash_next;
+	}
+
+	*link = beacons[idx].hash_next;
+	expiry_unlink(idx);
+
+	pos = sorted_search(beacons[idx].uuid, &found);
+	memmove(&sorted[pos], &sorted[pos + 1], (count - pos - 1) * sizeof(sorted[0]));
+	count--;
+
+	beacons[idx].hash_next = free_head;
+	free_head = idx;
+
+#if defined(CONFIG_GATEWAY_BEACON_EVENTS)
+	beacon_events_lost(beacons[idx].uuid);
+#endif // defined(CONFIG_GATEWAY_BEACON_EVENTS)
+}
+
+static void expire(struct k_work *work)
+{
+	int64_t now;
+
+	now = k_uptime_get();
+	k_mutex_lock(&beacon_lock, K_FOREVER);
+
+	while (expiry_head != BEACON_NONE && beacons[expiry_head].expiry <= now) {
+		beacon_remove(expiry_head);
+	}
+
+	if (expiry_head != BEACON_NONE) {
+		k_work_reschedule(k_work_delayable_from_work(work),
+				K_MSEC(beacons[expiry_head].expiry - now));
+	}
+
+	k_mutex_unlock(&beacon_lock);
+}
+
+K_WORK_DELAYABLE_DEFINE(expire_work, expire);
+
+int beacon_table_seen(const uint8_t uuid[UUID_LEN], bt_mesh_prov_oob_info_t oob_info,
+		const uint32_t *uri_hash)
+{
+	bool found;
+	size_t pos;
+	uint16_t idx;
+	uint32_t bucket;
+	struct beacon *beacon;
+#if defined(CONFIG_GATEWAY_BEACON_EVENTS)
+	struct beacon_info info;
+#endif // defined(CONFIG_GATEWAY_BEACON_EVENTS)
+
+	k_mutex_lock(&beacon_lock, K_FOREVER);
+	idx = lookup(uuid);
+
+	if (idx != BEACON_NONE) {
+		beacons[idx].expiry = k_uptime_get() + BEACON_TIMEOUT_MS;
+		expiry_unlink(idx);
+		expiry_append(idx);
+		k_mutex_unlock(&beacon_lock);
+		return -EALREADY;
+	}
+
+	if (free_head == BEACON_NONE) {
+		k_mutex_unlock(&beacon_lock);
+		return -ENOMEM;
+	}
+
+	idx = free_head;
+	beacon = &beacons[idx];
+	free_head = beacon->hash_next;
+
+	memcpy(beacon->uuid, uuid, UUID_LEN);
+	beacon->oob_info = oob_info;
+	beacon->uri_hash_set = uri_hash != NULL;
+	beacon->uri_hash = uri_hash != NULL ? *uri_hash : 0;
+	beacon->expiry = k_uptime_get() + BEACON_TIMEOUT_MS;
+
+	bucket = uuid_hash(uuid);
+	beacon->hash_next = buckets[bucket];
+	buckets[bucket] = idx;
+	expiry_append(idx);
+
+	pos = sorted_search(uuid, &found);
+	memmove(&sorted[pos + 1], &sorted[pos], (count - pos) * sizeof(sorted[0]));
+	sorted[pos] = idx;
+
+	/* The expiry work keeps itself scheduled until the table is empty again */
+	if (count++ == 0) {
+		k_work_reschedule(&expire_work, K_MSEC(BEACON_TIMEOUT_MS));
+	}
+
+#if defined(CONFIG_GATEWAY_BEACON_EVENTS)
+	memcpy(info.uuid, uuid, UUID_LEN);
+	info.oob_info = beacon->oob_info;
+	info.uri_hash_set = beacon->uri_hash_set;
+	info.uri_hash = beacon->uri_hash;
+	beacon_events_found(&info);
+#endif // defined(CONFIG_GATEWAY_BEACON_EVENTS)
+
+	k_mutex_unlock(&beacon_lock);
+
+	return 0;
+}
+
+bool beacon_table_contains(const uint8_t uuid[UUID_LEN])
+{
+	bool ret;
+
+	k_mutex_lock(&beacon_lock, K_FOREVER);
+	ret = lookup(uuid) != BEACON_NONE;
+	k_mutex_unlock(&beacon_lock);
+
+	return ret;
+}
+
+int beacon_table_get(size_t idx, struct beacon_info *info)
+{
+	struct beacon *beacon;
+
+	k_mutex_lock(&beacon_lock, K_FOREVER);
+
+	if (idx >= count) {
+		k_mutex_unlock(&beacon_lock);
+		return -ENOENT;
+	}
+
+	beacon = &beacons[sorted[idx]];
+	memcpy(info->uuid, beacon->uuid, UUID_LEN);
+	info->oob_info = beacon->oob_info;
+	info->uri_hash_set = beacon->uri_hash_set;
+	info->uri_hash = beacon->uri_hash;
+
+	k_mutex_unlock(&beacon_lock);
+
+	return 0;
+}
+
+size_t beacon_table_count(void)
+{
+	size_t ret;
+
+	k_mutex_lock(&beacon_lock, K_FOREVER);
+	ret = count;
+	k_mutex_unlock(&beacon_lock);
+
+	return ret;
+}
+
+void beacon_table_init(void)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(buckets); i++) {
+		buckets[i] = BEACON_NONE;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(beacons); i++) {
+		beacons[i].hash_next = i + 1 < ARRAY_SIZE(beacons) ? i + 1 : BEACON_NONE;
+	}
+
+	free_head = 0;
+	expiry_head = BEACON_NONE;
+	expiry_tail = BEACON_NONE;
+}
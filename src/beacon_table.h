@@ -0,0 +1,43 @@
+#ifndef BEACON_TABLE_H_
+#define BEACON_TABLE_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <bluetooth/mesh.h>
+
+#include "util.h"
+
+struct beacon_info {
+	uint8_t uuid[UUID_LEN];
+	bt_mesh_prov_oob_info_t oob_info;
+	bool uri_hash_set;
+	uint32_t uri_hash;
+};
+
+/* Add an unprovisioned beacon, or keep a listed one from expiring. Returns -EALREADY if the
+ * beacon was listed and -ENOMEM if the table is full. */
+int beacon_table_seen(const uint8_t uuid[UUID_LEN], bt_mesh_prov_oob_info_t oob_info,
+		const uint32_t *uri_hash);
+
+bool beacon_table_contains(const uint8_t uuid[UUID_LEN]);
+
+/* Listed beacons in order of UUID. Returns -ENOENT past the last one. */
+int beacon_table_get(size_t idx, struct beacon_info *info);
+
+size_t beacon_table_count(void);
+
+void beacon_table_init(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* BEACON_TABLE_H_ */
@@ -11,23 +11,51 @@
 #include "mesh/net.h"
 #include "mesh/access.h"
 
+#include "arena.h"
+#include "beacon_block.h"
+#include "beacon_table.h"
 #include "btmesh.h"
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+#include "cfg_async.h"
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
 #include "gateway.h"
+#include "mesh_retry.h"
+#if defined(CONFIG_GATEWAY_NODE_CACHE)
+#include "node_cache.h"
+#endif // defined(CONFIG_GATEWAY_NODE_CACHE)
+#if defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+#include "prov_allow.h"
+#endif // defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
 #ifdef CONFIG_SHELL
 #include "cli.h"
 #endif
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+#include "rx_bus.h"
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+#if defined(CONFIG_GATEWAY_UPLINK_RULES)
+#include "uplink_rules.h"
+#endif // defined(CONFIG_GATEWAY_UPLINK_RULES)
 #include "util.h"
 
 
 LOG_MODULE_REGISTER(app_btmesh, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
 
 
-#define BEACON_TIMEOUT_DURATION K_SECONDS(6) /* One second more than the zephyr defined unprovisioned device beacon period */
-#define MAX_BEACON 32
-#define BEACON_BLOCKED_SIZE 32
 #define COMP_DATA_PAGE 0x00
-#define COMP_DATA_BUF_SIZE 64
-#define MESH_RETRY_COUNT 3
+/* Largest Composition Data page the node can send: 12 bytes per received segment, less the
+ * TransMIC, the opcode and the page number of the status message */
+#define COMP_DATA_BUF_SIZE ((CONFIG_BT_MESH_RX_SEG_MAX * 12) - 4 - 2)
+
+/* Configuration gets and sets go through the asynchronous client when the access layer hook
+ * is available, so requests to different nodes do not have to wait for each other and each
+ * request gets the timeout of its node. */
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+#define CFG_GET(fn) cfg_async_##fn
+#define CFG_SET(fn) cfg_async_##fn
+#else
+#define CFG_GET(fn) bt_mesh_cfg_##fn
+#define CFG_SET(fn) bt_mesh_cfg_##fn
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
 #define PERIOD_PUB_100MS_STR "100ms"
 #define PERIOD_PUB_1S_STR "1s"
 #define PERIOD_PUB_10S_STR "10s"
@@ -471,307 +499,210 @@ const char *btmesh_get_sig_model_str(uint16_t model_id)
         }
 }
 
-static uint16_t cli_sub_list[CONFIG_BT_MESH_GATEWAY_SUB_LIST_LEN];
-static uint16_t gateway_sub_list[CONFIG_BT_MESH_GATEWAY_SUB_LIST_LEN];
-
-int btmesh_subscribe(enum btmesh_sub_type type, uint16_t addr)
-{
-        int i;
-        uint16_t *sub_list;
-
-        if (type == BTMESH_SUB_TYPE_CLI) {
-                sub_list = cli_sub_list;
-        } else if (type == BTMESH_SUB_TYPE_GATEWAY) {
-                sub_list = gateway_sub_list;
-        } else {
-                return -EINVAL;
-        }
-
-        for (i = 0; i < CONFIG_BT_MESH_GATEWAY_SUB_LIST_LEN; i++) {
-                if (sub_list[i] == addr) {
-                        return 0;
-                }
-
-                if (sub_list[i] == BT_MESH_ADDR_UNASSIGNED) {
-                        sub_list[i] = addr;
-                        return 0;
-                }
-        }
-
-        return -ENOMEM;
-}
-
-void btmesh_unsubscribe(enum btmesh_sub_type type, uint16_t addr)
-{
-        int i;
-        uint16_t *sub_list;
-
-        if (type == BTMESH_SUB_TYPE_CLI) {
-                sub_list = cli_sub_list;
-        } else if (type == BTMESH_SUB_TYPE_GATEWAY) {
-                sub_list = gateway_sub_list;
-        } else {
-                return;
-        }
-
-        for (i = 0; i < CONFIG_BT_MESH_GATEWAY_SUB_LIST_LEN; i++) {
-                if (sub_list[i] == addr) {
-                        sub_list[i] = BT_MESH_ADDR_UNASSIGNED;
-                }
-        }
-}
-
-const uint16_t *btmesh_get_subscribe_list(enum btmesh_sub_type type)
-{
-        if (type == BTMESH_SUB_TYPE_CLI) {
-                 return cli_sub_list;
-        } else if (type == BTMESH_SUB_TYPE_GATEWAY) {
-                return gateway_sub_list;
-        } else {
-                return NULL;
-        }
-}
-
-struct beacon {
-        uint8_t uuid[UUID_LEN];
-        char uuid_str[UUID_STR_LEN];
-        bt_mesh_prov_oob_info_t oob_info;
-        uint32_t uri_hash;
-        struct k_timer *timer;
+static const char *const op_str[] = {
+        [BTMESH_OP_PROV_ADV] = "prov_adv",
+        [BTMESH_OP_NODE_RESET] = "node_reset",
+        [BTMESH_OP_COMP_GET] = "comp_get",
+        [BTMESH_OP_BEACON_GET] = "beacon_get",
+        [BTMESH_OP_BEACON_SET] = "beacon_set",
+        [BTMESH_OP_TTL_GET] = "ttl_get",
+        [BTMESH_OP_TTL_SET] = "ttl_set",
+        [BTMESH_OP_FRIEND_GET] = "friend_get",
+        [BTMESH_OP_FRIEND_SET] = "friend_set",
+        [BTMESH_OP_PROXY_GET] = "proxy_get",
+        [BTMESH_OP_PROXY_SET] = "proxy_set",
+        [BTMESH_OP_RELAY_GET] = "relay_get",
+        [BTMESH_OP_RELAY_SET] = "relay_set",
+        [BTMESH_OP_NET_KEY_ADD] = "net_key_add",
+        [BTMESH_OP_NET_KEY_GET] = "net_key_get",
+        [BTMESH_OP_NET_KEY_DEL] = "net_key_del",
+        [BTMESH_OP_APP_KEY_ADD] = "app_key_add",
+        [BTMESH_OP_APP_KEY_GET] = "app_key_get",
+        [BTMESH_OP_APP_KEY_DEL] = "app_key_del",
+        [BTMESH_OP_MOD_APP_BIND] = "mod_app_bind",
+        [BTMESH_OP_MOD_APP_BIND_VND] = "mod_app_bind_vnd",
+        [BTMESH_OP_MOD_APP_UNBIND] = "mod_app_unbind",
+        [BTMESH_OP_MOD_APP_UNBIND_VND] = "mod_app_unbind_vnd",
+        [BTMESH_OP_MOD_APP_GET] = "mod_app_get",
+        [BTMESH_OP_MOD_APP_GET_VND] = "mod_app_get_vnd",
+        [BTMESH_OP_MOD_PUB_GET] = "mod_pub_get",
+        [BTMESH_OP_MOD_PUB_GET_VND] = "mod_pub_get_vnd",
+        [BTMESH_OP_MOD_PUB_SET] = "mod_pub_set",
+        [BTMESH_OP_MOD_PUB_SET_VND] = "mod_pub_set_vnd",
+        [BTMESH_OP_MOD_SUB_ADD] = "mod_sub_add",
+        [BTMESH_OP_MOD_SUB_ADD_VND] = "mod_sub_add_vnd",
+        [BTMESH_OP_MOD_SUB_DEL] = "mod_sub_del",
+        [BTMESH_OP_MOD_SUB_DEL_VND] = "mod_sub_del_vnd",
+        [BTMESH_OP_MOD_SUB_OVRW] = "mod_sub_ovrw",
+        [BTMESH_OP_MOD_SUB_OVRW_VND] = "mod_sub_ovrw_vnd",
+        [BTMESH_OP_MOD_SUB_GET] = "mod_sub_get",
+        [BTMESH_OP_MOD_SUB_GET_VND] = "mod_sub_get_vnd",
+        [BTMESH_OP_HLTH_FAULT_GET] = "hlth_fault_get",
+        [BTMESH_OP_HLTH_FAULT_CLR] = "hlth_fault_clr",
+        [BTMESH_OP_HLTH_FAULT_TEST] = "hlth_fault_test",
+        [BTMESH_OP_HLTH_PERIOD_GET] = "hlth_period_get",
+        [BTMESH_OP_HLTH_PERIOD_SET] = "hlth_period_set",
+        [BTMESH_OP_HLTH_ATTN_GET] = "hlth_attn_get",
+        [BTMESH_OP_HLTH_ATTN_SET] = "hlth_attn_set",
+        [BTMESH_OP_HLTH_TIMEOUT_GET] = "hlth_timeout_get",
+        [BTMESH_OP_HLTH_TIMEOUT_SET] = "hlth_timeout_set",
+        [BTMESH_OP_HB_SUB_GET] = "hb_sub_get",
+        [BTMESH_OP_HB_SUB_SET] = "hb_sub_set",
+        [BTMESH_OP_HB_PUB_GET] = "hb_pub_get",
+        [BTMESH_OP_HB_PUB_SET] = "hb_pub_set",
 };
 
-struct blocked_beacon {
-        uint8_t uuid[UUID_LEN];
-        char uuid_str[UUID_STR_LEN];
-};
-
-static struct beacon beacon_list[MAX_BEACON];
-static struct beacon *beacon_tail = beacon_list;
-static struct k_timer beacon_timer_list[MAX_BEACON];
-static struct blocked_beacon blocked_list[BEACON_BLOCKED_SIZE];
-static struct blocked_beacon *blocked_tail = blocked_list;
+BUILD_ASSERT(ARRAY_SIZE(op_str) == BTMESH_OP_COUNT);
 
-static bool beacon_is_blocked(uint8_t uuid[UUID_LEN])
+const char *btmesh_get_op_str(enum btmesh_op op)
 {
-        struct blocked_beacon *blocked_ptr;
-
-        blocked_ptr = blocked_list;
-        while (blocked_ptr != blocked_tail) {
-                if (!util_uuid_cmp(uuid, blocked_ptr->uuid)) {
-                        return true;
-                }
-                blocked_ptr++;
-        }
-
-        return false;
-}
-
-const char *btmesh_get_blocked_beacon(size_t idx)
-{
-        if (&blocked_list[idx] >= blocked_tail) {
+        if (op >= ARRAY_SIZE(op_str)) {
                 return NULL;
         }
 
-        return blocked_list[idx].uuid_str;
+        return op_str[op];
 }
 
-int btmesh_block_beacon(uint8_t uuid[UUID_LEN])
+uint8_t btmesh_get_op_status(enum btmesh_op op, const union btmesh_op_args *args)
 {
-        struct blocked_beacon *blocked_ptr;
-
-        /* Beacon block list is full. */
-        if (blocked_tail == blocked_list + BEACON_BLOCKED_SIZE) {
-                return -ENOMEM;
-        }
-
-        /* Beacon is already blocked. */
-        if (beacon_is_blocked(uuid)) {
-                return -EAGAIN;
-        }
-
-        /* Add to blocked list while maintaining order of uuid strings within the
-         * list.
-         */
-        blocked_ptr = blocked_tail;
-        while (blocked_ptr != blocked_list) {
-                blocked_ptr--;
-
-                if (util_uuid_cmp(uuid, blocked_ptr->uuid) < 0) {
-                        memcpy(blocked_ptr + 1, blocked_ptr, sizeof(struct blocked_beacon));
-                } else {
-                        blocked_ptr++;
-                        break;
-                }
-        }
-
-        util_uuid_cpy(blocked_ptr->uuid, uuid);
-        util_uuid2str(blocked_ptr->uuid, blocked_ptr->uuid_str);
-        blocked_tail++;
-        return 0;
-}
-
-int btmesh_unblock_beacon(uint8_t uuid[UUID_LEN])
-{
-        struct blocked_beacon *blocked_ptr;
-        bool found = false;
-
-        blocked_ptr = blocked_list;
-        while (blocked_ptr != blocked_tail) {
-                if (found) {
-                        memcpy(blocked_ptr, blocked_ptr + 1, sizeof(struct blocked_beacon));
-                } else {
-                        if (!util_uuid_cmp(uuid, blocked_ptr->uuid)) {
-                                found = true;
-                                memcpy(blocked_ptr, blocked_ptr + 1, sizeof(struct blocked_beacon));
-                        }
-                }
-                blocked_ptr++;
-        }
-
-        if (found) {
-                blocked_tail--;
+        switch (op) {
+        case BTMESH_OP_COMP_GET:
+                return args->comp_get.status;
+        case BTMESH_OP_NET_KEY_ADD:
+                return args->net_key_add.status;
+        case BTMESH_OP_NET_KEY_DEL:
+                return args->net_key_del.status;
+        case BTMESH_OP_APP_KEY_ADD:
+                return args->app_key_add.status;
+        case BTMESH_OP_APP_KEY_GET:
+                return args->app_key_get.status;
+        case BTMESH_OP_APP_KEY_DEL:
+                return args->app_key_del.status;
+        case BTMESH_OP_MOD_APP_BIND:
+                return args->mod_app_bind.status;
+        case BTMESH_OP_MOD_APP_BIND_VND:
+                return args->mod_app_bind_vnd.status;
+        case BTMESH_OP_MOD_APP_UNBIND:
+                return args->mod_app_unbind.status;
+        case BTMESH_OP_MOD_APP_UNBIND_VND:
+                return args->mod_app_unbind_vnd.status;
+        case BTMESH_OP_MOD_APP_GET:
+                return args->mod_app_get.status;
+        case BTMESH_OP_MOD_APP_GET_VND:
+                return args->mod_app_get_vnd.status;
+        case BTMESH_OP_MOD_PUB_GET:
+                return args->mod_pub_get.status;
+        case BTMESH_OP_MOD_PUB_GET_VND:
+                return args->mod_pub_get_vnd.status;
+        case BTMESH_OP_MOD_PUB_SET:
+                return args->mod_pub_set.status;
+        case BTMESH_OP_MOD_PUB_SET_VND:
+                return args->mod_pub_set_vnd.status;
+        case BTMESH_OP_MOD_SUB_ADD:
+                return args->mod_sub_add.status;
+        case BTMESH_OP_MOD_SUB_ADD_VND:
+                return args->mod_sub_add_vnd.status;
+        case BTMESH_OP_MOD_SUB_DEL:
+                return args->mod_sub_del.status;
+        case BTMESH_OP_MOD_SUB_DEL_VND:
+                return args->mod_sub_del_vnd.status;
+        case BTMESH_OP_MOD_SUB_OVRW:
+                return args->mod_sub_ovrw.status;
+        case BTMESH_OP_MOD_SUB_OVRW_VND:
+                return args->mod_sub_ovrw_vnd.status;
+        case BTMESH_OP_MOD_SUB_GET:
+                return args->mod_sub_get.status;
+        case BTMESH_OP_MOD_SUB_GET_VND:
+                return args->mod_sub_get_vnd.status;
+        case BTMESH_OP_HB_SUB_GET:
+                return args->hb_sub_get.status;
+        case BTMESH_OP_HB_SUB_SET:
+                return args->hb_sub_set.status;
+        case BTMESH_OP_HB_PUB_GET:
+                return args->hb_pub_get.status;
+        case BTMESH_OP_HB_PUB_SET:
+                return args->hb_pub_set.status;
+        default:
                 return 0;
         }
-
-        return -ESRCH;
 }
 
-static struct beacon *beacon_get(uint8_t uuid[UUID_LEN])
-{
-        struct beacon *beacon_ptr = beacon_list;
-
-        while (beacon_ptr != beacon_tail) {
-                if (!util_uuid_cmp(beacon_ptr->uuid, uuid)) {
-                        return beacon_ptr;
-                }
-                beacon_ptr++;
-        }
+#define OP_MODEL(_state, _args, _cid) \
+        do { \
+                (_state)->elem_addr = (_args).elem_addr; \
+                (_state)->model_id = (_args).mod_id; \
+                (_state)->company_id = (_cid); \
+        } while (0)
 
-        return NULL;
-}
-
-static void beacon_remove_inactive(struct k_work *work)
+int btmesh_get_op_model(enum btmesh_op op, const union btmesh_op_args *args,
+                struct btmesh_model_state *state)
 {
-        struct beacon *beacon_ptr_i;
-        struct beacon *beacon_ptr_j;
-
-        beacon_ptr_i = beacon_list;
-
-        /* Remove all expired beacons, not just just the first one */
-        while (beacon_ptr_i != beacon_tail) {
-                /* Timer has expired. Remove beacon from list */
-                if (k_timer_status_get(beacon_ptr_i->timer) > 0) {
-                        /* Reset the beacon timer user data */
-                        k_timer_user_data_set(beacon_ptr_i->timer, NULL);
-
-                        /* Move all other beacons up in the list to preserve order */
-                        beacon_ptr_j = beacon_ptr_i;
-                        while (beacon_ptr_j + 1 != beacon_tail) {
-                                memcpy(beacon_ptr_j, beacon_ptr_j + 1, sizeof(struct beacon));
-                                beacon_ptr_j++;
-                        }
-
-                        /* Decrement the size of the beacon list */
-                        beacon_tail--;
-
-                        /* Continue without incrementing beacon_ptr_i becuase it now points
-                         * to the nest beacon in the list and must also be checked */
-                        continue;
-                }
-                beacon_ptr_i++;
+        switch (op) {
+        case BTMESH_OP_MOD_APP_BIND:
+                OP_MODEL(state, args->mod_app_bind, BT_MESH_CID_NVAL);
+                break;
+        case BTMESH_OP_MOD_APP_BIND_VND:
+                OP_MODEL(state, args->mod_app_bind_vnd, args->mod_app_bind_vnd.cid);
+                break;
+        case BTMESH_OP_MOD_APP_UNBIND:
+                OP_MODEL(state, args->mod_app_unbind, BT_MESH_CID_NVAL);
+                break;
+        case BTMESH_OP_MOD_APP_UNBIND_VND:
+                OP_MODEL(state, args->mod_app_unbind_vnd, args->mod_app_unbind_vnd.cid);
+                break;
+        case BTMESH_OP_MOD_PUB_SET:
+                OP_MODEL(state, args->mod_pub_set, BT_MESH_CID_NVAL);
+                break;
+        case BTMESH_OP_MOD_PUB_SET_VND:
+                OP_MODEL(state, args->mod_pub_set_vnd, args->mod_pub_set_vnd.cid);
+                break;
+        case BTMESH_OP_MOD_SUB_ADD:
+                OP_MODEL(state, args->mod_sub_add, BT_MESH_CID_NVAL);
+                break;
+        case BTMESH_OP_MOD_SUB_ADD_VND:
+                OP_MODEL(state, args->mod_sub_add_vnd, args->mod_sub_add_vnd.cid);
+                break;
+        case BTMESH_OP_MOD_SUB_DEL:
+                OP_MODEL(state, args->mod_sub_del, BT_MESH_CID_NVAL);
+                break;
+        case BTMESH_OP_MOD_SUB_DEL_VND:
+                OP_MODEL(state, args->mod_sub_del_vnd, args->mod_sub_del_vnd.cid);
+                break;
+        case BTMESH_OP_MOD_SUB_OVRW:
+                OP_MODEL(state, args->mod_sub_ovrw, BT_MESH_CID_NVAL);
+                break;
+        case BTMESH_OP_MOD_SUB_OVRW_VND:
+                OP_MODEL(state, args->mod_sub_ovrw_vnd, args->mod_sub_ovrw_vnd.cid);
+                break;
+        default:
+                return -EINVAL;
         }
-}
 
-K_WORK_DEFINE(beacon_work, beacon_remove_inactive);
-
-extern void beacon_timer_handler(struct k_timer *timer)
-{
-        /* Let the system work que find and remove the expired beacon */
-        k_work_submit(&beacon_work);
+        return 0;
 }
 
 static void beacon_recv(uint8_t uuid[UUID_LEN], bt_mesh_prov_oob_info_t oob_info, uint32_t *uri_hash)
 {
-        struct beacon* beacon_ptr;
-        struct k_timer *timer_ptr;
-
-        /* Make sure the beacon list isn't already full */
-        if (beacon_tail == beacon_list + MAX_BEACON) {
-                return;
-        };
-
         /* Make sure the beacon isn't blocked.
-         * Note that for beacons that are listed before they are blocked, this will
-         * allow their timers to expire then they will be removed from the list.
+         * Note that beacons that are listed before they are blocked are left to
+         * expire from the list.
          */
-        if (beacon_is_blocked(uuid)) {
-                return;
-        }
-
-        /* If device beacon is already listed, reset its timer so the beacon stays valid */
-        beacon_ptr = beacon_get(uuid);
-        if (beacon_ptr != NULL) {
-                k_timer_start(beacon_ptr->timer, BEACON_TIMEOUT_DURATION, K_NO_WAIT);
+        if (beacon_block_contains(uuid)) {
                 return;
         }
 
-        /* Add the beacon to the unprovisioned device list while maintaining list is sorted,
-         * by comparing the new uuid against the largest (last) listed uuid, and moving larger
-         * listed uuids down untill we find the sorted location for the new uuid */
-        beacon_ptr = beacon_tail;
-        while (beacon_ptr != beacon_list) {
-                beacon_ptr--;
-
-                if (util_uuid_cmp(uuid, beacon_ptr->uuid) < 0) {
-                        /* The listed uuid is greater than the new uuid so move the listed down one
-                         * spot in the list and move on to compare the next listed beacon */
-                        memcpy(beacon_ptr + 1, beacon_ptr, sizeof(struct beacon));
-                } else {
-                        /* The listed uuid is less than the new uuid, so the new uuid goes in this list spot */
-                        beacon_ptr++;
-                        break;
-                }
-        }
-
-        /* Enter new beacon into list */
-        util_uuid_cpy(beacon_ptr->uuid, uuid);
-        util_uuid2str(beacon_ptr->uuid, beacon_ptr->uuid_str);
-        beacon_ptr->oob_info = oob_info;
-        beacon_ptr->uri_hash = *uri_hash;
-
-        /* Increase size of beacon list */
-        beacon_tail++;
-
-        /* Find an unused timer for the new beacon */
-        timer_ptr = beacon_timer_list;
-        /* If the beacon isn't full we will find a free timer within range fors ure */
-        while (k_timer_user_data_get(timer_ptr) != NULL) {
-                timer_ptr++;
-        }
-        beacon_ptr->timer = timer_ptr;
-
-        k_timer_user_data_set(beacon_ptr->timer, beacon_ptr);
-
-        /* Start the expiry timer for the new beacon */
-        k_timer_start(beacon_ptr->timer, BEACON_TIMEOUT_DURATION, K_NO_WAIT);
-}
-
-const char *btmesh_get_beacon_uuid(size_t idx)
-{
-        if (&beacon_list[idx] >= beacon_tail) {
-                return NULL;
-        }
+#if defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+        /* Allowlisted devices are provisioned without waiting for the cloud */
+        prov_allow_beacon(uuid);
+#endif // defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
 
-        return beacon_list[idx].uuid_str;
+        /* A listed beacon is kept from expiring, and a new one is dropped if the list is full */
+        beacon_table_seen(uuid, oob_info, uri_hash);
 }
 
-const char *btmesh_get_beacon_oob(size_t idx)
+const char *btmesh_get_oob_str(bt_mesh_prov_oob_info_t oob_info)
 {
-        if (&beacon_list[idx] >= beacon_tail) {
-                return NULL;
-        }
-
-        switch (beacon_list[idx].oob_info) {
+        switch (oob_info) {
                 case BT_MESH_PROV_OOB_OTHER:
                         return OOB_OTHER;
                 case BT_MESH_PROV_OOB_URI:
@@ -801,15 +732,6 @@ const char *btmesh_get_beacon_oob(size_t idx)
         }
 }
 
-const uint32_t *btmesh_get_beacon_uri_hash(size_t idx)
-{
-        if (&beacon_list[idx] >= beacon_tail) {
-                return NULL;
-        }
-
-        return &(beacon_list[idx].uri_hash);
-}
-
 uint8_t btmesh_get_pub_period(uint8_t period)
 {
         return period & 0x3F;
@@ -832,33 +754,11 @@ char * btmesh_get_pub_period_unit_str(uint8_t period)
 
 void btmesh_free_node(struct btmesh_node *node)
 {
-        uint8_t i;
-        uint8_t j;
-
-        if (node->elems != NULL) {
-                for (i = 0; i < node->elem_count; i++) {
-                        if (node->elems[i].sig_models != NULL) {
-                                for (j = 0; j < node->elems[i].sig_model_count; j++) {
-                                        k_free(node->elems[i].sig_models[j].appkey_idxs);
-                                        k_free(node->elems[i].sig_models[j].sub_addrs);
-                                }
-
-                                k_free(node->elems[i].sig_models);
-                        }
-
-                        if (node->elems[i].vnd_models != NULL) {
-                                for (j = 0; j < node->elems[i].vnd_model_count; j++) {
-                                        k_free(node->elems[i].vnd_models[j].appkey_idxs);
-                                        k_free(node->elems[i].vnd_models[j].sub_addrs);
-                                }
-
-                                k_free(node->elems[i].vnd_models);
-                        }
-                }
-
-                k_free(node->elems);
-                node->elems = NULL;
-        }
+        /* Everything discovered for the node lives in one block, see btmesh_node_alloc() */
+        k_free(node->mem);
+        node->mem = NULL;
+        node->subnet_idxs = NULL;
+        node->elems = NULL;
 }
 
 static const uint16_t cid = 0xBABE;
@@ -874,6 +774,10 @@ static struct bt_mesh_cfg_cli cfg_cli = {
         /* TODO */
 };
 
+#if !defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+K_MUTEX_DEFINE(cfg_cli_lock);
+#endif // !defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+
 static void health_current_status(struct bt_mesh_health_cli *cli, uint16_t addr,
                 uint8_t test_id, uint16_t cid, uint8_t *faults, size_t fault_count)
 {
@@ -946,6 +850,11 @@ static void node_added(uint16_t net_idx, uint8_t uuid[UUID_LEN], uint16_t addr,
         LOG_INF("- Address  : 0x%04x", addr);
         LOG_INF("- Elements : %d", num_elem);
 
+#if defined(CONFIG_GATEWAY_NODE_CACHE)
+        /* The address may have belonged to a node that was removed without a reset */
+        node_cache_delete(addr);
+#endif // defined(CONFIG_GATEWAY_NODE_CACHE)
+
         gateway_node_added(net_idx, uuid, addr, num_elem); 
 }
 
@@ -959,9 +868,30 @@ static const struct bt_mesh_prov prov = {
 };
 
 #if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+#if defined(CONFIG_GATEWAY_UPLINK_RULES)
+/* Only sees messages some consumer of the receive bus accepts, so the rule counters leave out
+ * traffic to addresses nobody is subscribed to */
+static bool uplink_route(uint32_t opcode, const struct bt_mesh_msg_ctx *ctx,
+		const struct net_buf_simple *buf, enum rx_bus_lane *lane, uint8_t *flags)
+{
+	switch (uplink_rules_eval(opcode, ctx, buf, flags)) {
+	case UPLINK_ACTION_DROP:
+		return false;
+	case UPLINK_ACTION_PRIORITY:
+		*lane = RX_BUS_LANE_PRIORITY;
+		return true;
+	default:
+		return true;
+	}
+}
+#endif // defined(CONFIG_GATEWAY_UPLINK_RULES)
+
 static void btmesh_msg_cb(uint32_t opcode, struct bt_mesh_msg_ctx *ctx, struct net_buf_simple *buf)
 {
-        int i;
+        /* Status messages answering our own asynchronous configuration gets */
+        if (cfg_async_recv(opcode, ctx, buf)) {
+                return;
+        }
 
         /* Ignore configuration opcodes as we have the configuration client model instantiated */
         if ((opcode & 0xFF00) == 0x8000) {
@@ -973,587 +903,962 @@ static void btmesh_msg_cb(uint32_t opcode, struct bt_mesh_msg_ctx *ctx, struct n
                 return;
         }
 
-        LOG_DBG("mesh message callback");
-        LOG_DBG("    opcode : 0x%08x", opcode);
-        LOG_DBG("    net_idx: 0x%04x", ctx->net_idx);
-        LOG_DBG("    app_idx: 0x%04x", ctx->app_idx);
-        LOG_DBG("    Source Address: 0x%04x", ctx->addr);
-        LOG_DBG("    Destination Address: 0x%04x", ctx->recv_dst);
-        LOG_HEXDUMP_DBG(buf->data, buf->len, "Payload");
+        /* Runs in the mesh receive thread, the consumers take it from the ring in their own */
+#if defined(CONFIG_GATEWAY_UPLINK_RULES)
+        rx_bus_publish(opcode, ctx, buf, uplink_route);
+#else
+        rx_bus_publish(opcode, ctx, buf, NULL);
+#endif // defined(CONFIG_GATEWAY_UPLINK_RULES)
+}
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
 
-        for (i = 0; i < CONFIG_BT_MESH_GATEWAY_SUB_LIST_LEN; i++) {
-                if (cli_sub_list[i] == ctx->recv_dst) {
-#ifdef CONFIG_SHELL
-                        cli_msg_callback(opcode, ctx, buf);
-#endif
-                }
-                
-                if (gateway_sub_list[i] == ctx->recv_dst) {
-                        gateway_msg_callback(opcode, ctx, buf);
-                }
+static int perform_op(enum btmesh_op op, union btmesh_op_args* args)
+{
+        int err;
+
+        switch (op) {
+        case BTMESH_OP_PROV_ADV:
+                err = bt_mesh_provision_adv(args->prov_adv.uuid,
+                                args->prov_adv.net_idx, args->prov_adv.addr,
+                                args->prov_adv.attn);
+                break;
+
+        case BTMESH_OP_NODE_RESET:
+                err = CFG_SET(node_reset)(args->node_reset.net_idx,
+                                args->node_reset.addr, &(args->node_reset.status));
+                break;
+
+        case BTMESH_OP_COMP_GET:
+                err = CFG_GET(comp_data_get)(args->comp_get.net_idx,
+                                args->comp_get.addr, args->comp_get.page,
+                                &(args->comp_get.status), args->comp_get.comp);
+                break;
+
+        case BTMESH_OP_BEACON_GET:
+                err = CFG_GET(beacon_get)(args->beacon_get.net_idx,
+                                args->beacon_get.addr, &(args->beacon_get.status));
+                break;
+
+        case BTMESH_OP_BEACON_SET:
+                err = CFG_SET(beacon_set)(args->beacon_set.net_idx,
+                                args->beacon_set.addr, args->beacon_set.val,
+                                &(args->beacon_set.status));
+                break;
+
+        case BTMESH_OP_TTL_GET:
+                err = CFG_GET(ttl_get)(args->ttl_get.net_idx,
+                                args->ttl_get.addr, &(args->ttl_get.ttl));
+                break;
+
+        case BTMESH_OP_TTL_SET:
+                err = CFG_SET(ttl_set)(args->ttl_set.net_idx,
+                                args->ttl_set.addr, args->ttl_set.val,
+                                &(args->ttl_set.ttl));
+                break;
+
+        case BTMESH_OP_FRIEND_GET:
+                err = CFG_GET(friend_get)(args->friend_get.net_idx,
+                                args->friend_get.addr, &(args->friend_get.status));
+                break;
+
+        case BTMESH_OP_FRIEND_SET:
+                err = CFG_SET(friend_set)(args->friend_set.net_idx,
+                                args->friend_set.addr, args->friend_set.val,
+                                &(args->friend_set.status));
+                break;
+
+        case BTMESH_OP_PROXY_GET:
+                err = CFG_GET(gatt_proxy_get)(args->proxy_get.net_idx,
+                                args->proxy_get.addr, &(args->proxy_get.status));
+                break;
+
+        case BTMESH_OP_PROXY_SET:
+                err = CFG_SET(gatt_proxy_set)(args->proxy_set.net_idx,
+                                args->proxy_set.addr, args->proxy_set.val,
+                                &(args->proxy_set.status));
+                break;
+
+        case BTMESH_OP_RELAY_GET:
+                err = CFG_GET(relay_get)(args->relay_get.net_idx,
+                                args->relay_get.addr, &(args->relay_get.status),
+                                &(args->relay_get.transmit));
+                break;
+
+        case BTMESH_OP_RELAY_SET:
+                err = CFG_SET(relay_set)(args->relay_set.net_idx,
+                                args->relay_set.addr, args->relay_set.new_relay,
+                                args->relay_set.new_transmit,
+                                &(args->relay_set.status),
+                                &(args->relay_set.transmit));
+                break;
+
+        case BTMESH_OP_NET_KEY_ADD:
+                err = CFG_SET(net_key_add)(args->net_key_add.net_idx,
+                                args->net_key_add.addr,
+                                args->net_key_add.key_net_idx,
+                                args->net_key_add.net_key,
+                                &(args->net_key_add.status));
+                break;
+
+        case BTMESH_OP_NET_KEY_GET:
+                err = CFG_GET(net_key_get)(args->net_key_get.net_idx,
+                                args->net_key_get.addr, args->net_key_get.keys,
+                                &(args->net_key_get.key_cnt));
+                break;
+
+        case BTMESH_OP_NET_KEY_DEL:
+                err = CFG_SET(net_key_del)(args->net_key_del.net_idx,
+                                args->net_key_del.addr,
+                                args->net_key_del.key_net_idx,
+                                &(args->net_key_del.status));
+                break;
+
+        case BTMESH_OP_APP_KEY_ADD:
+                err = CFG_SET(app_key_add)(args->app_key_add.net_idx,
+                                args->app_key_add.addr,
+                                args->app_key_add.key_net_idx,
+                                args->app_key_add.key_app_idx,
+                                args->app_key_add.app_key,
+                                &(args->app_key_add.status));
+                break;
+
+        case BTMESH_OP_APP_KEY_GET:
+                err = CFG_GET(app_key_get)(args->app_key_get.net_idx,
+                                args->app_key_get.addr,
+                                args->app_key_get.key_net_idx,
+                                &(args->app_key_get.status),
+                                args->app_key_get.keys,
+                                &(args->app_key_get.key_cnt));
+                break;
+
+        case BTMESH_OP_APP_KEY_DEL:
+                err = CFG_SET(app_key_del)(args->app_key_del.net_idx,
+                                args->app_key_del.addr,
+                                args->app_key_del.key_net_idx,
+                                args->app_key_del.key_app_idx,
+                                &(args->app_key_del.status));
+                break;
+
+        case BTMESH_OP_MOD_APP_BIND:
+                err = CFG_SET(mod_app_bind)(args->mod_app_bind.net_idx,
+                                args->mod_app_bind.addr,
+                                args->mod_app_bind.elem_addr,
+                                args->mod_app_bind.mod_app_idx,
+                                args->mod_app_bind.mod_id,
+                                &(args->mod_app_bind.status));
+                break;
+
+        case BTMESH_OP_MOD_APP_BIND_VND:
+                err = CFG_SET(mod_app_bind_vnd)(args->mod_app_bind_vnd.net_idx,
+                                args->mod_app_bind_vnd.addr,
+                                args->mod_app_bind_vnd.elem_addr,
+                                args->mod_app_bind_vnd.mod_app_idx,
+                                args->mod_app_bind_vnd.mod_id,
+                                args->mod_app_bind_vnd.cid,
+                                &(args->mod_app_bind_vnd.status));
+                break;
+
+        case BTMESH_OP_MOD_APP_UNBIND:
+                err = CFG_SET(mod_app_unbind)(
+                                args->mod_app_unbind.net_idx,
+                                args->mod_app_unbind.addr,
+                                args->mod_app_unbind.elem_addr,
+                                args->mod_app_unbind.mod_app_idx,
+                                args->mod_app_unbind.mod_id,
+                                &(args->mod_app_unbind.status));
+                break;
+
+        case BTMESH_OP_MOD_APP_UNBIND_VND:
+                err = CFG_SET(mod_app_unbind_vnd)(
+                                args->mod_app_unbind_vnd.net_idx,
+                                args->mod_app_unbind_vnd.addr,
+                                args->mod_app_unbind_vnd.elem_addr,
+                                args->mod_app_unbind_vnd.mod_app_idx,
+                                args->mod_app_unbind_vnd.mod_id,
+                                args->mod_app_unbind_vnd.cid,
+                                &(args->mod_app_unbind_vnd.status));
+                break;
+
+        case BTMESH_OP_MOD_APP_GET:
+                err = CFG_GET(mod_app_get)(
+                                args->mod_app_get.net_idx,
+                                args->mod_app_get.addr,
+                                args->mod_app_get.elem_addr,
+                                args->mod_app_get.mod_id,
+                                &(args->mod_app_get.status),
+                                args->mod_app_get.apps,
+                                &(args->mod_app_get.app_cnt));
+                break;
+
+        case BTMESH_OP_MOD_APP_GET_VND:
+                err = CFG_GET(mod_app_get_vnd)(
+                                args->mod_app_get_vnd.net_idx,
+                                args->mod_app_get_vnd.addr,
+                                args->mod_app_get_vnd.elem_addr,
+                                args->mod_app_get_vnd.mod_id,
+                                args->mod_app_get_vnd.cid,
+                                &(args->mod_app_get_vnd.status),
+                                args->mod_app_get_vnd.apps,
+                                &(args->mod_app_get_vnd.app_cnt));
+                break;
+
+        case BTMESH_OP_MOD_PUB_GET:
+                err = CFG_GET(mod_pub_get)(args->mod_pub_get.net_idx,
+                                args->mod_pub_get.addr, args->mod_pub_get.elem_addr,
+                                args->mod_pub_get.mod_id, &(args->mod_pub_get.pub),
+                                &(args->mod_pub_get.status));
+                break;
+
+        case BTMESH_OP_MOD_PUB_GET_VND:
+                err = CFG_GET(mod_pub_get_vnd)(
+                                args->mod_pub_get_vnd.net_idx,
+                                args->mod_pub_get_vnd.addr,
+                                args->mod_pub_get_vnd.elem_addr,
+                                args->mod_pub_get_vnd.mod_id,
+                                args->mod_pub_get_vnd.cid,
+                                &(args->mod_pub_get_vnd.pub),
+                                &(args->mod_pub_get_vnd.status));
+                break;
+
+        case BTMESH_OP_MOD_PUB_SET:
+                err = CFG_SET(mod_pub_set)(args->mod_pub_set.net_idx,
+                                args->mod_pub_set.addr,
+                                args->mod_pub_set.elem_addr,
+                                args->mod_pub_set.mod_id,
+                                &(args->mod_pub_set.pub),
+                                &(args->mod_pub_set.status));
+                break;
+
+        case BTMESH_OP_MOD_PUB_SET_VND:
+                err = CFG_SET(mod_pub_set_vnd)(args->mod_pub_set_vnd.net_idx,
+                                args->mod_pub_set_vnd.addr,
+                                args->mod_pub_set_vnd.elem_addr,
+                                args->mod_pub_set_vnd.mod_id,
+                                args->mod_pub_set_vnd.cid,
+                                &(args->mod_pub_set_vnd.pub),
+                                &(args->mod_pub_set_vnd.status));
+                break;
+
+        case BTMESH_OP_MOD_SUB_ADD:
+                err = CFG_SET(mod_sub_add)(args->mod_sub_add.net_idx,
+                                args->mod_sub_add.addr,
+                                args->mod_sub_add.elem_addr,
+                                args->mod_sub_add.sub_addr,
+                                args->mod_sub_add.mod_id,
+                                &(args->mod_sub_add.status));
+                break;
+        
+        case BTMESH_OP_MOD_SUB_ADD_VND:
+                err = CFG_SET(mod_sub_add_vnd)(args->mod_sub_add_vnd.net_idx,
+                                args->mod_sub_add_vnd.addr,
+                                args->mod_sub_add_vnd.elem_addr,
+                                args->mod_sub_add_vnd.sub_addr,
+                                args->mod_sub_add_vnd.mod_id,
+                                args->mod_sub_add_vnd.cid,
+                                &(args->mod_sub_add_vnd.status));
+                break;
+
+        case BTMESH_OP_MOD_SUB_DEL:
+                err = CFG_SET(mod_sub_del)(args->mod_sub_del.net_idx,
+                                args->mod_sub_del.addr,
+                                args->mod_sub_del.elem_addr,
+                                args->mod_sub_del.sub_addr,
+                                args->mod_sub_del.mod_id,
+                                &(args->mod_sub_del.status));
+                break;
+        
+        case BTMESH_OP_MOD_SUB_DEL_VND:
+                err = CFG_SET(mod_sub_del_vnd)(args->mod_sub_del_vnd.net_idx,
+                                args->mod_sub_del_vnd.addr,
+                                args->mod_sub_del_vnd.elem_addr,
+                                args->mod_sub_del_vnd.sub_addr,
+                                args->mod_sub_del_vnd.mod_id,
+                                args->mod_sub_del_vnd.cid,
+                                &(args->mod_sub_del_vnd.status));
+                break;
+
+        case BTMESH_OP_MOD_SUB_OVRW:
+                err = CFG_SET(mod_sub_overwrite)(
+                                args->mod_sub_ovrw.net_idx,
+                                args->mod_sub_ovrw.addr,
+                                args->mod_sub_ovrw.elem_addr,
+                                args->mod_sub_ovrw.sub_addr,
+                                args->mod_sub_ovrw.mod_id,
+                                &(args->mod_sub_ovrw.status));
+                break;
+        
+        case BTMESH_OP_MOD_SUB_OVRW_VND:
+                err = CFG_SET(mod_sub_overwrite_vnd)(
+                                args->mod_sub_ovrw_vnd.net_idx,
+                                args->mod_sub_ovrw_vnd.addr,
+                                args->mod_sub_ovrw_vnd.elem_addr,
+                                args->mod_sub_ovrw_vnd.sub_addr,
+                                args->mod_sub_ovrw_vnd.mod_id,
+                                args->mod_sub_ovrw_vnd.cid,
+                                &(args->mod_sub_ovrw_vnd.status));
+                break;
+
+        case BTMESH_OP_MOD_SUB_GET:
+                err = CFG_GET(mod_sub_get)(args->mod_sub_get.net_idx,
+                                args->mod_sub_get.addr,
+                                args->mod_sub_get.elem_addr,
+                                args->mod_sub_get.mod_id,
+                                &(args->mod_sub_get.status),
+                                args->mod_sub_get.subs,
+                                &(args->mod_sub_get.sub_cnt));
+                break;
+
+        case BTMESH_OP_MOD_SUB_GET_VND:
+                err = CFG_GET(mod_sub_get_vnd)(
+                                args->mod_sub_get_vnd.net_idx,
+                                args->mod_sub_get_vnd.addr,
+                                args->mod_sub_get_vnd.elem_addr,
+                                args->mod_sub_get_vnd.mod_id,
+                                args->mod_sub_get_vnd.cid,
+                                &(args->mod_sub_get_vnd.status),
+                                args->mod_sub_get_vnd.subs,
+                                &(args->mod_sub_get_vnd.sub_cnt));
+                break;
+
+        case BTMESH_OP_HLTH_FAULT_GET:
+                err = bt_mesh_health_fault_get(
+                                args->hlth_fault_get.addr,
+                                args->hlth_fault_get.app_idx,
+                                args->hlth_fault_get.cid,
+                                &(args->hlth_fault_get.test_id),
+                                args->hlth_fault_get.faults,
+                                &(args->hlth_fault_get.fault_count));
+                break;
+
+        case BTMESH_OP_HLTH_FAULT_CLR:
+                err = bt_mesh_health_fault_clear(
+                                args->hlth_fault_clear.addr,
+                                args->hlth_fault_clear.app_idx,
+                                args->hlth_fault_clear.cid,
+                                &(args->hlth_fault_clear.test_id),
+                                args->hlth_fault_clear.faults,
+                                &(args->hlth_fault_clear.fault_count));
+                break;
+
+        case BTMESH_OP_HLTH_FAULT_TEST:
+                err = bt_mesh_health_fault_test(
+                                args->hlth_fault_test.addr,
+                                args->hlth_fault_test.app_idx,
+                                args->hlth_fault_test.cid,
+                                args->hlth_fault_test.test_id,
+                                args->hlth_fault_test.faults,
+                                &(args->hlth_fault_test.fault_count));
+                break;
+
+        case BTMESH_OP_HLTH_PERIOD_GET:
+                err = bt_mesh_health_period_get(
+                                args->hlth_period_get.addr,
+                                args->hlth_period_get.app_idx,
+                                &(args->hlth_period_get.divisor));
+                break;
+
+        case BTMESH_OP_HLTH_PERIOD_SET:
+                err = bt_mesh_health_period_set(
+                                args->hlth_period_set.addr,
+                                args->hlth_period_set.app_idx,
+                                args->hlth_period_set.divisor,
+                                &(args->hlth_period_set.updated_divisor));
+                break;
+
+        case BTMESH_OP_HLTH_ATTN_GET:
+                err = bt_mesh_health_attention_get(
+                                args->hlth_attn_get.addr,
+                                args->hlth_attn_get.app_idx,
+                                &(args->hlth_attn_get.attn));
+                break;
+
+        case BTMESH_OP_HLTH_ATTN_SET:
+                err = bt_mesh_health_attention_set(
+                                args->hlth_attn_set.addr,
+                                args->hlth_attn_set.app_idx,
+                                args->hlth_attn_set.attn,
+                                &(args->hlth_attn_set.updated_attn));
+                break;
+
+        case BTMESH_OP_HLTH_TIMEOUT_GET:
+                args->hlth_timeout_get.timeout = bt_mesh_health_cli_timeout_get();
+                err = 0;
+                break;
+
+        case BTMESH_OP_HLTH_TIMEOUT_SET:
+                bt_mesh_health_cli_timeout_set(args->hlth_timeout_set.timeout);
+                err = 0;
+                break;
+
+        case BTMESH_OP_HB_SUB_GET:
+                err = CFG_GET(hb_sub_get)(
+                                args->hb_sub_get.net_idx,
+                                args->hb_sub_get.addr,
+                                &(args->hb_sub_get.sub),
+                                &(args->hb_sub_get.status));
+                break;
+
+        case BTMESH_OP_HB_SUB_SET:
+                err = CFG_SET(hb_sub_set)(
+                                args->hb_sub_set.net_idx,
+                                args->hb_sub_set.addr,
+                                &(args->hb_sub_set.sub),
+                                &(args->hb_sub_set.status));
+                break;
+
+        case BTMESH_OP_HB_PUB_GET:
+                err = CFG_GET(hb_pub_get)(
+                                args->hb_pub_get.net_idx,
+                                args->hb_pub_get.addr,
+                                &(args->hb_pub_get.pub),
+                                &(args->hb_pub_get.status));
+                break;
+
+        case BTMESH_OP_HB_PUB_SET:
+                err = CFG_SET(hb_pub_set)(
+                                args->hb_pub_set.net_idx,
+                                args->hb_pub_set.addr,
+                                &(args->hb_pub_set.pub),
+                                &(args->hb_pub_set.status));
+                break;
+
+        default:
+                err = -EINVAL;
+                break;
+        }
+
+        return err;
+}
+
+/* Unicast address of the node a configuration operation talks to. Health operations are
+ * left out as their timeout is set explicitly by the user. */
+static uint16_t cfg_op_addr(enum btmesh_op op, union btmesh_op_args* args)
+{
+        switch (op) {
+        case BTMESH_OP_PROV_ADV:
+        case BTMESH_OP_HLTH_FAULT_GET:
+        case BTMESH_OP_HLTH_FAULT_CLR:
+        case BTMESH_OP_HLTH_FAULT_TEST:
+        case BTMESH_OP_HLTH_PERIOD_GET:
+        case BTMESH_OP_HLTH_PERIOD_SET:
+        case BTMESH_OP_HLTH_ATTN_GET:
+        case BTMESH_OP_HLTH_ATTN_SET:
+        case BTMESH_OP_HLTH_TIMEOUT_GET:
+        case BTMESH_OP_HLTH_TIMEOUT_SET:
+                return BT_MESH_ADDR_UNASSIGNED;
+
+        default:
+                /* The arguments of every configuration operation start with net_idx, addr */
+                return args->node_reset.addr;
         }
 }
-#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
 
 int btmesh_perform_op(enum btmesh_op op, union btmesh_op_args* args)
 {
         int i;
         int err;
+        int timeouts;
+        uint16_t addr;
+        int64_t start;
+        int64_t sent;
 
-        for (i = 0; i < MESH_RETRY_COUNT; i++)
-        {
-                switch (op) {
-                case BTMESH_OP_PROV_ADV:
-                        err = bt_mesh_provision_adv(args->prov_adv.uuid,
-                                        args->prov_adv.net_idx, args->prov_adv.addr,
-                                        args->prov_adv.attn);
-                        break;
+        if (op >= BTMESH_OP_COUNT) {
+                return -EINVAL;
+        }
 
-                case BTMESH_OP_NODE_RESET:
-                        err = bt_mesh_cfg_node_reset(args->node_reset.net_idx,
-                                        args->node_reset.addr, &(args->node_reset.status));
-                        break;
+        addr = cfg_op_addr(op, args);
+        timeouts = 0;
+        start = k_uptime_get();
 
-                case BTMESH_OP_COMP_GET:
-                        err = bt_mesh_cfg_comp_data_get(args->comp_get.net_idx,
-                                        args->comp_get.addr, args->comp_get.page,
-                                        &(args->comp_get.status), args->comp_get.comp);
-                        break;
+        for (i = 0; i < CONFIG_GATEWAY_MESH_RETRY_COUNT; i++) {
+                if (i > 0) {
+                        k_sleep(K_MSEC(mesh_retry_backoff_get(i)));
+                }
 
-                case BTMESH_OP_BEACON_GET:
-                        err = bt_mesh_cfg_beacon_get(args->beacon_get.net_idx,
-                                        args->beacon_get.addr, &(args->beacon_get.status));
-                        break;
+                sent = k_uptime_get();
+#if !defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+                /* The stock configuration client only has room for one outstanding request,
+                 * so the reconcile, fan-out, sweep and processing threads take turns rather
+                 * than failing each other with -EBUSY */
+                k_mutex_lock(&cfg_cli_lock, K_FOREVER);
+#endif // !defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+                err = perform_op(op, args);
+#if !defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+                k_mutex_unlock(&cfg_cli_lock);
+#endif // !defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+
+                if (err == -ETIMEDOUT) {
+                        timeouts++;
+
+                        if (addr != BT_MESH_ADDR_UNASSIGNED) {
+                                mesh_retry_timeout(addr);
+                        }
+                }
 
-                case BTMESH_OP_BEACON_SET:
-                        err = bt_mesh_cfg_beacon_set(args->beacon_set.net_idx,
-                                        args->beacon_set.addr, args->beacon_set.val,
-                                        &(args->beacon_set.status));
-                        break;
+                if (!err) {
+                        /* An answer after a retry may belong to any of the attempts, so
+                         * only first attempts are sampled (Karn's algorithm) */
+                        if (i == 0 && addr != BT_MESH_ADDR_UNASSIGNED) {
+                                mesh_retry_rtt_sample(addr, k_uptime_get() - sent);
+                        }
 
-                case BTMESH_OP_TTL_GET:
-                        err = bt_mesh_cfg_ttl_get(args->ttl_get.net_idx,
-                                        args->ttl_get.addr, &(args->ttl_get.ttl));
                         break;
+                }
 
-                case BTMESH_OP_TTL_SET:
-                        err = bt_mesh_cfg_ttl_set(args->ttl_set.net_idx,
-                                        args->ttl_set.addr, args->ttl_set.val,
-                                        &(args->ttl_set.ttl));
+                /* Only a lost message or a full client is worth sending again, any other
+                 * error fails the same way every time */
+                if (err != -ETIMEDOUT && err != -EBUSY) {
                         break;
+                }
+        }
 
-                case BTMESH_OP_FRIEND_GET:
-                        err = bt_mesh_cfg_friend_get(args->friend_get.net_idx,
-                                        args->friend_get.addr, &(args->friend_get.status));
-                        break;
+        mesh_retry_op_record(op, MIN(i + 1, CONFIG_GATEWAY_MESH_RETRY_COUNT), timeouts, err,
+                        k_uptime_get() - start);
 
-                case BTMESH_OP_FRIEND_SET:
-                        err = bt_mesh_cfg_friend_set(args->friend_set.net_idx,
-                                        args->friend_set.addr, args->friend_set.val,
-                                        &(args->friend_set.status));
-                        break;
+#if defined(CONFIG_GATEWAY_NODE_CACHE)
+        if (!err) {
+                node_cache_update(op, args);
+        }
+#endif // defined(CONFIG_GATEWAY_NODE_CACHE)
 
-                case BTMESH_OP_PROXY_GET:
-                        err = bt_mesh_cfg_gatt_proxy_get(args->proxy_get.net_idx,
-                                        args->proxy_get.addr, &(args->proxy_get.status));
-                        break;
+        return err;
+}
 
-                case BTMESH_OP_PROXY_SET:
-                        err = bt_mesh_cfg_gatt_proxy_set(args->proxy_set.net_idx,
-                                        args->proxy_set.addr, args->proxy_set.val,
-                                        &(args->proxy_set.status));
-                        break;
+static bool node_app_key_used(const struct btmesh_node *node, uint16_t app_idx)
+{
+        size_t i;
+        size_t j;
+        size_t k;
+        const struct btmesh_elem *elem;
 
-                case BTMESH_OP_RELAY_GET:
-                        err = bt_mesh_cfg_relay_get(args->relay_get.net_idx,
-                                        args->relay_get.addr, &(args->relay_get.status),
-                                        &(args->relay_get.transmit));
-                        break;
+        for (i = 0; i < node->elem_count; i++) {
+                elem = &node->elems[i];
 
-                case BTMESH_OP_RELAY_SET:
-                        err = bt_mesh_cfg_relay_set(args->relay_set.net_idx,
-                                        args->relay_set.addr, args->relay_set.new_relay,
-                                        args->relay_set.new_transmit,
-                                        &(args->relay_set.status),
-                                        &(args->relay_set.transmit));
-                        break;
+                for (j = 0; j < elem->sig_model_count; j++) {
+                        for (k = 0; k < elem->sig_models[j].appkey_count; k++) {
+                                if (elem->sig_models[j].appkey_idxs[k] == app_idx) {
+                                        return true;
+                                }
+                        }
+                }
 
-                case BTMESH_OP_NET_KEY_ADD:
-                        err = bt_mesh_cfg_net_key_add(args->net_key_add.net_idx,
-                                        args->net_key_add.addr,
-                                        args->net_key_add.key_net_idx,
-                                        args->net_key_add.net_key,
-                                        &(args->net_key_add.status));
-                        break;
+                for (j = 0; j < elem->vnd_model_count; j++) {
+                        for (k = 0; k < elem->vnd_models[j].appkey_count; k++) {
+                                if (elem->vnd_models[j].appkey_idxs[k] == app_idx) {
+                                        return true;
+                                }
+                        }
+                }
+        }
 
-                case BTMESH_OP_NET_KEY_GET:
-                        err = bt_mesh_cfg_net_key_get(args->net_key_get.net_idx,
-                                        args->net_key_get.addr, args->net_key_get.keys,
-                                        &(args->net_key_get.key_cnt));
-                        break;
+        return false;
+}
 
-                case BTMESH_OP_NET_KEY_DEL:
-                        err = bt_mesh_cfg_net_key_del(args->net_key_get.net_idx,
-                                        args->net_key_del.addr,
-                                        args->net_key_del.key_net_idx,
-                                        &(args->net_key_del.status));
-                        break;
+int btmesh_clean_node_key(uint16_t addr, uint16_t app_idx)
+{
+        int err;
+        bool used;
+        uint8_t status;
+        union btmesh_op_args args;
+        struct btmesh_node node;
 
-                case BTMESH_OP_APP_KEY_ADD:
-                        err = bt_mesh_cfg_app_key_add(args->app_key_add.net_idx,
-                                        args->app_key_add.addr,
-                                        args->app_key_add.key_net_idx,
-                                        args->app_key_add.key_app_idx,
-                                        args->app_key_add.app_key,
-                                        &(args->app_key_add.status));
-                        break;
+        /* The bindings of every model are known from the node cache, or from one discovery */
+        node.addr = addr;
+        err = btmesh_get_node(&node, &status, false);
 
-                case BTMESH_OP_APP_KEY_GET:
-                        err = bt_mesh_cfg_app_key_get(args->app_key_get.net_idx,
-                                        args->app_key_get.addr,
-                                        args->app_key_get.key_net_idx,
-                                        &(args->app_key_get.status),
-                                        args->app_key_get.keys,
-                                        &(args->app_key_get.key_cnt));
-                        break;
+        if (err || status) {
+                LOG_ERR("Failed to get node configuration. Error: %d, Status: %d", err, status);
+                return err ? err : -EIO;
+        }
 
-                case BTMESH_OP_APP_KEY_DEL:
-                        err = bt_mesh_cfg_app_key_del(args->app_key_del.net_idx,
-                                        args->app_key_del.addr,
-                                        args->app_key_del.key_net_idx,
-                                        args->app_key_del.key_app_idx,
-                                        &(args->app_key_del.status));
-                        break;
+        used = node_app_key_used(&node, app_idx);
+        btmesh_free_node(&node);
 
-                case BTMESH_OP_MOD_APP_BIND:
-                        err = bt_mesh_cfg_mod_app_bind(args->mod_app_bind.net_idx,
-                                        args->mod_app_bind.addr,
-                                        args->mod_app_bind.elem_addr,
-                                        args->mod_app_bind.mod_app_idx,
-                                        args->mod_app_bind.mod_id,
-                                        &(args->mod_app_bind.status));
-                        break;
+        if (used) {
+                /* Some model on some element is still using this app key so no need to delete it */
+                return 0;
+        }
 
-                case BTMESH_OP_MOD_APP_BIND_VND:
-                        err = bt_mesh_cfg_mod_app_bind_vnd(args->mod_app_bind_vnd.net_idx,
-                                        args->mod_app_bind_vnd.addr,
-                                        args->mod_app_bind_vnd.elem_addr,
-                                        args->mod_app_bind_vnd.mod_app_idx,
-                                        args->mod_app_bind_vnd.mod_id,
-                                        args->mod_app_bind_vnd.cid,
-                                        &(args->mod_app_bind_vnd.status));
-                        break;
+        args.app_key_del.net_idx = PRIMARY_SUBNET;
+        args.app_key_del.addr = addr;
+        args.app_key_del.key_net_idx = bt_mesh_cdb_app_key_get(app_idx)->net_idx;
+        args.app_key_del.key_app_idx = app_idx;
+        err = btmesh_perform_op(BTMESH_OP_APP_KEY_DEL, &args);
 
-                case BTMESH_OP_MOD_APP_UNBIND:
-                        err = bt_mesh_cfg_mod_app_unbind(
-                                        args->mod_app_unbind.net_idx,
-                                        args->mod_app_unbind.addr,
-                                        args->mod_app_unbind.elem_addr,
-                                        args->mod_app_unbind.mod_app_idx,
-                                        args->mod_app_unbind.mod_id,
-                                        &(args->mod_app_unbind.status));
-                        break;
+        if (err) {
+                LOG_ERR("Failed to delete unused app key from node. Error: %d", err);
+                return err;
+        }
 
-                case BTMESH_OP_MOD_APP_UNBIND_VND:
-                        err = bt_mesh_cfg_mod_app_unbind_vnd(
-                                        args->mod_app_unbind_vnd.net_idx,
-                                        args->mod_app_unbind_vnd.addr,
-                                        args->mod_app_unbind_vnd.elem_addr,
-                                        args->mod_app_unbind_vnd.mod_app_idx,
-                                        args->mod_app_unbind_vnd.mod_id,
-                                        args->mod_app_unbind_vnd.cid,
-                                        &(args->mod_app_unbind_vnd.status));
-                        break;
+        return 0;
+}
 
-                case BTMESH_OP_MOD_APP_GET:
-                        err = bt_mesh_cfg_mod_app_get(
-					args->mod_app_get.net_idx,
-                                        args->mod_app_get.addr,
-                                        args->mod_app_get.elem_addr,
-                                        args->mod_app_get.mod_id,
-                                        &(args->mod_app_get.status),
-                                        args->mod_app_get.apps,
-                                        &(args->mod_app_get.app_cnt));
-                        break;
+/* Add app_idx to the node unless it already has it */
+static int node_app_key_add(uint16_t addr, uint16_t app_idx)
+{
+        int i;
+        int err;
+        union btmesh_op_args args;
+        struct bt_mesh_cdb_app_key *app_key;
 
-		case BTMESH_OP_MOD_APP_GET_VND:
-                        err = bt_mesh_cfg_mod_app_get_vnd(
-                                        args->mod_app_get_vnd.net_idx,
-                                        args->mod_app_get_vnd.addr,
-                                        args->mod_app_get_vnd.elem_addr,
-                                        args->mod_app_get_vnd.mod_id,
-                                        args->mod_app_get_vnd.cid,
-                                        &(args->mod_app_get_vnd.status),
-                                        args->mod_app_get_vnd.apps,
-                                        &(args->mod_app_get_vnd.app_cnt));
-                        break;
+        app_key = bt_mesh_cdb_app_key_get(app_idx);
 
-                case BTMESH_OP_MOD_PUB_GET:
-                        err = bt_mesh_cfg_mod_pub_get(args->mod_pub_get.net_idx,
-                                        args->mod_pub_get.addr, args->mod_pub_get.elem_addr,
-                                        args->mod_pub_get.mod_id, &(args->mod_pub_get.pub),
-                                        &(args->mod_pub_get.status));
-                        break;
+        if (app_key == NULL) {
+                return -ENOENT;
+        }
 
-                case BTMESH_OP_MOD_PUB_GET_VND:
-                        err = bt_mesh_cfg_mod_pub_get_vnd(
-                                        args->mod_pub_get_vnd.net_idx,
-                                        args->mod_pub_get_vnd.addr,
-                                        args->mod_pub_get_vnd.elem_addr,
-                                        args->mod_pub_get_vnd.mod_id,
-                                        args->mod_pub_get_vnd.cid,
-                                        &(args->mod_pub_get_vnd.pub),
-                                        &(args->mod_pub_get_vnd.status));
-                        break;
+        args.app_key_get.net_idx = PRIMARY_SUBNET;
+        args.app_key_get.addr = addr;
+        args.app_key_get.key_net_idx = app_key->net_idx;
+        args.app_key_get.key_cnt = ARRAY_SIZE(args.app_key_get.keys);
+        err = btmesh_perform_op(BTMESH_OP_APP_KEY_GET, &args);
 
-                case BTMESH_OP_MOD_PUB_SET:
-                        err = bt_mesh_cfg_mod_pub_set(args->mod_pub_set.net_idx,
-                                        args->mod_pub_set.addr,
-                                        args->mod_pub_set.elem_addr,
-                                        args->mod_pub_set.mod_id,
-                                        &(args->mod_pub_set.pub),
-                                        &(args->mod_pub_set.status));
-                        break;
+        if (err || args.app_key_get.status) {
+                LOG_ERR("Failed to get node app keys. Error: %d, Status: %d", err,
+                                args.app_key_get.status);
+                return err ? err : -EIO;
+        }
 
-                case BTMESH_OP_MOD_PUB_SET_VND:
-                        err = bt_mesh_cfg_mod_pub_set_vnd(args->mod_pub_set_vnd.net_idx,
-                                        args->mod_pub_set_vnd.addr,
-                                        args->mod_pub_set_vnd.elem_addr,
-                                        args->mod_pub_set_vnd.mod_id,
-                                        args->mod_pub_set_vnd.cid,
-                                        &(args->mod_pub_set_vnd.pub),
-                                        &(args->mod_pub_set_vnd.status));
-                        break;
+        for (i = 0; i < args.app_key_get.key_cnt; i++) {
+                if (args.app_key_get.keys[i] == app_idx) {
+                        return 0;
+                }
+        }
 
-                case BTMESH_OP_MOD_SUB_ADD:
-                        err = bt_mesh_cfg_mod_sub_add(args->mod_sub_add.net_idx,
-                                        args->mod_sub_add.addr,
-                                        args->mod_sub_add.elem_addr,
-                                        args->mod_sub_add.sub_addr,
-                                        args->mod_sub_add.mod_id,
-                                        &(args->mod_sub_add.status));
-                        break;
-                
-                case BTMESH_OP_MOD_SUB_ADD_VND:
-                        err = bt_mesh_cfg_mod_sub_add_vnd(args->mod_sub_add_vnd.net_idx,
-                                        args->mod_sub_add_vnd.addr,
-                                        args->mod_sub_add_vnd.elem_addr,
-                                        args->mod_sub_add_vnd.sub_addr,
-                                        args->mod_sub_add_vnd.mod_id,
-                                        args->mod_sub_add_vnd.cid,
-                                        &(args->mod_sub_add_vnd.status));
-                        break;
+        args.app_key_add.key_app_idx = app_idx;
+        memcpy(args.app_key_add.app_key, app_key->keys[0].app_key, KEY_LEN);
+        err = btmesh_perform_op(BTMESH_OP_APP_KEY_ADD, &args);
 
-                case BTMESH_OP_MOD_SUB_DEL:
-                        err = bt_mesh_cfg_mod_sub_del(args->mod_sub_del.net_idx,
-                                        args->mod_sub_del.addr,
-                                        args->mod_sub_del.elem_addr,
-                                        args->mod_sub_del.sub_addr,
-                                        args->mod_sub_del.mod_id,
-                                        &(args->mod_sub_del.status));
-                        break;
-                
-                case BTMESH_OP_MOD_SUB_DEL_VND:
-                        err = bt_mesh_cfg_mod_sub_del_vnd(args->mod_sub_del_vnd.net_idx,
-                                        args->mod_sub_del_vnd.addr,
-                                        args->mod_sub_del_vnd.elem_addr,
-                                        args->mod_sub_del_vnd.sub_addr,
-                                        args->mod_sub_del_vnd.mod_id,
-                                        args->mod_sub_del_vnd.cid,
-                                        &(args->mod_sub_del_vnd.status));
-                        break;
+        if (err || args.app_key_add.status) {
+                LOG_ERR("Failed to add app key to node. Error: %d, Status: %d", err,
+                                args.app_key_add.status);
+                return err ? err : -EIO;
+        }
 
-                case BTMESH_OP_MOD_SUB_OVRW:
-                        err = bt_mesh_cfg_mod_sub_overwrite(
-                                        args->mod_sub_ovrw.net_idx,
-                                        args->mod_sub_ovrw.addr,
-                                        args->mod_sub_ovrw.elem_addr,
-                                        args->mod_sub_ovrw.sub_addr,
-                                        args->mod_sub_ovrw.mod_id,
-                                        &(args->mod_sub_ovrw.status));
-                        break;
-                
-                case BTMESH_OP_MOD_SUB_OVRW_VND:
-                        err = bt_mesh_cfg_mod_sub_overwrite_vnd(
-                                        args->mod_sub_ovrw_vnd.net_idx,
-                                        args->mod_sub_ovrw_vnd.addr,
-                                        args->mod_sub_ovrw_vnd.elem_addr,
-                                        args->mod_sub_ovrw_vnd.sub_addr,
-                                        args->mod_sub_ovrw_vnd.mod_id,
-                                        args->mod_sub_ovrw_vnd.cid,
-                                        &(args->mod_sub_ovrw_vnd.status));
-                        break;
+        return 0;
+}
 
-                case BTMESH_OP_MOD_SUB_GET:
-                        err = bt_mesh_cfg_mod_sub_get(args->mod_sub_get.net_idx,
-                                        args->mod_sub_get.addr,
-                                        args->mod_sub_get.elem_addr,
-                                        args->mod_sub_get.mod_id,
-                                        &(args->mod_sub_get.status),
-                                        args->mod_sub_get.subs,
-                                        &(args->mod_sub_get.sub_cnt));
-                        break;
+int btmesh_perform_cfg_op(enum btmesh_op op, union btmesh_op_args *args)
+{
+        int err;
 
-                case BTMESH_OP_MOD_SUB_GET_VND:
-                        err = bt_mesh_cfg_mod_sub_get_vnd(
-                                        args->mod_sub_get_vnd.net_idx,
-                                        args->mod_sub_get_vnd.addr,
-                                        args->mod_sub_get_vnd.elem_addr,
-                                        args->mod_sub_get_vnd.mod_id,
-                                        args->mod_sub_get_vnd.cid,
-                                        &(args->mod_sub_get_vnd.status),
-                                        args->mod_sub_get_vnd.subs,
-                                        &(args->mod_sub_get_vnd.sub_cnt));
-                        break;
+        if (op == BTMESH_OP_MOD_APP_BIND || op == BTMESH_OP_MOD_APP_BIND_VND) {
+                err = node_app_key_add(args->mod_app_bind.addr, args->mod_app_bind.mod_app_idx);
 
-                case BTMESH_OP_HLTH_FAULT_GET:
-                        err = bt_mesh_health_fault_get(
-                                        args->hlth_fault_get.addr,
-                                        args->hlth_fault_get.app_idx,
-                                        args->hlth_fault_get.cid,
-                                        &(args->hlth_fault_get.test_id),
-                                        args->hlth_fault_get.faults,
-                                        &(args->hlth_fault_get.fault_count));
-                        break;
+                if (err) {
+                        return err;
+                }
+        }
 
-                case BTMESH_OP_HLTH_FAULT_CLR:
-                        err = bt_mesh_health_fault_clear(
-                                        args->hlth_fault_clear.addr,
-                                        args->hlth_fault_clear.app_idx,
-                                        args->hlth_fault_clear.cid,
-                                        &(args->hlth_fault_clear.test_id),
-                                        args->hlth_fault_clear.faults,
-                                        &(args->hlth_fault_clear.fault_count));
-                        break;
+        err = btmesh_perform_op(op, args);
 
-                case BTMESH_OP_HLTH_FAULT_TEST:
-                        err = bt_mesh_health_fault_test(
-                                        args->hlth_fault_test.addr,
-                                        args->hlth_fault_test.app_idx,
-                                        args->hlth_fault_test.cid,
-                                        args->hlth_fault_test.test_id,
-                                        args->hlth_fault_test.faults,
-                                        &(args->hlth_fault_test.fault_count));
-                        break;
+        if (err || btmesh_get_op_status(op, args)) {
+                return err;
+        }
 
-                case BTMESH_OP_HLTH_PERIOD_GET:
-                        err = bt_mesh_health_period_get(
-                                        args->hlth_period_get.addr,
-                                        args->hlth_period_get.app_idx,
-                                        &(args->hlth_period_get.divisor));
-                        break;
+        if (op == BTMESH_OP_MOD_APP_UNBIND || op == BTMESH_OP_MOD_APP_UNBIND_VND) {
+                /* The unbind itself succeeded, a key left behind is only logged */
+                btmesh_clean_node_key(args->mod_app_unbind.addr,
+                                args->mod_app_unbind.mod_app_idx);
+        }
 
-                case BTMESH_OP_HLTH_PERIOD_SET:
-                        err = bt_mesh_health_period_set(
-                                        args->hlth_period_set.addr,
-                                        args->hlth_period_set.app_idx,
-                                        args->hlth_period_set.divisor,
-                                        &(args->hlth_period_set.updated_divisor));
-                        break;
+        return 0;
+}
 
-                case BTMESH_OP_HLTH_ATTN_GET:
-                        err = bt_mesh_health_attention_get(
-                                        args->hlth_attn_get.addr,
-                                        args->hlth_attn_get.app_idx,
-                                        &(args->hlth_attn_get.attn));
-                        break;
+#if defined(CONFIG_GATEWAY_NODE_CACHE)
+static int model_state_from_cache(uint16_t addr, struct btmesh_model_state *state)
+{
+        int err;
+        size_t i;
+        struct btmesh_node node;
+        struct btmesh_elem *elem;
 
-                case BTMESH_OP_HLTH_ATTN_SET:
-                        err = bt_mesh_health_attention_set(
-                                        args->hlth_attn_set.addr,
-                                        args->hlth_attn_set.app_idx,
-                                        args->hlth_attn_set.attn,
-                                        &(args->hlth_attn_set.updated_attn));
-                        break;
+        err = node_cache_load(addr, &node);
 
-                case BTMESH_OP_HLTH_TIMEOUT_GET:
-                        args->hlth_timeout_get.timeout = bt_mesh_health_cli_timeout_get();
-                        err = 0;
-                        break;
+        if (err) {
+                return err;
+        }
 
-                case BTMESH_OP_HLTH_TIMEOUT_SET:
-                        bt_mesh_health_cli_timeout_set(args->hlth_timeout_set.timeout);
-                        err = 0;
-                        break;
+        err = -ENOENT;
 
-		case BTMESH_OP_HB_SUB_GET:
-			err = bt_mesh_cfg_hb_sub_get(
-					args->hb_sub_get.net_idx,
-					args->hb_sub_get.addr,
-					&(args->hb_sub_get.sub),
-					&(args->hb_sub_get.status));
-			break;
-
-		case BTMESH_OP_HB_SUB_SET:
-			err = bt_mesh_cfg_hb_sub_set(
-					args->hb_sub_set.net_idx,
-					args->hb_sub_set.addr,
-					&(args->hb_sub_set.sub),
-					&(args->hb_sub_set.status));
-			break;
-
-		case BTMESH_OP_HB_PUB_GET:
-			err = bt_mesh_cfg_hb_pub_get(
-					args->hb_pub_get.net_idx,
-					args->hb_pub_get.addr,
-					&(args->hb_pub_get.pub),
-					&(args->hb_pub_get.status));
-			break;
-
-		case BTMESH_OP_HB_PUB_SET:
-			err = bt_mesh_cfg_hb_pub_set(
-					args->hb_pub_set.net_idx,
-					args->hb_pub_set.addr,
-					&(args->hb_pub_set.pub),
-					&(args->hb_pub_set.status));
-			break;
+        if (state->elem_addr < addr || state->elem_addr - addr >= node.elem_count) {
+                goto done;
+        }
 
-                default:
-                        err = -EINVAL;
-                        break;
+        elem = &node.elems[state->elem_addr - addr];
+
+        for (i = 0; i < elem->sig_model_count && state->company_id == BT_MESH_CID_NVAL;
+                        i++) {
+                if (elem->sig_models[i].model_id == state->model_id) {
+                        state->appkey_count = elem->sig_models[i].appkey_count;
+                        memcpy(state->appkey_idxs, elem->sig_models[i].appkey_idxs,
+                                        state->appkey_count * sizeof(uint16_t));
+                        state->sub_addr_count = elem->sig_models[i].sub_addr_count;
+                        memcpy(state->sub_addrs, elem->sig_models[i].sub_addrs,
+                                        state->sub_addr_count * sizeof(uint16_t));
+                        state->pub = elem->sig_models[i].pub;
+                        err = 0;
+                        goto done;
                 }
+        }
 
-                if (!err) {
-                        return 0;
+        for (i = 0; i < elem->vnd_model_count && state->company_id != BT_MESH_CID_NVAL;
+                        i++) {
+                if (elem->vnd_models[i].model_id == state->model_id &&
+                                elem->vnd_models[i].company_id == state->company_id) {
+                        state->appkey_count = elem->vnd_models[i].appkey_count;
+                        memcpy(state->appkey_idxs, elem->vnd_models[i].appkey_idxs,
+                                        state->appkey_count * sizeof(uint16_t));
+                        state->sub_addr_count = elem->vnd_models[i].sub_addr_count;
+                        memcpy(state->sub_addrs, elem->vnd_models[i].sub_addrs,
+                                        state->sub_addr_count * sizeof(uint16_t));
+                        state->pub = elem->vnd_models[i].pub;
+                        err = 0;
+                        goto done;
                 }
         }
 
+done:
+        btmesh_free_node(&node);
         return err;
 }
+#endif // defined(CONFIG_GATEWAY_NODE_CACHE)
 
-int btmesh_clean_node_key(uint16_t addr, uint16_t app_idx)
+static int model_state_from_node(uint16_t addr, struct btmesh_model_state *state)
 {
-        int i;
-        int j;
-        int k;
         int err;
-        uint8_t num_elem;
-        uint8_t num_sig_models;
-        uint8_t num_vnd_models;
+        bool vnd;
         union btmesh_op_args args;
-        struct net_buf_simple *comp_data;
 
-        args.comp_get.net_idx = PRIMARY_SUBNET;
-        args.comp_get.addr = addr;
-        args.comp_get.page = 0x00;
-        args.comp_get.comp = NET_BUF_SIMPLE(COMP_DATA_BUF_SIZE);
-        net_buf_simple_init(args.comp_get.comp, 0);
-        err = btmesh_perform_op(BTMESH_OP_COMP_GET, &args);
+        vnd = state->company_id != BT_MESH_CID_NVAL;
 
-        if (err) {
-                LOG_ERR("Failed to get compositin data. Error: %d", err);
-                return err;
-        }
+        /* The three get requests share net_idx, addr, elem_addr, mod_id */
+        args.mod_app_get.net_idx = PRIMARY_SUBNET;
+        args.mod_app_get.addr = addr;
+        args.mod_app_get.elem_addr = state->elem_addr;
+        args.mod_app_get.mod_id = state->model_id;
+        args.mod_app_get.app_cnt = ARRAY_SIZE(args.mod_app_get.apps);
+        args.mod_app_get_vnd.cid = state->company_id;
+        err = btmesh_perform_op(vnd ? BTMESH_OP_MOD_APP_GET_VND : BTMESH_OP_MOD_APP_GET, &args);
 
-        /* Parse through comp data until element info */
-        comp_data = args.comp_get.comp;
-        net_buf_simple_pull_mem(comp_data, 10);
-        num_elem = bt_mesh_cdb_node_get(addr)->num_elem;
+        if (err || args.mod_app_get.status) {
+                return err ? err : -EIO;
+        }
 
-        for (i = 0; i < num_elem; i++) {
-                /* Parse through LOC field */
-                net_buf_simple_pull_le16(comp_data);
+        state->appkey_count = args.mod_app_get.app_cnt;
+        memcpy(state->appkey_idxs, args.mod_app_get.apps, state->appkey_count * sizeof(uint16_t));
 
-                /* Get number of models */
-                num_sig_models = net_buf_simple_pull_u8(comp_data);
-                num_vnd_models = net_buf_simple_pull_u8(comp_data);
-                args.mod_app_get.elem_addr = addr + i;
+        args.mod_sub_get.net_idx = PRIMARY_SUBNET;
+        args.mod_sub_get.addr = addr;
+        args.mod_sub_get.elem_addr = state->elem_addr;
+        args.mod_sub_get.mod_id = state->model_id;
 
-                for (j = 0; j < num_sig_models; j++) {
-                        args.mod_app_get.mod_id = net_buf_simple_pull_le16(comp_data);
-                        args.mod_app_get.app_cnt = sizeof(args.mod_app_get.apps);
-                        err = btmesh_perform_op(BTMESH_OP_MOD_APP_GET, &args);
+        if (vnd) {
+                args.mod_sub_get_vnd.cid = state->company_id;
+                args.mod_sub_get_vnd.sub_cnt = ARRAY_SIZE(args.mod_sub_get_vnd.subs);
+                err = btmesh_perform_op(BTMESH_OP_MOD_SUB_GET_VND, &args);
 
-                        if (err) {
-                                LOG_ERR("Failed to get model app keys. Error: %d", err);
-                                return err;
-                        }
+                if (err || args.mod_sub_get_vnd.status) {
+                        return err ? err : -EIO;
+                }
 
-                        for (k = 0; k < args.mod_app_get.app_cnt; k++) {
-                                if (args.mod_app_get.apps[k] == app_idx) {
-                                        /* At least one model on this node is still using this app key so we must NOT
-                                         * delete it */
-                                        break;
-                                }
-                        }
+                state->sub_addr_count = args.mod_sub_get_vnd.sub_cnt;
+                memcpy(state->sub_addrs, args.mod_sub_get_vnd.subs,
+                                state->sub_addr_count * sizeof(uint16_t));
+        } else {
+                args.mod_sub_get.sub_cnt = ARRAY_SIZE(args.mod_sub_get.subs);
+                err = btmesh_perform_op(BTMESH_OP_MOD_SUB_GET, &args);
 
-                        if (k != args.mod_app_get.app_cnt) {
-                                break;
-                        }
-                        /* If we make it here, this model is NOT using this app key */
+                if (err || args.mod_sub_get.status) {
+                        return err ? err : -EIO;
                 }
 
-                if (j != num_sig_models) {
-                        break;
-                }
-                /* If we make it here, NO SIG models on this element are using this app key */
+                state->sub_addr_count = args.mod_sub_get.sub_cnt;
+                memcpy(state->sub_addrs, args.mod_sub_get.subs,
+                                state->sub_addr_count * sizeof(uint16_t));
+        }
 
-                for (j = 0; j < num_vnd_models; j++) {
-                        args.mod_app_get_vnd.cid = net_buf_simple_pull_le16(comp_data);
-                        args.mod_app_get_vnd.mod_id = net_buf_simple_pull_le16(comp_data);
-                        args.mod_app_get_vnd.app_cnt = sizeof(args.mod_app_get_vnd.apps);
-                        err = btmesh_perform_op(BTMESH_OP_MOD_APP_GET_VND, &args);
+        args.mod_pub_get.net_idx = PRIMARY_SUBNET;
+        args.mod_pub_get.addr = addr;
+        args.mod_pub_get.elem_addr = state->elem_addr;
+        args.mod_pub_get.mod_id = state->model_id;
+        args.mod_pub_get_vnd.cid = state->company_id;
+        err = btmesh_perform_op(vnd ? BTMESH_OP_MOD_PUB_GET_VND : BTMESH_OP_MOD_PUB_GET, &args);
 
-                        if (err) {
-                                LOG_ERR("Failed to get vendor model app keys. Error: %d", err);
-                                return err;
-                        }
+        if (err || args.mod_pub_get.status) {
+                return err ? err : -EIO;
+        }
 
-                        for (k = 0; k < args.mod_app_get_vnd.app_cnt; k++) {
-                                if (args.mod_app_get_vnd.apps[k] == app_idx) {
-                                        /* At least one model on this node is still using this app key so we must NOT
-                                         * delete it */
-                                        break;
-                                }
-                        }
+        state->pub = args.mod_pub_get.pub;
+        state->pub.uuid = NULL;
+        return 0;
+}
 
-                        if (k != args.mod_app_get_vnd.app_cnt) {
-                                break;
-                        }
-                        /* If we make it here, this model is NOT using this app key */
+int btmesh_get_model_state(uint16_t addr, struct btmesh_model_state *state)
+{
+#if defined(CONFIG_GATEWAY_NODE_CACHE)
+        if (!model_state_from_cache(addr, state)) {
+                return 0;
+        }
+#endif // defined(CONFIG_GATEWAY_NODE_CACHE)
+
+        return model_state_from_node(addr, state);
+}
+
+uint32_t btmesh_get_cfg_version(uint16_t addr)
+{
+#if defined(CONFIG_GATEWAY_NODE_CACHE)
+        return node_cache_version_get(addr);
+#else
+        return 0;
+#endif // defined(CONFIG_GATEWAY_NODE_CACHE)
+}
+
+/* Walk the element descriptions of composition data page 0 without consuming them, to check
+ * they are complete and count the models */
+static int comp_data_scan(struct net_buf_simple *comp, size_t elem_count, size_t *sig_count,
+                size_t *vnd_count)
+{
+        int err;
+        size_t i;
+        size_t len;
+        uint8_t sig;
+        uint8_t vnd;
+        struct net_buf_simple_state state;
+
+        err = 0;
+        *sig_count = 0;
+        *vnd_count = 0;
+        net_buf_simple_save(comp, &state);
+
+        for (i = 0; i < elem_count; i++) {
+                if (comp->len < 4) {
+                        err = -EINVAL;
+                        break;
                 }
 
-                if (j != num_vnd_models) {
+                net_buf_simple_pull_le16(comp);
+                sig = net_buf_simple_pull_u8(comp);
+                vnd = net_buf_simple_pull_u8(comp);
+                len = (sig * sizeof(uint16_t)) + (vnd * sizeof(uint32_t));
+
+                if (comp->len < len) {
+                        err = -EINVAL;
                         break;
                 }
-                /* If we make it here, NO vendor models on this element are using this app key */
+
+                net_buf_simple_pull_mem(comp, len);
+                *sig_count += sig;
+                *vnd_count += vnd;
         }
 
-        if (i != num_elem) {
-                /* Some model on some element is still using this app key so no need to delete it */
-                return 0;
+        net_buf_simple_restore(comp, &state);
+        return err;
+}
+
+/* Bookkeeping at the start of a node's block. The element array, the SIG and vendor model
+ * arrays of the whole node and a pool for its key index and address lists follow it. Each
+ * model reserves room in the pool for the longest lists the configuration client can
+ * return, so lists can also be replaced with longer ones later on. */
+struct node_mem {
+        struct btmesh_sig_model *sig_next;
+        struct btmesh_vnd_model *vnd_next;
+        uint16_t *idx_next;
+        size_t sig_left;
+        size_t vnd_left;
+        size_t idx_left;
+};
+
+int btmesh_node_alloc(struct btmesh_node *node, size_t sig_count, size_t vnd_count)
+{
+        size_t size;
+        size_t idx_count;
+        struct arena arena;
+        struct node_mem *mem;
+
+        idx_count = CONFIG_BT_MESH_SUBNET_COUNT + ((sig_count + vnd_count) *
+                        (CONFIG_BT_MESH_APP_KEY_COUNT + CONFIG_BT_MESH_MODEL_GROUP_COUNT));
+        size = ROUND_UP(sizeof(struct node_mem), ARENA_ALIGN) +
+                ROUND_UP(sizeof(struct btmesh_elem) * node->elem_count, ARENA_ALIGN) +
+                ROUND_UP(sizeof(struct btmesh_sig_model) * sig_count, ARENA_ALIGN) +
+                ROUND_UP(sizeof(struct btmesh_vnd_model) * vnd_count, ARENA_ALIGN) +
+                ROUND_UP(sizeof(uint16_t) * idx_count, ARENA_ALIGN);
+
+        node->mem = k_malloc(size);
+
+        if (node->mem == NULL) {
+                return -ENOMEM;
         }
-        /* If we make it here, NO element has amodel that is using this app key so we can go ahead and
-         * delete it */
 
-        args.app_key_del.key_net_idx = bt_mesh_cdb_app_key_get(app_idx)->net_idx;
-        args.app_key_del.key_app_idx = app_idx;
-        err = btmesh_perform_op(BTMESH_OP_APP_KEY_DEL, &args);
+        memset(node->mem, 0, size);
+        arena_init(&arena, node->mem, size);
+
+        /* Zero length arrays are left NULL, the allocations below cannot fail otherwise */
+        mem = arena_alloc(&arena, sizeof(struct node_mem));
+        node->elems = node->elem_count ?
+                arena_alloc(&arena, sizeof(struct btmesh_elem) * node->elem_count) : NULL;
+        mem->sig_next = sig_count ?
+                arena_alloc(&arena, sizeof(struct btmesh_sig_model) * sig_count) : NULL;
+        mem->vnd_next = vnd_count ?
+                arena_alloc(&arena, sizeof(struct btmesh_vnd_model) * vnd_count) : NULL;
+        mem->idx_next = arena_alloc(&arena, sizeof(uint16_t) * idx_count);
+        mem->sig_left = sig_count;
+        mem->vnd_left = vnd_count;
+        mem->idx_left = idx_count;
+
+        LOG_DBG("Node 0x%04x: %d bytes for %d elements, %d models", node->addr, size,
+                        node->elem_count, sig_count + vnd_count);
+        return 0;
+}
 
-        if (err) {
-                LOG_ERR("Failed to delete unused app key from node. Error: %d", err);
-                return err;
+int btmesh_node_elem_init(struct btmesh_node *node, struct btmesh_elem *elem)
+{
+        struct node_mem *mem = node->mem;
+
+        if (elem->sig_model_count > mem->sig_left || elem->vnd_model_count > mem->vnd_left) {
+                return -ENOMEM;
         }
 
+        elem->sig_models = elem->sig_model_count ? mem->sig_next : NULL;
+        elem->vnd_models = elem->vnd_model_count ? mem->vnd_next : NULL;
+        mem->sig_next += elem->sig_model_count;
+        mem->vnd_next += elem->vnd_model_count;
+        mem->sig_left -= elem->sig_model_count;
+        mem->vnd_left -= elem->vnd_model_count;
         return 0;
 }
 
-int btmesh_discover_node(struct btmesh_node *node, uint8_t *status)
+uint16_t *btmesh_node_idx_list(struct btmesh_node *node, const uint16_t *src, size_t count)
+{
+        uint16_t *list;
+        struct node_mem *mem = node->mem;
+
+        if (count == 0 || count > mem->idx_left) {
+                return NULL;
+        }
+
+        list = mem->idx_next;
+        memcpy(list, src, count * sizeof(uint16_t));
+        mem->idx_next += count;
+        mem->idx_left -= count;
+        return list;
+}
+
+static int discover_node(struct btmesh_node *node, uint8_t *status)
 {
         int err;
         uint8_t i;
         uint8_t j;
         uint16_t features;
+        size_t sig_count;
+        size_t vnd_count;
         union btmesh_op_args args;
         struct bt_mesh_cdb_node *cdb_node;
+        struct btmesh_elem *elem;
         struct net_buf_simple *comp_data = NET_BUF_SIMPLE(COMP_DATA_BUF_SIZE);
 
         *status = 0;
 
-        /* Initialize node structure pointers */
-        node->subnet_idxs = NULL;
-        node->elems = NULL;
-
         /* Get the node's UUID, net index, and element count from CDB */
         cdb_node = bt_mesh_cdb_node_get(node->addr);
 
@@ -1578,6 +1883,10 @@ int btmesh_discover_node(struct btmesh_node *node, uint8_t *status)
                 return err;
         }
 
+        if (comp_data->len < 10) {
+                return -EINVAL;
+        }
+
         /* Get all IDs from composition data */
         node->cid = net_buf_simple_pull_le16(comp_data);
         node->pid = net_buf_simple_pull_le16(comp_data);
@@ -1591,6 +1900,20 @@ int btmesh_discover_node(struct btmesh_node *node, uint8_t *status)
         node->friend.support = (bool)(features & 0x0004);
         node->lpn = (bool)(features & 0x0008);
 
+        /* Size the node's memory from the element descriptions before any list is fetched */
+        err = comp_data_scan(comp_data, node->elem_count, &sig_count, &vnd_count);
+
+        if (err) {
+                LOG_ERR("Incomplete composition data from 0x%04x", node->addr);
+                return err;
+        }
+
+        err = btmesh_node_alloc(node, sig_count, vnd_count);
+
+        if (err) {
+                return err;
+        }
+
         /* Get node's network beacon state */
         err = btmesh_perform_op(BTMESH_OP_BEACON_GET, &args);
 
@@ -1687,7 +2010,7 @@ int btmesh_discover_node(struct btmesh_node *node, uint8_t *status)
         }
 
         /* Get node's subnets */
-        args.net_key_get.key_cnt = sizeof(args.net_key_get.keys);
+        args.net_key_get.key_cnt = ARRAY_SIZE(args.net_key_get.keys);
         err = btmesh_perform_op(BTMESH_OP_NET_KEY_GET, &args);
 
         if (err) {
@@ -1695,128 +2018,55 @@ int btmesh_discover_node(struct btmesh_node *node, uint8_t *status)
         };
 
         node->subnet_count = args.net_key_get.key_cnt;
-        node->subnet_idxs = (uint16_t *)k_malloc(sizeof(uint16_t) *
+        node->subnet_idxs = btmesh_node_idx_list(node, args.net_key_get.keys,
                         node->subnet_count);
 
-        if (node->subnet_idxs == NULL) {
-                return -ENOMEM;
-        }
-
-        memcpy(node->subnet_idxs, args.net_key_get.keys,
-                        sizeof(uint16_t) * node->subnet_count);
-
         /* Get the node's elements */
-        node->elems = (struct btmesh_elem *)k_malloc(sizeof(struct btmesh_elem)
-                        * node->elem_count);
-
-        if (node->elems == NULL) {
-                return -ENOMEM;
-        }
-
-        /* Initialize all pointers so they can be free'd later even if unused */
-        for (i = 0; i < node->elem_count; i++) {
-                node->elems[i].sig_models = NULL;
-                node->elems[i].vnd_models = NULL;
-        }
-
         for (i = 0; i < node->elem_count; i++)
         {
-                node->elems[i].addr = node->addr + i;
-                node->elems[i].loc = net_buf_simple_pull_le16(comp_data);
-                node->elems[i].sig_model_count = net_buf_simple_pull_u8(comp_data);
-                node->elems[i].vnd_model_count = net_buf_simple_pull_u8(comp_data);
-
-                node->elems[i].sig_models =
-                        (struct btmesh_sig_model *)k_malloc(sizeof(struct btmesh_sig_model)
-                                        * node->elems[i].sig_model_count);
-
-                if (node->elems[i].sig_models == NULL) {
-                        btmesh_free_node(node);
-                        return -ENOMEM;
-                }
-
-                /* Initialize all pointers so they can be free'd later even if unused */
-                for (j = 0; j < node->elems[i].sig_model_count; j++) {
-                        node->elems[i].sig_models[j].appkey_idxs = NULL;
-                        node->elems[i].sig_models[j].sub_addrs = NULL;
-                }
-
-                node->elems[i].vnd_models =
-                        (struct btmesh_vnd_model *)k_malloc(sizeof(struct btmesh_vnd_model)
-                                        * node->elems[i].vnd_model_count);
-
-                if (node->elems[i].vnd_models == NULL) {
-                        btmesh_free_node(node);
-                        return -ENOMEM;
-                }
-
-                /* Initialize all pointers so they can be free'd later even if unused */
-                for (j = 0; j < node->elems[i].vnd_model_count; j++) {
-                        node->elems[i].vnd_models[j].appkey_idxs = NULL;
-                        node->elems[i].vnd_models[j].sub_addrs = NULL;
-                }
+                elem = &node->elems[i];
+                elem->addr = node->addr + i;
+                elem->loc = net_buf_simple_pull_le16(comp_data);
+                elem->sig_model_count = net_buf_simple_pull_u8(comp_data);
+                elem->vnd_model_count = net_buf_simple_pull_u8(comp_data);
+                btmesh_node_elem_init(node, elem);
 
                 /* Get all SIG models on this element */
-                for (j = 0; j < node->elems[i].sig_model_count; j++) {
-                        node->elems[i].sig_models[j].model_id =
-                                net_buf_simple_pull_le16(comp_data);
+                for (j = 0; j < elem->sig_model_count; j++) {
+                        elem->sig_models[j].model_id = net_buf_simple_pull_le16(comp_data);
 
                         /* Get SIG model's appkey indexes */
-                        args.mod_app_get.elem_addr = node->addr + i;
-                        args.mod_app_get.mod_id = node->elems[i].sig_models[j].model_id;
-                        args.mod_app_get.app_cnt = sizeof(args.mod_app_get.apps);
+                        args.mod_app_get.elem_addr = elem->addr;
+                        args.mod_app_get.mod_id = elem->sig_models[j].model_id;
+                        args.mod_app_get.app_cnt = ARRAY_SIZE(args.mod_app_get.apps);
                         err = btmesh_perform_op(BTMESH_OP_MOD_APP_GET, &args);
 
                         if (err || args.mod_app_get.status) {
                                 *status = args.mod_app_get.status;
-                                btmesh_free_node(node);
                                 return err;
                         }
 
-                        node->elems[i].sig_models[j].appkey_count =
-                                args.mod_app_get.app_cnt;
-                        node->elems[i].sig_models[j].appkey_idxs =
-                                (uint16_t *)k_malloc(sizeof(uint16_t) *
-                                                node->elems[i].sig_models[j].appkey_count);
-
-                        if (node->elems[i].sig_models[j].appkey_idxs == NULL) {
-                                btmesh_free_node(node);
-                                return -ENOMEM;
-                        }
-
-                        memcpy(node->elems[i].sig_models[j].appkey_idxs,
-                                        args.mod_app_get.apps, sizeof(uint16_t) *
-                                        node->elems[i].sig_models[j].appkey_count);
+                        elem->sig_models[j].appkey_count = args.mod_app_get.app_cnt;
+                        elem->sig_models[j].appkey_idxs = btmesh_node_idx_list(node,
+                                        args.mod_app_get.apps, args.mod_app_get.app_cnt);
 
                         /* Get SIG model's subscribe addresses */
-                        args.mod_sub_get.sub_cnt = sizeof(args.mod_sub_get.subs);
+                        args.mod_sub_get.sub_cnt = ARRAY_SIZE(args.mod_sub_get.subs);
                         err = btmesh_perform_op(BTMESH_OP_MOD_SUB_GET, &args);
 
                         if (err || args.mod_sub_get.status) {
                                 *status = args.mod_sub_get.status;
-                                btmesh_free_node(node);
                                 return err;
                         }
 
-                        node->elems[i].sig_models[j].sub_addr_count =
-                                args.mod_sub_get.sub_cnt;
-                        node->elems[i].sig_models[j].sub_addrs =
-                                (uint16_t *)k_malloc(sizeof(uint16_t) * 
-                                                node->elems[i].sig_models[j].sub_addr_count);
-
-                        if (node->elems[i].sig_models[j].sub_addrs == NULL) {
-                                btmesh_free_node(node);
-                                return -ENOMEM;
-                        }
-
-                        memcpy(node->elems[i].sig_models[j].sub_addrs,
-                                        args.mod_sub_get.subs, sizeof(uint16_t) *
-                                        node->elems[i].sig_models[j].sub_addr_count);
+                        elem->sig_models[j].sub_addr_count = args.mod_sub_get.sub_cnt;
+                        elem->sig_models[j].sub_addrs = btmesh_node_idx_list(node,
+                                        args.mod_sub_get.subs, args.mod_sub_get.sub_cnt);
 
                         /* Get SIG model's publish parameters */
                         /* SIG model ID 0x0000 is configuration server model and has no
                          * user definable publish parameters */
-                        if (node->elems[i].sig_models[j].model_id == 0x0000) {
+                        if (elem->sig_models[j].model_id == 0x0000) {
                                 continue;
                         }
 
@@ -1824,105 +2074,112 @@ int btmesh_discover_node(struct btmesh_node *node, uint8_t *status)
 
                         if (err || args.mod_pub_get.status) {
                                 *status = args.mod_pub_get.status;
-                                btmesh_free_node(node);
                                 return err;
                         }
 
-                        memcpy(&node->elems[i].sig_models[j].pub, &args.mod_pub_get.pub,
+                        memcpy(&elem->sig_models[j].pub, &args.mod_pub_get.pub,
                                         sizeof(struct bt_mesh_cfg_mod_pub));
                 }
 
                 /* Get all vendor models on this element */
-                for (j = 0; j < node->elems[i].vnd_model_count; j++) {
-                        node->elems[i].vnd_models[j].company_id =
-                                net_buf_simple_pull_le16(comp_data);
-                        node->elems[i].vnd_models[j].model_id =
-                                net_buf_simple_pull_le16(comp_data);
+                for (j = 0; j < elem->vnd_model_count; j++) {
+                        elem->vnd_models[j].company_id = net_buf_simple_pull_le16(comp_data);
+                        elem->vnd_models[j].model_id = net_buf_simple_pull_le16(comp_data);
 
                         /* Get vendor model's appkey indexes */
-                        args.mod_app_get_vnd.mod_id = node->elems[i].vnd_models[j].model_id;
-                        args.mod_app_get_vnd.cid = node->elems[i].vnd_models[j].company_id;
-                        args.mod_app_get_vnd.app_cnt = sizeof(args.mod_app_get_vnd.apps);
+                        args.mod_app_get_vnd.elem_addr = elem->addr;
+                        args.mod_app_get_vnd.mod_id = elem->vnd_models[j].model_id;
+                        args.mod_app_get_vnd.cid = elem->vnd_models[j].company_id;
+                        args.mod_app_get_vnd.app_cnt = ARRAY_SIZE(args.mod_app_get_vnd.apps);
                         err = btmesh_perform_op(BTMESH_OP_MOD_APP_GET_VND, &args);
 
                         if (err || args.mod_app_get_vnd.status) {
                                 *status = args.mod_app_get_vnd.status;
-                                btmesh_free_node(node);
                                 return err;
                         }
 
-                        node->elems[i].vnd_models[j].appkey_count =
-                                args.mod_app_get_vnd.app_cnt;
-                        node->elems[i].vnd_models[j].appkey_idxs =
-                                (uint16_t *)k_malloc(sizeof(uint16_t) *
-                                                node->elems[i].vnd_models[j].appkey_count);
-
-                        if (node->elems[i].vnd_models[j].appkey_idxs == NULL) {
-                                btmesh_free_node(node);
-                                return -ENOMEM;
-                        }
-
-                        memcpy(node->elems[i].vnd_models[j].appkey_idxs,
-                                        args.mod_app_get_vnd.apps, sizeof(uint16_t) *
-                                        node->elems[i].vnd_models[j].appkey_count);
+                        elem->vnd_models[j].appkey_count = args.mod_app_get_vnd.app_cnt;
+                        elem->vnd_models[j].appkey_idxs = btmesh_node_idx_list(node,
+                                        args.mod_app_get_vnd.apps,
+                                        args.mod_app_get_vnd.app_cnt);
 
                         /* Get vendor model's subscribe addresses */
-                        args.mod_sub_get_vnd.sub_cnt = sizeof(args.mod_sub_get_vnd.subs);
-			args.mod_sub_get_vnd.cid = node->elems[i].vnd_models[j].company_id;
+                        args.mod_sub_get_vnd.sub_cnt = ARRAY_SIZE(args.mod_sub_get_vnd.subs);
+                        args.mod_sub_get_vnd.cid = elem->vnd_models[j].company_id;
                         err = btmesh_perform_op(BTMESH_OP_MOD_SUB_GET_VND, &args);
 
                         if (err || args.mod_sub_get_vnd.status) {
                                 *status = args.mod_sub_get_vnd.status;
-                                btmesh_free_node(node);
                                 return err;
                         }
 
-                        node->elems[i].vnd_models[j].sub_addr_count =
-                                args.mod_sub_get_vnd.sub_cnt;
-                        node->elems[i].vnd_models[j].sub_addrs =
-                                (uint16_t *)k_malloc(sizeof(uint16_t) *
-                                                node->elems[i].vnd_models[j].sub_addr_count);
-
-                        if (node->elems[i].vnd_models[j].sub_addrs == NULL) {
-                                btmesh_free_node(node);
-                                return -ENOMEM;
-                        }
-
-                        memcpy(node->elems[i].vnd_models[j].sub_addrs,
-                                        args.mod_sub_get_vnd.subs, sizeof(uint16_t) *
-                                        node->elems[i].vnd_models[j].sub_addr_count);
+                        elem->vnd_models[j].sub_addr_count = args.mod_sub_get_vnd.sub_cnt;
+                        elem->vnd_models[j].sub_addrs = btmesh_node_idx_list(node,
+                                        args.mod_sub_get_vnd.subs,
+                                        args.mod_sub_get_vnd.sub_cnt);
 
                         /* Get vendor model publish parameters */
-			args.mod_pub_get_vnd.cid = node->elems[i].vnd_models[j].company_id;
+                        args.mod_pub_get_vnd.cid = elem->vnd_models[j].company_id;
                         err = btmesh_perform_op(BTMESH_OP_MOD_PUB_GET_VND, &args);
 
                         if (err || args.mod_pub_get_vnd.status) {
                                 *status = args.mod_pub_get_vnd.status;
-                                btmesh_free_node(node);
                                 return err;
                         }
 
-                        memcpy(&node->elems[i].vnd_models[j].pub, &args.mod_pub_get_vnd.pub,
+                        memcpy(&elem->vnd_models[j].pub, &args.mod_pub_get_vnd.pub,
                                         sizeof(struct bt_mesh_cfg_mod_pub));
                 }
-        } 
+        }
 
-        return err;
+        return 0;
+}
+
+int btmesh_discover_node(struct btmesh_node *node, uint8_t *status)
+{
+        int err;
+
+        node->mem = NULL;
+        node->subnet_idxs = NULL;
+        node->elems = NULL;
+        node->cfg_version = 0;
+
+        err = discover_node(node, status);
+
+        /* A node is only handed out complete, or not at all */
+        if (err || *status) {
+                btmesh_free_node(node);
+                return err;
+        }
+
+#if defined(CONFIG_GATEWAY_NODE_CACHE)
+        node_cache_store(node);
+#endif // defined(CONFIG_GATEWAY_NODE_CACHE)
+
+        return 0;
+}
+
+int btmesh_get_node(struct btmesh_node *node, uint8_t *status, bool refresh)
+{
+#if defined(CONFIG_GATEWAY_NODE_CACHE)
+        if (!refresh && !node_cache_load(node->addr, node)) {
+                *status = 0;
+                return 0;
+        }
+#endif // defined(CONFIG_GATEWAY_NODE_CACHE)
+
+        return btmesh_discover_node(node, status);
 }
 
 int btmesh_init(void)
 {
         int err;
-        uint16_t i;
         uint8_t net_key[16];
         uint8_t dev_key[16];
         struct bt_mesh_cdb_node *self;
 
-        /* Initialize beacon timer structures */
-        for (i = 0; i < MAX_BEACON; i++) {
-                k_timer_init(&beacon_timer_list[i], beacon_timer_handler, NULL);
-                k_timer_user_data_set(&beacon_timer_list[i], NULL);
-        }
+        beacon_table_init();
+        beacon_block_init();
 
         err = bt_enable(NULL);
 
@@ -1992,6 +2249,8 @@ int btmesh_init(void)
         }
 
 #if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+        cfg_async_init();
+        cfg_async_timeout_cb_set(mesh_retry_rto_get);
         bt_mesh_msg_cb_set(btmesh_msg_cb);
 #endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
 
@@ -69,10 +69,27 @@ struct btmesh_node {
         struct btmesh_feature proxy;
         struct btmesh_feature friend;
         bool lpn;
+        /* Configuration changes seen by the node cache, 0 if not tracked */
+        uint32_t cfg_version;
         size_t subnet_count;
         uint16_t *subnet_idxs;
         size_t elem_count;
         struct btmesh_elem *elems;
+        /* Backs subnet_idxs, elems and every model array, released by btmesh_free_node() */
+        void *mem;
+};
+
+/* Configuration of a single SIG or vendor model, company_id is BT_MESH_CID_NVAL for SIG
+ * models */
+struct btmesh_model_state {
+        uint16_t elem_addr;
+        uint16_t model_id;
+        uint16_t company_id;
+        size_t appkey_count;
+        uint16_t appkey_idxs[CONFIG_BT_MESH_APP_KEY_COUNT];
+        size_t sub_addr_count;
+        uint16_t sub_addrs[CONFIG_BT_MESH_MODEL_GROUP_COUNT];
+        struct bt_mesh_cfg_mod_pub pub;
 };
 
 enum btmesh_op
@@ -126,7 +143,8 @@ enum btmesh_op
 	BTMESH_OP_HB_SUB_GET,
 	BTMESH_OP_HB_SUB_SET,
 	BTMESH_OP_HB_PUB_GET,
-	BTMESH_OP_HB_PUB_SET
+	BTMESH_OP_HB_PUB_SET,
+	BTMESH_OP_COUNT
 };
 
 union btmesh_op_args {
@@ -485,30 +503,25 @@ union btmesh_op_args {
 
 enum btmesh_sub_type {
         BTMESH_SUB_TYPE_CLI,
-        BTMESH_SUB_TYPE_GATEWAY
+        BTMESH_SUB_TYPE_GATEWAY,
+        BTMESH_SUB_TYPE_COUNT
 };
 
 const char* btmesh_parse_opcode(uint32_t opcode);
 
-int btmesh_subscribe(enum btmesh_sub_type type, uint16_t addr);
-
-void btmesh_unsubscribe(enum btmesh_sub_type type, uint16_t addr);
-
-const uint16_t *btmesh_get_subscribe_list(enum btmesh_sub_type);
-
 const char *btmesh_get_sig_model_str(uint16_t model_id);
 
-const char *btmesh_get_blocked_beacon(size_t idx);
+const char *btmesh_get_op_str(enum btmesh_op op);
 
-int btmesh_block_beacon(uint8_t uuid[UUID_LEN]);
+/* Configuration status code returned for op, 0 for operations that report a state instead */
+uint8_t btmesh_get_op_status(enum btmesh_op op, const union btmesh_op_args *args);
 
-int btmesh_unblock_beacon(uint8_t uuid[UUID_LEN]);
+/* Fill in the element, model and company id of the model op acts on. Returns -EINVAL for
+ * operations that do not act on a model. */
+int btmesh_get_op_model(enum btmesh_op op, const union btmesh_op_args *args,
+                struct btmesh_model_state *state);
 
-const char *btmesh_get_beacon_uuid(size_t idx);
-
-const char *btmesh_get_beacon_oob(size_t idx);
-
-const uint32_t *btmesh_get_beacon_uri_hash(size_t idx);
+const char *btmesh_get_oob_str(bt_mesh_prov_oob_info_t oob_info);
 
 uint8_t btmesh_get_pub_period(uint8_t period);
 
@@ -516,12 +529,35 @@ char * btmesh_get_pub_period_unit_str(uint8_t period);
 
 void btmesh_free_node(struct btmesh_node *node);
 
+/* Allocate the single block backing a node with elem_count elements. Elements then take
+ * their model arrays with btmesh_node_elem_init() and lists are copied in with
+ * btmesh_node_idx_list(). */
+int btmesh_node_alloc(struct btmesh_node *node, size_t sig_count, size_t vnd_count);
+
+int btmesh_node_elem_init(struct btmesh_node *node, struct btmesh_elem *elem);
+
+uint16_t *btmesh_node_idx_list(struct btmesh_node *node, const uint16_t *src, size_t count);
+
 int btmesh_discover_node(struct btmesh_node *node, uint8_t *status);
 
+/* Like btmesh_discover_node(), but served from the node cache unless refresh is set */
+int btmesh_get_node(struct btmesh_node *node, uint8_t *status, bool refresh);
+
 int btmesh_perform_op(enum btmesh_op op, union btmesh_op_args* args);
 
 int btmesh_clean_node_key(uint16_t addr, uint16_t app_idx);
 
+/* btmesh_perform_op() for node configuration requests. Binding a model first adds the app
+ * key to the node if it does not have it yet, and unbinding the last model from a key
+ * deletes the key from the node. */
+int btmesh_perform_cfg_op(enum btmesh_op op, union btmesh_op_args *args);
+
+/* Current configuration of the model selected by state. Served from the node cache when
+ * possible, otherwise read from the node. */
+int btmesh_get_model_state(uint16_t addr, struct btmesh_model_state *state);
+
+uint32_t btmesh_get_cfg_version(uint16_t addr);
+
 int btmesh_init(void);
 
 
@@ -0,0 +1,1160 @@
+#include <zephyr.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+#include <logging/log.h>
+
+/* Include mesh stack header for direct access to mesh access layer messaging. */
+#include "mesh/net.h"
+#include "mesh/access.h"
+
+#include "cfg_async.h"
+
+/* Configuration Client opcodes used by the getters and setters */
+#define OP_APP_KEY_ADD BT_MESH_MODEL_OP_1(0x00)
+#define OP_MOD_PUB_SET BT_MESH_MODEL_OP_1(0x03)
+#define OP_APP_KEY_DEL BT_MESH_MODEL_OP_2(0x80, 0x00)
+#define OP_APP_KEY_GET BT_MESH_MODEL_OP_2(0x80, 0x01)
+#define OP_APP_KEY_LIST BT_MESH_MODEL_OP_2(0x80, 0x02)
+#define OP_APP_KEY_STATUS BT_MESH_MODEL_OP_2(0x80, 0x03)
+#define OP_DEV_COMP_DATA_GET BT_MESH_MODEL_OP_2(0x80, 0x08)
+#define OP_DEV_COMP_DATA_STATUS BT_MESH_MODEL_OP_1(0x02)
+#define OP_BEACON_GET BT_MESH_MODEL_OP_2(0x80, 0x09)
+#define OP_BEACON_SET BT_MESH_MODEL_OP_2(0x80, 0x0a)
+#define OP_BEACON_STATUS BT_MESH_MODEL_OP_2(0x80, 0x0b)
+#define OP_DEFAULT_TTL_GET BT_MESH_MODEL_OP_2(0x80, 0x0c)
+#define OP_DEFAULT_TTL_SET BT_MESH_MODEL_OP_2(0x80, 0x0d)
+#define OP_DEFAULT_TTL_STATUS BT_MESH_MODEL_OP_2(0x80, 0x0e)
+#define OP_FRIEND_GET BT_MESH_MODEL_OP_2(0x80, 0x0f)
+#define OP_FRIEND_SET BT_MESH_MODEL_OP_2(0x80, 0x10)
+#define OP_FRIEND_STATUS BT_MESH_MODEL_OP_2(0x80, 0x11)
+#define OP_GATT_PROXY_GET BT_MESH_MODEL_OP_2(0x80, 0x12)
+#define OP_GATT_PROXY_SET BT_MESH_MODEL_OP_2(0x80, 0x13)
+#define OP_GATT_PROXY_STATUS BT_MESH_MODEL_OP_2(0x80, 0x14)
+#define OP_MOD_PUB_GET BT_MESH_MODEL_OP_2(0x80, 0x18)
+#define OP_MOD_PUB_STATUS BT_MESH_MODEL_OP_2(0x80, 0x19)
+#define OP_MOD_SUB_ADD BT_MESH_MODEL_OP_2(0x80, 0x1b)
+#define OP_MOD_SUB_DEL BT_MESH_MODEL_OP_2(0x80, 0x1c)
+#define OP_MOD_SUB_OVERWRITE BT_MESH_MODEL_OP_2(0x80, 0x1e)
+#define OP_MOD_SUB_STATUS BT_MESH_MODEL_OP_2(0x80, 0x1f)
+#define OP_RELAY_GET BT_MESH_MODEL_OP_2(0x80, 0x26)
+#define OP_RELAY_SET BT_MESH_MODEL_OP_2(0x80, 0x27)
+#define OP_RELAY_STATUS BT_MESH_MODEL_OP_2(0x80, 0x28)
+#define OP_MOD_SUB_GET BT_MESH_MODEL_OP_2(0x80, 0x29)
+#define OP_MOD_SUB_LIST BT_MESH_MODEL_OP_2(0x80, 0x2a)
+#define OP_MOD_SUB_GET_VND BT_MESH_MODEL_OP_2(0x80, 0x2b)
+#define OP_MOD_SUB_LIST_VND BT_MESH_MODEL_OP_2(0x80, 0x2c)
+#define OP_HEARTBEAT_PUB_STATUS BT_MESH_MODEL_OP_1(0x06)
+#define OP_HEARTBEAT_PUB_GET BT_MESH_MODEL_OP_2(0x80, 0x38)
+#define OP_HEARTBEAT_PUB_SET BT_MESH_MODEL_OP_2(0x80, 0x39)
+#define OP_HEARTBEAT_SUB_GET BT_MESH_MODEL_OP_2(0x80, 0x3a)
+#define OP_HEARTBEAT_SUB_SET BT_MESH_MODEL_OP_2(0x80, 0x3b)
+#define OP_HEARTBEAT_SUB_STATUS BT_MESH_MODEL_OP_2(0x80, 0x3c)
+#define OP_MOD_APP_BIND BT_MESH_MODEL_OP_2(0x80, 0x3d)
+#define OP_MOD_APP_STATUS BT_MESH_MODEL_OP_2(0x80, 0x3e)
+#define OP_MOD_APP_UNBIND BT_MESH_MODEL_OP_2(0x80, 0x3f)
+#define OP_NET_KEY_ADD BT_MESH_MODEL_OP_2(0x80, 0x40)
+#define OP_NET_KEY_DEL BT_MESH_MODEL_OP_2(0x80, 0x41)
+#define OP_NET_KEY_GET BT_MESH_MODEL_OP_2(0x80, 0x42)
+#define OP_NET_KEY_LIST BT_MESH_MODEL_OP_2(0x80, 0x43)
+#define OP_NET_KEY_STATUS BT_MESH_MODEL_OP_2(0x80, 0x44)
+#define OP_NODE_RESET BT_MESH_MODEL_OP_2(0x80, 0x49)
+#define OP_NODE_RESET_STATUS BT_MESH_MODEL_OP_2(0x80, 0x4a)
+#define OP_SIG_MOD_APP_GET BT_MESH_MODEL_OP_2(0x80, 0x4b)
+#define OP_SIG_MOD_APP_LIST BT_MESH_MODEL_OP_2(0x80, 0x4c)
+#define OP_VND_MOD_APP_GET BT_MESH_MODEL_OP_2(0x80, 0x4d)
+#define OP_VND_MOD_APP_LIST BT_MESH_MODEL_OP_2(0x80, 0x4e)
+
+/* Longest request parameters: element address, company ID and model ID. Setters with longer
+ * parameters are matched on their first KEY_MAX_LEN bytes. */
+#define KEY_MAX_LEN 6
+/* Packed NetKey and AppKey index */
+#define APP_KEY_IDX_LEN 3
+/* A timeout firing this early belongs to an earlier request on the same slot */
+#define TIMEOUT_SLACK_MS 10
+
+
+LOG_MODULE_REGISTER(app_cfg_async, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+struct slot {
+	bool busy;
+	uint16_t addr;
+	uint32_t rsp_op;
+	int64_t deadline;
+	cfg_async_match_t match;
+	const void *key;
+	cfg_async_cb_t cb;
+	void *user_data;
+	struct k_work_delayable timeout;
+};
+
+struct sync_ctx {
+	struct k_sem sem;
+	int err;
+	cfg_async_parse_t parse;
+	void *param;
+};
+
+/* Request parameters echoed back at a fixed offset of the status message */
+struct echo_key {
+	uint8_t offset;
+	uint8_t len;
+	uint8_t data[KEY_MAX_LEN];
+};
+
+struct pub_key {
+	uint16_t elem_addr;
+	uint16_t mod_id;
+	uint16_t cid;
+	bool vnd;
+};
+
+struct list_param {
+	uint8_t *status;
+	uint16_t *list;
+	size_t *count;
+};
+
+struct comp_param {
+	uint8_t *status;
+	struct net_buf_simple *comp;
+};
+
+struct relay_param {
+	uint8_t *status;
+	uint8_t *transmit;
+};
+
+struct pub_param {
+	uint8_t *status;
+	struct bt_mesh_cfg_mod_pub *pub;
+};
+
+struct hb_sub_param {
+	uint8_t *status;
+	struct bt_mesh_cfg_hb_sub *sub;
+};
+
+struct hb_pub_param {
+	uint8_t *status;
+	struct bt_mesh_cfg_hb_pub *pub;
+};
+
+static struct slot slots[CONFIG_GATEWAY_CFG_CLI_SLOTS];
+static struct k_spinlock lock;
+static cfg_async_timeout_t timeout_cb;
+
+static void slot_timeout(struct k_work *work)
+{
+	uint16_t addr;
+	uint32_t rsp_op;
+	void *user_data;
+	cfg_async_cb_t cb;
+	k_spinlock_key_t key;
+	struct k_work_delayable *dwork;
+	struct slot *slot;
+
+	dwork = k_work_delayable_from_work(work);
+	slot = CONTAINER_OF(dwork, struct slot, timeout);
+	key = k_spin_lock(&lock);
+
+	/* The slot may already have been answered, or even reused for a new request */
+	if (!slot->busy || slot->deadline - k_uptime_get() > TIMEOUT_SLACK_MS) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	slot->busy = false;
+	addr = slot->addr;
+	rsp_op = slot->rsp_op;
+	cb = slot->cb;
+	user_data = slot->user_data;
+	k_spin_unlock(&lock, key);
+
+	LOG_WRN("Config request to 0x%04x timed out (status 0x%04x)", addr, rsp_op);
+	cb(-ETIMEDOUT, NULL, user_data);
+}
+
+int cfg_async_send(const struct cfg_async_req *req, struct net_buf_simple *msg)
+{
+	int i;
+	int err;
+	int pending;
+	int32_t timeout_ms;
+	k_spinlock_key_t key;
+	struct slot *slot;
+	struct bt_mesh_msg_ctx ctx = {
+		.net_idx = req->net_idx,
+		.app_idx = BT_MESH_KEY_DEV_REMOTE,
+		.addr = req->addr,
+		.send_ttl = BT_MESH_TTL_DEFAULT,
+	};
+
+	if (req->cb == NULL) {
+		return -EINVAL;
+	}
+
+	timeout_ms = req->timeout_ms;
+
+	if (timeout_ms <= 0) {
+		timeout_ms = timeout_cb ? timeout_cb(req->addr) : CONFIG_GATEWAY_CFG_CLI_TIMEOUT_MS;
+	}
+	slot = NULL;
+	pending = 0;
+	key = k_spin_lock(&lock);
+
+	for (i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (!slots[i].busy) {
+			if (slot == NULL) {
+				slot = &slots[i];
+			}
+		} else if (slots[i].addr == req->addr) {
+			pending++;
+		}
+	}
+
+	/* Nodes usually have a single segmented transmit context, so limit how many answers
+	 * one node is asked for at a time */
+	if (slot == NULL || pending >= CONFIG_GATEWAY_CFG_CLI_NODE_MAX) {
+		k_spin_unlock(&lock, key);
+		return -EBUSY;
+	}
+
+	slot->busy = true;
+	slot->addr = req->addr;
+	slot->rsp_op = req->rsp_op;
+	slot->deadline = k_uptime_get() + timeout_ms;
+	slot->match = req->match;
+	slot->key = req->key;
+	slot->cb = req->cb;
+	slot->user_data = req->user_data;
+	k_work_reschedule(&slot->timeout, K_MSEC(timeout_ms));
+	k_spin_unlock(&lock, key);
+
+	err = bt_mesh_msg_send(&ctx, msg, bt_mesh_primary_addr(), NULL, NULL);
+
+	if (err) {
+		key = k_spin_lock(&lock);
+		slot->busy = false;
+		k_work_cancel_delayable(&slot->timeout);
+		k_spin_unlock(&lock, key);
+		return err;
+	}
+
+	return 0;
+}
+
+bool cfg_async_recv(uint32_t opcode, struct bt_mesh_msg_ctx *ctx, struct net_buf_simple *buf)
+{
+	int i;
+	void *user_data;
+	cfg_async_cb_t cb;
+	k_spinlock_key_t key;
+	struct slot *slot;
+	struct net_buf_simple rsp;
+
+	cb = NULL;
+	user_data = NULL;
+	key = k_spin_lock(&lock);
+
+	for (i = 0; i < ARRAY_SIZE(slots); i++) {
+		slot = &slots[i];
+
+		if (!slot->busy || slot->addr != ctx->addr || slot->rsp_op != opcode) {
+			continue;
+		}
+
+		net_buf_simple_clone(buf, &rsp);
+
+		if (slot->match != NULL && !slot->match(&rsp, slot->key)) {
+			continue;
+		}
+
+		slot->busy = false;
+		k_work_cancel_delayable(&slot->timeout);
+		cb = slot->cb;
+		user_data = slot->user_data;
+		break;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	if (cb == NULL) {
+		return false;
+	}
+
+	net_buf_simple_clone(buf, &rsp);
+	cb(0, &rsp, user_data);
+	return true;
+}
+
+static void sync_cb(int err, struct net_buf_simple *rsp, void *user_data)
+{
+	struct sync_ctx *sync;
+
+	sync = (struct sync_ctx *)user_data;
+
+	if (!err && sync->parse != NULL) {
+		err = sync->parse(rsp, sync->param);
+	}
+
+	sync->err = err;
+	k_sem_give(&sync->sem);
+}
+
+int cfg_async_send_sync(struct cfg_async_req *req, struct net_buf_simple *msg,
+		cfg_async_parse_t parse, void *param)
+{
+	int err;
+	struct sync_ctx sync;
+
+	k_sem_init(&sync.sem, 0, 1);
+	sync.err = 0;
+	sync.parse = parse;
+	sync.param = param;
+	req->cb = sync_cb;
+	req->user_data = &sync;
+	err = cfg_async_send(req, msg);
+
+	if (err) {
+		return err;
+	}
+
+	/* Every request completes, at the latest when its timeout fires */
+	k_sem_take(&sync.sem, K_FOREVER);
+	return sync.err;
+}
+
+static bool echo_match(struct net_buf_simple *rsp, const void *key)
+{
+	const struct echo_key *echo;
+
+	echo = (const struct echo_key *)key;
+
+	return rsp->len >= echo->offset + echo->len &&
+	       !memcmp(&rsp->data[echo->offset], echo->data, echo->len);
+}
+
+/* The request parameters are appended to msg and remembered as the key the status message
+ * must echo back after its status byte */
+static void echo_key_init(struct echo_key *echo, struct net_buf_simple *msg, size_t param_offset)
+{
+	echo->offset = 1;
+	echo->len = MIN(msg->len - param_offset, KEY_MAX_LEN);
+	memcpy(echo->data, &msg->data[param_offset], echo->len);
+}
+
+static int get_sync(uint16_t net_idx, uint16_t addr, uint32_t rsp_op, struct net_buf_simple *msg,
+		cfg_async_match_t match, const void *key, cfg_async_parse_t parse, void *param)
+{
+	struct cfg_async_req req = {
+		.net_idx = net_idx,
+		.addr = addr,
+		.rsp_op = rsp_op,
+		.match = match,
+		.key = key,
+	};
+
+	return cfg_async_send_sync(&req, msg, parse, param);
+}
+
+static int parse_u8(struct net_buf_simple *rsp, void *param)
+{
+	if (rsp->len < 1) {
+		return -EMSGSIZE;
+	}
+
+	*(uint8_t *)param = net_buf_simple_pull_u8(rsp);
+	return 0;
+}
+
+/* Two 12-bit key indexes are packed into three bytes, an odd last index takes two */
+static size_t key_idx_unpack(struct net_buf_simple *rsp, uint16_t *list, size_t max)
+{
+	size_t i;
+
+	for (i = 0; rsp->len >= 2 && i < max; ) {
+		if (rsp->len >= 3) {
+			list[i++] = sys_get_le16(&rsp->data[0]) & 0xfff;
+
+			if (i < max) {
+				list[i++] = sys_get_le16(&rsp->data[1]) >> 4;
+			}
+
+			net_buf_simple_pull(rsp, 3);
+		} else {
+			list[i++] = net_buf_simple_pull_le16(rsp) & 0xfff;
+		}
+	}
+
+	return i;
+}
+
+static int parse_key_list(struct net_buf_simple *rsp, void *param)
+{
+	struct list_param *list;
+
+	list = (struct list_param *)param;
+
+	if (list->status != NULL) {
+		if (rsp->len < 1) {
+			return -EMSGSIZE;
+		}
+
+		*list->status = net_buf_simple_pull_u8(rsp);
+	}
+
+	*list->count = key_idx_unpack(rsp, list->list, *list->count);
+	return 0;
+}
+
+static int parse_mod_key_list(struct net_buf_simple *rsp, void *param, size_t mod_len)
+{
+	struct list_param *list;
+
+	list = (struct list_param *)param;
+
+	if (rsp->len < 3 + mod_len) {
+		return -EMSGSIZE;
+	}
+
+	*list->status = net_buf_simple_pull_u8(rsp);
+	net_buf_simple_pull(rsp, 2 + mod_len);
+	*list->count = key_idx_unpack(rsp, list->list, *list->count);
+	return 0;
+}
+
+static int parse_mod_app_list(struct net_buf_simple *rsp, void *param)
+{
+	return parse_mod_key_list(rsp, param, 2);
+}
+
+static int parse_mod_app_list_vnd(struct net_buf_simple *rsp, void *param)
+{
+	return parse_mod_key_list(rsp, param, 4);
+}
+
+static int parse_mod_sub_list(struct net_buf_simple *rsp, void *param, size_t mod_len)
+{
+	size_t i;
+	struct list_param *list;
+
+	list = (struct list_param *)param;
+
+	if (rsp->len < 3 + mod_len) {
+		return -EMSGSIZE;
+	}
+
+	*list->status = net_buf_simple_pull_u8(rsp);
+	net_buf_simple_pull(rsp, 2 + mod_len);
+
+	for (i = 0; rsp->len >= 2 && i < *list->count; i++) {
+		list->list[i] = net_buf_simple_pull_le16(rsp);
+	}
+
+	*list->count = i;
+	return 0;
+}
+
+static int parse_mod_sub_list_sig(struct net_buf_simple *rsp, void *param)
+{
+	return parse_mod_sub_list(rsp, param, 2);
+}
+
+static int parse_mod_sub_list_vnd(struct net_buf_simple *rsp, void *param)
+{
+	return parse_mod_sub_list(rsp, param, 4);
+}
+
+static int parse_comp_data(struct net_buf_simple *rsp, void *param)
+{
+	struct comp_param *comp;
+
+	comp = (struct comp_param *)param;
+
+	if (rsp->len < 1) {
+		return -EMSGSIZE;
+	}
+
+	*comp->status = net_buf_simple_pull_u8(rsp);
+	net_buf_simple_add_mem(comp->comp, rsp->data,
+			MIN(net_buf_simple_tailroom(comp->comp), rsp->len));
+	return 0;
+}
+
+static int parse_relay(struct net_buf_simple *rsp, void *param)
+{
+	struct relay_param *relay;
+
+	relay = (struct relay_param *)param;
+
+	if (rsp->len < 2) {
+		return -EMSGSIZE;
+	}
+
+	*relay->status = net_buf_simple_pull_u8(rsp);
+	*relay->transmit = net_buf_simple_pull_u8(rsp);
+	return 0;
+}
+
+static bool pub_match(struct net_buf_simple *rsp, const void *key)
+{
+	const struct pub_key *pub;
+
+	pub = (const struct pub_key *)key;
+
+	/* Status, element address, publish address, app key index, TTL, period and transmit
+	 * come before the model ID */
+	if (pub->vnd) {
+		return rsp->len >= 14 && sys_get_le16(&rsp->data[1]) == pub->elem_addr &&
+		       sys_get_le16(&rsp->data[10]) == pub->cid &&
+		       sys_get_le16(&rsp->data[12]) == pub->mod_id;
+	}
+
+	return rsp->len >= 12 && sys_get_le16(&rsp->data[1]) == pub->elem_addr &&
+	       sys_get_le16(&rsp->data[10]) == pub->mod_id;
+}
+
+static int parse_mod_pub(struct net_buf_simple *rsp, void *param)
+{
+	uint16_t app_idx;
+	struct pub_param *pub;
+
+	pub = (struct pub_param *)param;
+
+	if (rsp->len < 10) {
+		return -EMSGSIZE;
+	}
+
+	*pub->status = net_buf_simple_pull_u8(rsp);
+	net_buf_simple_pull_le16(rsp);
+	pub->pub->addr = net_buf_simple_pull_le16(rsp);
+	app_idx = net_buf_simple_pull_le16(rsp);
+	pub->pub->app_idx = app_idx & BIT_MASK(12);
+	pub->pub->cred_flag = (app_idx & BIT(12)) != 0;
+	pub->pub->ttl = net_buf_simple_pull_u8(rsp);
+	pub->pub->period = net_buf_simple_pull_u8(rsp);
+	pub->pub->transmit = net_buf_simple_pull_u8(rsp);
+	return 0;
+}
+
+static int parse_hb_sub(struct net_buf_simple *rsp, void *param)
+{
+	struct hb_sub_param *hb;
+
+	hb = (struct hb_sub_param *)param;
+
+	if (rsp->len < 9) {
+		return -EMSGSIZE;
+	}
+
+	*hb->status = net_buf_simple_pull_u8(rsp);
+	hb->sub->src = net_buf_simple_pull_le16(rsp);
+	hb->sub->dst = net_buf_simple_pull_le16(rsp);
+	hb->sub->period = net_buf_simple_pull_u8(rsp);
+	hb->sub->count = net_buf_simple_pull_u8(rsp);
+	hb->sub->min = net_buf_simple_pull_u8(rsp);
+	hb->sub->max = net_buf_simple_pull_u8(rsp);
+	return 0;
+}
+
+static int parse_hb_pub(struct net_buf_simple *rsp, void *param)
+{
+	struct hb_pub_param *hb;
+
+	hb = (struct hb_pub_param *)param;
+
+	if (rsp->len < 10) {
+		return -EMSGSIZE;
+	}
+
+	*hb->status = net_buf_simple_pull_u8(rsp);
+	hb->pub->dst = net_buf_simple_pull_le16(rsp);
+	hb->pub->count = net_buf_simple_pull_u8(rsp);
+	hb->pub->period = net_buf_simple_pull_u8(rsp);
+	hb->pub->ttl = net_buf_simple_pull_u8(rsp);
+	hb->pub->feat = net_buf_simple_pull_le16(rsp);
+	hb->pub->net_idx = net_buf_simple_pull_le16(rsp);
+	return 0;
+}
+
+int cfg_async_comp_data_get(uint16_t net_idx, uint16_t addr, uint8_t page, uint8_t *status,
+		struct net_buf_simple *comp)
+{
+	struct comp_param param = {
+		.status = status,
+		.comp = comp,
+	};
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_DEV_COMP_DATA_GET, 1);
+	bt_mesh_model_msg_init(&msg, OP_DEV_COMP_DATA_GET);
+	net_buf_simple_add_u8(&msg, page);
+
+	return get_sync(net_idx, addr, OP_DEV_COMP_DATA_STATUS, &msg, NULL, NULL,
+			parse_comp_data, &param);
+}
+
+static int u8_get(uint16_t net_idx, uint16_t addr, uint32_t op, uint32_t rsp_op, uint8_t *val)
+{
+	/* All getters use two byte opcodes */
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_BEACON_GET, 0);
+	bt_mesh_model_msg_init(&msg, op);
+
+	return get_sync(net_idx, addr, rsp_op, &msg, NULL, NULL, parse_u8, val);
+}
+
+int cfg_async_beacon_get(uint16_t net_idx, uint16_t addr, uint8_t *status)
+{
+	return u8_get(net_idx, addr, OP_BEACON_GET, OP_BEACON_STATUS, status);
+}
+
+int cfg_async_ttl_get(uint16_t net_idx, uint16_t addr, uint8_t *ttl)
+{
+	return u8_get(net_idx, addr, OP_DEFAULT_TTL_GET, OP_DEFAULT_TTL_STATUS, ttl);
+}
+
+int cfg_async_friend_get(uint16_t net_idx, uint16_t addr, uint8_t *status)
+{
+	return u8_get(net_idx, addr, OP_FRIEND_GET, OP_FRIEND_STATUS, status);
+}
+
+int cfg_async_gatt_proxy_get(uint16_t net_idx, uint16_t addr, uint8_t *status)
+{
+	return u8_get(net_idx, addr, OP_GATT_PROXY_GET, OP_GATT_PROXY_STATUS, status);
+}
+
+int cfg_async_relay_get(uint16_t net_idx, uint16_t addr, uint8_t *status, uint8_t *transmit)
+{
+	struct relay_param param = {
+		.status = status,
+		.transmit = transmit,
+	};
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_RELAY_GET, 0);
+	bt_mesh_model_msg_init(&msg, OP_RELAY_GET);
+
+	return get_sync(net_idx, addr, OP_RELAY_STATUS, &msg, NULL, NULL, parse_relay, &param);
+}
+
+int cfg_async_net_key_get(uint16_t net_idx, uint16_t addr, uint16_t *keys, size_t *key_cnt)
+{
+	struct list_param param = {
+		.status = NULL,
+		.list = keys,
+		.count = key_cnt,
+	};
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_NET_KEY_GET, 0);
+	bt_mesh_model_msg_init(&msg, OP_NET_KEY_GET);
+
+	return get_sync(net_idx, addr, OP_NET_KEY_LIST, &msg, NULL, NULL, parse_key_list, &param);
+}
+
+int cfg_async_app_key_get(uint16_t net_idx, uint16_t addr, uint16_t key_net_idx,
+		uint8_t *status, uint16_t *keys, size_t *key_cnt)
+{
+	struct echo_key key;
+	struct list_param param = {
+		.status = status,
+		.list = keys,
+		.count = key_cnt,
+	};
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_APP_KEY_GET, 2);
+	bt_mesh_model_msg_init(&msg, OP_APP_KEY_GET);
+	net_buf_simple_add_le16(&msg, key_net_idx);
+	echo_key_init(&key, &msg, msg.len - 2);
+
+	return get_sync(net_idx, addr, OP_APP_KEY_LIST, &msg, echo_match, &key, parse_key_list,
+			&param);
+}
+
+static int mod_list_get(uint16_t net_idx, uint16_t addr, uint32_t op, uint32_t rsp_op,
+		uint16_t elem_addr, uint16_t mod_id, const uint16_t *cid, cfg_async_parse_t parse,
+		struct list_param *param)
+{
+	struct echo_key key;
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_SIG_MOD_APP_GET, KEY_MAX_LEN);
+	bt_mesh_model_msg_init(&msg, op);
+	net_buf_simple_add_le16(&msg, elem_addr);
+
+	if (cid != NULL) {
+		net_buf_simple_add_le16(&msg, *cid);
+	}
+
+	net_buf_simple_add_le16(&msg, mod_id);
+	echo_key_init(&key, &msg, msg.len - (cid != NULL ? 6 : 4));
+
+	return get_sync(net_idx, addr, rsp_op, &msg, echo_match, &key, parse, param);
+}
+
+int cfg_async_mod_app_get(uint16_t net_idx, uint16_t addr, uint16_t elem_addr, uint16_t mod_id,
+		uint8_t *status, uint16_t *apps, size_t *app_cnt)
+{
+	struct list_param param = {
+		.status = status,
+		.list = apps,
+		.count = app_cnt,
+	};
+
+	return mod_list_get(net_idx, addr, OP_SIG_MOD_APP_GET, OP_SIG_MOD_APP_LIST, elem_addr,
+			mod_id, NULL, parse_mod_app_list, &param);
+}
+
+int cfg_async_mod_app_get_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_id, uint16_t cid, uint8_t *status, uint16_t *apps, size_t *app_cnt)
+{
+	struct list_param param = {
+		.status = status,
+		.list = apps,
+		.count = app_cnt,
+	};
+
+	return mod_list_get(net_idx, addr, OP_VND_MOD_APP_GET, OP_VND_MOD_APP_LIST, elem_addr,
+			mod_id, &cid, parse_mod_app_list_vnd, &param);
+}
+
+int cfg_async_mod_sub_get(uint16_t net_idx, uint16_t addr, uint16_t elem_addr, uint16_t mod_id,
+		uint8_t *status, uint16_t *subs, size_t *sub_cnt)
+{
+	struct list_param param = {
+		.status = status,
+		.list = subs,
+		.count = sub_cnt,
+	};
+
+	return mod_list_get(net_idx, addr, OP_MOD_SUB_GET, OP_MOD_SUB_LIST, elem_addr, mod_id,
+			NULL, parse_mod_sub_list_sig, &param);
+}
+
+int cfg_async_mod_sub_get_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_id, uint16_t cid, uint8_t *status, uint16_t *subs, size_t *sub_cnt)
+{
+	struct list_param param = {
+		.status = status,
+		.list = subs,
+		.count = sub_cnt,
+	};
+
+	return mod_list_get(net_idx, addr, OP_MOD_SUB_GET_VND, OP_MOD_SUB_LIST_VND, elem_addr,
+			mod_id, &cid, parse_mod_sub_list_vnd, &param);
+}
+
+static int mod_pub_get(uint16_t net_idx, uint16_t addr, struct pub_key *key,
+		struct bt_mesh_cfg_mod_pub *pub, uint8_t *status)
+{
+	struct pub_param param = {
+		.status = status,
+		.pub = pub,
+	};
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_MOD_PUB_GET, KEY_MAX_LEN);
+	bt_mesh_model_msg_init(&msg, OP_MOD_PUB_GET);
+	net_buf_simple_add_le16(&msg, key->elem_addr);
+
+	if (key->vnd) {
+		net_buf_simple_add_le16(&msg, key->cid);
+	}
+
+	net_buf_simple_add_le16(&msg, key->mod_id);
+
+	return get_sync(net_idx, addr, OP_MOD_PUB_STATUS, &msg, pub_match, key, parse_mod_pub,
+			&param);
+}
+
+int cfg_async_mod_pub_get(uint16_t net_idx, uint16_t addr, uint16_t elem_addr, uint16_t mod_id,
+		struct bt_mesh_cfg_mod_pub *pub, uint8_t *status)
+{
+	struct pub_key key = {
+		.elem_addr = elem_addr,
+		.mod_id = mod_id,
+		.vnd = false,
+	};
+
+	return mod_pub_get(net_idx, addr, &key, pub, status);
+}
+
+int cfg_async_mod_pub_get_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_id, uint16_t cid, struct bt_mesh_cfg_mod_pub *pub, uint8_t *status)
+{
+	struct pub_key key = {
+		.elem_addr = elem_addr,
+		.mod_id = mod_id,
+		.cid = cid,
+		.vnd = true,
+	};
+
+	return mod_pub_get(net_idx, addr, &key, pub, status);
+}
+
+int cfg_async_hb_sub_get(uint16_t net_idx, uint16_t addr, struct bt_mesh_cfg_hb_sub *sub,
+		uint8_t *status)
+{
+	struct hb_sub_param param = {
+		.status = status,
+		.sub = sub,
+	};
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_HEARTBEAT_SUB_GET, 0);
+	bt_mesh_model_msg_init(&msg, OP_HEARTBEAT_SUB_GET);
+
+	return get_sync(net_idx, addr, OP_HEARTBEAT_SUB_STATUS, &msg, NULL, NULL, parse_hb_sub,
+			&param);
+}
+
+int cfg_async_hb_pub_get(uint16_t net_idx, uint16_t addr, struct bt_mesh_cfg_hb_pub *pub,
+		uint8_t *status)
+{
+	struct hb_pub_param param = {
+		.status = status,
+		.pub = pub,
+	};
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_HEARTBEAT_PUB_GET, 0);
+	bt_mesh_model_msg_init(&msg, OP_HEARTBEAT_PUB_GET);
+
+	return get_sync(net_idx, addr, OP_HEARTBEAT_PUB_STATUS, &msg, NULL, NULL, parse_hb_pub,
+			&param);
+}
+
+/* Setters whose status message echoes the request parameters after the status byte */
+static int set_sync(uint16_t net_idx, uint16_t addr, uint32_t rsp_op, struct net_buf_simple *msg,
+		size_t param_offset, uint8_t *status)
+{
+	struct echo_key key;
+
+	echo_key_init(&key, msg, param_offset);
+
+	return get_sync(net_idx, addr, rsp_op, msg, echo_match, &key, parse_u8, status);
+}
+
+int cfg_async_app_key_add(uint16_t net_idx, uint16_t addr, uint16_t key_net_idx,
+		uint16_t key_app_idx, const uint8_t app_key[16], uint8_t *status)
+{
+	size_t param_offset;
+	struct echo_key key;
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_APP_KEY_ADD, APP_KEY_IDX_LEN + 16);
+	bt_mesh_model_msg_init(&msg, OP_APP_KEY_ADD);
+	param_offset = msg.len;
+	net_buf_simple_add_le16(&msg, key_net_idx | (key_app_idx << 12));
+	net_buf_simple_add_u8(&msg, key_app_idx >> 4);
+	/* Only the key indexes come back in the status message */
+	echo_key_init(&key, &msg, param_offset);
+	net_buf_simple_add_mem(&msg, app_key, 16);
+
+	return get_sync(net_idx, addr, OP_APP_KEY_STATUS, &msg, echo_match, &key, parse_u8,
+			status);
+}
+
+int cfg_async_app_key_del(uint16_t net_idx, uint16_t addr, uint16_t key_net_idx,
+		uint16_t key_app_idx, uint8_t *status)
+{
+	size_t param_offset;
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_APP_KEY_DEL, APP_KEY_IDX_LEN);
+	bt_mesh_model_msg_init(&msg, OP_APP_KEY_DEL);
+	param_offset = msg.len;
+	net_buf_simple_add_le16(&msg, key_net_idx | (key_app_idx << 12));
+	net_buf_simple_add_u8(&msg, key_app_idx >> 4);
+
+	return set_sync(net_idx, addr, OP_APP_KEY_STATUS, &msg, param_offset, status);
+}
+
+int cfg_async_net_key_add(uint16_t net_idx, uint16_t addr, uint16_t key_net_idx,
+		const uint8_t net_key[16], uint8_t *status)
+{
+	size_t param_offset;
+	struct echo_key key;
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_NET_KEY_ADD, 2 + 16);
+	bt_mesh_model_msg_init(&msg, OP_NET_KEY_ADD);
+	param_offset = msg.len;
+	net_buf_simple_add_le16(&msg, key_net_idx);
+	/* Only the key index comes back in the status message */
+	echo_key_init(&key, &msg, param_offset);
+	net_buf_simple_add_mem(&msg, net_key, 16);
+
+	return get_sync(net_idx, addr, OP_NET_KEY_STATUS, &msg, echo_match, &key, parse_u8,
+			status);
+}
+
+int cfg_async_net_key_del(uint16_t net_idx, uint16_t addr, uint16_t key_net_idx,
+		uint8_t *status)
+{
+	size_t param_offset;
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_NET_KEY_DEL, 2);
+	bt_mesh_model_msg_init(&msg, OP_NET_KEY_DEL);
+	param_offset = msg.len;
+	net_buf_simple_add_le16(&msg, key_net_idx);
+
+	return set_sync(net_idx, addr, OP_NET_KEY_STATUS, &msg, param_offset, status);
+}
+
+/* The status message of these setters carries the new state instead of echoing the request */
+static int u8_set(uint16_t net_idx, uint16_t addr, uint32_t op, uint32_t rsp_op, uint8_t val,
+		uint8_t *status)
+{
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_BEACON_SET, 1);
+	bt_mesh_model_msg_init(&msg, op);
+	net_buf_simple_add_u8(&msg, val);
+
+	return get_sync(net_idx, addr, rsp_op, &msg, NULL, NULL, parse_u8, status);
+}
+
+int cfg_async_beacon_set(uint16_t net_idx, uint16_t addr, uint8_t val, uint8_t *status)
+{
+	return u8_set(net_idx, addr, OP_BEACON_SET, OP_BEACON_STATUS, val, status);
+}
+
+int cfg_async_ttl_set(uint16_t net_idx, uint16_t addr, uint8_t val, uint8_t *ttl)
+{
+	return u8_set(net_idx, addr, OP_DEFAULT_TTL_SET, OP_DEFAULT_TTL_STATUS, val, ttl);
+}
+
+int cfg_async_friend_set(uint16_t net_idx, uint16_t addr, uint8_t val, uint8_t *status)
+{
+	return u8_set(net_idx, addr, OP_FRIEND_SET, OP_FRIEND_STATUS, val, status);
+}
+
+int cfg_async_gatt_proxy_set(uint16_t net_idx, uint16_t addr, uint8_t val, uint8_t *status)
+{
+	return u8_set(net_idx, addr, OP_GATT_PROXY_SET, OP_GATT_PROXY_STATUS, val, status);
+}
+
+int cfg_async_relay_set(uint16_t net_idx, uint16_t addr, uint8_t new_relay,
+		uint8_t new_transmit, uint8_t *status, uint8_t *transmit)
+{
+	struct relay_param param = {
+		.status = status,
+		.transmit = transmit,
+	};
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_RELAY_SET, 2);
+	bt_mesh_model_msg_init(&msg, OP_RELAY_SET);
+	net_buf_simple_add_u8(&msg, new_relay);
+	net_buf_simple_add_u8(&msg, new_transmit);
+
+	return get_sync(net_idx, addr, OP_RELAY_STATUS, &msg, NULL, NULL, parse_relay, &param);
+}
+
+static int mod_app_set(uint16_t net_idx, uint16_t addr, uint32_t op, uint16_t elem_addr,
+		uint16_t mod_app_idx, uint16_t mod_id, const uint16_t *cid, uint8_t *status)
+{
+	size_t param_offset;
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_MOD_APP_BIND, 8);
+	bt_mesh_model_msg_init(&msg, op);
+	param_offset = msg.len;
+	net_buf_simple_add_le16(&msg, elem_addr);
+	net_buf_simple_add_le16(&msg, mod_app_idx);
+
+	if (cid != NULL) {
+		net_buf_simple_add_le16(&msg, *cid);
+	}
+
+	net_buf_simple_add_le16(&msg, mod_id);
+
+	return set_sync(net_idx, addr, OP_MOD_APP_STATUS, &msg, param_offset, status);
+}
+
+int cfg_async_mod_app_bind(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_app_idx, uint16_t mod_id, uint8_t *status)
+{
+	return mod_app_set(net_idx, addr, OP_MOD_APP_BIND, elem_addr, mod_app_idx, mod_id, NULL,
+			status);
+}
+
+int cfg_async_mod_app_bind_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_app_idx, uint16_t mod_id, uint16_t cid, uint8_t *status)
+{
+	return mod_app_set(net_idx, addr, OP_MOD_APP_BIND, elem_addr, mod_app_idx, mod_id, &cid,
+			status);
+}
+
+int cfg_async_mod_app_unbind(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_app_idx, uint16_t mod_id, uint8_t *status)
+{
+	return mod_app_set(net_idx, addr, OP_MOD_APP_UNBIND, elem_addr, mod_app_idx, mod_id,
+			NULL, status);
+}
+
+int cfg_async_mod_app_unbind_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_app_idx, uint16_t mod_id, uint16_t cid, uint8_t *status)
+{
+	return mod_app_set(net_idx, addr, OP_MOD_APP_UNBIND, elem_addr, mod_app_idx, mod_id,
+			&cid, status);
+}
+
+static int mod_sub_set(uint16_t net_idx, uint16_t addr, uint32_t op, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, const uint16_t *cid, uint8_t *status)
+{
+	size_t param_offset;
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_MOD_SUB_ADD, 8);
+	bt_mesh_model_msg_init(&msg, op);
+	param_offset = msg.len;
+	net_buf_simple_add_le16(&msg, elem_addr);
+	net_buf_simple_add_le16(&msg, sub_addr);
+
+	if (cid != NULL) {
+		net_buf_simple_add_le16(&msg, *cid);
+	}
+
+	net_buf_simple_add_le16(&msg, mod_id);
+
+	return set_sync(net_idx, addr, OP_MOD_SUB_STATUS, &msg, param_offset, status);
+}
+
+int cfg_async_mod_sub_add(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint8_t *status)
+{
+	return mod_sub_set(net_idx, addr, OP_MOD_SUB_ADD, elem_addr, sub_addr, mod_id, NULL,
+			status);
+}
+
+int cfg_async_mod_sub_add_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint16_t cid, uint8_t *status)
+{
+	return mod_sub_set(net_idx, addr, OP_MOD_SUB_ADD, elem_addr, sub_addr, mod_id, &cid,
+			status);
+}
+
+int cfg_async_mod_sub_del(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint8_t *status)
+{
+	return mod_sub_set(net_idx, addr, OP_MOD_SUB_DEL, elem_addr, sub_addr, mod_id, NULL,
+			status);
+}
+
+int cfg_async_mod_sub_del_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint16_t cid, uint8_t *status)
+{
+	return mod_sub_set(net_idx, addr, OP_MOD_SUB_DEL, elem_addr, sub_addr, mod_id, &cid,
+			status);
+}
+
+int cfg_async_mod_sub_overwrite(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint8_t *status)
+{
+	return mod_sub_set(net_idx, addr, OP_MOD_SUB_OVERWRITE, elem_addr, sub_addr, mod_id,
+			NULL, status);
+}
+
+int cfg_async_mod_sub_overwrite_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint16_t cid, uint8_t *status)
+{
+	return mod_sub_set(net_idx, addr, OP_MOD_SUB_OVERWRITE, elem_addr, sub_addr, mod_id,
+			&cid, status);
+}
+
+static int mod_pub_set(uint16_t net_idx, uint16_t addr, struct pub_key *key,
+		const struct bt_mesh_cfg_mod_pub *pub, uint8_t *status)
+{
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_MOD_PUB_SET, 13);
+	bt_mesh_model_msg_init(&msg, OP_MOD_PUB_SET);
+	net_buf_simple_add_le16(&msg, key->elem_addr);
+	net_buf_simple_add_le16(&msg, pub->addr);
+	net_buf_simple_add_le16(&msg, pub->app_idx | (pub->cred_flag << 12));
+	net_buf_simple_add_u8(&msg, pub->ttl);
+	net_buf_simple_add_u8(&msg, pub->period);
+	net_buf_simple_add_u8(&msg, pub->transmit);
+
+	if (key->vnd) {
+		net_buf_simple_add_le16(&msg, key->cid);
+	}
+
+	net_buf_simple_add_le16(&msg, key->mod_id);
+
+	return get_sync(net_idx, addr, OP_MOD_PUB_STATUS, &msg, pub_match, key, parse_u8,
+			status);
+}
+
+int cfg_async_mod_pub_set(uint16_t net_idx, uint16_t addr, uint16_t elem_addr, uint16_t mod_id,
+		struct bt_mesh_cfg_mod_pub *pub, uint8_t *status)
+{
+	struct pub_key key = {
+		.elem_addr = elem_addr,
+		.mod_id = mod_id,
+		.vnd = false,
+	};
+
+	return mod_pub_set(net_idx, addr, &key, pub, status);
+}
+
+int cfg_async_mod_pub_set_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_id, uint16_t cid, struct bt_mesh_cfg_mod_pub *pub, uint8_t *status)
+{
+	struct pub_key key = {
+		.elem_addr = elem_addr,
+		.mod_id = mod_id,
+		.cid = cid,
+		.vnd = true,
+	};
+
+	return mod_pub_set(net_idx, addr, &key, pub, status);
+}
+
+int cfg_async_hb_sub_set(uint16_t net_idx, uint16_t addr, struct bt_mesh_cfg_hb_sub *sub,
+		uint8_t *status)
+{
+	struct hb_sub_param param = {
+		.status = status,
+		.sub = sub,
+	};
+
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_HEARTBEAT_SUB_SET, 5);
+	bt_mesh_model_msg_init(&msg, OP_HEARTBEAT_SUB_SET);
+	net_buf_simple_add_le16(&msg, sub->src);
+	net_buf_simple_add_le16(&msg, sub->dst);
+	net_buf_simple_add_u8(&msg, sub->period);
+
+	return get_sync(net_idx, addr, OP_HEARTBEAT_SUB_STATUS, &msg, NULL, NULL, parse_hb_sub,
+			&param);
+}
+
+int cfg_async_hb_pub_set(uint16_t net_idx, uint16_t addr, const struct bt_mesh_cfg_hb_pub *pub,
+		uint8_t *status)
+{
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_HEARTBEAT_PUB_SET, 9);
+	bt_mesh_model_msg_init(&msg, OP_HEARTBEAT_PUB_SET);
+	net_buf_simple_add_le16(&msg, pub->dst);
+	net_buf_simple_add_u8(&msg, pub->count);
+	net_buf_simple_add_u8(&msg, pub->period);
+	net_buf_simple_add_u8(&msg, pub->ttl);
+	net_buf_simple_add_le16(&msg, pub->feat);
+	net_buf_simple_add_le16(&msg, pub->net_idx);
+
+	return get_sync(net_idx, addr, OP_HEARTBEAT_PUB_STATUS, &msg, NULL, NULL, parse_u8,
+			status);
+}
+
+static int parse_node_reset(struct net_buf_simple *rsp, void *param)
+{
+	*(bool *)param = true;
+	return 0;
+}
+
+int cfg_async_node_reset(uint16_t net_idx, uint16_t addr, bool *status)
+{
+	BT_MESH_MODEL_BUF_DEFINE(msg, OP_NODE_RESET, 0);
+	bt_mesh_model_msg_init(&msg, OP_NODE_RESET);
+
+	return get_sync(net_idx, addr, OP_NODE_RESET_STATUS, &msg, NULL, NULL, parse_node_reset,
+			status);
+}
+
+void cfg_async_timeout_cb_set(cfg_async_timeout_t cb)
+{
+	timeout_cb = cb;
+}
+
+void cfg_async_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(slots); i++) {
+		k_work_init_delayable(&slots[i].timeout, slot_timeout);
+	}
+}
@@ -0,0 +1,172 @@
+#ifndef CFG_ASYNC_H_
+#define CFG_ASYNC_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+#include <bluetooth/mesh.h>
+
+/* Called once per request, either with the status message payload (opcode already removed)
+ * or with rsp NULL and a negative error, e.g. -ETIMEDOUT. Runs in the mesh receive context
+ * or the system work queue, so it must not block. */
+typedef void (*cfg_async_cb_t)(int err, struct net_buf_simple *rsp, void *user_data);
+
+/* Return true if the status message payload in rsp answers the request with this key.
+ * Must not consume rsp. */
+typedef bool (*cfg_async_match_t)(struct net_buf_simple *rsp, const void *key);
+
+/* Decode a status message payload into param. Used by the synchronous wrappers. */
+typedef int (*cfg_async_parse_t)(struct net_buf_simple *rsp, void *param);
+
+/* Return the timeout in milliseconds for a request to addr */
+typedef int32_t (*cfg_async_timeout_t)(uint16_t addr);
+
+struct cfg_async_req {
+	uint16_t net_idx;
+	uint16_t addr;
+	/* Opcode of the expected status message */
+	uint32_t rsp_op;
+	/* Optional, for status messages that can answer several different requests */
+	cfg_async_match_t match;
+	const void *key;
+	/* 0 asks the timeout callback, or selects CONFIG_GATEWAY_CFG_CLI_TIMEOUT_MS if none
+	 * is set */
+	int32_t timeout_ms;
+	cfg_async_cb_t cb;
+	void *user_data;
+};
+
+void cfg_async_init(void);
+
+void cfg_async_timeout_cb_set(cfg_async_timeout_t cb);
+
+int cfg_async_send(const struct cfg_async_req *req, struct net_buf_simple *msg);
+
+int cfg_async_send_sync(struct cfg_async_req *req, struct net_buf_simple *msg,
+		cfg_async_parse_t parse, void *param);
+
+bool cfg_async_recv(uint32_t opcode, struct bt_mesh_msg_ctx *ctx, struct net_buf_simple *buf);
+
+/* Blocking configuration getters with the same signatures as their bt_mesh_cfg_*
+ * counterparts, but several of them can be outstanding at once to different nodes. */
+int cfg_async_comp_data_get(uint16_t net_idx, uint16_t addr, uint8_t page, uint8_t *status,
+		struct net_buf_simple *comp);
+
+int cfg_async_beacon_get(uint16_t net_idx, uint16_t addr, uint8_t *status);
+
+int cfg_async_ttl_get(uint16_t net_idx, uint16_t addr, uint8_t *ttl);
+
+int cfg_async_friend_get(uint16_t net_idx, uint16_t addr, uint8_t *status);
+
+int cfg_async_gatt_proxy_get(uint16_t net_idx, uint16_t addr, uint8_t *status);
+
+int cfg_async_relay_get(uint16_t net_idx, uint16_t addr, uint8_t *status, uint8_t *transmit);
+
+int cfg_async_net_key_get(uint16_t net_idx, uint16_t addr, uint16_t *keys, size_t *key_cnt);
+
+int cfg_async_app_key_get(uint16_t net_idx, uint16_t addr, uint16_t key_net_idx,
+		uint8_t *status, uint16_t *keys, size_t *key_cnt);
+
+int cfg_async_mod_app_get(uint16_t net_idx, uint16_t addr, uint16_t elem_addr, uint16_t mod_id,
+		uint8_t *status, uint16_t *apps, size_t *app_cnt);
+
+int cfg_async_mod_app_get_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_id, uint16_t cid, uint8_t *status, uint16_t *apps, size_t *app_cnt);
+
+int cfg_async_mod_pub_get(uint16_t net_idx, uint16_t addr, uint16_t elem_addr, uint16_t mod_id,
+		struct bt_mesh_cfg_mod_pub *pub, uint8_t *status);
+
+int cfg_async_mod_pub_get_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_id, uint16_t cid, struct bt_mesh_cfg_mod_pub *pub, uint8_t *status);
+
+int cfg_async_mod_sub_get(uint16_t net_idx, uint16_t addr, uint16_t elem_addr, uint16_t mod_id,
+		uint8_t *status, uint16_t *subs, size_t *sub_cnt);
+
+int cfg_async_mod_sub_get_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_id, uint16_t cid, uint8_t *status, uint16_t *subs, size_t *sub_cnt);
+
+int cfg_async_hb_sub_get(uint16_t net_idx, uint16_t addr, struct bt_mesh_cfg_hb_sub *sub,
+		uint8_t *status);
+
+int cfg_async_hb_pub_get(uint16_t net_idx, uint16_t addr, struct bt_mesh_cfg_hb_pub *pub,
+		uint8_t *status);
+
+/* Blocking configuration setters, likewise matching their bt_mesh_cfg_* counterparts */
+int cfg_async_app_key_add(uint16_t net_idx, uint16_t addr, uint16_t key_net_idx,
+		uint16_t key_app_idx, const uint8_t app_key[16], uint8_t *status);
+
+int cfg_async_app_key_del(uint16_t net_idx, uint16_t addr, uint16_t key_net_idx,
+		uint16_t key_app_idx, uint8_t *status);
+
+int cfg_async_net_key_add(uint16_t net_idx, uint16_t addr, uint16_t key_net_idx,
+		const uint8_t net_key[16], uint8_t *status);
+
+int cfg_async_net_key_del(uint16_t net_idx, uint16_t addr, uint16_t key_net_idx,
+		uint8_t *status);
+
+int cfg_async_beacon_set(uint16_t net_idx, uint16_t addr, uint8_t val, uint8_t *status);
+
+int cfg_async_ttl_set(uint16_t net_idx, uint16_t addr, uint8_t val, uint8_t *ttl);
+
+int cfg_async_friend_set(uint16_t net_idx, uint16_t addr, uint8_t val, uint8_t *status);
+
+int cfg_async_gatt_proxy_set(uint16_t net_idx, uint16_t addr, uint8_t val, uint8_t *status);
+
+int cfg_async_relay_set(uint16_t net_idx, uint16_t addr, uint8_t new_relay,
+		uint8_t new_transmit, uint8_t *status, uint8_t *transmit);
+
+int cfg_async_mod_app_bind(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_app_idx, uint16_t mod_id, uint8_t *status);
+
+int cfg_async_mod_app_bind_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_app_idx, uint16_t mod_id, uint16_t cid, uint8_t *status);
+
+int cfg_async_mod_app_unbind(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_app_idx, uint16_t mod_id, uint8_t *status);
+
+int cfg_async_mod_app_unbind_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_app_idx, uint16_t mod_id, uint16_t cid, uint8_t *status);
+
+int cfg_async_mod_sub_add(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint8_t *status);
+
+int cfg_async_mod_sub_add_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint16_t cid, uint8_t *status);
+
+int cfg_async_mod_sub_del(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint8_t *status);
+
+int cfg_async_mod_sub_del_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint16_t cid, uint8_t *status);
+
+int cfg_async_mod_sub_overwrite(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint8_t *status);
+
+int cfg_async_mod_sub_overwrite_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t sub_addr, uint16_t mod_id, uint16_t cid, uint8_t *status);
+
+/* Virtual publish addresses are not supported */
+int cfg_async_mod_pub_set(uint16_t net_idx, uint16_t addr, uint16_t elem_addr, uint16_t mod_id,
+		struct bt_mesh_cfg_mod_pub *pub, uint8_t *status);
+
+int cfg_async_mod_pub_set_vnd(uint16_t net_idx, uint16_t addr, uint16_t elem_addr,
+		uint16_t mod_id, uint16_t cid, struct bt_mesh_cfg_mod_pub *pub, uint8_t *status);
+
+int cfg_async_hb_sub_set(uint16_t net_idx, uint16_t addr, struct bt_mesh_cfg_hb_sub *sub,
+		uint8_t *status);
+
+int cfg_async_hb_pub_set(uint16_t net_idx, uint16_t addr, const struct bt_mesh_cfg_hb_pub *pub,
+		uint8_t *status);
+
+int cfg_async_node_reset(uint16_t net_idx, uint16_t addr, bool *status);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* CFG_ASYNC_H_ */
@@ -0,0 +1,89 @@
+#include <zephyr.h>
+#include <logging/log.h>
+
+#include "btmesh.h"
+#include "cfg_txn.h"
+
+
+LOG_MODULE_REGISTER(app_cfg_txn, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+static bool op_perform(struct cfg_txn_op *op)
+{
+	op->err = btmesh_perform_cfg_op(op->op, &op->args);
+	return !op->err && !btmesh_get_op_status(op->op, &op->args);
+}
+
+static void step_rollback(struct cfg_txn_step *step)
+{
+	if (!step->has_rollback) {
+		return;
+	}
+
+	if (op_perform(&step->rollback)) {
+		step->state = CFG_TXN_STEP_ROLLED_BACK;
+		return;
+	}
+
+	step->state = CFG_TXN_STEP_ROLLBACK_FAILED;
+	LOG_ERR("Failed to roll back %s. Error: %d, Status: %d",
+			btmesh_get_op_str(step->op.op), step->rollback.err,
+			btmesh_get_op_status(step->rollback.op, &step->rollback.args));
+}
+
+int cfg_txn_perform(struct cfg_txn *txn)
+{
+	size_t i;
+	struct cfg_txn_step *step;
+
+	for (i = 0; i < txn->step_count; i++) {
+		txn->steps[i].state = CFG_TXN_STEP_PENDING;
+	}
+
+	for (i = 0; i < txn->step_count; i++) {
+		step = &txn->steps[i];
+
+		if (!op_perform(&step->op)) {
+			step->state = CFG_TXN_STEP_FAILED;
+			break;
+		}
+
+		step->state = CFG_TXN_STEP_DONE;
+	}
+
+	txn->failed_step = i;
+
+	if (i == txn->step_count) {
+		return 0;
+	}
+
+	LOG_WRN("Configuration of 0x%04x failed at step %d of %d, rolling back", txn->addr,
+			i + 1, txn->step_count);
+
+	if (step->op.err) {
+		step_rollback(step);
+	}
+
+	while (i-- > 0) {
+		step_rollback(&txn->steps[i]);
+	}
+
+	return step->op.err ? step->op.err : -EIO;
+}
+
+const char *cfg_txn_step_state_str(enum cfg_txn_step_state state)
+{
+	switch (state) {
+	case CFG_TXN_STEP_PENDING:
+		return "pending";
+	case CFG_TXN_STEP_DONE:
+		return "done";
+	case CFG_TXN_STEP_FAILED:
+		return "failed";
+	case CFG_TXN_STEP_ROLLED_BACK:
+		return "rolledBack";
+	case CFG_TXN_STEP_ROLLBACK_FAILED:
+		return "rollbackFailed";
+	default:
+		return "unknown";
+	}
+}
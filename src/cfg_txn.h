@@ -0,0 +1,62 @@
+#ifndef CFG_TXN_H_
+#define CFG_TXN_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "btmesh.h"
+
+enum cfg_txn_step_state {
+	/* Not performed, an earlier step failed */
+	CFG_TXN_STEP_PENDING,
+	CFG_TXN_STEP_DONE,
+	CFG_TXN_STEP_FAILED,
+	CFG_TXN_STEP_ROLLED_BACK,
+	CFG_TXN_STEP_ROLLBACK_FAILED,
+};
+
+struct cfg_txn_op {
+	enum btmesh_op op;
+	union btmesh_op_args args;
+	int err;
+};
+
+struct cfg_txn_step {
+	struct cfg_txn_op op;
+	/* Optional compensating operation, performed if a later step fails */
+	struct cfg_txn_op rollback;
+	bool has_rollback;
+	enum cfg_txn_step_state state;
+};
+
+struct cfg_txn {
+	uint16_t addr;
+	struct cfg_txn_step *steps;
+	size_t step_count;
+	/* Index of the step that failed, step_count if none did */
+	size_t failed_step;
+};
+
+/* Perform the steps in order with btmesh_perform_cfg_op() and stop at the first one that
+ * fails or is rejected by the node. The rollback operations of the steps performed so far
+ * are then run in reverse order. A step that failed without an answer from the node may
+ * still have been applied, so its own rollback is run as well.
+ * Returns 0 if every step succeeded, -EIO if the node rejected a step and the error of the
+ * failed step otherwise. */
+int cfg_txn_perform(struct cfg_txn *txn);
+
+const char *cfg_txn_step_state_str(enum cfg_txn_step_state state);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* CFG_TXN_H_ */
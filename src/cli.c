@@ -11,10 +11,24 @@
 #include "mesh/net.h"
 #include "mesh/access.h"
 
+#include "beacon_block.h"
+#include "beacon_table.h"
 #include "btmesh.h"
 #ifdef CONFIG_SHELL
 #include "cli.h"
 #endif
+#if defined(CONFIG_GATEWAY_CODEC_STATS)
+#include "codec.h"
+#endif // defined(CONFIG_GATEWAY_CODEC_STATS)
+#if defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+#include "compress.h"
+#endif // defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+#include "gateway.h"
+#include "mesh_retry.h"
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+#include "rx_bus.h"
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+#include "sub_set.h"
 #include "util.h"
 
 #define MAX_PAYLOAD_LEN 32
@@ -181,7 +195,10 @@ static int provision_cmd(const struct shell *shell, size_t argc, char **argv)
         }
 
         /* Get UUID from argv */
-        util_str2uuid(argv[0], op_args.prov_adv.uuid);
+        if (util_str2uuid(argv[0], op_args.prov_adv.uuid)) {
+                shell_error(shell, "Invalid UUID: %s", argv[0]);
+                return -EINVAL;
+        }
 
         for (i = 1; i < argc - 1; i=i+2) {
                 if (!arg_addr && !strcmp(argv[i], "-a")) {
@@ -240,12 +257,18 @@ static int provision_cmd(const struct shell *shell, size_t argc, char **argv)
 
 static void get_dynamic_prov(size_t idx, struct shell_static_entry *entry)
 {
-        entry->syntax = btmesh_get_beacon_uuid(idx);
+        /* The shell uses the syntax string after this returns */
+        static char uuid_str[UUID_STR_LEN];
+        struct beacon_info beacon;
 
-        if (entry->syntax == NULL) {
+        if (beacon_table_get(idx, &beacon)) {
+                entry->syntax = NULL;
                 return;
         }
 
+        util_uuid2str(beacon.uuid, uuid_str);
+        entry->syntax = uuid_str;
+
         entry->handler = provision_cmd;
         entry->subcmd = NULL;
         entry->help = DYNAMIC_PROV_HELP;
@@ -475,11 +498,10 @@ static int subnet_add(const struct shell *shell, size_t argc, char **argv)
         }
 
         /* Make sure the key argument is valid */
-        if (!util_key_valid(argv[1])) {
+        if (util_str2key(argv[1], net_key)) {
                 shell_error(shell, "%s: %s\n", argv[1], NET_KEY_ERR);
                 return -EINVAL;
         }
-        util_str2key(argv[1], net_key);
 
         /* If the optional netIdx argument was provided... */
         if (argc > 2) {     /* User has specified net index to use */
@@ -849,11 +871,10 @@ static int appkey_add(const struct shell *shell, size_t argc, char **argv)
         }
 
         /* Make sure the key argument is valid */
-        if (!util_key_valid(argv[1])) {
+        if (util_str2key(argv[1], app_key)) {
                 shell_error(shell, "%s: %s\n", argv[1], APP_KEY_ERR);
                 return -EINVAL;
         }
-        util_str2key(argv[1], app_key);
 
         /* If the optional appIdx argument was provided... */
         if (argc > 2) {     /* User has specified app index to use */
@@ -2105,45 +2126,19 @@ static void get_dynamic_addr(size_t idx, struct shell_static_entry *entry)
 }
 
 #ifdef CONFIG_SHELL_MESH_MSG
-static char addr_strings[CONFIG_BT_MESH_GATEWAY_SUB_LIST_LEN][7];
-
 static void get_dynamic_sub_addr(size_t idx, struct shell_static_entry *entry)
 {
-        int i;
-        int j;
-        uint16_t lowest_addr;
-        uint16_t last_lowest_addr;
-        const uint16_t *addr_ptr;
+        static char addr_str[7];
+        struct sub_range range;
 
-        if (idx == 0) {
-                last_lowest_addr = 0x0000;
-                addr_ptr = btmesh_get_subscribe_list(BTMESH_SUB_TYPE_CLI);
-
-                if (addr_ptr == NULL) {
-                        entry->syntax = NULL;
-                        return;
-                }
-
-                for (i = 0; i < CONFIG_BT_MESH_GATEWAY_SUB_LIST_LEN; i++) {
-                        lowest_addr = 0xFFFF;
-                        
-                        for (j = 0; j < CONFIG_BT_MESH_GATEWAY_SUB_LIST_LEN; j++) {
-                                if ((addr_ptr[j] < lowest_addr) && (addr_ptr[j] > last_lowest_addr)) {
-                                        lowest_addr = addr_ptr[j];
-                                }
-                        }
-                        
-                        snprintf(addr_strings[i], sizeof(addr_strings[i]), "0x%04x", lowest_addr);
-                        last_lowest_addr = lowest_addr;
-                }
-        }
-
-        if (!strcmp(addr_strings[idx], "0xffff")) {
+        /* Ranges are offered by their first address */
+        if (sub_set_get(BTMESH_SUB_TYPE_CLI, idx, &range)) {
                 entry->syntax = NULL;
                 return;
         }
 
-        entry->syntax = addr_strings[idx];
+        snprintf(addr_str, sizeof(addr_str), "0x%04x", range.first);
+        entry->syntax = addr_str;
         entry->help = DYNAMIC_SUB_ADDR_HELP;
 }
 #endif // CONFIG_SHELL_MESH_MSG
@@ -2634,13 +2629,11 @@ static int cmd_parse_args(const struct shell *shell, size_t argc, char **argv)
 
                 switch (arg[j]) {
                 case ARG_UUID:
-                        if (!util_uuid_valid(argv[i+j])) {
+                        if (util_str2uuid(argv[i+j], cmd.args.uuid)) {
                                 shell_error(shell, "Invalid UUID: %s. %s\n", argv[i+j],
                                                 ARG_UUID_HELP);
                                 return -EINVAL;
                         }
-
-                        util_str2uuid(argv[i+j], cmd.args.uuid);
                         break;
 
                 case ARG_ADDR:
@@ -3403,10 +3396,8 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
         size_t i;
         size_t j;
         size_t k;
-        const char *uuid;
         const char *oob;
-        uint8_t uuid_bytes[UUID_LEN];
-        const uint32_t *uri_hash;
+        struct beacon_info beacon;
         uint16_t features;
         uint8_t num_elem;
         uint8_t num_sig_models;
@@ -3446,38 +3437,31 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 
         switch (cmd.cmd) {
 	case CMD_BEACON_LIST:
-		i = 0;
-		uuid = btmesh_get_beacon_uuid(i);
-		oob = btmesh_get_beacon_oob(i);
-		uri_hash = btmesh_get_beacon_uri_hash(i);
-
-		if (uuid == NULL) {
+		if (beacon_table_get(0, &beacon)) {
 			shell_print(shell, "  No active beacons.\n");
 			break;
 		}
 
-		while (uuid != NULL) {
+		for (i = 0; !beacon_table_get(i, &beacon); i++) {
+			util_uuid2str(beacon.uuid, uuid_str);
+			oob = btmesh_get_oob_str(beacon.oob_info);
+
 			shell_print(shell,
 					"  UUID: %s\n"
 					"  - OOB Info: %s",
-					uuid, oob ? oob : "None");
+					uuid_str, oob ? oob : "None");
 
-			if (uri_hash == NULL) {
+			if (!beacon.uri_hash_set) {
 				shell_print(shell, "  - URI Hash: None\n");
 			} else {
-				shell_print(shell, "  - URI Hash: 0x%08x\n", *uri_hash);
+				shell_print(shell, "  - URI Hash: 0x%08x\n", beacon.uri_hash);
 			}
-
-			i++;
-			uuid = btmesh_get_beacon_uuid(i);
-			oob = btmesh_get_beacon_oob(i);
-			uri_hash = btmesh_get_beacon_uri_hash(i);
 		}
 
 		break;
 
 	case CMD_BEACON_BLOCK:
-		err = btmesh_block_beacon(cmd.args.uuid);
+		err = beacon_block_add(cmd.args.uuid);
 
 		if (cmd_err_handler(shell, err, status)) { 
 			if (err == -ENOMEM) {
@@ -3487,7 +3471,7 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 				break;
 			}
 
-			if (err == -EAGAIN) {
+			if (err == -EALREADY) {
 				shell_info(shell,
 						"  UUID is already on blocked beacon list.\n");
 				break;
@@ -3498,7 +3482,7 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 		break;
 
 	case CMD_BEACON_UNBLOCK:
-		err = btmesh_unblock_beacon(cmd.args.uuid);
+		err = beacon_block_remove(cmd.args.uuid);
 
 		if (cmd_err_handler(shell, err, status)) {
 			shell_info(shell, "  Beacon NOT unblocked.\n");
@@ -3533,19 +3517,9 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 
 		k_sleep(K_SECONDS(5));
 
-		i = 0;
-		uuid = btmesh_get_beacon_uuid(i);
-
-		while (uuid != NULL) {
-			util_str2uuid(uuid, uuid_bytes);
-			if (!util_uuid_cmp(uuid_bytes, cdb_node->uuid)) {
-				bt_mesh_cdb_node_del(cdb_node, true);
-				shell_info(shell, "Successfully reset node %s\n", argv[1]);
-				break;
-			}
-
-			i++; 
-			uuid = btmesh_get_beacon_uuid(i);
+		if (beacon_table_contains(cdb_node->uuid)) {
+			bt_mesh_cdb_node_del(cdb_node, true);
+			shell_info(shell, "Successfully reset node %s\n", argv[1]);
 		}
 
 		/* If the reset was a success, we just deleted this node from the
@@ -3556,10 +3530,10 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 		}
 
 		/* The node being reset cannot send an ack message after resetting
-		 * itself so the call to bt_mesh_cfg_node_reset() always returns
-		 * err -11 (-EAGAIN). Ignore this and only check status for the
-		 * success/failure of the reset */
-		if (err && err != -EAGAIN)
+		 * itself so the reset request always times out, with -EAGAIN from
+		 * the stock client or -ETIMEDOUT from cfg_async. Ignore this and
+		 * only check status for the success/failure of the reset */
+		if (err && err != -EAGAIN && err != -ETIMEDOUT)
 		{
 			shell_error(shell, "Error: %d\n", err);
 			shell_info(shell, "Node NOT reset\n");
@@ -4105,7 +4079,7 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 	case CMD_NODE_SUBNET_GET:
 		op_args.net_key_get.net_idx = PRIMARY_SUBNET;
 		op_args.net_key_get.addr = cmd.args.addr;
-		op_args.net_key_get.key_cnt = sizeof(op_args.net_key_get.keys);
+		op_args.net_key_get.key_cnt = ARRAY_SIZE(op_args.net_key_get.keys);
 		err = btmesh_perform_op(BTMESH_OP_NET_KEY_GET, &op_args);
 
 		if (cmd_err_handler(shell, err, 0)) {
@@ -4196,7 +4170,7 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 		op_args.app_key_get.net_idx = PRIMARY_SUBNET;
 		op_args.app_key_get.addr = cmd.args.addr;
 		op_args.app_key_get.key_net_idx = appkey->net_idx;
-		op_args.app_key_get.key_cnt = sizeof(op_args.app_key_get.keys);
+		op_args.app_key_get.key_cnt = ARRAY_SIZE(op_args.app_key_get.keys);
 		err = btmesh_perform_op(BTMESH_OP_APP_KEY_GET, &op_args);
 
 		if (cmd_err_handler(shell, err, op_args.app_key_get.status)) {
@@ -4300,7 +4274,7 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 		op_args.mod_app_get.addr = cmd.args.addr;
 		op_args.mod_app_get.elem_addr = cmd.args.elem_addr;
 		op_args.mod_app_get.mod_id = cmd.args.model_id;
-		op_args.mod_app_get.app_cnt = sizeof(op_args.mod_app_get.apps);
+		op_args.mod_app_get.app_cnt = ARRAY_SIZE(op_args.mod_app_get.apps);
 	
 #ifdef CONFIG_SHELL_MESH_SIG	
 		if (cmd.cmd == CMD_MODEL_APP_KEY_GET) {
@@ -4554,7 +4528,7 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 		op_args.mod_sub_get.addr = cmd.args.addr;
 		op_args.mod_sub_get.elem_addr = cmd.args.elem_addr;
 		op_args.mod_sub_get.mod_id = cmd.args.model_id;
-		op_args.mod_sub_get.sub_cnt = sizeof(op_args.mod_sub_get.subs);
+		op_args.mod_sub_get.sub_cnt = ARRAY_SIZE(op_args.mod_sub_get.subs);
 
 #ifdef CONFIG_SHELL_MESH_SIG
 		if (cmd.cmd == CMD_MODEL_SUB_GET) {
@@ -4587,7 +4561,13 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 #endif // defined(CONFIG_SHELL_MESH_SIG) || defined(CONFIG_SHELL_MESH_VND)
 #ifdef CONFIG_SHELL_MESH_MSG
 	case CMD_MSG_SUB:
-		err = btmesh_subscribe(BTMESH_SUB_TYPE_CLI, cmd.args.addr);
+	{
+		struct sub_range range = {
+			.first = cmd.args.addr,
+			.last = cmd.args.addr,
+		};
+
+		err = sub_set_update(BTMESH_SUB_TYPE_CLI, &range, 1, true);
 		
 		if (cmd_err_handler(shell, err, 0)) {
 			return -ENOEXEC;
@@ -4596,9 +4576,16 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 		shell_info(shell, "  Subscribed to message address.\n");
 
 		break;
+	}
 
 	case CMD_MSG_UNSUB:
-		btmesh_unsubscribe(BTMESH_SUB_TYPE_CLI, cmd.args.addr);
+	{
+		struct sub_range range = {
+			.first = cmd.args.addr,
+			.last = cmd.args.addr,
+		};
+
+		err = sub_set_update(BTMESH_SUB_TYPE_CLI, &range, 1, false);
 
 		if (cmd_err_handler(shell, err, 0)) {
 			return -ENOEXEC;
@@ -4607,6 +4594,7 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
 		shell_info(shell, "  Unsibscribed from message address.\n");
 
 		break;
+	}
 
 	case CMD_MSG_SEND:
 	{
@@ -4788,23 +4776,52 @@ static int cmd_handler(const struct shell *shell, size_t argc, char **argv)
         return 0;
 }
 
-void cli_msg_callback(uint32_t opcode, struct bt_mesh_msg_ctx *ctx, struct net_buf_simple *buf)
+#ifdef CONFIG_SHELL_MESH_MSG
+static bool rx_filter(const struct rx_bus_msg *msg, void *user_data)
+{
+        return sub_set_contains(BTMESH_SUB_TYPE_CLI, msg->recv_dst);
+}
+
+static void rx_print(struct k_work *work);
+static void rx_notify(struct rx_bus_consumer *consumer);
+
+K_WORK_DEFINE(rx_work, rx_print);
+
+static struct rx_bus_consumer rx_consumer = {
+        .name = "shell",
+        .filter = rx_filter,
+        .notify = rx_notify,
+};
+
+static void rx_notify(struct rx_bus_consumer *consumer)
 {
-        shell_print(shell,
-                        "Received Mesh Model Message:\n"
-                        "    - Opcode             : 0x%08x - %s\n"
-                        "    - Network Index      : 0x%04x\n"
-                        "    - Application Index  : 0x%04x\n"
-                        "    - Source Address     : 0x%04x\n"
-                        "    - Destination Address: 0x%04x\n"
-                        "    - Payload:",
-                        opcode, btmesh_parse_opcode(opcode), ctx->net_idx, ctx->app_idx, ctx->addr,
-                        ctx->recv_dst);
-        
-        while(buf->len) {
-                shell_print(shell, "    0x%02x", net_buf_simple_pull_u8(buf));
+        k_work_submit(&rx_work);
+}
+
+/* Printed from the system work queue, the UART is far slower than the mesh */
+static void rx_print(struct k_work *work)
+{
+        size_t i;
+        struct rx_bus_msg msg;
+
+        while (!rx_bus_read(&rx_consumer, &msg)) {
+                shell_print(shell,
+                                "Received Mesh Model Message:\n"
+                                "    - Opcode             : 0x%08x - %s\n"
+                                "    - Network Index      : 0x%04x\n"
+                                "    - Application Index  : 0x%04x\n"
+                                "    - Source Address     : 0x%04x\n"
+                                "    - Destination Address: 0x%04x\n"
+                                "    - Payload:",
+                                msg.opcode, btmesh_parse_opcode(msg.opcode), msg.net_idx,
+                                msg.app_idx, msg.addr, msg.recv_dst);
+
+                for (i = 0; i < msg.len; i++) {
+                        shell_print(shell, "    0x%02x", msg.payload[i]);
+                }
         }
 }
+#endif // CONFIG_SHELL_MESH_MSG
 
 void cli_hlth_cb(uint16_t addr, uint8_t test_id, uint16_t cid, uint8_t *faults, size_t fault_count)
 {
@@ -4847,12 +4864,18 @@ SHELL_DYNAMIC_CMD_CREATE(dynamic_addr_app_key_sub, dynamic_addr_app_key_func);
 
 static void dynamic_blocked_func(size_t idx, struct shell_static_entry *entry)
 {
-        entry->syntax = btmesh_get_blocked_beacon(idx);
+        /* The shell uses the syntax string after this returns */
+        static char uuid_str[UUID_STR_LEN];
+        uint8_t uuid[UUID_LEN];
 
-        if (entry->syntax == NULL) {
+        if (beacon_block_get(idx, uuid)) {
+                entry->syntax = NULL;
                 return;
         }
 
+        util_uuid2str(uuid, uuid_str);
+        entry->syntax = uuid_str;
+
         entry->handler = NULL;
         entry->subcmd = &dummy_sub;
         entry->help = DYNAMIC_UNBLOCK_HELP;
@@ -5050,10 +5073,231 @@ SHELL_CMD_REGISTER(health, &hlth_subs, HLTH_HELP, NULL);
 #endif // CONFIG_SHELL_MESH_HEALTH
 
 
+/******************************************************************************
+ *  GATEWAY STATISTICS COMMANDS
+ *****************************************************************************/
+#if defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+static int stats_compression(const struct shell *shell, size_t argc, char **argv)
+{
+        struct compress_stats stats;
+
+        compress_get_stats(&stats);
+
+        shell_print(shell,
+                        "  Uplink Compression\n"
+                        "    - Compressed messages: %u\n"
+                        "    - Sent uncompressed  : %u\n"
+                        "    - Bytes in           : %u\n"
+                        "    - Bytes out          : %u\n"
+                        "    - Overall ratio      : %u%%\n"
+                        "    - Last ratio         : %u%%\n"
+                        "    - Last CPU time      : %uus\n"
+                        "    - Max CPU time       : %uus\n"
+                        "    - Average CPU time   : %uus\n",
+                        stats.msg_count, stats.skip_count, stats.bytes_in, stats.bytes_out,
+                        stats.bytes_in ? (uint32_t)(((uint64_t)stats.bytes_out * 100) /
+                                stats.bytes_in) : 0,
+                        stats.last_ratio, stats.last_us, stats.max_us,
+                        (stats.msg_count + stats.skip_count) ?
+                                stats.total_us / (stats.msg_count + stats.skip_count) : 0);
+
+        return 0;
+}
+#endif // defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+
+#if defined(CONFIG_GATEWAY_JSON_ARENA)
+static int stats_arena(const struct shell *shell, size_t argc, char **argv)
+{
+        size_t i;
+        struct gateway_arena_stats stats;
+
+        shell_print(shell,
+                        "  cJSON Request Arena (%d bytes)\n"
+                        "    Proc  Requests  Allocs/Req  Heap Fallbacks  High-Water Mark",
+                        CONFIG_GATEWAY_JSON_ARENA_SIZE);
+
+        for (i = 0; !gateway_arena_stats_get(i, &stats); i++) {
+                if (stats.count == 0) {
+                        continue;
+                }
+
+                shell_print(shell, "    %4d  %8u  %10u  %14u  %15d",
+                                i, stats.count, stats.allocs / stats.count, stats.fallbacks,
+                                stats.hwm);
+        }
+
+        shell_print(shell, "");
+        return 0;
+}
+#endif // defined(CONFIG_GATEWAY_JSON_ARENA)
+
+#if defined(CONFIG_GATEWAY_CODEC_STATS)
+static int stats_codec(const struct shell *shell, size_t argc, char **argv)
+{
+        size_t i;
+        struct codec_stats stats;
+
+        if (argc > 1) {
+                if (strcmp(argv[1], "reset")) {
+                        shell_error(shell, "Unknown argument: %s", argv[1]);
+                        return -EINVAL;
+                }
+
+                codec_stats_reset();
+                return 0;
+        }
+
+        shell_print(shell,
+                        "  JSON Codec\n"
+                        "    %-24s  %8s  %5s  %6s  %6s  %9s",
+                        "Type", "Count", "Fails", "Avg us", "Max us", "Avg bytes");
+
+        for (i = 0; !codec_stats_get(i, &stats); i++) {
+                if (stats.count == 0) {
+                        shell_print(shell, "    %-24s  %8u  %5u  %6s  %6s  %9s",
+                                        stats.type, 0, stats.fail_count, "-", "-", "-");
+                        continue;
+                }
+
+                shell_print(shell, "    %-24s  %8u  %5u  %6u  %6u  %9u",
+                                stats.type, stats.count, stats.fail_count,
+                                stats.total_us / stats.count, stats.max_us,
+                                stats.bytes / stats.count);
+        }
+
+        shell_print(shell, "");
+        return 0;
+}
+#endif // defined(CONFIG_GATEWAY_CODEC_STATS)
+
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+static int stats_rx(const struct shell *shell, size_t argc, char **argv)
+{
+        size_t i;
+        struct rx_bus_stats stats;
+
+        shell_print(shell,
+                        "  Received Model Messages (%d buffered)\n"
+                        "    %-10s  %8s  %8s  %7s",
+                        CONFIG_GATEWAY_RX_BUS_LEN, "Consumer", "Read", "Overflow", "Pending");
+
+        for (i = 0; !rx_bus_stats_get(i, &stats); i++) {
+                shell_print(shell, "    %-10s  %8u  %8u  %7u",
+                                stats.name, stats.read_count, stats.overflow, stats.pending);
+        }
+
+        shell_print(shell, "    Dropped for length: %u", rx_bus_dropped());
+        shell_print(shell, "    Not for any consumer: %u\n", rx_bus_unmatched());
+        return 0;
+}
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+
+static int stats_mesh(const struct shell *shell, size_t argc, char **argv)
+{
+        size_t i;
+        struct mesh_retry_op_stats stats;
+        struct mesh_retry_node node;
+
+        if (argc > 1) {
+                if (strcmp(argv[1], "reset")) {
+                        shell_error(shell, "Unknown argument: %s", argv[1]);
+                        return -EINVAL;
+                }
+
+                mesh_retry_stats_reset();
+                return 0;
+        }
+
+        shell_print(shell,
+                        "  Mesh Operations\n"
+                        "    %-20s  %8s  %5s  %7s  %8s  %6s  %6s",
+                        "Operation", "Count", "Fails", "Retries", "Timeouts", "Avg ms",
+                        "Max ms");
+
+        for (i = 0; !mesh_retry_op_stats_get(i, &stats); i++) {
+                if (stats.count == 0) {
+                        continue;
+                }
+
+                shell_print(shell, "    %-20s  %8u  %5u  %7u  %8u  %6u  %6u",
+                                btmesh_get_op_str(i), stats.count, stats.fail_count,
+                                stats.retry_count, stats.timeout_count,
+                                stats.total_ms / stats.count, stats.max_ms);
+        }
+
+        shell_print(shell,
+                        "\n  Node Round Trip Times\n"
+                        "    %-7s  %7s  %7s  %7s  %7s  %8s",
+                        "Address", "RTT ms", "Var ms", "RTO ms", "Samples", "Timeouts");
+
+        for (i = 0; !mesh_retry_node_get(i, &node); i++) {
+                if (node.addr == BT_MESH_ADDR_UNASSIGNED) {
+                        continue;
+                }
+
+                shell_print(shell, "    0x%04x   %7u  %7u  %7u  %7u  %8u",
+                                node.addr, node.srtt, node.rttvar, node.rto,
+                                node.sample_count, node.timeout_count);
+        }
+
+        shell_print(shell, "");
+        return 0;
+}
+
+#define STATS_HELP \
+        "Gateway runtime statistics."
+#define STATS_COMPRESSION_HELP \
+        "Print uplink compression ratio and CPU cost.\n" \
+        "USAGE:\n" \
+        "stats compression\n" \
+        " * Ratios are compressed size as a percentage of the plain JSON size.\n"
+#define STATS_ARENA_HELP \
+        "Print cJSON arena usage for each gateway procedure type.\n" \
+        "USAGE:\n" \
+        "stats arena\n" \
+        " * Heap fallbacks count allocations that did not fit in the arena.\n"
+#define STATS_CODEC_HELP \
+        "Print JSON encode cost for each event type and parse cost of cloud requests.\n" \
+        "USAGE:\n" \
+        "stats codec [reset]\n" \
+        " * reset: Clear the codec statistics, e.g. before a benchmark run.\n"
+#define STATS_MESH_HELP \
+        "Print retry and timeout statistics of mesh operations and node round trip times.\n" \
+        "USAGE:\n" \
+        "stats mesh [reset]\n" \
+        " * reset: Clear the counters. Round trip estimates are kept.\n"
+#define STATS_RX_HELP \
+        "Print how far each consumer of received model messages is behind.\n" \
+        "USAGE:\n" \
+        "stats rx\n" \
+        " * Overflow counts messages a consumer lost by falling a whole ring behind.\n"
+
+SHELL_STATIC_SUBCMD_SET_CREATE(stats_subs,
+#if defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+                SHELL_CMD_ARG(compression, NULL, STATS_COMPRESSION_HELP, stats_compression, 1, 0),
+#endif // defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+#if defined(CONFIG_GATEWAY_JSON_ARENA)
+                SHELL_CMD_ARG(arena, NULL, STATS_ARENA_HELP, stats_arena, 1, 0),
+#endif // defined(CONFIG_GATEWAY_JSON_ARENA)
+#if defined(CONFIG_GATEWAY_CODEC_STATS)
+                SHELL_CMD_ARG(codec, NULL, STATS_CODEC_HELP, stats_codec, 1, 1),
+#endif // defined(CONFIG_GATEWAY_CODEC_STATS)
+                SHELL_CMD_ARG(mesh, NULL, STATS_MESH_HELP, stats_mesh, 1, 1),
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+                SHELL_CMD_ARG(rx, NULL, STATS_RX_HELP, stats_rx, 1, 0),
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+                SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(stats, &stats_subs, STATS_HELP, NULL);
+
 /******************************************************************************
  *  PUBLIC SHELL FUNCTIONS
  *****************************************************************************/
 void cli_init(void)
 {
         shell = shell_backend_uart_get_ptr();
+
+#ifdef CONFIG_SHELL_MESH_MSG
+        rx_bus_subscribe(&rx_consumer);
+#endif // CONFIG_SHELL_MESH_MSG
 }
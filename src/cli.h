@@ -12,8 +12,6 @@ extern "C" {
 
 void cli_init(void);
 
-void cli_msg_callback(uint32_t opcode, struct bt_mesh_msg_ctx *ctx, struct net_buf_simple *buf);
-
 void cli_hlth_cb(uint16_t addr, uint8_t test_id, uint16_t cid, uint8_t *faults, size_t fault_count);
 
 
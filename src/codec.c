@@ -1,10 +1,12 @@
 #include <zephyr.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <cJSON.h>
 #include <cJSON_os.h>
 #include <logging/log.h>
 #include <random/rand32.h>
+#include <settings/settings.h>
 #undef __XSI_VISIBLE
 #define __XSI_VISIBLE 1
 #include <date_time.h>
@@ -12,8 +14,18 @@
 #include <posix/time.h>
 
 #include "codec.h"
+#include "beacon_block.h"
+#include "beacon_table.h"
 #include "btmesh.h"
+#include "cfg_txn.h"
+#include "compress.h"
 #include "gw_cloud.h"
+#include "mesh_retry.h"
+#include "model_decode.h"
+#include "reconcile.h"
+#include "sub_set.h"
+#include "sweep.h"
+#include "uplink_rules.h"
 #include "util.h"
 
 
@@ -68,29 +80,331 @@ const char JSON_STR_LPN[] = "lpnFeature";
 const char JSON_STR_PAYLOAD[] = "payload";
 const char JSON_STR_OPCODE[] = "opcode";
 const char JSON_STR_BYTE[] = "byte";
+const char JSON_STR_RESET[] = "reset";
+const char JSON_STR_REFRESH[] = "refresh";
+const char JSON_STR_OPS[] = "operations";
+const char JSON_STR_OP[] = "operation";
+const char JSON_STR_NODES[] = "nodes";
+const char JSON_STR_FAIL_COUNT[] = "failCount";
+const char JSON_STR_RETRY_COUNT[] = "retryCount";
+const char JSON_STR_TIMEOUT_COUNT[] = "timeoutCount";
+const char JSON_STR_SAMPLE_COUNT[] = "sampleCount";
+const char JSON_STR_AVG_TIME[] = "averageTime";
+const char JSON_STR_MAX_TIME[] = "maximumTime";
+const char JSON_STR_RTT[] = "roundTripTime";
+const char JSON_STR_RTT_VAR[] = "roundTripVariance";
+const char JSON_STR_CFG[] = "configuration";
+const char JSON_STR_CFG_VERSION[] = "configVersion";
+const char JSON_STR_STATUS[] = "status";
+const char JSON_STR_MODEL[] = "model";
+const char JSON_STR_NET_BEACON[] = "networkBeaconState";
+const char JSON_STR_HB_SUB[] = "heartbeatSubscribe";
+const char JSON_STR_HB_PUB[] = "heartbeatPublish";
+const char JSON_STR_CONCURRENCY[] = "concurrency";
+const char JSON_STR_INTERVAL[] = "interval";
+const char JSON_STR_MAX_LATENCY[] = "maximumLatency";
+const char JSON_STR_MAX_QUEUE[] = "maximumQueueDepth";
+const char JSON_STR_TOTAL_COUNT[] = "totalCount";
+const char JSON_STR_DONE_COUNT[] = "completeCount";
+const char JSON_STR_ACTIVE_COUNT[] = "activeCount";
+const char JSON_STR_QUEUE_DEPTH[] = "queueDepth";
+const char JSON_STR_LATENCY[] = "latency";
+const char JSON_STR_STEPS[] = "steps";
+const char JSON_STR_ROLLBACK[] = "rollback";
+const char JSON_STR_FAILED_STEP[] = "failedStep";
+const char JSON_STR_FILTER[] = "filter";
+const char JSON_STR_SKIPPED[] = "skipped";
+const char JSON_STR_SKIP_COUNT[] = "skipCount";
+const char JSON_STR_PROFILE[] = "profile";
+const char JSON_STR_PROFILES[] = "profiles";
+const char JSON_STR_NAME[] = "name";
+const char JSON_STR_MATCH[] = "match";
+const char JSON_STR_UUID_PREFIX[] = "uuidPrefix";
+const char JSON_STR_PID[] = "productId";
+const char JSON_STR_ELEM_IDX[] = "elementIndex";
+const char JSON_STR_DESIRED_STATE[] = "desiredState";
+const char JSON_STR_DESIRED_STATES[] = "desiredStates";
+const char JSON_STR_MODELS[] = "models";
+const char JSON_STR_SUBNETS[] = "subnets";
+const char JSON_STR_NODE_COUNT[] = "nodeCount";
+const char JSON_STR_CONVERGED_COUNT[] = "convergedCount";
+const char JSON_STR_PENDING_COUNT[] = "pendingCount";
+const char JSON_STR_DRIFT_COUNT[] = "driftCount";
+const char JSON_STR_OP_COUNT[] = "operationCount";
+const char JSON_STR_FAILED_NODES[] = "failedNodes";
+const char JSON_STR_DEVICES[] = "devices";
+const char JSON_STR_ACTIVE[] = "active";
+const char JSON_STR_QUEUED_COUNT[] = "queuedCount";
+const char JSON_STR_RETRY_WAIT_COUNT[] = "retryWaitCount";
+const char JSON_STR_BATCH_DONE_COUNT[] = "batchCompleteCount";
+const char JSON_STR_BATCH_TIME[] = "batchTime";
+const char JSON_STR_RATE[] = "devicesPerMinute";
+const char JSON_STR_OVERFLOW[] = "overflow";
+const char JSON_STR_UUIDS[] = "uuids";
+const char JSON_STR_CHANGED_COUNT[] = "changedCount";
+const char JSON_STR_LAST_ADDR[] = "lastAddress";
+const char JSON_STR_ALL_GROUPS[] = "allGroups";
+const char JSON_STR_RULES[] = "rules";
+const char JSON_STR_ACTION[] = "action";
+const char JSON_STR_SAMPLE_RATE[] = "sampleRate";
+const char JSON_STR_SRC_LAST_ADDR[] = "sourceLastAddress";
+const char JSON_STR_DST_LAST_ADDR[] = "destinationLastAddress";
+const char JSON_STR_PAYLOAD_PREFIX[] = "payloadPrefix";
+const char JSON_STR_HIT_COUNT[] = "hitCount";
+const char JSON_STR_DECODE[] = "decode";
+const char JSON_STR_DECODED[] = "decoded";
+const char JSON_STR_SENSORS[] = "sensors";
+const char JSON_STR_PROP_ID[] = "propertyId";
+const char JSON_STR_VALUE[] = "value";
+const char JSON_STR_RAW[] = "raw";
+const char JSON_STR_POS_TOLERANCE[] = "positiveTolerance";
+const char JSON_STR_NEG_TOLERANCE[] = "negativeTolerance";
+const char JSON_STR_SAMPLING_FUNC[] = "samplingFunction";
+const char JSON_STR_MEASURE_PERIOD[] = "measurementPeriod";
+const char JSON_STR_UPDATE_INTERVAL[] = "updateInterval";
+const char JSON_STR_COMPRESSION[] = "compression";
+const char JSON_STR_BYTES_IN[] = "bytesIn";
+const char JSON_STR_BYTES_OUT[] = "bytesOut";
+const char JSON_STR_RATIO[] = "ratio";
+const char JSON_STR_AVG_CPU_TIME[] = "averageCpuTime";
+const char JSON_STR_MAX_CPU_TIME[] = "maximumCpuTime";
+
+
+/* The message ID survives reboots. Rather than writing flash for every message, the
+ * stored value is a limit no issued ID has reached yet, and the ID restarts from it after a
+ * reboot. Once the IDs get within a block of the limit, the next block is reserved in the
+ * background, and an ID at the limit waits for the write. */
+#define MSG_ID_STORE_BLOCK 256
+#define MSG_ID_SETTINGS_KEY "msg_id"
+
+static atomic_t message_id;
+static atomic_t message_id_stored;
+K_MUTEX_DEFINE(msg_id_lock);
+
+/* Offset between uptime and UNIX time in milliseconds. Sampled from the date-time library
+ * once per cloud connection so timestamps only cost an addition and a gmtime_r(). */
+static int64_t epoch_offset_ms;
+static atomic_t epoch_valid;
+
+static void msg_id_reserve(uint32_t limit)
+{
+        int err;
+
+        k_mutex_lock(&msg_id_lock, K_FOREVER);
+
+        if (limit > (uint32_t)atomic_get(&message_id_stored)) {
+                err = settings_save_one("codec/" MSG_ID_SETTINGS_KEY, &limit, sizeof(limit));
+
+                if (err) {
+                        LOG_ERR("Failed to store message ID: %d", err);
+                } else {
+                        atomic_set(&message_id_stored, limit);
+                }
+        }
+
+        k_mutex_unlock(&msg_id_lock);
+}
+
+static void msg_id_store(struct k_work *work)
+{
+        msg_id_reserve((uint32_t)atomic_get(&message_id) + 2 * MSG_ID_STORE_BLOCK);
+}
+
+K_WORK_DEFINE(msg_id_store_work, msg_id_store);
+
+static int msg_id_set(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+        uint32_t id;
+
+        if (strcmp(key, MSG_ID_SETTINGS_KEY)) {
+                return -ENOENT;
+        }
+
+        if (len != sizeof(id) || read_cb(cb_arg, &id, sizeof(id)) != sizeof(id)) {
+                return -EINVAL;
+        }
+
+        atomic_set(&message_id, id);
+        atomic_set(&message_id_stored, id);
+        return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(codec, "codec", NULL, msg_id_set, NULL, NULL);
+
+static uint32_t codec_next_msg_id(void)
+{
+        uint32_t id;
+        uint32_t stored;
+
+        id = (uint32_t)atomic_inc(&message_id);
+        stored = (uint32_t)atomic_get(&message_id_stored);
+
+        /* No ID is issued before a limit above it is in flash */
+        if (id >= stored) {
+                msg_id_reserve(id + 2 * MSG_ID_STORE_BLOCK);
+        } else if (stored - id <= MSG_ID_STORE_BLOCK) {
+                k_work_submit(&msg_id_store_work);
+        }
+
+        return id;
+}
+
+static int64_t codec_epoch_offset(void)
+{
+        int64_t now;
+
+        if (atomic_get(&epoch_valid)) {
+                return epoch_offset_ms;
+        }
 
+        if (!date_time_now(&now)) {
+                epoch_offset_ms = now - k_uptime_get();
+                atomic_set(&epoch_valid, 1);
+        }
 
-static int message_id;
+        return epoch_offset_ms;
+}
 
+void codec_epoch_reset(void)
+{
+        atomic_clear(&epoch_valid);
+}
 
-static char *get_time_str(char *dst, size_t len)
+static char *get_time_str(char *dst, size_t len, int64_t uptime_ms)
 {
-        struct timespec ts;
         struct tm tm;
         time_t t;
+        int64_t ms;
+        size_t n;
 
-        if (clock_gettime(CLOCK_REALTIME, &ts) == 0) {
-                t = (time_t)ts.tv_sec;
-                tm = *(gmtime(&t));
-                strftime(dst, len, "%Y-%m-%dT%H:%M:%S.000Z", &tm);
-        }
+        ms = codec_epoch_offset() + uptime_ms;
+        t = (time_t)(ms / MSEC_PER_SEC);
+        gmtime_r(&t, &tm);
+        n = strftime(dst, len, "%Y-%m-%dT%H:%M:%S", &tm);
+        snprintf(&dst[n], len - n, ".%03dZ", (int)(ms % MSEC_PER_SEC));
 
         return dst;
 }
 
-static bool codec_init_event(cJSON **root_obj, cJSON **event_obj, const char *event)
+#if defined(CONFIG_GATEWAY_CODEC_STATS)
+/* One entry per event type, plus the inbound request parse recorded by the gateway */
+#define CODEC_STATS_MAX 24
+
+static struct codec_stats codec_stats[CODEC_STATS_MAX];
+static struct k_spinlock codec_stats_lock;
+
+void codec_stats_record(const char *type, uint32_t cycles, size_t bytes, bool ok)
+{
+        size_t i;
+        uint32_t us;
+        k_spinlock_key_t key;
+        struct codec_stats *stats;
+
+        us = k_cyc_to_us_floor32(cycles);
+        key = k_spin_lock(&codec_stats_lock);
+
+        for (i = 0; i < CODEC_STATS_MAX; i++) {
+                if (codec_stats[i].type == NULL || codec_stats[i].type == type) {
+                        break;
+                }
+        }
+
+        if (i == CODEC_STATS_MAX) {
+                k_spin_unlock(&codec_stats_lock, key);
+                return;
+        }
+
+        stats = &codec_stats[i];
+        stats->type = type;
+
+        if (ok) {
+                stats->count++;
+                stats->bytes += bytes;
+                stats->total_us += us;
+
+                if (us > stats->max_us) {
+                        stats->max_us = us;
+                }
+        } else {
+                stats->fail_count++;
+        }
+
+        k_spin_unlock(&codec_stats_lock, key);
+
+#if CONFIG_GATEWAY_CODEC_STATS_WARN_US > 0
+        if (ok && us > CONFIG_GATEWAY_CODEC_STATS_WARN_US) {
+                LOG_WRN("Codec %s took %dus (%d bytes)", log_strdup(type), us, bytes);
+        }
+#endif
+}
+
+int codec_stats_get(size_t idx, struct codec_stats *stats)
 {
-        char time_str[64];
+        int err;
+        k_spinlock_key_t key;
+
+        if (idx >= CODEC_STATS_MAX) {
+                return -ENOENT;
+        }
+
+        err = 0;
+        key = k_spin_lock(&codec_stats_lock);
+
+        if (codec_stats[idx].type == NULL) {
+                err = -ENOENT;
+        } else {
+                memcpy(stats, &codec_stats[idx], sizeof(*stats));
+        }
+
+        k_spin_unlock(&codec_stats_lock, key);
+        return err;
+}
+
+void codec_stats_reset(void)
+{
+        k_spinlock_key_t key;
+
+        key = k_spin_lock(&codec_stats_lock);
+        memset(codec_stats, 0, sizeof(codec_stats));
+        k_spin_unlock(&codec_stats_lock, key);
+}
+#endif // defined(CONFIG_GATEWAY_CODEC_STATS)
+
+/* Print a finished event into buf. With codec statistics enabled this also records the time
+ * spent since the event envelope was created and the encoded size. Events are encoded from
+ * several threads at once, so the start time is kept in the otherwise unused valueint of
+ * the root object and the event type is read back from the envelope. */
+static bool codec_print(cJSON *root_obj, char *buf, size_t buf_len)
+{
+        bool ok;
+#if defined(CONFIG_GATEWAY_CODEC_STATS)
+        cJSON *type_obj;
+#endif // defined(CONFIG_GATEWAY_CODEC_STATS)
+
+        ok = cJSON_PrintPreallocated(root_obj, buf, buf_len, 0);
+
+#if defined(CONFIG_GATEWAY_CODEC_STATS)
+        type_obj = cJSON_GetObjectItem(cJSON_GetObjectItem(root_obj, JSON_STR_EVENT),
+                        JSON_STR_TYPE);
+
+        if (cJSON_IsString(type_obj)) {
+                codec_stats_record(type_obj->valuestring,
+                                k_cycle_get_32() - (uint32_t)root_obj->valueint,
+                                ok ? strlen(buf) : 0, ok);
+        }
+#endif // defined(CONFIG_GATEWAY_CODEC_STATS)
+
+        return ok;
+}
+
+/* Constant keys and the cached gateway ID are added by reference, so building the envelope
+ * does not copy any strings. */
+static bool codec_init_event_at(cJSON **root_obj, cJSON **event_obj, const char *event,
+                int64_t uptime_ms)
+{
+        char time_str[32];
+        const char *gateway_id;
+        cJSON *item;
 
         *root_obj = cJSON_CreateObject();
 
@@ -98,28 +412,42 @@ static bool codec_init_event(cJSON **root_obj, cJSON **event_obj, const char *ev
                 return false;
         }
 
-        if (cJSON_AddStringToObject(*root_obj, JSON_STR_TYPE, JSON_STR_EVENT) == NULL) {
+#if defined(CONFIG_GATEWAY_CODEC_STATS)
+        (*root_obj)->valueint = (int)k_cycle_get_32();
+#endif // defined(CONFIG_GATEWAY_CODEC_STATS)
+
+        item = cJSON_CreateStringReference(JSON_STR_EVENT);
+
+        if (item == NULL) {
                 goto error;
         }
 
-        if (cJSON_AddStringToObject(*root_obj, "gatewayId", gw_cloud_get_id()) == NULL) {
+        cJSON_AddItemToObjectCS(*root_obj, JSON_STR_TYPE, item);
+        gateway_id = gw_cloud_get_id();
+        item = gateway_id ? cJSON_CreateStringReference(gateway_id) : NULL;
+
+        if (item == NULL) {
                 goto error;
         }
 
+        cJSON_AddItemToObjectCS(*root_obj, "gatewayId", item);
         *event_obj = cJSON_CreateObject();
 
         if (*event_obj == NULL) {
                 goto error;
         }
 
-        cJSON_AddItemToObject(*root_obj, JSON_STR_EVENT, *event_obj);
+        cJSON_AddItemToObjectCS(*root_obj, JSON_STR_EVENT, *event_obj);
+        item = cJSON_CreateStringReference(event);
 
-        if (cJSON_AddStringToObject(*event_obj, JSON_STR_TYPE, event) == NULL) {
+        if (item == NULL) {
                 goto error;
         }
 
+        cJSON_AddItemToObjectCS(*event_obj, JSON_STR_TYPE, item);
+
         if (cJSON_AddStringToObject(*event_obj, "timestamp",
-                                get_time_str(time_str, sizeof(time_str))) == NULL) {
+                                get_time_str(time_str, sizeof(time_str), uptime_ms)) == NULL) {
                 goto error;
         }
 
@@ -130,6 +458,11 @@ error:
         return false;
 }
 
+static bool codec_init_event(cJSON **root_obj, cJSON **event_obj, const char *event)
+{
+        return codec_init_event_at(root_obj, event_obj, event, k_uptime_get());
+}
+
 static bool codec_get_uint8(cJSON *obj, const char *item, uint8_t *uint8)
 {
         cJSON *uint8_obj;
@@ -256,1759 +589,3973 @@ static bool codec_get_str(cJSON *obj, const char *item, char **str)
         return true;
 }
 
-int codec_encode_beacon_list(char *buf, size_t buf_len)
+/* Reserve room for the largest cursor value (and for "null") when measuring a page. */
+#define PAGE_CURSOR_PLACEHOLDER UINT16_MAX
+/* cJSON_PrintPreallocated() may need a few bytes more than the printed length */
+#define PAGE_PRINT_SLACK 6
+
+/* Builds item idx of a paged list. Returns -ENOENT if the list has shrunk below idx. */
+typedef int (*codec_page_item_cb)(size_t idx, cJSON **item, void *user_data);
+
+/* Fill array_obj with as many items as fit in one page of buf_len bytes, starting at the
+ * page cursor, then print the page into buf. The envelope is printed once to measure it and
+ * each item is printed once more to measure it, so building a page is linear in its size. */
+static int codec_encode_page(char *buf, size_t buf_len, cJSON *root_obj, cJSON *event_obj,
+		cJSON *array_obj, struct codec_page *page, codec_page_item_cb item_cb,
+		void *user_data)
 {
-        int err;
-        size_t i;
-        const char *uuid;
-        const char *oob_info;
-        const uint32_t *uri_hash;
-        cJSON *beacon_list_obj;
-        cJSON *event_obj;
-        cJSON *beacons_obj;
-        cJSON *beacon_obj;
+	int err;
+	size_t i;
+	size_t used;
+	size_t item_len;
+	cJSON *total_obj;
+	cJSON *cursor_obj;
+	cJSON *item;
+
+	if (buf_len <= PAGE_PRINT_SLACK) {
+		return -EINVAL;
+	}
 
-        if (!codec_init_event(&beacon_list_obj, &event_obj, "beacon_list")) {
-                return -ENOMEM;
-        }
+	if (cJSON_AddNumberToObject(event_obj, "page", page->index) == NULL) {
+		return -ENOMEM;
+	}
 
-        err = -ENOMEM;
-        beacons_obj  = cJSON_AddArrayToObject(event_obj, "beacons");
+	total_obj = cJSON_AddNumberToObject(event_obj, "totalCount", page->total);
 
-        if (beacons_obj == NULL) {
-                goto cleanup;
-        }
+	if (total_obj == NULL) {
+		return -ENOMEM;
+	}
 
-        i = 0;
-        uuid = btmesh_get_beacon_uuid(i);
-        oob_info = btmesh_get_beacon_oob(i);
-        uri_hash = btmesh_get_beacon_uri_hash(i);
+	cursor_obj = cJSON_AddNumberToObject(event_obj, "cursor", PAGE_CURSOR_PLACEHOLDER);
 
-        while (uuid != NULL) {
-                beacon_obj = cJSON_CreateObject();
+	if (cursor_obj == NULL) {
+		return -ENOMEM;
+	}
 
-                if (beacon_obj == NULL) {
-                        goto cleanup;
-                }
+	if (cJSON_AddNumberToObject(root_obj, JSON_STR_MSG_ID, codec_next_msg_id()) == NULL) {
+		return -ENOMEM;
+	}
+
+	if (!cJSON_PrintPreallocated(root_obj, buf, buf_len - PAGE_PRINT_SLACK, 0)) {
+		return -E2BIG;
+	}
 
-                cJSON_AddItemToArray(beacons_obj, beacon_obj);
+	used = strlen(buf) + PAGE_PRINT_SLACK;
 
-                if (cJSON_AddStringToObject(beacon_obj, JSON_STR_DEVICE_TYPE, JSON_STR_BT_MESH)
-				== NULL) {
-                        goto cleanup;
-                }
+	for (i = page->cursor; i < page->total; i++) {
+		err = item_cb(i, &item, user_data);
 
-                if (cJSON_AddStringToObject(beacon_obj, JSON_STR_UUID, uuid) == NULL) {
-                        goto cleanup;
-                }
+		if (err == -ENOENT) {
+			page->total = i;
+			cJSON_SetNumberValue(total_obj, i);
+			break;
+		}
 
-                if (oob_info == NULL) {
-                        if (cJSON_AddStringToObject(beacon_obj, JSON_STR_OOB_INFO, JSON_STR_NA)
-					== NULL) {
-                                goto cleanup;
-                        }
-                } else {
-                        if (cJSON_AddStringToObject(beacon_obj, JSON_STR_OOB_INFO, oob_info)
-					== NULL) {
-                                goto cleanup;
-                        }
-                }
+		if (err) {
+			return err;
+		}
 
-                if (uri_hash == NULL) {
-                        if (cJSON_AddStringToObject(beacon_obj, JSON_STR_URI_HASH, JSON_STR_NA)
-					== NULL) {
-                                goto cleanup;
-                        }
-                } else {
-                        if (cJSON_AddNumberToObject(beacon_obj, JSON_STR_URI_HASH, *uri_hash)
-					== NULL) {
-                                goto cleanup;
-                        }
-                }
+		if (!cJSON_PrintPreallocated(item, buf, buf_len, 0)) {
+			cJSON_Delete(item);
+			return -E2BIG;
+		}
 
-                i++;
-                uuid = btmesh_get_beacon_uuid(i);
-                oob_info = btmesh_get_beacon_oob(i);
-                uri_hash = btmesh_get_beacon_uri_hash(i);
-        }
+		/* Every item after the first also needs a separating comma */
+		item_len = strlen(buf) + (i != page->cursor);
 
-        if (cJSON_AddNumberToObject(beacon_list_obj, JSON_STR_MSG_ID, message_id++) == NULL) {
-                goto cleanup;
-        }
+		if (used + item_len > buf_len) {
+			cJSON_Delete(item);
 
-        if (!cJSON_PrintPreallocated(beacon_list_obj, buf, buf_len, 0)) {
-                goto cleanup;
-        }
+			if (i == page->cursor) {
+				/* A single item that can never fit in a page */
+				return -E2BIG;
+			}
 
-        err = 0;
+			break;
+		}
 
-cleanup:
-        cJSON_Delete(beacon_list_obj);
-        return err;
-}
+		cJSON_AddItemToArray(array_obj, item);
+		used += item_len;
+	}
 
+	page->cursor = i;
+	page->more = i < page->total;
 
-int codec_encode_prov_result(char *buf,  size_t buf_len, int prov_err,
-                uint16_t net_idx, uint8_t uuid[UUID_LEN], uint16_t addr, uint8_t num_elem)
+	if (page->more) {
+		cJSON_SetNumberValue(cursor_obj, i);
+	} else {
+		cJSON_DeleteItemFromObject(event_obj, "cursor");
+
+		if (cJSON_AddNullToObject(event_obj, "cursor") == NULL) {
+			return -ENOMEM;
+		}
+	}
+
+	if (!codec_print(root_obj, buf, buf_len)) {
+		return -E2BIG;
+	}
+
+	return 0;
+}
+
+int codec_parse_cursor(cJSON *op_obj, uint16_t *cursor)
 {
-        int err;
-        char uuid_str[UUID_STR_LEN];
-        cJSON *prov_result_obj;
-        cJSON *event_obj;
+	*cursor = 0;
 
-        if (!codec_init_event(&prov_result_obj, &event_obj, "provision_result")) {
-                return -ENOMEM;
-        }
+	if (op_obj == NULL || cJSON_GetObjectItem(op_obj, "cursor") == NULL) {
+		return 0;
+	}
 
-        err = -ENOMEM;
+	if (!codec_get_uint16(op_obj, "cursor", cursor)) {
+		return -EINVAL;
+	}
 
-        if (cJSON_AddNumberToObject(event_obj, JSON_STR_ERR, prov_err) == NULL) {
-                goto cleanup;
-        }
+	return 0;
+}
 
-        if (uuid == NULL) {
-                memset(uuid_str, '0', sizeof(uuid_str));
-        } else  {
-                util_uuid2str(uuid, uuid_str);
-        }
+static cJSON *beacon_obj_create(const struct beacon_info *beacon)
+{
+        char uuid[UUID_STR_LEN];
+        const char *oob_info;
+        cJSON *beacon_obj;
 
-        if (cJSON_AddStringToObject(event_obj, JSON_STR_UUID, uuid_str) == NULL) {
-                goto cleanup;
-        }
+        util_uuid2str(beacon->uuid, uuid);
+        oob_info = btmesh_get_oob_str(beacon->oob_info);
 
-        if (prov_err) {
-                /* Other items irrelevent on provision err, so just send as is */
-                goto encode;
-        }
+        beacon_obj = cJSON_CreateObject();
 
-        if(cJSON_AddNumberToObject(event_obj, JSON_STR_NET_IDX, net_idx) == NULL) {
-                goto cleanup;
+        if (beacon_obj == NULL) {
+                return NULL;
         }
 
-        if (cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, addr) == NULL) {
-                goto cleanup;
+        if (cJSON_AddStringToObject(beacon_obj, JSON_STR_DEVICE_TYPE, JSON_STR_BT_MESH) == NULL) {
+                goto error;
         }
 
-        if (cJSON_AddNumberToObject(event_obj, JSON_STR_ELEM_COUNT, num_elem) == NULL) {
-                goto cleanup;
+        if (cJSON_AddStringToObject(beacon_obj, JSON_STR_UUID, uuid) == NULL) {
+                goto error;
         }
 
-        if (cJSON_AddNumberToObject(prov_result_obj, JSON_STR_MSG_ID, message_id++) == NULL) {
-                goto cleanup;
+        if (cJSON_AddStringToObject(beacon_obj, JSON_STR_OOB_INFO,
+                                oob_info ? oob_info : JSON_STR_NA) == NULL) {
+                goto error;
         }
 
-encode:
-        if (!cJSON_PrintPreallocated(prov_result_obj, buf, buf_len, 0)) {
-                goto cleanup;
+        if (!beacon->uri_hash_set) {
+                if (cJSON_AddStringToObject(beacon_obj, JSON_STR_URI_HASH, JSON_STR_NA) == NULL) {
+                        goto error;
+                }
+        } else {
+                if (cJSON_AddNumberToObject(beacon_obj, JSON_STR_URI_HASH,
+                                        beacon->uri_hash) == NULL) {
+                        goto error;
+                }
         }
 
-        err = 0;
+        return beacon_obj;
 
-cleanup:
-        cJSON_Delete(prov_result_obj);
-        return err;
+error:
+        cJSON_Delete(beacon_obj);
+        return NULL;
 }
 
-int codec_parse_prov(cJSON *op_obj, uint8_t uuid[UUID_LEN], uint16_t *net_idx, uint16_t *addr,
-		uint8_t *attn)
+static int encode_beacon(size_t idx, cJSON **item, void *user_data)
 {
-	char *uuid_str;
+        struct beacon_info beacon;
 
-	if (!codec_get_str(op_obj, JSON_STR_UUID, &uuid_str) ||
-	    !codec_get_uint16(op_obj, JSON_STR_NET_IDX, net_idx) ||
-	    !codec_get_uint16(op_obj, JSON_STR_ADDR, addr) ||
-	    !codec_get_uint8(op_obj, JSON_STR_ATTN, attn)) {
-		return -EINVAL;
-	}
+        if (beacon_table_get(idx, &beacon)) {
+                return -ENOENT;
+        }
 
-	util_str2uuid(uuid_str, uuid);
+        *item = beacon_obj_create(&beacon);
 
-	return 0;
+        return *item == NULL ? -ENOMEM : 0;
 }
 
-int codec_encode_subnet_list(char *buf, size_t buf_len)
+int codec_encode_beacon_list(char *buf, size_t buf_len, struct codec_page *page)
 {
         int err;
-        uint8_t i;
-        cJSON *subnet_list_obj;
+        cJSON *beacon_list_obj;
         cJSON *event_obj;
-        cJSON *subnets_obj;
-        cJSON *subnet_obj;
-        struct bt_mesh_cdb_subnet *subnet;
+        cJSON *beacons_obj;
 
-        if (!codec_init_event(&subnet_list_obj, &event_obj, "subnet_list")) {
+        if (!codec_init_event(&beacon_list_obj, &event_obj, "beacon_list")) {
                 return -ENOMEM;
         }
 
-        subnets_obj = cJSON_AddArrayToObject(event_obj, "subnetList");
         err = -ENOMEM;
+        beacons_obj  = cJSON_AddArrayToObject(event_obj, "beacons");
 
-        if (subnets_obj == NULL) {
+        if (beacons_obj == NULL) {
                 goto cleanup;
         }
 
-        subnet = bt_mesh_cdb.subnets;
+        page->total = beacon_table_count();
 
-        for (i = 0; i < SUBNET_COUNT; i++) {
-                if (subnet[i].net_idx == BT_MESH_KEY_UNUSED) {
-                        continue;
-                }
+        err = codec_encode_page(buf, buf_len, beacon_list_obj, event_obj, beacons_obj, page,
+                        encode_beacon, NULL);
 
-                subnet_obj = cJSON_CreateObject();
+cleanup:
+        cJSON_Delete(beacon_list_obj);
+        return err;
+}
 
-                if (subnet_obj == NULL) {
-                        goto cleanup;
-                }
-
-                cJSON_AddItemToArray(subnets_obj, subnet_obj);
-
-                if (cJSON_AddNumberToObject(subnet_obj, JSON_STR_NET_IDX, subnet[i].net_idx)
-				== NULL) {
-                        goto cleanup;
-                }
-        }
-
-        if (!cJSON_PrintPreallocated(subnet_list_obj, buf, buf_len, 0)) {
-                goto cleanup;
-        }
-
-        err = 0;
-
-cleanup:
-        cJSON_Delete(subnet_list_obj);
-        return err;
-}
-
-int codec_parse_subnet(cJSON *op_obj, uint16_t *net_idx)
+#if defined(CONFIG_GATEWAY_BEACON_EVENTS)
+int codec_parse_beacon_events(cJSON *op_obj, bool *enable)
 {
-	if (!codec_get_uint16(op_obj, JSON_STR_NET_IDX, net_idx)) {
+	if (!codec_get_bool(op_obj, JSON_STR_STATE, enable)) {
 		return -EINVAL;
 	}
 
 	return 0;
 }
 
-int codec_parse_subnet_add(cJSON *op_obj, uint16_t *net_idx, uint8_t net_key[KEY_LEN])
+int codec_encode_beacon_events(char *buf, size_t buf_len, const struct beacon_event *events,
+		size_t count, bool found, bool overflow)
 {
-	char *net_key_str;
+	int err;
+	size_t i;
+	char uuid_str[UUID_STR_LEN];
+	cJSON *root_obj;
+	cJSON *event_obj;
+	cJSON *beacons_obj;
+	cJSON *beacon_obj;
 
-	if (!codec_get_str(op_obj, JSON_STR_NET_KEY, &net_key_str)) {
-		return -EINVAL;
+	if (!codec_init_event(&root_obj, &event_obj, found ? "beacon_found" : "beacon_lost")) {
+		return -ENOMEM;
 	}
 
-	util_str2key(net_key_str, net_key);
-		
-	return codec_parse_subnet(op_obj, net_idx);
-}
-
-int codec_encode_app_key_list(char *buf, size_t buf_len)
-{
-        int err;
-        uint8_t i;
-        cJSON *app_key_list_obj;
-        cJSON *event_obj;
-        cJSON *app_keys_obj;
-        cJSON *app_key_obj;
-        struct bt_mesh_cdb_app_key *app_keys;
-
-        if (!codec_init_event(&app_key_list_obj, &event_obj, "app_key_list")) {
-                return -ENOMEM;
-        }
-
-        app_keys_obj = cJSON_AddArrayToObject(event_obj, "appKeyList");
-        err = - ENOMEM;
-
-        if (app_keys_obj == NULL) {
-                goto cleanup;
-        }
-
-        app_keys = bt_mesh_cdb.app_keys;
+	err = -ENOMEM;
+	beacons_obj = cJSON_AddArrayToObject(event_obj, "beacons");
 
-        for (i = 0; i < APP_KEY_COUNT; i++) {
-                if (app_keys[i].net_idx == BT_MESH_KEY_UNUSED) {
-                        continue;
-                }
+	if (beacons_obj == NULL ||
+	    cJSON_AddBoolToObject(event_obj, JSON_STR_OVERFLOW, overflow) == NULL) {
+		goto cleanup;
+	}
 
-                app_key_obj = cJSON_CreateObject();
+	for (i = 0; i < count; i++) {
+		if (events[i].found != found) {
+			continue;
+		}
 
-                if (app_key_obj == NULL) {
-                        goto cleanup;
-                }
+		if (found) {
+			beacon_obj = beacon_obj_create(&events[i].beacon);
+		} else {
+			beacon_obj = cJSON_CreateObject();
+			util_uuid2str(events[i].beacon.uuid, uuid_str);
 
-                cJSON_AddItemToArray(app_keys_obj, app_key_obj);
+			if (beacon_obj != NULL &&
+			    cJSON_AddStringToObject(beacon_obj, JSON_STR_UUID, uuid_str) == NULL) {
+				cJSON_Delete(beacon_obj);
+				beacon_obj = NULL;
+			}
+		}
 
-                if (cJSON_AddNumberToObject(app_key_obj, JSON_STR_APP_IDX, app_keys[i].app_idx)
-				== NULL) {
-                        goto cleanup;
-                }
+		if (beacon_obj == NULL) {
+			goto cleanup;
+		}
 
-                if (cJSON_AddNumberToObject(app_key_obj, JSON_STR_NET_IDX, app_keys[i].net_idx)
-				== NULL) {
-                        goto cleanup;
-                }
-        }
+		cJSON_AddItemToArray(beacons_obj, beacon_obj);
+	}
 
-        if (!cJSON_PrintPreallocated(app_key_list_obj, buf, buf_len, 0)) {
-                goto cleanup;
-        }
+	if (!codec_print(root_obj, buf, buf_len)) {
+		goto cleanup;
+	}
 
-        err = 0;
+	err = 0;
 
 cleanup:
-        cJSON_Delete(app_key_list_obj);
-        return err;
+	cJSON_Delete(root_obj);
+	return err;
 }
+#endif // defined(CONFIG_GATEWAY_BEACON_EVENTS)
 
-int codec_parse_app_key(cJSON *op_obj, uint16_t *net_idx, uint16_t *app_idx)
+int codec_parse_beacon_block(cJSON *op_obj, uint8_t (**uuids)[UUID_LEN], size_t *count)
 {
-	if (!codec_get_uint16(op_obj, JSON_STR_NET_IDX, net_idx) ||
-	    !codec_get_uint16(op_obj, JSON_STR_APP_IDX, app_idx)) {
-		return -EINVAL;
-	}
-
-	return 0;
-}
+	size_t i;
+	cJSON *uuids_obj;
+	cJSON *uuid_obj;
 
-int codec_parse_app_key_add(cJSON *op_obj, uint16_t *net_idx, uint16_t *app_idx,
-		uint8_t app_key[KEY_LEN])
-{
-	char *app_key_str;
+	uuids_obj = cJSON_GetObjectItem(op_obj, JSON_STR_UUIDS);
 
-	if (!codec_get_str(op_obj, JSON_STR_APP_KEY, &app_key_str)) {
+	if (!cJSON_IsArray(uuids_obj) || cJSON_GetArraySize(uuids_obj) == 0) {
 		return -EINVAL;
 	}
 
-	util_str2key(app_key_str, app_key);
-
-	return codec_parse_app_key(op_obj, net_idx, app_idx);
-}
-
-static uint8_t encode_node(struct bt_mesh_cdb_node *node, void *nodes)
-{
-        char uuid_str[UUID_STR_LEN];
-        cJSON *node_array_obj;
-        cJSON *node_obj;
-
-        node_array_obj = (cJSON *)nodes;
+	*count = cJSON_GetArraySize(uuids_obj);
+	*uuids = k_malloc(sizeof(**uuids) * *count);
 
-        if (node_array_obj == NULL) {
-                goto error;
-        }
-
-        node_obj = cJSON_CreateObject();
+	if (*uuids == NULL) {
+		return -ENOMEM;
+	}
 
-        if (node_obj == NULL) {
-                goto error;
-        }
+	i = 0;
 
-        cJSON_AddItemToArray(node_array_obj, node_obj);
+	/* Walked rather than indexed, as lists can hold thousands of UUIDs */
+	cJSON_ArrayForEach(uuid_obj, uuids_obj) {
+		if (!cJSON_IsString(uuid_obj) ||
+		    util_str2uuid(uuid_obj->valuestring, (*uuids)[i])) {
+			k_free(*uuids);
+			*uuids = NULL;
+			return -EINVAL;
+		}
 
-        if (cJSON_AddStringToObject(node_obj, JSON_STR_DEVICE_TYPE, JSON_STR_BT_MESH) == NULL) {
-                goto error;
-        }
+		i++;
+	}
 
-        util_uuid2str(node->uuid, uuid_str);
+	return 0;
+}
 
-        if (cJSON_AddStringToObject(node_obj, JSON_STR_UUID, uuid_str) == NULL) {
-                goto error;
-        }
+int codec_encode_beacon_block_result(char *buf, size_t buf_len, int block_err, size_t changed,
+		size_t total)
+{
+	int err;
+	cJSON *root_obj;
+	cJSON *event_obj;
 
-        if (cJSON_AddNumberToObject(node_obj, JSON_STR_NET_IDX, node->net_idx) == NULL) {
-                goto error;
-        }
+	if (!codec_init_event(&root_obj, &event_obj, "beacon_blocklist_status")) {
+		return -ENOMEM;
+	}
 
-        if (cJSON_AddNumberToObject(node_obj, JSON_STR_ADDR, node->addr) == NULL) {
-                goto error;
-        }
+	err = -ENOMEM;
 
-        if (cJSON_AddNumberToObject(node_obj, JSON_STR_ELEM_COUNT, node->num_elem) == NULL) {
-                goto error;
-        }
+	if (cJSON_AddNumberToObject(event_obj, JSON_STR_ERR, block_err) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_CHANGED_COUNT, changed) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_TOTAL_COUNT, total) == NULL) {
+		goto cleanup;
+	}
 
-        return BT_MESH_CDB_ITER_CONTINUE;
+	if (!codec_print(root_obj, buf, buf_len)) {
+		goto cleanup;
+	}
 
-error:
-        cJSON_Delete(nodes);
-        return BT_MESH_CDB_ITER_STOP;
-}
+	err = 0;
 
-int codec_parse_node_disc(cJSON *op_obj, uint16_t *addr)
-{
-	if (!codec_get_uint16(op_obj, JSON_STR_ADDR, addr)) {
-		return -EINVAL;
-	}
-	
-	return 0;
+cleanup:
+	cJSON_Delete(root_obj);
+	return err;
 }
 
-int codec_encode_node_list(char *buf, size_t buf_len)
+static int encode_blocked_uuid(size_t idx, cJSON **item, void *user_data)
 {
-        int err;
-        cJSON *node_list_obj;
-        cJSON *event_obj;
-        cJSON *nodes_obj;
+	uint8_t uuid[UUID_LEN];
+	char uuid_str[UUID_STR_LEN];
 
-        if (!codec_init_event(&node_list_obj, &event_obj, "node_list")) {
-                return -ENOMEM;
-        }
+	if (beacon_block_get(idx, uuid)) {
+		return -ENOENT;
+	}
 
-        err = -ENOMEM;
+	util_uuid2str(uuid, uuid_str);
+	*item = cJSON_CreateString(uuid_str);
 
-        nodes_obj = cJSON_AddArrayToObject(event_obj, "nodes");
+	return *item == NULL ? -ENOMEM : 0;
+}
 
-        if (nodes_obj == NULL) {
-                goto cleanup;
-        }
+int codec_encode_beacon_blocklist(char *buf, size_t buf_len, struct codec_page *page)
+{
+	int err;
+	cJSON *root_obj;
+	cJSON *event_obj;
+	cJSON *uuids_obj;
 
-        bt_mesh_cdb_node_foreach(encode_node, (void*)nodes_obj);
+	if (!codec_init_event(&root_obj, &event_obj, "beacon_blocklist")) {
+		return -ENOMEM;
+	}
 
-        if (nodes_obj == NULL) {
-                goto cleanup;
-        }
+	err = -ENOMEM;
+	uuids_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_UUIDS);
 
-        if (cJSON_AddNumberToObject(node_list_obj, JSON_STR_MSG_ID, message_id++) == NULL ) {
-                goto cleanup;
-        }
+	if (uuids_obj == NULL) {
+		goto cleanup;
+	}
 
-        if (!cJSON_PrintPreallocated(node_list_obj, buf, buf_len, 0)) {
-                goto cleanup;
-        }
+	page->total = beacon_block_count();
 
-        err = 0;
+	err = codec_encode_page(buf, buf_len, root_obj, event_obj, uuids_obj, page,
+			encode_blocked_uuid, NULL);
 
 cleanup:
-        cJSON_Delete(node_list_obj);
-        return err;
+	cJSON_Delete(root_obj);
+	return err;
 }
 
-int codec_encode_node_disc(char *buf, size_t buf_len, struct btmesh_node *node, int disc_err,
-                uint8_t status)
+
+int codec_encode_prov_result(char *buf,  size_t buf_len, int prov_err,
+                uint16_t net_idx, uint8_t uuid[UUID_LEN], uint16_t addr, uint8_t num_elem)
 {
         int err;
-        int *temp_int_array;
-        uint8_t i;
-        uint8_t j;
-        uint8_t k;
-        struct btmesh_elem *elem;
-        struct btmesh_sig_model *sig_model;
-        struct btmesh_vnd_model *vnd_model;
         char uuid_str[UUID_STR_LEN];
-        cJSON *disc_obj;
+        cJSON *prov_result_obj;
         cJSON *event_obj;
-        cJSON *feature_obj;
-	cJSON *hb_sub_obj;
-	cJSON *hb_pub_obj;
-        cJSON *array_obj;
-        cJSON *elem_array_obj;
-        cJSON *elem_obj;
-        cJSON *model_array_obj;
-        cJSON *model_obj;
-        cJSON *pub_obj;
 
-        if (!codec_init_event(&disc_obj, &event_obj, "node_discover_result")) {
+        if (!codec_init_event(&prov_result_obj, &event_obj, "provision_result")) {
                 return -ENOMEM;
         }
 
         err = -ENOMEM;
 
-        if (cJSON_AddNumberToObject(event_obj, JSON_STR_ERR, disc_err) == NULL) {
-                goto cleanup;
-        }
-
-        if (cJSON_AddNumberToObject(event_obj, "status", status) == NULL) {
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_ERR, prov_err) == NULL) {
                 goto cleanup;
         }
 
-        if (cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, node->addr) == NULL) {
-                goto cleanup;
-        }
-        
-	if (disc_err || status) {
-                /* If there was an error or status performing the discovery, then all other items
-                 * are irrelevant so encode the JSON as it is */
-                goto encode;
+        if (uuid == NULL) {
+                memset(uuid_str, '0', sizeof(uuid_str));
+        } else  {
+                util_uuid2str(uuid, uuid_str);
         }
 
-        util_uuid2str(node->uuid, uuid_str);
-
         if (cJSON_AddStringToObject(event_obj, JSON_STR_UUID, uuid_str) == NULL) {
                 goto cleanup;
         }
 
-        if (cJSON_AddNumberToObject(event_obj, "cid", node->cid) == NULL) {
-                goto cleanup;
+        if (prov_err) {
+                /* Other items irrelevent on provision err, so just send as is */
+                goto encode;
         }
 
-        if (cJSON_AddNumberToObject(event_obj, "pid", node->pid) == NULL) {
+        if(cJSON_AddNumberToObject(event_obj, JSON_STR_NET_IDX, net_idx) == NULL) {
                 goto cleanup;
         }
 
-        if (cJSON_AddNumberToObject(event_obj, "vid", node->vid) == NULL) {
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, addr) == NULL) {
                 goto cleanup;
         }
 
-        if (cJSON_AddNumberToObject(event_obj, "crpl", node->crpl) == NULL) {
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_ELEM_COUNT, num_elem) == NULL) {
                 goto cleanup;
         }
 
-        if (cJSON_AddBoolToObject(event_obj, "networkBeaconState", node->net_beacon_state) == NULL) {
+        if (cJSON_AddNumberToObject(prov_result_obj, JSON_STR_MSG_ID, codec_next_msg_id()) == NULL) {
                 goto cleanup;
         }
 
-        if (cJSON_AddNumberToObject(event_obj, JSON_STR_TTL, node->ttl) == NULL) {
+encode:
+        if (!codec_print(prov_result_obj, buf, buf_len)) {
                 goto cleanup;
         }
 
-        feature_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_RELAY);
+        err = 0;
 
-        if (feature_obj == NULL) {
-                goto cleanup;
-        }
+cleanup:
+        cJSON_Delete(prov_result_obj);
+        return err;
+}
 
-        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_SUPPORT, node->relay.support) == NULL) {
-                goto cleanup;
-        }
+int codec_parse_prov(cJSON *op_obj, uint8_t uuid[UUID_LEN], uint16_t *net_idx, uint16_t *addr,
+		uint8_t *attn, char **profile)
+{
+	char *uuid_str;
 
-        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_STATE, node->relay.state) == NULL) {
-                goto cleanup;
-        }
+	/* Optional, selects the provisioning profile applied to the node */
+	if (!codec_get_str(op_obj, JSON_STR_PROFILE, profile)) {
+		*profile = NULL;
+	}
 
-        if (cJSON_AddNumberToObject(feature_obj, JSON_STR_TX_COUNT, node->relay.count) == NULL) {
-                goto cleanup;
-        }
+	if (!codec_get_str(op_obj, JSON_STR_UUID, &uuid_str) ||
+	    !codec_get_uint16(op_obj, JSON_STR_NET_IDX, net_idx) ||
+	    !codec_get_uint16(op_obj, JSON_STR_ADDR, addr) ||
+	    !codec_get_uint8(op_obj, JSON_STR_ATTN, attn)) {
+		return -EINVAL;
+	}
 
-        if (cJSON_AddNumberToObject(feature_obj, JSON_STR_TX_INT, node->relay.interval) == NULL) {
-                goto cleanup;
-        }
+	return util_str2uuid(uuid_str, uuid);
+}
 
-        feature_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_PROXY);
+static int parse_prov_profile_name(cJSON *obj, char profile[PROV_PROFILE_NAME_LEN + 1])
+{
+	char *name;
 
-        if (feature_obj == NULL) {
-                goto cleanup;
-        }
+	if (!codec_get_str(obj, JSON_STR_PROFILE, &name)) {
+		return 0;
+	}
 
-        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_SUPPORT, node->proxy.support) == NULL) {
-                goto cleanup;
-        }
+	if (strlen(name) > PROV_PROFILE_NAME_LEN) {
+		return -EINVAL;
+	}
 
-        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_STATE, node->proxy.state) == NULL) {
-                goto cleanup;
-        }
+	strcpy(profile, name);
+	return 0;
+}
 
-        feature_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_FRIEND);
+/* Items a device leaves out are taken from the request */
+static int parse_prov_bulk_dev(cJSON *dev_obj, const struct prov_queue_dev *defaults,
+		struct prov_queue_dev *dev)
+{
+	int err;
+	char *uuid_str;
 
-        if (feature_obj == NULL) {
-                goto cleanup;
-        }
+	*dev = *defaults;
+	codec_get_uint16(dev_obj, JSON_STR_NET_IDX, &dev->net_idx);
+	codec_get_uint16(dev_obj, JSON_STR_ADDR, &dev->addr);
+	codec_get_uint8(dev_obj, JSON_STR_ELEM_COUNT, &dev->elem_count);
+	codec_get_uint8(dev_obj, JSON_STR_ATTN, &dev->attn);
+	err = parse_prov_profile_name(dev_obj, dev->profile);
 
-        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_SUPPORT, node->friend.support) == NULL) {
-                goto cleanup;
-        }
+	if (err) {
+		return err;
+	}
 
-        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_STATE, node->friend.state) == NULL) {
-                goto cleanup;
-        }
+	if (!codec_get_str(dev_obj, JSON_STR_UUID, &uuid_str) || dev->elem_count == 0 ||
+	    (dev->addr != BT_MESH_ADDR_UNASSIGNED && !BT_MESH_ADDR_IS_UNICAST(dev->addr))) {
+		return -EINVAL;
+	}
 
-        feature_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_LPN);
+	return util_str2uuid(uuid_str, dev->uuid);
+}
 
-        if (feature_obj == NULL) {
-                goto cleanup;
-        }
+int codec_parse_prov_bulk(cJSON *op_obj, struct prov_queue_dev **devs, size_t *dev_count)
+{
+	size_t i;
+	int err;
+	cJSON *devs_obj;
+	struct prov_queue_dev defaults;
 
-        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_STATE, node->lpn) == NULL) {
-                goto cleanup;
-        }
+	memset(&defaults, 0, sizeof(defaults));
+	defaults.net_idx = PRIMARY_SUBNET;
+	defaults.elem_count = 1;
+	codec_get_uint16(op_obj, JSON_STR_NET_IDX, &defaults.net_idx);
+	codec_get_uint8(op_obj, JSON_STR_ELEM_COUNT, &defaults.elem_count);
+	codec_get_uint8(op_obj, JSON_STR_ATTN, &defaults.attn);
+	err = parse_prov_profile_name(op_obj, defaults.profile);
+
+	if (err) {
+		return err;
+	}
 
-	hb_sub_obj = cJSON_AddObjectToObject(event_obj, "heartbeatSubscribe");
+	devs_obj = cJSON_GetObjectItem(op_obj, JSON_STR_DEVICES);
 
-	if (hb_sub_obj == NULL) {
-		goto cleanup;
+	if (!cJSON_IsArray(devs_obj) || cJSON_GetArraySize(devs_obj) == 0) {
+		return -EINVAL;
 	}
 
-	if (cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_SRC_ADDR, node->hb_sub.src) == NULL ||
-	    cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_DST_ADDR, node->hb_sub.dst) == NULL ||
-	    cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_PERIOD, node->hb_sub.period) == NULL ||
-	    cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_COUNT, node->hb_sub.count) == NULL ||
-	    cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_MIN_HOPS, node->hb_sub.min) == NULL ||
-	    cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_MAX_HOPS, node->hb_sub.max) == NULL) {
-		goto cleanup;
+	*dev_count = cJSON_GetArraySize(devs_obj);
+	*devs = k_malloc(sizeof(**devs) * *dev_count);
+
+	if (*devs == NULL) {
+		return -ENOMEM;
 	}
 
-	hb_pub_obj = cJSON_AddObjectToObject(event_obj, "heartbeatPublish");
+	for (i = 0; i < *dev_count; i++) {
+		err = parse_prov_bulk_dev(cJSON_GetArrayItem(devs_obj, i), &defaults, &(*devs)[i]);
 
-	if (hb_pub_obj == NULL) {
-		goto cleanup;
+		if (err) {
+			k_free(*devs);
+			*devs = NULL;
+			return err;
+		}
 	}
 
-	if (cJSON_AddNumberToObject(hb_pub_obj, JSON_STR_DST_ADDR, node->hb_pub.dst) == NULL ||
-	    cJSON_AddNumberToObject(hb_pub_obj, JSON_STR_COUNT, node->hb_pub.count) == NULL ||
-	    cJSON_AddNumberToObject(hb_pub_obj, JSON_STR_PERIOD, node->hb_pub.period) == NULL ||
-	    cJSON_AddNumberToObject(hb_pub_obj, JSON_STR_TTL, node->hb_pub.ttl) == NULL ||
-	    cJSON_AddBoolToObject(hb_pub_obj, JSON_STR_RELAY,
-		    node->hb_pub.feat & BT_MESH_FEAT_RELAY) == NULL ||
-	    cJSON_AddBoolToObject(hb_pub_obj, JSON_STR_PROXY,
-		    node->hb_pub.feat & BT_MESH_FEAT_PROXY) == NULL ||
-	    cJSON_AddBoolToObject(hb_pub_obj, JSON_STR_FRIEND,
-		    node->hb_pub.feat & BT_MESH_FEAT_FRIEND) == NULL ||
-	    cJSON_AddBoolToObject(hb_pub_obj, JSON_STR_LPN,
-		    node->hb_pub.feat & BT_MESH_FEAT_LOW_POWER) == NULL) {
+	return 0;
+}
+
+int codec_encode_prov_queue_status(char *buf, size_t buf_len,
+		const struct prov_queue_stats *stats)
+{
+	int err;
+	double rate;
+	cJSON *status_obj;
+	cJSON *event_obj;
+
+	if (!codec_init_event(&status_obj, &event_obj, "provision_queue_status")) {
+		return -ENOMEM;
+	}
+
+	err = -ENOMEM;
+	rate = stats->batch_time_ms ?
+		stats->batch_done * (double)MSEC_PER_SEC * 60 / stats->batch_time_ms : 0;
+
+	if (cJSON_AddNumberToObject(event_obj, JSON_STR_QUEUED_COUNT, stats->queued) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_RETRY_WAIT_COUNT,
+		    stats->retrying) == NULL ||
+	    cJSON_AddBoolToObject(event_obj, JSON_STR_ACTIVE, stats->active) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_DONE_COUNT, stats->done) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_FAIL_COUNT, stats->failed) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_RETRY_COUNT, stats->retries) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_AVG_TIME, stats->avg_time_ms) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_BATCH_DONE_COUNT,
+		    stats->batch_done) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_BATCH_TIME, stats->batch_time_ms) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_RATE, rate) == NULL) {
 		goto cleanup;
 	}
 
-        temp_int_array = (int *)k_malloc(sizeof(int) * node->subnet_count);
+	if (!codec_print(status_obj, buf, buf_len)) {
+		goto cleanup;
+	}
 
-        if (temp_int_array == NULL) {
-                goto cleanup;
-        }
+	err = 0;
 
-        for (i = 0; i < node->subnet_count; i++) {
-                temp_int_array[i] = (int)node->subnet_idxs[i];
-        }
+cleanup:
+	cJSON_Delete(status_obj);
+	return err;
+}
 
-        array_obj = cJSON_CreateIntArray(temp_int_array, node->subnet_count);
+int codec_encode_subnet_list(char *buf, size_t buf_len)
+{
+        int err;
+        uint8_t i;
+        cJSON *subnet_list_obj;
+        cJSON *event_obj;
+        cJSON *subnets_obj;
+        cJSON *subnet_obj;
+        struct bt_mesh_cdb_subnet *subnet;
 
-        if (array_obj == NULL) {
-                goto cleanup;
+        if (!codec_init_event(&subnet_list_obj, &event_obj, "subnet_list")) {
+                return -ENOMEM;
         }
 
-        k_free(temp_int_array);
-        cJSON_AddItemToObject(event_obj, "subnets", array_obj);
-        elem_array_obj = cJSON_AddArrayToObject(event_obj, "elements");
+        subnets_obj = cJSON_AddArrayToObject(event_obj, "subnetList");
+        err = -ENOMEM;
 
-        if (elem_array_obj == NULL) {
+        if (subnets_obj == NULL) {
                 goto cleanup;
         }
 
-        for (i = 0; i < node->elem_count; i++) {
-                elem_obj = cJSON_CreateObject();
+        subnet = bt_mesh_cdb.subnets;
 
-                if (elem_obj == NULL) {
-                        goto cleanup;
+        for (i = 0; i < SUBNET_COUNT; i++) {
+                if (subnet[i].net_idx == BT_MESH_KEY_UNUSED) {
+                        continue;
                 }
 
-                cJSON_AddItemToArray(elem_array_obj, elem_obj);
-                elem = &(node->elems[i]);
-
-                if (cJSON_AddNumberToObject(elem_obj, JSON_STR_ADDR, elem->addr) == NULL) {
-                        goto cleanup;
-                }
+                subnet_obj = cJSON_CreateObject();
 
-                if (cJSON_AddNumberToObject(elem_obj, "loc", elem->loc) == NULL) {
+                if (subnet_obj == NULL) {
                         goto cleanup;
                 }
 
-                model_array_obj = cJSON_AddArrayToObject(elem_obj, "sigModels");
+                cJSON_AddItemToArray(subnets_obj, subnet_obj);
 
-                if (model_array_obj == NULL) {
+                if (cJSON_AddNumberToObject(subnet_obj, JSON_STR_NET_IDX, subnet[i].net_idx)
+				== NULL) {
                         goto cleanup;
                 }
+        }
 
-                for (j = 0; j < elem->sig_model_count; j++) {
-                        model_obj = cJSON_CreateObject();
-
-                        if (model_obj == NULL) {
-                                goto cleanup;
-                        }
-
-                        cJSON_AddItemToArray(model_array_obj, model_obj);
-                        sig_model = &elem->sig_models[j];
+        if (!codec_print(subnet_list_obj, buf, buf_len)) {
+                goto cleanup;
+        }
 
-                        if (cJSON_AddNumberToObject(model_obj, JSON_STR_MOD_ID, sig_model->model_id)
-					== NULL) {
-                                goto cleanup;
-                        }
-                        /* Add appkey indexes to model */
-			if (sig_model->appkey_count > 0) {
-				temp_int_array = (int *)k_malloc(sizeof(int) * sig_model->appkey_count);
+        err = 0;
 
-				if (temp_int_array == NULL) {
-					goto cleanup;
-				}
+cleanup:
+        cJSON_Delete(subnet_list_obj);
+        return err;
+}
 
-				for (k = 0; k < sig_model->appkey_count; k++) {
-					temp_int_array[k] = (int)sig_model->appkey_idxs[k];
-				}
+int codec_parse_subnet(cJSON *op_obj, uint16_t *net_idx)
+{
+	if (!codec_get_uint16(op_obj, JSON_STR_NET_IDX, net_idx)) {
+		return -EINVAL;
+	}
 
-				array_obj = cJSON_CreateIntArray(temp_int_array, sig_model->appkey_count);
+	return 0;
+}
 
-				if (array_obj == NULL) {
-					goto cleanup;
-				}
+int codec_parse_subnet_add(cJSON *op_obj, uint16_t *net_idx, uint8_t net_key[KEY_LEN])
+{
+	char *net_key_str;
 
-				k_free(temp_int_array);
-			} else {
-				array_obj = cJSON_CreateArray();
-			}
-			cJSON_AddItemToObject(model_obj, JSON_STR_APP_IDXS, array_obj);
+	if (!codec_get_str(op_obj, JSON_STR_NET_KEY, &net_key_str) ||
+	    util_str2key(net_key_str, net_key)) {
+		return -EINVAL;
+	}
+		
+	return codec_parse_subnet(op_obj, net_idx);
+}
 
-                        /* Add subscribe addresses to model */
-			if (sig_model->sub_addr_count > 0) {
-				temp_int_array = (int *)k_malloc(sizeof(int) * sig_model->sub_addr_count);
+int codec_encode_app_key_list(char *buf, size_t buf_len)
+{
+        int err;
+        uint8_t i;
+        cJSON *app_key_list_obj;
+        cJSON *event_obj;
+        cJSON *app_keys_obj;
+        cJSON *app_key_obj;
+        struct bt_mesh_cdb_app_key *app_keys;
 
-				if (temp_int_array == NULL) {
-					goto cleanup;
-				}
+        if (!codec_init_event(&app_key_list_obj, &event_obj, "app_key_list")) {
+                return -ENOMEM;
+        }
 
-				for (k = 0; k < sig_model->sub_addr_count; k++) {
-					temp_int_array[k] = (int)sig_model->sub_addrs[k];
-				}
+        app_keys_obj = cJSON_AddArrayToObject(event_obj, "appKeyList");
+        err = - ENOMEM;
 
-				array_obj = cJSON_CreateIntArray(temp_int_array, sig_model->sub_addr_count);
+        if (app_keys_obj == NULL) {
+                goto cleanup;
+        }
 
-				if (array_obj == NULL) {
-					goto cleanup;
-				}
+        app_keys = bt_mesh_cdb.app_keys;
 
-				k_free(temp_int_array);
-			} else {
-				array_obj = cJSON_CreateArray();
-			}
-			cJSON_AddItemToObject(model_obj, JSON_STR_SUB_ADDRS, array_obj);
-
-                        /* Add publish parameters to model */
-                        pub_obj = cJSON_AddObjectToObject(model_obj, JSON_STR_PUB_PARAMS);
-
-                        if (pub_obj == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_ADDR, sig_model->pub.addr) == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_APP_IDX,
-						sig_model->pub.app_idx) == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddBoolToObject(pub_obj, JSON_STR_FRIEND_CRED_FLAG,
-                                                sig_model->pub.cred_flag) == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_TTL, sig_model->pub.ttl) == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_PERIOD, 
-                                                btmesh_get_pub_period(sig_model->pub.period)) == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddStringToObject(pub_obj, JSON_STR_PERIOD_UNITS,
-                                                btmesh_get_pub_period_unit_str(sig_model->pub.period)) == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_TX_COUNT,
-                                                BT_MESH_TRANSMIT_COUNT(sig_model->pub.transmit)) == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_TX_INT,
-                                                BT_MESH_TRANSMIT_INT(sig_model->pub.transmit)) == NULL) {
-                                goto cleanup;
-                        }
+        for (i = 0; i < APP_KEY_COUNT; i++) {
+                if (app_keys[i].net_idx == BT_MESH_KEY_UNUSED) {
+                        continue;
                 }
 
-                // Get array of vendor models */
-                model_array_obj = cJSON_AddArrayToObject(elem_obj, "vendorModels");
+                app_key_obj = cJSON_CreateObject();
 
-                if (model_array_obj == NULL) {
+                if (app_key_obj == NULL) {
                         goto cleanup;
                 }
-                
-		for (j = 0; j < elem->vnd_model_count; j++) {
-                        model_obj = cJSON_CreateObject();
-
-                        if (model_obj == NULL) {
-                                goto cleanup;
-                        }
 
-                        cJSON_AddItemToArray(model_array_obj, model_obj);
-                        vnd_model = &elem->vnd_models[j];
-
-                        if (cJSON_AddNumberToObject(model_obj, JSON_STR_CID, vnd_model->company_id)
-					== NULL) {
-                                goto cleanup;
-                        }
+                cJSON_AddItemToArray(app_keys_obj, app_key_obj);
 
-                        if (cJSON_AddNumberToObject(model_obj, JSON_STR_MOD_ID, vnd_model->model_id)
-					== NULL) {
-                                goto cleanup;
-                        }
+                if (cJSON_AddNumberToObject(app_key_obj, JSON_STR_APP_IDX, app_keys[i].app_idx)
+				== NULL) {
+                        goto cleanup;
+                }
 
-                        /* Add appkey indexes to model */
-			if (vnd_model->appkey_count > 0) {
-				temp_int_array = (int *)k_malloc(sizeof(int) * vnd_model->appkey_count);
+                if (cJSON_AddNumberToObject(app_key_obj, JSON_STR_NET_IDX, app_keys[i].net_idx)
+				== NULL) {
+                        goto cleanup;
+                }
+        }
 
-				if (temp_int_array == NULL) {
-					goto cleanup;
-				}
+        if (!codec_print(app_key_list_obj, buf, buf_len)) {
+                goto cleanup;
+        }
 
-				for (k = 0; k < vnd_model->appkey_count; k++) {
-					temp_int_array[k] = (int)vnd_model->appkey_idxs[k];
-				}
+        err = 0;
 
-				array_obj = cJSON_CreateIntArray(temp_int_array, vnd_model->appkey_count);
+cleanup:
+        cJSON_Delete(app_key_list_obj);
+        return err;
+}
 
-				if (array_obj == NULL) {
-					goto cleanup;
-				}
+int codec_parse_app_key(cJSON *op_obj, uint16_t *net_idx, uint16_t *app_idx)
+{
+	if (!codec_get_uint16(op_obj, JSON_STR_NET_IDX, net_idx) ||
+	    !codec_get_uint16(op_obj, JSON_STR_APP_IDX, app_idx)) {
+		return -EINVAL;
+	}
 
-				k_free(temp_int_array);
-			} else {
-				array_obj = cJSON_CreateArray();
-			}
-                        cJSON_AddItemToObject(model_obj, JSON_STR_APP_IDXS, array_obj);
+	return 0;
+}
 
-                        /* Add subscribe addresses to model */
-			if (vnd_model->sub_addr_count > 0) {
-				temp_int_array = (int *)k_malloc(sizeof(int) * vnd_model->sub_addr_count);
+int codec_parse_app_key_add(cJSON *op_obj, uint16_t *net_idx, uint16_t *app_idx,
+		uint8_t app_key[KEY_LEN])
+{
+	char *app_key_str;
 
-				if (temp_int_array == NULL) {
-					goto cleanup;
-				}
+	if (!codec_get_str(op_obj, JSON_STR_APP_KEY, &app_key_str) ||
+	    util_str2key(app_key_str, app_key)) {
+		return -EINVAL;
+	}
 
-				array_obj = cJSON_CreateIntArray(temp_int_array, vnd_model->sub_addr_count);
+	return codec_parse_app_key(op_obj, net_idx, app_idx);
+}
 
-				if (array_obj == NULL) {
-					goto cleanup;
-				}
+struct node_find {
+        size_t idx;
+        size_t count;
+        struct bt_mesh_cdb_node *node;
+};
 
-				k_free(temp_int_array);
-			} else {
-				array_obj = cJSON_CreateArray();
-			}
-                        cJSON_AddItemToObject(model_obj, JSON_STR_SUB_ADDRS, array_obj);
-
-                        /* Add publish parameters to model */
-                        pub_obj = cJSON_AddObjectToObject(model_obj, JSON_STR_PUB_PARAMS);
-
-                        if (pub_obj == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_ADDR, vnd_model->pub.addr)
-					== NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_APP_IDX,
-						vnd_model->pub.app_idx)
-					== NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddBoolToObject(pub_obj, JSON_STR_FRIEND_CRED_FLAG,
-                                                vnd_model->pub.cred_flag) == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_TTL, vnd_model->pub.ttl)
-					== NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_PERIOD,
-                                                btmesh_get_pub_period(vnd_model->pub.period)) == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddStringToObject(pub_obj, JSON_STR_PERIOD_UNITS,
-                                                btmesh_get_pub_period_unit_str(vnd_model->pub.period)) == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_TX_COUNT,
-                                                BT_MESH_TRANSMIT_COUNT(vnd_model->pub.transmit)) == NULL) {
-                                goto cleanup;
-                        }
-
-                        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_TX_INT,
-                                                BT_MESH_TRANSMIT_INT(vnd_model->pub.transmit)) == NULL) {
-                                goto cleanup;
-                        }
-                }
-        }
+static uint8_t count_node(struct bt_mesh_cdb_node *node, void *count)
+{
+        (*(size_t *)count)++;
+        return BT_MESH_CDB_ITER_CONTINUE;
+}
 
-        if (cJSON_AddNumberToObject(disc_obj, JSON_STR_MSG_ID, message_id++) == NULL) {
-                goto cleanup;
-        }
+static uint8_t find_node(struct bt_mesh_cdb_node *node, void *user_data)
+{
+        struct node_find *find;
 
-encode:
+        find = (struct node_find *)user_data;
 
-        if (!cJSON_PrintPreallocated(disc_obj, buf, buf_len, 0)) {
-                goto cleanup;
+        if (find->count++ == find->idx) {
+                find->node = node;
+                return BT_MESH_CDB_ITER_STOP;
         }
 
-        err = 0;
-
-cleanup:
-        cJSON_Delete(disc_obj);
-        return err;
+        return BT_MESH_CDB_ITER_CONTINUE;
 }
 
-static bool parse_cfg_op(cJSON *op_obj, enum btmesh_op *op)
+static int encode_node(size_t idx, cJSON **item, void *user_data)
 {
-        char *cfg_type_str;
+        char uuid_str[UUID_STR_LEN];
+        struct node_find find;
+        struct bt_mesh_cdb_node *node;
+        cJSON *node_obj;
 
-        codec_get_str(op_obj, "configuration", &cfg_type_str);
+        memset(&find, 0, sizeof(find));
+        find.idx = idx;
+        bt_mesh_cdb_node_foreach(find_node, &find);
+        node = find.node;
 
-        if (cfg_type_str == NULL) {
-                return false;
+        if (node == NULL) {
+                return -ENOENT;
         }
 
-        if (!strcmp(cfg_type_str, "networkBeaconSet")) {
-                *op = BTMESH_OP_BEACON_SET;
-        } else if (!strcmp(cfg_type_str, "timeToLiveSet")) {
-                *op = BTMESH_OP_TTL_SET;
-        } else if (!strcmp(cfg_type_str, "relayFeatureSet")) {
-                *op = BTMESH_OP_RELAY_SET;
-        } else if (!strcmp(cfg_type_str, "friendFeatureSet")) {
-                *op = BTMESH_OP_FRIEND_SET;
-        } else if (!strcmp(cfg_type_str, "proxyFeatureSet")) {
-                *op = BTMESH_OP_PROXY_SET;
-        } else if (!strcmp(cfg_type_str, "subnetAdd")) {
-                *op = BTMESH_OP_NET_KEY_ADD;
-        } else if (!strcmp(cfg_type_str, "subnetDelete")) {
-                *op = BTMESH_OP_NET_KEY_DEL;
-        } else if (!strcmp(cfg_type_str, "appKeyBind")) {
-                *op = BTMESH_OP_MOD_APP_BIND;
-        } else if (!strcmp(cfg_type_str, "appKeyBindVnd")) {
-                *op = BTMESH_OP_MOD_APP_BIND_VND;
-        } else if (!strcmp(cfg_type_str, "appKeyUnbind")) {
-                *op = BTMESH_OP_MOD_APP_UNBIND;
-        } else if (!strcmp(cfg_type_str, "appKeyUnbindVnd")) {
-                *op = BTMESH_OP_MOD_APP_UNBIND_VND;
-        } else if (!strcmp(cfg_type_str, "publishParametersSet")) {
-                *op = BTMESH_OP_MOD_PUB_SET;
-        } else if (!strcmp(cfg_type_str, "publishParametersSetVnd")) {
-                *op = BTMESH_OP_MOD_PUB_SET_VND;
-        } else if (!strcmp(cfg_type_str, "subscribeAddressAdd")) {
-                *op = BTMESH_OP_MOD_SUB_ADD;
-        } else if (!strcmp(cfg_type_str, "subscribeAddressAddVnd")) {
-                *op = BTMESH_OP_MOD_SUB_ADD_VND;
-        } else if (!strcmp(cfg_type_str, "subscribeAddressDelete")) {
-                *op = BTMESH_OP_MOD_SUB_DEL;
-        } else if (!strcmp(cfg_type_str, "subscribeAddressDeleteVnd")) {
-                *op = BTMESH_OP_MOD_SUB_DEL_VND;
-        } else if (!strcmp(cfg_type_str, "subscribeAddressOverwrite")) {
-                *op = BTMESH_OP_MOD_SUB_OVRW;
-        } else if (!strcmp(cfg_type_str, "subscribeAddressOverwriteVnd")) {
-                *op = BTMESH_OP_MOD_SUB_OVRW_VND;
-	} else if (!strcmp(cfg_type_str, "heartbeatSubscribeSet")) {
-		*op = BTMESH_OP_HB_SUB_SET;
-	} else if (!strcmp(cfg_type_str, "heartbeatPublishSet")) {
-		*op = BTMESH_OP_HB_PUB_SET;
-        } else {
-                LOG_ERR("UNRECOGNIZED CFG OP: %s", log_strdup(cfg_type_str));
-                return false;
-        }
-        
-	LOG_DBG("CFG OP: %d", *op);
-        return true;
-}
+        node_obj = cJSON_CreateObject();
+
+        if (node_obj == NULL) {
+                return -ENOMEM;
+        }
+
+        if (cJSON_AddStringToObject(node_obj, JSON_STR_DEVICE_TYPE, JSON_STR_BT_MESH) == NULL) {
+                goto error;
+        }
+
+        util_uuid2str(node->uuid, uuid_str);
+
+        if (cJSON_AddStringToObject(node_obj, JSON_STR_UUID, uuid_str) == NULL) {
+                goto error;
+        }
+
+        if (cJSON_AddNumberToObject(node_obj, JSON_STR_NET_IDX, node->net_idx) == NULL) {
+                goto error;
+        }
+
+        if (cJSON_AddNumberToObject(node_obj, JSON_STR_ADDR, node->addr) == NULL) {
+                goto error;
+        }
+
+        if (cJSON_AddNumberToObject(node_obj, JSON_STR_ELEM_COUNT, node->num_elem) == NULL) {
+                goto error;
+        }
+
+        *item = node_obj;
+        return 0;
+
+error:
+        cJSON_Delete(node_obj);
+        return -ENOMEM;
+}
+
+int codec_parse_node_disc(cJSON *op_obj, uint16_t *addr, bool *refresh)
+{
+	if (!codec_get_uint16(op_obj, JSON_STR_ADDR, addr)) {
+		return -EINVAL;
+	}
+
+	if (!codec_get_bool(op_obj, JSON_STR_REFRESH, refresh)) {
+		*refresh = false;
+	}
+	
+	return 0;
+}
+
+int codec_encode_node_list(char *buf, size_t buf_len, struct codec_page *page)
+{
+        int err;
+        size_t count;
+        cJSON *node_list_obj;
+        cJSON *event_obj;
+        cJSON *nodes_obj;
+
+        if (!codec_init_event(&node_list_obj, &event_obj, "node_list")) {
+                return -ENOMEM;
+        }
+
+        err = -ENOMEM;
+
+        nodes_obj = cJSON_AddArrayToObject(event_obj, "nodes");
+
+        if (nodes_obj == NULL) {
+                goto cleanup;
+        }
+
+        count = 0;
+        bt_mesh_cdb_node_foreach(count_node, &count);
+        page->total = count;
+
+        err = codec_encode_page(buf, buf_len, node_list_obj, event_obj, nodes_obj, page,
+                        encode_node, NULL);
+
+cleanup:
+        cJSON_Delete(node_list_obj);
+        return err;
+}
+
+static cJSON *codec_create_idx_array(const uint16_t *vals, size_t count)
+{
+        size_t i;
+        cJSON *array_obj;
+        cJSON *item;
+
+        array_obj = cJSON_CreateArray();
+
+        if (array_obj == NULL) {
+                return NULL;
+        }
+
+        for (i = 0; i < count; i++) {
+                item = cJSON_CreateNumber(vals[i]);
+
+                if (item == NULL) {
+                        cJSON_Delete(array_obj);
+                        return NULL;
+                }
+
+                cJSON_AddItemToArray(array_obj, item);
+        }
+
+        return array_obj;
+}
+
+/* Add the app key bindings, subscriptions and publish parameters shared by SIG and vendor
+ * models. */
+static bool encode_model_cfg(cJSON *model_obj, const uint16_t *appkey_idxs, size_t appkey_count,
+                const uint16_t *sub_addrs, size_t sub_addr_count,
+                const struct bt_mesh_cfg_mod_pub *pub)
+{
+        cJSON *array_obj;
+        cJSON *pub_obj;
+
+        array_obj = codec_create_idx_array(appkey_idxs, appkey_count);
+
+        if (array_obj == NULL) {
+                return false;
+        }
+
+        cJSON_AddItemToObject(model_obj, JSON_STR_APP_IDXS, array_obj);
+        array_obj = codec_create_idx_array(sub_addrs, sub_addr_count);
+
+        if (array_obj == NULL) {
+                return false;
+        }
+
+        cJSON_AddItemToObject(model_obj, JSON_STR_SUB_ADDRS, array_obj);
+        pub_obj = cJSON_AddObjectToObject(model_obj, JSON_STR_PUB_PARAMS);
+
+        if (pub_obj == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddNumberToObject(pub_obj, JSON_STR_ADDR, pub->addr) == NULL ||
+            cJSON_AddNumberToObject(pub_obj, JSON_STR_APP_IDX, pub->app_idx) == NULL ||
+            cJSON_AddBoolToObject(pub_obj, JSON_STR_FRIEND_CRED_FLAG, pub->cred_flag) == NULL ||
+            cJSON_AddNumberToObject(pub_obj, JSON_STR_TTL, pub->ttl) == NULL ||
+            cJSON_AddNumberToObject(pub_obj, JSON_STR_PERIOD,
+                    btmesh_get_pub_period(pub->period)) == NULL ||
+            cJSON_AddStringToObject(pub_obj, JSON_STR_PERIOD_UNITS,
+                    btmesh_get_pub_period_unit_str(pub->period)) == NULL ||
+            cJSON_AddNumberToObject(pub_obj, JSON_STR_TX_COUNT,
+                    BT_MESH_TRANSMIT_COUNT(pub->transmit)) == NULL ||
+            cJSON_AddNumberToObject(pub_obj, JSON_STR_TX_INT,
+                    BT_MESH_TRANSMIT_INT(pub->transmit)) == NULL) {
+                return false;
+        }
+
+        return true;
+}
+
+static int encode_elem(size_t idx, cJSON **item, void *user_data)
+{
+        size_t i;
+        struct btmesh_node *node;
+        struct btmesh_elem *elem;
+        struct btmesh_sig_model *sig_model;
+        struct btmesh_vnd_model *vnd_model;
+        cJSON *elem_obj;
+        cJSON *model_array_obj;
+        cJSON *model_obj;
+
+        node = (struct btmesh_node *)user_data;
+
+        if (idx >= node->elem_count) {
+                return -ENOENT;
+        }
+
+        elem = &node->elems[idx];
+        elem_obj = cJSON_CreateObject();
+
+        if (elem_obj == NULL) {
+                return -ENOMEM;
+        }
+
+        if (cJSON_AddNumberToObject(elem_obj, JSON_STR_ADDR, elem->addr) == NULL) {
+                goto error;
+        }
+
+        if (cJSON_AddNumberToObject(elem_obj, "loc", elem->loc) == NULL) {
+                goto error;
+        }
+
+        model_array_obj = cJSON_AddArrayToObject(elem_obj, "sigModels");
+
+        if (model_array_obj == NULL) {
+                goto error;
+        }
+
+        for (i = 0; i < elem->sig_model_count; i++) {
+                model_obj = cJSON_CreateObject();
+
+                if (model_obj == NULL) {
+                        goto error;
+                }
+
+                cJSON_AddItemToArray(model_array_obj, model_obj);
+                sig_model = &elem->sig_models[i];
+
+                if (cJSON_AddNumberToObject(model_obj, JSON_STR_MOD_ID, sig_model->model_id)
+                                == NULL) {
+                        goto error;
+                }
+
+                if (!encode_model_cfg(model_obj, sig_model->appkey_idxs, sig_model->appkey_count,
+                                        sig_model->sub_addrs, sig_model->sub_addr_count,
+                                        &sig_model->pub)) {
+                        goto error;
+                }
+        }
+
+        model_array_obj = cJSON_AddArrayToObject(elem_obj, "vendorModels");
+
+        if (model_array_obj == NULL) {
+                goto error;
+        }
+
+        for (i = 0; i < elem->vnd_model_count; i++) {
+                model_obj = cJSON_CreateObject();
+
+                if (model_obj == NULL) {
+                        goto error;
+                }
+
+                cJSON_AddItemToArray(model_array_obj, model_obj);
+                vnd_model = &elem->vnd_models[i];
+
+                if (cJSON_AddNumberToObject(model_obj, JSON_STR_CID, vnd_model->company_id)
+                                == NULL) {
+                        goto error;
+                }
+
+                if (cJSON_AddNumberToObject(model_obj, JSON_STR_MOD_ID, vnd_model->model_id)
+                                == NULL) {
+                        goto error;
+                }
+
+                if (!encode_model_cfg(model_obj, vnd_model->appkey_idxs, vnd_model->appkey_count,
+                                        vnd_model->sub_addrs, vnd_model->sub_addr_count,
+                                        &vnd_model->pub)) {
+                        goto error;
+                }
+        }
+
+        *item = elem_obj;
+        return 0;
+
+error:
+        cJSON_Delete(elem_obj);
+        return -ENOMEM;
+}
+
+static bool encode_hb_sub(cJSON *obj, const struct bt_mesh_cfg_hb_sub *sub)
+{
+	cJSON *hb_sub_obj;
+
+	hb_sub_obj = cJSON_AddObjectToObject(obj, JSON_STR_HB_SUB);
+
+	if (hb_sub_obj == NULL) {
+		return false;
+	}
+
+	if (cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_SRC_ADDR, sub->src) == NULL ||
+	    cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_DST_ADDR, sub->dst) == NULL ||
+	    cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_PERIOD, sub->period) == NULL ||
+	    cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_COUNT, sub->count) == NULL ||
+	    cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_MIN_HOPS, sub->min) == NULL ||
+	    cJSON_AddNumberToObject(hb_sub_obj, JSON_STR_MAX_HOPS, sub->max) == NULL) {
+		return false;
+	}
+
+	return true;
+}
+
+static bool encode_hb_pub(cJSON *obj, const struct bt_mesh_cfg_hb_pub *pub)
+{
+	cJSON *hb_pub_obj;
+
+	hb_pub_obj = cJSON_AddObjectToObject(obj, JSON_STR_HB_PUB);
+
+	if (hb_pub_obj == NULL) {
+		return false;
+	}
+
+	if (cJSON_AddNumberToObject(hb_pub_obj, JSON_STR_DST_ADDR, pub->dst) == NULL ||
+	    cJSON_AddNumberToObject(hb_pub_obj, JSON_STR_COUNT, pub->count) == NULL ||
+	    cJSON_AddNumberToObject(hb_pub_obj, JSON_STR_PERIOD, pub->period) == NULL ||
+	    cJSON_AddNumberToObject(hb_pub_obj, JSON_STR_TTL, pub->ttl) == NULL ||
+	    cJSON_AddBoolToObject(hb_pub_obj, JSON_STR_RELAY,
+		    pub->feat & BT_MESH_FEAT_RELAY) == NULL ||
+	    cJSON_AddBoolToObject(hb_pub_obj, JSON_STR_PROXY,
+		    pub->feat & BT_MESH_FEAT_PROXY) == NULL ||
+	    cJSON_AddBoolToObject(hb_pub_obj, JSON_STR_FRIEND,
+		    pub->feat & BT_MESH_FEAT_FRIEND) == NULL ||
+	    cJSON_AddBoolToObject(hb_pub_obj, JSON_STR_LPN,
+		    pub->feat & BT_MESH_FEAT_LOW_POWER) == NULL) {
+		return false;
+	}
+
+	return true;
+}
+
+static bool encode_node_details(cJSON *event_obj, struct btmesh_node *node)
+{
+        char uuid_str[UUID_STR_LEN];
+        cJSON *feature_obj;
+        cJSON *array_obj;
+
+        util_uuid2str(node->uuid, uuid_str);
+
+        if (cJSON_AddStringToObject(event_obj, JSON_STR_UUID, uuid_str) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, "cid", node->cid) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, "pid", node->pid) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, "vid", node->vid) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, "crpl", node->crpl) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_CFG_VERSION, node->cfg_version) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddBoolToObject(event_obj, JSON_STR_NET_BEACON, node->net_beacon_state) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_TTL, node->ttl) == NULL) {
+                return false;
+        }
+
+        feature_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_RELAY);
+
+        if (feature_obj == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_SUPPORT, node->relay.support) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_STATE, node->relay.state) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddNumberToObject(feature_obj, JSON_STR_TX_COUNT, node->relay.count) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddNumberToObject(feature_obj, JSON_STR_TX_INT, node->relay.interval) == NULL) {
+                return false;
+        }
+
+        feature_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_PROXY);
+
+        if (feature_obj == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_SUPPORT, node->proxy.support) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_STATE, node->proxy.state) == NULL) {
+                return false;
+        }
+
+        feature_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_FRIEND);
+
+        if (feature_obj == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_SUPPORT, node->friend.support) == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_STATE, node->friend.state) == NULL) {
+                return false;
+        }
+
+        feature_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_LPN);
+
+        if (feature_obj == NULL) {
+                return false;
+        }
+
+        if (cJSON_AddBoolToObject(feature_obj, JSON_STR_STATE, node->lpn) == NULL) {
+                return false;
+        }
+
+	if (!encode_hb_sub(event_obj, &node->hb_sub) || !encode_hb_pub(event_obj, &node->hb_pub)) {
+		return false;
+	}
+
+        array_obj = codec_create_idx_array(node->subnet_idxs, node->subnet_count);
+
+        if (array_obj == NULL) {
+                return false;
+        }
+
+        cJSON_AddItemToObject(event_obj, JSON_STR_SUBNETS, array_obj);
+        return true;
+}
+
+int codec_encode_node_disc(char *buf, size_t buf_len, struct btmesh_node *node, int disc_err,
+                uint8_t status, struct codec_page *page)
+{
+        int err;
+        cJSON *disc_obj;
+        cJSON *event_obj;
+        cJSON *elem_array_obj;
+
+        if (!codec_init_event(&disc_obj, &event_obj, "node_discover_result")) {
+                return -ENOMEM;
+        }
+
+        err = -ENOMEM;
+
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_ERR, disc_err) == NULL) {
+                goto cleanup;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, "status", status) == NULL) {
+                goto cleanup;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, node->addr) == NULL) {
+                goto cleanup;
+        }
+        
+	if (disc_err || status) {
+                /* If there was an error or status performing the discovery, then all other items
+                 * are irrelevant so encode the JSON as it is */
+                page->more = false;
+
+                if (!codec_print(disc_obj, buf, buf_len)) {
+                        goto cleanup;
+                }
+
+                err = 0;
+                goto cleanup;
+        }
+
+        /* Node level details are only sent with the first page, later pages only carry
+         * elements */
+        if (page->cursor == 0 && !encode_node_details(event_obj, node)) {
+                goto cleanup;
+        }
+
+        elem_array_obj = cJSON_AddArrayToObject(event_obj, "elements");
+
+        if (elem_array_obj == NULL) {
+                goto cleanup;
+        }
+
+        page->total = node->elem_count;
+        err = codec_encode_page(buf, buf_len, disc_obj, event_obj, elem_array_obj, page,
+                        encode_elem, node);
+
+cleanup:
+        cJSON_Delete(disc_obj);
+        return err;
+}
+
+static bool parse_pub_period(const char *units, uint8_t period, uint8_t *pub_period)
+{
+	if (!strcmp(units, "100ms")) {
+		*pub_period = BT_MESH_PUB_PERIOD_100MS(period);
+	} else if (!strcmp(units, "1s")) {
+		*pub_period = BT_MESH_PUB_PERIOD_SEC(period);
+	} else if (!strcmp(units, "10s")) {
+		*pub_period = BT_MESH_PUB_PERIOD_10SEC(period);
+	} else if (!strcmp(units, "10m")) {
+		*pub_period = BT_MESH_PUB_PERIOD_10MIN(period);
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+/* "configuration" names of the node_configure operations */
+static const struct {
+        const char *name;
+        enum btmesh_op op;
+} cfg_ops[] = {
+        { "networkBeaconSet", BTMESH_OP_BEACON_SET },
+        { "timeToLiveSet", BTMESH_OP_TTL_SET },
+        { "relayFeatureSet", BTMESH_OP_RELAY_SET },
+        { "friendFeatureSet", BTMESH_OP_FRIEND_SET },
+        { "proxyFeatureSet", BTMESH_OP_PROXY_SET },
+        { "subnetAdd", BTMESH_OP_NET_KEY_ADD },
+        { "subnetDelete", BTMESH_OP_NET_KEY_DEL },
+        { "appKeyBind", BTMESH_OP_MOD_APP_BIND },
+        { "appKeyBindVnd", BTMESH_OP_MOD_APP_BIND_VND },
+        { "appKeyUnbind", BTMESH_OP_MOD_APP_UNBIND },
+        { "appKeyUnbindVnd", BTMESH_OP_MOD_APP_UNBIND_VND },
+        { "publishParametersSet", BTMESH_OP_MOD_PUB_SET },
+        { "publishParametersSetVnd", BTMESH_OP_MOD_PUB_SET_VND },
+        { "subscribeAddressAdd", BTMESH_OP_MOD_SUB_ADD },
+        { "subscribeAddressAddVnd", BTMESH_OP_MOD_SUB_ADD_VND },
+        { "subscribeAddressDelete", BTMESH_OP_MOD_SUB_DEL },
+        { "subscribeAddressDeleteVnd", BTMESH_OP_MOD_SUB_DEL_VND },
+        { "subscribeAddressOverwrite", BTMESH_OP_MOD_SUB_OVRW },
+        { "subscribeAddressOverwriteVnd", BTMESH_OP_MOD_SUB_OVRW_VND },
+        { "heartbeatSubscribeSet", BTMESH_OP_HB_SUB_SET },
+        { "heartbeatPublishSet", BTMESH_OP_HB_PUB_SET },
+};
+
+static const char *cfg_op_name(enum btmesh_op op)
+{
+        size_t i;
+
+        for (i = 0; i < ARRAY_SIZE(cfg_ops); i++) {
+                if (cfg_ops[i].op == op) {
+                        return cfg_ops[i].name;
+                }
+        }
+
+        return NULL;
+}
+
+static bool parse_cfg_op(cJSON *op_obj, enum btmesh_op *op)
+{
+        size_t i;
+        char *cfg_type_str;
+
+        if (!codec_get_str(op_obj, JSON_STR_CFG, &cfg_type_str)) {
+                return false;
+        }
+
+        for (i = 0; i < ARRAY_SIZE(cfg_ops); i++) {
+                if (!strcmp(cfg_type_str, cfg_ops[i].name)) {
+                        *op = cfg_ops[i].op;
+                        LOG_DBG("CFG OP: %d", *op);
+                        return true;
+                }
+        }
+
+        LOG_ERR("UNRECOGNIZED CFG OP: %s", log_strdup(cfg_type_str));
+        return false;
+}
 
 static int parse_cfg_args(cJSON *op_obj, enum btmesh_op op, union btmesh_op_args *args)
 {
-        switch (op) {
-	case BTMESH_OP_BEACON_SET:
-		args->beacon_set.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->beacon_set.addr)) ||
-		    !codec_get_bool(op_obj, JSON_STR_STATE, (bool*)&(args->beacon_set.val))) {
-			return -EINVAL;
-		}
-		break;
+        switch (op) {
+	case BTMESH_OP_BEACON_SET:
+		args->beacon_set.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->beacon_set.addr)) ||
+		    !codec_get_bool(op_obj, JSON_STR_STATE, (bool*)&(args->beacon_set.val))) {
+			return -EINVAL;
+		}
+		break;
+
+	case BTMESH_OP_TTL_SET:
+		args->ttl_set.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->ttl_set.addr)) ||
+		    !codec_get_uint8(op_obj, JSON_STR_TTL, &(args->ttl_set.val))) {
+			return -EINVAL;
+		}
+		break;
+
+	case BTMESH_OP_RELAY_SET:
+	{
+		uint8_t count;
+		uint16_t interval;
+
+		args->relay_set.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->relay_set.addr)) ||
+		    !codec_get_bool(op_obj, JSON_STR_STATE, (bool*)&(args->relay_set.new_relay)) ||
+		    !codec_get_uint8(op_obj, JSON_STR_TX_COUNT, &count) ||
+		    !codec_get_uint16(op_obj, JSON_STR_TX_INT, &interval)) {
+			return -EINVAL;
+		}
+		args->relay_set.new_transmit = BT_MESH_TRANSMIT(count, interval);
+		break;
+	}
+
+	case BTMESH_OP_FRIEND_SET:
+		args->friend_set.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->friend_set.addr)) ||
+		    !codec_get_bool(op_obj, JSON_STR_STATE, (bool*)&(args->friend_set.val))) {
+			return -EINVAL;
+		}
+		break;
+
+	case BTMESH_OP_PROXY_SET:
+		args->proxy_set.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->proxy_set.addr)) ||
+		    !codec_get_bool(op_obj, JSON_STR_STATE, (bool*)&(args->proxy_set.val))) {
+			return -EINVAL;
+		}
+		break;
+
+	case BTMESH_OP_NET_KEY_ADD:
+	{
+		uint16_t key_net_idx;
+		struct bt_mesh_cdb_subnet *subnet;
+
+		args->net_key_add.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->net_key_add.addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_NET_IDX, &key_net_idx)) {
+			return -EINVAL;
+		}
+		subnet = bt_mesh_cdb_subnet_get(key_net_idx);
+		if (subnet == NULL) {
+			return -ENOEXEC;
+		}
+		args->net_key_add.key_net_idx = key_net_idx;
+		memcpy(args->net_key_add.net_key, subnet->keys[0].net_key, KEY_LEN);
+		break;
+	}
+
+	case BTMESH_OP_NET_KEY_DEL:
+		args->net_key_del.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->net_key_del.addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_NET_IDX, &(args->net_key_del.key_net_idx))) {
+			return -EINVAL;
+		}
+		break;
+
+	case BTMESH_OP_MOD_APP_BIND:
+	case BTMESH_OP_MOD_APP_BIND_VND:
+		args->mod_app_bind.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->mod_app_bind.addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR, &(args->mod_app_bind.elem_addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &(args->mod_app_bind.mod_id)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_APP_IDX,
+			    &(args->mod_app_bind.mod_app_idx))) {
+			return -EINVAL;
+		}
+		if (op == BTMESH_OP_MOD_APP_BIND_VND) {
+			if (!codec_get_uint16(op_obj, JSON_STR_CID, &(args->mod_app_bind_vnd.cid))) {
+				return -EINVAL;
+			}
+		}
+
+		/* The key itself is added to the node by btmesh_perform_cfg_op() */
+		if (bt_mesh_cdb_app_key_get(args->mod_app_bind.mod_app_idx) == NULL) {
+			return -ENOEXEC;
+		}
+		break;
+
+	case BTMESH_OP_MOD_APP_UNBIND:
+	case BTMESH_OP_MOD_APP_UNBIND_VND:
+		args->mod_app_unbind.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->mod_app_unbind.addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR,
+			    &(args->mod_app_unbind.elem_addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &(args->mod_app_unbind.mod_id)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_APP_IDX,
+			    &(args->mod_app_unbind.mod_app_idx))) {
+			return -EINVAL;
+		}
+		if (op == BTMESH_OP_MOD_APP_UNBIND_VND) {
+			if (!codec_get_uint16(op_obj, JSON_STR_CID,
+						&(args->mod_app_unbind_vnd.cid))) {
+				return -EINVAL;
+			}
+		}
+		break;
+
+	case BTMESH_OP_MOD_PUB_SET:
+	case BTMESH_OP_MOD_PUB_SET_VND:
+	{
+		char *units;
+		uint8_t period;
+		uint8_t count;
+		uint16_t interval;
+		args->mod_pub_set.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->mod_pub_set.addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR, &(args->mod_pub_set.elem_addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &(args->mod_pub_set.mod_id)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_PUB_ADDR, &(args->mod_pub_set.pub.addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_APP_IDX, &(args->mod_pub_set.pub.app_idx)) ||
+		    !codec_get_bool(op_obj, JSON_STR_FRIEND_CRED_FLAG,
+			    &(args->mod_pub_set.pub.cred_flag)) ||
+		    !codec_get_uint8(op_obj, JSON_STR_TTL, &(args->mod_pub_set.pub.ttl)) ||
+		    !codec_get_uint8(op_obj, JSON_STR_PERIOD, &period) ||
+		    !codec_get_str(op_obj, JSON_STR_PERIOD_UNITS, &units) ||
+		    !codec_get_uint8(op_obj, JSON_STR_TX_COUNT, &count) ||
+		    !codec_get_uint16(op_obj, JSON_STR_TX_INT, &interval)) {
+			return -EINVAL;
+		}
+
+		if (op == BTMESH_OP_MOD_PUB_SET_VND) {
+			if (!codec_get_uint16(op_obj, JSON_STR_CID, &(args->mod_pub_set_vnd.cid))) {
+				return -EINVAL;
+			}
+		}
+
+		if (!parse_pub_period(units, period, &(args->mod_pub_set.pub.period))) {
+			return -EINVAL;
+		}
+
+		args->mod_pub_set.pub.transmit = BT_MESH_TRANSMIT(count, interval);
+
+		break;
+	}
+
+	case BTMESH_OP_MOD_SUB_ADD:
+	case BTMESH_OP_MOD_SUB_ADD_VND:
+		args->mod_sub_add.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->mod_sub_add.addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR, &(args->mod_sub_add.elem_addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &(args->mod_sub_add.mod_id)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_SUB_ADDR, &(args->mod_sub_add.sub_addr))) {
+		       return -ENOEXEC;
+		}	       
+		if (op == BTMESH_OP_MOD_SUB_ADD_VND) {
+			if (!codec_get_uint16(op_obj, JSON_STR_CID, &(args->mod_sub_add_vnd.cid))) {
+				return -ENOEXEC;
+			}
+		}
+		break;
+
+	case BTMESH_OP_MOD_SUB_DEL:
+	case BTMESH_OP_MOD_SUB_DEL_VND:
+		args->mod_sub_del.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->mod_sub_del.addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR, &(args->mod_sub_del.elem_addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &(args->mod_sub_del.mod_id)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_SUB_ADDR, &(args->mod_sub_del.sub_addr))) {
+			return -EINVAL;
+		}
+		if (op == BTMESH_OP_MOD_SUB_DEL_VND) {
+			if (!codec_get_uint16(op_obj, JSON_STR_CID, &(args->mod_sub_del_vnd.cid))) {
+				return -EINVAL;
+			}
+		}
+		break;
+
+	case BTMESH_OP_MOD_SUB_OVRW:
+	case BTMESH_OP_MOD_SUB_OVRW_VND:
+		args->mod_sub_ovrw.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->mod_sub_ovrw.addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR, &(args->mod_sub_ovrw.elem_addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &(args->mod_sub_ovrw.mod_id)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_SUB_ADDR, &(args->mod_sub_ovrw.sub_addr))) {
+			return -EINVAL;
+		}
+		if (op == BTMESH_OP_MOD_SUB_OVRW_VND) {
+			if (!codec_get_uint16(op_obj, JSON_STR_CID, &(args->mod_sub_ovrw_vnd.cid))) {
+				return -EINVAL;
+			}
+		}
+		break;
+
+	case BTMESH_OP_HB_SUB_SET:
+		args->hb_sub_set.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->hb_sub_set.addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_SRC_ADDR, &(args->hb_sub_set.sub.src)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_DST_ADDR, &(args->hb_sub_set.sub.dst)) ||
+		    !codec_get_uint8(op_obj, JSON_STR_PERIOD, &(args->hb_sub_set.sub.period)) ||
+		    !codec_get_uint8(op_obj, JSON_STR_COUNT, &(args->hb_sub_set.sub.count)) ||
+		    !codec_get_uint8(op_obj, JSON_STR_MIN_HOPS, &(args->hb_sub_set.sub.min)) ||
+		    !codec_get_uint8(op_obj, JSON_STR_MAX_HOPS, &(args->hb_sub_set.sub.max))) {
+			return -EINVAL;
+		}
+		break;
+
+	case BTMESH_OP_HB_PUB_SET:
+	{
+		bool relay;
+		bool proxy;
+		bool friend;
+		bool lpn;
+
+		args->hb_pub_set.net_idx = PRIMARY_SUBNET;
+		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->hb_pub_set.addr)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_NET_IDX, &(args->hb_pub_set.pub.net_idx)) ||
+		    !codec_get_uint16(op_obj, JSON_STR_DST_ADDR, &(args->hb_pub_set.pub.dst)) ||
+		    !codec_get_uint8(op_obj, JSON_STR_COUNT, &(args->hb_pub_set.pub.count)) ||
+		    !codec_get_uint8(op_obj, JSON_STR_PERIOD, &(args->hb_pub_set.pub.period)) ||
+		    !codec_get_uint8(op_obj, JSON_STR_TTL, &(args->hb_pub_set.pub.ttl)) ||
+		    !codec_get_bool(op_obj, JSON_STR_RELAY, &relay) ||
+		    !codec_get_bool(op_obj, JSON_STR_PROXY, &proxy) ||
+		    !codec_get_bool(op_obj, JSON_STR_FRIEND, &friend) ||
+		    !codec_get_bool(op_obj, JSON_STR_LPN, &lpn)) {
+			return -EINVAL;
+		}
+
+		args->hb_pub_set.pub.feat =
+			(relay ? BT_MESH_FEAT_RELAY : 0) |
+			(proxy ? BT_MESH_FEAT_PROXY : 0) |
+			(friend ? BT_MESH_FEAT_FRIEND : 0) |
+			(lpn ? BT_MESH_FEAT_LOW_POWER : 0);
+		break;
+	}
+	default:
+		LOG_ERR("Unsupported configuration operation");
+		return false;
+        }
+
+        return 0;
+}
+
+int codec_parse_node_cfg(cJSON *op_obj, uint16_t *addr, enum btmesh_op *op,
+                union btmesh_op_args *args)
+{
+	if (!codec_get_uint16(op_obj, JSON_STR_ADDR, addr)) {
+		return -EINVAL;
+	}
+
+        if (!parse_cfg_op(op_obj, op)) {
+                return -EINVAL;
+        }
+
+	return parse_cfg_args(op_obj, *op, args);
+}
+
+static int parse_txn_op(cJSON *op_obj, uint16_t addr, struct cfg_txn_op *op)
+{
+	int err;
+
+	/* Steps configure the node of the transaction and may leave the address out */
+	if (!cJSON_HasObjectItem(op_obj, JSON_STR_ADDR) &&
+	    cJSON_AddNumberToObject(op_obj, JSON_STR_ADDR, addr) == NULL) {
+		return -ENOMEM;
+	}
+
+	if (!parse_cfg_op(op_obj, &op->op)) {
+		return -EINVAL;
+	}
+
+	err = parse_cfg_args(op_obj, op->op, &op->args);
+
+	if (err) {
+		return err;
+	}
+
+	/* Every configuration operation starts with net_idx, addr */
+	if (op->args.node_reset.addr != addr) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int parse_txn_steps(cJSON *steps_obj, struct cfg_txn *txn)
+{
+	int i;
+	int err;
+	int count;
+	cJSON *step_obj;
+	cJSON *rollback_obj;
+	struct cfg_txn_step *step;
+
+	txn->steps = NULL;
+	txn->step_count = 0;
+
+	if (!cJSON_IsArray(steps_obj)) {
+		return -EINVAL;
+	}
+
+	count = cJSON_GetArraySize(steps_obj);
+
+	if (count == 0 || count > CONFIG_GATEWAY_CFG_TXN_MAX_STEPS) {
+		return -EINVAL;
+	}
+
+	txn->steps = k_calloc(count, sizeof(*txn->steps));
+
+	if (txn->steps == NULL) {
+		return -ENOMEM;
+	}
+
+	txn->step_count = count;
+
+	for (i = 0; i < count; i++) {
+		step = &txn->steps[i];
+		step_obj = cJSON_GetArrayItem(steps_obj, i);
+		err = parse_txn_op(step_obj, txn->addr, &step->op);
+
+		if (err) {
+			goto error;
+		}
+
+		rollback_obj = cJSON_GetObjectItem(step_obj, JSON_STR_ROLLBACK);
+
+		if (rollback_obj == NULL) {
+			continue;
+		}
+
+		err = parse_txn_op(rollback_obj, txn->addr, &step->rollback);
+
+		if (err) {
+			goto error;
+		}
+
+		step->has_rollback = true;
+	}
+
+	return 0;
+
+error:
+	LOG_ERR("Invalid transaction step %d", i);
+	k_free(txn->steps);
+	txn->steps = NULL;
+	txn->step_count = 0;
+	return err;
+}
+
+int codec_parse_node_cfg_txn(cJSON *op_obj, struct cfg_txn *txn)
+{
+	if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &txn->addr)) {
+		return -EINVAL;
+	}
+
+	return parse_txn_steps(cJSON_GetObjectItem(op_obj, JSON_STR_STEPS), txn);
+}
+
+/* The state a node reports back for a configuration operation */
+static bool encode_cfg_state(cJSON *event_obj, enum btmesh_op op,
+                const union btmesh_op_args *args)
+{
+        cJSON *feature_obj;
+
+        switch (op) {
+        case BTMESH_OP_BEACON_SET:
+                return cJSON_AddBoolToObject(event_obj, JSON_STR_NET_BEACON,
+                                args->beacon_set.status == BT_MESH_BEACON_ENABLED) != NULL;
+
+        case BTMESH_OP_TTL_SET:
+                return cJSON_AddNumberToObject(event_obj, JSON_STR_TTL, args->ttl_set.ttl) != NULL;
+
+        case BTMESH_OP_RELAY_SET:
+                feature_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_RELAY);
+
+                return feature_obj != NULL &&
+                        cJSON_AddBoolToObject(feature_obj, JSON_STR_STATE,
+                                args->relay_set.status == BT_MESH_RELAY_ENABLED) != NULL &&
+                        cJSON_AddNumberToObject(feature_obj, JSON_STR_TX_COUNT,
+                                BT_MESH_TRANSMIT_COUNT(args->relay_set.transmit)) != NULL &&
+                        cJSON_AddNumberToObject(feature_obj, JSON_STR_TX_INT,
+                                BT_MESH_TRANSMIT_INT(args->relay_set.transmit)) != NULL;
+
+        case BTMESH_OP_PROXY_SET:
+                feature_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_PROXY);
+
+                return feature_obj != NULL &&
+                        cJSON_AddBoolToObject(feature_obj, JSON_STR_STATE,
+                                args->proxy_set.status == BT_MESH_GATT_PROXY_ENABLED) != NULL;
+
+        case BTMESH_OP_FRIEND_SET:
+                feature_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_FRIEND);
+
+                return feature_obj != NULL &&
+                        cJSON_AddBoolToObject(feature_obj, JSON_STR_STATE,
+                                args->friend_set.status == BT_MESH_FRIEND_ENABLED) != NULL;
+
+        case BTMESH_OP_NET_KEY_ADD:
+                return cJSON_AddNumberToObject(event_obj, JSON_STR_NET_IDX,
+                                args->net_key_add.key_net_idx) != NULL;
+
+        case BTMESH_OP_NET_KEY_DEL:
+                return cJSON_AddNumberToObject(event_obj, JSON_STR_NET_IDX,
+                                args->net_key_del.key_net_idx) != NULL;
+
+        case BTMESH_OP_HB_SUB_SET:
+                return encode_hb_sub(event_obj, &args->hb_sub_set.sub);
+
+        case BTMESH_OP_HB_PUB_SET:
+                return encode_hb_pub(event_obj, &args->hb_pub_set.pub);
+
+        default:
+                /* Model operations report the model state instead */
+                return true;
+        }
+}
+
+int codec_encode_node_cfg(char *buf, size_t buf_len, uint16_t addr, enum btmesh_op op,
+                const union btmesh_op_args *args, int op_err, uint32_t cfg_version,
+                const struct btmesh_model_state *model)
+{
+        int err;
+        uint8_t status;
+        cJSON *cfg_obj;
+        cJSON *event_obj;
+        cJSON *model_obj;
+
+        if (!codec_init_event(&cfg_obj, &event_obj, "node_configure_result")) {
+                return -ENOMEM;
+        }
+
+        err = -ENOMEM;
+        status = op_err ? 0 : btmesh_get_op_status(op, args);
+
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_ERR, op_err) == NULL ||
+            cJSON_AddNumberToObject(event_obj, JSON_STR_STATUS, status) == NULL ||
+            cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, addr) == NULL ||
+            cJSON_AddStringToObject(event_obj, JSON_STR_CFG, cfg_op_name(op)) == NULL ||
+            cJSON_AddNumberToObject(event_obj, JSON_STR_CFG_VERSION, cfg_version) == NULL) {
+                goto cleanup;
+        }
+
+        if (!op_err && !status && !encode_cfg_state(event_obj, op, args)) {
+                goto cleanup;
+        }
+
+        if (model != NULL) {
+                model_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_MODEL);
+
+                if (model_obj == NULL) {
+                        goto cleanup;
+                }
+
+                if (cJSON_AddNumberToObject(model_obj, JSON_STR_ELEM_ADDR, model->elem_addr)
+                                == NULL ||
+                    cJSON_AddNumberToObject(model_obj, JSON_STR_MOD_ID, model->model_id) == NULL) {
+                        goto cleanup;
+                }
+
+                if (model->company_id != BT_MESH_CID_NVAL &&
+                    cJSON_AddNumberToObject(model_obj, JSON_STR_CID, model->company_id) == NULL) {
+                        goto cleanup;
+                }
+
+                if (!encode_model_cfg(model_obj, model->appkey_idxs, model->appkey_count,
+                                        model->sub_addrs, model->sub_addr_count, &model->pub)) {
+                        goto cleanup;
+                }
+        }
+
+        if (!codec_print(cfg_obj, buf, buf_len)) {
+                goto cleanup;
+        }
+
+        err = 0;
+
+cleanup:
+        cJSON_Delete(cfg_obj);
+        return err;
+}
+
+static bool encode_txn_op(cJSON *op_obj, const struct cfg_txn_op *op)
+{
+	uint8_t status;
+
+	status = op->err ? 0 : btmesh_get_op_status(op->op, &op->args);
+
+	if (cJSON_AddStringToObject(op_obj, JSON_STR_CFG, cfg_op_name(op->op)) == NULL ||
+	    cJSON_AddNumberToObject(op_obj, JSON_STR_ERR, op->err) == NULL ||
+	    cJSON_AddNumberToObject(op_obj, JSON_STR_STATUS, status) == NULL) {
+		return false;
+	}
+
+	return op->err || status || encode_cfg_state(op_obj, op->op, &op->args);
+}
+
+static bool encode_txn_step(cJSON *steps_obj, const struct cfg_txn_step *step)
+{
+	cJSON *step_obj;
+	cJSON *rollback_obj;
+
+	step_obj = cJSON_CreateObject();
+
+	if (step_obj == NULL) {
+		return false;
+	}
+
+	cJSON_AddItemToArray(steps_obj, step_obj);
+
+	if (cJSON_AddStringToObject(step_obj, JSON_STR_STATE,
+				cfg_txn_step_state_str(step->state)) == NULL) {
+		return false;
+	}
+
+	if (step->state == CFG_TXN_STEP_PENDING) {
+		return cJSON_AddStringToObject(step_obj, JSON_STR_CFG,
+				cfg_op_name(step->op.op)) != NULL;
+	}
+
+	if (!encode_txn_op(step_obj, &step->op)) {
+		return false;
+	}
+
+	if (step->state != CFG_TXN_STEP_ROLLED_BACK &&
+	    step->state != CFG_TXN_STEP_ROLLBACK_FAILED) {
+		return true;
+	}
+
+	rollback_obj = cJSON_AddObjectToObject(step_obj, JSON_STR_ROLLBACK);
+
+	return rollback_obj != NULL && encode_txn_op(rollback_obj, &step->rollback);
+}
+
+int codec_encode_node_cfg_txn(char *buf, size_t buf_len, const struct cfg_txn *txn,
+		int txn_err, uint32_t cfg_version)
+{
+	int err;
+	size_t i;
+	cJSON *txn_obj;
+	cJSON *event_obj;
+	cJSON *steps_obj;
+
+	if (!codec_init_event(&txn_obj, &event_obj, "node_configure_transaction_result")) {
+		return -ENOMEM;
+	}
+
+	err = -ENOMEM;
+
+	if (cJSON_AddNumberToObject(event_obj, JSON_STR_ERR, txn_err) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, txn->addr) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_CFG_VERSION, cfg_version) == NULL) {
+		goto cleanup;
+	}
+
+	if (txn->failed_step < txn->step_count &&
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_FAILED_STEP, txn->failed_step) == NULL) {
+		goto cleanup;
+	}
+
+	steps_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_STEPS);
+
+	if (steps_obj == NULL) {
+		goto cleanup;
+	}
+
+	for (i = 0; i < txn->step_count; i++) {
+		if (!encode_txn_step(steps_obj, &txn->steps[i])) {
+			goto cleanup;
+		}
+	}
+
+	if (!codec_print(txn_obj, buf, buf_len)) {
+		goto cleanup;
+	}
+
+	err = 0;
+
+cleanup:
+	cJSON_Delete(txn_obj);
+	return err;
+}
+
+#if defined(CONFIG_GATEWAY_PROV_PROFILE)
+/* Profile steps address elements by their index, as the address of the node is not known
+ * until it is provisioned */
+static int profile_elem_addr(cJSON *op_obj, uint16_t addr)
+{
+	uint8_t elem_idx;
+
+	if (cJSON_HasObjectItem(op_obj, JSON_STR_ELEM_ADDR)) {
+		return -EINVAL;
+	}
+
+	elem_idx = 0;
+	codec_get_uint8(op_obj, JSON_STR_ELEM_IDX, &elem_idx);
+
+	if (cJSON_AddNumberToObject(op_obj, JSON_STR_ELEM_ADDR, addr + elem_idx) == NULL) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+int codec_parse_prov_profile_steps(const char *steps, uint16_t addr, struct cfg_txn *txn)
+{
+	int i;
+	int err;
+	cJSON *steps_obj;
+	cJSON *step_obj;
+	cJSON *rollback_obj;
+
+	txn->addr = addr;
+	txn->steps = NULL;
+	txn->step_count = 0;
+	steps_obj = cJSON_Parse(steps);
+
+	if (steps_obj == NULL) {
+		return -EINVAL;
+	}
+
+	err = 0;
+
+	for (i = 0; !err && i < cJSON_GetArraySize(steps_obj); i++) {
+		step_obj = cJSON_GetArrayItem(steps_obj, i);
+		rollback_obj = cJSON_GetObjectItem(step_obj, JSON_STR_ROLLBACK);
+		err = profile_elem_addr(step_obj, addr);
+
+		if (!err && rollback_obj != NULL) {
+			err = profile_elem_addr(rollback_obj, addr);
+		}
+	}
+
+	if (!err) {
+		err = parse_txn_steps(steps_obj, txn);
+	}
+
+	cJSON_Delete(steps_obj);
+	return err;
+}
+
+static int parse_profile_match(cJSON *match_obj, struct prov_profile_match *match)
+{
+	int len;
+	char *uuid_prefix;
+
+	memset(match, 0, sizeof(*match));
+
+	if (match_obj == NULL) {
+		return 0;
+	}
+
+	if (codec_get_str(match_obj, JSON_STR_UUID_PREFIX, &uuid_prefix)) {
+		len = util_hex2bin(uuid_prefix, strlen(uuid_prefix), match->uuid_prefix,
+				sizeof(match->uuid_prefix));
+
+		if (len < 0) {
+			return len;
+		}
+
+		match->uuid_prefix_len = len;
+	}
+
+	match->cid_set = codec_get_uint16(match_obj, JSON_STR_CID, &match->cid);
+	match->pid_set = codec_get_uint16(match_obj, JSON_STR_PID, &match->pid);
+
+	return 0;
+}
+
+int codec_parse_prov_profile(cJSON *op_obj, struct prov_profile_info *info, char **steps)
+{
+	int err;
+	char *name;
+	cJSON *steps_obj;
+	struct cfg_txn txn;
+
+	if (!codec_get_str(op_obj, JSON_STR_NAME, &name) || name[0] == '\0' ||
+	    strlen(name) > PROV_PROFILE_NAME_LEN) {
+		return -EINVAL;
+	}
+
+	strcpy(info->name, name);
+	err = parse_profile_match(cJSON_GetObjectItem(op_obj, JSON_STR_MATCH), &info->match);
+
+	if (err) {
+		return err;
+	}
+
+	steps_obj = cJSON_GetObjectItem(op_obj, JSON_STR_STEPS);
+
+	if (!cJSON_IsArray(steps_obj)) {
+		return -EINVAL;
+	}
+
+	*steps = cJSON_PrintUnformatted(steps_obj);
+
+	if (*steps == NULL) {
+		return -ENOMEM;
+	}
+
+	/* Reject a profile that could never be applied. Any unicast address will do here. */
+	err = codec_parse_prov_profile_steps(*steps, 0x0001, &txn);
+	k_free(txn.steps);
+
+	if (err) {
+		cJSON_free(*steps);
+		*steps = NULL;
+	}
+
+	return err;
+}
+
+int codec_parse_prov_profile_name(cJSON *op_obj, char **name)
+{
+	if (!codec_get_str(op_obj, JSON_STR_NAME, name)) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static bool encode_profile_match(cJSON *profile_obj, const struct prov_profile_match *match)
+{
+	cJSON *match_obj;
+	char uuid_prefix[UUID_STR_LEN];
+
+	match_obj = cJSON_AddObjectToObject(profile_obj, JSON_STR_MATCH);
+
+	if (match_obj == NULL) {
+		return false;
+	}
+
+	if (match->uuid_prefix_len) {
+		util_bin2hex(match->uuid_prefix, match->uuid_prefix_len, uuid_prefix,
+				sizeof(uuid_prefix));
+
+		if (cJSON_AddStringToObject(match_obj, JSON_STR_UUID_PREFIX, uuid_prefix) == NULL) {
+			return false;
+		}
+	}
+
+	if (match->cid_set && cJSON_AddNumberToObject(match_obj, JSON_STR_CID, match->cid) == NULL) {
+		return false;
+	}
+
+	return !match->pid_set || cJSON_AddNumberToObject(match_obj, JSON_STR_PID, match->pid) != NULL;
+}
+
+int codec_encode_prov_profile_list(char *buf, size_t buf_len)
+{
+	int err;
+	int ret;
+	size_t i;
+	cJSON *list_obj;
+	cJSON *event_obj;
+	cJSON *profiles_obj;
+	cJSON *profile_obj;
+	struct prov_profile_info info;
+
+	if (!codec_init_event(&list_obj, &event_obj, "provision_profile_list")) {
+		return -ENOMEM;
+	}
+
+	err = -ENOMEM;
+	profiles_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_PROFILES);
+
+	if (profiles_obj == NULL) {
+		goto cleanup;
+	}
+
+	for (i = 0; (ret = prov_profile_get(i, &info)) != -EINVAL; i++) {
+		/* Unused slot */
+		if (ret) {
+			continue;
+		}
+
+		profile_obj = cJSON_CreateObject();
+
+		if (profile_obj == NULL) {
+			goto cleanup;
+		}
+
+		cJSON_AddItemToArray(profiles_obj, profile_obj);
+
+		if (cJSON_AddStringToObject(profile_obj, JSON_STR_NAME, info.name) == NULL ||
+		    !encode_profile_match(profile_obj, &info.match)) {
+			goto cleanup;
+		}
+	}
+
+	if (!codec_print(list_obj, buf, buf_len)) {
+		goto cleanup;
+	}
+
+	err = 0;
+
+cleanup:
+	cJSON_Delete(list_obj);
+	return err;
+}
+
+int codec_encode_node_ready(char *buf, size_t buf_len, const uint8_t uuid[UUID_LEN],
+		uint16_t net_idx, uint16_t addr, uint8_t num_elem, const char *profile,
+		const struct cfg_txn *txn, int txn_err, uint32_t cfg_version)
+{
+	int err;
+	size_t i;
+	char uuid_str[UUID_STR_LEN];
+	cJSON *ready_obj;
+	cJSON *event_obj;
+	cJSON *steps_obj;
+
+	if (!codec_init_event(&ready_obj, &event_obj, "node_ready")) {
+		return -ENOMEM;
+	}
+
+	err = -ENOMEM;
+	util_uuid2str(uuid, uuid_str);
+
+	if (cJSON_AddStringToObject(event_obj, JSON_STR_UUID, uuid_str) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_NET_IDX, net_idx) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, addr) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_ELEM_COUNT, num_elem) == NULL ||
+	    cJSON_AddStringToObject(event_obj, JSON_STR_PROFILE, profile) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_ERR, txn_err) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_CFG_VERSION, cfg_version) == NULL) {
+		goto cleanup;
+	}
+
+	if (txn->failed_step < txn->step_count &&
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_FAILED_STEP, txn->failed_step) == NULL) {
+		goto cleanup;
+	}
+
+	steps_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_STEPS);
+
+	if (steps_obj == NULL) {
+		goto cleanup;
+	}
+
+	for (i = 0; i < txn->step_count; i++) {
+		if (!encode_txn_step(steps_obj, &txn->steps[i])) {
+			goto cleanup;
+		}
+	}
+
+	if (!codec_print(ready_obj, buf, buf_len)) {
+		goto cleanup;
+	}
+
+	err = 0;
+
+cleanup:
+	cJSON_Delete(ready_obj);
+	return err;
+}
+#endif // defined(CONFIG_GATEWAY_PROV_PROFILE)
+
+#if defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+/* A device is listed by its UUID, or a group of devices by a hexadecimal UUID prefix */
+static int parse_prov_allow_entry(cJSON *dev_obj, struct prov_allow_entry *entry)
+{
+	int len;
+	char *uuid_str;
+
+	memset(entry, 0, sizeof(*entry));
+	entry->net_idx = PRIMARY_SUBNET;
+	entry->elem_count = 1;
+	codec_get_uint16(dev_obj, JSON_STR_NET_IDX, &entry->net_idx);
+	codec_get_uint8(dev_obj, JSON_STR_ELEM_COUNT, &entry->elem_count);
+
+	if (codec_get_str(dev_obj, JSON_STR_UUID, &uuid_str)) {
+		entry->uuid_prefix_len = UUID_LEN;
+		return util_str2uuid(uuid_str, entry->uuid_prefix);
+	}
+
+	if (!codec_get_str(dev_obj, JSON_STR_UUID_PREFIX, &uuid_str)) {
+		return -EINVAL;
+	}
+
+	len = util_hex2bin(uuid_str, strlen(uuid_str), entry->uuid_prefix,
+			sizeof(entry->uuid_prefix));
+
+	if (len <= 0) {
+		return -EINVAL;
+	}
+
+	entry->uuid_prefix_len = len;
+	return 0;
+}
+
+int codec_parse_prov_allow(cJSON *op_obj, struct prov_allow_entry **entries, size_t *count)
+{
+	size_t i;
+	int err;
+	cJSON *devs_obj;
+
+	devs_obj = cJSON_GetObjectItem(op_obj, JSON_STR_DEVICES);
+
+	if (!cJSON_IsArray(devs_obj) || cJSON_GetArraySize(devs_obj) == 0) {
+		return -EINVAL;
+	}
+
+	*count = cJSON_GetArraySize(devs_obj);
+	*entries = k_malloc(sizeof(**entries) * *count);
+
+	if (*entries == NULL) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < *count; i++) {
+		err = parse_prov_allow_entry(cJSON_GetArrayItem(devs_obj, i), &(*entries)[i]);
+
+		if (err) {
+			k_free(*entries);
+			*entries = NULL;
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+int codec_encode_prov_allow_list(char *buf, size_t buf_len)
+{
+	int err;
+	int ret;
+	size_t i;
+	char uuid_str[UUID_STR_LEN];
+	cJSON *list_obj;
+	cJSON *event_obj;
+	cJSON *devs_obj;
+	cJSON *dev_obj;
+	struct prov_allow_entry entry;
+
+	if (!codec_init_event(&list_obj, &event_obj, "provision_allowlist")) {
+		return -ENOMEM;
+	}
+
+	err = -ENOMEM;
+	devs_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_DEVICES);
+
+	if (devs_obj == NULL) {
+		goto cleanup;
+	}
+
+	for (i = 0; (ret = prov_allow_get(i, &entry)) != -EINVAL; i++) {
+		/* Unused slot */
+		if (ret) {
+			continue;
+		}
+
+		dev_obj = cJSON_CreateObject();
+
+		if (dev_obj == NULL) {
+			goto cleanup;
+		}
+
+		cJSON_AddItemToArray(devs_obj, dev_obj);
+		util_bin2hex(entry.uuid_prefix, entry.uuid_prefix_len, uuid_str, sizeof(uuid_str));
+
+		if (cJSON_AddStringToObject(dev_obj, entry.uuid_prefix_len == UUID_LEN ?
+					JSON_STR_UUID : JSON_STR_UUID_PREFIX, uuid_str) == NULL ||
+		    cJSON_AddNumberToObject(dev_obj, JSON_STR_NET_IDX, entry.net_idx) == NULL ||
+		    cJSON_AddNumberToObject(dev_obj, JSON_STR_ELEM_COUNT,
+			    entry.elem_count) == NULL) {
+			goto cleanup;
+		}
+	}
+
+	if (!codec_print(list_obj, buf, buf_len)) {
+		goto cleanup;
+	}
+
+	err = 0;
+
+cleanup:
+	cJSON_Delete(list_obj);
+	return err;
+}
+#endif // defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+
+#if defined(CONFIG_GATEWAY_UPLINK_RULES)
+/* Fields left out of a rule match any message. An address range is given by its first
+ * address and an optional last address. */
+static int parse_uplink_rule(cJSON *rule_obj, struct uplink_rule *rule)
+{
+	int len;
+	char *str;
+	bool decode;
+	enum uplink_action action;
+
+	memset(rule, 0, sizeof(*rule));
+
+	if (!codec_get_str(rule_obj, JSON_STR_ACTION, &str)) {
+		return -EINVAL;
+	}
+
+	for (action = 0; action < UPLINK_ACTION_COUNT; action++) {
+		if (!strcmp(str, uplink_action_str(action))) {
+			break;
+		}
+	}
+
+	if (action == UPLINK_ACTION_COUNT) {
+		return -EINVAL;
+	}
+
+	rule->action = action;
+
+	if (action == UPLINK_ACTION_SAMPLE &&
+	    !codec_get_uint16(rule_obj, JSON_STR_SAMPLE_RATE, &rule->sample_rate)) {
+		return -EINVAL;
+	}
+
+	if (codec_get_bool(rule_obj, JSON_STR_DECODE, &decode) && decode) {
+		rule->flags |= UPLINK_FLAG_DECODE;
+	}
+
+	if (codec_get_uint32(rule_obj, JSON_STR_OPCODE, &rule->opcode)) {
+		rule->match |= UPLINK_MATCH_OPCODE;
+	}
+
+	if (codec_get_uint16(rule_obj, JSON_STR_SRC_ADDR, &rule->src_first)) {
+		rule->match |= UPLINK_MATCH_SRC;
+
+		if (!codec_get_uint16(rule_obj, JSON_STR_SRC_LAST_ADDR, &rule->src_last)) {
+			rule->src_last = rule->src_first;
+		}
+	}
+
+	if (codec_get_uint16(rule_obj, JSON_STR_DST_ADDR, &rule->dst_first)) {
+		rule->match |= UPLINK_MATCH_DST;
+
+		if (!codec_get_uint16(rule_obj, JSON_STR_DST_LAST_ADDR, &rule->dst_last)) {
+			rule->dst_last = rule->dst_first;
+		}
+	}
+
+	if (codec_get_uint16(rule_obj, JSON_STR_APP_IDX, &rule->app_idx)) {
+		rule->match |= UPLINK_MATCH_APP_IDX;
+	}
+
+	if (codec_get_str(rule_obj, JSON_STR_PAYLOAD_PREFIX, &str)) {
+		len = util_hex2bin(str, strlen(str), rule->prefix, sizeof(rule->prefix));
+
+		if (len <= 0) {
+			return -EINVAL;
+		}
+
+		rule->prefix_len = len;
+		rule->match |= UPLINK_MATCH_PREFIX;
+	}
+
+	return 0;
+}
+
+int codec_parse_uplink_rules(cJSON *op_obj, struct uplink_rule **rules, size_t *count)
+{
+	size_t i;
+	int err;
+	cJSON *rules_obj;
+
+	rules_obj = cJSON_GetObjectItem(op_obj, JSON_STR_RULES);
+
+	if (!cJSON_IsArray(rules_obj)) {
+		return -EINVAL;
+	}
+
+	/* An empty table forwards everything */
+	*count = cJSON_GetArraySize(rules_obj);
+	*rules = NULL;
+
+	if (*count == 0) {
+		return 0;
+	}
+
+	*rules = k_malloc(sizeof(**rules) * *count);
+
+	if (*rules == NULL) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < *count; i++) {
+		err = parse_uplink_rule(cJSON_GetArrayItem(rules_obj, i), &(*rules)[i]);
+
+		if (err) {
+			k_free(*rules);
+			*rules = NULL;
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static int encode_uplink_rule(size_t idx, cJSON **item, void *user_data)
+{
+	char prefix_str[UPLINK_RULE_PREFIX_MAX * 2 + 1];
+	uint32_t hit_count;
+	struct uplink_rule rule;
+
+	if (uplink_rules_get(idx, &rule, &hit_count)) {
+		return -ENOENT;
+	}
+
+	*item = cJSON_CreateObject();
+
+	if (*item == NULL) {
+		return -ENOMEM;
+	}
+
+	if (cJSON_AddStringToObject(*item, JSON_STR_ACTION, uplink_action_str(rule.action)) == NULL ||
+	    (rule.action == UPLINK_ACTION_SAMPLE &&
+	     cJSON_AddNumberToObject(*item, JSON_STR_SAMPLE_RATE, rule.sample_rate) == NULL) ||
+	    cJSON_AddNumberToObject(*item, JSON_STR_HIT_COUNT, hit_count) == NULL) {
+		goto fail;
+	}
+
+	if ((rule.flags & UPLINK_FLAG_DECODE) &&
+	    cJSON_AddBoolToObject(*item, JSON_STR_DECODE, true) == NULL) {
+		goto fail;
+	}
+
+	if ((rule.match & UPLINK_MATCH_OPCODE) &&
+	    cJSON_AddNumberToObject(*item, JSON_STR_OPCODE, rule.opcode) == NULL) {
+		goto fail;
+	}
+
+	if ((rule.match & UPLINK_MATCH_SRC) &&
+	    (cJSON_AddNumberToObject(*item, JSON_STR_SRC_ADDR, rule.src_first) == NULL ||
+	     cJSON_AddNumberToObject(*item, JSON_STR_SRC_LAST_ADDR, rule.src_last) == NULL)) {
+		goto fail;
+	}
+
+	if ((rule.match & UPLINK_MATCH_DST) &&
+	    (cJSON_AddNumberToObject(*item, JSON_STR_DST_ADDR, rule.dst_first) == NULL ||
+	     cJSON_AddNumberToObject(*item, JSON_STR_DST_LAST_ADDR, rule.dst_last) == NULL)) {
+		goto fail;
+	}
+
+	if ((rule.match & UPLINK_MATCH_APP_IDX) &&
+	    cJSON_AddNumberToObject(*item, JSON_STR_APP_IDX, rule.app_idx) == NULL) {
+		goto fail;
+	}
+
+	if (rule.match & UPLINK_MATCH_PREFIX) {
+		util_bin2hex(rule.prefix, rule.prefix_len, prefix_str, sizeof(prefix_str));
+
+		if (cJSON_AddStringToObject(*item, JSON_STR_PAYLOAD_PREFIX, prefix_str) == NULL) {
+			goto fail;
+		}
+	}
+
+	return 0;
+
+fail:
+	cJSON_Delete(*item);
+	*item = NULL;
+	return -ENOMEM;
+}
+
+int codec_encode_uplink_rules(char *buf, size_t buf_len, struct codec_page *page)
+{
+	int err;
+	cJSON *root_obj;
+	cJSON *event_obj;
+	cJSON *rules_obj;
+
+	if (!codec_init_event(&root_obj, &event_obj, "uplink_rules")) {
+		return -ENOMEM;
+	}
+
+	err = -ENOMEM;
+	rules_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_RULES);
+
+	if (rules_obj == NULL) {
+		goto cleanup;
+	}
+
+	page->total = uplink_rules_count();
+
+	err = codec_encode_page(buf, buf_len, root_obj, event_obj, rules_obj, page,
+			encode_uplink_rule, NULL);
+
+cleanup:
+	cJSON_Delete(root_obj);
+	return err;
+}
+#endif // defined(CONFIG_GATEWAY_UPLINK_RULES)
+
+static bool parse_sub_range(cJSON *range_obj, struct sub_range *range)
+{
+	bool all_groups;
+
+	if (codec_get_bool(range_obj, JSON_STR_ALL_GROUPS, &all_groups) && all_groups) {
+		range->first = SUB_SET_GROUP_FIRST;
+		range->last = SUB_SET_GROUP_LAST;
+		return true;
+	}
+
+	if (!codec_get_uint16(range_obj, JSON_STR_ADDR, &range->first)) {
+		return false;
+	}
+
+	/* A single address unless a range is given */
+	if (!codec_get_uint16(range_obj, JSON_STR_LAST_ADDR, &range->last)) {
+		range->last = range->first;
+	}
+
+	return range->first <= range->last;
+}
+
+int codec_parse_subscribe_addrs(cJSON *op_obj, struct sub_range **ranges, size_t *count)
+{
+	size_t i;
+	cJSON *addr_list_obj;
+	cJSON *range_obj;
+
+	addr_list_obj = cJSON_GetObjectItem(op_obj, JSON_STR_ADDR_LIST);
+
+	if (!cJSON_IsArray(addr_list_obj) || cJSON_GetArraySize(addr_list_obj) == 0) {
+		return -EINVAL;
+	}
+
+	*count = cJSON_GetArraySize(addr_list_obj);
+	*ranges = k_malloc(sizeof(**ranges) * *count);
+
+	if (*ranges == NULL) {
+		return -ENOMEM;
+	}
+
+	i = 0;
+
+	cJSON_ArrayForEach(range_obj, addr_list_obj) {
+		if (!parse_sub_range(range_obj, &(*ranges)[i])) {
+			k_free(*ranges);
+			*ranges = NULL;
+			return -EINVAL;
+		}
+
+		i++;
+	}
+
+	return 0;
+}
+
+static int encode_sub_range(size_t idx, cJSON **item, void *user_data)
+{
+	struct sub_range range;
+
+	if (sub_set_get(BTMESH_SUB_TYPE_GATEWAY, idx, &range)) {
+		return -ENOENT;
+	}
+
+	*item = cJSON_CreateObject();
+
+	if (*item == NULL) {
+		return -ENOMEM;
+	}
+
+	if (cJSON_AddNumberToObject(*item, JSON_STR_ADDR, range.first) == NULL ||
+	    (range.last != range.first &&
+	     cJSON_AddNumberToObject(*item, JSON_STR_LAST_ADDR, range.last) == NULL)) {
+		cJSON_Delete(*item);
+		*item = NULL;
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+int codec_encode_subscribe_list(char *buf, size_t buf_len, struct codec_page *page)
+{
+	int err;
+	cJSON *root_obj;
+	cJSON *event_obj;
+	cJSON *addr_list_obj;
+
+	if (!codec_init_event(&root_obj, &event_obj, "subscribe_list")) {
+		return -ENOMEM;
+	}
+
+	err = -ENOMEM;
+	addr_list_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_ADDR_LIST);
+
+	if (addr_list_obj == NULL) {
+		goto cleanup;
+	}
+
+	page->total = sub_set_count(BTMESH_SUB_TYPE_GATEWAY);
+
+	err = codec_encode_page(buf, buf_len, root_obj, event_obj, addr_list_obj, page,
+			encode_sub_range, NULL);
+
+cleanup:
+	cJSON_Delete(root_obj);
+	return err;
+}
+
+int codec_parse_model_msg(cJSON *op_obj, struct bt_mesh_msg_ctx *ctx, struct net_buf_simple *buf)
+{
+        int i;
+        uint8_t byte;
+        uint32_t opcode;
+        size_t payload_len;
+        cJSON *payload_obj;
+        cJSON *byte_obj;
 
-	case BTMESH_OP_TTL_SET:
-		args->ttl_set.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->ttl_set.addr)) ||
-		    !codec_get_uint8(op_obj, JSON_STR_TTL, &(args->ttl_set.val))) {
+	if (!codec_get_uint16(op_obj, JSON_STR_NET_IDX, &(ctx->net_idx)) ||
+	    !codec_get_uint16(op_obj, JSON_STR_APP_IDX, &(ctx->app_idx)) ||
+	    !codec_get_uint16(op_obj, JSON_STR_ADDR, &(ctx->addr)) ||
+	    !codec_get_uint32(op_obj, JSON_STR_OPCODE, &opcode)) {
+		return -EINVAL;
+	}
+        
+	if (opcode & 0xFF0000) {
+                net_buf_simple_add_u8(buf, (uint8_t)(opcode >> 16));
+                net_buf_simple_add_le16(buf, (uint16_t)opcode);
+        } else if (opcode & 0xFF00) {
+                net_buf_simple_add_be16(buf, (uint16_t)opcode);
+        } else if (opcode & 0xFF) {
+                net_buf_simple_add_u8(buf, (uint8_t)opcode);
+        } else {
+                LOG_DBG("Invalid opcode: 0x%08x", opcode);
+                return -EINVAL;
+        }
+                
+        payload_obj = cJSON_GetObjectItem(op_obj, JSON_STR_PAYLOAD);
+
+        if (payload_obj == NULL) {
+                return -EINVAL;
+        }
+
+        if (!cJSON_IsArray(payload_obj)) {
+                return -EINVAL;
+        }
+
+        payload_len = cJSON_GetArraySize(payload_obj);
+
+        for (i = 0; i < payload_len; i++) {
+                byte_obj = cJSON_GetArrayItem(payload_obj, i);
+
+                if (byte_obj == NULL) {
+                        return -ENOMEM;
+                }
+
+		if (!codec_get_uint8(byte_obj, JSON_STR_BYTE, &byte)) {
 			return -EINVAL;
 		}
-		break;
+                
+                net_buf_simple_add_u8(buf, byte);
+        }
 
-	case BTMESH_OP_RELAY_SET:
-	{
-		uint8_t count;
-		uint16_t interval;
+        return 0;
+}
 
-		args->relay_set.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->relay_set.addr)) ||
-		    !codec_get_bool(op_obj, JSON_STR_STATE, (bool*)&(args->relay_set.new_relay)) ||
-		    !codec_get_uint8(op_obj, JSON_STR_TX_COUNT, &count) ||
-		    !codec_get_uint16(op_obj, JSON_STR_TX_INT, &interval)) {
-			return -EINVAL;
+#if defined(CONFIG_GATEWAY_MODEL_DECODE)
+static bool encode_sensor(cJSON *sensors_obj, const struct model_sensor *sensor)
+{
+	char raw_str[CONFIG_GATEWAY_RX_BUS_PAYLOAD_MAX * 2 + 1];
+	cJSON *sensor_obj;
+
+	sensor_obj = cJSON_CreateObject();
+
+	if (sensor_obj == NULL) {
+		return false;
+	}
+
+	cJSON_AddItemToArray(sensors_obj, sensor_obj);
+
+	if (cJSON_AddNumberToObject(sensor_obj, JSON_STR_PROP_ID, sensor->prop_id) == NULL) {
+		return false;
+	}
+
+	if (sensor->len) {
+		util_bin2hex(sensor->raw, sensor->len, raw_str, sizeof(raw_str));
+
+		if (cJSON_AddStringToObject(sensor_obj, JSON_STR_RAW, raw_str) == NULL) {
+			return false;
 		}
-		args->relay_set.new_transmit = BT_MESH_TRANSMIT(count, interval);
-		break;
 	}
 
-	case BTMESH_OP_FRIEND_SET:
-		args->friend_set.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->friend_set.addr)) ||
-		    !codec_get_bool(op_obj, JSON_STR_STATE, (bool*)&(args->friend_set.val))) {
-			return -EINVAL;
+	if (sensor->has_value &&
+	    cJSON_AddNumberToObject(sensor_obj, JSON_STR_VALUE, sensor->value) == NULL) {
+		return false;
+	}
+
+	if (sensor->has_desc &&
+	    (cJSON_AddNumberToObject(sensor_obj, JSON_STR_POS_TOLERANCE,
+			sensor->desc.pos_tolerance) == NULL ||
+	     cJSON_AddNumberToObject(sensor_obj, JSON_STR_NEG_TOLERANCE,
+			sensor->desc.neg_tolerance) == NULL ||
+	     cJSON_AddNumberToObject(sensor_obj, JSON_STR_SAMPLING_FUNC,
+			sensor->desc.sampling_func) == NULL ||
+	     cJSON_AddNumberToObject(sensor_obj, JSON_STR_MEASURE_PERIOD,
+			sensor->desc.measure_period) == NULL ||
+	     cJSON_AddNumberToObject(sensor_obj, JSON_STR_UPDATE_INTERVAL,
+			sensor->desc.update_interval) == NULL)) {
+		return false;
+	}
+
+	return true;
+}
+
+static bool encode_model_decoded(cJSON *event_obj, const struct model_decoded *decoded)
+{
+	size_t i;
+	cJSON *decoded_obj;
+	cJSON *sensors_obj;
+
+	decoded_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_DECODED);
+
+	if (decoded_obj == NULL) {
+		return false;
+	}
+
+	for (i = 0; i < decoded->value_count; i++) {
+		if (cJSON_AddNumberToObject(decoded_obj, decoded->values[i].name,
+					decoded->values[i].value) == NULL) {
+			return false;
 		}
-		break;
+	}
 
-	case BTMESH_OP_PROXY_SET:
-		args->proxy_set.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->proxy_set.addr)) ||
-		    !codec_get_bool(op_obj, JSON_STR_STATE, (bool*)&(args->proxy_set.val))) {
-			return -EINVAL;
+	if (decoded->sensor_count == 0) {
+		return true;
+	}
+
+	sensors_obj = cJSON_AddArrayToObject(decoded_obj, JSON_STR_SENSORS);
+
+	if (sensors_obj == NULL) {
+		return false;
+	}
+
+	for (i = 0; i < decoded->sensor_count; i++) {
+		if (!encode_sensor(sensors_obj, &decoded->sensors[i])) {
+			return false;
 		}
-		break;
+	}
 
-	case BTMESH_OP_NET_KEY_ADD:
-	{
-		uint16_t key_net_idx;
-		struct bt_mesh_cdb_subnet *subnet;
+	return true;
+}
+#endif // defined(CONFIG_GATEWAY_MODEL_DECODE)
 
-		args->net_key_add.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->net_key_add.addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_NET_IDX, &key_net_idx)) {
-			return -EINVAL;
+int codec_encode_model_msg(char *buf, size_t buf_len, uint32_t opcode, struct bt_mesh_msg_ctx *ctx,
+                uint8_t *payload, size_t payload_len, int64_t recv_time,
+                const struct model_decoded *decoded)
+{
+        int err;
+        int i;
+        cJSON *model_status_obj;
+        cJSON *event_obj;
+        cJSON *payload_obj;
+        cJSON *byte_obj;
+
+        if (!codec_init_event_at(&model_status_obj, &event_obj, "receive_model_message",
+                                recv_time)) {
+                return -ENOMEM;
+        }
+
+        err = -ENOMEM;
+
+
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_NET_IDX, ctx->net_idx) == NULL) {
+                goto cleanup;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_APP_IDX, ctx->app_idx) == NULL) {
+                goto cleanup;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_SRC_ADDR, ctx->addr) == NULL) {
+                goto cleanup;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_DST_ADDR, ctx->recv_dst) == NULL) {
+                goto cleanup;
+        }
+
+        if (cJSON_AddNumberToObject(event_obj, JSON_STR_OPCODE, opcode) == NULL) {
+                goto cleanup;
+        }
+
+        payload_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_PAYLOAD);
+
+        if (payload_obj == NULL) {
+                goto cleanup;
+        }
+
+        for (i = 0; i < payload_len; i++) {
+                byte_obj = cJSON_CreateObject();
+
+                if (byte_obj == NULL) {
+                        goto cleanup;
+                }
+
+                cJSON_AddItemToArray(payload_obj, byte_obj);
+
+                if (cJSON_AddNumberToObject(byte_obj, JSON_STR_BYTE, payload[i]) == NULL) {
+                        goto cleanup;
+                }
+        }
+
+#if defined(CONFIG_GATEWAY_MODEL_DECODE)
+        if (decoded != NULL && !encode_model_decoded(event_obj, decoded)) {
+                goto cleanup;
+        }
+#endif // defined(CONFIG_GATEWAY_MODEL_DECODE)
+
+        if (!codec_print(model_status_obj, buf, buf_len)) {
+                goto cleanup;
+        }
+
+        err = 0;
+
+cleanup:
+        cJSON_Delete(model_status_obj);
+        return err;
+}
+
+int codec_parse_hlth_fault(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx, uint16_t *cid)
+{
+        if (!codec_get_uint16(op_obj, JSON_STR_ADDR, addr) ||
+            !codec_get_uint16(op_obj, JSON_STR_APP_IDX, app_idx) ||
+            !codec_get_uint16(op_obj, JSON_STR_CID, cid)) {
+                return -EINVAL; 
+        }
+
+	return 0;
+}
+
+int codec_parse_hlth_fault_test(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx, uint16_t *cid,
+		uint8_t *test_id)
+{
+	if (!codec_get_uint8(op_obj, JSON_STR_TEST_ID, test_id)) {
+		return -EINVAL;
+	}
+
+	return codec_parse_hlth_fault(op_obj, addr, app_idx, cid);
+}
+
+static int codec_encode_hlth_faults(char *buf, size_t buf_len, bool current, uint16_t addr,
+		uint16_t app_idx, uint16_t cid, uint8_t test_id, uint8_t *faults,
+		size_t fault_count, int64_t recv_time)
+{
+	int err;
+	int i;
+	cJSON *hlth_faults_obj;
+	cJSON *event_obj;
+	cJSON *faults_obj;
+	cJSON *fault_obj;
+
+	if (current) {
+		if (!codec_init_event_at(&hlth_faults_obj, &event_obj, "health_faults_current",
+					recv_time)) {
+			return -ENOMEM;
 		}
-		subnet = bt_mesh_cdb_subnet_get(key_net_idx);
-		if (subnet == NULL) {
-			return -ENOEXEC;
+	} else {
+		if (!codec_init_event_at(&hlth_faults_obj, &event_obj, "health_faults_registered",
+					recv_time)) {
+			return -ENOMEM;
 		}
-		args->net_key_add.key_net_idx = key_net_idx;
-		memcpy(args->net_key_add.net_key, subnet->keys[0].net_key, KEY_LEN);
-		break;
 	}
 
-	case BTMESH_OP_NET_KEY_DEL:
-		args->net_key_del.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->net_key_del.addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_NET_IDX, &(args->net_key_del.key_net_idx))) {
-			return -EINVAL;
-		}
-		break;
+	err = -ENOMEM;
+
+	if (cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, addr) == NULL) {
+		goto cleanup;
+	}
 
-	case BTMESH_OP_MOD_APP_BIND:
-	case BTMESH_OP_MOD_APP_BIND_VND:
-	{
-		int i;
-		int err;
-		uint16_t elem_addr;
-		uint16_t model_id;
-		uint16_t cid;
-		uint16_t app_idx;
-		struct bt_mesh_cdb_app_key *app_key;
-
-		args->app_key_get.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->app_key_get.addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR, &elem_addr) ||
-		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &model_id) ||
-		    !codec_get_uint16(op_obj, JSON_STR_APP_IDX, &app_idx)) {
-			return -EINVAL;
+	if (!current) {
+		if (cJSON_AddNumberToObject(event_obj, JSON_STR_APP_IDX, app_idx) == NULL) {
+			goto cleanup;
 		}
+	}
 
-		if (op == BTMESH_OP_MOD_APP_BIND_VND) {
-			if (!codec_get_uint16(op_obj, JSON_STR_CID, &cid)) {
-				return -EINVAL;
-			}
-		}
+	if (cJSON_AddNumberToObject(event_obj, JSON_STR_CID, cid) == NULL) {
+		goto cleanup;
+	}
 
-		app_key = bt_mesh_cdb_app_key_get(app_idx);
+	if (cJSON_AddNumberToObject(event_obj, JSON_STR_TEST_ID, test_id) == NULL) {
+		goto cleanup;
+	}
 
-		if (app_key == NULL) {
-			return -ENOEXEC;
-		}
+	faults_obj = cJSON_AddArrayToObject(event_obj, "faults");
 
-		args->app_key_get.key_net_idx = app_key->net_idx;
-		args->app_key_get.key_cnt = sizeof(args->app_key_get.keys);
+	if (faults_obj == NULL) {
+		goto cleanup;
+	}
 
-		err = btmesh_perform_op(BTMESH_OP_APP_KEY_GET, args);
+	for (i = 0; i < fault_count; i++) {
+		fault_obj = cJSON_CreateObject();
 
-		if (err) {
-			return -ENOEXEC;
+		if (fault_obj == NULL) {
+			goto cleanup;
 		}
 
-		for (i = 0; i < args->app_key_get.key_cnt; i++) {
-			if (args->app_key_get.keys[i] == app_idx) {
-				break;
-			}
+		cJSON_AddItemToArray(faults_obj, fault_obj);
+
+		if (cJSON_AddNumberToObject(fault_obj, "fault", faults[i]) == NULL) {
+			goto cleanup;
 		}
+	}
+
+	if (!codec_print(hlth_faults_obj, buf, buf_len)) {
+		goto cleanup;
+	}
 
-		if (i >= args->app_key_get.key_cnt) {
-			args->app_key_add.key_app_idx = app_idx;
-			memcpy(args->app_key_add.app_key, app_key->keys[0].app_key, KEY_LEN);
-			err = btmesh_perform_op(BTMESH_OP_APP_KEY_ADD, args);
+	err = 0;
 
-			if (err) {
-				return -ENOEXEC;
-			}
-		}
+cleanup:
+	cJSON_Delete(hlth_faults_obj);
+	return err;
+}
 
-		args->mod_app_bind.elem_addr = elem_addr;
-		args->mod_app_bind.mod_app_idx = app_idx;
-		args->mod_app_bind.mod_id = model_id;
+int codec_encode_hlth_faults_cur(char *buf, size_t buf_len, uint16_t addr, uint16_t cid,
+		uint8_t test_id, uint8_t *faults, size_t fault_count, int64_t recv_time)
+{
+	return codec_encode_hlth_faults(buf, buf_len, true, addr, 0, cid, test_id, faults,
+			fault_count, recv_time);
+}
 
-		if (op == BTMESH_OP_MOD_APP_BIND_VND) {
-			args->mod_app_bind_vnd.cid = cid;
-		}
+int codec_encode_hlth_faults_reg(char *buf, size_t buf_len, uint16_t addr, uint16_t app_idx,
+		uint16_t cid, uint8_t test_id, uint8_t *faults, size_t fault_count)
+{
+	return codec_encode_hlth_faults(buf, buf_len, false, addr, app_idx, cid, test_id, faults,
+			fault_count, k_uptime_get());
+}
 
-		break;
+int codec_parse_hlth_period(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx)
+{
+	if (!codec_get_uint16(op_obj, JSON_STR_ADDR, addr) ||
+	    !codec_get_uint16(op_obj, JSON_STR_APP_IDX, app_idx)) {
+		return -EINVAL;
 	}
 
-	case BTMESH_OP_MOD_APP_UNBIND:
-	case BTMESH_OP_MOD_APP_UNBIND_VND:
-		args->mod_app_unbind.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->mod_app_unbind.addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR,
-			    &(args->mod_app_unbind.elem_addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &(args->mod_app_unbind.mod_id)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_APP_IDX,
-			    &(args->mod_app_unbind.mod_app_idx))) {
-			return -EINVAL;
-		}
-		if (op == BTMESH_OP_MOD_APP_UNBIND) {
-			if (!codec_get_uint16(op_obj, JSON_STR_CID,
-						&(args->mod_app_unbind_vnd.cid))) {
-				return -EINVAL;
-			}
-		}
-		break;
+	return 0;
+}
 
-	case BTMESH_OP_MOD_PUB_SET:
-	case BTMESH_OP_MOD_PUB_SET_VND:
-	{
-		char *units;
-		uint8_t period;
-		uint8_t count;
-		uint16_t interval;
-		args->mod_pub_set.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->mod_pub_set.addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR, &(args->mod_pub_set.elem_addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &(args->mod_pub_set.mod_id)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_PUB_ADDR, &(args->mod_pub_set.pub.addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_APP_IDX, &(args->mod_pub_set.pub.app_idx)) ||
-		    !codec_get_bool(op_obj, JSON_STR_FRIEND_CRED_FLAG,
-			    &(args->mod_pub_set.pub.cred_flag)) ||
-		    !codec_get_uint8(op_obj, JSON_STR_TTL, &(args->mod_pub_set.pub.ttl)) ||
-		    !codec_get_uint8(op_obj, JSON_STR_PERIOD, &period) ||
-		    !codec_get_str(op_obj, JSON_STR_PERIOD_UNITS, &units) ||
-		    !codec_get_uint8(op_obj, JSON_STR_TX_COUNT, &count) ||
-		    !codec_get_uint16(op_obj, JSON_STR_TX_INT, &interval)) {
-			return -EINVAL;
-		}
+int codec_parse_hlth_period_set(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx, uint8_t *div)
+{
+	if (!codec_get_uint8(op_obj, JSON_STR_DIV, div)) {
+		return -EINVAL;
+	}
 
-		if (op == BTMESH_OP_MOD_PUB_SET_VND) {
-			if (!codec_get_uint16(op_obj, JSON_STR_CID, &(args->mod_pub_set_vnd.cid))) {
-				return -EINVAL;
-			}
-		}
+	return codec_parse_hlth_period(op_obj, addr, app_idx);
+}
 
-		if (!strcmp(units, "100ms")) {
-			args->mod_pub_set.pub.period = BT_MESH_PUB_PERIOD_100MS(period);
-			break;
-		} else if (!strcmp(units, "1s")) {
-			args->mod_pub_set.pub.period = BT_MESH_PUB_PERIOD_SEC(period);
-			break;
-		} else if (!strcmp(units, "10s")) {
-			args->mod_pub_set.pub.period = BT_MESH_PUB_PERIOD_10SEC(period);
-			break;
-		} else if (!strcmp(units, "10m")) {
-			args->mod_pub_set.pub.period = BT_MESH_PUB_PERIOD_10MIN(period);
-			break;
-		} else {
-			return -EINVAL;
-		}
+int codec_encode_hlth_period(char *buf, size_t buf_len, uint16_t addr, uint8_t div)
+{
+	int err;
+	cJSON *hlth_period_obj;
+	cJSON *event_obj;
 
-		args->mod_pub_set.pub.transmit = BT_MESH_TRANSMIT(count, interval);
+	if (!codec_init_event(&hlth_period_obj, &event_obj, "health_period")) {
+		return -ENOMEM;
+	}
 
-		break;
+	err = -ENOMEM;
+
+	if (cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, addr) == NULL) {
+		goto cleanup;
 	}
 
-	case BTMESH_OP_MOD_SUB_ADD:
-	case BTMESH_OP_MOD_SUB_ADD_VND:
-		args->mod_sub_add.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->mod_sub_add.addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR, &(args->mod_sub_add.elem_addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &(args->mod_sub_add.mod_id)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_SUB_ADDR, &(args->mod_sub_add.sub_addr))) {
-		       return -ENOEXEC;
-		}	       
-		if (op == BTMESH_OP_MOD_SUB_ADD_VND) {
-			if (!codec_get_uint16(op_obj, JSON_STR_CID, &(args->mod_sub_add_vnd.cid))) {
-				return -ENOEXEC;
-			}
-		}
-		break;
+	if (cJSON_AddNumberToObject(event_obj, JSON_STR_DIV, div) == NULL) {
+		goto cleanup;
+	}
 
-	case BTMESH_OP_MOD_SUB_DEL:
-	case BTMESH_OP_MOD_SUB_DEL_VND:
-		args->mod_sub_del.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->mod_sub_del.addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR, &(args->mod_sub_del.elem_addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &(args->mod_sub_del.mod_id)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_SUB_ADDR, &(args->mod_sub_del.sub_addr))) {
-			return -EINVAL;
-		}
-		if (op == BTMESH_OP_MOD_SUB_DEL_VND) {
-			if (!codec_get_uint16(op_obj, JSON_STR_CID, &(args->mod_sub_del_vnd.cid))) {
-				return -EINVAL;
-			}
-		}
-		break;
+	if (!codec_print(hlth_period_obj, buf, buf_len)) {
+		goto cleanup;
+	}
 
-	case BTMESH_OP_MOD_SUB_OVRW:
-	case BTMESH_OP_MOD_SUB_OVRW_VND:
-		args->mod_sub_ovrw.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->mod_sub_ovrw.addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_ELEM_ADDR, &(args->mod_sub_ovrw.elem_addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_MOD_ID, &(args->mod_sub_ovrw.mod_id)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_SUB_ADDR, &(args->mod_sub_ovrw.sub_addr))) {
-			return -EINVAL;
-		}
-		if (op == BTMESH_OP_MOD_SUB_OVRW_VND) {
-			if (!codec_get_uint16(op_obj, JSON_STR_CID, &(args->mod_sub_ovrw_vnd.cid))) {
-				return -EINVAL;
-			}
-		}
-		break;
+	err = 0;
 
-	case BTMESH_OP_HB_SUB_SET:
-		args->hb_sub_set.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->hb_sub_set.addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_SRC_ADDR, &(args->hb_sub_set.sub.src)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_DST_ADDR, &(args->hb_sub_set.sub.dst)) ||
-		    !codec_get_uint8(op_obj, JSON_STR_PERIOD, &(args->hb_sub_set.sub.period)) ||
-		    !codec_get_uint8(op_obj, JSON_STR_COUNT, &(args->hb_sub_set.sub.count)) ||
-		    !codec_get_uint8(op_obj, JSON_STR_MIN_HOPS, &(args->hb_sub_set.sub.min)) ||
-		    !codec_get_uint8(op_obj, JSON_STR_MAX_HOPS, &(args->hb_sub_set.sub.max))) {
-			return -EINVAL;
-		}
-		break;
+cleanup:
+	cJSON_Delete(hlth_period_obj);
+	return err;
+}
 
-	case BTMESH_OP_HB_PUB_SET:
-	{
-		bool relay;
-		bool proxy;
-		bool friend;
-		bool lpn;
+int codec_parse_hlth_attn(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx)
+{
+	if (!codec_get_uint16(op_obj, JSON_STR_ADDR, addr) ||
+	    !codec_get_uint16(op_obj, JSON_STR_APP_IDX, app_idx)) {
+		return -EINVAL;
+	}
 
-		args->hb_pub_set.net_idx = PRIMARY_SUBNET;
-		if (!codec_get_uint16(op_obj, JSON_STR_ADDR, &(args->hb_pub_set.addr)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_NET_IDX, &(args->hb_pub_set.pub.net_idx)) ||
-		    !codec_get_uint16(op_obj, JSON_STR_DST_ADDR, &(args->hb_pub_set.pub.dst)) ||
-		    !codec_get_uint8(op_obj, JSON_STR_COUNT, &(args->hb_pub_set.pub.count)) ||
-		    !codec_get_uint8(op_obj, JSON_STR_PERIOD, &(args->hb_pub_set.pub.period)) ||
-		    !codec_get_uint8(op_obj, JSON_STR_TTL, &(args->hb_pub_set.pub.ttl)) ||
-		    !codec_get_bool(op_obj, JSON_STR_RELAY, &relay) ||
-		    !codec_get_bool(op_obj, JSON_STR_PROXY, &proxy) ||
-		    !codec_get_bool(op_obj, JSON_STR_FRIEND, &friend) ||
-		    !codec_get_bool(op_obj, JSON_STR_LPN, &lpn)) {
-			return -EINVAL;
-		}
+	return 0;
+}
 
-		args->hb_pub_set.pub.feat =
-			(relay ? BT_MESH_FEAT_RELAY : 0) |
-			(proxy ? BT_MESH_FEAT_PROXY : 0) |
-			(friend ? BT_MESH_FEAT_FRIEND : 0) |
-			(lpn ? BT_MESH_FEAT_LOW_POWER : 0);
-		break;
+int codec_parse_hlth_attn_set(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx, uint8_t *attn)
+{
+	if (!codec_get_uint8(op_obj, JSON_STR_ATTN, attn)) {
+		return -EINVAL;
 	}
-	default:
-		LOG_ERR("Unsupported configuration operation");
-		return false;
-        }
 
-        return 0;
+	return codec_parse_hlth_attn(op_obj, addr, app_idx);
 }
 
-int codec_parse_node_cfg(cJSON *op_obj, uint16_t *addr)
-{
-        int err;
-        enum btmesh_op op;
-        union btmesh_op_args args;
+int codec_encode_hlth_attn(char *buf, size_t buf_len, uint16_t addr, uint8_t attn)
+{
+	int err;
+	cJSON *hlth_attn_obj;
+	cJSON *event_obj;
+
+	if (!codec_init_event(&hlth_attn_obj, &event_obj, "health_attention")) {
+		return -ENOMEM;
+	}
 
-	if (!codec_get_uint16(op_obj, JSON_STR_ADDR, addr)) {
-		return -EINVAL;
+	err = -ENOMEM;
+
+	if (cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, addr) == NULL) {
+		goto cleanup;
 	}
 
-        if (!parse_cfg_op(op_obj, &op)) {
-                return -EINVAL;
-        }
+	if (cJSON_AddNumberToObject(event_obj, JSON_STR_ATTN, attn) == NULL) {
+		goto cleanup;
+	}
 
-	err = parse_cfg_args(op_obj, op, &args);
-	if (err) {
-		return err;
+	if (!codec_print(hlth_attn_obj, buf, buf_len)) {
+		goto cleanup;
 	}
 
-        err = btmesh_perform_op(op, &args);
-        if (err) {
-		return -ENOEXEC;
-        }
+	err = 0;
 
-        if (op == BTMESH_OP_MOD_APP_UNBIND) {
-                err = btmesh_clean_node_key(args.mod_app_unbind.addr, args.mod_app_unbind.mod_app_idx);
+cleanup:
+	cJSON_Delete(hlth_attn_obj);
+	return err;
+}
 
-                if (err) {
-			return -ENOEXEC;
-                }
-        }
+int codec_parse_hlth_timeout(cJSON *op_obj, int32_t *timeout)
+{
+	if (!codec_get_int32(op_obj, JSON_STR_TIMEOUT, timeout)) {
+		return -EINVAL;
+	}
 
-        return 0;
+	return 0;
 }
 
-int codec_parse_subscribe_addrs(cJSON *op_obj, uint16_t **addr_list, int *addr_count)
+int codec_encode_hlth_timeout(char *buf, size_t buf_len, int32_t timeout)
 {
-        int i;
-        cJSON *addr_list_obj;
-        cJSON *addr_obj;
-        uint16_t addr;
+	int err;
+	cJSON *hlth_timeout_obj;
+	cJSON *event_obj;
 
-        addr_list_obj = cJSON_GetObjectItem(op_obj, JSON_STR_ADDR_LIST);
+	if (!codec_init_event(&hlth_timeout_obj, &event_obj, "health_client_timeout")) {
+		return -ENOMEM;
+	}
 
-        if (addr_list_obj == NULL) {
-                return -ENOMEM;
-        }
+	err = -ENOMEM;
 
-        *addr_count = cJSON_GetArraySize(addr_list_obj);
-        *addr_list = k_malloc(sizeof(uint16_t) * *addr_count);
+	if (cJSON_AddNumberToObject(event_obj, JSON_STR_TIMEOUT, timeout) == NULL) {
+		goto cleanup;
+	}
 
-        if (*addr_list == NULL) {
-                return -ENOMEM;
-        }
+	if (!codec_print(hlth_timeout_obj, buf, buf_len)) {
+		goto cleanup;
+	}
 
-        for (i = 0; i < *addr_count; i++) {
-                addr_obj = cJSON_GetArrayItem(addr_list_obj, i);
-		
-		if (!codec_get_uint16(addr_obj, JSON_STR_ADDR, &addr)) {
-			return -EINVAL;
-		}
-                
-		(*addr_list)[i] = addr;
-        }
+	err= 0;
 
-        return 0;        
+cleanup:
+	cJSON_Delete(hlth_timeout_obj);
+	return err;
 }
 
-int codec_encode_subscribe_list(char *buf, size_t buf_len)
+int codec_parse_mesh_stats(cJSON *op_obj, bool *reset)
 {
-        int err;
-        int i;
-        const uint16_t *subscribe_list;
-        cJSON *subscribe_list_obj;
-        cJSON *event_obj;
-        cJSON *addr_list_obj;
-        cJSON *addr_obj;
-
-        subscribe_list = btmesh_get_subscribe_list(BTMESH_SUB_TYPE_GATEWAY);
+	if (!codec_get_bool(op_obj, JSON_STR_RESET, reset)) {
+		*reset = false;
+	}
 
-        if (subscribe_list == NULL) {
-                return -EINVAL;
-        }
+	return 0;
+}
 
-        if (!codec_init_event(&subscribe_list_obj, &event_obj, "subscribe_list")) {
-                return -ENOMEM;
-        }
+static bool encode_op_stats(cJSON *ops_obj, enum btmesh_op op,
+		const struct mesh_retry_op_stats *stats)
+{
+	cJSON *op_obj;
 
-        addr_list_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_ADDR_LIST);
-        err = -ENOMEM;
+	op_obj = cJSON_CreateObject();
 
-        if (addr_list_obj == NULL) {
-                goto cleanup;
-        }
+	if (op_obj == NULL) {
+		return false;
+	}
 
-        for (i = 0; i < CONFIG_BT_MESH_GATEWAY_SUB_LIST_LEN; i++) {
-                if (subscribe_list[i] == BT_MESH_ADDR_UNASSIGNED) {
-                        continue;
-                }
+	cJSON_AddItemToArray(ops_obj, op_obj);
+
+	if (cJSON_AddStringToObject(op_obj, JSON_STR_OP, btmesh_get_op_str(op)) == NULL ||
+			cJSON_AddNumberToObject(op_obj, JSON_STR_COUNT, stats->count) == NULL ||
+			cJSON_AddNumberToObject(op_obj, JSON_STR_FAIL_COUNT,
+				stats->fail_count) == NULL ||
+			cJSON_AddNumberToObject(op_obj, JSON_STR_RETRY_COUNT,
+				stats->retry_count) == NULL ||
+			cJSON_AddNumberToObject(op_obj, JSON_STR_TIMEOUT_COUNT,
+				stats->timeout_count) == NULL ||
+			cJSON_AddNumberToObject(op_obj, JSON_STR_AVG_TIME,
+				stats->total_ms / stats->count) == NULL ||
+			cJSON_AddNumberToObject(op_obj, JSON_STR_MAX_TIME, stats->max_ms) == NULL) {
+		return false;
+	}
 
-                addr_obj = cJSON_CreateObject();
+	return true;
+}
 
-                if (addr_obj == NULL) {
-                        goto cleanup;
-                }
+static bool encode_node_rtt(cJSON *nodes_obj, const struct mesh_retry_node *node)
+{
+	cJSON *node_obj;
 
-                cJSON_AddItemToArray(addr_list_obj, addr_obj);
+	node_obj = cJSON_CreateObject();
 
-                if (cJSON_AddNumberToObject(addr_obj, JSON_STR_ADDR, subscribe_list[i]) == NULL) {
-                        goto cleanup;
-                }
-        }
+	if (node_obj == NULL) {
+		return false;
+	}
 
-        if (!cJSON_PrintPreallocated(subscribe_list_obj, buf, buf_len, 0)) {
-                goto cleanup;
-        }
+	cJSON_AddItemToArray(nodes_obj, node_obj);
 
-        err = 0;
+	if (cJSON_AddNumberToObject(node_obj, JSON_STR_ADDR, node->addr) == NULL ||
+			cJSON_AddNumberToObject(node_obj, JSON_STR_RTT, node->srtt) == NULL ||
+			cJSON_AddNumberToObject(node_obj, JSON_STR_RTT_VAR, node->rttvar) == NULL ||
+			cJSON_AddNumberToObject(node_obj, JSON_STR_TIMEOUT, node->rto) == NULL ||
+			cJSON_AddNumberToObject(node_obj, JSON_STR_SAMPLE_COUNT,
+				node->sample_count) == NULL ||
+			cJSON_AddNumberToObject(node_obj, JSON_STR_TIMEOUT_COUNT,
+				node->timeout_count) == NULL) {
+		return false;
+	}
 
-cleanup:
-        cJSON_Delete(subscribe_list_obj);
-        return err;
+	return true;
 }
 
-int codec_parse_model_msg(cJSON *op_obj, struct bt_mesh_msg_ctx *ctx, struct net_buf_simple *buf)
+#if defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+static bool encode_compress_stats(cJSON *event_obj)
 {
-        int i;
-        uint8_t byte;
-        uint32_t opcode;
-        size_t payload_len;
-        cJSON *payload_obj;
-        cJSON *byte_obj;
-
-	if (!codec_get_uint16(op_obj, JSON_STR_NET_IDX, &(ctx->net_idx)) ||
-	    !codec_get_uint16(op_obj, JSON_STR_APP_IDX, &(ctx->app_idx)) ||
-	    !codec_get_uint16(op_obj, JSON_STR_ADDR, &(ctx->addr)) ||
-	    !codec_get_uint32(op_obj, JSON_STR_OPCODE, &opcode)) {
-		return -EINVAL;
+	cJSON *compress_obj;
+	struct compress_stats stats;
+	uint32_t count;
+
+	compress_get_stats(&stats);
+	count = stats.msg_count + stats.skip_count;
+	compress_obj = cJSON_AddObjectToObject(event_obj, JSON_STR_COMPRESSION);
+
+	/* The ratio is the compressed size in percent of the original */
+	if (compress_obj == NULL ||
+			cJSON_AddNumberToObject(compress_obj, JSON_STR_COUNT,
+				stats.msg_count) == NULL ||
+			cJSON_AddNumberToObject(compress_obj, JSON_STR_SKIP_COUNT,
+				stats.skip_count) == NULL ||
+			cJSON_AddNumberToObject(compress_obj, JSON_STR_BYTES_IN,
+				stats.bytes_in) == NULL ||
+			cJSON_AddNumberToObject(compress_obj, JSON_STR_BYTES_OUT,
+				stats.bytes_out) == NULL ||
+			cJSON_AddNumberToObject(compress_obj, JSON_STR_RATIO, stats.bytes_in ?
+				((uint64_t)stats.bytes_out * 100) / stats.bytes_in : 0) == NULL ||
+			cJSON_AddNumberToObject(compress_obj, JSON_STR_AVG_CPU_TIME,
+				count ? stats.total_us / count : 0) == NULL ||
+			cJSON_AddNumberToObject(compress_obj, JSON_STR_MAX_CPU_TIME,
+				stats.max_us) == NULL) {
+		return false;
 	}
-        
-	if (opcode & 0xFF0000) {
-                net_buf_simple_add_u8(buf, (uint8_t)(opcode >> 16));
-                net_buf_simple_add_le16(buf, (uint16_t)opcode);
-        } else if (opcode & 0xFF00) {
-                net_buf_simple_add_be16(buf, (uint16_t)opcode);
-        } else if (opcode & 0xFF) {
-                net_buf_simple_add_u8(buf, (uint8_t)opcode);
-        } else {
-                LOG_DBG("Invalid opcode: 0x%08x", opcode);
-                return -EINVAL;
-        }
-                
-        payload_obj = cJSON_GetObjectItem(op_obj, JSON_STR_PAYLOAD);
 
-        if (payload_obj == NULL) {
-                return -EINVAL;
-        }
+	return true;
+}
+#endif // defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
 
-        if (!cJSON_IsArray(payload_obj)) {
-                return -EINVAL;
-        }
+int codec_encode_mesh_stats(char *buf, size_t buf_len)
+{
+	int err;
+	size_t i;
+	cJSON *mesh_stats_obj;
+	cJSON *event_obj;
+	cJSON *ops_obj;
+	cJSON *nodes_obj;
+	struct mesh_retry_op_stats stats;
+	struct mesh_retry_node node;
 
-        payload_len = cJSON_GetArraySize(payload_obj);
+	if (!codec_init_event(&mesh_stats_obj, &event_obj, "mesh_stats")) {
+		return -ENOMEM;
+	}
 
-        for (i = 0; i < payload_len; i++) {
-                byte_obj = cJSON_GetArrayItem(payload_obj, i);
+	err = -ENOMEM;
+	ops_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_OPS);
 
-                if (byte_obj == NULL) {
-                        return -ENOMEM;
-                }
+	if (ops_obj == NULL) {
+		goto cleanup;
+	}
 
-		if (!codec_get_uint8(byte_obj, JSON_STR_BYTE, &byte)) {
-			return -EINVAL;
+	/* Operations that were never performed are left out to keep the event small */
+	for (i = 0; !mesh_retry_op_stats_get(i, &stats); i++) {
+		if (stats.count && !encode_op_stats(ops_obj, i, &stats)) {
+			goto cleanup;
 		}
-                
-                net_buf_simple_add_u8(buf, byte);
-        }
-
-        return 0;
-}
-
-int codec_encode_model_msg(char *buf, size_t buf_len, uint32_t opcode, struct bt_mesh_msg_ctx *ctx,
-                uint8_t *payload, size_t payload_len)
-{
-        int err;
-        int i;
-        cJSON *model_status_obj;
-        cJSON *event_obj;
-        cJSON *payload_obj;
-        cJSON *byte_obj;
+	}
 
-        if (!codec_init_event(&model_status_obj, &event_obj, "receive_model_message")) {
-                return -ENOMEM;
-        }
+	nodes_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_NODES);
 
-        err = -ENOMEM;
+	if (nodes_obj == NULL) {
+		goto cleanup;
+	}
 
+	for (i = 0; !mesh_retry_node_get(i, &node); i++) {
+		if (node.addr != BT_MESH_ADDR_UNASSIGNED && !encode_node_rtt(nodes_obj, &node)) {
+			goto cleanup;
+		}
+	}
 
-        if (cJSON_AddNumberToObject(event_obj, JSON_STR_NET_IDX, ctx->net_idx) == NULL) {
-                goto cleanup;
-        }
+#if defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+	if (!encode_compress_stats(event_obj)) {
+		goto cleanup;
+	}
+#endif // defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
 
-        if (cJSON_AddNumberToObject(event_obj, JSON_STR_APP_IDX, ctx->app_idx) == NULL) {
-                goto cleanup;
-        }
+	if (!codec_print(mesh_stats_obj, buf, buf_len)) {
+		goto cleanup;
+	}
 
-        if (cJSON_AddNumberToObject(event_obj, JSON_STR_SRC_ADDR, ctx->addr) == NULL) {
-                goto cleanup;
-        }
+	err = 0;
 
-        if (cJSON_AddNumberToObject(event_obj, JSON_STR_DST_ADDR, ctx->recv_dst) == NULL) {
-                goto cleanup;
-        }
+cleanup:
+	cJSON_Delete(mesh_stats_obj);
+	return err;
+}
 
-        if (cJSON_AddNumberToObject(event_obj, JSON_STR_OPCODE, opcode) == NULL) {
-                goto cleanup;
-        }
+#if defined(CONFIG_GATEWAY_SWEEP)
+int codec_parse_sweep_start(cJSON *op_obj, struct sweep_params *params)
+{
+	/* Every parameter is optional and keeps the value passed in when left out */
+	codec_get_uint8(op_obj, JSON_STR_CONCURRENCY, &params->concurrency);
+	codec_get_uint32(op_obj, JSON_STR_INTERVAL, &params->interval_ms);
+	codec_get_uint32(op_obj, JSON_STR_MAX_LATENCY, &params->max_latency_ms);
+	codec_get_uint32(op_obj, JSON_STR_MAX_QUEUE, &params->max_queue);
+	codec_get_bool(op_obj, JSON_STR_REFRESH, &params->refresh);
+
+	if (params->concurrency == 0) {
+		return -EINVAL;
+	}
 
-        payload_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_PAYLOAD);
+	return 0;
+}
 
-        if (payload_obj == NULL) {
-                goto cleanup;
-        }
+int codec_encode_sweep_progress(char *buf, size_t buf_len, const struct sweep_status *status,
+		size_t queue_depth, uint32_t latency_ms, uint16_t addr, int node_err,
+		uint8_t node_status)
+{
+	int err;
+	cJSON *sweep_obj;
+	cJSON *event_obj;
 
-        for (i = 0; i < payload_len; i++) {
-                byte_obj = cJSON_CreateObject();
+	if (!codec_init_event(&sweep_obj, &event_obj, "node_sweep_progress")) {
+		return -ENOMEM;
+	}
 
-                if (byte_obj == NULL) {
-                        goto cleanup;
-                }
+	err = -ENOMEM;
 
-                cJSON_AddItemToArray(payload_obj, byte_obj);
+	if (cJSON_AddStringToObject(event_obj, JSON_STR_STATE,
+				sweep_state_str(status->state)) == NULL ||
+			cJSON_AddNumberToObject(event_obj, JSON_STR_TOTAL_COUNT,
+				status->total) == NULL ||
+			cJSON_AddNumberToObject(event_obj, JSON_STR_DONE_COUNT,
+				status->done) == NULL ||
+			cJSON_AddNumberToObject(event_obj, JSON_STR_FAIL_COUNT,
+				status->failed) == NULL ||
+			cJSON_AddNumberToObject(event_obj, JSON_STR_ACTIVE_COUNT,
+				status->active) == NULL ||
+			cJSON_AddNumberToObject(event_obj, JSON_STR_QUEUE_DEPTH,
+				queue_depth) == NULL ||
+			cJSON_AddNumberToObject(event_obj, JSON_STR_LATENCY, latency_ms) == NULL) {
+		goto cleanup;
+	}
 
-                if (cJSON_AddNumberToObject(byte_obj, JSON_STR_BYTE, payload[i]) == NULL) {
-                        goto cleanup;
-                }
-        }
+	/* The node that just finished, if the event was sent for one */
+	if (addr != BT_MESH_ADDR_UNASSIGNED) {
+		if (cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, addr) == NULL ||
+				cJSON_AddNumberToObject(event_obj, JSON_STR_ERR, node_err) == NULL ||
+				cJSON_AddNumberToObject(event_obj, JSON_STR_STATUS,
+					node_status) == NULL) {
+			goto cleanup;
+		}
+	}
 
-        if (!cJSON_PrintPreallocated(model_status_obj, buf, buf_len, 0)) {
-                goto cleanup;
-        }
+	if (!codec_print(sweep_obj, buf, buf_len)) {
+		goto cleanup;
+	}
 
-        err = 0;
+	err = 0;
 
 cleanup:
-        cJSON_Delete(model_status_obj);
-        return err;
+	cJSON_Delete(sweep_obj);
+	return err;
 }
+#endif // defined(CONFIG_GATEWAY_SWEEP)
 
-int codec_parse_hlth_fault(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx, uint16_t *cid)
+#if defined(CONFIG_GATEWAY_FANOUT)
+static int parse_fanout_addrs(cJSON *addr_list_obj, struct fanout_req *req)
 {
-        if (!codec_get_uint16(op_obj, JSON_STR_ADDR, addr) ||
-            !codec_get_uint16(op_obj, JSON_STR_APP_IDX, app_idx) ||
-            !codec_get_uint16(op_obj, JSON_STR_CID, cid)) {
-                return -EINVAL; 
-        }
+	int i;
+	int count;
+	cJSON *addr_obj;
+
+	count = cJSON_GetArraySize(addr_list_obj);
+
+	if (count == 0 || count > CONFIG_BT_MESH_CDB_NODE_COUNT) {
+		return -EINVAL;
+	}
+
+	req->addrs = k_malloc(sizeof(uint16_t) * count);
+
+	if (req->addrs == NULL) {
+		return -ENOMEM;
+	}
+
+	req->addr_count = count;
+
+	for (i = 0; i < count; i++) {
+		addr_obj = cJSON_GetArrayItem(addr_list_obj, i);
+
+		if (!codec_get_uint16(addr_obj, JSON_STR_ADDR, &req->addrs[i])) {
+			k_free(req->addrs);
+			req->addrs = NULL;
+			return -EINVAL;
+		}
+	}
 
 	return 0;
 }
 
-int codec_parse_hlth_fault_test(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx, uint16_t *cid,
-		uint8_t *test_id)
+int codec_parse_node_cfg_fanout(cJSON *op_obj, struct fanout_req *req)
 {
-	if (!codec_get_uint8(op_obj, JSON_STR_TEST_ID, test_id)) {
+	int err;
+	cJSON *filter_obj;
+	cJSON *addr_list_obj;
+
+	memset(req, 0, sizeof(*req));
+	req->concurrency = CONFIG_GATEWAY_FANOUT_WORKERS;
+	codec_get_uint8(op_obj, JSON_STR_CONCURRENCY, &req->concurrency);
+
+	if (req->concurrency == 0) {
 		return -EINVAL;
 	}
 
-	return codec_parse_hlth_fault(op_obj, addr, app_idx, cid);
+	filter_obj = cJSON_GetObjectItem(op_obj, JSON_STR_FILTER);
+
+	if (filter_obj != NULL) {
+		req->filter.net_idx_set = codec_get_uint16(filter_obj, JSON_STR_NET_IDX,
+				&req->filter.net_idx);
+		req->filter.model_id_set = codec_get_uint16(filter_obj, JSON_STR_MOD_ID,
+				&req->filter.model_id);
+		req->filter.company_id_set = codec_get_uint16(filter_obj, JSON_STR_CID,
+				&req->filter.company_id);
+	}
+
+	/* The node and element addresses are filled in for every node the operation is
+	 * applied to */
+	if ((!cJSON_HasObjectItem(op_obj, JSON_STR_ADDR) &&
+	     cJSON_AddNumberToObject(op_obj, JSON_STR_ADDR, BT_MESH_ADDR_UNASSIGNED) == NULL) ||
+	    (!cJSON_HasObjectItem(op_obj, JSON_STR_ELEM_ADDR) &&
+	     cJSON_AddNumberToObject(op_obj, JSON_STR_ELEM_ADDR,
+		     BT_MESH_ADDR_UNASSIGNED) == NULL)) {
+		return -ENOMEM;
+	}
+
+	if (!parse_cfg_op(op_obj, &req->op)) {
+		return -EINVAL;
+	}
+
+	err = parse_cfg_args(op_obj, req->op, &req->args);
+
+	if (err) {
+		return err;
+	}
+
+	addr_list_obj = cJSON_GetObjectItem(op_obj, JSON_STR_ADDR_LIST);
+
+	if (addr_list_obj == NULL) {
+		return 0;
+	}
+
+	return parse_fanout_addrs(addr_list_obj, req);
 }
 
-static int codec_encode_hlth_faults(char *buf, size_t buf_len, bool current, uint16_t addr,
-		uint16_t app_idx, uint16_t cid, uint8_t test_id, uint8_t *faults,
-		size_t fault_count)
+int codec_encode_fanout_node(char *buf, size_t buf_len, const struct fanout_result *res)
 {
 	int err;
-	int i;
-	cJSON *hlth_faults_obj;
+	cJSON *fanout_obj;
 	cJSON *event_obj;
-	cJSON *faults_obj;
-	cJSON *fault_obj;
 
-	if (current) {
-		if (!codec_init_event(&hlth_faults_obj, &event_obj, "health_faults_current")) {
-			return -ENOMEM;
-		}
-	} else {
-		if (!codec_init_event(&hlth_faults_obj, &event_obj, "health_faults_registered")) {
-			return -ENOMEM;
-		}
+	if (!codec_init_event(&fanout_obj, &event_obj, "node_configure_fanout_result")) {
+		return -ENOMEM;
 	}
 
 	err = -ENOMEM;
 
-	if (cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, addr) == NULL) {
+	if (cJSON_AddStringToObject(event_obj, JSON_STR_CFG, cfg_op_name(res->op)) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, res->addr) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_ERR, res->err) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_STATUS, res->status) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_ELEM_COUNT, res->elem_count) == NULL ||
+	    cJSON_AddBoolToObject(event_obj, JSON_STR_SKIPPED, res->skipped) == NULL) {
 		goto cleanup;
 	}
 
-	if (!current) {
-		if (cJSON_AddNumberToObject(event_obj, JSON_STR_APP_IDX, app_idx) == NULL) {
-			goto cleanup;
-		}
-	}
-
-	if (cJSON_AddNumberToObject(event_obj, JSON_STR_CID, cid) == NULL) {
+	if (!codec_print(fanout_obj, buf, buf_len)) {
 		goto cleanup;
 	}
 
-	if (cJSON_AddNumberToObject(event_obj, JSON_STR_TEST_ID, test_id) == NULL) {
-		goto cleanup;
-	}
+	err = 0;
 
-	faults_obj = cJSON_AddArrayToObject(event_obj, "faults");
+cleanup:
+	cJSON_Delete(fanout_obj);
+	return err;
+}
 
-	if (faults_obj == NULL) {
-		goto cleanup;
-	}
+int codec_encode_fanout_progress(char *buf, size_t buf_len, const struct fanout_status *status)
+{
+	int err;
+	cJSON *fanout_obj;
+	cJSON *event_obj;
 
-	for (i = 0; i < fault_count; i++) {
-		fault_obj = cJSON_CreateObject();
+	if (!codec_init_event(&fanout_obj, &event_obj, "node_configure_fanout_progress")) {
+		return -ENOMEM;
+	}
 
-		if (fault_obj == NULL) {
-			goto cleanup;
-		}
+	err = -ENOMEM;
 
-		cJSON_AddItemToArray(faults_obj, fault_obj);
+	if (cJSON_AddStringToObject(event_obj, JSON_STR_STATE,
+				fanout_state_str(status->state)) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_TOTAL_COUNT, status->total) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_DONE_COUNT, status->done) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_FAIL_COUNT, status->failed) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_SKIP_COUNT, status->skipped) == NULL ||
+	    cJSON_AddNumberToObject(event_obj, JSON_STR_ACTIVE_COUNT, status->active) == NULL) {
+		goto cleanup;
+	}
 
-		if (cJSON_AddNumberToObject(fault_obj, "fault", faults[i]) == NULL) {
-			goto cleanup;
-		}
+	/* Nothing has been started yet if the gateway has been idle since boot */
+	if (status->state != FANOUT_IDLE &&
+	    cJSON_AddStringToObject(event_obj, JSON_STR_CFG, cfg_op_name(status->op)) == NULL) {
+		goto cleanup;
 	}
 
-	if (!cJSON_PrintPreallocated(hlth_faults_obj, buf, buf_len, 0)) {
+	if (!codec_print(fanout_obj, buf, buf_len)) {
 		goto cleanup;
 	}
 
 	err = 0;
 
 cleanup:
-	cJSON_Delete(hlth_faults_obj);
+	cJSON_Delete(fanout_obj);
 	return err;
 }
+#endif // defined(CONFIG_GATEWAY_FANOUT)
 
-int codec_encode_hlth_faults_cur(char *buf, size_t buf_len, uint16_t addr, uint16_t cid,
-		uint8_t test_id, uint8_t *faults, size_t fault_count)
+#if defined(CONFIG_GATEWAY_RECONCILE)
+/* A missing list leaves *set false, an empty one sets it with no values */
+static int parse_idx_list(cJSON *obj, const char *item, uint16_t *vals, size_t max,
+		bool *set, size_t *count)
 {
-	return codec_encode_hlth_faults(buf, buf_len, true, addr, 0, cid, test_id, faults,
-			fault_count);
-}
+	int i;
+	cJSON *list_obj;
+	cJSON *val_obj;
 
-int codec_encode_hlth_faults_reg(char *buf, size_t buf_len, uint16_t addr, uint16_t app_idx,
-		uint16_t cid, uint8_t test_id, uint8_t *faults, size_t fault_count)
-{
-	return codec_encode_hlth_faults(buf, buf_len, false, addr, app_idx, cid, test_id, faults,
-			fault_count);
-}
+	list_obj = cJSON_GetObjectItem(obj, item);
+	*set = list_obj != NULL;
+	*count = 0;
 
-int codec_parse_hlth_period(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx)
-{
-	if (!codec_get_uint16(op_obj, JSON_STR_ADDR, addr) ||
-	    !codec_get_uint16(op_obj, JSON_STR_APP_IDX, app_idx)) {
+	if (list_obj == NULL) {
+		return 0;
+	}
+
+	if (!cJSON_IsArray(list_obj) || cJSON_GetArraySize(list_obj) > max) {
 		return -EINVAL;
 	}
 
+	for (i = 0; i < cJSON_GetArraySize(list_obj); i++) {
+		val_obj = cJSON_GetArrayItem(list_obj, i);
+
+		if (!cJSON_IsNumber(val_obj) || val_obj->valuedouble < 0 ||
+		    val_obj->valuedouble > UINT16_MAX) {
+			return -EINVAL;
+		}
+
+		vals[(*count)++] = (uint16_t)val_obj->valuedouble;
+	}
+
 	return 0;
 }
 
-int codec_parse_hlth_period_set(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx, uint8_t *div)
+static bool parse_desired_pub(cJSON *pub_obj, struct bt_mesh_cfg_mod_pub *pub)
 {
-	if (!codec_get_uint8(op_obj, JSON_STR_DIV, div)) {
-		return -EINVAL;
+	char *units;
+	uint8_t period;
+	uint8_t count;
+	uint16_t interval;
+
+	if (!codec_get_uint16(pub_obj, JSON_STR_ADDR, &pub->addr) ||
+	    !codec_get_uint16(pub_obj, JSON_STR_APP_IDX, &pub->app_idx) ||
+	    !codec_get_bool(pub_obj, JSON_STR_FRIEND_CRED_FLAG, &pub->cred_flag) ||
+	    !codec_get_uint8(pub_obj, JSON_STR_TTL, &pub->ttl) ||
+	    !codec_get_uint8(pub_obj, JSON_STR_PERIOD, &period) ||
+	    !codec_get_str(pub_obj, JSON_STR_PERIOD_UNITS, &units) ||
+	    !codec_get_uint8(pub_obj, JSON_STR_TX_COUNT, &count) ||
+	    !codec_get_uint16(pub_obj, JSON_STR_TX_INT, &interval)) {
+		return false;
 	}
 
-	return codec_parse_hlth_period(op_obj, addr, app_idx);
+	pub->transmit = BT_MESH_TRANSMIT(count, interval);
+
+	return parse_pub_period(units, period, &pub->period);
 }
 
-int codec_encode_hlth_period(char *buf, size_t buf_len, uint16_t addr, uint8_t div)
+static int parse_desired_model(cJSON *model_obj, struct reconcile_model *model)
 {
 	int err;
-	cJSON *hlth_period_obj;
-	cJSON *event_obj;
+	cJSON *pub_obj;
 
-	if (!codec_init_event(&hlth_period_obj, &event_obj, "health_period")) {
-		return -ENOMEM;
+	memset(model, 0, sizeof(*model));
+	model->company_id = BT_MESH_CID_NVAL;
+	codec_get_uint8(model_obj, JSON_STR_ELEM_IDX, &model->elem_idx);
+	codec_get_uint16(model_obj, JSON_STR_CID, &model->company_id);
+
+	if (!codec_get_uint16(model_obj, JSON_STR_MOD_ID, &model->model_id)) {
+		return -EINVAL;
 	}
 
-	err = -ENOMEM;
+	err = parse_idx_list(model_obj, JSON_STR_APP_IDXS, model->appkey_idxs,
+			ARRAY_SIZE(model->appkey_idxs), &model->appkeys_set, &model->appkey_count);
 
-	if (cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, addr) == NULL) {
-		goto cleanup;
+	if (err) {
+		return err;
 	}
 
-	if (cJSON_AddNumberToObject(event_obj, JSON_STR_DIV, div) == NULL) {
-		goto cleanup;
-	}
+	err = parse_idx_list(model_obj, JSON_STR_SUB_ADDRS, model->sub_addrs,
+			ARRAY_SIZE(model->sub_addrs), &model->subs_set, &model->sub_addr_count);
 
-	if (!cJSON_PrintPreallocated(hlth_period_obj, buf, buf_len, 0)) {
-		goto cleanup;
+	if (err) {
+		return err;
 	}
 
-	err = 0;
+	pub_obj = cJSON_GetObjectItem(model_obj, JSON_STR_PUB_PARAMS);
+	model->pub_set = pub_obj != NULL;
 
-cleanup:
-	cJSON_Delete(hlth_period_obj);
-	return err;
+	if (model->pub_set && !parse_desired_pub(pub_obj, &model->pub)) {
+		return -EINVAL;
+	}
+
+	return 0;
 }
 
-int codec_parse_hlth_attn(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx)
+static int parse_desired_features(cJSON *desired_obj, struct reconcile_state *state)
 {
-	if (!codec_get_uint16(op_obj, JSON_STR_ADDR, addr) ||
-	    !codec_get_uint16(op_obj, JSON_STR_APP_IDX, app_idx)) {
-		return -EINVAL;
+	uint8_t count;
+	uint16_t interval;
+	cJSON *feature_obj;
+
+	state->beacon_set = codec_get_bool(desired_obj, JSON_STR_NET_BEACON, &state->beacon);
+	state->ttl_set = codec_get_uint8(desired_obj, JSON_STR_TTL, &state->ttl);
+
+	feature_obj = cJSON_GetObjectItem(desired_obj, JSON_STR_RELAY);
+
+	if (feature_obj != NULL) {
+		state->relay_set = codec_get_bool(feature_obj, JSON_STR_STATE, &state->relay);
+		state->relay_transmit_set =
+			codec_get_uint8(feature_obj, JSON_STR_TX_COUNT, &count) &&
+			codec_get_uint16(feature_obj, JSON_STR_TX_INT, &interval);
+
+		if (!state->relay_set) {
+			return -EINVAL;
+		}
+
+		if (state->relay_transmit_set) {
+			state->relay_transmit = BT_MESH_TRANSMIT(count, interval);
+		}
 	}
 
-	return 0;
+	feature_obj = cJSON_GetObjectItem(desired_obj, JSON_STR_PROXY);
+
+	if (feature_obj != NULL) {
+		state->proxy_set = codec_get_bool(feature_obj, JSON_STR_STATE, &state->proxy);
+
+		if (!state->proxy_set) {
+			return -EINVAL;
+		}
+	}
+
+	feature_obj = cJSON_GetObjectItem(desired_obj, JSON_STR_FRIEND);
+
+	if (feature_obj != NULL) {
+		state->friend_set = codec_get_bool(feature_obj, JSON_STR_STATE, &state->friend);
+
+		if (!state->friend_set) {
+			return -EINVAL;
+		}
+	}
+
+	return parse_idx_list(desired_obj, JSON_STR_SUBNETS, state->subnet_idxs,
+			ARRAY_SIZE(state->subnet_idxs), &state->subnets_set, &state->subnet_count);
 }
 
-int codec_parse_hlth_attn_set(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx, uint8_t *attn)
+static int parse_desired_addrs(cJSON *op_obj, uint16_t **addrs, size_t *addr_count)
 {
-	if (!codec_get_uint8(op_obj, JSON_STR_ATTN, attn)) {
+	int i;
+	int count;
+	cJSON *addr_list_obj;
+	cJSON *addr_obj;
+
+	addr_list_obj = cJSON_GetObjectItem(op_obj, JSON_STR_ADDR_LIST);
+	count = cJSON_GetArraySize(addr_list_obj);
+
+	if (count == 0 || count > CONFIG_GATEWAY_RECONCILE_MAX_NODES) {
 		return -EINVAL;
 	}
 
-	return codec_parse_hlth_attn(op_obj, addr, app_idx);
+	*addrs = k_malloc(sizeof(uint16_t) * count);
+
+	if (*addrs == NULL) {
+		return -ENOMEM;
+	}
+
+	*addr_count = count;
+
+	for (i = 0; i < count; i++) {
+		addr_obj = cJSON_GetArrayItem(addr_list_obj, i);
+
+		if (!codec_get_uint16(addr_obj, JSON_STR_ADDR, &(*addrs)[i]) ||
+		    !BT_MESH_ADDR_IS_UNICAST((*addrs)[i])) {
+			k_free(*addrs);
+			*addrs = NULL;
+			return -EINVAL;
+		}
+	}
+
+	return 0;
 }
 
-int codec_encode_hlth_attn(char *buf, size_t buf_len, uint16_t addr, uint8_t attn)
+int codec_parse_reconcile_state(cJSON *op_obj, struct reconcile_state *state, uint16_t **addrs,
+		size_t *addr_count)
 {
+	int i;
 	int err;
-	cJSON *hlth_attn_obj;
-	cJSON *event_obj;
+	char *name;
+	cJSON *desired_obj;
+	cJSON *models_obj;
 
-	if (!codec_init_event(&hlth_attn_obj, &event_obj, "health_attention")) {
-		return -ENOMEM;
+	memset(state, 0, sizeof(*state));
+	*addrs = NULL;
+	desired_obj = cJSON_GetObjectItem(op_obj, JSON_STR_DESIRED_STATE);
+
+	if (!codec_get_str(op_obj, JSON_STR_NAME, &name) || name[0] == '\0' ||
+	    strlen(name) > RECONCILE_NAME_LEN || !cJSON_IsObject(desired_obj)) {
+		return -EINVAL;
 	}
 
-	err = -ENOMEM;
+	strcpy(state->name, name);
+	err = parse_desired_features(desired_obj, state);
 
-	if (cJSON_AddNumberToObject(event_obj, JSON_STR_ADDR, addr) == NULL) {
-		goto cleanup;
+	if (err) {
+		return err;
 	}
 
-	if (cJSON_AddNumberToObject(event_obj, JSON_STR_ATTN, attn) == NULL) {
-		goto cleanup;
+	models_obj = cJSON_GetObjectItem(desired_obj, JSON_STR_MODELS);
+
+	if (models_obj != NULL && !cJSON_IsArray(models_obj)) {
+		return -EINVAL;
 	}
 
-	if (!cJSON_PrintPreallocated(hlth_attn_obj, buf, buf_len, 0)) {
-		goto cleanup;
+	state->model_count = cJSON_GetArraySize(models_obj);
+
+	if (state->model_count) {
+		state->models = k_malloc(sizeof(*state->models) * state->model_count);
+
+		if (state->models == NULL) {
+			return -ENOMEM;
+		}
 	}
 
-	err = 0;
+	for (i = 0; !err && i < state->model_count; i++) {
+		err = parse_desired_model(cJSON_GetArrayItem(models_obj, i), &state->models[i]);
+	}
+
+	if (!err) {
+		err = parse_desired_addrs(op_obj, addrs, addr_count);
+	}
+
+	if (err) {
+		k_free(state->models);
+		state->models = NULL;
+	}
 
-cleanup:
-	cJSON_Delete(hlth_attn_obj);
 	return err;
 }
 
-int codec_parse_hlth_timeout(cJSON *op_obj, int32_t *timeout)
+int codec_parse_reconcile_name(cJSON *op_obj, char **name)
 {
-	if (!codec_get_int32(op_obj, JSON_STR_TIMEOUT, timeout)) {
+	if (!codec_get_str(op_obj, JSON_STR_NAME, name)) {
 		return -EINVAL;
 	}
 
 	return 0;
 }
 
-int codec_encode_hlth_timeout(char *buf, size_t buf_len, int32_t timeout)
+/* Only nodes that failed are listed, up to CONFIG_GATEWAY_RECONCILE_REPORT_MAX of them */
+static bool encode_reconcile_failed(cJSON *state_obj, size_t state_idx)
+{
+	int ret;
+	size_t i;
+	size_t count;
+	cJSON *nodes_obj;
+	cJSON *node_obj;
+	struct reconcile_node_status status;
+
+	nodes_obj = cJSON_AddArrayToObject(state_obj, JSON_STR_FAILED_NODES);
+
+	if (nodes_obj == NULL) {
+		return false;
+	}
+
+	count = 0;
+
+	for (i = 0; count < CONFIG_GATEWAY_RECONCILE_REPORT_MAX &&
+			(ret = reconcile_node_get(i, &status)) != -EINVAL; i++) {
+		if (ret || status.state_idx != state_idx || status.state != RECONCILE_FAILED) {
+			continue;
+		}
+
+		node_obj = cJSON_CreateObject();
+
+		if (node_obj == NULL) {
+			return false;
+		}
+
+		cJSON_AddItemToArray(nodes_obj, node_obj);
+		count++;
+
+		if (cJSON_AddNumberToObject(node_obj, JSON_STR_ADDR, status.addr) == NULL ||
+		    cJSON_AddNumberToObject(node_obj, JSON_STR_ERR, status.err) == NULL ||
+		    cJSON_AddNumberToObject(node_obj, JSON_STR_STATUS, status.status) == NULL ||
+		    cJSON_AddNumberToObject(node_obj, JSON_STR_RETRY_COUNT,
+			    status.failures) == NULL) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int codec_encode_reconcile_status(char *buf, size_t buf_len)
 {
 	int err;
-	cJSON *hlth_timeout_obj;
+	int ret;
+	size_t i;
+	cJSON *status_obj;
 	cJSON *event_obj;
+	cJSON *states_obj;
+	cJSON *state_obj;
+	struct reconcile_summary summary;
 
-	if (!codec_init_event(&hlth_timeout_obj, &event_obj, "health_client_timeout")) {
+	if (!codec_init_event(&status_obj, &event_obj, "node_desired_state_status")) {
 		return -ENOMEM;
 	}
 
 	err = -ENOMEM;
+	states_obj = cJSON_AddArrayToObject(event_obj, JSON_STR_DESIRED_STATES);
 
-	if (cJSON_AddNumberToObject(event_obj, JSON_STR_TIMEOUT, timeout) == NULL) {
+	if (states_obj == NULL) {
 		goto cleanup;
 	}
 
-	if (!cJSON_PrintPreallocated(hlth_timeout_obj, buf, buf_len, 0)) {
+	for (i = 0; (ret = reconcile_summary_get(i, &summary)) != -EINVAL; i++) {
+		/* Unused slot */
+		if (ret) {
+			continue;
+		}
+
+		state_obj = cJSON_CreateObject();
+
+		if (state_obj == NULL) {
+			goto cleanup;
+		}
+
+		cJSON_AddItemToArray(states_obj, state_obj);
+
+		if (cJSON_AddStringToObject(state_obj, JSON_STR_NAME, summary.name) == NULL ||
+		    cJSON_AddNumberToObject(state_obj, JSON_STR_NODE_COUNT,
+			    summary.node_count) == NULL ||
+		    cJSON_AddNumberToObject(state_obj, JSON_STR_CONVERGED_COUNT,
+			    summary.converged) == NULL ||
+		    cJSON_AddNumberToObject(state_obj, JSON_STR_PENDING_COUNT,
+			    summary.pending) == NULL ||
+		    cJSON_AddNumberToObject(state_obj, JSON_STR_FAIL_COUNT, summary.failed) == NULL ||
+		    cJSON_AddNumberToObject(state_obj, JSON_STR_DRIFT_COUNT, summary.drift) == NULL ||
+		    cJSON_AddNumberToObject(state_obj, JSON_STR_OP_COUNT, summary.ops) == NULL ||
+		    (summary.failed && !encode_reconcile_failed(state_obj, i))) {
+			goto cleanup;
+		}
+	}
+
+	if (!codec_print(status_obj, buf, buf_len)) {
 		goto cleanup;
 	}
 
-	err= 0;
+	err = 0;
 
 cleanup:
-	cJSON_Delete(hlth_timeout_obj);
+	cJSON_Delete(status_obj);
 	return err;
 }
+#endif // defined(CONFIG_GATEWAY_RECONCILE)
+
+/* Preset dictionary for uplink compression. The cloud rebuilds the same byte sequence to
+ * inflate, so entries may only be appended, and any change is a new CODEC_DICT_ID. The
+ * envelope fragments are stored verbatim, keys as "key":. */
+#define DICT_ENVELOPE(X) \
+	X("{\"type\":\"event\",\"gatewayId\":\"") \
+	X("\",\"event\":{\"type\":\"") \
+	X("\",\"timestamp\":\"") \
+	X("\"deviceType\":\"BT-Mesh\"")
+
+#define DICT_KEYS(X) \
+	X(JSON_STR_OOB_INFO) \
+	X(JSON_STR_URI_HASH) \
+	X(JSON_STR_ERR) \
+	X(JSON_STR_SUPPORT) \
+	X(JSON_STR_UUID) \
+	X(JSON_STR_NET_IDX) \
+	X(JSON_STR_APP_IDX) \
+	X(JSON_STR_APP_IDXS) \
+	X(JSON_STR_PUB_PARAMS) \
+	X(JSON_STR_ADDR) \
+	X(JSON_STR_ADDR_LIST) \
+	X(JSON_STR_ATTN) \
+	X(JSON_STR_NET_KEY) \
+	X(JSON_STR_APP_KEY) \
+	X(JSON_STR_TEST_ID) \
+	X(JSON_STR_DIV) \
+	X(JSON_STR_TIMEOUT) \
+	X(JSON_STR_STATE) \
+	X(JSON_STR_TTL) \
+	X(JSON_STR_TX_COUNT) \
+	X(JSON_STR_TX_INT) \
+	X(JSON_STR_MOD_ID) \
+	X(JSON_STR_ELEM_ADDR) \
+	X(JSON_STR_ELEM_COUNT) \
+	X(JSON_STR_PUB_ADDR) \
+	X(JSON_STR_SUB_ADDR) \
+	X(JSON_STR_SUB_ADDRS) \
+	X(JSON_STR_SRC_ADDR) \
+	X(JSON_STR_DST_ADDR) \
+	X(JSON_STR_CID) \
+	X(JSON_STR_FRIEND_CRED_FLAG) \
+	X(JSON_STR_PERIOD) \
+	X(JSON_STR_PERIOD_UNITS) \
+	X(JSON_STR_COUNT) \
+	X(JSON_STR_MIN_HOPS) \
+	X(JSON_STR_MAX_HOPS) \
+	X(JSON_STR_RELAY) \
+	X(JSON_STR_PROXY) \
+	X(JSON_STR_FRIEND) \
+	X(JSON_STR_LPN) \
+	X(JSON_STR_PAYLOAD) \
+	X(JSON_STR_OPCODE) \
+	X(JSON_STR_BYTE) \
+	X(JSON_STR_MSG_ID)
+
+#define DICT_FRAGMENT(str) str,
+#define DICT_FRAGMENT_LEN(str) (sizeof(str) - 1) +
+#define DICT_KEY_LEN(key) (sizeof(key) - 1 + 3) +
+#define DICT_LEN (DICT_ENVELOPE(DICT_FRAGMENT_LEN) DICT_KEYS(DICT_KEY_LEN) 0)
+
+static const char *const dict_envelope[] = { DICT_ENVELOPE(DICT_FRAGMENT) };
+static const char *const dict_keys[] = { DICT_KEYS(DICT_FRAGMENT) };
+
+#if defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+/* The dictionary is never truncated, a truncated one would not match the cloud's */
+BUILD_ASSERT(DICT_LEN <= CONFIG_GATEWAY_UPLINK_COMPRESSION_DICT_SIZE);
+#endif // defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+
+size_t codec_build_dict(uint8_t *dict, size_t dict_len)
+{
+	size_t i;
+	size_t len;
+	size_t pos;
+
+	if (dict_len < DICT_LEN) {
+		return 0;
+	}
+
+	pos = 0;
+
+	for (i = 0; i < ARRAY_SIZE(dict_envelope); i++) {
+		len = strlen(dict_envelope[i]);
+		memcpy(&dict[pos], dict_envelope[i], len);
+		pos += len;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(dict_keys); i++) {
+		len = strlen(dict_keys[i]);
+		dict[pos++] = '"';
+		memcpy(&dict[pos], dict_keys[i], len);
+		pos += len;
+		dict[pos++] = '"';
+		dict[pos++] = ':';
+	}
+
+	return pos;
+}
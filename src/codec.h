@@ -9,17 +9,71 @@ extern "C" {
 #include <cJSON.h>
 #include <cJSON_os.h>
 
+#include "beacon_events.h"
 #include "btmesh.h"
+#include "cfg_txn.h"
+#include "fanout.h"
+#include "model_decode.h"
+#include "prov_allow.h"
+#include "prov_profile.h"
+#include "prov_queue.h"
+#include "reconcile.h"
+#include "sub_set.h"
+#include "sweep.h"
+#include "uplink_rules.h"
 #include "util.h"
 
 
-int codec_encode_beacon_list(char *buf, size_t buf_len);
+/* Position in a paged list response. The caller sets cursor (and index for the first page)
+ * and the encoder fills in total, advances cursor past the last item sent and sets more if
+ * another page is needed. */
+struct codec_page {
+        uint16_t index;
+        uint16_t cursor;
+        uint16_t total;
+        bool more;
+};
+
+/* Per message type encode cost, see CONFIG_GATEWAY_CODEC_STATS */
+struct codec_stats {
+        const char *type;
+        uint32_t count;
+        uint32_t fail_count;
+        uint32_t bytes;
+        uint32_t total_us;
+        uint32_t max_us;
+};
+
+int codec_parse_cursor(cJSON *op_obj, uint16_t *cursor);
+
+int codec_encode_beacon_list(char *buf, size_t buf_len, struct codec_page *page);
+
+int codec_parse_beacon_events(cJSON *op_obj, bool *enable);
+
+/* Encodes the found, or the lost, beacons of a batch as one event */
+int codec_encode_beacon_events(char *buf, size_t buf_len, const struct beacon_event *events,
+		size_t count, bool found, bool overflow);
+
+/* Allocates *uuids, to be released with k_free() */
+int codec_parse_beacon_block(cJSON *op_obj, uint8_t (**uuids)[UUID_LEN], size_t *count);
+
+int codec_encode_beacon_block_result(char *buf, size_t buf_len, int block_err, size_t changed,
+		size_t total);
+
+int codec_encode_beacon_blocklist(char *buf, size_t buf_len, struct codec_page *page);
 
 int codec_encode_prov_result(char *buf, size_t buf_len, int prov_err, uint16_t net_idx,
         uint8_t uuid[UUID_LEN], uint16_t addr, uint8_t num_elem);
 
+/* profile is NULL if the request does not name a provisioning profile */
 int codec_parse_prov(cJSON *op_obj, uint8_t uuid[UUID_LEN], uint16_t *net_idx, uint16_t *addr,
-		uint8_t *attn);
+		uint8_t *attn, char **profile);
+
+/* Allocates *devs, to be released with k_free() */
+int codec_parse_prov_bulk(cJSON *op_obj, struct prov_queue_dev **devs, size_t *dev_count);
+
+int codec_encode_prov_queue_status(char *buf, size_t buf_len,
+		const struct prov_queue_stats *stats);
 
 int codec_encode_subnet_list(char *buf, size_t buf_len);
 
@@ -34,23 +88,62 @@ int codec_parse_app_key(cJSON *op_obj, uint16_t *net_idx, uint16_t *app_idx);
 int codec_parse_app_key_add(cJSON *op_obj, uint16_t *net_idx, uint16_t *app_idx,
 		uint8_t app_key[KEY_LEN]);
 
-int codec_parse_node_disc(cJSON *op_obj, uint16_t *addr);
+int codec_parse_node_disc(cJSON *op_obj, uint16_t *addr, bool *refresh);
 
-int codec_encode_node_list(char *buf, size_t buf_len);
+int codec_encode_node_list(char *buf, size_t buf_len, struct codec_page *page);
 
 int codec_encode_node_disc(char *buf, size_t buf_len, struct btmesh_node *node, int disc_err,
-        uint8_t status);
+        uint8_t status, struct codec_page *page);
+
+int codec_parse_node_cfg(cJSON *op_obj, uint16_t *addr, enum btmesh_op *op,
+                union btmesh_op_args *args);
+
+/* model is the state of the model the operation acted on, or NULL */
+int codec_encode_node_cfg(char *buf, size_t buf_len, uint16_t addr, enum btmesh_op op,
+                const union btmesh_op_args *args, int op_err, uint32_t cfg_version,
+                const struct btmesh_model_state *model);
+
+/* Allocates txn->steps, to be released with k_free() */
+int codec_parse_node_cfg_txn(cJSON *op_obj, struct cfg_txn *txn);
+
+int codec_encode_node_cfg_txn(char *buf, size_t buf_len, const struct cfg_txn *txn,
+		int txn_err, uint32_t cfg_version);
+
+/* steps is allocated by cJSON and released with cJSON_free() */
+int codec_parse_prov_profile(cJSON *op_obj, struct prov_profile_info *info, char **steps);
+
+int codec_parse_prov_profile_name(cJSON *op_obj, char **name);
+
+/* Allocates txn->steps, to be released with k_free() */
+int codec_parse_prov_profile_steps(const char *steps, uint16_t addr, struct cfg_txn *txn);
+
+int codec_encode_prov_profile_list(char *buf, size_t buf_len);
+
+/* Allocates *entries, to be released with k_free() */
+int codec_parse_prov_allow(cJSON *op_obj, struct prov_allow_entry **entries, size_t *count);
 
-int codec_parse_node_cfg(cJSON *op_obj, uint16_t* addr);
+int codec_encode_prov_allow_list(char *buf, size_t buf_len);
 
-int codec_parse_subscribe_addrs(cJSON *op_obj, uint16_t **addr_list, int *addr_count);
+/* Allocates *rules, to be released with k_free(). An empty list gives no rules. */
+int codec_parse_uplink_rules(cJSON *op_obj, struct uplink_rule **rules, size_t *count);
 
-int codec_encode_subscribe_list(char *buf, size_t buf_len);
+int codec_encode_uplink_rules(char *buf, size_t buf_len, struct codec_page *page);
+
+int codec_encode_node_ready(char *buf, size_t buf_len, const uint8_t uuid[UUID_LEN],
+		uint16_t net_idx, uint16_t addr, uint8_t num_elem, const char *profile,
+		const struct cfg_txn *txn, int txn_err, uint32_t cfg_version);
+
+/* Allocates *ranges, to be released with k_free() */
+int codec_parse_subscribe_addrs(cJSON *op_obj, struct sub_range **ranges, size_t *count);
+
+int codec_encode_subscribe_list(char *buf, size_t buf_len, struct codec_page *page);
 
 int codec_parse_model_msg(cJSON *op_obj, struct bt_mesh_msg_ctx *ctx, struct net_buf_simple *buf);
 
+/* decoded is NULL for a message sent raw only */
 int codec_encode_model_msg(char *buf, size_t buf_len, uint32_t opcode, struct bt_mesh_msg_ctx *ctx,
-                uint8_t *payload, size_t payload_len);
+                uint8_t *payload, size_t payload_len, int64_t recv_time,
+                const struct model_decoded *decoded);
 
 int codec_parse_hlth_fault(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx, uint16_t *cid);
 
@@ -58,7 +151,7 @@ int codec_parse_hlth_fault_test(cJSON *op_obj, uint16_t *addr, uint16_t *app_idx
 		uint8_t *test_id);
 
 int codec_encode_hlth_faults_cur(char *buf, size_t buf_len, uint16_t addr, uint16_t cid,
-		uint8_t test_id, uint8_t *faults, size_t fault_count);
+		uint8_t test_id, uint8_t *faults, size_t fault_count, int64_t recv_time);
 
 int codec_encode_hlth_faults_reg(char *buf, size_t buf_len, uint16_t addr, uint16_t app_idx,
 		uint16_t cid, uint8_t test_id, uint8_t *faults, size_t fault_count);
@@ -79,6 +172,46 @@ int codec_parse_hlth_timeout(cJSON *op_obj, int32_t *timeout);
 
 int codec_encode_hlth_timeout(char *buf, size_t buf_len, int32_t timeout);
 
+int codec_parse_mesh_stats(cJSON *op_obj, bool *reset);
+
+int codec_encode_mesh_stats(char *buf, size_t buf_len);
+
+int codec_parse_sweep_start(cJSON *op_obj, struct sweep_params *params);
+
+int codec_encode_sweep_progress(char *buf, size_t buf_len, const struct sweep_status *status,
+		size_t queue_depth, uint32_t latency_ms, uint16_t addr, int node_err,
+		uint8_t node_status);
+
+/* Allocates req->addrs if the request lists nodes, to be released with k_free() */
+int codec_parse_node_cfg_fanout(cJSON *op_obj, struct fanout_req *req);
+
+int codec_encode_fanout_node(char *buf, size_t buf_len, const struct fanout_result *res);
+
+int codec_encode_fanout_progress(char *buf, size_t buf_len, const struct fanout_status *status);
+
+/* Allocates state->models and *addrs, to be released with k_free() */
+int codec_parse_reconcile_state(cJSON *op_obj, struct reconcile_state *state, uint16_t **addrs,
+		size_t *addr_count);
+
+int codec_parse_reconcile_name(cJSON *op_obj, char **name);
+
+int codec_encode_reconcile_status(char *buf, size_t buf_len);
+
+/* Sample the UNIX time offset of event timestamps again */
+void codec_epoch_reset(void);
+
+/* Identifies the preset dictionary built by codec_build_dict() in compressed uplinks */
+#define CODEC_DICT_ID 1
+
+/* Returns the dictionary length, 0 if it does not fit */
+size_t codec_build_dict(uint8_t *dict, size_t dict_len);
+
+void codec_stats_record(const char *type, uint32_t cycles, size_t bytes, bool ok);
+
+int codec_stats_get(size_t idx, struct codec_stats *stats);
+
+void codec_stats_reset(void);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,212 @@
+#include <zephyr.h>
+#include <string.h>
+#include <sys/byteorder.h>
+#include <logging/log.h>
+
+#include "compress.h"
+
+/* LZSS with a preset dictionary. The match window is the dictionary followed by the input,
+ * so even the first occurrence of a JSON key in a message can be encoded as a back
+ * reference into the dictionary.
+ *
+ * Stream layout after the header: groups of one flag byte followed by up to 8 items. Flag
+ * bit n (LSB first) set means item n is a 2-byte match, clear means a 1-byte literal.
+ * Match: byte 0 = (distance - 1) & 0xff
+ *        byte 1 = ((distance - 1) >> 8) << 4 | (length - 3)
+ */
+#define MIN_MATCH 3
+#define MAX_MATCH (MIN_MATCH + 15)
+#define GROUP_LEN 8
+
+
+LOG_MODULE_REGISTER(app_compress, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+static uint8_t dict_id;
+static const uint8_t *dict;
+static size_t dict_len;
+static struct compress_stats stats;
+static struct k_spinlock stats_lock;
+
+static inline uint8_t byte_at(const uint8_t *src, size_t pos)
+{
+	return pos < dict_len ? dict[pos] : src[pos - dict_len];
+}
+
+static inline uint32_t hash(const uint8_t *src, size_t pos)
+{
+	uint32_t val;
+
+	val = byte_at(src, pos) | (byte_at(src, pos + 1) << 8) | (byte_at(src, pos + 2) << 16);
+	return (val * 2654435761U) >> (32 - COMPRESS_HASH_BITS);
+}
+
+static void stats_update(size_t src_len, size_t out_len, uint32_t cycles, bool skipped)
+{
+	k_spinlock_key_t key;
+	uint32_t us;
+
+	us = k_cyc_to_us_floor32(cycles);
+	key = k_spin_lock(&stats_lock);
+
+	if (skipped) {
+		stats.skip_count++;
+	} else {
+		stats.msg_count++;
+		stats.bytes_in += src_len;
+		stats.bytes_out += out_len;
+		stats.last_ratio = (out_len * 100) / src_len;
+	}
+
+	stats.last_us = us;
+	stats.total_us += us;
+
+	if (us > stats.max_us) {
+		stats.max_us = us;
+	}
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+int compress_encode(struct compress_ctx *ctx, const uint8_t *src, size_t src_len, uint8_t *dst,
+		size_t dst_len, size_t *out_len)
+{
+	size_t i;
+	size_t pos;
+	size_t end;
+	size_t out;
+	size_t len;
+	size_t cand;
+	size_t dist;
+	size_t flag_pos;
+	uint8_t flag_bit;
+	uint32_t h;
+	uint32_t start;
+
+	if (src_len == 0 || dict_len + src_len > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	/* Never hand back something larger than the plain message */
+	if (dst_len > src_len) {
+		dst_len = src_len;
+	}
+
+	if (dst_len <= COMPRESS_HDR_LEN) {
+		return -E2BIG;
+	}
+
+	start = k_cycle_get_32();
+	memset(ctx->hash_table, 0, sizeof(ctx->hash_table));
+
+	for (pos = 0; pos + MIN_MATCH <= dict_len; pos++) {
+		ctx->hash_table[hash(src, pos)] = pos + 1;
+	}
+
+	dst[0] = COMPRESS_MAGIC;
+	dst[1] = COMPRESS_VERSION;
+	dst[2] = dict_id;
+	sys_put_le16(dict_len, &dst[3]);
+	sys_put_le16(src_len, &dst[5]);
+	out = COMPRESS_HDR_LEN;
+	pos = dict_len;
+	end = dict_len + src_len;
+	flag_pos = 0;
+	flag_bit = GROUP_LEN;
+
+	while (pos < end) {
+		if (flag_bit == GROUP_LEN) {
+			if (out >= dst_len) {
+				goto overflow;
+			}
+
+			flag_pos = out++;
+			dst[flag_pos] = 0;
+			flag_bit = 0;
+		}
+
+		len = 0;
+		dist = 0;
+
+		if (pos + MIN_MATCH <= end) {
+			h = hash(src, pos);
+			cand = ctx->hash_table[h];
+			ctx->hash_table[h] = pos + 1;
+
+			if (cand) {
+				cand--;
+				dist = pos - cand;
+
+				while (dist <= COMPRESS_WINDOW_SIZE && len < MAX_MATCH &&
+						pos + len < end &&
+						byte_at(src, cand + len) == byte_at(src, pos + len)) {
+					len++;
+				}
+			}
+		}
+
+		if (len >= MIN_MATCH) {
+			if (out + 2 > dst_len) {
+				goto overflow;
+			}
+
+			dst[flag_pos] |= BIT(flag_bit);
+			dst[out++] = (dist - 1) & 0xff;
+			dst[out++] = (((dist - 1) >> 8) << 4) | (len - MIN_MATCH);
+
+			for (i = 1; i < len && pos + i + MIN_MATCH <= end; i++) {
+				ctx->hash_table[hash(src, pos + i)] = pos + i + 1;
+			}
+
+			pos += len;
+		} else {
+			if (out >= dst_len) {
+				goto overflow;
+			}
+
+			dst[out++] = src[pos - dict_len];
+			pos++;
+		}
+
+		flag_bit++;
+	}
+
+	if (out >= src_len) {
+		goto overflow;
+	}
+
+	stats_update(src_len, out, k_cycle_get_32() - start, false);
+	*out_len = out;
+	return 0;
+
+overflow:
+	stats_update(src_len, 0, k_cycle_get_32() - start, true);
+	return -E2BIG;
+}
+
+void compress_get_stats(struct compress_stats *out)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&stats_lock);
+	memcpy(out, &stats, sizeof(stats));
+	k_spin_unlock(&stats_lock, key);
+}
+
+int compress_init(uint8_t _dict_id, const uint8_t *_dict, size_t _dict_len)
+{
+	if (_dict == NULL && _dict_len) {
+		return -EINVAL;
+	}
+
+	if (_dict_len > COMPRESS_WINDOW_SIZE) {
+		LOG_ERR("Compression dictionary too large: %d", _dict_len);
+		return -EINVAL;
+	}
+
+	dict_id = _dict_id;
+	dict = _dict;
+	dict_len = _dict_len;
+	LOG_DBG("Compression dictionary %d: %d bytes", dict_id, dict_len);
+
+	return 0;
+}
@@ -0,0 +1,51 @@
+#ifndef COMPRESS_H_
+#define COMPRESS_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Compressed uplink header. The first byte can never start a JSON document, so the cloud
+ * can tell compressed and plain uplinks apart without any extra transport metadata. The
+ * header also names the preset dictionary and its length, so the cloud can check that it
+ * inflates with the same one. */
+#define COMPRESS_MAGIC 0x1F
+#define COMPRESS_VERSION 2
+#define COMPRESS_HDR_LEN 7
+#define COMPRESS_WINDOW_SIZE 4096
+#define COMPRESS_HASH_BITS 10
+
+/* Match finder state, owned by one compress_encode() call at a time */
+struct compress_ctx {
+	uint16_t hash_table[1 << COMPRESS_HASH_BITS];
+};
+
+struct compress_stats {
+	uint32_t msg_count;
+	uint32_t skip_count;
+	uint32_t bytes_in;
+	uint32_t bytes_out;
+	uint32_t last_ratio;
+	uint32_t last_us;
+	uint32_t max_us;
+	uint32_t total_us;
+};
+
+int compress_init(uint8_t dict_id, const uint8_t *dict, size_t dict_len);
+
+int compress_encode(struct compress_ctx *ctx, const uint8_t *src, size_t src_len, uint8_t *dst,
+		size_t dst_len, size_t *out_len);
+
+void compress_get_stats(struct compress_stats *stats);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* COMPRESS_H_ */
@@ -0,0 +1,322 @@
+#include <zephyr.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+#include <logging/log.h>
+
+#include "btmesh.h"
+#include "gateway.h"
+#include "fanout.h"
+#include "node_pool.h"
+
+#define FANOUT_WORKER_PRIORITY 7
+
+
+LOG_MODULE_REGISTER(app_fanout, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+K_MUTEX_DEFINE(fanout_lock);
+
+static struct fanout_req req;
+static struct fanout_status fanout;
+/* Model the operation acts on, if it is a model operation */
+static bool model_op;
+static uint16_t op_model_id;
+static uint16_t op_company_id;
+static bool cancel;
+/* Next entry of req.addrs, or the address of the last CDB node handed to a worker */
+static size_t next_idx;
+static uint16_t cursor;
+
+static bool net_idx_match(uint16_t net_idx)
+{
+	return !req.filter.net_idx_set || req.filter.net_idx == net_idx;
+}
+
+static uint8_t count_node(struct bt_mesh_cdb_node *node, void *count)
+{
+	if (net_idx_match(node->net_idx)) {
+		(*(uint32_t *)count)++;
+	}
+
+	return BT_MESH_CDB_ITER_CONTINUE;
+}
+
+static bool cdb_node_match(const struct bt_mesh_cdb_node *node, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	return net_idx_match(node->net_idx);
+}
+
+/* Returns false once the fan-out is over */
+static bool next_node(uint16_t *addr)
+{
+	uint16_t next;
+
+	next = BT_MESH_ADDR_UNASSIGNED;
+	k_mutex_lock(&fanout_lock, K_FOREVER);
+
+	if (cancel) {
+		/* Nothing more to start */
+	} else if (req.addrs != NULL) {
+		if (next_idx < req.addr_count) {
+			next = req.addrs[next_idx++];
+		}
+	} else {
+		next = node_pool_cdb_next(cursor, cdb_node_match, NULL);
+	}
+
+	if (next != BT_MESH_ADDR_UNASSIGNED) {
+		cursor = next;
+		fanout.active++;
+	}
+
+	k_mutex_unlock(&fanout_lock);
+
+	*addr = next;
+	return next != BT_MESH_ADDR_UNASSIGNED;
+}
+
+static bool elem_has_model(const struct btmesh_elem *elem, uint16_t model_id,
+		uint16_t company_id)
+{
+	size_t i;
+
+	if (company_id == BT_MESH_CID_NVAL) {
+		for (i = 0; i < elem->sig_model_count; i++) {
+			if (elem->sig_models[i].model_id == model_id) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	for (i = 0; i < elem->vnd_model_count; i++) {
+		if (elem->vnd_models[i].company_id == company_id &&
+				elem->vnd_models[i].model_id == model_id) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool node_has_model(const struct btmesh_node *node, uint16_t model_id)
+{
+	size_t i;
+
+	for (i = 0; i < node->elem_count; i++) {
+		if (elem_has_model(&node->elems[i], model_id, BT_MESH_CID_NVAL)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void perform(union btmesh_op_args *args, struct fanout_result *res)
+{
+	res->err = btmesh_perform_cfg_op(req.op, args);
+	res->status = res->err ? 0 : btmesh_get_op_status(req.op, args);
+
+	if (!res->err && !res->status) {
+		res->elem_count++;
+	}
+}
+
+static void configure_elems(const struct btmesh_node *node, union btmesh_op_args *args,
+		struct fanout_result *res)
+{
+	size_t i;
+
+	for (i = 0; i < node->elem_count && !res->err && !res->status; i++) {
+		if (!elem_has_model(&node->elems[i], op_model_id, op_company_id)) {
+			continue;
+		}
+
+		/* Every model operation has the element address after net_idx, addr */
+		args->mod_app_bind.elem_addr = node->elems[i].addr;
+		perform(args, res);
+	}
+
+	res->skipped = !res->err && !res->status && res->elem_count == 0;
+}
+
+static void configure_node(uint16_t addr, struct fanout_result *res)
+{
+	struct bt_mesh_cdb_node *cdb_node;
+	struct btmesh_node node;
+	union btmesh_op_args args;
+
+	memset(res, 0, sizeof(*res));
+	res->op = req.op;
+	res->addr = addr;
+	cdb_node = bt_mesh_cdb_node_get(addr);
+
+	if (cdb_node == NULL) {
+		res->err = -ENOENT;
+		return;
+	}
+
+	if (!net_idx_match(cdb_node->net_idx)) {
+		res->skipped = true;
+		return;
+	}
+
+	args = req.args;
+	/* Every configuration operation starts with net_idx, addr */
+	args.node_reset.addr = addr;
+
+	if (!model_op && !req.filter.model_id_set && !req.filter.company_id_set) {
+		perform(&args, res);
+		return;
+	}
+
+	/* The composition is usually cached, so this rarely goes to the node */
+	node.addr = addr;
+	res->err = btmesh_get_node(&node, &res->status, false);
+
+	if (res->err || res->status) {
+		return;
+	}
+
+	if ((req.filter.company_id_set && node.cid != req.filter.company_id) ||
+			(req.filter.model_id_set && !node_has_model(&node, req.filter.model_id))) {
+		res->skipped = true;
+	} else if (model_op) {
+		configure_elems(&node, &args, res);
+	} else {
+		perform(&args, res);
+	}
+
+	btmesh_free_node(&node);
+}
+
+static void node_done(const struct fanout_result *res)
+{
+	k_mutex_lock(&fanout_lock, K_FOREVER);
+	fanout.active--;
+	fanout.done++;
+
+	if (res->err || res->status) {
+		fanout.failed++;
+	} else if (res->skipped) {
+		fanout.skipped++;
+	}
+
+	k_mutex_unlock(&fanout_lock);
+
+	if (res->err) {
+		LOG_WRN("Fan-out failed to configure 0x%04x. Error: %d", res->addr, res->err);
+	}
+}
+
+static void fanout_node(uint16_t addr)
+{
+	struct fanout_result res;
+
+	configure_node(addr, &res);
+	node_done(&res);
+	gateway_fanout_node(&res);
+}
+
+/* Called by the last worker with fanout_lock held */
+static void fanout_done(void)
+{
+	fanout.state = cancel ? FANOUT_CANCELLED : FANOUT_DONE;
+	LOG_INF("Fan-out %s: %d of %d nodes, %d failed, %d skipped",
+			fanout_state_str(fanout.state), fanout.done, fanout.total,
+			fanout.failed, fanout.skipped);
+	k_free(req.addrs);
+	req.addrs = NULL;
+	gateway_fanout_progress();
+}
+
+NODE_POOL_DEFINE(fanout_workers, CONFIG_GATEWAY_FANOUT_WORKERS, CONFIG_GATEWAY_FANOUT_STACK_SIZE,
+		FANOUT_WORKER_PRIORITY, fanout_lock, next_node, fanout_node, fanout_done);
+
+int fanout_start(struct fanout_req *_req)
+{
+	int count;
+	uint32_t total;
+	struct btmesh_model_state model;
+
+	k_mutex_lock(&fanout_lock, K_FOREVER);
+
+	if (node_pool_busy(&fanout_workers)) {
+		k_mutex_unlock(&fanout_lock);
+		k_free(_req->addrs);
+		return -EBUSY;
+	}
+
+	req = *_req;
+	model_op = !btmesh_get_op_model(req.op, &req.args, &model);
+	op_model_id = model.model_id;
+	op_company_id = model.company_id;
+
+	count = node_pool_start(&fanout_workers, req.concurrency);
+	req.concurrency = count;
+
+	memset(&fanout, 0, sizeof(fanout));
+	fanout.op = req.op;
+
+	if (req.addrs != NULL) {
+		fanout.total = req.addr_count;
+	} else {
+		bt_mesh_cdb_node_foreach(count_node, &fanout.total);
+	}
+
+	fanout.state = FANOUT_RUNNING;
+	cancel = false;
+	next_idx = 0;
+	cursor = BT_MESH_ADDR_UNASSIGNED;
+	total = fanout.total;
+
+	k_mutex_unlock(&fanout_lock);
+
+	LOG_INF("Fan-out of %s to %d nodes started, %d at a time", btmesh_get_op_str(req.op),
+			total, count);
+	gateway_fanout_progress();
+	node_pool_run(&fanout_workers, count);
+
+	return 0;
+}
+
+void fanout_cancel(void)
+{
+	k_mutex_lock(&fanout_lock, K_FOREVER);
+
+	if (node_pool_busy(&fanout_workers)) {
+		cancel = true;
+	}
+
+	k_mutex_unlock(&fanout_lock);
+}
+
+void fanout_status_get(struct fanout_status *status)
+{
+	k_mutex_lock(&fanout_lock, K_FOREVER);
+	*status = fanout;
+	k_mutex_unlock(&fanout_lock);
+}
+
+const char *fanout_state_str(enum fanout_state state)
+{
+	switch (state) {
+	case FANOUT_IDLE:
+		return "idle";
+	case FANOUT_RUNNING:
+		return "running";
+	case FANOUT_DONE:
+		return "done";
+	case FANOUT_CANCELLED:
+		return "cancelled";
+	default:
+		return "unknown";
+	}
+}
+
+void fanout_init(void)
+{
+	node_pool_init(&fanout_workers);
+}
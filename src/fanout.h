@@ -0,0 +1,88 @@
+#ifndef FANOUT_H_
+#define FANOUT_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "btmesh.h"
+
+enum fanout_state {
+	FANOUT_IDLE,
+	FANOUT_RUNNING,
+	FANOUT_DONE,
+	FANOUT_CANCELLED,
+};
+
+/* A node is configured only if it matches every filter that is set */
+struct fanout_filter {
+	bool net_idx_set;
+	uint16_t net_idx;
+	/* A SIG model the node must have on one of its elements */
+	bool model_id_set;
+	uint16_t model_id;
+	/* Company of the node, from its composition data */
+	bool company_id_set;
+	uint16_t company_id;
+};
+
+struct fanout_req {
+	enum btmesh_op op;
+	/* The node and, for model operations, element addresses are filled in per node */
+	union btmesh_op_args args;
+	/* Nodes to configure, or every node in the CDB if NULL. Must come from k_malloc(). */
+	uint16_t *addrs;
+	size_t addr_count;
+	struct fanout_filter filter;
+	/* Nodes configured at the same time */
+	uint8_t concurrency;
+};
+
+struct fanout_result {
+	enum btmesh_op op;
+	uint16_t addr;
+	int err;
+	uint8_t status;
+	/* Elements the operation was applied to, model operations apply to every element
+	 * with the model */
+	uint8_t elem_count;
+	/* The node did not match the filter or has no element with the model */
+	bool skipped;
+};
+
+struct fanout_status {
+	enum fanout_state state;
+	enum btmesh_op op;
+	uint32_t total;
+	uint32_t done;
+	uint32_t failed;
+	uint32_t skipped;
+	uint32_t active;
+};
+
+/* Apply req->op to every selected node. Every node is handed to gateway_fanout_node() once it
+ * is configured, and gateway_fanout_progress() is called whenever the fan-out changes state.
+ * Takes over req->addrs, also on error. Returns -EBUSY while a previous fan-out is running. */
+int fanout_start(struct fanout_req *req);
+
+/* Nodes that are being configured are finished, no new ones are started */
+void fanout_cancel(void);
+
+void fanout_status_get(struct fanout_status *status);
+
+const char *fanout_state_str(enum fanout_state state);
+
+void fanout_init(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* FANOUT_H_ */
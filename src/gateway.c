@@ -12,18 +12,36 @@
 #include "net/nrf_cloud.h"
 #include "net/cloud.h"
 
+#include "arena.h"
+#include "beacon_block.h"
+#include "beacon_events.h"
 #include "btmesh.h"
+#include "cfg_txn.h"
 #include "codec.h"
+#include "compress.h"
+#include "fanout.h"
+#include "mesh_retry.h"
+#include "model_decode.h"
+#include "prov_allow.h"
+#include "prov_profile.h"
+#include "prov_queue.h"
+#include "reconcile.h"
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+#include "rx_bus.h"
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+#include "sub_set.h"
+#include "sweep.h"
+#include "uplink_rules.h"
 #include "util.h"
 #include "nrf_cloud_transport.h"
 #include "gateway.h"
 
 
-#define PROV_TIMEOUT_SEC 60
 #define GATEWAY_PROC_THREAD_SLEEP_TIME_MS 500
 #define GATEWAY_PROC_THREAD_STACK_SIZE 5120
 #define GATEWAY_PROC_THREAD_PRIORITY 5
 #define GATEWAY_BUF_LEN 4096
+#define GATEWAY_PAGE_LEN MIN(CONFIG_GATEWAY_PAGE_SIZE, GATEWAY_BUF_LEN)
 #define ERR_STR "ERROR: "
 
 
@@ -88,13 +106,49 @@ enum gateway_err {
 	ERR_HLTH_TIMEOUT_GET_ENCODE,
 	ERR_HLTH_TIMEOUT_SET_PARSE,
 	ERR_HLTH_TIMEOUT_SET_OP,
-	ERR_HLTH_TIMEOUT_SET_ENCODE
+	ERR_HLTH_TIMEOUT_SET_ENCODE,
+	ERR_MESH_STATS_ENCODE,
+	ERR_NODE_CFG_MODEL_GET,
+	ERR_NODE_CFG_ENCODE,
+	ERR_SWEEP_PARSE,
+	ERR_SWEEP_START,
+	ERR_SWEEP_ENCODE,
+	ERR_NODE_CFG_TXN_PARSE,
+	ERR_NODE_CFG_TXN_ENCODE,
+	ERR_FANOUT_PARSE,
+	ERR_FANOUT_START,
+	ERR_FANOUT_ENCODE,
+	ERR_PROV_PROFILE_PARSE,
+	ERR_PROV_PROFILE_STORE,
+	ERR_PROV_PROFILE_ENCODE,
+	ERR_NODE_READY_ENCODE,
+	ERR_RECONCILE_PARSE,
+	ERR_RECONCILE_SET,
+	ERR_RECONCILE_ENCODE,
+	ERR_PROV_BULK_PARSE,
+	ERR_PROV_QUEUE_ENCODE,
+	ERR_PROV_ALLOW_PARSE,
+	ERR_PROV_ALLOW_STORE,
+	ERR_PROV_ALLOW_ENCODE,
+	ERR_BEACON_EVENTS_PARSE,
+	ERR_BEACON_EVENTS_ENCODE,
+	ERR_BEACON_BLOCK_PARSE,
+	ERR_BEACON_BLOCK_ENCODE,
+	ERR_UPLINK_RULES_PARSE,
+	ERR_UPLINK_RULES_SET,
+	ERR_UPLINK_RULES_ENCODE
 };
 
 enum gateway_proc {
         GATEWAY_PROC_BEACON_REQ,
+	GATEWAY_PROC_BEACON_BLOCK,
+	GATEWAY_PROC_BEACON_UNBLOCK,
+	GATEWAY_PROC_BEACON_BLOCK_REQ,
         GATEWAY_PROC_PROV,
         GATEWAY_PROC_PROV_RESP,
+	GATEWAY_PROC_PROV_BULK,
+	GATEWAY_PROC_PROV_QUEUE_FLUSH,
+	GATEWAY_PROC_PROV_QUEUE_STATUS,
         GATEWAY_PROC_SUBNET_ADD,
         GATEWAY_PROC_SUBNET_GEN,
         GATEWAY_PROC_SUBNET_DEL,
@@ -123,7 +177,45 @@ enum gateway_proc {
 	GATEWAY_PROC_HLTH_ATTN_GET,
 	GATEWAY_PROC_HLTH_ATTN_SET,
 	GATEWAY_PROC_HLTH_TIMEOUT_GET,
-	GATEWAY_PROC_HLTH_TIMEOUT_SET
+	GATEWAY_PROC_HLTH_TIMEOUT_SET,
+	GATEWAY_PROC_MESH_STATS,
+#if defined(CONFIG_GATEWAY_SWEEP)
+	GATEWAY_PROC_SWEEP_START,
+	GATEWAY_PROC_SWEEP_STOP,
+	GATEWAY_PROC_SWEEP_STATUS,
+	GATEWAY_PROC_SWEEP_NODE,
+#endif // defined(CONFIG_GATEWAY_SWEEP)
+	GATEWAY_PROC_NODE_CFG_TXN,
+#if defined(CONFIG_GATEWAY_FANOUT)
+	GATEWAY_PROC_FANOUT_START,
+	GATEWAY_PROC_FANOUT_CANCEL,
+	GATEWAY_PROC_FANOUT_STATUS,
+	GATEWAY_PROC_FANOUT_NODE,
+#endif // defined(CONFIG_GATEWAY_FANOUT)
+#if defined(CONFIG_GATEWAY_PROV_PROFILE)
+	GATEWAY_PROC_PROV_PROFILE_SET,
+	GATEWAY_PROC_PROV_PROFILE_DEL,
+	GATEWAY_PROC_PROV_PROFILE_REQ,
+#endif // defined(CONFIG_GATEWAY_PROV_PROFILE)
+#if defined(CONFIG_GATEWAY_RECONCILE)
+	GATEWAY_PROC_RECONCILE_SET,
+	GATEWAY_PROC_RECONCILE_DEL,
+	GATEWAY_PROC_RECONCILE_STATUS,
+#endif // defined(CONFIG_GATEWAY_RECONCILE)
+#if defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+	GATEWAY_PROC_PROV_ALLOW_ADD,
+	GATEWAY_PROC_PROV_ALLOW_DEL,
+	GATEWAY_PROC_PROV_ALLOW_REQ,
+#endif // defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+#if defined(CONFIG_GATEWAY_BEACON_EVENTS)
+	GATEWAY_PROC_BEACON_EVENTS_SET,
+	GATEWAY_PROC_BEACON_EVENTS,
+#endif // defined(CONFIG_GATEWAY_BEACON_EVENTS)
+#if defined(CONFIG_GATEWAY_UPLINK_RULES)
+	GATEWAY_PROC_UPLINK_RULES_SET,
+	GATEWAY_PROC_UPLINK_RULES_REQ,
+#endif // defined(CONFIG_GATEWAY_UPLINK_RULES)
+	GATEWAY_PROC_COUNT
 };
 
 struct gateway_proc_data {
@@ -131,33 +223,125 @@ struct gateway_proc_data {
         enum gateway_proc proc;
         cJSON *root_obj;
         cJSON *op_obj;
-        uint32_t opcode;
-        struct bt_mesh_msg_ctx msg_ctx;
-        uint8_t *payload;
-        size_t payload_len;
 	uint16_t addr;
 	uint8_t test_id;
 	uint16_t cid;
 	uint8_t *faults;
 	size_t fault_count;
+	int64_t recv_time;
+	struct btmesh_node *node;
+	int err;
+	uint8_t status;
+	struct prov_queue_result prov_res;
+#if defined(CONFIG_GATEWAY_FANOUT)
+	struct fanout_result fanout_res;
+#endif // defined(CONFIG_GATEWAY_FANOUT)
 };
 
 K_FIFO_DEFINE(gateway_proc_fifo);
 
-static struct k_work_q *work_q;
-static struct k_work_delayable prov_timeout_work;
-static struct {
-        int err;
-        uint8_t uuid[UUID_LEN];
-        uint16_t net_idx;
-        uint16_t addr;
-        uint8_t num_elem;
-} prov;
+/* Procedures waiting in gateway_proc_fifo, and how long the last model message or health
+ * fault took from reception to the cloud */
+static atomic_t proc_pending;
+static atomic_t telemetry_latency;
 
-K_SEM_DEFINE(prov_sem, 1, 1);
+static struct k_work_q *work_q;
 
 static char buf[GATEWAY_BUF_LEN];
 
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+static bool rx_filter(const struct rx_bus_msg *msg, void *user_data);
+static void rx_notify(struct rx_bus_consumer *consumer);
+
+static struct rx_bus_consumer rx_consumer = {
+	.name = "gateway",
+	.filter = rx_filter,
+	.notify = rx_notify,
+};
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+
+#if defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+/* Messages are sent from several threads, compress_lock guards the compressor state and
+ * the output buffer until the message has been handed to the cloud library */
+static struct compress_ctx compress_ctx;
+static uint8_t compress_buf[GATEWAY_BUF_LEN];
+static uint8_t compress_dict[CONFIG_GATEWAY_UPLINK_COMPRESSION_DICT_SIZE];
+K_MUTEX_DEFINE(compress_lock);
+#endif // defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+
+#if defined(CONFIG_GATEWAY_JSON_ARENA)
+/* cJSON allocations made by the processing thread while a request is being handled come
+ * from this arena and are released in one step when the request completes. Allocations
+ * from any other thread (e.g. parsing in gateway_handler() or the nRF Cloud library) and
+ * allocations that do not fit go to the system heap. */
+static uint8_t json_arena_buf[CONFIG_GATEWAY_JSON_ARENA_SIZE] __aligned(ARENA_ALIGN);
+static struct arena json_arena;
+static k_tid_t json_arena_owner;
+static struct gateway_arena_stats json_arena_stats[GATEWAY_PROC_COUNT];
+
+static void *json_arena_malloc(size_t size)
+{
+	void *ptr;
+
+	if (k_current_get() == json_arena_owner) {
+		ptr = arena_alloc(&json_arena, size);
+
+		if (ptr != NULL) {
+			return ptr;
+		}
+	}
+
+	return k_malloc(size);
+}
+
+static void json_arena_free(void *ptr)
+{
+	if (arena_owns(&json_arena, ptr)) {
+		return;
+	}
+
+	k_free(ptr);
+}
+
+static cJSON_Hooks json_arena_hooks = {
+	.malloc_fn = json_arena_malloc,
+	.free_fn = json_arena_free,
+};
+
+static void json_arena_begin(void)
+{
+	/* The nRF Cloud library calls cJSON_Init() when it connects, which replaces any
+	 * installed hooks, so (re)install them for every request. */
+	cJSON_InitHooks(&json_arena_hooks);
+	arena_reset(&json_arena);
+	json_arena.hwm = 0;
+	json_arena.alloc_count = 0;
+	json_arena.fail_count = 0;
+	json_arena_owner = k_current_get();
+}
+
+static void json_arena_end(enum gateway_proc proc)
+{
+	struct gateway_arena_stats *stats;
+
+	json_arena_owner = NULL;
+	arena_reset(&json_arena);
+
+	if (proc >= GATEWAY_PROC_COUNT) {
+		return;
+	}
+
+	stats = &json_arena_stats[proc];
+	stats->count++;
+	stats->allocs += json_arena.alloc_count;
+	stats->fallbacks += json_arena.fail_count;
+
+	if (json_arena.hwm > stats->hwm) {
+		stats->hwm = json_arena.hwm;
+	}
+}
+#endif // defined(CONFIG_GATEWAY_JSON_ARENA)
+
 static void log_err(enum gateway_err loc, int err)
 {
 	LOG_ERR("Error at %d: %d", -loc, err);
@@ -170,28 +354,118 @@ static bool strings_equal(const char *s1, const  char *s2)
 
 static int g2c_send(char *buf)
 {
+	int err;
 	struct nrf_cloud_tx_data msg;
+#if defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+	size_t len;
+#endif // defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
 
 	msg.data.ptr = (const void *)buf;
 	msg.data.len = strlen(buf);
 	msg.topic_type = NRF_CLOUD_TOPIC_MESSAGE;
 	msg.qos = MQTT_QOS_1_AT_LEAST_ONCE;
 
-	return nrf_cloud_send(&msg);
+#if defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+	if (msg.data.len < CONFIG_GATEWAY_UPLINK_COMPRESSION_MIN_LEN) {
+		return nrf_cloud_send(&msg);
+	}
+
+	k_mutex_lock(&compress_lock, K_FOREVER);
+
+	if (!compress_encode(&compress_ctx, (const uint8_t *)buf, msg.data.len, compress_buf,
+			sizeof(compress_buf), &len)) {
+		LOG_DBG("Uplink compressed %d -> %d bytes", msg.data.len, len);
+		msg.data.ptr = (const void *)compress_buf;
+		msg.data.len = len;
+	}
+
+	err = nrf_cloud_send(&msg);
+	k_mutex_unlock(&compress_lock);
+#else
+	err = nrf_cloud_send(&msg);
+#endif // defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+
+	return err;
 }
 
-static void beacon_req(void)
+static void beacon_req(cJSON *op_obj)
 {
         int err;
+        struct codec_page page;
 
-        err = codec_encode_beacon_list(buf, sizeof(buf));
+        memset(&page, 0, sizeof(page));
+        err = codec_parse_cursor(op_obj, &page.cursor);
 
         if (err) {
 		log_err(ERR_BEACON_LIST_ENCODE, err);
                 return;
         }
 
-        g2c_send(buf);
+        do {
+                err = codec_encode_beacon_list(buf, GATEWAY_PAGE_LEN, &page);
+
+                if (err) {
+			log_err(ERR_BEACON_LIST_ENCODE, err);
+                        return;
+                }
+
+                g2c_send(buf);
+                page.index++;
+        } while (page.more);
+}
+
+static void beacon_block_req(cJSON *op_obj)
+{
+	int err;
+	struct codec_page page;
+
+	memset(&page, 0, sizeof(page));
+	err = codec_parse_cursor(op_obj, &page.cursor);
+
+	if (err) {
+		log_err(ERR_BEACON_BLOCK_PARSE, err);
+		return;
+	}
+
+	do {
+		err = codec_encode_beacon_blocklist(buf, GATEWAY_PAGE_LEN, &page);
+
+		if (err) {
+			log_err(ERR_BEACON_BLOCK_ENCODE, err);
+			return;
+		}
+
+		g2c_send(buf);
+		page.index++;
+	} while (page.more);
+}
+
+static void beacon_block_change(cJSON *op_obj, bool block)
+{
+	int err;
+	size_t count;
+	size_t changed;
+	uint8_t (*uuids)[UUID_LEN];
+
+	err = codec_parse_beacon_block(op_obj, &uuids, &count);
+
+	if (err) {
+		log_err(ERR_BEACON_BLOCK_PARSE, err);
+		return;
+	}
+
+	err = beacon_block_update(uuids, count, block, &changed);
+	k_free(uuids);
+
+	err = codec_encode_beacon_block_result(buf, sizeof(buf), err, changed,
+			beacon_block_count());
+
+	if (err) {
+		log_err(ERR_BEACON_BLOCK_ENCODE, err);
+		return;
+	}
+
+	g2c_send(buf);
 }
 
 static void prov_result(int err, uint8_t uuid[UUID_LEN], uint16_t net_idx, uint16_t addr,
@@ -203,90 +477,247 @@ static void prov_result(int err, uint8_t uuid[UUID_LEN], uint16_t net_idx, uint1
 
         if (codec_err) {
 		log_err(ERR_PROV_RESP_ENCODE, codec_err);
-                goto cleanup;
+                return;
         }
 
         g2c_send(buf);
+}
+
+#if defined(CONFIG_GATEWAY_PROV_PROFILE)
+/* Configure a newly provisioned node with its profile and report it as ready */
+static void node_ready(uint8_t uuid[UUID_LEN], uint16_t net_idx, uint16_t addr,
+		uint8_t num_elem, const char *profile)
+{
+	int err;
+	int txn_err;
+	char *steps;
+	struct cfg_txn txn;
+	struct prov_profile_info info;
+
+	memset(&txn, 0, sizeof(txn));
+	memset(&info, 0, sizeof(info));
+	txn.addr = addr;
+	txn_err = prov_profile_find(profile, uuid, net_idx, addr, &info, &steps);
+
+	/* Nodes without a profile are left to the cloud */
+	if (txn_err == -ENOENT && profile == NULL) {
+		return;
+	}
+
+	if (txn_err) {
+		strcpy(info.name, profile != NULL ? profile : "");
+	} else {
+		LOG_INF("Applying provisioning profile %s to 0x%04x", log_strdup(info.name), addr);
+		txn_err = codec_parse_prov_profile_steps(steps, addr, &txn);
+		k_free(steps);
+	}
+
+	if (!txn_err) {
+		txn_err = cfg_txn_perform(&txn);
+	}
+
+	err = codec_encode_node_ready(buf, sizeof(buf), uuid, net_idx, addr, num_elem, info.name,
+			&txn, txn_err, btmesh_get_cfg_version(addr));
+	k_free(txn.steps);
+
+	if (err) {
+		log_err(ERR_NODE_READY_ENCODE, err);
+		return;
+	}
 
-cleanup:
-        k_sem_give(&prov_sem);
+	g2c_send(buf);
 }
 
+static void prov_profile_list(void)
+{
+	int err;
+
+	err = codec_encode_prov_profile_list(buf, sizeof(buf));
 
+	if (err) {
+		log_err(ERR_PROV_PROFILE_ENCODE, err);
+		return;
+	}
+
+	g2c_send(buf);
+}
+
+static void prov_profile_set(cJSON *op_obj)
+{
+	int err;
+	char *steps;
+	struct prov_profile_info info;
+
+	err = codec_parse_prov_profile(op_obj, &info, &steps);
+
+	if (err) {
+		log_err(ERR_PROV_PROFILE_PARSE, err);
+		return;
+	}
+
+	err = prov_profile_store(&info, steps);
+	cJSON_free(steps);
+
+	if (err) {
+		log_err(ERR_PROV_PROFILE_STORE, err);
+		return;
+	}
+
+	prov_profile_list();
+}
+
+static void prov_profile_del(cJSON *op_obj)
+{
+	int err;
+	char *name;
+
+	err = codec_parse_prov_profile_name(op_obj, &name);
+
+	if (err) {
+		log_err(ERR_PROV_PROFILE_PARSE, err);
+		return;
+	}
+
+	err = prov_profile_delete(name);
+
+	if (err) {
+		log_err(ERR_PROV_PROFILE_STORE, err);
+		return;
+	}
+
+	prov_profile_list();
+}
+#endif // defined(CONFIG_GATEWAY_PROV_PROFILE)
+
+/* Devices are provisioned through the queue, one at a time, and reported as they finish */
 static void prov_dev(cJSON *op_obj)
 {
         int err;
-        union btmesh_op_args args;
+        char *profile;
+        struct prov_queue_dev dev;
 
-	err = codec_parse_prov(op_obj, args.prov_adv.uuid, &args.prov_adv.net_idx,
-			&args.prov_adv.addr, &args.prov_adv.attn);
+	memset(&dev, 0, sizeof(dev));
+	err = codec_parse_prov(op_obj, dev.uuid, &dev.net_idx, &dev.addr, &dev.attn, &profile);
 
 	if (err) {
 		log_err(ERR_PROV_PARSE, err);
 		return;
 	}
 
-        if (k_sem_take(&prov_sem, K_SECONDS(PROV_TIMEOUT_SEC))) {
-		log_err(ERR_PROV_RESOURCE, 0);
-                prov_result(-EDEADLK, args.prov_adv.uuid, args.prov_adv.net_idx, args.prov_adv.addr,
-                                args.prov_adv.attn);
-                return;
-        }
+	if (profile != NULL && strlen(profile) > PROV_PROFILE_NAME_LEN) {
+		log_err(ERR_PROV_PARSE, -EINVAL);
+		return;
+	}
 
-        err = btmesh_perform_op(BTMESH_OP_PROV_ADV, &args);
+	strcpy(dev.profile, profile != NULL ? profile : "");
+	dev.elem_count = 1;
+	err = prov_queue_add(&dev);
 
         if (err) {
-		log_err(ERR_PROV_OP, err);
-                prov_result(err, args.prov_adv.uuid, args.prov_adv.net_idx, args.prov_adv.addr,
-                                args.prov_adv.attn);
-                return;
+		log_err(ERR_PROV_RESOURCE, err);
+                prov_result(err, dev.uuid, dev.net_idx, dev.addr, 0);
         }
+}
+
+static void prov_bulk(cJSON *op_obj)
+{
+	int err;
+	size_t i;
+	size_t dev_count;
+	struct prov_queue_dev *devs;
+
+	err = codec_parse_prov_bulk(op_obj, &devs, &dev_count);
+
+	if (err) {
+		log_err(ERR_PROV_BULK_PARSE, err);
+		return;
+	}
 
-        util_uuid_cpy(prov.uuid, args.prov_adv.uuid);
-        k_work_reschedule_for_queue(work_q, &prov_timeout_work, K_SECONDS(PROV_TIMEOUT_SEC));
-        LOG_DBG("DONE INITIATING LTE PROVISION");
+	/* Devices that do not fit are reported right away, the others when they finish */
+	for (i = 0; i < dev_count; i++) {
+		err = prov_queue_add(&devs[i]);
+
+		if (err) {
+			log_err(ERR_PROV_RESOURCE, err);
+			prov_result(err, devs[i].uuid, devs[i].net_idx, devs[i].addr, 0);
+		}
+	}
+
+	k_free(devs);
 }
 
-static void prov_timeout(struct k_work *work)
+static void prov_queue_status(void)
 {
-        char uuid_str[UUID_STR_LEN];
-        struct gateway_proc_data proc_data;
-        struct gateway_proc_data *mem_ptr;
+	int err;
+	struct prov_queue_stats stats;
 
-        util_uuid2str(prov.uuid,  uuid_str);
-	log_err(ERR_PROV_TIMEOUT, 0);
-        LOG_ERR("  -> %s", log_strdup(uuid_str));
+	prov_queue_stats_get(&stats);
+	err = codec_encode_prov_queue_status(buf, sizeof(buf), &stats);
 
-        proc_data.proc = GATEWAY_PROC_PROV_RESP;
-        prov.err = -ETIMEDOUT;
-        prov.net_idx = 0;
-        prov.addr = 0;
-        prov.num_elem = 0;
+	if (err) {
+		log_err(ERR_PROV_QUEUE_ENCODE, err);
+		return;
+	}
 
-        mem_ptr = k_malloc(sizeof(proc_data));
+	g2c_send(buf);
+}
 
-        if (mem_ptr == NULL) {
+static void proc_queue(struct gateway_proc_data *proc_data)
+{
+	atomic_inc(&proc_pending);
+	k_fifo_put(&gateway_proc_fifo, proc_data);
+}
+
+/* Queues proc with a copy of the fields of data, which may be NULL. Returns false if it could
+ * not be queued, anything data points to is then still owned by the caller. */
+static bool proc_post(enum gateway_proc proc, const struct gateway_proc_data *data)
+{
+	struct gateway_proc_data *proc_ptr;
+
+	proc_ptr = k_malloc(sizeof(*proc_ptr));
+
+	if (proc_ptr == NULL) {
 		log_err(ERR_PROC_DATA_MEM, 0);
-                k_sem_give(&prov_sem);
-                return;
-        }
+		return false;
+	}
 
-        memcpy(mem_ptr, &proc_data, sizeof(proc_data));
-        k_fifo_put(&gateway_proc_fifo, mem_ptr);
+	if (data != NULL) {
+		memcpy(proc_ptr, data, sizeof(*proc_ptr));
+	} else {
+		memset(proc_ptr, 0, sizeof(*proc_ptr));
+	}
+
+	proc_ptr->proc = proc;
+	proc_ptr->root_obj = NULL;
+	proc_ptr->op_obj = NULL;
+	proc_queue(proc_ptr);
+	return true;
 }
 
-static void node_req(void)
+static void node_req(cJSON *op_obj)
 {
         int err;
+        struct codec_page page;
 
-        err = codec_encode_node_list(buf, sizeof(buf));
+        memset(&page, 0, sizeof(page));
+        err = codec_parse_cursor(op_obj, &page.cursor);
 
         if (err) {
 		log_err(ERR_NODE_LIST_ENCODE, err);
                 return;
         }
 
-        g2c_send(buf);
+        do {
+                err = codec_encode_node_list(buf, GATEWAY_PAGE_LEN, &page);
+
+                if (err) {
+			log_err(ERR_NODE_LIST_ENCODE, err);
+                        return;
+                }
+
+                g2c_send(buf);
+                page.index++;
+        } while (page.more);
 }
 
 static bool add_subnet(uint16_t net_idx, uint8_t net_key[KEY_LEN])
@@ -557,104 +988,454 @@ static void app_key_req(void)
         g2c_send(buf);
 }
 
+static void node_disc_send(struct btmesh_node *node, uint8_t status)
+{
+        int err;
+        struct codec_page page;
+
+        memset(&page, 0, sizeof(page));
+
+        do {
+                err = codec_encode_node_disc(buf, GATEWAY_PAGE_LEN, node, 0, status, &page);
+
+                if (err) {
+			log_err(ERR_NODE_DISC_ENCODE, err);
+                        return;
+                }
+
+                g2c_send(buf);
+                page.index++;
+        } while (page.more);
+}
+
 static void node_disc(cJSON *op_obj)
 {
         int err;
+        bool refresh;
         uint8_t status;
         struct btmesh_node node;
 
-	err = codec_parse_node_disc(op_obj, &node.addr);
+	err = codec_parse_node_disc(op_obj, &node.addr, &refresh);
 
 	if (err) {
 		log_err(ERR_NODE_DISC_PARSE, err);
 		return;
 	}
 
-        err = btmesh_discover_node(&node, &status);
+        err = btmesh_get_node(&node, &status, refresh);
 
         if (err) {
 		log_err(ERR_NODE_DISC_OP, err);
                 return;
         }
 
-        err = codec_encode_node_disc(buf, sizeof(buf), &node, err, status);
-
-        if (err) {
-		log_err(ERR_NODE_DISC_ENCODE, err);
-                return;
-        }
-
-        g2c_send(buf);
+        node_disc_send(&node, status);
+        btmesh_free_node(&node);
 }
 
 static void node_cfg(cJSON *op_obj)
 {
         int err;
-        uint8_t status;
-        struct btmesh_node node;
+        int op_err;
+        uint16_t addr;
+        enum btmesh_op op;
+        union btmesh_op_args args;
+        struct btmesh_model_state model;
+        struct btmesh_model_state *model_state;
 
-        err = codec_parse_node_cfg(op_obj, &node.addr);
+        err = codec_parse_node_cfg(op_obj, &addr, &op, &args);
 
         if (err) {
-		log_err(ERR_NODE_CFG_PARSE, 0);
+		log_err(ERR_NODE_CFG_PARSE, err);
+                return;
         }
 
-        err = btmesh_discover_node(&node, &status);
+        op_err = btmesh_perform_cfg_op(op, &args);
+        model_state = NULL;
+
+        if (!op_err && !btmesh_get_op_status(op, &args)) {
+                /* Only the model that was changed is reported, not the whole node */
+                if (!btmesh_get_op_model(op, &args, &model)) {
+                        err = btmesh_get_model_state(addr, &model);
+
+                        if (err) {
+				log_err(ERR_NODE_CFG_MODEL_GET, err);
+                        } else {
+                                model_state = &model;
+                        }
+                }
+        }
+
+        err = codec_encode_node_cfg(buf, sizeof(buf), addr, op, &args, op_err,
+                        btmesh_get_cfg_version(addr), model_state);
 
         if (err) {
-		log_err(ERR_NODE_DISC_OP, err);
+		log_err(ERR_NODE_CFG_ENCODE, err);
                 return;
         }
 
-        err = codec_encode_node_disc(buf, sizeof(buf), &node, err, status);
+        g2c_send(buf);
+}
+
+static void node_cfg_txn(cJSON *op_obj)
+{
+	int err;
+	int txn_err;
+	struct cfg_txn txn;
+
+	err = codec_parse_node_cfg_txn(op_obj, &txn);
+
+	if (err) {
+		log_err(ERR_NODE_CFG_TXN_PARSE, err);
+		return;
+	}
+
+	txn_err = cfg_txn_perform(&txn);
+	err = codec_encode_node_cfg_txn(buf, sizeof(buf), &txn, txn_err,
+			btmesh_get_cfg_version(txn.addr));
+	k_free(txn.steps);
+
+	if (err) {
+		log_err(ERR_NODE_CFG_TXN_ENCODE, err);
+		return;
+	}
+
+	g2c_send(buf);
+}
+
+#if defined(CONFIG_GATEWAY_FANOUT)
+static void fanout_progress(void)
+{
+	int err;
+	struct fanout_status status;
+
+	fanout_status_get(&status);
+	err = codec_encode_fanout_progress(buf, sizeof(buf), &status);
+
+	if (err) {
+		log_err(ERR_FANOUT_ENCODE, err);
+		return;
+	}
+
+	g2c_send(buf);
+}
+
+static void fanout_start_req(cJSON *op_obj)
+{
+	int err;
+	struct fanout_req req;
+
+	err = codec_parse_node_cfg_fanout(op_obj, &req);
+
+	if (err) {
+		log_err(ERR_FANOUT_PARSE, err);
+		return;
+	}
+
+	err = fanout_start(&req);
+
+	/* A started fan-out reports its own progress */
+	if (err) {
+		log_err(ERR_FANOUT_START, err);
+		fanout_progress();
+	}
+}
+
+static void fanout_node(const struct fanout_result *res)
+{
+	int err;
+
+	err = codec_encode_fanout_node(buf, sizeof(buf), res);
+
+	if (err) {
+		log_err(ERR_FANOUT_ENCODE, err);
+		return;
+	}
+
+	g2c_send(buf);
+}
+#endif // defined(CONFIG_GATEWAY_FANOUT)
+
+#if defined(CONFIG_GATEWAY_RECONCILE)
+static void reconcile_status(void)
+{
+	int err;
+
+	err = codec_encode_reconcile_status(buf, sizeof(buf));
+
+	if (err) {
+		log_err(ERR_RECONCILE_ENCODE, err);
+		return;
+	}
+
+	g2c_send(buf);
+}
+
+static void reconcile_set(cJSON *op_obj)
+{
+	int err;
+	size_t addr_count;
+	uint16_t *addrs;
+	struct reconcile_state state;
+
+	err = codec_parse_reconcile_state(op_obj, &state, &addrs, &addr_count);
+
+	if (err) {
+		log_err(ERR_RECONCILE_PARSE, err);
+		return;
+	}
+
+	err = reconcile_state_set(&state, addrs, addr_count);
+	k_free(addrs);
+
+	if (err) {
+		log_err(ERR_RECONCILE_SET, err);
+		return;
+	}
+
+	reconcile_status();
+}
+
+static void reconcile_del(cJSON *op_obj)
+{
+	int err;
+	char *name;
+
+	err = codec_parse_reconcile_name(op_obj, &name);
+
+	if (err) {
+		log_err(ERR_RECONCILE_PARSE, err);
+		return;
+	}
+
+	err = reconcile_state_delete(name);
+
+	if (err) {
+		log_err(ERR_RECONCILE_SET, err);
+		return;
+	}
+
+	reconcile_status();
+}
+#endif // defined(CONFIG_GATEWAY_RECONCILE)
+
+#if defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+static void prov_allow_list(void)
+{
+	int err;
+
+	err = codec_encode_prov_allow_list(buf, sizeof(buf));
+
+	if (err) {
+		log_err(ERR_PROV_ALLOW_ENCODE, err);
+		return;
+	}
+
+	g2c_send(buf);
+}
+
+static void prov_allow_update(cJSON *op_obj, bool add)
+{
+	int err;
+	size_t i;
+	size_t count;
+	struct prov_allow_entry *entries;
+
+	err = codec_parse_prov_allow(op_obj, &entries, &count);
+
+	if (err) {
+		log_err(ERR_PROV_ALLOW_PARSE, err);
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (add) {
+			err = prov_allow_add(&entries[i]);
+		} else {
+			err = prov_allow_delete(entries[i].uuid_prefix, entries[i].uuid_prefix_len);
+		}
+
+		if (err) {
+			log_err(ERR_PROV_ALLOW_STORE, err);
+		}
+	}
+
+	k_free(entries);
+	prov_allow_list();
+}
+#endif // defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+
+#if defined(CONFIG_GATEWAY_UPLINK_RULES)
+static void send_uplink_rules(uint16_t cursor)
+{
+	int err;
+	struct codec_page page;
+
+	memset(&page, 0, sizeof(page));
+	page.cursor = cursor;
+
+	do {
+		err = codec_encode_uplink_rules(buf, GATEWAY_PAGE_LEN, &page);
+
+		if (err) {
+			log_err(ERR_UPLINK_RULES_ENCODE, err);
+			return;
+		}
+
+		g2c_send(buf);
+		page.index++;
+	} while (page.more);
+}
+
+/* The table is replaced as a whole, so a cloud update never leaves half of it applied */
+static void uplink_rules_update(cJSON *op_obj)
+{
+	int err;
+	size_t count;
+	struct uplink_rule *rules;
+
+	err = codec_parse_uplink_rules(op_obj, &rules, &count);
+
+	if (err) {
+		log_err(ERR_UPLINK_RULES_PARSE, err);
+		return;
+	}
+
+	err = uplink_rules_set(rules, count);
+	k_free(rules);
+
+	if (err) {
+		log_err(ERR_UPLINK_RULES_SET, err);
+		return;
+	}
+
+	send_uplink_rules(0);
+}
+
+static void uplink_rules_req(cJSON *op_obj)
+{
+	int err;
+	uint16_t cursor;
+
+	err = codec_parse_cursor(op_obj, &cursor);
+
+	if (err) {
+		log_err(ERR_UPLINK_RULES_PARSE, err);
+		return;
+	}
+
+	send_uplink_rules(cursor);
+}
+#endif // defined(CONFIG_GATEWAY_UPLINK_RULES)
+
+#if defined(CONFIG_GATEWAY_BEACON_EVENTS)
+static struct beacon_event beacon_event_batch[CONFIG_GATEWAY_BEACON_EVENTS_BATCH];
+
+static void beacon_events_set(cJSON *op_obj)
+{
+	int err;
+	bool enable;
+
+	err = codec_parse_beacon_events(op_obj, &enable);
+
+	if (err) {
+		log_err(ERR_BEACON_EVENTS_PARSE, err);
+		return;
+	}
+
+	beacon_events_enable(enable);
+
+	/* The full list is the starting point the events are applied to */
+	if (enable) {
+		beacon_req(NULL);
+	}
+}
+
+static void beacon_events_send(void)
+{
+	int err;
+	size_t i;
+	size_t count;
+	size_t found_count;
+	bool overflow;
+
+	count = beacon_events_take(beacon_event_batch, &overflow);
+	found_count = 0;
+
+	for (i = 0; i < count; i++) {
+		if (beacon_event_batch[i].found) {
+			found_count++;
+		}
+	}
+
+	/* Dropped changes are flagged on the found event, the cloud then requests the list */
+	if (found_count || overflow) {
+		err = codec_encode_beacon_events(buf, sizeof(buf), beacon_event_batch, count, true,
+				overflow);
+
+		if (err) {
+			log_err(ERR_BEACON_EVENTS_ENCODE, err);
+		} else {
+			g2c_send(buf);
+		}
+	}
+
+	if (count > found_count) {
+		err = codec_encode_beacon_events(buf, sizeof(buf), beacon_event_batch, count, false,
+				false);
+
+		if (err) {
+			log_err(ERR_BEACON_EVENTS_ENCODE, err);
+		} else {
+			g2c_send(buf);
+		}
+	}
+}
+#endif // defined(CONFIG_GATEWAY_BEACON_EVENTS)
+
+static void send_subscribe_list(uint16_t cursor)
+{
+	int err;
+	struct codec_page page;
+
+	memset(&page, 0, sizeof(page));
+	page.cursor = cursor;
 
-        if (err) {
-		log_err(ERR_NODE_DISC_ENCODE, err);
-                return;
-        }
+	do {
+		err = codec_encode_subscribe_list(buf, GATEWAY_PAGE_LEN, &page);
 
-        g2c_send(buf);
+		if (err) {
+			log_err(ERR_SUB_ENCODE, err);
+			return;
+		}
+
+		g2c_send(buf);
+		page.index++;
+	} while (page.more);
 }
 
 static void change_subscribe_list(cJSON *op_obj, bool subscribe)
 {
-        int i;
-        int err;
-        int addr_count;
-        uint16_t *addr_list;
+	int err;
+	size_t count;
+	struct sub_range *ranges;
 
-        addr_list = NULL;
-        err = codec_parse_subscribe_addrs(op_obj, &addr_list, &addr_count);
+	err = codec_parse_subscribe_addrs(op_obj, &ranges, &count);
 
-        if (err) {
+	if (err) {
 		log_err(ERR_SUB_PARSE, err);
-                return;
-        }
-
-        for (i = 0; i < addr_count; i++) {
-                if (subscribe) {
-                        err = btmesh_subscribe(BTMESH_SUB_TYPE_GATEWAY, addr_list[i]);
-                } else {
-                        btmesh_unsubscribe(BTMESH_SUB_TYPE_GATEWAY, addr_list[i]);
-                }
-
-                if (err) {
-			log_err(ERR_SUB_CHANGE, err);
-                        goto cleanup;
-                }
-        }
-
-        err = codec_encode_subscribe_list(buf, sizeof(buf));
+		return;
+	}
 
-        if (err) {
-		log_err(ERR_SUB_ENCODE, err);
-                goto cleanup;
-        }
+	err = sub_set_update(BTMESH_SUB_TYPE_GATEWAY, ranges, count, subscribe);
+	k_free(ranges);
 
-        g2c_send(buf);
+	if (err) {
+		log_err(ERR_SUB_CHANGE, err);
+		return;
+	}
 
-cleanup:
-        k_free(addr_list);
+	send_subscribe_list(0);
 }
 
 static void subscribe(cJSON *op_obj)
@@ -669,34 +1450,62 @@ static void unsubscribe(cJSON *op_obj)
 
 static void subscribe_req(cJSON *op_obj)
 {
-        int err;
+	int err;
+	uint16_t cursor;
 
-        err = codec_encode_subscribe_list(buf, sizeof(buf));
+	err = codec_parse_cursor(op_obj, &cursor);
 
-        if (err) {
-		log_err(ERR_SUB_ENCODE, err);
-                return;
-        }
+	if (err) {
+		log_err(ERR_SUB_PARSE, err);
+		return;
+	}
 
-        g2c_send(buf);
+	send_subscribe_list(cursor);
 }
 
-static void recv_model_msg(uint32_t opcode, struct bt_mesh_msg_ctx ctx, uint8_t *payload,
-                size_t payload_len)
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+static bool rx_filter(const struct rx_bus_msg *msg, void *user_data)
 {
-        int err;
+	return sub_set_contains(BTMESH_SUB_TYPE_GATEWAY, msg->recv_dst);
+}
 
-        err = codec_encode_model_msg(buf, sizeof(buf), opcode, &ctx, payload, payload_len);
+#if defined(CONFIG_GATEWAY_MODEL_DECODE)
+/* Kept off the stack of the gateway thread */
+static struct model_decoded model_decoded;
+#endif // defined(CONFIG_GATEWAY_MODEL_DECODE)
 
-        if (err) {
+static void recv_model_msg(struct rx_bus_msg *msg)
+{
+	int err;
+	const struct model_decoded *decoded;
+	struct bt_mesh_msg_ctx ctx = {
+		.net_idx = msg->net_idx,
+		.app_idx = msg->app_idx,
+		.addr = msg->addr,
+		.recv_dst = msg->recv_dst,
+	};
+
+	decoded = NULL;
+
+#if defined(CONFIG_GATEWAY_MODEL_DECODE)
+	/* Opcodes without a decoder, and payloads that do not parse, are sent raw only */
+	if ((msg->flags & UPLINK_FLAG_DECODE) &&
+	    !model_decode(msg->opcode, msg->addr, msg->payload, msg->len, &model_decoded)) {
+		decoded = &model_decoded;
+	}
+#endif // defined(CONFIG_GATEWAY_MODEL_DECODE)
+
+	err = codec_encode_model_msg(buf, sizeof(buf), msg->opcode, &ctx, msg->payload, msg->len,
+			msg->recv_time, decoded);
+
+	if (err) {
 		log_err(ERR_MOD_MSG_ENCODE, err);
-                return;
-        }
+		return;
+	}
 
-        g2c_send(buf);
+	g2c_send(buf);
 }
 
-#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
 static void send_model_msg(cJSON *op_obj)
 {
         int err;
@@ -722,12 +1531,12 @@ static void send_model_msg(cJSON *op_obj)
 #endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
 
 static void hlth_fault_cur(uint16_t addr, uint8_t test_id, uint16_t cid, uint8_t *faults,
-		size_t fault_count)
+		size_t fault_count, int64_t recv_time)
 {
 	int err;
 
 	err = codec_encode_hlth_faults_cur(buf, sizeof(buf), addr, cid, test_id, faults,
-			fault_count);
+			fault_count, recv_time);
 
 	if (err) {
 		log_err(ERR_HLTH_FAULT_CUR_ENCODE, err);
@@ -1012,11 +1821,119 @@ static void hlth_timeout_set(cJSON *op_obj)
 	g2c_send(buf);
 }
 
+static void mesh_stats(cJSON *op_obj)
+{
+	int err;
+	bool reset;
+
+	codec_parse_mesh_stats(op_obj, &reset);
+	err = codec_encode_mesh_stats(buf, sizeof(buf));
+
+	if (err) {
+		log_err(ERR_MESH_STATS_ENCODE, err);
+		return;
+	}
+
+	/* Only reset once the counters have made it into the event */
+	if (reset) {
+		mesh_retry_stats_reset();
+	}
+
+	g2c_send(buf);
+}
+
+#if defined(CONFIG_GATEWAY_SWEEP)
+/* addr is the node that just finished, if the progress is reported for one */
+static void sweep_progress(uint16_t addr, int node_err, uint8_t node_status)
+{
+	int err;
+	size_t queue_depth;
+	uint32_t latency_ms;
+	struct sweep_status status;
+
+	sweep_status_get(&status);
+	gateway_load_get(&queue_depth, &latency_ms);
+	err = codec_encode_sweep_progress(buf, sizeof(buf), &status, queue_depth, latency_ms,
+			addr, node_err, node_status);
+
+	if (err) {
+		log_err(ERR_SWEEP_ENCODE, err);
+		return;
+	}
+
+	g2c_send(buf);
+}
+
+static void sweep_start_req(cJSON *op_obj)
+{
+	int err;
+	struct sweep_params params;
+
+	sweep_params_default(&params);
+	err = codec_parse_sweep_start(op_obj, &params);
+
+	if (err) {
+		log_err(ERR_SWEEP_PARSE, err);
+		return;
+	}
+
+	err = sweep_start(&params);
+
+	/* A started sweep reports its own progress */
+	if (err) {
+		log_err(ERR_SWEEP_START, err);
+		sweep_progress(BT_MESH_ADDR_UNASSIGNED, 0, 0);
+	}
+}
+
+static void sweep_node(struct btmesh_node *node, uint16_t addr, int err, uint8_t status)
+{
+	if (node != NULL) {
+		node_disc_send(node, status);
+		btmesh_free_node(node);
+		k_free(node);
+	}
+
+	sweep_progress(addr, err, status);
+}
+#endif // defined(CONFIG_GATEWAY_SWEEP)
+
 static void log_proc(enum gateway_proc proc)
 {
 	LOG_DBG("Gateway procedure: %d", proc);
 }
 
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+/* Send every subscribed message received since the last call */
+static void recv_model_msgs(void)
+{
+	uint32_t overflow;
+	static uint32_t overflow_reported;
+	struct rx_bus_msg msg;
+
+	while (!rx_bus_read(&rx_consumer, &msg)) {
+#if defined(CONFIG_GATEWAY_JSON_ARENA)
+		json_arena_begin();
+#endif // defined(CONFIG_GATEWAY_JSON_ARENA)
+
+		log_proc(GATEWAY_PROC_RECV_MODEL_MSG);
+		recv_model_msg(&msg);
+		atomic_set(&telemetry_latency, k_uptime_get() - msg.recv_time);
+
+#if defined(CONFIG_GATEWAY_JSON_ARENA)
+		json_arena_end(GATEWAY_PROC_RECV_MODEL_MSG);
+#endif // defined(CONFIG_GATEWAY_JSON_ARENA)
+	}
+
+	overflow = atomic_get(&rx_consumer.overflow);
+
+	if (overflow != overflow_reported) {
+		LOG_WRN("%u received model messages lost", overflow - overflow_reported);
+		overflow_reported = overflow;
+	}
+}
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+
 static void gateway_process(int unused1, int unused2, int unused3)
 {
         ARG_UNUSED(unused1);
@@ -1027,18 +1944,42 @@ static void gateway_process(int unused1, int unused2, int unused3)
 
         for(;;) {
                 k_sleep(K_MSEC(GATEWAY_PROC_THREAD_SLEEP_TIME_MS));
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+                recv_model_msgs();
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
                 proc_data = k_fifo_get(&gateway_proc_fifo, K_NO_WAIT);
 
                 if (proc_data == NULL) {
                         continue;
                 }
 
+                atomic_dec(&proc_pending);
+
+#if defined(CONFIG_GATEWAY_JSON_ARENA)
+                json_arena_begin();
+#endif // defined(CONFIG_GATEWAY_JSON_ARENA)
+
                 switch (proc_data->proc) {
                         case GATEWAY_PROC_BEACON_REQ:
                                 log_proc(GATEWAY_PROC_BEACON_REQ);
-                                beacon_req();
+                                beacon_req(proc_data->op_obj);
                                 break;
 
+			case GATEWAY_PROC_BEACON_BLOCK:
+				log_proc(GATEWAY_PROC_BEACON_BLOCK);
+				beacon_block_change(proc_data->op_obj, true);
+				break;
+
+			case GATEWAY_PROC_BEACON_UNBLOCK:
+				log_proc(GATEWAY_PROC_BEACON_UNBLOCK);
+				beacon_block_change(proc_data->op_obj, false);
+				break;
+
+			case GATEWAY_PROC_BEACON_BLOCK_REQ:
+				log_proc(GATEWAY_PROC_BEACON_BLOCK_REQ);
+				beacon_block_req(proc_data->op_obj);
+				break;
+
                         case GATEWAY_PROC_PROV:
                                 log_proc(GATEWAY_PROC_PROV);
                                 prov_dev(proc_data->op_obj);
@@ -1046,10 +1987,37 @@ static void gateway_process(int unused1, int unused2, int unused3)
 
                         case GATEWAY_PROC_PROV_RESP:
                                 log_proc(GATEWAY_PROC_PROV_RESP);
-                                prov_result(prov.err, prov.uuid, prov.net_idx, prov.addr,
-                                                prov.num_elem);
+                                prov_result(proc_data->prov_res.err, proc_data->prov_res.uuid,
+                                                proc_data->prov_res.net_idx,
+                                                proc_data->prov_res.addr,
+                                                proc_data->prov_res.num_elem);
+#if defined(CONFIG_GATEWAY_PROV_PROFILE)
+                                if (!proc_data->prov_res.err) {
+                                        node_ready(proc_data->prov_res.uuid,
+                                                        proc_data->prov_res.net_idx,
+                                                        proc_data->prov_res.addr,
+                                                        proc_data->prov_res.num_elem,
+                                                        proc_data->prov_res.profile[0] ?
+                                                        proc_data->prov_res.profile : NULL);
+                                }
+#endif // defined(CONFIG_GATEWAY_PROV_PROFILE)
                                 break;
 
+			case GATEWAY_PROC_PROV_BULK:
+				log_proc(GATEWAY_PROC_PROV_BULK);
+				prov_bulk(proc_data->op_obj);
+				break;
+
+			case GATEWAY_PROC_PROV_QUEUE_FLUSH:
+				log_proc(GATEWAY_PROC_PROV_QUEUE_FLUSH);
+				prov_queue_flush();
+				break;
+
+			case GATEWAY_PROC_PROV_QUEUE_STATUS:
+				log_proc(GATEWAY_PROC_PROV_QUEUE_STATUS);
+				prov_queue_status();
+				break;
+
                         case GATEWAY_PROC_SUBNET_ADD:
                                 log_proc(GATEWAY_PROC_SUBNET_ADD);
                                 subnet_add(proc_data->op_obj);
@@ -1096,7 +2064,7 @@ static void gateway_process(int unused1, int unused2, int unused3)
 
                         case GATEWAY_PROC_NODE_REQ:
                                 log_proc(GATEWAY_PROC_NODE_REQ);
-                                node_req();
+                                node_req(proc_data->op_obj);
                                 break;
 
                         case GATEWAY_PROC_NODE_DISC:
@@ -1109,6 +2077,108 @@ static void gateway_process(int unused1, int unused2, int unused3)
                                 node_cfg(proc_data->op_obj);
                                 break;
 
+                        case GATEWAY_PROC_NODE_CFG_TXN:
+                                log_proc(GATEWAY_PROC_NODE_CFG_TXN);
+                                node_cfg_txn(proc_data->op_obj);
+                                break;
+
+#if defined(CONFIG_GATEWAY_FANOUT)
+			case GATEWAY_PROC_FANOUT_START:
+				log_proc(GATEWAY_PROC_FANOUT_START);
+				fanout_start_req(proc_data->op_obj);
+				break;
+
+			case GATEWAY_PROC_FANOUT_CANCEL:
+				log_proc(GATEWAY_PROC_FANOUT_CANCEL);
+				fanout_cancel();
+				break;
+
+			case GATEWAY_PROC_FANOUT_STATUS:
+				log_proc(GATEWAY_PROC_FANOUT_STATUS);
+				fanout_progress();
+				break;
+
+			case GATEWAY_PROC_FANOUT_NODE:
+				log_proc(GATEWAY_PROC_FANOUT_NODE);
+				fanout_node(&proc_data->fanout_res);
+				break;
+#endif // defined(CONFIG_GATEWAY_FANOUT)
+
+#if defined(CONFIG_GATEWAY_PROV_PROFILE)
+			case GATEWAY_PROC_PROV_PROFILE_SET:
+				log_proc(GATEWAY_PROC_PROV_PROFILE_SET);
+				prov_profile_set(proc_data->op_obj);
+				break;
+
+			case GATEWAY_PROC_PROV_PROFILE_DEL:
+				log_proc(GATEWAY_PROC_PROV_PROFILE_DEL);
+				prov_profile_del(proc_data->op_obj);
+				break;
+
+			case GATEWAY_PROC_PROV_PROFILE_REQ:
+				log_proc(GATEWAY_PROC_PROV_PROFILE_REQ);
+				prov_profile_list();
+				break;
+#endif // defined(CONFIG_GATEWAY_PROV_PROFILE)
+
+#if defined(CONFIG_GATEWAY_RECONCILE)
+			case GATEWAY_PROC_RECONCILE_SET:
+				log_proc(GATEWAY_PROC_RECONCILE_SET);
+				reconcile_set(proc_data->op_obj);
+				break;
+
+			case GATEWAY_PROC_RECONCILE_DEL:
+				log_proc(GATEWAY_PROC_RECONCILE_DEL);
+				reconcile_del(proc_data->op_obj);
+				break;
+
+			case GATEWAY_PROC_RECONCILE_STATUS:
+				log_proc(GATEWAY_PROC_RECONCILE_STATUS);
+				reconcile_status();
+				break;
+#endif // defined(CONFIG_GATEWAY_RECONCILE)
+
+#if defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+			case GATEWAY_PROC_PROV_ALLOW_ADD:
+				log_proc(GATEWAY_PROC_PROV_ALLOW_ADD);
+				prov_allow_update(proc_data->op_obj, true);
+				break;
+
+			case GATEWAY_PROC_PROV_ALLOW_DEL:
+				log_proc(GATEWAY_PROC_PROV_ALLOW_DEL);
+				prov_allow_update(proc_data->op_obj, false);
+				break;
+
+			case GATEWAY_PROC_PROV_ALLOW_REQ:
+				log_proc(GATEWAY_PROC_PROV_ALLOW_REQ);
+				prov_allow_list();
+				break;
+#endif // defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+
+#if defined(CONFIG_GATEWAY_BEACON_EVENTS)
+			case GATEWAY_PROC_BEACON_EVENTS_SET:
+				log_proc(GATEWAY_PROC_BEACON_EVENTS_SET);
+				beacon_events_set(proc_data->op_obj);
+				break;
+
+			case GATEWAY_PROC_BEACON_EVENTS:
+				log_proc(GATEWAY_PROC_BEACON_EVENTS);
+				beacon_events_send();
+				break;
+#endif // defined(CONFIG_GATEWAY_BEACON_EVENTS)
+
+#if defined(CONFIG_GATEWAY_UPLINK_RULES)
+			case GATEWAY_PROC_UPLINK_RULES_SET:
+				log_proc(GATEWAY_PROC_UPLINK_RULES_SET);
+				uplink_rules_update(proc_data->op_obj);
+				break;
+
+			case GATEWAY_PROC_UPLINK_RULES_REQ:
+				log_proc(GATEWAY_PROC_UPLINK_RULES_REQ);
+				uplink_rules_req(proc_data->op_obj);
+				break;
+#endif // defined(CONFIG_GATEWAY_UPLINK_RULES)
+
                         case GATEWAY_PROC_SUBSCRIBE:
                                 log_proc(GATEWAY_PROC_SUBSCRIBE);
                                 subscribe(proc_data->op_obj);
@@ -1124,13 +2194,6 @@ static void gateway_process(int unused1, int unused2, int unused3)
                                 subscribe_req(proc_data->op_obj);
                                 break;
 
-                        case GATEWAY_PROC_RECV_MODEL_MSG:
-                                log_proc(GATEWAY_PROC_RECV_MODEL_MSG);
-                                recv_model_msg(proc_data->opcode, proc_data->msg_ctx,
-                                                proc_data->payload, proc_data->payload_len);
-                                k_free(proc_data->payload);
-                                break;
-
 #if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
                         case GATEWAY_PROC_SEND_MODEL_MSG:
                                 log_proc(GATEWAY_PROC_SEND_MODEL_MSG);
@@ -1141,7 +2204,10 @@ static void gateway_process(int unused1, int unused2, int unused3)
 			case GATEWAY_PROC_HLTH_FAULT_CUR:
 				log_proc(GATEWAY_PROC_HLTH_FAULT_CUR);
 				hlth_fault_cur(proc_data->addr, proc_data->test_id, proc_data->cid,
-						proc_data->faults, proc_data->fault_count);
+						proc_data->faults, proc_data->fault_count,
+						proc_data->recv_time);
+				atomic_set(&telemetry_latency,
+						k_uptime_get() - proc_data->recv_time);
 				k_free(proc_data->faults);
 				break;
 
@@ -1190,12 +2256,43 @@ static void gateway_process(int unused1, int unused2, int unused3)
 				hlth_timeout_set(proc_data->op_obj);
 				break;
 
+			case GATEWAY_PROC_MESH_STATS:
+				log_proc(GATEWAY_PROC_MESH_STATS);
+				mesh_stats(proc_data->op_obj);
+				break;
+
+#if defined(CONFIG_GATEWAY_SWEEP)
+			case GATEWAY_PROC_SWEEP_START:
+				log_proc(GATEWAY_PROC_SWEEP_START);
+				sweep_start_req(proc_data->op_obj);
+				break;
+
+			case GATEWAY_PROC_SWEEP_STOP:
+				log_proc(GATEWAY_PROC_SWEEP_STOP);
+				sweep_stop();
+				break;
+
+			case GATEWAY_PROC_SWEEP_STATUS:
+				log_proc(GATEWAY_PROC_SWEEP_STATUS);
+				sweep_progress(BT_MESH_ADDR_UNASSIGNED, 0, 0);
+				break;
+
+			case GATEWAY_PROC_SWEEP_NODE:
+				log_proc(GATEWAY_PROC_SWEEP_NODE);
+				sweep_node(proc_data->node, proc_data->addr, proc_data->err,
+						proc_data->status);
+				break;
+#endif // defined(CONFIG_GATEWAY_SWEEP)
+
                         default:
                                 LOG_ERR("Unkown gateway process type: %d", proc_data->proc);
                                 break;
                 }
 
                 cJSON_Delete(proc_data->root_obj);
+#if defined(CONFIG_GATEWAY_JSON_ARENA)
+                json_arena_end(proc_data->proc);
+#endif // defined(CONFIG_GATEWAY_JSON_ARENA)
                 k_free(proc_data);
         }
 }
@@ -1203,67 +2300,32 @@ static void gateway_process(int unused1, int unused2, int unused3)
 K_THREAD_DEFINE(gateway_proc_thread, GATEWAY_PROC_THREAD_STACK_SIZE,
                 gateway_process, NULL, NULL, NULL, GATEWAY_PROC_THREAD_PRIORITY, 0, 0);
 
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+static void rx_notify(struct rx_bus_consumer *consumer)
+{
+	/* Cut the poll interval short, the thread drains the ring before the next procedure */
+	k_wakeup(gateway_proc_thread);
+}
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+
 void gateway_node_added(uint16_t net_idx, uint8_t uuid[UUID_LEN], uint16_t addr, uint8_t num_elem)
 {
         char uuid_str[UUID_STR_LEN];
-        struct gateway_proc_data proc_data;
-        struct gateway_proc_data *mem_ptr;
 
-        /* Check to see if this is the callback from a gateway provision attempt */
-        if (util_uuid_cmp(prov.uuid, uuid)) {
+        /* Check to see if this is the callback from a gateway provision attempt. The queue
+         * thread waiting on the attempt is woken from here, never through the processing
+         * thread, which may itself be busy. The queue then reports the result from its own
+         * thread. */
+        if (!prov_queue_node_added(net_idx, uuid, addr, num_elem)) {
                 return;
         }
 
-        k_work_cancel_delayable(&prov_timeout_work);
         util_uuid2str(uuid, uuid_str);
         LOG_INF("Gateway request to provision complete:");
         LOG_INF("  UUID         : %s", log_strdup(uuid_str));
         LOG_INF("  Net Index     : 0x%04x", net_idx);
         LOG_INF("  Address      : 0x%04x", addr);
         LOG_INF("  Element Count: %d", num_elem);
-
-        prov_result(0, uuid, net_idx, addr, num_elem); // TODO: Fix this
-        return;
-
-        proc_data.proc = GATEWAY_PROC_PROV_RESP;
-        prov.net_idx = net_idx;
-        prov.addr = addr;
-        prov.num_elem = num_elem;
-
-        mem_ptr = k_malloc(sizeof(proc_data));
-
-        if (mem_ptr == NULL) {
-                LOG_ERR("Failed to allocate memory for process data");
-                k_sem_give(&prov_sem);
-                return;
-        }
-
-        memcpy(mem_ptr, &proc_data, sizeof(proc_data));
-        k_fifo_put(&gateway_proc_fifo, mem_ptr);
-}
-
-void gateway_msg_callback(uint32_t opcode, struct bt_mesh_msg_ctx *ctx, struct net_buf_simple *buf)
-{
-        uint8_t *payload;
-        struct gateway_proc_data proc_data;
-        struct gateway_proc_data *proc_ptr;
-
-        payload = k_malloc(sizeof(uint8_t) * buf->len);
-        memcpy(payload, buf->data, buf->len);
-
-        proc_data.proc = GATEWAY_PROC_RECV_MODEL_MSG;
-        proc_data.root_obj = NULL;
-        proc_data.opcode = opcode;
-        proc_data.msg_ctx.net_idx= ctx->net_idx;
-        proc_data.msg_ctx.app_idx = ctx->app_idx;
-        proc_data.msg_ctx.addr = ctx->addr;
-        proc_data.msg_ctx.recv_dst = ctx->recv_dst;
-        proc_data.payload = payload;
-        proc_data.payload_len = buf->len;
-
-        proc_ptr = k_malloc(sizeof(proc_data));
-        memcpy(proc_ptr, &proc_data, sizeof(proc_data));
-        k_fifo_put(&gateway_proc_fifo, proc_ptr);
 }
 
 void gateway_hlth_cb(uint16_t addr, uint8_t test_id, uint16_t cid, uint8_t *faults,
@@ -1283,10 +2345,11 @@ void gateway_hlth_cb(uint16_t addr, uint8_t test_id, uint16_t cid, uint8_t *faul
 	proc_data.cid = cid;
 	proc_data.faults = faults_store;
 	proc_data.fault_count = fault_count;
+	proc_data.recv_time = k_uptime_get();
 
 	proc_ptr = k_malloc(sizeof(proc_data));
 	memcpy(proc_ptr, &proc_data, sizeof(proc_data));
-	k_fifo_put(&gateway_proc_fifo, proc_ptr);
+	proc_queue(proc_ptr);
 }
 
 enum gateway_handler_err {
@@ -1322,6 +2385,9 @@ uint8_t gateway_handler(const struct cloud_msg *gw_data)
         cJSON *op_type_obj;
         struct gateway_proc_data proc_data;
         struct gateway_proc_data *mem_ptr;
+#if defined(CONFIG_GATEWAY_CODEC_STATS)
+        uint32_t start;
+#endif // defined(CONFIG_GATEWAY_CODEC_STATS)
 
 	LOG_DBG("Cloud message len:%d, topic:%s, data:%s",
 		gw_data->len,
@@ -1333,7 +2399,14 @@ uint8_t gateway_handler(const struct cloud_msg *gw_data)
 		return 0;
 	}
 
+#if defined(CONFIG_GATEWAY_CODEC_STATS)
+        start = k_cycle_get_32();
+        root_obj = cJSON_Parse(gw_data->buf);
+        codec_stats_record("cloud_request", k_cycle_get_32() - start, gw_data->len,
+                        root_obj != NULL);
+#else
         root_obj = cJSON_Parse(gw_data->buf);
+#endif // defined(CONFIG_GATEWAY_CODEC_STATS)
 
         if (root_obj == NULL) {
 		log_handler_err(HANDLER_ERR_JSON_PARSE);
@@ -1402,10 +2475,34 @@ uint8_t gateway_handler(const struct cloud_msg *gw_data)
                 log_handler_proc(GATEWAY_PROC_BEACON_REQ);
                 proc_data.proc = GATEWAY_PROC_BEACON_REQ;
 
+	} else if (strings_equal(op_type_str, "beacon_block")) {
+		log_handler_proc(GATEWAY_PROC_BEACON_BLOCK);
+		proc_data.proc = GATEWAY_PROC_BEACON_BLOCK;
+
+	} else if (strings_equal(op_type_str, "beacon_unblock")) {
+		log_handler_proc(GATEWAY_PROC_BEACON_UNBLOCK);
+		proc_data.proc = GATEWAY_PROC_BEACON_UNBLOCK;
+
+	} else if (strings_equal(op_type_str, "beacon_blocklist_request")) {
+		log_handler_proc(GATEWAY_PROC_BEACON_BLOCK_REQ);
+		proc_data.proc = GATEWAY_PROC_BEACON_BLOCK_REQ;
+
         } else if (strings_equal(op_type_str, "provision")) {
                 log_handler_proc(GATEWAY_PROC_PROV);
                 proc_data.proc = GATEWAY_PROC_PROV;
 
+	} else if (strings_equal(op_type_str, "provision_bulk")) {
+		log_handler_proc(GATEWAY_PROC_PROV_BULK);
+		proc_data.proc = GATEWAY_PROC_PROV_BULK;
+
+	} else if (strings_equal(op_type_str, "provision_queue_flush")) {
+		log_handler_proc(GATEWAY_PROC_PROV_QUEUE_FLUSH);
+		proc_data.proc = GATEWAY_PROC_PROV_QUEUE_FLUSH;
+
+	} else if (strings_equal(op_type_str, "provision_queue_status_request")) {
+		log_handler_proc(GATEWAY_PROC_PROV_QUEUE_STATUS);
+		proc_data.proc = GATEWAY_PROC_PROV_QUEUE_STATUS;
+
         } else if (strings_equal(op_type_str, "subnet_add")) {
                 log_handler_proc(GATEWAY_PROC_SUBNET_ADD);
                 proc_data.proc = GATEWAY_PROC_SUBNET_ADD;
@@ -1454,6 +2551,82 @@ uint8_t gateway_handler(const struct cloud_msg *gw_data)
                 log_handler_proc(GATEWAY_PROC_NODE_CFG);
                 proc_data.proc = GATEWAY_PROC_NODE_CFG;
 
+        } else if (strings_equal(op_type_str, "node_configure_transaction")) {
+                log_handler_proc(GATEWAY_PROC_NODE_CFG_TXN);
+                proc_data.proc = GATEWAY_PROC_NODE_CFG_TXN;
+
+#if defined(CONFIG_GATEWAY_FANOUT)
+	} else if (strings_equal(op_type_str, "node_configure_fanout")) {
+		log_handler_proc(GATEWAY_PROC_FANOUT_START);
+		proc_data.proc = GATEWAY_PROC_FANOUT_START;
+
+	} else if (strings_equal(op_type_str, "node_configure_fanout_cancel")) {
+		log_handler_proc(GATEWAY_PROC_FANOUT_CANCEL);
+		proc_data.proc = GATEWAY_PROC_FANOUT_CANCEL;
+
+	} else if (strings_equal(op_type_str, "node_configure_fanout_status_request")) {
+		log_handler_proc(GATEWAY_PROC_FANOUT_STATUS);
+		proc_data.proc = GATEWAY_PROC_FANOUT_STATUS;
+#endif // defined(CONFIG_GATEWAY_FANOUT)
+
+#if defined(CONFIG_GATEWAY_PROV_PROFILE)
+	} else if (strings_equal(op_type_str, "provision_profile_set")) {
+		log_handler_proc(GATEWAY_PROC_PROV_PROFILE_SET);
+		proc_data.proc = GATEWAY_PROC_PROV_PROFILE_SET;
+
+	} else if (strings_equal(op_type_str, "provision_profile_delete")) {
+		log_handler_proc(GATEWAY_PROC_PROV_PROFILE_DEL);
+		proc_data.proc = GATEWAY_PROC_PROV_PROFILE_DEL;
+
+	} else if (strings_equal(op_type_str, "provision_profile_list_request")) {
+		log_handler_proc(GATEWAY_PROC_PROV_PROFILE_REQ);
+		proc_data.proc = GATEWAY_PROC_PROV_PROFILE_REQ;
+#endif // defined(CONFIG_GATEWAY_PROV_PROFILE)
+
+#if defined(CONFIG_GATEWAY_RECONCILE)
+	} else if (strings_equal(op_type_str, "node_desired_state_set")) {
+		log_handler_proc(GATEWAY_PROC_RECONCILE_SET);
+		proc_data.proc = GATEWAY_PROC_RECONCILE_SET;
+
+	} else if (strings_equal(op_type_str, "node_desired_state_delete")) {
+		log_handler_proc(GATEWAY_PROC_RECONCILE_DEL);
+		proc_data.proc = GATEWAY_PROC_RECONCILE_DEL;
+
+	} else if (strings_equal(op_type_str, "node_desired_state_status_request")) {
+		log_handler_proc(GATEWAY_PROC_RECONCILE_STATUS);
+		proc_data.proc = GATEWAY_PROC_RECONCILE_STATUS;
+#endif // defined(CONFIG_GATEWAY_RECONCILE)
+
+#if defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+	} else if (strings_equal(op_type_str, "provision_allowlist_add")) {
+		log_handler_proc(GATEWAY_PROC_PROV_ALLOW_ADD);
+		proc_data.proc = GATEWAY_PROC_PROV_ALLOW_ADD;
+
+	} else if (strings_equal(op_type_str, "provision_allowlist_delete")) {
+		log_handler_proc(GATEWAY_PROC_PROV_ALLOW_DEL);
+		proc_data.proc = GATEWAY_PROC_PROV_ALLOW_DEL;
+
+	} else if (strings_equal(op_type_str, "provision_allowlist_request")) {
+		log_handler_proc(GATEWAY_PROC_PROV_ALLOW_REQ);
+		proc_data.proc = GATEWAY_PROC_PROV_ALLOW_REQ;
+#endif // defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+
+#if defined(CONFIG_GATEWAY_BEACON_EVENTS)
+	} else if (strings_equal(op_type_str, "beacon_events_set")) {
+		log_handler_proc(GATEWAY_PROC_BEACON_EVENTS_SET);
+		proc_data.proc = GATEWAY_PROC_BEACON_EVENTS_SET;
+#endif // defined(CONFIG_GATEWAY_BEACON_EVENTS)
+
+#if defined(CONFIG_GATEWAY_UPLINK_RULES)
+	} else if (strings_equal(op_type_str, "uplink_rules_set")) {
+		log_handler_proc(GATEWAY_PROC_UPLINK_RULES_SET);
+		proc_data.proc = GATEWAY_PROC_UPLINK_RULES_SET;
+
+	} else if (strings_equal(op_type_str, "uplink_rules_request")) {
+		log_handler_proc(GATEWAY_PROC_UPLINK_RULES_REQ);
+		proc_data.proc = GATEWAY_PROC_UPLINK_RULES_REQ;
+#endif // defined(CONFIG_GATEWAY_UPLINK_RULES)
+
         } else if (strings_equal(op_type_str, "subscribe")) {
                 log_handler_proc(GATEWAY_PROC_SUBSCRIBE);
                 proc_data.proc = GATEWAY_PROC_SUBSCRIBE;
@@ -1508,6 +2681,24 @@ uint8_t gateway_handler(const struct cloud_msg *gw_data)
 		log_handler_proc(GATEWAY_PROC_HLTH_TIMEOUT_SET);
 		proc_data.proc = GATEWAY_PROC_HLTH_TIMEOUT_SET;
 
+	} else if (strings_equal(op_type_str, "mesh_stats_request")) {
+		log_handler_proc(GATEWAY_PROC_MESH_STATS);
+		proc_data.proc = GATEWAY_PROC_MESH_STATS;
+
+#if defined(CONFIG_GATEWAY_SWEEP)
+	} else if (strings_equal(op_type_str, "node_sweep_start")) {
+		log_handler_proc(GATEWAY_PROC_SWEEP_START);
+		proc_data.proc = GATEWAY_PROC_SWEEP_START;
+
+	} else if (strings_equal(op_type_str, "node_sweep_stop")) {
+		log_handler_proc(GATEWAY_PROC_SWEEP_STOP);
+		proc_data.proc = GATEWAY_PROC_SWEEP_STOP;
+
+	} else if (strings_equal(op_type_str, "node_sweep_status_request")) {
+		log_handler_proc(GATEWAY_PROC_SWEEP_STATUS);
+		proc_data.proc = GATEWAY_PROC_SWEEP_STATUS;
+#endif // defined(CONFIG_GATEWAY_SWEEP)
+
 	} else {
 		log_handler_err(HANDLER_ERR_UNKOWN_OP_TYPE);
                 k_free(mem_ptr);
@@ -1516,7 +2707,7 @@ uint8_t gateway_handler(const struct cloud_msg *gw_data)
         }
 
         memcpy(mem_ptr, &proc_data, sizeof(proc_data));
-        k_fifo_put(&gateway_proc_fifo, mem_ptr);
+        proc_queue(mem_ptr);
         return 0;
 
 handler_err:
@@ -1533,11 +2724,142 @@ int gateway_init(struct k_work_q *_work_q)
         }
 
         work_q = _work_q;
-        k_work_init_delayable(&prov_timeout_work, prov_timeout);
 
         cJSON_Init();
 
+#if defined(CONFIG_GATEWAY_JSON_ARENA)
+        arena_init(&json_arena, json_arena_buf, sizeof(json_arena_buf));
+#endif // defined(CONFIG_GATEWAY_JSON_ARENA)
+
+#if defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+        compress_init(CODEC_DICT_ID, compress_dict,
+                        codec_build_dict(compress_dict, sizeof(compress_dict)));
+#endif // defined(CONFIG_GATEWAY_UPLINK_COMPRESSION)
+
         k_thread_name_set(gateway_proc_thread, "gateway_proc_thread");
 
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+        rx_bus_subscribe(&rx_consumer);
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+
+        prov_queue_init();
+
+#if defined(CONFIG_GATEWAY_SWEEP)
+        sweep_init();
+#endif // defined(CONFIG_GATEWAY_SWEEP)
+
+#if defined(CONFIG_GATEWAY_FANOUT)
+        fanout_init();
+#endif // defined(CONFIG_GATEWAY_FANOUT)
+
+#if defined(CONFIG_GATEWAY_RECONCILE)
+        reconcile_init();
+#endif // defined(CONFIG_GATEWAY_RECONCILE)
+
+#if defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+        prov_allow_init();
+#endif // defined(CONFIG_GATEWAY_PROV_ALLOWLIST)
+
+        return 0;
+}
+
+void gateway_load_get(size_t *queue_depth, uint32_t *latency_ms)
+{
+        *queue_depth = atomic_get(&proc_pending);
+#if defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+        *queue_depth += rx_bus_pending(&rx_consumer);
+#endif // defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+        /* Only meaningful while there is a backlog, an empty queue is sent right away */
+        *latency_ms = *queue_depth ? atomic_get(&telemetry_latency) : 0;
+}
+
+void gateway_prov_result(const struct prov_queue_result *res)
+{
+	struct gateway_proc_data proc_data = {
+		.prov_res = *res,
+	};
+
+	/* Reported from the processing thread, which also applies any provisioning profile to
+	 * the node */
+	proc_post(GATEWAY_PROC_PROV_RESP, &proc_data);
+}
+
+#if defined(CONFIG_GATEWAY_BEACON_EVENTS)
+void gateway_beacon_events(void)
+{
+	proc_post(GATEWAY_PROC_BEACON_EVENTS, NULL);
+}
+#endif // defined(CONFIG_GATEWAY_BEACON_EVENTS)
+
+void gateway_prov_queue_status(void)
+{
+	proc_post(GATEWAY_PROC_PROV_QUEUE_STATUS, NULL);
+}
+
+#if defined(CONFIG_GATEWAY_SWEEP)
+void gateway_sweep_node(struct btmesh_node *node, int err, uint8_t status)
+{
+	struct gateway_proc_data proc_data = {
+		.addr = node->addr,
+		.err = err,
+		.status = status,
+	};
+
+	if (!err) {
+		proc_data.node = k_malloc(sizeof(*node));
+
+		if (proc_data.node == NULL) {
+			log_err(ERR_PROC_DATA_MEM, 0);
+			btmesh_free_node(node);
+			return;
+		}
+
+		memcpy(proc_data.node, node, sizeof(*node));
+	}
+
+	if (!proc_post(GATEWAY_PROC_SWEEP_NODE, &proc_data) && !err) {
+		btmesh_free_node(proc_data.node);
+		k_free(proc_data.node);
+	}
+}
+
+void gateway_sweep_progress(void)
+{
+	proc_post(GATEWAY_PROC_SWEEP_STATUS, NULL);
+}
+#endif // defined(CONFIG_GATEWAY_SWEEP)
+
+#if defined(CONFIG_GATEWAY_FANOUT)
+void gateway_fanout_node(const struct fanout_result *res)
+{
+	struct gateway_proc_data proc_data = {
+		.fanout_res = *res,
+	};
+
+	proc_post(GATEWAY_PROC_FANOUT_NODE, &proc_data);
+}
+
+void gateway_fanout_progress(void)
+{
+	proc_post(GATEWAY_PROC_FANOUT_STATUS, NULL);
+}
+#endif // defined(CONFIG_GATEWAY_FANOUT)
+
+#if defined(CONFIG_GATEWAY_RECONCILE)
+void gateway_reconcile_status(void)
+{
+	proc_post(GATEWAY_PROC_RECONCILE_STATUS, NULL);
+}
+#endif // defined(CONFIG_GATEWAY_RECONCILE)
+
+#if defined(CONFIG_GATEWAY_JSON_ARENA)
+int gateway_arena_stats_get(size_t proc, struct gateway_arena_stats *stats)
+{
+        if (proc >= GATEWAY_PROC_COUNT) {
+                return -ENOENT;
+        }
+
+        memcpy(stats, &json_arena_stats[proc], sizeof(*stats));
         return 0;
 }
+#endif // defined(CONFIG_GATEWAY_JSON_ARENA)
@@ -10,20 +10,54 @@ extern "C" {
 #include <bluetooth/mesh.h>
 #include <net/cloud.h>
 
+#include "btmesh.h"
+#include "fanout.h"
+#include "prov_queue.h"
 #include "util.h"
 #include "nrf_cloud_transport.h"
 
+struct gateway_arena_stats {
+	uint32_t count;
+	uint32_t allocs;
+	uint32_t fallbacks;
+	size_t hwm;
+};
+
 uint8_t gateway_handler(const struct cloud_msg *gw_data);
 
 void gateway_node_added(uint16_t net_idx, uint8_t uuid[UUID_LEN], uint16_t addr, uint8_t num_elem);
 
-void gateway_msg_callback(uint32_t opcode, struct bt_mesh_msg_ctx *ctx, struct net_buf_simple *buf);
-
 void gateway_hlth_cb(uint16_t addr, uint8_t test_id, uint16_t cid, uint8_t *faults,
 		size_t fault_count);
 
 int gateway_init(struct k_work_q *_work_q);
 
+/* Report a device provisioned, or given up on, by the provisioning queue */
+void gateway_prov_result(const struct prov_queue_result *res);
+
+void gateway_prov_queue_status(void);
+
+/* Send the beacon changes collected since the last batch */
+void gateway_beacon_events(void);
+
+int gateway_arena_stats_get(size_t proc, struct gateway_arena_stats *stats);
+
+/* Procedures waiting to be processed, and the delay of received telemetry while they wait */
+void gateway_load_get(size_t *queue_depth, uint32_t *latency_ms);
+
+/* Report a node discovered by a sweep. On success the gateway takes over the node. */
+void gateway_sweep_node(struct btmesh_node *node, int err, uint8_t status);
+
+void gateway_sweep_progress(void);
+
+/* Report a node configured by a fan-out */
+void gateway_fanout_node(const struct fanout_result *res);
+
+void gateway_fanout_progress(void);
+
+/* Report the convergence of the desired node states */
+void gateway_reconcile_status(void);
+
 
 #ifdef __cplusplus
 }
@@ -11,6 +11,7 @@
 #include <nrf_socket.h>
 #endif
 
+#include "codec.h"
 #include "error.h"
 #include "lte.h"
 #include "nrf_cloud_transport.h"
@@ -38,6 +39,7 @@ LOG_MODULE_REGISTER(app_gw_cloud, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
 char gateway_id[NRF_CLOUD_CLIENT_ID_LEN+1];
 
 static char device_id[64];
+static atomic_t device_id_valid;
 
 static void(*error_handler)(enum error_type type, int err);
 
@@ -196,6 +198,11 @@ static void connection_event_handler(const struct cloud_event *const evt)
         k_work_cancel_delayable(&cloud_reboot_work);
         k_sem_take(&cloud_disconnected, K_NO_WAIT);
         atomic_set(&cloud_connect_attempts, 0);
+
+        /* The gateway ID and time offset used in event envelopes are refreshed once per
+         * connection */
+        atomic_clear(&device_id_valid);
+        codec_epoch_reset();
 #if !IS_ENABLED(CONFIG_MQTT_CLEAN_SESSION)
         LOG_INF("Persistant Sessions = %u", evt->data.persistent_session);
 #endif
@@ -515,6 +522,10 @@ const char *gw_cloud_get_id(void)
 {
     int err;
 
+    if (atomic_get(&device_id_valid)) {
+        return device_id;
+    }
+
     err = cloud_get_id(cloud_backend, device_id, sizeof(device_id));
 
     if (err) {
@@ -522,6 +533,7 @@ const char *gw_cloud_get_id(void)
         return NULL;
     }
 
+    atomic_set(&device_id_valid, 1);
     return device_id;
 }
 
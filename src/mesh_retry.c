@@ -0,0 +1,239 @@
+#include <zephyr.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+#include <random/rand32.h>
+#include <logging/log.h>
+
+#include "btmesh.h"
+#include "mesh_retry.h"
+#include "util.h"
+
+/* Retransmission timeout estimation after RFC 6298. The smoothed RTT is kept scaled by 8
+ * and the RTT variance by 4, so both update with shifts only:
+ *   SRTT   = 7/8 SRTT + 1/8 R
+ *   RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|
+ *   RTO    = SRTT + max(G, 4 RTTVAR)
+ */
+#define SRTT_SHIFT 3
+#define RTTVAR_SHIFT 2
+/* Clock granularity term of the RTO */
+#define RTO_GRANULARITY_MS 10
+
+
+LOG_MODULE_REGISTER(app_mesh_retry, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+struct node_rtt {
+	uint16_t addr;
+	uint32_t srtt8;
+	uint32_t rttvar4;
+	uint32_t rto;
+	uint32_t sample_count;
+	uint32_t timeout_count;
+	int64_t last_used;
+};
+
+static struct node_rtt nodes[CONFIG_GATEWAY_MESH_RTT_NODES];
+static struct mesh_retry_op_stats op_stats[BTMESH_OP_COUNT];
+static struct k_spinlock lock;
+
+static struct node_rtt *node_find(uint16_t addr)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(nodes); i++) {
+		if (nodes[i].addr == addr) {
+			return &nodes[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Find the entry of addr, or take over the free or least recently used one */
+static struct node_rtt *node_get(uint16_t addr)
+{
+	int i;
+	struct node_rtt *node;
+
+	node = node_find(addr);
+
+	if (node != NULL) {
+		return node;
+	}
+
+	node = &nodes[0];
+
+	for (i = 0; i < ARRAY_SIZE(nodes); i++) {
+		if (nodes[i].addr == BT_MESH_ADDR_UNASSIGNED) {
+			node = &nodes[i];
+			break;
+		}
+
+		if (nodes[i].last_used < node->last_used) {
+			node = &nodes[i];
+		}
+	}
+
+	memset(node, 0, sizeof(*node));
+	node->addr = addr;
+	node->rto = CONFIG_GATEWAY_MESH_RTO_INIT_MS;
+	return node;
+}
+
+int32_t mesh_retry_rto_get(uint16_t addr)
+{
+	int32_t rto;
+	k_spinlock_key_t key;
+	struct node_rtt *node;
+
+	key = k_spin_lock(&lock);
+	node = node_find(addr);
+	rto = node ? node->rto : CONFIG_GATEWAY_MESH_RTO_INIT_MS;
+	k_spin_unlock(&lock, key);
+
+	return rto;
+}
+
+void mesh_retry_rtt_sample(uint16_t addr, uint32_t rtt_ms)
+{
+	int32_t delta;
+	uint32_t rto;
+	k_spinlock_key_t key;
+	struct node_rtt *node;
+
+	key = k_spin_lock(&lock);
+	node = node_get(addr);
+
+	if (node->sample_count == 0) {
+		node->srtt8 = rtt_ms << SRTT_SHIFT;
+		node->rttvar4 = rtt_ms << (RTTVAR_SHIFT - 1);
+	} else {
+		delta = rtt_ms - (node->srtt8 >> SRTT_SHIFT);
+		node->srtt8 += delta;
+
+		if (delta < 0) {
+			delta = -delta;
+		}
+
+		node->rttvar4 += delta - (node->rttvar4 >> RTTVAR_SHIFT);
+	}
+
+	rto = (node->srtt8 >> SRTT_SHIFT) + MAX(RTO_GRANULARITY_MS, node->rttvar4);
+	node->rto = CLAMP(rto, CONFIG_GATEWAY_MESH_RTO_MIN_MS, CONFIG_GATEWAY_MESH_RTO_MAX_MS);
+	node->sample_count++;
+	node->last_used = k_uptime_get();
+	k_spin_unlock(&lock, key);
+}
+
+void mesh_retry_timeout(uint16_t addr)
+{
+	uint32_t rto;
+	k_spinlock_key_t key;
+	struct node_rtt *node;
+
+	key = k_spin_lock(&lock);
+	node = node_get(addr);
+	/* Kept until the next sample replaces it */
+	node->rto = MIN(node->rto * 2, CONFIG_GATEWAY_MESH_RTO_MAX_MS);
+	node->timeout_count++;
+	node->last_used = k_uptime_get();
+	rto = node->rto;
+	k_spin_unlock(&lock, key);
+
+	LOG_DBG("Timeout for 0x%04x raised to %dms", addr, rto);
+}
+
+int32_t mesh_retry_backoff_get(int attempt)
+{
+	uint32_t delay;
+
+	if (attempt < 1) {
+		return 0;
+	}
+
+	delay = util_backoff(CONFIG_GATEWAY_MESH_RETRY_BACKOFF_MS, CONFIG_GATEWAY_MESH_RTO_MAX_MS,
+			attempt);
+
+	/* Half fixed, half random so retries from several requests do not line up */
+	return (delay / 2) + (sys_rand32_get() % ((delay / 2) + 1));
+}
+
+void mesh_retry_op_record(size_t op, int attempts, int timeouts, int err, uint32_t elapsed_ms)
+{
+	k_spinlock_key_t key;
+	struct mesh_retry_op_stats *stats;
+
+	if (op >= ARRAY_SIZE(op_stats)) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+	stats = &op_stats[op];
+	stats->count++;
+	stats->retry_count += attempts > 1 ? attempts - 1 : 0;
+	stats->timeout_count += timeouts;
+	stats->total_ms += elapsed_ms;
+
+	if (err) {
+		stats->fail_count++;
+	}
+
+	if (elapsed_ms > stats->max_ms) {
+		stats->max_ms = elapsed_ms;
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+int mesh_retry_op_stats_get(size_t op, struct mesh_retry_op_stats *stats)
+{
+	k_spinlock_key_t key;
+
+	if (op >= ARRAY_SIZE(op_stats)) {
+		return -ENOENT;
+	}
+
+	key = k_spin_lock(&lock);
+	*stats = op_stats[op];
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+int mesh_retry_node_get(size_t idx, struct mesh_retry_node *node)
+{
+	k_spinlock_key_t key;
+	struct node_rtt *entry;
+
+	if (idx >= ARRAY_SIZE(nodes)) {
+		return -ENOENT;
+	}
+
+	key = k_spin_lock(&lock);
+	entry = &nodes[idx];
+	node->addr = entry->addr;
+	node->srtt = entry->srtt8 >> SRTT_SHIFT;
+	node->rttvar = entry->rttvar4 >> RTTVAR_SHIFT;
+	node->rto = entry->rto;
+	node->sample_count = entry->sample_count;
+	node->timeout_count = entry->timeout_count;
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+void mesh_retry_stats_reset(void)
+{
+	int i;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&lock);
+	memset(op_stats, 0, sizeof(op_stats));
+
+	/* The estimates themselves are kept, only the counters start over */
+	for (i = 0; i < ARRAY_SIZE(nodes); i++) {
+		nodes[i].timeout_count = 0;
+	}
+
+	k_spin_unlock(&lock, key);
+}
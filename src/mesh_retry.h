@@ -0,0 +1,60 @@
+#ifndef MESH_RETRY_H_
+#define MESH_RETRY_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Outcome of every btmesh_perform_op() call for one operation type */
+struct mesh_retry_op_stats {
+	uint32_t count;
+	uint32_t fail_count;
+	uint32_t retry_count;
+	uint32_t timeout_count;
+	uint32_t total_ms;
+	uint32_t max_ms;
+};
+
+/* Round trip estimate for one node, all times in milliseconds */
+struct mesh_retry_node {
+	uint16_t addr;
+	uint32_t srtt;
+	uint32_t rttvar;
+	uint32_t rto;
+	uint32_t sample_count;
+	uint32_t timeout_count;
+};
+
+/* Timeout to use for the next request to addr. Nodes without any samples get
+ * CONFIG_GATEWAY_MESH_RTO_INIT_MS. */
+int32_t mesh_retry_rto_get(uint16_t addr);
+
+/* Feed a round trip time measured on a request that was answered on its first attempt */
+void mesh_retry_rtt_sample(uint16_t addr, uint32_t rtt_ms);
+
+/* Double the timeout of addr after a request to it timed out */
+void mesh_retry_timeout(uint16_t addr);
+
+/* Randomized delay before retry number attempt (starting at 1) */
+int32_t mesh_retry_backoff_get(int attempt);
+
+void mesh_retry_op_record(size_t op, int attempts, int timeouts, int err, uint32_t elapsed_ms);
+
+int mesh_retry_op_stats_get(size_t op, struct mesh_retry_op_stats *stats);
+
+int mesh_retry_node_get(size_t idx, struct mesh_retry_node *node);
+
+void mesh_retry_stats_reset(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* MESH_RETRY_H_ */
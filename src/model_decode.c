@@ -0,0 +1,513 @@
+#include <zephyr.h>
+#include <string.h>
+#include <sys/byteorder.h>
+#include <logging/log.h>
+
+#include "model_decode.h"
+
+#define OP_ONOFF_STATUS 0x8204
+#define OP_LEVEL_STATUS 0x8208
+#define OP_DEF_TRANS_TIME_STATUS 0x8210
+#define OP_ONPOWERUP_STATUS 0x8212
+#define OP_POWER_LEVEL_STATUS 0x8218
+#define OP_BATTERY_STATUS 0x8224
+#define OP_SENSOR_DESC_STATUS 0x51
+#define OP_SENSOR_STATUS 0x52
+#define OP_LIGHTNESS_STATUS 0x824E
+#define OP_LIGHTNESS_LINEAR_STATUS 0x8252
+#define OP_LIGHTNESS_LAST_STATUS 0x8254
+#define OP_CTL_STATUS 0x8260
+#define OP_CTL_TEMP_STATUS 0x8266
+#define OP_HSL_HUE_STATUS 0x8271
+#define OP_HSL_SAT_STATUS 0x8275
+#define OP_HSL_STATUS 0x8278
+#define OP_HSL_TARGET_STATUS 0x827A
+
+#define SENSOR_DESC_LEN 8
+#define SENSOR_PROP_PROHIBITED 0x0000
+/* Format B length of a property without a value */
+#define SENSOR_LEN_UNKNOWN 0x7F
+
+
+LOG_MODULE_REGISTER(app_model_decode, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+enum field_type {
+	FIELD_U8,
+	FIELD_U16,
+	FIELD_S16,
+	FIELD_U24,
+	/* Generic Default Transition Time encoding */
+	FIELD_TRANSITION,
+};
+
+struct field {
+	const char *name;
+	enum field_type type;
+};
+
+/* Messages with trailing optional fields, such as the target and remaining time of a
+ * transition, carry either the first min_count fields or all of them */
+struct decoder {
+	uint32_t opcode;
+	const struct field *fields;
+	uint8_t field_count;
+	uint8_t min_count;
+	/* Decodes the message instead of the field table */
+	int (*decode)(uint16_t addr, const uint8_t *payload, size_t len,
+			struct model_decoded *decoded);
+};
+
+/* Sensor values in the unit of the property, value = raw * scale */
+struct sensor_format {
+	uint16_t prop_id;
+	uint8_t len;
+	bool is_signed;
+	double scale;
+};
+
+struct desc_entry {
+	uint16_t addr;
+	uint16_t prop_id;
+	struct model_sensor_desc desc;
+};
+
+static const uint8_t field_lens[] = {
+	[FIELD_U8] = 1,
+	[FIELD_U16] = 2,
+	[FIELD_S16] = 2,
+	[FIELD_U24] = 3,
+	[FIELD_TRANSITION] = 1,
+};
+
+static const struct field onoff_fields[] = {
+	{ "onOff", FIELD_U8 },
+	{ "targetOnOff", FIELD_U8 },
+	{ "remainingTime", FIELD_TRANSITION },
+};
+
+static const struct field level_fields[] = {
+	{ "level", FIELD_S16 },
+	{ "targetLevel", FIELD_S16 },
+	{ "remainingTime", FIELD_TRANSITION },
+};
+
+static const struct field def_trans_time_fields[] = {
+	{ "transitionTime", FIELD_TRANSITION },
+};
+
+static const struct field onpowerup_fields[] = {
+	{ "onPowerUp", FIELD_U8 },
+};
+
+static const struct field power_level_fields[] = {
+	{ "power", FIELD_U16 },
+	{ "targetPower", FIELD_U16 },
+	{ "remainingTime", FIELD_TRANSITION },
+};
+
+static const struct field battery_fields[] = {
+	{ "batteryLevel", FIELD_U8 },
+	{ "timeToDischarge", FIELD_U24 },
+	{ "timeToCharge", FIELD_U24 },
+	{ "batteryFlags", FIELD_U8 },
+};
+
+static const struct field lightness_fields[] = {
+	{ "lightness", FIELD_U16 },
+	{ "targetLightness", FIELD_U16 },
+	{ "remainingTime", FIELD_TRANSITION },
+};
+
+/* The lightness the light returns to when turned on, not its current lightness */
+static const struct field lightness_last_fields[] = {
+	{ "lastLightness", FIELD_U16 },
+};
+
+static const struct field ctl_fields[] = {
+	{ "lightness", FIELD_U16 },
+	{ "temperature", FIELD_U16 },
+	{ "targetLightness", FIELD_U16 },
+	{ "targetTemperature", FIELD_U16 },
+	{ "remainingTime", FIELD_TRANSITION },
+};
+
+static const struct field ctl_temp_fields[] = {
+	{ "temperature", FIELD_U16 },
+	{ "deltaUv", FIELD_S16 },
+	{ "targetTemperature", FIELD_U16 },
+	{ "targetDeltaUv", FIELD_S16 },
+	{ "remainingTime", FIELD_TRANSITION },
+};
+
+static const struct field hsl_fields[] = {
+	{ "lightness", FIELD_U16 },
+	{ "hue", FIELD_U16 },
+	{ "saturation", FIELD_U16 },
+	{ "remainingTime", FIELD_TRANSITION },
+};
+
+static const struct field hsl_hue_fields[] = {
+	{ "hue", FIELD_U16 },
+	{ "targetHue", FIELD_U16 },
+	{ "remainingTime", FIELD_TRANSITION },
+};
+
+static const struct field hsl_sat_fields[] = {
+	{ "saturation", FIELD_U16 },
+	{ "targetSaturation", FIELD_U16 },
+	{ "remainingTime", FIELD_TRANSITION },
+};
+
+static int sensor_status_decode(uint16_t addr, const uint8_t *payload, size_t len,
+		struct model_decoded *decoded);
+static int sensor_desc_decode(uint16_t addr, const uint8_t *payload, size_t len,
+		struct model_decoded *decoded);
+
+#define FIELDS(_opcode, _fields, _min_count) \
+	{ .opcode = _opcode, .fields = _fields, .field_count = ARRAY_SIZE(_fields), \
+	  .min_count = _min_count }
+
+/* Sorted by opcode */
+static const struct decoder decoders[] = {
+	{ .opcode = OP_SENSOR_DESC_STATUS, .decode = sensor_desc_decode },
+	{ .opcode = OP_SENSOR_STATUS, .decode = sensor_status_decode },
+	FIELDS(OP_ONOFF_STATUS, onoff_fields, 1),
+	FIELDS(OP_LEVEL_STATUS, level_fields, 1),
+	FIELDS(OP_DEF_TRANS_TIME_STATUS, def_trans_time_fields, 1),
+	FIELDS(OP_ONPOWERUP_STATUS, onpowerup_fields, 1),
+	FIELDS(OP_POWER_LEVEL_STATUS, power_level_fields, 1),
+	FIELDS(OP_BATTERY_STATUS, battery_fields, ARRAY_SIZE(battery_fields)),
+	FIELDS(OP_LIGHTNESS_STATUS, lightness_fields, 1),
+	FIELDS(OP_LIGHTNESS_LINEAR_STATUS, lightness_fields, 1),
+	FIELDS(OP_LIGHTNESS_LAST_STATUS, lightness_last_fields, 1),
+	FIELDS(OP_CTL_STATUS, ctl_fields, 2),
+	FIELDS(OP_CTL_TEMP_STATUS, ctl_temp_fields, 2),
+	FIELDS(OP_HSL_HUE_STATUS, hsl_hue_fields, 1),
+	FIELDS(OP_HSL_SAT_STATUS, hsl_sat_fields, 1),
+	FIELDS(OP_HSL_STATUS, hsl_fields, 3),
+	FIELDS(OP_HSL_TARGET_STATUS, hsl_fields, 3),
+};
+
+/* Properties of the common environmental and occupancy sensors, from the Mesh Device
+ * Properties specification */
+static const struct sensor_format sensor_formats[] = {
+	/* Motion Sensed, percentage 8 */
+	{ 0x0042, 1, false, 0.5 },
+	/* People Count, count 16 */
+	{ 0x004C, 2, false, 1.0 },
+	/* Presence Detected, boolean */
+	{ 0x004D, 1, false, 1.0 },
+	/* Present Ambient Light Level, illuminance in lux */
+	{ 0x004E, 3, false, 0.01 },
+	/* Present Ambient Temperature, temperature 8 in degrees Celsius */
+	{ 0x004F, 1, true, 0.5 },
+	/* Present Device Operating Temperature, temperature in degrees Celsius */
+	{ 0x0054, 2, true, 0.01 },
+	/* Present Indoor Ambient Temperature, temperature 8 */
+	{ 0x0056, 1, true, 0.5 },
+	/* Present Outdoor Ambient Temperature, temperature 8 */
+	{ 0x005B, 1, true, 0.5 },
+	/* Present Ambient Relative Humidity, humidity in percent */
+	{ 0x0076, 2, false, 0.01 },
+};
+
+/* Replaced round robin once full */
+static struct desc_entry desc_cache[CONFIG_GATEWAY_MODEL_DECODE_DESC_CACHE];
+static size_t desc_count;
+static size_t desc_next;
+
+static const struct decoder *decoder_find(uint32_t opcode)
+{
+	size_t lo;
+	size_t hi;
+	size_t mid;
+
+	lo = 0;
+	hi = ARRAY_SIZE(decoders);
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+
+		if (decoders[mid].opcode == opcode) {
+			return &decoders[mid];
+		}
+
+		if (decoders[mid].opcode < opcode) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return NULL;
+}
+
+static int32_t transition_ms(uint8_t time)
+{
+	static const int32_t resolution_ms[] = { 100, 1000, 10000, 600000 };
+	uint8_t steps;
+
+	steps = time & BIT_MASK(6);
+
+	/* Unknown, or a transition too long for the field */
+	if (steps == BIT_MASK(6)) {
+		return -1;
+	}
+
+	return steps * resolution_ms[time >> 6];
+}
+
+static int fields_decode(const struct decoder *decoder, const uint8_t *payload, size_t len,
+		struct model_decoded *decoded)
+{
+	size_t i;
+	size_t min_len;
+	size_t full_len;
+	size_t count;
+	const struct field *field;
+
+	min_len = 0;
+	full_len = 0;
+
+	for (i = 0; i < decoder->field_count; i++) {
+		full_len += field_lens[decoder->fields[i].type];
+
+		if (i < decoder->min_count) {
+			min_len = full_len;
+		}
+	}
+
+	if (len == full_len) {
+		count = decoder->field_count;
+	} else if (len == min_len) {
+		count = decoder->min_count;
+	} else {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < count; i++) {
+		field = &decoder->fields[i];
+		decoded->values[i].name = field->name;
+
+		switch (field->type) {
+		case FIELD_U8:
+			decoded->values[i].value = payload[0];
+			break;
+		case FIELD_U16:
+			decoded->values[i].value = sys_get_le16(payload);
+			break;
+		case FIELD_S16:
+			decoded->values[i].value = (int16_t)sys_get_le16(payload);
+			break;
+		case FIELD_U24:
+			decoded->values[i].value = sys_get_le24(payload);
+			break;
+		case FIELD_TRANSITION:
+			decoded->values[i].value = transition_ms(payload[0]);
+			break;
+		}
+
+		payload += field_lens[field->type];
+	}
+
+	decoded->value_count = count;
+
+	return 0;
+}
+
+static struct desc_entry *desc_find(uint16_t addr, uint16_t prop_id)
+{
+	size_t i;
+
+	for (i = 0; i < desc_count; i++) {
+		if (desc_cache[i].addr == addr && desc_cache[i].prop_id == prop_id) {
+			return &desc_cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void desc_cache_put(uint16_t addr, uint16_t prop_id, const struct model_sensor_desc *desc)
+{
+	struct desc_entry *entry;
+
+	entry = desc_find(addr, prop_id);
+
+	if (entry == NULL) {
+		entry = &desc_cache[desc_next];
+		desc_next = (desc_next + 1) % ARRAY_SIZE(desc_cache);
+		desc_count = MIN(desc_count + 1, ARRAY_SIZE(desc_cache));
+	}
+
+	entry->addr = addr;
+	entry->prop_id = prop_id;
+	entry->desc = *desc;
+}
+
+static void sensor_value(struct model_sensor *sensor)
+{
+	size_t i;
+	int32_t raw;
+	const struct sensor_format *format;
+
+	for (i = 0; i < ARRAY_SIZE(sensor_formats); i++) {
+		format = &sensor_formats[i];
+
+		if (format->prop_id != sensor->prop_id) {
+			continue;
+		}
+
+		if (format->len != sensor->len) {
+			return;
+		}
+
+		switch (format->len) {
+		case 1:
+			raw = format->is_signed ? (int8_t)sensor->raw[0] : sensor->raw[0];
+			break;
+		case 2:
+			raw = format->is_signed ? (int16_t)sys_get_le16(sensor->raw) :
+				sys_get_le16(sensor->raw);
+			break;
+		default:
+			raw = sys_get_le24(sensor->raw);
+			break;
+		}
+
+		sensor->has_value = true;
+		sensor->value = raw * format->scale;
+		return;
+	}
+}
+
+/* Marshalled sensor data, each property in format A (1 bit format, 4 bit length, 11 bit
+ * property ID) or format B (1 bit format, 7 bit length, 16 bit property ID), followed by its
+ * value. Lengths are encoded minus one. */
+static int sensor_status_decode(uint16_t addr, const uint8_t *payload, size_t len,
+		struct model_decoded *decoded)
+{
+	size_t val_len;
+	struct desc_entry *entry;
+	struct model_sensor *sensor;
+
+	while (len) {
+		if (decoded->sensor_count == ARRAY_SIZE(decoded->sensors)) {
+			return -ENOMEM;
+		}
+
+		sensor = &decoded->sensors[decoded->sensor_count];
+		memset(sensor, 0, sizeof(*sensor));
+
+		if (payload[0] & BIT(0)) {
+			if (len < 3) {
+				return -EINVAL;
+			}
+
+			val_len = payload[0] >> 1;
+			val_len = val_len == SENSOR_LEN_UNKNOWN ? 0 : val_len + 1;
+			sensor->prop_id = sys_get_le16(&payload[1]);
+			payload += 3;
+			len -= 3;
+		} else {
+			if (len < 2) {
+				return -EINVAL;
+			}
+
+			val_len = ((payload[0] >> 1) & BIT_MASK(4)) + 1;
+			sensor->prop_id = sys_get_le16(payload) >> 5;
+			payload += 2;
+			len -= 2;
+		}
+
+		if (val_len > len || sensor->prop_id == SENSOR_PROP_PROHIBITED) {
+			return -EINVAL;
+		}
+
+		sensor->raw = payload;
+		sensor->len = val_len;
+		sensor_value(sensor);
+		entry = desc_find(addr, sensor->prop_id);
+
+		if (entry != NULL) {
+			sensor->has_desc = true;
+			sensor->desc = entry->desc;
+		}
+
+		payload += val_len;
+		len -= val_len;
+		decoded->sensor_count++;
+	}
+
+	return 0;
+}
+
+/* Descriptors of 8 bytes: property ID, 12 bit positive and negative tolerances, sampling
+ * function, measurement period and update interval. A lone property ID is a property the
+ * node does not support. */
+static int sensor_desc_decode(uint16_t addr, const uint8_t *payload, size_t len,
+		struct model_decoded *decoded)
+{
+	uint32_t tolerance;
+	struct model_sensor *sensor;
+
+	if (len == sizeof(uint16_t)) {
+		sensor = &decoded->sensors[0];
+		memset(sensor, 0, sizeof(*sensor));
+		sensor->prop_id = sys_get_le16(payload);
+		decoded->sensor_count = 1;
+		return 0;
+	}
+
+	if (len % SENSOR_DESC_LEN) {
+		return -EINVAL;
+	}
+
+	if (len / SENSOR_DESC_LEN > ARRAY_SIZE(decoded->sensors)) {
+		return -ENOMEM;
+	}
+
+	for (; len; payload += SENSOR_DESC_LEN, len -= SENSOR_DESC_LEN) {
+		sensor = &decoded->sensors[decoded->sensor_count++];
+		memset(sensor, 0, sizeof(*sensor));
+		sensor->prop_id = sys_get_le16(payload);
+		tolerance = sys_get_le24(&payload[2]);
+		sensor->has_desc = true;
+		sensor->desc.pos_tolerance = tolerance & BIT_MASK(12);
+		sensor->desc.neg_tolerance = tolerance >> 12;
+		sensor->desc.sampling_func = payload[5];
+		sensor->desc.measure_period = payload[6];
+		sensor->desc.update_interval = payload[7];
+		desc_cache_put(addr, sensor->prop_id, &sensor->desc);
+	}
+
+	return 0;
+}
+
+int model_decode(uint32_t opcode, uint16_t addr, const uint8_t *payload, size_t len,
+		struct model_decoded *decoded)
+{
+	int err;
+	const struct decoder *decoder;
+
+	decoder = decoder_find(opcode);
+
+	if (decoder == NULL) {
+		return -ENOENT;
+	}
+
+	decoded->value_count = 0;
+	decoded->sensor_count = 0;
+
+	if (decoder->decode) {
+		err = decoder->decode(addr, payload, len, decoded);
+	} else {
+		err = fields_decode(decoder, payload, len, decoded);
+	}
+
+	if (err) {
+		LOG_DBG("Opcode 0x%x from 0x%04x not decoded: %d", opcode, addr, err);
+	}
+
+	return err;
+}
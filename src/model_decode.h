@@ -0,0 +1,66 @@
+#ifndef MODEL_DECODE_H_
+#define MODEL_DECODE_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MODEL_DECODE_VALUES_MAX 5
+#define MODEL_DECODE_SENSORS_MAX 8
+
+/* A named field of a status message. Remaining times are in milliseconds, -1 if unknown,
+ * all other fields are as encoded in the message. */
+struct model_value {
+	const char *name;
+	int32_t value;
+};
+
+struct model_sensor_desc {
+	uint16_t pos_tolerance;
+	uint16_t neg_tolerance;
+	uint8_t sampling_func;
+	uint8_t measure_period;
+	uint8_t update_interval;
+};
+
+/* One property of a Sensor Status or Sensor Descriptor Status message */
+struct model_sensor {
+	uint16_t prop_id;
+	/* Raw value, points into the decoded payload. len is 0 for a descriptor or an unknown
+	 * value. */
+	const uint8_t *raw;
+	uint8_t len;
+	/* The value in the unit of the property, for the properties the gateway knows */
+	bool has_value;
+	double value;
+	/* From the message, or from the descriptor cache for a Sensor Status */
+	bool has_desc;
+	struct model_sensor_desc desc;
+};
+
+struct model_decoded {
+	size_t value_count;
+	struct model_value values[MODEL_DECODE_VALUES_MAX];
+	size_t sensor_count;
+	struct model_sensor sensors[MODEL_DECODE_SENSORS_MAX];
+};
+
+/* Decode a SIG model status message. Returns -ENOENT for an opcode without a decoder and
+ * -EINVAL for a malformed payload, the message is then sent raw. Sensor descriptors of
+ * decoded Sensor Descriptor Status messages are cached and added to the properties of
+ * later Sensor Status messages from the same node. Only called from the gateway thread. */
+int model_decode(uint32_t opcode, uint16_t addr, const uint8_t *payload, size_t len,
+		struct model_decoded *decoded);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* MODEL_DECODE_H_ */
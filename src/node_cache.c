@@ -0,0 +1,1062 @@
+#include <zephyr.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+#include <logging/log.h>
+#include <settings/settings.h>
+
+#include "btmesh.h"
+#include "node_cache.h"
+
+/* Each node is stored as one little endian settings value, "ncache/<address>":
+ *
+ *   format version, configuration version, cid, pid, vid, crpl, feature flags, ttl,
+ *   relay count, relay interval, heartbeat subscription, heartbeat publication,
+ *   SIG model count, vendor model count, subnet list, element count, then for every element
+ *   its location and model counts followed by its SIG models (id, publication, app key list,
+ *   subscription list) and its vendor models (company id, id, publication, app key list,
+ *   subscription list).
+ *
+ * Lists are a count byte followed by the 16-bit entries. Nodes whose configuration is not
+ * known, but whose configuration version is, keep just the two version fields.
+ *
+ * Configuration operations update a copy of the value in RAM, which is written back once
+ * the node has been left alone for CONFIG_GATEWAY_NODE_CACHE_FLUSH_MS. A transaction or a
+ * profile of many steps then costs one flash write instead of one per step.
+ */
+#define CACHE_VERSION 2
+#define HEADER_LEN 5
+#define CACHE_SETTINGS_ROOT "ncache"
+#define CACHE_KEY_LEN sizeof(CACHE_SETTINGS_ROOT "/ffff")
+
+#define FLAG_NET_BEACON BIT(0)
+#define FLAG_RELAY_SUPPORT BIT(1)
+#define FLAG_RELAY BIT(2)
+#define FLAG_PROXY_SUPPORT BIT(3)
+#define FLAG_PROXY BIT(4)
+#define FLAG_FRIEND_SUPPORT BIT(5)
+#define FLAG_FRIEND BIT(6)
+#define FLAG_LPN BIT(7)
+
+/* cid, pid, vid and crpl */
+#define IDS_LEN 8
+#define FLAGS_LEN 1
+#define TTL_LEN 1
+#define RELAY_LEN 3
+#define HB_SUB_LEN 8
+#define HB_PUB_LEN 9
+#define MODEL_COUNTS_LEN 4
+/* Node level fields between the header and the subnet list */
+#define NODE_LEN (IDS_LEN + FLAGS_LEN + TTL_LEN + RELAY_LEN + HB_SUB_LEN + HB_PUB_LEN + \
+		MODEL_COUNTS_LEN)
+#define ELEM_COUNT_LEN 1
+/* Location, SIG model count and vendor model count */
+#define ELEM_LEN 4
+#define SIG_ID_LEN 2
+#define VND_ID_LEN 4
+#define PUB_LEN 8
+#define LIST_MAX MAX(CONFIG_BT_MESH_SUBNET_COUNT, \
+		MAX(CONFIG_BT_MESH_APP_KEY_COUNT, CONFIG_BT_MESH_MODEL_GROUP_COUNT))
+
+
+LOG_MODULE_REGISTER(app_node_cache, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+/* Serializes read-modify-write updates of the same node from different threads and guards
+ * the dirty entries */
+K_MUTEX_DEFINE(cache_lock);
+
+/* The lists and publication parameters of one model, SIG or vendor */
+struct model_ref {
+	uint16_t **apps;
+	size_t *app_cnt;
+	uint16_t **subs;
+	size_t *sub_cnt;
+	struct bt_mesh_cfg_mod_pub *pub;
+};
+
+struct load_ctx {
+	uint8_t *data;
+	size_t len;
+};
+
+/* A value changed in RAM and not written back yet, data is NULL for a free entry */
+struct dirty_entry {
+	uint16_t addr;
+	uint8_t *data;
+	size_t len;
+};
+
+static struct dirty_entry dirty[CONFIG_GATEWAY_NODE_CACHE_DIRTY_MAX];
+
+static void flush(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(flush_work, flush);
+
+static void cache_key(uint16_t addr, char key[CACHE_KEY_LEN])
+{
+	snprintk(key, CACHE_KEY_LEN, CACHE_SETTINGS_ROOT "/%04x", addr);
+}
+
+static size_t list_len(size_t count)
+{
+	return 1 + (count * sizeof(uint16_t));
+}
+
+static size_t encoded_len(const struct btmesh_node *node)
+{
+	size_t i;
+	size_t j;
+	size_t len;
+	const struct btmesh_elem *elem;
+
+	len = HEADER_LEN + NODE_LEN + list_len(node->subnet_count) + ELEM_COUNT_LEN;
+
+	for (i = 0; i < node->elem_count; i++) {
+		elem = &node->elems[i];
+		len += ELEM_LEN;
+
+		for (j = 0; j < elem->sig_model_count; j++) {
+			len += SIG_ID_LEN + PUB_LEN + list_len(elem->sig_models[j].appkey_count) +
+				list_len(elem->sig_models[j].sub_addr_count);
+		}
+
+		for (j = 0; j < elem->vnd_model_count; j++) {
+			len += VND_ID_LEN + PUB_LEN + list_len(elem->vnd_models[j].appkey_count) +
+				list_len(elem->vnd_models[j].sub_addr_count);
+		}
+	}
+
+	return len;
+}
+
+static void put_list(struct net_buf_simple *buf, const uint16_t *list, size_t count)
+{
+	size_t i;
+
+	net_buf_simple_add_u8(buf, count);
+
+	for (i = 0; i < count; i++) {
+		net_buf_simple_add_le16(buf, list[i]);
+	}
+}
+
+static void put_pub(struct net_buf_simple *buf, const struct bt_mesh_cfg_mod_pub *pub)
+{
+	net_buf_simple_add_le16(buf, pub->addr);
+	net_buf_simple_add_le16(buf, pub->app_idx);
+	net_buf_simple_add_u8(buf, pub->cred_flag);
+	net_buf_simple_add_u8(buf, pub->ttl);
+	net_buf_simple_add_u8(buf, pub->period);
+	net_buf_simple_add_u8(buf, pub->transmit);
+}
+
+static void encode(struct net_buf_simple *buf, const struct btmesh_node *node)
+{
+	size_t i;
+	size_t j;
+	size_t sig_count;
+	size_t vnd_count;
+	uint8_t flags;
+	const struct btmesh_elem *elem;
+
+	sig_count = 0;
+	vnd_count = 0;
+
+	for (i = 0; i < node->elem_count; i++) {
+		sig_count += node->elems[i].sig_model_count;
+		vnd_count += node->elems[i].vnd_model_count;
+	}
+
+	flags = (node->net_beacon_state ? FLAG_NET_BEACON : 0) |
+		(node->relay.support ? FLAG_RELAY_SUPPORT : 0) |
+		(node->relay.state ? FLAG_RELAY : 0) |
+		(node->proxy.support ? FLAG_PROXY_SUPPORT : 0) |
+		(node->proxy.state ? FLAG_PROXY : 0) |
+		(node->friend.support ? FLAG_FRIEND_SUPPORT : 0) |
+		(node->friend.state ? FLAG_FRIEND : 0) |
+		(node->lpn ? FLAG_LPN : 0);
+
+	net_buf_simple_add_u8(buf, CACHE_VERSION);
+	net_buf_simple_add_le32(buf, node->cfg_version);
+	net_buf_simple_add_le16(buf, node->cid);
+	net_buf_simple_add_le16(buf, node->pid);
+	net_buf_simple_add_le16(buf, node->vid);
+	net_buf_simple_add_le16(buf, node->crpl);
+	net_buf_simple_add_u8(buf, flags);
+	net_buf_simple_add_u8(buf, node->ttl);
+	net_buf_simple_add_u8(buf, node->relay.count);
+	net_buf_simple_add_le16(buf, node->relay.interval);
+
+	net_buf_simple_add_le16(buf, node->hb_sub.src);
+	net_buf_simple_add_le16(buf, node->hb_sub.dst);
+	net_buf_simple_add_u8(buf, node->hb_sub.period);
+	net_buf_simple_add_u8(buf, node->hb_sub.count);
+	net_buf_simple_add_u8(buf, node->hb_sub.min);
+	net_buf_simple_add_u8(buf, node->hb_sub.max);
+
+	net_buf_simple_add_le16(buf, node->hb_pub.dst);
+	net_buf_simple_add_u8(buf, node->hb_pub.count);
+	net_buf_simple_add_u8(buf, node->hb_pub.period);
+	net_buf_simple_add_u8(buf, node->hb_pub.ttl);
+	net_buf_simple_add_le16(buf, node->hb_pub.feat);
+	net_buf_simple_add_le16(buf, node->hb_pub.net_idx);
+
+	net_buf_simple_add_le16(buf, sig_count);
+	net_buf_simple_add_le16(buf, vnd_count);
+	put_list(buf, node->subnet_idxs, node->subnet_count);
+	net_buf_simple_add_u8(buf, node->elem_count);
+
+	for (i = 0; i < node->elem_count; i++) {
+		elem = &node->elems[i];
+		net_buf_simple_add_le16(buf, elem->loc);
+		net_buf_simple_add_u8(buf, elem->sig_model_count);
+		net_buf_simple_add_u8(buf, elem->vnd_model_count);
+
+		for (j = 0; j < elem->sig_model_count; j++) {
+			net_buf_simple_add_le16(buf, elem->sig_models[j].model_id);
+			put_pub(buf, &elem->sig_models[j].pub);
+			put_list(buf, elem->sig_models[j].appkey_idxs,
+					elem->sig_models[j].appkey_count);
+			put_list(buf, elem->sig_models[j].sub_addrs,
+					elem->sig_models[j].sub_addr_count);
+		}
+
+		for (j = 0; j < elem->vnd_model_count; j++) {
+			net_buf_simple_add_le16(buf, elem->vnd_models[j].company_id);
+			net_buf_simple_add_le16(buf, elem->vnd_models[j].model_id);
+			put_pub(buf, &elem->vnd_models[j].pub);
+			put_list(buf, elem->vnd_models[j].appkey_idxs,
+					elem->vnd_models[j].appkey_count);
+			put_list(buf, elem->vnd_models[j].sub_addrs,
+					elem->vnd_models[j].sub_addr_count);
+		}
+	}
+}
+
+static bool get_list(struct net_buf_simple *buf, struct btmesh_node *node, size_t max,
+		uint16_t **list, size_t *count)
+{
+	size_t i;
+	uint16_t entries[LIST_MAX];
+
+	if (buf->len < 1) {
+		return false;
+	}
+
+	*count = net_buf_simple_pull_u8(buf);
+
+	if (*count > max || buf->len < *count * sizeof(uint16_t)) {
+		return false;
+	}
+
+	for (i = 0; i < *count; i++) {
+		entries[i] = net_buf_simple_pull_le16(buf);
+	}
+
+	*list = btmesh_node_idx_list(node, entries, *count);
+	return *count == 0 || *list != NULL;
+}
+
+static bool get_pub(struct net_buf_simple *buf, struct bt_mesh_cfg_mod_pub *pub)
+{
+	if (buf->len < PUB_LEN) {
+		return false;
+	}
+
+	pub->addr = net_buf_simple_pull_le16(buf);
+	pub->uuid = NULL;
+	pub->app_idx = net_buf_simple_pull_le16(buf);
+	pub->cred_flag = net_buf_simple_pull_u8(buf);
+	pub->ttl = net_buf_simple_pull_u8(buf);
+	pub->period = net_buf_simple_pull_u8(buf);
+	pub->transmit = net_buf_simple_pull_u8(buf);
+	return true;
+}
+
+static bool get_model_lists(struct net_buf_simple *buf, struct btmesh_node *node,
+		struct bt_mesh_cfg_mod_pub *pub, uint16_t **apps, size_t *app_cnt,
+		uint16_t **subs, size_t *sub_cnt)
+{
+	return get_pub(buf, pub) &&
+		get_list(buf, node, CONFIG_BT_MESH_APP_KEY_COUNT, apps, app_cnt) &&
+		get_list(buf, node, CONFIG_BT_MESH_MODEL_GROUP_COUNT, subs, sub_cnt);
+}
+
+static bool decode_elem(struct net_buf_simple *buf, struct btmesh_node *node, uint8_t idx)
+{
+	size_t j;
+	struct btmesh_elem *elem = &node->elems[idx];
+	struct btmesh_sig_model *sig;
+	struct btmesh_vnd_model *vnd;
+
+	if (buf->len < ELEM_LEN) {
+		return false;
+	}
+
+	elem->addr = node->addr + idx;
+	elem->loc = net_buf_simple_pull_le16(buf);
+	elem->sig_model_count = net_buf_simple_pull_u8(buf);
+	elem->vnd_model_count = net_buf_simple_pull_u8(buf);
+
+	if (btmesh_node_elem_init(node, elem)) {
+		return false;
+	}
+
+	for (j = 0; j < elem->sig_model_count; j++) {
+		sig = &elem->sig_models[j];
+
+		if (buf->len < SIG_ID_LEN) {
+			return false;
+		}
+
+		sig->model_id = net_buf_simple_pull_le16(buf);
+
+		if (!get_model_lists(buf, node, &sig->pub, &sig->appkey_idxs, &sig->appkey_count,
+					&sig->sub_addrs, &sig->sub_addr_count)) {
+			return false;
+		}
+	}
+
+	for (j = 0; j < elem->vnd_model_count; j++) {
+		vnd = &elem->vnd_models[j];
+
+		if (buf->len < VND_ID_LEN) {
+			return false;
+		}
+
+		vnd->company_id = net_buf_simple_pull_le16(buf);
+		vnd->model_id = net_buf_simple_pull_le16(buf);
+
+		if (!get_model_lists(buf, node, &vnd->pub, &vnd->appkey_idxs, &vnd->appkey_count,
+					&vnd->sub_addrs, &vnd->sub_addr_count)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int decode(struct net_buf_simple *buf, struct btmesh_node *node, uint8_t num_elem)
+{
+	uint8_t i;
+	uint8_t flags;
+	uint16_t sig_count;
+	uint16_t vnd_count;
+
+	if (buf->len == 0) {
+		return -ENOENT;
+	}
+
+	if (buf->len < NODE_LEN) {
+		return -EINVAL;
+	}
+
+	node->cid = net_buf_simple_pull_le16(buf);
+	node->pid = net_buf_simple_pull_le16(buf);
+	node->vid = net_buf_simple_pull_le16(buf);
+	node->crpl = net_buf_simple_pull_le16(buf);
+	flags = net_buf_simple_pull_u8(buf);
+	node->net_beacon_state = flags & FLAG_NET_BEACON;
+	node->relay.support = flags & FLAG_RELAY_SUPPORT;
+	node->relay.state = flags & FLAG_RELAY;
+	node->proxy.support = flags & FLAG_PROXY_SUPPORT;
+	node->proxy.state = flags & FLAG_PROXY;
+	node->friend.support = flags & FLAG_FRIEND_SUPPORT;
+	node->friend.state = flags & FLAG_FRIEND;
+	node->lpn = flags & FLAG_LPN;
+	node->ttl = net_buf_simple_pull_u8(buf);
+	node->relay.count = net_buf_simple_pull_u8(buf);
+	node->relay.interval = net_buf_simple_pull_le16(buf);
+
+	node->hb_sub.src = net_buf_simple_pull_le16(buf);
+	node->hb_sub.dst = net_buf_simple_pull_le16(buf);
+	node->hb_sub.period = net_buf_simple_pull_u8(buf);
+	node->hb_sub.count = net_buf_simple_pull_u8(buf);
+	node->hb_sub.min = net_buf_simple_pull_u8(buf);
+	node->hb_sub.max = net_buf_simple_pull_u8(buf);
+
+	node->hb_pub.dst = net_buf_simple_pull_le16(buf);
+	node->hb_pub.count = net_buf_simple_pull_u8(buf);
+	node->hb_pub.period = net_buf_simple_pull_u8(buf);
+	node->hb_pub.ttl = net_buf_simple_pull_u8(buf);
+	node->hb_pub.feat = net_buf_simple_pull_le16(buf);
+	node->hb_pub.net_idx = net_buf_simple_pull_le16(buf);
+
+	sig_count = net_buf_simple_pull_le16(buf);
+	vnd_count = net_buf_simple_pull_le16(buf);
+
+	/* The element count comes after the subnet list, so the block is sized from the CDB
+	 * and checked against the stored count afterwards */
+	node->elem_count = num_elem;
+
+	if (btmesh_node_alloc(node, sig_count, vnd_count)) {
+		return -ENOMEM;
+	}
+
+	if (!get_list(buf, node, CONFIG_BT_MESH_SUBNET_COUNT, &node->subnet_idxs,
+				&node->subnet_count)) {
+		return -EINVAL;
+	}
+
+	if (buf->len < ELEM_COUNT_LEN || net_buf_simple_pull_u8(buf) != num_elem) {
+		return -ESTALE;
+	}
+
+	for (i = 0; i < num_elem; i++) {
+		if (!decode_elem(buf, node, i)) {
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+static int header_get(struct net_buf_simple *buf, uint32_t *cfg_version)
+{
+	if (buf->len < HEADER_LEN || net_buf_simple_pull_u8(buf) != CACHE_VERSION) {
+		return -EINVAL;
+	}
+
+	*cfg_version = net_buf_simple_pull_le32(buf);
+	return 0;
+}
+
+static int load_cb(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg,
+		void *param)
+{
+	ssize_t read_len;
+	struct load_ctx *ctx = param;
+
+	if (key != NULL) {
+		return 0;
+	}
+
+	/* Backends that log every write report older values first, so the last one wins.
+	 * Deleted entries read back as empty values. */
+	k_free(ctx->data);
+	ctx->data = NULL;
+	ctx->len = 0;
+
+	if (len == 0) {
+		return 0;
+	}
+
+	ctx->data = k_malloc(len);
+
+	if (ctx->data == NULL) {
+		return -ENOMEM;
+	}
+
+	read_len = read_cb(cb_arg, ctx->data, len);
+
+	if (read_len < 0) {
+		k_free(ctx->data);
+		ctx->data = NULL;
+		return read_len;
+	}
+
+	ctx->len = read_len;
+	return 0;
+}
+
+static struct dirty_entry *dirty_find(uint16_t addr)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(dirty); i++) {
+		if (dirty[i].data != NULL && dirty[i].addr == addr) {
+			return &dirty[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void dirty_free(struct dirty_entry *entry)
+{
+	k_free(entry->data);
+	entry->data = NULL;
+	entry->len = 0;
+}
+
+/* Called with cache_lock held */
+static void flush_all(void)
+{
+	int err;
+	size_t i;
+	char key[CACHE_KEY_LEN];
+
+	for (i = 0; i < ARRAY_SIZE(dirty); i++) {
+		if (dirty[i].data == NULL) {
+			continue;
+		}
+
+		cache_key(dirty[i].addr, key);
+		err = settings_save_one(key, dirty[i].data, dirty[i].len);
+
+		if (err) {
+			LOG_ERR("Failed to cache node 0x%04x: %d", dirty[i].addr, err);
+		}
+
+		dirty_free(&dirty[i]);
+	}
+}
+
+static void flush(struct k_work *work)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	flush_all();
+	k_mutex_unlock(&cache_lock);
+}
+
+static struct dirty_entry *dirty_alloc(uint16_t addr)
+{
+	size_t i;
+	struct dirty_entry *entry;
+
+	entry = dirty_find(addr);
+
+	if (entry != NULL) {
+		dirty_free(entry);
+		return entry;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(dirty); i++) {
+		if (dirty[i].data == NULL) {
+			return &dirty[i];
+		}
+	}
+
+	/* More nodes changing at once than there are entries, write them all back now */
+	flush_all();
+	return &dirty[0];
+}
+
+/* Store a value, now or from the flush work if defer is set. Takes ownership of data. */
+static int value_put(uint16_t addr, uint8_t *data, size_t len, bool defer)
+{
+	int err;
+	char key[CACHE_KEY_LEN];
+	struct dirty_entry *entry;
+
+	if (defer) {
+		entry = dirty_alloc(addr);
+		entry->addr = addr;
+		entry->data = data;
+		entry->len = len;
+		/* Not rescheduled, so a node that keeps changing is still written back in time */
+		k_work_schedule(&flush_work, K_MSEC(CONFIG_GATEWAY_NODE_CACHE_FLUSH_MS));
+		return 0;
+	}
+
+	entry = dirty_find(addr);
+
+	if (entry != NULL) {
+		dirty_free(entry);
+	}
+
+	cache_key(addr, key);
+	err = settings_save_one(key, data, len);
+	k_free(data);
+	return err;
+}
+
+static int entry_read(uint16_t addr, struct load_ctx *ctx)
+{
+	int err;
+	char key[CACHE_KEY_LEN];
+	struct dirty_entry *entry;
+
+	memset(ctx, 0, sizeof(*ctx));
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	entry = dirty_find(addr);
+
+	if (entry != NULL) {
+		ctx->data = k_malloc(entry->len);
+
+		if (ctx->data != NULL) {
+			memcpy(ctx->data, entry->data, entry->len);
+			ctx->len = entry->len;
+		}
+
+		k_mutex_unlock(&cache_lock);
+		return ctx->data ? 0 : -ENOMEM;
+	}
+
+	cache_key(addr, key);
+	err = settings_load_subtree_direct(key, load_cb, ctx);
+	k_mutex_unlock(&cache_lock);
+
+	if (err) {
+		k_free(ctx->data);
+		return err;
+	}
+
+	return ctx->data ? 0 : -ENOENT;
+}
+
+static int header_store(uint16_t addr, uint32_t cfg_version, bool defer)
+{
+	struct net_buf_simple buf;
+
+	buf.__buf = k_malloc(HEADER_LEN);
+
+	if (buf.__buf == NULL) {
+		return -ENOMEM;
+	}
+
+	buf.size = HEADER_LEN;
+	net_buf_simple_reset(&buf);
+	net_buf_simple_add_u8(&buf, CACHE_VERSION);
+	net_buf_simple_add_le32(&buf, cfg_version);
+	return value_put(addr, buf.__buf, buf.len, defer);
+}
+
+static uint32_t version_get(uint16_t addr)
+{
+	uint32_t cfg_version;
+	struct load_ctx ctx;
+	struct net_buf_simple buf;
+
+	if (entry_read(addr, &ctx)) {
+		return 0;
+	}
+
+	net_buf_simple_init_with_data(&buf, ctx.data, ctx.len);
+
+	if (header_get(&buf, &cfg_version)) {
+		cfg_version = 0;
+	}
+
+	k_free(ctx.data);
+	return cfg_version;
+}
+
+uint32_t node_cache_version_get(uint16_t addr)
+{
+	uint32_t cfg_version;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	cfg_version = version_get(addr);
+	k_mutex_unlock(&cache_lock);
+
+	return cfg_version;
+}
+
+int node_cache_load(uint16_t addr, struct btmesh_node *node)
+{
+	int err;
+	struct load_ctx ctx;
+	struct net_buf_simple buf;
+	struct bt_mesh_cdb_node *cdb_node;
+
+	node->mem = NULL;
+	node->subnet_idxs = NULL;
+	node->elems = NULL;
+	cdb_node = bt_mesh_cdb_node_get(addr);
+
+	if (cdb_node == NULL) {
+		return -ESRCH;
+	}
+
+	err = entry_read(addr, &ctx);
+
+	if (err) {
+		return err;
+	}
+
+	node->addr = addr;
+	memcpy(node->uuid, cdb_node->uuid, UUID_LEN);
+	node->net_idx = cdb_node->net_idx;
+	net_buf_simple_init_with_data(&buf, ctx.data, ctx.len);
+	err = header_get(&buf, &node->cfg_version);
+
+	if (!err) {
+		err = decode(&buf, node, cdb_node->num_elem);
+	}
+
+	k_free(ctx.data);
+
+	if (err) {
+		btmesh_free_node(node);
+
+		if (err == -ENOMEM || err == -ENOENT) {
+			return err;
+		}
+
+		LOG_WRN("Dropping unusable cache entry of 0x%04x: %d", addr, err);
+		node_cache_delete(addr);
+		return -ENOENT;
+	}
+
+	return 0;
+}
+
+static int store(const struct btmesh_node *node, bool defer)
+{
+	int err;
+	size_t len;
+	struct net_buf_simple buf;
+
+	len = encoded_len(node);
+
+	if (len > CONFIG_GATEWAY_NODE_CACHE_MAX_SIZE) {
+		LOG_WRN("Node 0x%04x too large to cache (%d bytes)", node->addr, len);
+		header_store(node->addr, node->cfg_version, defer);
+		return -E2BIG;
+	}
+
+	buf.__buf = k_malloc(len);
+
+	if (buf.__buf == NULL) {
+		return -ENOMEM;
+	}
+
+	buf.size = len;
+	net_buf_simple_reset(&buf);
+	encode(&buf, node);
+	err = value_put(node->addr, buf.__buf, buf.len, defer);
+
+	if (err) {
+		LOG_ERR("Failed to cache node 0x%04x: %d", node->addr, err);
+	}
+
+	return err;
+}
+
+int node_cache_store(struct btmesh_node *node)
+{
+	int err;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	/* A rediscovered node may differ from the last known configuration */
+	node->cfg_version = version_get(node->addr) + 1;
+	err = store(node, false);
+	k_mutex_unlock(&cache_lock);
+
+	return err;
+}
+
+void node_cache_delete(uint16_t addr)
+{
+	char key[CACHE_KEY_LEN];
+	struct dirty_entry *entry;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	entry = dirty_find(addr);
+
+	if (entry != NULL) {
+		dirty_free(entry);
+	}
+
+	cache_key(addr, key);
+	settings_delete(key);
+	k_mutex_unlock(&cache_lock);
+}
+
+static bool model_find(struct btmesh_node *node, uint16_t elem_addr, uint16_t mod_id,
+		uint16_t cid, struct model_ref *ref)
+{
+	size_t j;
+	struct btmesh_elem *elem;
+
+	if (elem_addr < node->addr || elem_addr - node->addr >= node->elem_count) {
+		return false;
+	}
+
+	elem = &node->elems[elem_addr - node->addr];
+
+	if (cid == BT_MESH_CID_NVAL) {
+		for (j = 0; j < elem->sig_model_count; j++) {
+			if (elem->sig_models[j].model_id == mod_id) {
+				ref->apps = &elem->sig_models[j].appkey_idxs;
+				ref->app_cnt = &elem->sig_models[j].appkey_count;
+				ref->subs = &elem->sig_models[j].sub_addrs;
+				ref->sub_cnt = &elem->sig_models[j].sub_addr_count;
+				ref->pub = &elem->sig_models[j].pub;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	for (j = 0; j < elem->vnd_model_count; j++) {
+		if (elem->vnd_models[j].model_id == mod_id &&
+				elem->vnd_models[j].company_id == cid) {
+			ref->apps = &elem->vnd_models[j].appkey_idxs;
+			ref->app_cnt = &elem->vnd_models[j].appkey_count;
+			ref->subs = &elem->vnd_models[j].sub_addrs;
+			ref->sub_cnt = &elem->vnd_models[j].sub_addr_count;
+			ref->pub = &elem->vnd_models[j].pub;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Lists are replaced rather than grown in place. The node's pool reserves the longest list
+ * for every model, so one update per load always fits. */
+static bool list_add(struct btmesh_node *node, uint16_t **list, size_t *count, size_t max,
+		uint16_t val)
+{
+	size_t i;
+	uint16_t entries[LIST_MAX];
+
+	for (i = 0; i < *count; i++) {
+		if ((*list)[i] == val) {
+			return true;
+		}
+	}
+
+	if (*count >= max) {
+		return false;
+	}
+
+	if (*count) {
+		memcpy(entries, *list, *count * sizeof(uint16_t));
+	}
+
+	entries[*count] = val;
+	*list = btmesh_node_idx_list(node, entries, *count + 1);
+
+	if (*list == NULL) {
+		return false;
+	}
+
+	(*count)++;
+	return true;
+}
+
+static bool list_del(uint16_t *list, size_t *count, uint16_t val)
+{
+	size_t i;
+
+	for (i = 0; i < *count; i++) {
+		if (list[i] == val) {
+			memmove(&list[i], &list[i + 1], (*count - i - 1) * sizeof(uint16_t));
+			(*count)--;
+			break;
+		}
+	}
+
+	return true;
+}
+
+static bool list_set(struct btmesh_node *node, uint16_t **list, size_t *count, uint16_t val)
+{
+	*list = btmesh_node_idx_list(node, &val, 1);
+	*count = *list ? 1 : 0;
+	return *list != NULL;
+}
+
+/* Deleting an app key unbinds it from every model of the node */
+static void app_key_unbind(struct btmesh_node *node, uint16_t app_idx)
+{
+	size_t i;
+	size_t j;
+	struct btmesh_elem *elem;
+
+	for (i = 0; i < node->elem_count; i++) {
+		elem = &node->elems[i];
+
+		for (j = 0; j < elem->sig_model_count; j++) {
+			list_del(elem->sig_models[j].appkey_idxs, &elem->sig_models[j].appkey_count,
+					app_idx);
+		}
+
+		for (j = 0; j < elem->vnd_model_count; j++) {
+			list_del(elem->vnd_models[j].appkey_idxs, &elem->vnd_models[j].appkey_count,
+					app_idx);
+		}
+	}
+}
+
+#define MOD_REF(_node, _args, _cid, _ref) \
+	model_find(_node, (_args).elem_addr, (_args).mod_id, _cid, _ref)
+
+/* Returns false if the cached node can no longer be trusted */
+static bool apply(struct btmesh_node *node, enum btmesh_op op,
+		const union btmesh_op_args *args)
+{
+	struct model_ref ref;
+
+	switch (op) {
+	case BTMESH_OP_BEACON_SET:
+		node->net_beacon_state = args->beacon_set.status == BT_MESH_BEACON_ENABLED;
+		return true;
+
+	case BTMESH_OP_TTL_SET:
+		node->ttl = args->ttl_set.ttl;
+		return true;
+
+	case BTMESH_OP_FRIEND_SET:
+		node->friend.state = args->friend_set.status == BT_MESH_FRIEND_ENABLED;
+		return true;
+
+	case BTMESH_OP_PROXY_SET:
+		node->proxy.state = args->proxy_set.status == BT_MESH_GATT_PROXY_ENABLED;
+		return true;
+
+	case BTMESH_OP_RELAY_SET:
+		node->relay.state = args->relay_set.status == BT_MESH_RELAY_ENABLED;
+		node->relay.count = BT_MESH_TRANSMIT_COUNT(args->relay_set.transmit);
+		node->relay.interval = BT_MESH_TRANSMIT_INT(args->relay_set.transmit);
+		return true;
+
+	case BTMESH_OP_NET_KEY_ADD:
+		return list_add(node, &node->subnet_idxs, &node->subnet_count,
+				CONFIG_BT_MESH_SUBNET_COUNT, args->net_key_add.key_net_idx);
+
+	case BTMESH_OP_NET_KEY_DEL:
+		/* The node also drops the app keys of the subnet and their bindings, which are
+		 * not known here */
+		return false;
+
+	case BTMESH_OP_APP_KEY_DEL:
+		app_key_unbind(node, args->app_key_del.key_app_idx);
+		return true;
+
+	case BTMESH_OP_MOD_APP_BIND:
+		return MOD_REF(node, args->mod_app_bind, BT_MESH_CID_NVAL, &ref) &&
+			list_add(node, ref.apps, ref.app_cnt, CONFIG_BT_MESH_APP_KEY_COUNT,
+					args->mod_app_bind.mod_app_idx);
+
+	case BTMESH_OP_MOD_APP_BIND_VND:
+		return MOD_REF(node, args->mod_app_bind_vnd, args->mod_app_bind_vnd.cid, &ref) &&
+			list_add(node, ref.apps, ref.app_cnt, CONFIG_BT_MESH_APP_KEY_COUNT,
+					args->mod_app_bind_vnd.mod_app_idx);
+
+	case BTMESH_OP_MOD_APP_UNBIND:
+		return MOD_REF(node, args->mod_app_unbind, BT_MESH_CID_NVAL, &ref) &&
+			list_del(*ref.apps, ref.app_cnt, args->mod_app_unbind.mod_app_idx);
+
+	case BTMESH_OP_MOD_APP_UNBIND_VND:
+		return MOD_REF(node, args->mod_app_unbind_vnd, args->mod_app_unbind_vnd.cid,
+					&ref) &&
+			list_del(*ref.apps, ref.app_cnt, args->mod_app_unbind_vnd.mod_app_idx);
+
+	case BTMESH_OP_MOD_PUB_SET:
+		if (!MOD_REF(node, args->mod_pub_set, BT_MESH_CID_NVAL, &ref)) {
+			return false;
+		}
+
+		*ref.pub = args->mod_pub_set.pub;
+		ref.pub->uuid = NULL;
+		return true;
+
+	case BTMESH_OP_MOD_PUB_SET_VND:
+		if (!MOD_REF(node, args->mod_pub_set_vnd, args->mod_pub_set_vnd.cid, &ref)) {
+			return false;
+		}
+
+		*ref.pub = args->mod_pub_set_vnd.pub;
+		ref.pub->uuid = NULL;
+		return true;
+
+	case BTMESH_OP_MOD_SUB_ADD:
+		return MOD_REF(node, args->mod_sub_add, BT_MESH_CID_NVAL, &ref) &&
+			list_add(node, ref.subs, ref.sub_cnt, CONFIG_BT_MESH_MODEL_GROUP_COUNT,
+					args->mod_sub_add.sub_addr);
+
+	case BTMESH_OP_MOD_SUB_ADD_VND:
+		return MOD_REF(node, args->mod_sub_add_vnd, args->mod_sub_add_vnd.cid, &ref) &&
+			list_add(node, ref.subs, ref.sub_cnt, CONFIG_BT_MESH_MODEL_GROUP_COUNT,
+					args->mod_sub_add_vnd.sub_addr);
+
+	case BTMESH_OP_MOD_SUB_DEL:
+		return MOD_REF(node, args->mod_sub_del, BT_MESH_CID_NVAL, &ref) &&
+			list_del(*ref.subs, ref.sub_cnt, args->mod_sub_del.sub_addr);
+
+	case BTMESH_OP_MOD_SUB_DEL_VND:
+		return MOD_REF(node, args->mod_sub_del_vnd, args->mod_sub_del_vnd.cid, &ref) &&
+			list_del(*ref.subs, ref.sub_cnt, args->mod_sub_del_vnd.sub_addr);
+
+	case BTMESH_OP_MOD_SUB_OVRW:
+		return MOD_REF(node, args->mod_sub_ovrw, BT_MESH_CID_NVAL, &ref) &&
+			list_set(node, ref.subs, ref.sub_cnt, args->mod_sub_ovrw.sub_addr);
+
+	case BTMESH_OP_MOD_SUB_OVRW_VND:
+		return MOD_REF(node, args->mod_sub_ovrw_vnd, args->mod_sub_ovrw_vnd.cid, &ref) &&
+			list_set(node, ref.subs, ref.sub_cnt, args->mod_sub_ovrw_vnd.sub_addr);
+
+	case BTMESH_OP_HB_SUB_SET:
+		node->hb_sub = args->hb_sub_set.sub;
+		return true;
+
+	case BTMESH_OP_HB_PUB_SET:
+		node->hb_pub = args->hb_pub_set.pub;
+		return true;
+
+	default:
+		return true;
+	}
+}
+
+void node_cache_update(enum btmesh_op op, const union btmesh_op_args *args)
+{
+	int err;
+	uint16_t addr;
+	struct btmesh_node node;
+
+	switch (op) {
+	case BTMESH_OP_NODE_RESET:
+		node_cache_delete(args->node_reset.addr);
+		return;
+
+	case BTMESH_OP_BEACON_SET:
+	case BTMESH_OP_TTL_SET:
+	case BTMESH_OP_FRIEND_SET:
+	case BTMESH_OP_PROXY_SET:
+	case BTMESH_OP_RELAY_SET:
+	case BTMESH_OP_NET_KEY_ADD:
+	case BTMESH_OP_NET_KEY_DEL:
+	case BTMESH_OP_APP_KEY_DEL:
+	case BTMESH_OP_MOD_APP_BIND:
+	case BTMESH_OP_MOD_APP_BIND_VND:
+	case BTMESH_OP_MOD_APP_UNBIND:
+	case BTMESH_OP_MOD_APP_UNBIND_VND:
+	case BTMESH_OP_MOD_PUB_SET:
+	case BTMESH_OP_MOD_PUB_SET_VND:
+	case BTMESH_OP_MOD_SUB_ADD:
+	case BTMESH_OP_MOD_SUB_ADD_VND:
+	case BTMESH_OP_MOD_SUB_DEL:
+	case BTMESH_OP_MOD_SUB_DEL_VND:
+	case BTMESH_OP_MOD_SUB_OVRW:
+	case BTMESH_OP_MOD_SUB_OVRW_VND:
+	case BTMESH_OP_HB_SUB_SET:
+	case BTMESH_OP_HB_PUB_SET:
+		break;
+
+	default:
+		return;
+	}
+
+	/* Rejected by the node, so nothing changed */
+	if (btmesh_get_op_status(op, args)) {
+		return;
+	}
+
+	addr = args->node_reset.addr;
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	err = node_cache_load(addr, &node);
+
+	if (err == -ENOENT) {
+		/* Only the version is tracked until the node is discovered */
+		header_store(addr, version_get(addr) + 1, true);
+	} else if (!err) {
+		node.cfg_version++;
+
+		if (apply(&node, op, args)) {
+			store(&node, true);
+		} else {
+			/* Let the next request rediscover the node */
+			LOG_WRN("Cache of 0x%04x out of sync, dropped", addr);
+			header_store(addr, node.cfg_version, true);
+		}
+
+		btmesh_free_node(&node);
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
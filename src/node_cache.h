@@ -0,0 +1,34 @@
+#ifndef NODE_CACHE_H_
+#define NODE_CACHE_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "btmesh.h"
+
+/* Rebuild a node from its cached configuration. node->addr selects the node. Returns
+ * -ENOENT if the node has not been discovered yet. Free with btmesh_free_node(). */
+int node_cache_load(uint16_t addr, struct btmesh_node *node);
+
+/* Also assigns the node its next configuration version */
+int node_cache_store(struct btmesh_node *node);
+
+void node_cache_delete(uint16_t addr);
+
+/* Number of configuration changes seen for addr, 0 if none are known */
+uint32_t node_cache_version_get(uint16_t addr);
+
+/* Apply the result of a successful configuration operation to the cached node */
+void node_cache_update(enum btmesh_op op, const union btmesh_op_args *args);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* NODE_CACHE_H_ */
@@ -0,0 +1,104 @@
+#include <zephyr.h>
+#include <bluetooth/mesh.h>
+
+#include "node_pool.h"
+
+struct cdb_next {
+	uint16_t after;
+	uint16_t addr;
+	node_pool_match_t match;
+	void *user_data;
+};
+
+static void worker(void *p1, void *unused2, void *unused3)
+{
+	ARG_UNUSED(unused2);
+	ARG_UNUSED(unused3);
+
+	uint16_t addr;
+	struct node_pool *pool = p1;
+
+	for (;;) {
+		k_sem_take(pool->sem, K_FOREVER);
+
+		while (pool->next(&addr)) {
+			pool->node(addr);
+		}
+
+		k_mutex_lock(pool->lock, K_FOREVER);
+
+		if (--pool->running == 0) {
+			pool->done();
+		}
+
+		k_mutex_unlock(pool->lock);
+	}
+}
+
+bool node_pool_busy(const struct node_pool *pool)
+{
+	return pool->running != 0;
+}
+
+int node_pool_start(struct node_pool *pool, int concurrency)
+{
+	int count;
+
+	count = CLAMP(concurrency, 1, pool->workers);
+#if !defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+	/* The stock configuration client only has room for one outstanding request */
+	count = 1;
+#endif // !defined(CONFIG_BT_MESH_ACCESS_LAYER_MSG)
+	pool->running = count;
+
+	return count;
+}
+
+void node_pool_run(struct node_pool *pool, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		k_sem_give(pool->sem);
+	}
+}
+
+static uint8_t find_next(struct bt_mesh_cdb_node *node, void *user_data)
+{
+	struct cdb_next *next;
+
+	next = (struct cdb_next *)user_data;
+
+	if (node->addr > next->after &&
+			(next->addr == BT_MESH_ADDR_UNASSIGNED || node->addr < next->addr) &&
+			(next->match == NULL || next->match(node, next->user_data))) {
+		next->addr = node->addr;
+	}
+
+	return BT_MESH_CDB_ITER_CONTINUE;
+}
+
+uint16_t node_pool_cdb_next(uint16_t after, node_pool_match_t match, void *user_data)
+{
+	struct cdb_next next = {
+		.after = after,
+		.addr = BT_MESH_ADDR_UNASSIGNED,
+		.match = match,
+		.user_data = user_data,
+	};
+
+	bt_mesh_cdb_node_foreach(find_next, &next);
+	return next.addr;
+}
+
+void node_pool_init(struct node_pool *pool)
+{
+	int i;
+
+	for (i = 0; i < pool->workers; i++) {
+		k_thread_create(&pool->threads[i], &pool->stacks[i * pool->stack_len],
+				pool->stack_len - K_THREAD_STACK_RESERVED, worker, pool, NULL,
+				NULL, pool->priority, 0, K_NO_WAIT);
+		k_thread_name_set(&pool->threads[i], pool->name);
+	}
+}
@@ -0,0 +1,85 @@
+#ifndef NODE_POOL_H_
+#define NODE_POOL_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <bluetooth/mesh.h>
+
+/* Hand a worker the next node to work on. Returns false once the run is over. */
+typedef bool (*node_pool_next_t)(uint16_t *addr);
+
+/* Work on one node */
+typedef void (*node_pool_node_t)(uint16_t addr);
+
+/* Called with the pool's lock held by the last worker to run out of nodes */
+typedef void (*node_pool_done_t)(void);
+
+typedef bool (*node_pool_match_t)(const struct bt_mesh_cdb_node *node, void *user_data);
+
+/* A fixed set of worker threads that take nodes from next() until it runs dry. Define with
+ * NODE_POOL_DEFINE(). */
+struct node_pool {
+	const char *name;
+	/* Owned by the user, also guards running */
+	struct k_mutex *lock;
+	struct k_sem *sem;
+	struct k_thread *threads;
+	k_thread_stack_t *stacks;
+	size_t stack_len;
+	int workers;
+	int priority;
+	node_pool_next_t next;
+	node_pool_node_t node;
+	node_pool_done_t done;
+	/* Workers taking part in the current run */
+	int running;
+};
+
+#define NODE_POOL_DEFINE(_name, _workers, _stack_size, _prio, _lock, _next, _node, _done)  \
+	K_THREAD_STACK_ARRAY_DEFINE(_name##_stacks, _workers, _stack_size);                \
+	static struct k_thread _name##_threads[_workers];                                  \
+	K_SEM_DEFINE(_name##_sem, 0, _workers);                                            \
+	static struct node_pool _name = {                                                  \
+		.name = #_name,                                                            \
+		.lock = &(_lock),                                                          \
+		.sem = &_name##_sem,                                                       \
+		.threads = _name##_threads,                                                \
+		.stacks = _name##_stacks[0],                                               \
+		.stack_len = K_THREAD_STACK_LEN(_stack_size),                              \
+		.workers = _workers,                                                       \
+		.priority = _prio,                                                         \
+		.next = _next,                                                             \
+		.node = _node,                                                             \
+		.done = _done,                                                             \
+	}
+
+void node_pool_init(struct node_pool *pool);
+
+/* Called with the pool's lock held */
+bool node_pool_busy(const struct node_pool *pool);
+
+/* Called with the pool's lock held. Reserves concurrency workers, limited to the size of the
+ * pool, for a new run. Returns the number of workers to hand to node_pool_run(). */
+int node_pool_start(struct node_pool *pool, int concurrency);
+
+/* Let count workers reserved by node_pool_start() go, once the lock is released */
+void node_pool_run(struct node_pool *pool, int count);
+
+/* Lowest CDB node address above after that match accepts, BT_MESH_ADDR_UNASSIGNED if there
+ * is none. match may be NULL. */
+uint16_t node_pool_cdb_next(uint16_t after, node_pool_match_t match, void *user_data);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* NODE_POOL_H_ */
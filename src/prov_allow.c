@@ -0,0 +1,435 @@
+#include <zephyr.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/mesh.h>
+#include <logging/log.h>
+#include <settings/settings.h>
+
+#include "prov_allow.h"
+#include "prov_queue.h"
+
+/* Each entry is stored as one settings value, "pallow/<slot>":
+ *
+ *   format version, UUID prefix length, UUID prefix, net_idx (little endian), element count
+ */
+#define ALLOW_VERSION 1
+#define ALLOW_SETTINGS_ROOT "pallow"
+#define ALLOW_KEY_LEN sizeof(ALLOW_SETTINGS_ROOT "/255")
+#define ALLOW_VALUE_MAX (5 + UUID_LEN)
+
+/* Mesh beacon advertising data: beacon type followed by the device UUID */
+#define BEACON_TYPE_UNPROVISIONED 0x00
+#define BEACON_UUID_OFFSET 1
+
+#define RSSI_UNKNOWN INT8_MIN
+
+
+LOG_MODULE_REGISTER(app_prov_allow, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+struct candidate {
+	uint8_t uuid[UUID_LEN];
+	/* Strongest signal the beacon was received with during the window */
+	int8_t rssi;
+	uint16_t net_idx;
+	uint8_t elem_count;
+};
+
+struct recent {
+	uint8_t uuid[UUID_LEN];
+	int64_t time;
+};
+
+K_MUTEX_DEFINE(allow_lock);
+/* Orders the settings writes, so the last one of a slot always stores its latest entry.
+ * Taken before allow_lock, never while holding it. */
+K_MUTEX_DEFINE(store_lock);
+
+static struct {
+	bool used;
+	struct prov_allow_entry entry;
+} entries[CONFIG_GATEWAY_PROV_ALLOWLIST_MAX];
+
+static struct candidate candidates[CONFIG_GATEWAY_PROV_ALLOWLIST_PENDING];
+static atomic_t candidate_count;
+/* Devices queued lately, not queued again until CONFIG_GATEWAY_PROV_ALLOWLIST_HOLDOFF has
+ * passed. Oldest entries are overwritten. */
+static struct recent recent[CONFIG_GATEWAY_PROV_ALLOWLIST_PENDING];
+static size_t recent_next;
+
+static void allow_key(size_t slot, char key[ALLOW_KEY_LEN])
+{
+	snprintk(key, ALLOW_KEY_LEN, ALLOW_SETTINGS_ROOT "/%u", (unsigned int)slot);
+}
+
+static int slot_find(const uint8_t *uuid_prefix, uint8_t uuid_prefix_len)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].used && entries[i].entry.uuid_prefix_len == uuid_prefix_len &&
+				!memcmp(entries[i].entry.uuid_prefix, uuid_prefix, uuid_prefix_len)) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+/* Longest matching prefix, called with allow_lock held */
+static int best_match(const uint8_t uuid[UUID_LEN])
+{
+	size_t i;
+	int best;
+
+	best = -ENOENT;
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (!entries[i].used ||
+		    memcmp(entries[i].entry.uuid_prefix, uuid, entries[i].entry.uuid_prefix_len) ||
+		    (best >= 0 && entries[i].entry.uuid_prefix_len <=
+				entries[best].entry.uuid_prefix_len)) {
+			continue;
+		}
+
+		best = i;
+	}
+
+	return best;
+}
+
+/* Write the current entry of slot to settings, or delete it if the slot is free. The entry is
+ * copied under allow_lock and written without it, so beacon scanning does not wait for flash. */
+static int slot_store(size_t slot)
+{
+	int err;
+	bool used;
+	char key[ALLOW_KEY_LEN];
+	struct prov_allow_entry entry;
+
+	NET_BUF_SIMPLE_DEFINE(buf, ALLOW_VALUE_MAX);
+
+	allow_key(slot, key);
+	k_mutex_lock(&store_lock, K_FOREVER);
+
+	k_mutex_lock(&allow_lock, K_FOREVER);
+	used = entries[slot].used;
+	entry = entries[slot].entry;
+	k_mutex_unlock(&allow_lock);
+
+	if (!used) {
+		err = settings_delete(key);
+		goto unlock;
+	}
+
+	net_buf_simple_add_u8(&buf, ALLOW_VERSION);
+	net_buf_simple_add_u8(&buf, entry.uuid_prefix_len);
+	net_buf_simple_add_mem(&buf, entry.uuid_prefix, entry.uuid_prefix_len);
+	net_buf_simple_add_le16(&buf, entry.net_idx);
+	net_buf_simple_add_u8(&buf, entry.elem_count);
+	err = settings_save_one(key, buf.data, buf.len);
+
+unlock:
+	k_mutex_unlock(&store_lock);
+	return err;
+}
+
+int prov_allow_add(const struct prov_allow_entry *entry)
+{
+	int slot;
+	size_t i;
+
+	if (entry->uuid_prefix_len == 0 || entry->uuid_prefix_len > UUID_LEN ||
+	    entry->elem_count == 0) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&allow_lock, K_FOREVER);
+	slot = slot_find(entry->uuid_prefix, entry->uuid_prefix_len);
+
+	for (i = 0; slot < 0 && i < ARRAY_SIZE(entries); i++) {
+		if (!entries[i].used) {
+			slot = i;
+		}
+	}
+
+	if (slot >= 0) {
+		entries[slot].used = true;
+		entries[slot].entry = *entry;
+	}
+
+	k_mutex_unlock(&allow_lock);
+
+	if (slot < 0) {
+		return -ENOMEM;
+	}
+
+	return slot_store(slot);
+}
+
+int prov_allow_delete(const uint8_t *uuid_prefix, uint8_t uuid_prefix_len)
+{
+	int slot;
+
+	k_mutex_lock(&allow_lock, K_FOREVER);
+	slot = slot_find(uuid_prefix, uuid_prefix_len);
+
+	if (slot >= 0) {
+		entries[slot].used = false;
+	}
+
+	k_mutex_unlock(&allow_lock);
+
+	if (slot < 0) {
+		return slot;
+	}
+
+	/* The entry no longer applies even if it could not be removed from flash */
+	slot_store(slot);
+
+	return 0;
+}
+
+int prov_allow_get(size_t idx, struct prov_allow_entry *entry)
+{
+	int err;
+
+	if (idx >= ARRAY_SIZE(entries)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&allow_lock, K_FOREVER);
+	err = entries[idx].used ? 0 : -ENOENT;
+
+	if (!err) {
+		*entry = entries[idx].entry;
+	}
+
+	k_mutex_unlock(&allow_lock);
+
+	return err;
+}
+
+static bool recently_queued(const uint8_t uuid[UUID_LEN], int64_t now)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(recent); i++) {
+		if (recent[i].time && !util_uuid_cmp(recent[i].uuid, uuid) &&
+		    now - recent[i].time < CONFIG_GATEWAY_PROV_ALLOWLIST_HOLDOFF * MSEC_PER_SEC) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int candidate_find(const uint8_t uuid[UUID_LEN])
+{
+	int i;
+
+	for (i = 0; i < atomic_get(&candidate_count); i++) {
+		if (!util_uuid_cmp(candidates[i].uuid, uuid)) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static void window_end(struct k_work *work)
+{
+	int i;
+	int j;
+	int err;
+	int count;
+	char uuid_str[UUID_STR_LEN];
+	struct candidate sorted[CONFIG_GATEWAY_PROV_ALLOWLIST_PENDING];
+	struct candidate tmp;
+	struct prov_queue_dev dev;
+
+	k_mutex_lock(&allow_lock, K_FOREVER);
+
+	count = atomic_get(&candidate_count);
+	memcpy(sorted, candidates, sizeof(candidates[0]) * count);
+	atomic_set(&candidate_count, 0);
+
+	for (i = 0; i < count; i++) {
+		util_uuid_cpy(recent[recent_next].uuid, sorted[i].uuid);
+		recent[recent_next].time = k_uptime_get();
+		recent_next = (recent_next + 1) % ARRAY_SIZE(recent);
+	}
+
+	k_mutex_unlock(&allow_lock);
+
+	/* Strongest signal first, the queue provisions devices in the order they are added */
+	for (i = 1; i < count; i++) {
+		tmp = sorted[i];
+
+		for (j = i; j > 0 && sorted[j - 1].rssi < tmp.rssi; j--) {
+			sorted[j] = sorted[j - 1];
+		}
+
+		sorted[j] = tmp;
+	}
+
+	for (i = 0; i < count; i++) {
+		memset(&dev, 0, sizeof(dev));
+		util_uuid_cpy(dev.uuid, sorted[i].uuid);
+		dev.net_idx = sorted[i].net_idx;
+		dev.addr = BT_MESH_ADDR_UNASSIGNED;
+		dev.elem_count = sorted[i].elem_count;
+		err = prov_queue_add(&dev);
+		util_uuid2str(dev.uuid, uuid_str);
+
+		if (err && err != -EALREADY) {
+			LOG_WRN("Failed to queue allowlisted device %s: %d", log_strdup(uuid_str),
+					err);
+		} else if (!err) {
+			LOG_INF("Queued allowlisted device %s, RSSI %d", log_strdup(uuid_str),
+					sorted[i].rssi);
+		}
+	}
+}
+
+K_WORK_DELAYABLE_DEFINE(window_work, window_end);
+
+void prov_allow_beacon(const uint8_t uuid[UUID_LEN])
+{
+	int slot;
+	int count;
+
+	k_mutex_lock(&allow_lock, K_FOREVER);
+	count = atomic_get(&candidate_count);
+
+	if (count == ARRAY_SIZE(candidates) || candidate_find(uuid) >= 0 ||
+	    recently_queued(uuid, k_uptime_get())) {
+		goto unlock;
+	}
+
+	slot = best_match(uuid);
+
+	if (slot < 0) {
+		goto unlock;
+	}
+
+	memcpy(candidates[count].uuid, uuid, UUID_LEN);
+	candidates[count].rssi = RSSI_UNKNOWN;
+	candidates[count].net_idx = entries[slot].entry.net_idx;
+	candidates[count].elem_count = entries[slot].entry.elem_count;
+	atomic_inc(&candidate_count);
+
+	/* Started by the first device of a window */
+	k_work_schedule(&window_work, K_MSEC(CONFIG_GATEWAY_PROV_ALLOWLIST_WINDOW_MS));
+
+unlock:
+	k_mutex_unlock(&allow_lock);
+}
+
+static bool beacon_ad(struct bt_data *data, void *user_data)
+{
+	const uint8_t **uuid = user_data;
+
+	if (data->type != BT_DATA_MESH_BEACON) {
+		return true;
+	}
+
+	if (data->data_len >= BEACON_UUID_OFFSET + UUID_LEN &&
+	    data->data[0] == BEACON_TYPE_UNPROVISIONED) {
+		*uuid = &data->data[BEACON_UUID_OFFSET];
+	}
+
+	return false;
+}
+
+/* The mesh stack does not pass the RSSI of unprovisioned beacons on, so it is taken from the
+ * advertising reports. The mesh stack sees every report first, so a new candidate is already
+ * listed when its own beacon comes by here. */
+static void scan_recv(const struct bt_le_scan_recv_info *info, struct net_buf_simple *buf)
+{
+	int idx;
+	const uint8_t *uuid;
+
+	if (!atomic_get(&candidate_count) || info->adv_type != BT_GAP_ADV_TYPE_ADV_NONCONN_IND) {
+		return;
+	}
+
+	uuid = NULL;
+	bt_data_parse(buf, beacon_ad, &uuid);
+
+	if (uuid == NULL) {
+		return;
+	}
+
+	k_mutex_lock(&allow_lock, K_FOREVER);
+	idx = candidate_find(uuid);
+
+	if (idx >= 0 && info->rssi > candidates[idx].rssi) {
+		candidates[idx].rssi = info->rssi;
+	}
+
+	k_mutex_unlock(&allow_lock);
+}
+
+static struct bt_le_scan_cb scan_cb = {
+	.recv = scan_recv,
+};
+
+void prov_allow_init(void)
+{
+	bt_le_scan_cb_register(&scan_cb);
+}
+
+static int allow_set(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+	char *end;
+	unsigned long slot;
+	ssize_t read_len;
+	uint8_t prefix_len;
+	struct prov_allow_entry *entry;
+
+	NET_BUF_SIMPLE_DEFINE(buf, ALLOW_VALUE_MAX);
+
+	slot = strtoul(key, &end, 10);
+
+	if (*end != '\0' || slot >= ARRAY_SIZE(entries)) {
+		return -ENOENT;
+	}
+
+	entries[slot].used = false;
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if (len > ALLOW_VALUE_MAX) {
+		return -EINVAL;
+	}
+
+	read_len = read_cb(cb_arg, net_buf_simple_add(&buf, len), len);
+
+	if (read_len < 0) {
+		return read_len;
+	}
+
+	if (read_len != len || len < 2 || net_buf_simple_pull_u8(&buf) != ALLOW_VERSION) {
+		return -EINVAL;
+	}
+
+	prefix_len = net_buf_simple_pull_u8(&buf);
+
+	if (prefix_len == 0 || prefix_len > UUID_LEN || buf.len != prefix_len + 3) {
+		return -EINVAL;
+	}
+
+	entry = &entries[slot].entry;
+	memcpy(entry->uuid_prefix, net_buf_simple_pull_mem(&buf, prefix_len), prefix_len);
+	entry->uuid_prefix_len = prefix_len;
+	entry->net_idx = net_buf_simple_pull_le16(&buf);
+	entry->elem_count = net_buf_simple_pull_u8(&buf);
+	entries[slot].used = true;
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(prov_allow, ALLOW_SETTINGS_ROOT, NULL, allow_set, NULL, NULL);
@@ -0,0 +1,47 @@
+#ifndef PROV_ALLOW_H_
+#define PROV_ALLOW_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util.h"
+
+struct prov_allow_entry {
+	uint8_t uuid_prefix[UUID_LEN];
+	/* UUID_LEN for a single device */
+	uint8_t uuid_prefix_len;
+	/* Provisioning parameters of the devices that match */
+	uint16_t net_idx;
+	uint8_t elem_count;
+};
+
+/* Add an entry, or replace the one with the same UUID prefix. The entry applies right away,
+ * an error from storing it means it is lost on reboot. */
+int prov_allow_add(const struct prov_allow_entry *entry);
+
+int prov_allow_delete(const uint8_t *uuid_prefix, uint8_t uuid_prefix_len);
+
+/* Entries are listed by slot, unused slots return -ENOENT and idx past the last slot
+ * returns -EINVAL */
+int prov_allow_get(size_t idx, struct prov_allow_entry *entry);
+
+/* Called for every unprovisioned beacon that is not blocked. Devices matching an entry are
+ * collected for CONFIG_GATEWAY_PROV_ALLOWLIST_WINDOW_MS and then queued for provisioning,
+ * strongest signal first. */
+void prov_allow_beacon(const uint8_t uuid[UUID_LEN]);
+
+void prov_allow_init(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* PROV_ALLOW_H_ */
@@ -0,0 +1,454 @@
+#include <zephyr.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+#include <logging/log.h>
+#include <settings/settings.h>
+
+#include "btmesh.h"
+#include "prov_profile.h"
+
+/* Each profile is stored as one settings value, "pprof/<slot>":
+ *
+ *   format version, name length, name, UUID prefix length, UUID prefix, match flags, cid, pid,
+ *   followed by the JSON configuration steps up to the end of the value.
+ *
+ * The match criteria of every profile are kept in RAM, the steps are read back from settings
+ * when a node needs them.
+ */
+#define PROFILE_VERSION 1
+#define PROFILE_SETTINGS_ROOT "pprof"
+#define PROFILE_KEY_LEN sizeof(PROFILE_SETTINGS_ROOT "/255")
+#define PROFILE_HEADER_MAX (6 + PROV_PROFILE_NAME_LEN + UUID_LEN + 4)
+
+#define FLAG_CID BIT(0)
+#define FLAG_PID BIT(1)
+
+/* Enough of composition data page 0 to hold the company and product IDs */
+#define COMP_ID_LEN 4
+
+
+LOG_MODULE_REGISTER(app_prov_profile, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+K_MUTEX_DEFINE(profile_lock);
+
+static struct {
+	bool used;
+	struct prov_profile_info info;
+} profiles[CONFIG_GATEWAY_PROV_PROFILE_MAX];
+
+struct load_ctx {
+	uint8_t *data;
+	size_t len;
+};
+
+static void profile_key(size_t slot, char key[PROFILE_KEY_LEN])
+{
+	snprintk(key, PROFILE_KEY_LEN, PROFILE_SETTINGS_ROOT "/%u", (unsigned int)slot);
+}
+
+static int header_get(struct net_buf_simple *buf, struct prov_profile_info *info)
+{
+	uint8_t len;
+	uint8_t flags;
+
+	if (buf->len < 2 || net_buf_simple_pull_u8(buf) != PROFILE_VERSION) {
+		return -EINVAL;
+	}
+
+	len = net_buf_simple_pull_u8(buf);
+
+	if (len > PROV_PROFILE_NAME_LEN || buf->len < len + 1) {
+		return -EINVAL;
+	}
+
+	memcpy(info->name, net_buf_simple_pull_mem(buf, len), len);
+	info->name[len] = '\0';
+	len = net_buf_simple_pull_u8(buf);
+
+	if (len > UUID_LEN || buf->len < len + 5) {
+		return -EINVAL;
+	}
+
+	memcpy(info->match.uuid_prefix, net_buf_simple_pull_mem(buf, len), len);
+	info->match.uuid_prefix_len = len;
+	flags = net_buf_simple_pull_u8(buf);
+	info->match.cid = net_buf_simple_pull_le16(buf);
+	info->match.pid = net_buf_simple_pull_le16(buf);
+	info->match.cid_set = flags & FLAG_CID;
+	info->match.pid_set = flags & FLAG_PID;
+
+	return 0;
+}
+
+static void header_add(struct net_buf_simple *buf, const struct prov_profile_info *info)
+{
+	size_t len;
+
+	len = strlen(info->name);
+	net_buf_simple_add_u8(buf, PROFILE_VERSION);
+	net_buf_simple_add_u8(buf, len);
+	net_buf_simple_add_mem(buf, info->name, len);
+	net_buf_simple_add_u8(buf, info->match.uuid_prefix_len);
+	net_buf_simple_add_mem(buf, info->match.uuid_prefix, info->match.uuid_prefix_len);
+	net_buf_simple_add_u8(buf, (info->match.cid_set ? FLAG_CID : 0) |
+			(info->match.pid_set ? FLAG_PID : 0));
+	net_buf_simple_add_le16(buf, info->match.cid);
+	net_buf_simple_add_le16(buf, info->match.pid);
+}
+
+static int load_cb(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg,
+		void *param)
+{
+	ssize_t read_len;
+	struct load_ctx *ctx = param;
+
+	if (key != NULL) {
+		return 0;
+	}
+
+	/* The last value written wins, deleted entries read back as empty values */
+	k_free(ctx->data);
+	ctx->data = NULL;
+	ctx->len = 0;
+
+	if (len == 0) {
+		return 0;
+	}
+
+	/* Room for the string terminator of the steps */
+	ctx->data = k_malloc(len + 1);
+
+	if (ctx->data == NULL) {
+		return -ENOMEM;
+	}
+
+	read_len = read_cb(cb_arg, ctx->data, len);
+
+	if (read_len < 0) {
+		k_free(ctx->data);
+		ctx->data = NULL;
+		return read_len;
+	}
+
+	ctx->len = read_len;
+	return 0;
+}
+
+/* Returns the steps of the profile in slot as a string allocated with k_malloc() */
+static int steps_load(size_t slot, char **steps)
+{
+	int err;
+	char key[PROFILE_KEY_LEN];
+	struct load_ctx ctx;
+	struct net_buf_simple buf;
+	struct prov_profile_info info;
+
+	memset(&ctx, 0, sizeof(ctx));
+	profile_key(slot, key);
+	err = settings_load_subtree_direct(key, load_cb, &ctx);
+
+	if (!err && ctx.data == NULL) {
+		err = -ENOENT;
+	}
+
+	if (err) {
+		k_free(ctx.data);
+		return err;
+	}
+
+	net_buf_simple_init_with_data(&buf, ctx.data, ctx.len);
+	err = header_get(&buf, &info);
+
+	if (err) {
+		k_free(ctx.data);
+		return err;
+	}
+
+	memmove(ctx.data, buf.data, buf.len);
+	ctx.data[buf.len] = '\0';
+	*steps = (char *)ctx.data;
+
+	return 0;
+}
+
+static int slot_find(const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(profiles); i++) {
+		if (profiles[i].used && !strcmp(profiles[i].info.name, name)) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+int prov_profile_store(const struct prov_profile_info *info, const char *steps)
+{
+	int err;
+	int slot;
+	size_t i;
+	size_t steps_len;
+	char key[PROFILE_KEY_LEN];
+	struct net_buf_simple buf;
+	uint8_t *data;
+
+	steps_len = strlen(steps);
+
+	if (info->name[0] == '\0' || steps_len > CONFIG_GATEWAY_PROV_PROFILE_MAX_SIZE) {
+		return -EINVAL;
+	}
+
+	data = k_malloc(PROFILE_HEADER_MAX + steps_len);
+
+	if (data == NULL) {
+		return -ENOMEM;
+	}
+
+	net_buf_simple_init_with_data(&buf, data, PROFILE_HEADER_MAX + steps_len);
+	net_buf_simple_reset(&buf);
+	header_add(&buf, info);
+	net_buf_simple_add_mem(&buf, steps, steps_len);
+
+	k_mutex_lock(&profile_lock, K_FOREVER);
+	slot = slot_find(info->name);
+
+	for (i = 0; slot < 0 && i < ARRAY_SIZE(profiles); i++) {
+		if (!profiles[i].used) {
+			slot = i;
+		}
+	}
+
+	if (slot < 0) {
+		err = -ENOMEM;
+		goto unlock;
+	}
+
+	profile_key(slot, key);
+	err = settings_save_one(key, buf.data, buf.len);
+
+	if (err) {
+		goto unlock;
+	}
+
+	profiles[slot].used = true;
+	profiles[slot].info = *info;
+	LOG_INF("Stored provisioning profile %s", log_strdup(info->name));
+
+unlock:
+	k_mutex_unlock(&profile_lock);
+	k_free(data);
+	return err;
+}
+
+int prov_profile_delete(const char *name)
+{
+	int slot;
+	char key[PROFILE_KEY_LEN];
+
+	k_mutex_lock(&profile_lock, K_FOREVER);
+	slot = slot_find(name);
+
+	if (slot >= 0) {
+		profiles[slot].used = false;
+		profile_key(slot, key);
+		settings_delete(key);
+	}
+
+	k_mutex_unlock(&profile_lock);
+
+	return slot < 0 ? slot : 0;
+}
+
+int prov_profile_get(size_t idx, struct prov_profile_info *info)
+{
+	int err;
+
+	if (idx >= ARRAY_SIZE(profiles)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&profile_lock, K_FOREVER);
+	err = profiles[idx].used ? 0 : -ENOENT;
+
+	if (!err) {
+		*info = profiles[idx].info;
+	}
+
+	k_mutex_unlock(&profile_lock);
+
+	return err;
+}
+
+static bool uuid_match(const struct prov_profile_match *match, const uint8_t uuid[UUID_LEN])
+{
+	return !memcmp(match->uuid_prefix, uuid, match->uuid_prefix_len);
+}
+
+static bool needs_comp(const struct prov_profile_match *match)
+{
+	return match->cid_set || match->pid_set;
+}
+
+/* More criteria, then a longer UUID prefix, make a profile more specific */
+static int specificity(const struct prov_profile_match *match)
+{
+	return ((!!match->uuid_prefix_len + match->cid_set + match->pid_set) << 8) +
+		match->uuid_prefix_len;
+}
+
+/* Returns the most specific matching slot. cid and pid are only compared if comp is set. */
+static int best_match(const uint8_t uuid[UUID_LEN], bool comp, uint16_t cid, uint16_t pid,
+		bool *comp_needed)
+{
+	size_t i;
+	int best;
+	int score;
+	int best_score;
+	const struct prov_profile_match *match;
+
+	best = -ENOENT;
+	best_score = 0;
+
+	for (i = 0; i < ARRAY_SIZE(profiles); i++) {
+		match = &profiles[i].info.match;
+		score = specificity(match);
+
+		if (!profiles[i].used || score <= best_score || !uuid_match(match, uuid)) {
+			continue;
+		}
+
+		if (needs_comp(match) && !comp) {
+			*comp_needed = true;
+			continue;
+		}
+
+		if ((match->cid_set && match->cid != cid) || (match->pid_set && match->pid != pid)) {
+			continue;
+		}
+
+		best = i;
+		best_score = score;
+	}
+
+	return best;
+}
+
+static int comp_ids_get(uint16_t net_idx, uint16_t addr, uint16_t *cid, uint16_t *pid)
+{
+	int err;
+	union btmesh_op_args args;
+
+	NET_BUF_SIMPLE_DEFINE(comp, COMP_ID_LEN);
+
+	args.comp_get.net_idx = net_idx;
+	args.comp_get.addr = addr;
+	args.comp_get.page = 0;
+	args.comp_get.comp = &comp;
+	err = btmesh_perform_op(BTMESH_OP_COMP_GET, &args);
+
+	if (err) {
+		return err;
+	}
+
+	if (comp.len < COMP_ID_LEN) {
+		return -EMSGSIZE;
+	}
+
+	*cid = net_buf_simple_pull_le16(&comp);
+	*pid = net_buf_simple_pull_le16(&comp);
+
+	return 0;
+}
+
+int prov_profile_find(const char *name, const uint8_t uuid[UUID_LEN], uint16_t net_idx,
+		uint16_t addr, struct prov_profile_info *info, char **steps)
+{
+	int err;
+	int slot;
+	uint16_t cid;
+	uint16_t pid;
+	bool comp_needed;
+
+	comp_needed = false;
+	k_mutex_lock(&profile_lock, K_FOREVER);
+
+	if (name != NULL) {
+		slot = slot_find(name);
+	} else {
+		slot = best_match(uuid, false, 0, 0, &comp_needed);
+	}
+
+	k_mutex_unlock(&profile_lock);
+
+	/* A more specific profile may depend on the composition data */
+	if (comp_needed) {
+		err = comp_ids_get(net_idx, addr, &cid, &pid);
+
+		if (err) {
+			LOG_WRN("Failed to read composition of 0x%04x for profile match: %d", addr,
+					err);
+		} else {
+			k_mutex_lock(&profile_lock, K_FOREVER);
+			slot = best_match(uuid, true, cid, pid, &comp_needed);
+			k_mutex_unlock(&profile_lock);
+		}
+	}
+
+	if (slot < 0) {
+		return slot;
+	}
+
+	err = prov_profile_get(slot, info);
+
+	if (err) {
+		return err;
+	}
+
+	return steps_load(slot, steps);
+}
+
+static int profile_set(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+	int err;
+	char *end;
+	unsigned long slot;
+	ssize_t read_len;
+	uint8_t *data;
+	struct net_buf_simple buf;
+
+	slot = strtoul(key, &end, 10);
+
+	if (*end != '\0' || slot >= ARRAY_SIZE(profiles)) {
+		return -ENOENT;
+	}
+
+	profiles[slot].used = false;
+
+	if (len == 0) {
+		return 0;
+	}
+
+	data = k_malloc(len);
+
+	if (data == NULL) {
+		return -ENOMEM;
+	}
+
+	read_len = read_cb(cb_arg, data, len);
+	err = read_len < 0 ? read_len : 0;
+
+	if (!err) {
+		net_buf_simple_init_with_data(&buf, data, read_len);
+		err = header_get(&buf, &profiles[slot].info);
+		profiles[slot].used = !err;
+	}
+
+	k_free(data);
+	return err;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(prov_profile, PROFILE_SETTINGS_ROOT, NULL, profile_set, NULL,
+		NULL);
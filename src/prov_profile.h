@@ -0,0 +1,57 @@
+#ifndef PROV_PROFILE_H_
+#define PROV_PROFILE_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util.h"
+
+#define PROV_PROFILE_NAME_LEN 16
+
+/* A profile applies to a new node if every criterion that is set matches. Profiles without
+ * any criteria are only applied when a provisioning request names them. */
+struct prov_profile_match {
+	uint8_t uuid_prefix[UUID_LEN];
+	uint8_t uuid_prefix_len;
+	/* Compared against the composition data of the node */
+	bool cid_set;
+	uint16_t cid;
+	bool pid_set;
+	uint16_t pid;
+};
+
+struct prov_profile_info {
+	char name[PROV_PROFILE_NAME_LEN + 1];
+	struct prov_profile_match match;
+};
+
+/* Add a profile, or replace the one with the same name. steps is the JSON array of
+ * configuration steps applied to matching nodes. */
+int prov_profile_store(const struct prov_profile_info *info, const char *steps);
+
+int prov_profile_delete(const char *name);
+
+/* Profiles are listed by slot, unused slots return -ENOENT and idx past the last slot
+ * returns -EINVAL */
+int prov_profile_get(size_t idx, struct prov_profile_info *info);
+
+/* Pick the profile for a newly provisioned node. A named profile is used as is, otherwise the
+ * most specific profile matching the node is chosen, reading the composition data of the node
+ * only if a candidate depends on it. On success *steps holds the JSON steps of the profile,
+ * to be released with k_free(). Returns -ENOENT if no profile applies. */
+int prov_profile_find(const char *name, const uint8_t uuid[UUID_LEN], uint16_t net_idx,
+		uint16_t addr, struct prov_profile_info *info, char **steps);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* PROV_PROFILE_H_ */
@@ -0,0 +1,437 @@
+#include <zephyr.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+#include <logging/log.h>
+
+#include "btmesh.h"
+#include "gateway.h"
+#include "prov_queue.h"
+#include "util.h"
+
+#define PROV_QUEUE_PRIORITY 7
+#define ADDR_WORD_BITS 32
+#define ADDR_WORDS DIV_ROUND_UP(CONFIG_GATEWAY_PROV_QUEUE_ADDR_COUNT, ADDR_WORD_BITS)
+
+/* The allocated range has to stay within the unicast addresses */
+BUILD_ASSERT(CONFIG_GATEWAY_PROV_QUEUE_ADDR_MIN + CONFIG_GATEWAY_PROV_QUEUE_ADDR_COUNT - 1 <=
+		0x7fff);
+
+
+LOG_MODULE_REGISTER(app_prov_queue, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+struct queue_entry {
+	bool used;
+	/* Order the device was queued in, due devices are provisioned oldest first */
+	uint32_t seq;
+	int64_t next_try;
+	uint8_t attempts;
+	struct prov_queue_dev dev;
+};
+
+K_THREAD_STACK_DEFINE(prov_queue_stack, CONFIG_GATEWAY_PROV_QUEUE_STACK_SIZE);
+static struct k_thread prov_queue_thread;
+
+K_SEM_DEFINE(prov_queue_sem, 0, 1);
+/* Given when the device being provisioned is added to the CDB */
+K_SEM_DEFINE(prov_added_sem, 0, 1);
+K_MUTEX_DEFINE(prov_queue_lock);
+
+static struct queue_entry entries[CONFIG_GATEWAY_PROV_QUEUE_SIZE];
+static uint32_t next_seq;
+
+/* Entry being provisioned, or -1 */
+static int active = -1;
+static int64_t active_start;
+static struct {
+	bool done;
+	uint16_t net_idx;
+	uint16_t addr;
+	uint8_t num_elem;
+} added;
+
+static struct prov_queue_stats stats;
+static uint64_t time_total;
+static int64_t batch_start;
+static int64_t batch_end;
+
+/* Used unicast addresses from CONFIG_GATEWAY_PROV_QUEUE_ADDR_MIN on, one bit per address */
+static uint32_t addr_map[ADDR_WORDS];
+
+static void addr_mark(uint16_t addr, uint8_t count)
+{
+	uint32_t idx;
+
+	for (; count > 0; count--, addr++) {
+		if (addr < CONFIG_GATEWAY_PROV_QUEUE_ADDR_MIN) {
+			continue;
+		}
+
+		idx = addr - CONFIG_GATEWAY_PROV_QUEUE_ADDR_MIN;
+
+		if (idx >= CONFIG_GATEWAY_PROV_QUEUE_ADDR_COUNT) {
+			return;
+		}
+
+		addr_map[idx / ADDR_WORD_BITS] |= BIT(idx % ADDR_WORD_BITS);
+	}
+}
+
+static uint8_t mark_node(struct bt_mesh_cdb_node *node, void *user_data)
+{
+	addr_mark(node->addr, node->num_elem);
+	return BT_MESH_CDB_ITER_CONTINUE;
+}
+
+/* First fit of count free addresses. The map is built again every time, as nodes are also
+ * added and removed outside the queue. Called with prov_queue_lock held. */
+static int addr_alloc(uint8_t count, uint16_t *addr)
+{
+	size_t i;
+	uint32_t idx;
+	uint32_t run;
+
+	memset(addr_map, 0, sizeof(addr_map));
+	bt_mesh_cdb_node_foreach(mark_node, NULL);
+
+	/* Fixed addresses of waiting devices are taken as well */
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].used && entries[i].dev.addr != BT_MESH_ADDR_UNASSIGNED) {
+			addr_mark(entries[i].dev.addr, entries[i].dev.elem_count);
+		}
+	}
+
+	run = 0;
+
+	for (idx = 0; idx < CONFIG_GATEWAY_PROV_QUEUE_ADDR_COUNT; idx++) {
+		if (idx % ADDR_WORD_BITS == 0 && addr_map[idx / ADDR_WORD_BITS] == UINT32_MAX) {
+			run = 0;
+			idx += ADDR_WORD_BITS - 1;
+			continue;
+		}
+
+		if (addr_map[idx / ADDR_WORD_BITS] & BIT(idx % ADDR_WORD_BITS)) {
+			run = 0;
+			continue;
+		}
+
+		if (++run == count) {
+			*addr = CONFIG_GATEWAY_PROV_QUEUE_ADDR_MIN + idx - (count - 1);
+			return 0;
+		}
+	}
+
+	return -EADDRNOTAVAIL;
+}
+
+static uint32_t queue_count(void)
+{
+	size_t i;
+	uint32_t count;
+
+	count = 0;
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].used) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+static int64_t retry_delay_ms(uint8_t attempts)
+{
+	return (int64_t)util_backoff(CONFIG_GATEWAY_PROV_QUEUE_RETRY_MIN,
+			CONFIG_GATEWAY_PROV_QUEUE_RETRY_MAX, attempts) * MSEC_PER_SEC;
+}
+
+/* Picks the next due device and makes it active. Returns -1 and sets *wait if none is due. */
+static int next_entry(k_timeout_t *wait)
+{
+	size_t i;
+	int next;
+	int64_t now;
+	int64_t first_try;
+
+	next = -1;
+	now = k_uptime_get();
+	first_try = INT64_MAX;
+	k_mutex_lock(&prov_queue_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (!entries[i].used) {
+			continue;
+		}
+
+		if (entries[i].next_try > now) {
+			first_try = MIN(first_try, entries[i].next_try);
+		} else if (next < 0 || entries[i].seq < entries[next].seq) {
+			next = (int)i;
+		}
+	}
+
+	if (next >= 0) {
+		active = next;
+		active_start = now;
+		added.done = false;
+		k_sem_reset(&prov_added_sem);
+	}
+
+	k_mutex_unlock(&prov_queue_lock);
+
+	*wait = first_try == INT64_MAX ? K_FOREVER : K_MSEC(first_try - now);
+	return next;
+}
+
+static void prov_done(int idx, int err)
+{
+	bool retry;
+	bool empty;
+	uint8_t attempts;
+	int64_t now;
+	struct queue_entry *entry;
+	struct prov_queue_result res;
+
+	now = k_uptime_get();
+	memset(&res, 0, sizeof(res));
+	k_mutex_lock(&prov_queue_lock, K_FOREVER);
+
+	entry = &entries[idx];
+	active = -1;
+	entry->attempts++;
+
+	/* The node may have been added just as the attempt timed out */
+	if (added.done) {
+		err = 0;
+	}
+
+	res.err = err;
+	memcpy(res.uuid, entry->dev.uuid, UUID_LEN);
+	strcpy(res.profile, entry->dev.profile);
+
+	if (!err) {
+		res.net_idx = added.net_idx;
+		res.addr = added.addr;
+		res.num_elem = added.num_elem;
+		time_total += now - active_start;
+		stats.done++;
+		stats.batch_done++;
+		stats.avg_time_ms = time_total / stats.done;
+	}
+
+	attempts = entry->attempts;
+	retry = err && attempts <= CONFIG_GATEWAY_PROV_QUEUE_RETRIES;
+
+	if (retry) {
+		entry->next_try = now + retry_delay_ms(entry->attempts);
+		stats.retries++;
+	} else {
+		entry->used = false;
+		stats.failed += err ? 1 : 0;
+	}
+
+	empty = queue_count() == 0;
+
+	if (empty) {
+		batch_end = now;
+	}
+
+	k_mutex_unlock(&prov_queue_lock);
+
+	if (retry) {
+		LOG_WRN("Provisioning attempt %d failed: %d, retrying", attempts, err);
+		return;
+	}
+
+	gateway_prov_result(&res);
+
+	if (empty) {
+		gateway_prov_queue_status();
+	}
+}
+
+static void provision(int idx)
+{
+	int err;
+	char uuid_str[UUID_STR_LEN];
+	union btmesh_op_args args;
+
+	err = 0;
+	k_mutex_lock(&prov_queue_lock, K_FOREVER);
+
+	memcpy(args.prov_adv.uuid, entries[idx].dev.uuid, UUID_LEN);
+	args.prov_adv.net_idx = entries[idx].dev.net_idx;
+	args.prov_adv.addr = entries[idx].dev.addr;
+	args.prov_adv.attn = entries[idx].dev.attn;
+
+	if (args.prov_adv.addr == BT_MESH_ADDR_UNASSIGNED) {
+		err = addr_alloc(entries[idx].dev.elem_count, &args.prov_adv.addr);
+	}
+
+	k_mutex_unlock(&prov_queue_lock);
+
+	util_uuid2str(args.prov_adv.uuid, uuid_str);
+
+	if (err) {
+		LOG_ERR("No room for %s in the unicast range", log_strdup(uuid_str));
+		prov_done(idx, err);
+		return;
+	}
+
+	LOG_INF("Provisioning %s as 0x%04x", log_strdup(uuid_str), args.prov_adv.addr);
+	err = btmesh_perform_op(BTMESH_OP_PROV_ADV, &args);
+
+	/* The mesh stack runs one provisioning link at a time, so the devices are provisioned
+	 * one after the other */
+	if (!err && k_sem_take(&prov_added_sem, K_SECONDS(CONFIG_GATEWAY_PROV_QUEUE_TIMEOUT))) {
+		err = -ETIMEDOUT;
+	}
+
+	prov_done(idx, err);
+}
+
+static void prov_queue_run(void *unused1, void *unused2, void *unused3)
+{
+	ARG_UNUSED(unused1);
+	ARG_UNUSED(unused2);
+	ARG_UNUSED(unused3);
+
+	int idx;
+	k_timeout_t wait;
+
+	for (;;) {
+		idx = next_entry(&wait);
+
+		if (idx < 0) {
+			k_sem_take(&prov_queue_sem, wait);
+			continue;
+		}
+
+		provision(idx);
+	}
+}
+
+int prov_queue_add(const struct prov_queue_dev *dev)
+{
+	size_t i;
+	int free_idx;
+
+	free_idx = -1;
+	k_mutex_lock(&prov_queue_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (!entries[i].used) {
+			free_idx = free_idx < 0 ? (int)i : free_idx;
+		} else if (!util_uuid_cmp(entries[i].dev.uuid, dev->uuid)) {
+			k_mutex_unlock(&prov_queue_lock);
+			return -EALREADY;
+		}
+	}
+
+	if (free_idx < 0) {
+		k_mutex_unlock(&prov_queue_lock);
+		return -ENOMEM;
+	}
+
+	if (queue_count() == 0) {
+		batch_start = k_uptime_get();
+		stats.batch_done = 0;
+	}
+
+	entries[free_idx].used = true;
+	entries[free_idx].seq = next_seq++;
+	entries[free_idx].next_try = 0;
+	entries[free_idx].attempts = 0;
+	entries[free_idx].dev = *dev;
+	entries[free_idx].dev.elem_count = MAX(dev->elem_count, 1);
+
+	k_mutex_unlock(&prov_queue_lock);
+	k_sem_give(&prov_queue_sem);
+
+	return 0;
+}
+
+void prov_queue_flush(void)
+{
+	size_t i;
+	bool empty;
+	struct prov_queue_result res;
+
+	k_mutex_lock(&prov_queue_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (!entries[i].used || (int)i == active) {
+			continue;
+		}
+
+		memset(&res, 0, sizeof(res));
+		res.err = -ECANCELED;
+		memcpy(res.uuid, entries[i].dev.uuid, UUID_LEN);
+		strcpy(res.profile, entries[i].dev.profile);
+		entries[i].used = false;
+		stats.failed++;
+		gateway_prov_result(&res);
+	}
+
+	empty = queue_count() == 0;
+
+	if (empty) {
+		batch_end = k_uptime_get();
+	}
+
+	k_mutex_unlock(&prov_queue_lock);
+
+	if (empty) {
+		gateway_prov_queue_status();
+	}
+}
+
+bool prov_queue_node_added(uint16_t net_idx, const uint8_t uuid[UUID_LEN], uint16_t addr,
+		uint8_t num_elem)
+{
+	bool match;
+
+	k_mutex_lock(&prov_queue_lock, K_FOREVER);
+	match = active >= 0 && !util_uuid_cmp(entries[active].dev.uuid, uuid);
+
+	if (match) {
+		added.done = true;
+		added.net_idx = net_idx;
+		added.addr = addr;
+		added.num_elem = num_elem;
+		k_sem_give(&prov_added_sem);
+	}
+
+	k_mutex_unlock(&prov_queue_lock);
+
+	return match;
+}
+
+void prov_queue_stats_get(struct prov_queue_stats *_stats)
+{
+	size_t i;
+
+	k_mutex_lock(&prov_queue_lock, K_FOREVER);
+
+	*_stats = stats;
+	_stats->queued = queue_count();
+	_stats->active = active >= 0;
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].used && entries[i].attempts > 0 && (int)i != active) {
+			_stats->retrying++;
+		}
+	}
+
+	_stats->batch_time_ms = (_stats->queued ? k_uptime_get() : batch_end) - batch_start;
+
+	k_mutex_unlock(&prov_queue_lock);
+}
+
+void prov_queue_init(void)
+{
+	k_thread_create(&prov_queue_thread, prov_queue_stack,
+			K_THREAD_STACK_SIZEOF(prov_queue_stack), prov_queue_run,
+			NULL, NULL, NULL, PROV_QUEUE_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&prov_queue_thread, "prov_queue_thread");
+}
@@ -0,0 +1,78 @@
+#ifndef PROV_QUEUE_H_
+#define PROV_QUEUE_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "prov_profile.h"
+#include "util.h"
+
+struct prov_queue_dev {
+	uint8_t uuid[UUID_LEN];
+	uint16_t net_idx;
+	/* BT_MESH_ADDR_UNASSIGNED to allocate the address when the device is provisioned */
+	uint16_t addr;
+	/* Addresses reserved for the elements of the device. A device with more elements only
+	 * fits if the addresses after the range are free. */
+	uint8_t elem_count;
+	uint8_t attn;
+	/* Provisioning profile named by the request, empty to pick one by matching */
+	char profile[PROV_PROFILE_NAME_LEN + 1];
+};
+
+struct prov_queue_result {
+	int err;
+	uint8_t uuid[UUID_LEN];
+	uint16_t net_idx;
+	uint16_t addr;
+	uint8_t num_elem;
+	char profile[PROV_PROFILE_NAME_LEN + 1];
+};
+
+struct prov_queue_stats {
+	/* Devices waiting, including the one being provisioned */
+	uint32_t queued;
+	/* Devices waiting to be tried again after a failure */
+	uint32_t retrying;
+	bool active;
+	/* Since boot */
+	uint32_t done;
+	uint32_t failed;
+	uint32_t retries;
+	/* Average time of a successful attempt */
+	uint32_t avg_time_ms;
+	/* Devices provisioned since the queue was last empty, and how long that took */
+	uint32_t batch_done;
+	uint32_t batch_time_ms;
+};
+
+/* Queue a device for provisioning. The outcome is handed to gateway_prov_result() once the
+ * device is provisioned or has failed every attempt. Returns -EALREADY if the device is queued
+ * and -ENOMEM if the queue is full. */
+int prov_queue_add(const struct prov_queue_dev *dev);
+
+/* Drop the waiting devices, each is reported as cancelled. The device being provisioned is
+ * finished. */
+void prov_queue_flush(void);
+
+/* Called for every node added to the CDB, returns true if it was provisioned by the queue */
+bool prov_queue_node_added(uint16_t net_idx, const uint8_t uuid[UUID_LEN], uint16_t addr,
+		uint8_t num_elem);
+
+void prov_queue_stats_get(struct prov_queue_stats *stats);
+
+void prov_queue_init(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* PROV_QUEUE_H_ */
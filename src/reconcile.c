@@ -0,0 +1,812 @@
+#include <zephyr.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+#include <logging/log.h>
+
+#include "btmesh.h"
+#include "cfg_txn.h"
+#include "gateway.h"
+#include "reconcile.h"
+#include "util.h"
+
+#define RECONCILE_PRIORITY 7
+/* Passes in a row that send operations without the node converging, after which the node is
+ * treated as failed. Guards against a node that does not keep what it is told. */
+#define RECONCILE_PASS_MAX 4
+
+
+LOG_MODULE_REGISTER(app_reconcile, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+struct diff {
+	uint16_t addr;
+	size_t count;
+};
+
+K_THREAD_STACK_DEFINE(reconcile_stack, CONFIG_GATEWAY_RECONCILE_STACK_SIZE);
+static struct k_thread reconcile_thread;
+
+K_SEM_DEFINE(reconcile_sem, 0, 1);
+K_MUTEX_DEFINE(reconcile_lock);
+
+static struct {
+	bool used;
+	struct reconcile_state state;
+	uint32_t drift;
+	uint32_t ops;
+} states[CONFIG_GATEWAY_RECONCILE_MAX_STATES];
+
+static struct {
+	bool used;
+	uint16_t addr;
+	uint8_t state_idx;
+	enum reconcile_node_state state;
+	int err;
+	uint8_t status;
+	uint8_t failures;
+	uint8_t passes;
+	int64_t next_check;
+} nodes[CONFIG_GATEWAY_RECONCILE_MAX_NODES];
+
+/* Changed by every set and delete, so results for a replaced state are dropped */
+static uint32_t generation;
+
+/* Operations for the node being reconciled, only used by the reconcile thread. Operations past
+ * the limit land in the spare last entry and are left for the next pass. */
+static struct cfg_txn_op ops[CONFIG_GATEWAY_RECONCILE_MAX_OPS + 1];
+/* Earliest time of the next operation, shared by every node */
+static int64_t next_op;
+
+static int state_find(const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(states); i++) {
+		if (states[i].used && !strcmp(states[i].state.name, name)) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static int node_find(uint16_t addr)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(nodes); i++) {
+		if (nodes[i].used && nodes[i].addr == addr) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+/* The entry of addr, or a free one */
+static int node_alloc(uint16_t addr)
+{
+	int idx;
+	size_t i;
+
+	idx = node_find(addr);
+
+	for (i = 0; idx < 0 && i < ARRAY_SIZE(nodes); i++) {
+		if (!nodes[i].used) {
+			idx = i;
+		}
+	}
+
+	return idx;
+}
+
+static bool list_has(const uint16_t *list, size_t count, uint16_t val)
+{
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		if (list[i] == val) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static union btmesh_op_args *op_add(struct diff *diff, enum btmesh_op op)
+{
+	struct cfg_txn_op *txn_op;
+
+	txn_op = &ops[MIN(diff->count, CONFIG_GATEWAY_RECONCILE_MAX_OPS)];
+	diff->count = MIN(diff->count + 1, CONFIG_GATEWAY_RECONCILE_MAX_OPS);
+
+	memset(txn_op, 0, sizeof(*txn_op));
+	txn_op->op = op;
+	/* Every configuration operation starts with net_idx, addr */
+	txn_op->args.node_reset.net_idx = PRIMARY_SUBNET;
+	txn_op->args.node_reset.addr = diff->addr;
+
+	return &txn_op->args;
+}
+
+/* The SIG and vendor variants of an operation share their layout up to the company ID, which
+ * is only used by the vendor variant */
+static union btmesh_op_args *model_op_add(struct diff *diff, const struct reconcile_model *model,
+		const struct btmesh_elem *elem, enum btmesh_op sig_op, enum btmesh_op vnd_op)
+{
+	union btmesh_op_args *args;
+
+	args = op_add(diff, model->company_id == BT_MESH_CID_NVAL ? sig_op : vnd_op);
+	/* Every model operation has the element address after net_idx, addr */
+	args->mod_app_bind.elem_addr = elem->addr;
+
+	return args;
+}
+
+static void diff_features(struct diff *diff, const struct btmesh_node *node,
+		const struct reconcile_state *state)
+{
+	uint8_t transmit;
+	union btmesh_op_args *args;
+
+	if (state->beacon_set && node->net_beacon_state != state->beacon) {
+		args = op_add(diff, BTMESH_OP_BEACON_SET);
+		args->beacon_set.val = state->beacon ? BT_MESH_BEACON_ENABLED :
+			BT_MESH_BEACON_DISABLED;
+	}
+
+	if (state->ttl_set && node->ttl != state->ttl) {
+		args = op_add(diff, BTMESH_OP_TTL_SET);
+		args->ttl_set.val = state->ttl;
+	}
+
+	transmit = BT_MESH_TRANSMIT(node->relay.count, node->relay.interval);
+
+	if (state->relay_set && node->relay.support && (node->relay.state != state->relay ||
+			(state->relay_transmit_set && transmit != state->relay_transmit))) {
+		args = op_add(diff, BTMESH_OP_RELAY_SET);
+		args->relay_set.new_relay = state->relay ? BT_MESH_RELAY_ENABLED :
+			BT_MESH_RELAY_DISABLED;
+		args->relay_set.new_transmit = state->relay_transmit_set ?
+			state->relay_transmit : transmit;
+	}
+
+	if (state->proxy_set && node->proxy.support && node->proxy.state != state->proxy) {
+		args = op_add(diff, BTMESH_OP_PROXY_SET);
+		args->proxy_set.val = state->proxy ? BT_MESH_GATT_PROXY_ENABLED :
+			BT_MESH_GATT_PROXY_DISABLED;
+	}
+
+	if (state->friend_set && node->friend.support && node->friend.state != state->friend) {
+		args = op_add(diff, BTMESH_OP_FRIEND_SET);
+		args->friend_set.val = state->friend ? BT_MESH_FRIEND_ENABLED :
+			BT_MESH_FRIEND_DISABLED;
+	}
+}
+
+static int diff_subnets_add(struct diff *diff, const struct btmesh_node *node,
+		const struct reconcile_state *state)
+{
+	size_t i;
+	struct bt_mesh_cdb_subnet *subnet;
+	union btmesh_op_args *args;
+
+	for (i = 0; state->subnets_set && i < state->subnet_count; i++) {
+		if (list_has(node->subnet_idxs, node->subnet_count, state->subnet_idxs[i])) {
+			continue;
+		}
+
+		subnet = bt_mesh_cdb_subnet_get(state->subnet_idxs[i]);
+
+		if (subnet == NULL) {
+			return -ENOENT;
+		}
+
+		args = op_add(diff, BTMESH_OP_NET_KEY_ADD);
+		args->net_key_add.key_net_idx = state->subnet_idxs[i];
+		memcpy(args->net_key_add.net_key, subnet->keys[0].net_key,
+				sizeof(args->net_key_add.net_key));
+	}
+
+	return 0;
+}
+
+static void diff_subnets_del(struct diff *diff, const struct btmesh_node *node,
+		const struct reconcile_state *state)
+{
+	size_t i;
+	union btmesh_op_args *args;
+
+	for (i = 0; state->subnets_set && i < node->subnet_count; i++) {
+		/* The node is never cut off from the subnet it was provisioned on */
+		if (node->subnet_idxs[i] == node->net_idx ||
+		    list_has(state->subnet_idxs, state->subnet_count, node->subnet_idxs[i])) {
+			continue;
+		}
+
+		args = op_add(diff, BTMESH_OP_NET_KEY_DEL);
+		args->net_key_del.key_net_idx = node->subnet_idxs[i];
+	}
+}
+
+static bool pub_equal(const struct bt_mesh_cfg_mod_pub *a, const struct bt_mesh_cfg_mod_pub *b)
+{
+	return a->addr == b->addr && a->app_idx == b->app_idx && a->cred_flag == b->cred_flag &&
+		a->ttl == b->ttl && a->period == b->period && a->transmit == b->transmit;
+}
+
+static void diff_subs(struct diff *diff, const struct reconcile_model *model,
+		const struct btmesh_elem *elem, const uint16_t *subs, size_t sub_count)
+{
+	size_t i;
+	size_t missing;
+	size_t extra;
+	union btmesh_op_args *args;
+
+	missing = 0;
+	extra = 0;
+
+	for (i = 0; i < model->sub_addr_count; i++) {
+		missing += !list_has(subs, sub_count, model->sub_addrs[i]);
+	}
+
+	for (i = 0; i < sub_count; i++) {
+		extra += !list_has(model->sub_addrs, model->sub_addr_count, subs[i]);
+	}
+
+	/* A single overwrite replaces the whole list */
+	if (model->sub_addr_count == 1 && missing + extra > 1) {
+		args = model_op_add(diff, model, elem, BTMESH_OP_MOD_SUB_OVRW,
+				BTMESH_OP_MOD_SUB_OVRW_VND);
+		args->mod_sub_ovrw_vnd.sub_addr = model->sub_addrs[0];
+		args->mod_sub_ovrw_vnd.mod_id = model->model_id;
+		args->mod_sub_ovrw_vnd.cid = model->company_id;
+		return;
+	}
+
+	/* Deleted first, the node may not have room for more */
+	for (i = 0; i < sub_count; i++) {
+		if (list_has(model->sub_addrs, model->sub_addr_count, subs[i])) {
+			continue;
+		}
+
+		args = model_op_add(diff, model, elem, BTMESH_OP_MOD_SUB_DEL,
+				BTMESH_OP_MOD_SUB_DEL_VND);
+		args->mod_sub_del_vnd.sub_addr = subs[i];
+		args->mod_sub_del_vnd.mod_id = model->model_id;
+		args->mod_sub_del_vnd.cid = model->company_id;
+	}
+
+	for (i = 0; i < model->sub_addr_count; i++) {
+		if (list_has(subs, sub_count, model->sub_addrs[i])) {
+			continue;
+		}
+
+		args = model_op_add(diff, model, elem, BTMESH_OP_MOD_SUB_ADD,
+				BTMESH_OP_MOD_SUB_ADD_VND);
+		args->mod_sub_add_vnd.sub_addr = model->sub_addrs[i];
+		args->mod_sub_add_vnd.mod_id = model->model_id;
+		args->mod_sub_add_vnd.cid = model->company_id;
+	}
+}
+
+static int diff_model(struct diff *diff, const struct btmesh_node *node,
+		const struct reconcile_model *model)
+{
+	size_t i;
+	size_t appkey_count;
+	size_t sub_count;
+	const uint16_t *appkeys;
+	const uint16_t *subs;
+	const struct bt_mesh_cfg_mod_pub *pub;
+	const struct btmesh_elem *elem;
+	union btmesh_op_args *args;
+
+	if (model->elem_idx >= node->elem_count) {
+		return -ENOENT;
+	}
+
+	elem = &node->elems[model->elem_idx];
+	appkeys = NULL;
+	appkey_count = 0;
+	subs = NULL;
+	sub_count = 0;
+	pub = NULL;
+
+	for (i = 0; i < elem->sig_model_count && model->company_id == BT_MESH_CID_NVAL &&
+			pub == NULL; i++) {
+		if (elem->sig_models[i].model_id == model->model_id) {
+			appkeys = elem->sig_models[i].appkey_idxs;
+			appkey_count = elem->sig_models[i].appkey_count;
+			subs = elem->sig_models[i].sub_addrs;
+			sub_count = elem->sig_models[i].sub_addr_count;
+			pub = &elem->sig_models[i].pub;
+		}
+	}
+
+	for (i = 0; i < elem->vnd_model_count && model->company_id != BT_MESH_CID_NVAL &&
+			pub == NULL; i++) {
+		if (elem->vnd_models[i].model_id == model->model_id &&
+		    elem->vnd_models[i].company_id == model->company_id) {
+			appkeys = elem->vnd_models[i].appkey_idxs;
+			appkey_count = elem->vnd_models[i].appkey_count;
+			subs = elem->vnd_models[i].sub_addrs;
+			sub_count = elem->vnd_models[i].sub_addr_count;
+			pub = &elem->vnd_models[i].pub;
+		}
+	}
+
+	if (pub == NULL) {
+		return -ENOENT;
+	}
+
+	/* Bound before publication, which may use one of the keys, and unbound after it */
+	for (i = 0; model->appkeys_set && i < model->appkey_count; i++) {
+		if (list_has(appkeys, appkey_count, model->appkey_idxs[i])) {
+			continue;
+		}
+
+		args = model_op_add(diff, model, elem, BTMESH_OP_MOD_APP_BIND,
+				BTMESH_OP_MOD_APP_BIND_VND);
+		args->mod_app_bind_vnd.mod_app_idx = model->appkey_idxs[i];
+		args->mod_app_bind_vnd.mod_id = model->model_id;
+		args->mod_app_bind_vnd.cid = model->company_id;
+	}
+
+	if (model->subs_set) {
+		diff_subs(diff, model, elem, subs, sub_count);
+	}
+
+	if (model->pub_set && !pub_equal(pub, &model->pub)) {
+		args = model_op_add(diff, model, elem, BTMESH_OP_MOD_PUB_SET,
+				BTMESH_OP_MOD_PUB_SET_VND);
+		args->mod_pub_set_vnd.mod_id = model->model_id;
+		args->mod_pub_set_vnd.pub = model->pub;
+		args->mod_pub_set_vnd.cid = model->company_id;
+	}
+
+	for (i = 0; model->appkeys_set && i < appkey_count; i++) {
+		if (list_has(model->appkey_idxs, model->appkey_count, appkeys[i])) {
+			continue;
+		}
+
+		args = model_op_add(diff, model, elem, BTMESH_OP_MOD_APP_UNBIND,
+				BTMESH_OP_MOD_APP_UNBIND_VND);
+		args->mod_app_unbind_vnd.mod_app_idx = appkeys[i];
+		args->mod_app_unbind_vnd.mod_id = model->model_id;
+		args->mod_app_unbind_vnd.cid = model->company_id;
+	}
+
+	return 0;
+}
+
+/* Operations that bring node to state, in the order they are to be performed */
+static int diff_node(struct diff *diff, const struct btmesh_node *node,
+		const struct reconcile_state *state)
+{
+	int err;
+	size_t i;
+
+	diff_features(diff, node, state);
+
+	/* Subnets are added before the models may need them and removed last */
+	err = diff_subnets_add(diff, node, state);
+
+	for (i = 0; !err && i < state->model_count; i++) {
+		err = diff_model(diff, node, &state->models[i]);
+	}
+
+	if (!err) {
+		diff_subnets_del(diff, node, state);
+	}
+
+	return err;
+}
+
+/* Stops at the first operation that fails or is rejected by the node */
+static int perform_ops(size_t count, size_t *performed, uint8_t *status)
+{
+	int err;
+	size_t i;
+	int64_t delay;
+
+	for (i = 0; i < count; i++) {
+		/* Rate limit towards the mesh */
+		delay = next_op - k_uptime_get();
+
+		if (delay > 0) {
+			k_sleep(K_MSEC(delay));
+		}
+
+		next_op = k_uptime_get() + CONFIG_GATEWAY_RECONCILE_OP_INTERVAL_MS;
+		err = btmesh_perform_cfg_op(ops[i].op, &ops[i].args);
+		*status = err ? 0 : btmesh_get_op_status(ops[i].op, &ops[i].args);
+		*performed = i + 1;
+
+		if (err || *status) {
+			LOG_WRN("Reconcile %s on 0x%04x failed. Error: %d, status: %d",
+					btmesh_get_op_str(ops[i].op), ops[i].args.node_reset.addr,
+					err, *status);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static uint32_t retry_delay_ms(uint8_t failures)
+{
+	return util_backoff(CONFIG_GATEWAY_RECONCILE_RETRY_MIN, CONFIG_GATEWAY_RECONCILE_RETRY_MAX,
+			failures) * MSEC_PER_SEC;
+}
+
+/* Returns true if the node changed state */
+static bool node_done(uint16_t addr, uint32_t gen, size_t op_count, size_t performed, int err,
+		uint8_t status)
+{
+	int idx;
+	bool changed;
+	int64_t now;
+	enum reconcile_node_state prev;
+
+	now = k_uptime_get();
+	k_mutex_lock(&reconcile_lock, K_FOREVER);
+	idx = node_find(addr);
+
+	if (idx < 0 || gen != generation) {
+		k_mutex_unlock(&reconcile_lock);
+		return false;
+	}
+
+	prev = nodes[idx].state;
+	states[nodes[idx].state_idx].ops += performed;
+
+	if (prev == RECONCILE_CONVERGED && op_count) {
+		states[nodes[idx].state_idx].drift++;
+	}
+
+	if (!err && !status && !op_count) {
+		nodes[idx].state = RECONCILE_CONVERGED;
+		nodes[idx].err = 0;
+		nodes[idx].status = 0;
+		nodes[idx].failures = 0;
+		nodes[idx].passes = 0;
+		nodes[idx].next_check = now + CONFIG_GATEWAY_RECONCILE_CHECK_INTERVAL * MSEC_PER_SEC;
+	} else if (!err && !status && ++nodes[idx].passes < RECONCILE_PASS_MAX) {
+		/* Checked against the updated cache right away */
+		nodes[idx].state = RECONCILE_PENDING;
+		nodes[idx].next_check = now;
+	} else {
+		nodes[idx].state = RECONCILE_FAILED;
+		nodes[idx].err = (err || status) ? err : -EAGAIN;
+		nodes[idx].status = status;
+		nodes[idx].passes = 0;
+
+		if (nodes[idx].failures < UINT8_MAX) {
+			nodes[idx].failures++;
+		}
+
+		nodes[idx].next_check = now + retry_delay_ms(nodes[idx].failures);
+	}
+
+	changed = nodes[idx].state != prev;
+
+	if (changed && nodes[idx].state == RECONCILE_CONVERGED) {
+		LOG_INF("0x%04x converged to %s", addr,
+				log_strdup(states[nodes[idx].state_idx].state.name));
+	}
+
+	k_mutex_unlock(&reconcile_lock);
+
+	return changed;
+}
+
+static bool reconcile_node(uint16_t addr)
+{
+	int err;
+	int idx;
+	bool refresh;
+	bool found;
+	uint8_t status;
+	uint32_t gen;
+	size_t performed;
+	struct btmesh_node node;
+	struct diff diff;
+
+	status = 0;
+	performed = 0;
+	diff.addr = addr;
+	diff.count = 0;
+	node.addr = addr;
+
+	k_mutex_lock(&reconcile_lock, K_FOREVER);
+	idx = node_find(addr);
+	/* A pending node is checked against the cache its own operations just updated. Drift on
+	 * a converged node, or a failed one coming up for retry, comes from outside the gateway
+	 * and only shows when the node is asked again. */
+	refresh = idx >= 0 && nodes[idx].state != RECONCILE_PENDING;
+	k_mutex_unlock(&reconcile_lock);
+
+	err = btmesh_get_node(&node, &status, refresh);
+	found = !err && !status;
+
+	k_mutex_lock(&reconcile_lock, K_FOREVER);
+	gen = generation;
+	idx = node_find(addr);
+
+	if (found && idx >= 0) {
+		err = diff_node(&diff, &node, &states[nodes[idx].state_idx].state);
+	}
+
+	k_mutex_unlock(&reconcile_lock);
+
+	/* The operations are copied into the diff, whether or not diff_node() succeeded */
+	if (found) {
+		btmesh_free_node(&node);
+	}
+
+	if (idx < 0) {
+		return false;
+	}
+
+	if (!err && !status) {
+		err = perform_ops(diff.count, &performed, &status);
+	}
+
+	return node_done(addr, gen, diff.count, performed, err, status);
+}
+
+/* Returns false with *wait set to the time until the next node is due if none is due now */
+static bool node_due(uint16_t *addr, k_timeout_t *wait)
+{
+	int due;
+	size_t i;
+	bool ready;
+	int64_t now;
+
+	due = -ENOENT;
+	now = k_uptime_get();
+	k_mutex_lock(&reconcile_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(nodes); i++) {
+		if (nodes[i].used && (due < 0 || nodes[i].next_check < nodes[due].next_check)) {
+			due = i;
+		}
+	}
+
+	ready = due >= 0 && nodes[due].next_check <= now;
+
+	if (ready) {
+		*addr = nodes[due].addr;
+	} else if (due >= 0) {
+		*wait = K_MSEC(nodes[due].next_check - now);
+	} else {
+		*wait = K_FOREVER;
+	}
+
+	k_mutex_unlock(&reconcile_lock);
+
+	return ready;
+}
+
+static void reconcile_run(void *unused1, void *unused2, void *unused3)
+{
+	ARG_UNUSED(unused1);
+	ARG_UNUSED(unused2);
+	ARG_UNUSED(unused3);
+
+	bool changed;
+	uint16_t addr;
+	k_timeout_t wait;
+
+	wait = K_FOREVER;
+
+	for (;;) {
+		k_sem_take(&reconcile_sem, wait);
+		changed = false;
+
+		while (node_due(&addr, &wait)) {
+			changed |= reconcile_node(addr);
+		}
+
+		if (changed) {
+			gateway_reconcile_status();
+		}
+	}
+}
+
+int reconcile_state_set(struct reconcile_state *state, const uint16_t *addrs, size_t addr_count)
+{
+	int idx;
+	int slot;
+	size_t i;
+	size_t room;
+	size_t needed;
+
+	k_mutex_lock(&reconcile_lock, K_FOREVER);
+	slot = state_find(state->name);
+
+	for (i = 0; slot < 0 && i < ARRAY_SIZE(states); i++) {
+		if (!states[i].used) {
+			slot = i;
+		}
+	}
+
+	if (slot < 0) {
+		k_mutex_unlock(&reconcile_lock);
+		k_free(state->models);
+		return -ENOMEM;
+	}
+
+	/* Nodes of the state being replaced make room, nodes taken from other states reuse
+	 * their entry */
+	room = 0;
+	needed = 0;
+
+	for (i = 0; i < ARRAY_SIZE(nodes); i++) {
+		room += !nodes[i].used || (states[slot].used && nodes[i].state_idx == slot);
+	}
+
+	for (i = 0; i < addr_count; i++) {
+		idx = node_find(addrs[i]);
+		needed += idx < 0 || nodes[idx].state_idx == slot;
+	}
+
+	if (needed > room) {
+		k_mutex_unlock(&reconcile_lock);
+		k_free(state->models);
+		return -ENOMEM;
+	}
+
+	if (states[slot].used) {
+		k_free(states[slot].state.models);
+
+		for (i = 0; i < ARRAY_SIZE(nodes); i++) {
+			if (nodes[i].used && nodes[i].state_idx == slot) {
+				nodes[i].used = false;
+			}
+		}
+	}
+
+	states[slot].used = true;
+	states[slot].state = *state;
+	states[slot].drift = 0;
+	states[slot].ops = 0;
+
+	for (i = 0; i < addr_count; i++) {
+		idx = node_alloc(addrs[i]);
+		nodes[idx].used = true;
+		nodes[idx].addr = addrs[i];
+		nodes[idx].state_idx = slot;
+		nodes[idx].state = RECONCILE_PENDING;
+		nodes[idx].err = 0;
+		nodes[idx].status = 0;
+		nodes[idx].failures = 0;
+		nodes[idx].passes = 0;
+		nodes[idx].next_check = 0;
+	}
+
+	generation++;
+	k_mutex_unlock(&reconcile_lock);
+
+	LOG_INF("Desired state %s set for %d nodes", log_strdup(state->name), addr_count);
+	k_sem_give(&reconcile_sem);
+
+	return 0;
+}
+
+int reconcile_state_delete(const char *name)
+{
+	int slot;
+	size_t i;
+
+	k_mutex_lock(&reconcile_lock, K_FOREVER);
+	slot = state_find(name);
+
+	if (slot >= 0) {
+		for (i = 0; i < ARRAY_SIZE(nodes); i++) {
+			if (nodes[i].used && nodes[i].state_idx == slot) {
+				nodes[i].used = false;
+			}
+		}
+
+		k_free(states[slot].state.models);
+		states[slot].used = false;
+		generation++;
+	}
+
+	k_mutex_unlock(&reconcile_lock);
+
+	return slot < 0 ? slot : 0;
+}
+
+int reconcile_summary_get(size_t idx, struct reconcile_summary *summary)
+{
+	size_t i;
+
+	if (idx >= ARRAY_SIZE(states)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&reconcile_lock, K_FOREVER);
+
+	if (!states[idx].used) {
+		k_mutex_unlock(&reconcile_lock);
+		return -ENOENT;
+	}
+
+	memset(summary, 0, sizeof(*summary));
+	strcpy(summary->name, states[idx].state.name);
+	summary->drift = states[idx].drift;
+	summary->ops = states[idx].ops;
+
+	for (i = 0; i < ARRAY_SIZE(nodes); i++) {
+		if (!nodes[i].used || nodes[i].state_idx != idx) {
+			continue;
+		}
+
+		summary->node_count++;
+
+		switch (nodes[i].state) {
+		case RECONCILE_PENDING:
+			summary->pending++;
+			break;
+		case RECONCILE_CONVERGED:
+			summary->converged++;
+			break;
+		case RECONCILE_FAILED:
+			summary->failed++;
+			break;
+		}
+	}
+
+	k_mutex_unlock(&reconcile_lock);
+
+	return 0;
+}
+
+int reconcile_node_get(size_t idx, struct reconcile_node_status *status)
+{
+	int err;
+
+	if (idx >= ARRAY_SIZE(nodes)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&reconcile_lock, K_FOREVER);
+	err = nodes[idx].used ? 0 : -ENOENT;
+
+	if (!err) {
+		status->addr = nodes[idx].addr;
+		status->state_idx = nodes[idx].state_idx;
+		status->state = nodes[idx].state;
+		status->err = nodes[idx].err;
+		status->status = nodes[idx].status;
+		status->failures = nodes[idx].failures;
+	}
+
+	k_mutex_unlock(&reconcile_lock);
+
+	return err;
+}
+
+const char *reconcile_node_state_str(enum reconcile_node_state state)
+{
+	switch (state) {
+	case RECONCILE_PENDING:
+		return "pending";
+	case RECONCILE_CONVERGED:
+		return "converged";
+	case RECONCILE_FAILED:
+		return "failed";
+	default:
+		return "unknown";
+	}
+}
+
+void reconcile_init(void)
+{
+	k_thread_create(&reconcile_thread, reconcile_stack,
+			K_THREAD_STACK_SIZEOF(reconcile_stack), reconcile_run,
+			NULL, NULL, NULL, RECONCILE_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&reconcile_thread, "reconcile_thread");
+}
@@ -0,0 +1,112 @@
+#ifndef RECONCILE_H_
+#define RECONCILE_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "btmesh.h"
+
+#define RECONCILE_NAME_LEN 16
+
+/* Desired configuration of one model. Lists and parameters that are not set are left as the
+ * node has them. */
+struct reconcile_model {
+	uint8_t elem_idx;
+	uint16_t model_id;
+	/* BT_MESH_CID_NVAL for SIG models */
+	uint16_t company_id;
+	bool appkeys_set;
+	size_t appkey_count;
+	uint16_t appkey_idxs[CONFIG_BT_MESH_APP_KEY_COUNT];
+	bool subs_set;
+	size_t sub_addr_count;
+	uint16_t sub_addrs[CONFIG_BT_MESH_MODEL_GROUP_COUNT];
+	bool pub_set;
+	struct bt_mesh_cfg_mod_pub pub;
+};
+
+/* Desired configuration of a group of nodes. Only what is set is reconciled, and features
+ * a node does not support are skipped. */
+struct reconcile_state {
+	char name[RECONCILE_NAME_LEN + 1];
+	bool beacon_set;
+	bool beacon;
+	bool ttl_set;
+	uint8_t ttl;
+	bool relay_set;
+	bool relay;
+	/* Relay retransmit parameters, encoded with BT_MESH_TRANSMIT() */
+	bool relay_transmit_set;
+	uint8_t relay_transmit;
+	bool proxy_set;
+	bool proxy;
+	bool friend_set;
+	bool friend;
+	bool subnets_set;
+	size_t subnet_count;
+	uint16_t subnet_idxs[CONFIG_BT_MESH_SUBNET_COUNT];
+	size_t model_count;
+	/* From k_malloc() */
+	struct reconcile_model *models;
+};
+
+enum reconcile_node_state {
+	RECONCILE_PENDING,
+	RECONCILE_CONVERGED,
+	RECONCILE_FAILED,
+};
+
+struct reconcile_summary {
+	char name[RECONCILE_NAME_LEN + 1];
+	uint32_t node_count;
+	uint32_t converged;
+	uint32_t pending;
+	uint32_t failed;
+	/* Converged nodes that were found changed and configured again */
+	uint32_t drift;
+	/* Configuration operations sent to the nodes */
+	uint32_t ops;
+};
+
+struct reconcile_node_status {
+	uint16_t addr;
+	/* Index of the desired state, as for reconcile_summary_get() */
+	size_t state_idx;
+	enum reconcile_node_state state;
+	int err;
+	uint8_t status;
+	/* Failed attempts since the node last converged */
+	uint8_t failures;
+};
+
+/* Assign state to the nodes in addrs, replacing the state with the same name. Nodes taken from
+ * another state are moved over. Takes over state->models, also on error. */
+int reconcile_state_set(struct reconcile_state *state, const uint16_t *addrs, size_t addr_count);
+
+/* The nodes keep the configuration they have */
+int reconcile_state_delete(const char *name);
+
+/* Desired states are listed by slot, unused slots return -ENOENT and idx past the last slot
+ * returns -EINVAL */
+int reconcile_summary_get(size_t idx, struct reconcile_summary *summary);
+
+/* Same for the nodes with a desired state */
+int reconcile_node_get(size_t idx, struct reconcile_node_status *status);
+
+const char *reconcile_node_state_str(enum reconcile_node_state state);
+
+void reconcile_init(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* RECONCILE_H_ */
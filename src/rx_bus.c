@@ -0,0 +1,284 @@
+#include <zephyr.h>
+#include <stddef.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+
+#include "rx_bus.h"
+
+/* Each lane is a ring with a single producer, the mesh receive thread, and takes no locks.
+ * The producer fills the slot of head and then advances head, never waiting for the
+ * consumers. A consumer copies the slot of its cursor and then checks that head has not come
+ * round to that slot again while it was copying, in which case the copy may be torn and the
+ * message is counted as lost instead. The slot of head is always the one being written, so
+ * at most len - 1 messages can be waiting for a consumer.
+ *
+ * The consumer filters run as a message is published, and a message no consumer accepts never
+ * takes a slot. Each slot records which consumers accepted it, and how many messages each of
+ * them had been sent in the lane up to then, so a consumer that falls behind counts only its
+ * own lost messages as overflow. */
+#define RX_BUS_CONSUMER_MAX 4
+
+/* Must be powers of two for the cursors to wrap round the rings */
+BUILD_ASSERT((CONFIG_GATEWAY_RX_BUS_LEN & (CONFIG_GATEWAY_RX_BUS_LEN - 1)) == 0);
+BUILD_ASSERT((CONFIG_GATEWAY_RX_BUS_PRIORITY_LEN &
+		(CONFIG_GATEWAY_RX_BUS_PRIORITY_LEN - 1)) == 0);
+
+struct slot {
+	/* Consumers that accepted the message, one bit per consumer id */
+	uint8_t match;
+	/* Messages accepted by each consumer in the lane, up to and including this one */
+	uint32_t seq[RX_BUS_CONSUMER_MAX];
+	struct rx_bus_msg msg;
+};
+
+struct lane {
+	struct slot *ring;
+	uint32_t len;
+	atomic_t head;
+};
+
+BUILD_ASSERT(RX_BUS_CONSUMER_MAX <= 8);
+
+static struct slot normal_ring[CONFIG_GATEWAY_RX_BUS_LEN];
+static struct slot priority_ring[CONFIG_GATEWAY_RX_BUS_PRIORITY_LEN];
+
+static struct lane lanes[RX_BUS_LANE_COUNT] = {
+	[RX_BUS_LANE_NORMAL] = {
+		.ring = normal_ring,
+		.len = ARRAY_SIZE(normal_ring),
+	},
+	[RX_BUS_LANE_PRIORITY] = {
+		.ring = priority_ring,
+		.len = ARRAY_SIZE(priority_ring),
+	},
+};
+
+static atomic_t dropped;
+static atomic_t unmatched;
+static struct rx_bus_consumer *consumers[RX_BUS_CONSUMER_MAX];
+/* Consumers are published to the producer by incrementing the count after the slot is set */
+static atomic_t consumer_count;
+
+int rx_bus_subscribe(struct rx_bus_consumer *consumer)
+{
+	size_t i;
+	atomic_val_t idx;
+
+	idx = atomic_get(&consumer_count);
+
+	if (idx == RX_BUS_CONSUMER_MAX) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < RX_BUS_LANE_COUNT; i++) {
+		consumer->cursor[i] = atomic_get(&lanes[i].head);
+		consumer->seen[i] = 0;
+		atomic_clear(&consumer->published[i]);
+	}
+
+	consumer->id = idx;
+	atomic_clear(&consumer->read_count);
+	atomic_clear(&consumer->overflow);
+	consumers[idx] = consumer;
+	atomic_inc(&consumer_count);
+
+	return 0;
+}
+
+int rx_bus_publish(uint32_t opcode, const struct bt_mesh_msg_ctx *ctx,
+		const struct net_buf_simple *buf, rx_bus_route_t route)
+{
+	size_t i;
+	size_t count;
+	uint8_t match;
+	uint8_t flags;
+	uint32_t pos;
+	enum rx_bus_lane lane;
+	struct slot *slot;
+	struct rx_bus_msg *msg;
+
+	if (buf->len > sizeof(msg->payload)) {
+		atomic_inc(&dropped);
+		return -EMSGSIZE;
+	}
+
+	/* The slot of head is not visible to the consumers until head moves on, so the header
+	 * can be filled in for the filters before it is known whether the slot is taken. It goes
+	 * to the normal lane until the route says otherwise. */
+	lane = RX_BUS_LANE_NORMAL;
+	pos = atomic_get(&lanes[lane].head);
+	slot = &lanes[lane].ring[pos & (lanes[lane].len - 1)];
+	msg = &slot->msg;
+
+	msg->opcode = opcode;
+	msg->net_idx = ctx->net_idx;
+	msg->app_idx = ctx->app_idx;
+	msg->addr = ctx->addr;
+	msg->recv_dst = ctx->recv_dst;
+	msg->flags = 0;
+	msg->recv_time = k_uptime_get();
+	msg->len = buf->len;
+
+	count = atomic_get(&consumer_count);
+	match = 0;
+
+	for (i = 0; i < count; i++) {
+		if (consumers[i]->filter == NULL ||
+		    consumers[i]->filter(msg, consumers[i]->user_data)) {
+			match |= BIT(i);
+		}
+	}
+
+	if (!match) {
+		atomic_inc(&unmatched);
+		return 0;
+	}
+
+	flags = 0;
+
+	if (route != NULL && !route(opcode, ctx, buf, &lane, &flags)) {
+		return 0;
+	}
+
+	if (lane != RX_BUS_LANE_NORMAL) {
+		pos = atomic_get(&lanes[lane].head);
+		slot = &lanes[lane].ring[pos & (lanes[lane].len - 1)];
+		memcpy(&slot->msg, msg, offsetof(struct rx_bus_msg, payload));
+		msg = &slot->msg;
+	}
+
+	msg->flags = flags;
+	memcpy(msg->payload, buf->data, buf->len);
+	slot->match = match;
+
+	for (i = 0; i < count; i++) {
+		if (match & BIT(i)) {
+			atomic_inc(&consumers[i]->published[lane]);
+		}
+
+		slot->seq[i] = atomic_get(&consumers[i]->published[lane]);
+	}
+
+	atomic_set(&lanes[lane].head, pos + 1);
+
+	for (i = 0; i < count; i++) {
+		if ((match & BIT(i)) && consumers[i]->notify) {
+			consumers[i]->notify(consumers[i]);
+		}
+	}
+
+	return 0;
+}
+
+static int lane_read(enum rx_bus_lane idx, struct rx_bus_consumer *consumer,
+		struct rx_bus_msg *msg)
+{
+	bool match;
+	uint32_t pos;
+	uint32_t seq;
+	uint32_t lost;
+	struct lane *lane;
+	uint32_t *cursor;
+	const struct slot *slot;
+
+	lane = &lanes[idx];
+	cursor = &consumer->cursor[idx];
+
+	for (;;) {
+		pos = atomic_get(&lane->head);
+
+		if (*cursor == pos) {
+			return -EAGAIN;
+		}
+
+		/* Skipped slots are counted as lost through seq below, if they were for us */
+		if (pos - *cursor > lane->len - 1) {
+			*cursor = pos - (lane->len - 1);
+		}
+
+		slot = &lane->ring[*cursor & (lane->len - 1)];
+		match = slot->match & BIT(consumer->id);
+		seq = slot->seq[consumer->id];
+
+		if (match) {
+			memcpy(msg, &slot->msg, offsetof(struct rx_bus_msg, payload));
+			/* The length may be torn as well, the check below throws such a copy
+			 * away */
+			msg->len = MIN(msg->len, sizeof(msg->payload));
+			memcpy(msg->payload, slot->msg.payload, msg->len);
+		}
+
+		if ((uint32_t)atomic_get(&lane->head) - *cursor > lane->len - 1) {
+			continue;
+		}
+
+		(*cursor)++;
+		lost = seq - consumer->seen[idx] - (match ? 1 : 0);
+
+		if (lost) {
+			atomic_add(&consumer->overflow, lost);
+		}
+
+		consumer->seen[idx] = seq;
+
+		if (match) {
+			atomic_inc(&consumer->read_count);
+			return 0;
+		}
+	}
+}
+
+int rx_bus_read(struct rx_bus_consumer *consumer, struct rx_bus_msg *msg)
+{
+	int err;
+
+	err = lane_read(RX_BUS_LANE_PRIORITY, consumer, msg);
+
+	if (err != -EAGAIN) {
+		return err;
+	}
+
+	return lane_read(RX_BUS_LANE_NORMAL, consumer, msg);
+}
+
+uint32_t rx_bus_pending(const struct rx_bus_consumer *consumer)
+{
+	size_t i;
+	uint32_t pending;
+
+	pending = 0;
+
+	for (i = 0; i < RX_BUS_LANE_COUNT; i++) {
+		/* Messages lost to overflow but not counted yet are left out, at most len - 1
+		 * messages can still be read */
+		pending += MIN((uint32_t)atomic_get(&consumer->published[i]) - consumer->seen[i],
+				MIN((uint32_t)atomic_get(&lanes[i].head) - consumer->cursor[i],
+					lanes[i].len - 1));
+	}
+
+	return pending;
+}
+
+int rx_bus_stats_get(size_t idx, struct rx_bus_stats *stats)
+{
+	if (idx >= (size_t)atomic_get(&consumer_count)) {
+		return -ENOENT;
+	}
+
+	stats->name = consumers[idx]->name;
+	stats->read_count = atomic_get(&consumers[idx]->read_count);
+	stats->overflow = atomic_get(&consumers[idx]->overflow);
+	stats->pending = rx_bus_pending(consumers[idx]);
+
+	return 0;
+}
+
+uint32_t rx_bus_dropped(void)
+{
+	return atomic_get(&dropped);
+}
+
+uint32_t rx_bus_unmatched(void)
+{
+	return atomic_get(&unmatched);
+}
@@ -0,0 +1,108 @@
+#ifndef RX_BUS_H_
+#define RX_BUS_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+#include <bluetooth/mesh.h>
+
+/* Messages in the priority lane are read before any in the normal lane, and a flood of
+ * normal messages cannot push them out */
+enum rx_bus_lane {
+	RX_BUS_LANE_NORMAL,
+	RX_BUS_LANE_PRIORITY,
+	RX_BUS_LANE_COUNT
+};
+
+/* A received model message as kept in the ring */
+struct rx_bus_msg {
+	uint32_t opcode;
+	uint16_t net_idx;
+	uint16_t app_idx;
+	uint16_t addr;
+	uint16_t recv_dst;
+	/* Uplink rule flags, passed through to the consumers */
+	uint8_t flags;
+	int64_t recv_time;
+	uint16_t len;
+	uint8_t payload[CONFIG_GATEWAY_RX_BUS_PAYLOAD_MAX];
+};
+
+struct rx_bus_consumer;
+
+/* Called from the mesh receive thread as a message is published, with every field but the
+ * payload set. Messages the filter returns false for are never seen by the consumer, and
+ * messages no consumer accepts are not kept at all. Must not block. */
+typedef bool (*rx_bus_filter_t)(const struct rx_bus_msg *msg, void *user_data);
+
+/* Called from rx_bus_publish() once at least one consumer has accepted the message, and
+ * before its payload is copied. Returns false to drop the message, otherwise it may move the
+ * message to another lane and set the flags the consumers see. Must not block. */
+typedef bool (*rx_bus_route_t)(uint32_t opcode, const struct bt_mesh_msg_ctx *ctx,
+		const struct net_buf_simple *buf, enum rx_bus_lane *lane, uint8_t *flags);
+
+/* Called from the mesh receive thread after every message. Must not block, typically it
+ * submits a work item or wakes a thread that calls rx_bus_read(). */
+typedef void (*rx_bus_notify_t)(struct rx_bus_consumer *consumer);
+
+/* Every consumer reads each lane at its own pace. A consumer that falls more than the
+ * length of a lane behind loses the oldest messages, which are counted in its overflow. */
+struct rx_bus_consumer {
+	const char *name;
+	rx_bus_filter_t filter;
+	rx_bus_notify_t notify;
+	void *user_data;
+	/* Set by rx_bus_subscribe() */
+	uint8_t id;
+	/* Owned by the consumer thread */
+	uint32_t cursor[RX_BUS_LANE_COUNT];
+	/* Messages accepted by the consumer that it has read or lost, per lane */
+	uint32_t seen[RX_BUS_LANE_COUNT];
+	/* Owned by the mesh receive thread. Messages accepted by the consumer, per lane. */
+	atomic_t published[RX_BUS_LANE_COUNT];
+	atomic_t read_count;
+	atomic_t overflow;
+};
+
+struct rx_bus_stats {
+	const char *name;
+	uint32_t read_count;
+	uint32_t overflow;
+	uint32_t pending;
+};
+
+/* Start reading at the next message. Consumers subscribe while the application starts up
+ * and are never removed. */
+int rx_bus_subscribe(struct rx_bus_consumer *consumer);
+
+/* Copy a message into a lane and notify the consumers that accept it. Only called from the
+ * mesh receive thread. Messages longer than CONFIG_GATEWAY_RX_BUS_PAYLOAD_MAX are dropped.
+ * Without a route, messages go to the normal lane with no flags. */
+int rx_bus_publish(uint32_t opcode, const struct bt_mesh_msg_ctx *ctx,
+		const struct net_buf_simple *buf, rx_bus_route_t route);
+
+/* Next message for the consumer, or -EAGAIN once the consumer has caught up. Only one thread
+ * may read for a consumer. */
+int rx_bus_read(struct rx_bus_consumer *consumer, struct rx_bus_msg *msg);
+
+/* Messages accepted by the consumer but not yet read */
+uint32_t rx_bus_pending(const struct rx_bus_consumer *consumer);
+
+int rx_bus_stats_get(size_t idx, struct rx_bus_stats *stats);
+
+/* Messages dropped for being too long */
+uint32_t rx_bus_dropped(void);
+
+/* Messages no consumer accepted */
+uint32_t rx_bus_unmatched(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* RX_BUS_H_ */
@@ -0,0 +1,415 @@
+#include <zephyr.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+#include <logging/log.h>
+#include <settings/settings.h>
+
+#include "sub_set.h"
+
+/* The ranges of a set are stored in pages of SUB_PAGE_LEN ranges, each page one settings
+ * value "gwsub/<type>/<page>":
+ *
+ *   format version, first and last address (little endian) of every range
+ */
+#define SUB_VERSION 1
+#define SUB_SETTINGS_ROOT "gwsub"
+#define SUB_KEY_LEN sizeof(SUB_SETTINGS_ROOT "/255/65535")
+#define SUB_PAGE_LEN 32
+#define SUB_VALUE_MAX (1 + SUB_PAGE_LEN * 4)
+#define SUB_MIN_CAP 8
+
+#define GROUP_COUNT (SUB_SET_GROUP_LAST - SUB_SET_GROUP_FIRST + 1)
+
+
+LOG_MODULE_REGISTER(app_sub_set, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+/* Ranges are kept sorted and merged, and grow on the heap. Group addresses, the usual
+ * destination of relayed messages, are also kept in a bitmap so that the test made for every
+ * received message does not depend on the number of ranges. */
+struct sub_set {
+	struct sub_range *ranges;
+	size_t count;
+	size_t cap;
+	uint8_t groups[GROUP_COUNT / 8];
+	/* Pages the set was last stored in */
+	size_t stored_pages;
+};
+
+K_MUTEX_DEFINE(sub_lock);
+/* One store() at a time, so the trailing pages one store deletes are not pages another one
+ * has just written */
+K_MUTEX_DEFINE(store_lock);
+
+static struct sub_set sets[BTMESH_SUB_TYPE_COUNT];
+
+static void sub_key(enum btmesh_sub_type type, size_t page, char key[SUB_KEY_LEN])
+{
+	snprintk(key, SUB_KEY_LEN, SUB_SETTINGS_ROOT "/%u/%u", (unsigned int)type,
+			(unsigned int)page);
+}
+
+/* First range that ends at or after addr */
+static size_t lower(const struct sub_set *set, uint16_t addr)
+{
+	size_t lo;
+	size_t hi;
+	size_t mid;
+
+	lo = 0;
+	hi = set->count;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+
+		if (set->ranges[mid].last < addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static int reserve(struct sub_set *set, size_t count)
+{
+	size_t cap;
+	struct sub_range *ranges;
+
+	if (count <= set->cap) {
+		return 0;
+	}
+
+	cap = MAX(MAX(count, set->cap * 2), SUB_MIN_CAP);
+	ranges = k_malloc(cap * sizeof(*ranges));
+
+	if (ranges == NULL) {
+		return -ENOMEM;
+	}
+
+	memcpy(ranges, set->ranges, set->count * sizeof(*ranges));
+	k_free(set->ranges);
+	set->ranges = ranges;
+	set->cap = cap;
+
+	return 0;
+}
+
+static void groups_set(struct sub_set *set, uint16_t first, uint16_t last, bool member)
+{
+	uint32_t addr;
+	uint32_t bit;
+
+	for (addr = MAX(first, SUB_SET_GROUP_FIRST); addr <= last; addr++) {
+		bit = addr - SUB_SET_GROUP_FIRST;
+
+		if (member) {
+			set->groups[bit / 8] |= BIT(bit % 8);
+		} else {
+			set->groups[bit / 8] &= ~BIT(bit % 8);
+		}
+	}
+}
+
+static int range_add(struct sub_set *set, uint16_t first, uint16_t last)
+{
+	int err;
+	size_t i;
+	size_t j;
+
+	/* Ranges from i up to j overlap or touch the new one and are merged into it */
+	i = lower(set, first > 0 ? first - 1 : 0);
+
+	for (j = i; j < set->count && set->ranges[j].first <= last + 1; j++) {
+		first = MIN(first, set->ranges[j].first);
+		last = MAX(last, set->ranges[j].last);
+	}
+
+	if (i == j) {
+		err = reserve(set, set->count + 1);
+
+		if (err) {
+			return err;
+		}
+
+		memmove(&set->ranges[i + 1], &set->ranges[i],
+				(set->count - i) * sizeof(set->ranges[0]));
+		set->count++;
+	} else {
+		memmove(&set->ranges[i + 1], &set->ranges[j],
+				(set->count - j) * sizeof(set->ranges[0]));
+		set->count -= j - i - 1;
+	}
+
+	set->ranges[i].first = first;
+	set->ranges[i].last = last;
+	groups_set(set, first, last, true);
+
+	return 0;
+}
+
+static int range_remove(struct sub_set *set, uint16_t first, uint16_t last)
+{
+	int err;
+	size_t i;
+	size_t j;
+
+	i = lower(set, first);
+
+	if (i == set->count || set->ranges[i].first > last) {
+		return 0;
+	}
+
+	if (set->ranges[i].first < first && set->ranges[i].last > last) {
+		err = reserve(set, set->count + 1);
+
+		if (err) {
+			return err;
+		}
+
+		memmove(&set->ranges[i + 1], &set->ranges[i],
+				(set->count - i) * sizeof(set->ranges[0]));
+		set->count++;
+		set->ranges[i].last = first - 1;
+		set->ranges[i + 1].first = last + 1;
+		groups_set(set, first, last, false);
+
+		return 0;
+	}
+
+	if (set->ranges[i].first < first) {
+		set->ranges[i].last = first - 1;
+		i++;
+	}
+
+	for (j = i; j < set->count && set->ranges[j].last <= last; j++) {
+	}
+
+	if (j < set->count && set->ranges[j].first <= last) {
+		set->ranges[j].first = last + 1;
+	}
+
+	memmove(&set->ranges[i], &set->ranges[j], (set->count - j) * sizeof(set->ranges[0]));
+	set->count -= j - i;
+	groups_set(set, first, last, false);
+
+	return 0;
+}
+
+/* Writes every page of the set and deletes the pages it has shrunk out of. sub_lock is only
+ * held to copy a page, it is taken for every received message. */
+static int store(enum btmesh_sub_type type)
+{
+	int err;
+	size_t i;
+	size_t page;
+	size_t pages;
+	size_t stored_pages;
+	struct sub_set *set;
+	char key[SUB_KEY_LEN];
+
+	NET_BUF_SIMPLE_DEFINE(buf, SUB_VALUE_MAX);
+
+	set = &sets[type];
+	err = 0;
+	pages = 0;
+	stored_pages = 0;
+	k_mutex_lock(&store_lock, K_FOREVER);
+
+	for (page = 0; !err; page++) {
+		k_mutex_lock(&sub_lock, K_FOREVER);
+		pages = DIV_ROUND_UP(set->count, SUB_PAGE_LEN);
+
+		if (page >= pages) {
+			stored_pages = set->stored_pages;
+			set->stored_pages = pages;
+			k_mutex_unlock(&sub_lock);
+			break;
+		}
+
+		net_buf_simple_reset(&buf);
+		net_buf_simple_add_u8(&buf, SUB_VERSION);
+
+		for (i = page * SUB_PAGE_LEN; i < MIN(set->count, (page + 1) * SUB_PAGE_LEN); i++) {
+			net_buf_simple_add_le16(&buf, set->ranges[i].first);
+			net_buf_simple_add_le16(&buf, set->ranges[i].last);
+		}
+
+		k_mutex_unlock(&sub_lock);
+
+		sub_key(type, page, key);
+		err = settings_save_one(key, buf.data, buf.len);
+	}
+
+	if (!err) {
+		for (page = pages; page < stored_pages; page++) {
+			sub_key(type, page, key);
+			settings_delete(key);
+		}
+	}
+
+	k_mutex_unlock(&store_lock);
+
+	return err;
+}
+
+int sub_set_update(enum btmesh_sub_type type, const struct sub_range *ranges, size_t count,
+		bool subscribe)
+{
+	int err;
+	int ret;
+	size_t i;
+
+	if (type >= BTMESH_SUB_TYPE_COUNT) {
+		return -EINVAL;
+	}
+
+	/* Checked up front, so a bad range does not leave the list half applied */
+	for (i = 0; i < count; i++) {
+		if (ranges[i].first > ranges[i].last ||
+		    ranges[i].first == BT_MESH_ADDR_UNASSIGNED) {
+			return -EINVAL;
+		}
+	}
+
+	k_mutex_lock(&sub_lock, K_FOREVER);
+
+	/* Every range adds at most one range to the set, with room for all of them neither
+	 * range_add nor range_remove can fail */
+	err = reserve(&sets[type], sets[type].count + count);
+
+	if (err) {
+		k_mutex_unlock(&sub_lock);
+		return err;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (subscribe) {
+			range_add(&sets[type], ranges[i].first, ranges[i].last);
+		} else {
+			range_remove(&sets[type], ranges[i].first, ranges[i].last);
+		}
+	}
+
+	k_mutex_unlock(&sub_lock);
+	ret = store(type);
+
+	if (ret) {
+		LOG_ERR("Failed to store subscriptions: %d", ret);
+	}
+
+	return ret;
+}
+
+bool sub_set_contains(enum btmesh_sub_type type, uint16_t addr)
+{
+	bool ret;
+	size_t i;
+	uint32_t bit;
+	struct sub_set *set;
+
+	set = &sets[type];
+	k_mutex_lock(&sub_lock, K_FOREVER);
+
+	if (addr >= SUB_SET_GROUP_FIRST) {
+		bit = addr - SUB_SET_GROUP_FIRST;
+		ret = set->groups[bit / 8] & BIT(bit % 8);
+	} else {
+		i = lower(set, addr);
+		ret = i < set->count && set->ranges[i].first <= addr;
+	}
+
+	k_mutex_unlock(&sub_lock);
+
+	return ret;
+}
+
+int sub_set_get(enum btmesh_sub_type type, size_t idx, struct sub_range *range)
+{
+	int err;
+
+	k_mutex_lock(&sub_lock, K_FOREVER);
+	err = idx < sets[type].count ? 0 : -ENOENT;
+
+	if (!err) {
+		*range = sets[type].ranges[idx];
+	}
+
+	k_mutex_unlock(&sub_lock);
+
+	return err;
+}
+
+size_t sub_set_count(enum btmesh_sub_type type)
+{
+	size_t ret;
+
+	k_mutex_lock(&sub_lock, K_FOREVER);
+	ret = sets[type].count;
+	k_mutex_unlock(&sub_lock);
+
+	return ret;
+}
+
+static int sub_settings_set(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+	int err;
+	char *end;
+	unsigned long type;
+	unsigned long page;
+	ssize_t read_len;
+	uint16_t first;
+	uint16_t last;
+
+	NET_BUF_SIMPLE_DEFINE(buf, SUB_VALUE_MAX);
+
+	type = strtoul(key, &end, 10);
+
+	if (*end != '/' || type >= BTMESH_SUB_TYPE_COUNT) {
+		return -ENOENT;
+	}
+
+	page = strtoul(end + 1, &end, 10);
+
+	if (*end != '\0') {
+		return -ENOENT;
+	}
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if (len > SUB_VALUE_MAX) {
+		return -EINVAL;
+	}
+
+	read_len = read_cb(cb_arg, net_buf_simple_add(&buf, len), len);
+
+	if (read_len < 0) {
+		return read_len;
+	}
+
+	if (read_len != len || (len - 1) % 4 || net_buf_simple_pull_u8(&buf) != SUB_VERSION) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&sub_lock, K_FOREVER);
+
+	/* Pages are loaded in any order, the ranges are sorted again as they are added */
+	sets[type].stored_pages = MAX(sets[type].stored_pages, page + 1);
+	err = 0;
+
+	while (buf.len && !err) {
+		first = net_buf_simple_pull_le16(&buf);
+		last = net_buf_simple_pull_le16(&buf);
+		err = first <= last ? range_add(&sets[type], first, last) : -EINVAL;
+	}
+
+	k_mutex_unlock(&sub_lock);
+
+	return err;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(sub_set, SUB_SETTINGS_ROOT, NULL, sub_settings_set, NULL,
+		NULL);
@@ -0,0 +1,46 @@
+#ifndef SUB_SET_H_
+#define SUB_SET_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "btmesh.h"
+
+/* Every group address, including the fixed group addresses */
+#define SUB_SET_GROUP_FIRST 0xC000
+#define SUB_SET_GROUP_LAST 0xFFFF
+
+struct sub_range {
+	uint16_t first;
+	/* Equal to first for a single address */
+	uint16_t last;
+};
+
+/* Subscribe to, or unsubscribe from, a list of address ranges and store the result once.
+ * Ranges that overlap or touch are merged, unsubscribing from part of a range splits it.
+ * Nothing is changed if any range is invalid or there is no memory for the result. */
+int sub_set_update(enum btmesh_sub_type type, const struct sub_range *ranges, size_t count,
+		bool subscribe);
+
+/* Called for every received message. Constant time for group addresses, a binary search over
+ * the subscribed ranges for unicast and virtual addresses. */
+bool sub_set_contains(enum btmesh_sub_type type, uint16_t addr);
+
+/* Subscribed ranges in order. Returns -ENOENT past the last one. */
+int sub_set_get(enum btmesh_sub_type type, size_t idx, struct sub_range *range);
+
+size_t sub_set_count(enum btmesh_sub_type type);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* SUB_SET_H_ */
@@ -0,0 +1,239 @@
+#include <zephyr.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+#include <logging/log.h>
+
+#include "btmesh.h"
+#include "gateway.h"
+#include "node_pool.h"
+#include "sweep.h"
+
+/* How often a paused sweep checks whether the gateway has caught up */
+#define SWEEP_PAUSE_POLL_MS 1000
+#define SWEEP_WORKER_PRIORITY 7
+
+
+LOG_MODULE_REGISTER(app_sweep, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+K_MUTEX_DEFINE(sweep_lock);
+
+static struct sweep_params params;
+static struct sweep_status sweep;
+static bool stop;
+/* Address of the last node handed to a worker, nodes are walked in address order */
+static uint16_t cursor;
+static int64_t next_start;
+
+static uint8_t count_node(struct bt_mesh_cdb_node *node, void *count)
+{
+	(*(uint32_t *)count)++;
+	return BT_MESH_CDB_ITER_CONTINUE;
+}
+
+static bool throttled(void)
+{
+	size_t queue_depth;
+	uint32_t latency_ms;
+
+	gateway_load_get(&queue_depth, &latency_ms);
+
+	return (params.max_queue && queue_depth > params.max_queue) ||
+		(params.max_latency_ms && latency_ms > params.max_latency_ms);
+}
+
+/* Block until the next node may be started. Returns false once the sweep is over. */
+static bool next_node(uint16_t *addr)
+{
+	bool notify;
+	int64_t delay;
+	uint16_t next;
+
+	for (;;) {
+		notify = false;
+		k_mutex_lock(&sweep_lock, K_FOREVER);
+
+		if (stop) {
+			k_mutex_unlock(&sweep_lock);
+			return false;
+		}
+
+		if (throttled()) {
+			if (sweep.state != SWEEP_PAUSED) {
+				LOG_INF("Sweep paused, gateway is busy");
+				sweep.state = SWEEP_PAUSED;
+				notify = true;
+			}
+
+			k_mutex_unlock(&sweep_lock);
+
+			if (notify) {
+				gateway_sweep_progress();
+			}
+
+			k_sleep(K_MSEC(SWEEP_PAUSE_POLL_MS));
+			continue;
+		}
+
+		if (sweep.state == SWEEP_PAUSED) {
+			LOG_INF("Sweep resumed");
+			sweep.state = SWEEP_RUNNING;
+			notify = true;
+		}
+
+		delay = next_start - k_uptime_get();
+
+		if (delay > 0) {
+			k_mutex_unlock(&sweep_lock);
+
+			if (notify) {
+				gateway_sweep_progress();
+			}
+
+			k_sleep(K_MSEC(delay));
+			continue;
+		}
+
+		next = node_pool_cdb_next(cursor, NULL, NULL);
+
+		if (next != BT_MESH_ADDR_UNASSIGNED) {
+			cursor = next;
+			next_start = k_uptime_get() + params.interval_ms;
+			sweep.active++;
+		}
+
+		k_mutex_unlock(&sweep_lock);
+
+		if (notify) {
+			gateway_sweep_progress();
+		}
+
+		*addr = next;
+		return next != BT_MESH_ADDR_UNASSIGNED;
+	}
+}
+
+static void node_done(uint16_t addr, int err, uint8_t status)
+{
+	k_mutex_lock(&sweep_lock, K_FOREVER);
+	sweep.active--;
+	sweep.done++;
+
+	if (err || status) {
+		sweep.failed++;
+	}
+
+	k_mutex_unlock(&sweep_lock);
+
+	if (err) {
+		LOG_WRN("Sweep failed to discover 0x%04x. Error: %d", addr, err);
+	}
+}
+
+static void sweep_node(uint16_t addr)
+{
+	int err;
+	uint8_t status;
+	struct btmesh_node node;
+
+	node.addr = addr;
+	status = 0;
+	err = btmesh_get_node(&node, &status, params.refresh);
+	node_done(node.addr, err, status);
+	/* Takes over the node on success */
+	gateway_sweep_node(&node, err, status);
+}
+
+/* Called by the last worker with sweep_lock held */
+static void sweep_done(void)
+{
+	sweep.state = stop ? SWEEP_STOPPED : SWEEP_DONE;
+	LOG_INF("Sweep %s: %d of %d nodes, %d failed", sweep_state_str(sweep.state),
+			sweep.done, sweep.total, sweep.failed);
+	gateway_sweep_progress();
+}
+
+NODE_POOL_DEFINE(sweep_workers, CONFIG_GATEWAY_SWEEP_WORKERS, CONFIG_GATEWAY_SWEEP_STACK_SIZE,
+		SWEEP_WORKER_PRIORITY, sweep_lock, next_node, sweep_node, sweep_done);
+
+void sweep_params_default(struct sweep_params *params)
+{
+	params->concurrency = CONFIG_GATEWAY_SWEEP_WORKERS;
+	params->interval_ms = CONFIG_GATEWAY_SWEEP_INTERVAL_MS;
+	params->max_latency_ms = CONFIG_GATEWAY_SWEEP_MAX_LATENCY_MS;
+	params->max_queue = CONFIG_GATEWAY_SWEEP_MAX_QUEUE;
+	params->refresh = true;
+}
+
+int sweep_start(const struct sweep_params *_params)
+{
+	int count;
+	uint32_t total;
+
+	k_mutex_lock(&sweep_lock, K_FOREVER);
+
+	if (node_pool_busy(&sweep_workers)) {
+		k_mutex_unlock(&sweep_lock);
+		return -EBUSY;
+	}
+
+	params = *_params;
+	count = node_pool_start(&sweep_workers, params.concurrency);
+	params.concurrency = count;
+
+	memset(&sweep, 0, sizeof(sweep));
+	bt_mesh_cdb_node_foreach(count_node, &sweep.total);
+	sweep.state = SWEEP_RUNNING;
+	stop = false;
+	cursor = BT_MESH_ADDR_UNASSIGNED;
+	next_start = 0;
+	total = sweep.total;
+
+	k_mutex_unlock(&sweep_lock);
+
+	LOG_INF("Sweep of %d nodes started, %d at a time", total, count);
+	gateway_sweep_progress();
+	node_pool_run(&sweep_workers, count);
+
+	return 0;
+}
+
+void sweep_stop(void)
+{
+	k_mutex_lock(&sweep_lock, K_FOREVER);
+
+	if (node_pool_busy(&sweep_workers)) {
+		stop = true;
+	}
+
+	k_mutex_unlock(&sweep_lock);
+}
+
+void sweep_status_get(struct sweep_status *status)
+{
+	k_mutex_lock(&sweep_lock, K_FOREVER);
+	*status = sweep;
+	k_mutex_unlock(&sweep_lock);
+}
+
+const char *sweep_state_str(enum sweep_state state)
+{
+	switch (state) {
+	case SWEEP_IDLE:
+		return "idle";
+	case SWEEP_RUNNING:
+		return "running";
+	case SWEEP_PAUSED:
+		return "paused";
+	case SWEEP_DONE:
+		return "done";
+	case SWEEP_STOPPED:
+		return "stopped";
+	default:
+		return "unknown";
+	}
+}
+
+void sweep_init(void)
+{
+	node_pool_init(&sweep_workers);
+}
@@ -0,0 +1,63 @@
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum sweep_state {
+	SWEEP_IDLE,
+	SWEEP_RUNNING,
+	SWEEP_PAUSED,
+	SWEEP_DONE,
+	SWEEP_STOPPED,
+};
+
+struct sweep_params {
+	/* Nodes discovered at the same time */
+	uint8_t concurrency;
+	/* Minimum time between the start of two node discoveries */
+	uint32_t interval_ms;
+	/* The sweep pauses while either limit is exceeded, 0 disables the limit */
+	uint32_t max_latency_ms;
+	uint32_t max_queue;
+	/* Discover nodes even if their configuration is cached */
+	bool refresh;
+};
+
+struct sweep_status {
+	enum sweep_state state;
+	uint32_t total;
+	uint32_t done;
+	uint32_t failed;
+	uint32_t active;
+};
+
+void sweep_params_default(struct sweep_params *params);
+
+/* Walk all nodes in the CDB in address order. Every node is handed to
+ * gateway_sweep_node() once its discovery finishes, and gateway_sweep_progress() is called
+ * whenever the sweep changes state. Returns -EBUSY while a previous sweep is still running. */
+int sweep_start(const struct sweep_params *params);
+
+/* Nodes that are being discovered are finished, no new ones are started */
+void sweep_stop(void);
+
+void sweep_status_get(struct sweep_status *status);
+
+const char *sweep_state_str(enum sweep_state state);
+
+void sweep_init(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* SWEEP_H_ */
@@ -0,0 +1,421 @@
+#include <zephyr.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+#include <logging/log.h>
+#include <settings/settings.h>
+
+#include "uplink_rules.h"
+
+/* The table is stored in pages of RULES_PAGE_LEN rules, each page one settings value
+ * "urules/<page>":
+ *
+ *   format version, then for every rule: match, action, flags, sample rate, opcode, source
+ *   range, destination range, app index, prefix length and prefix (little endian)
+ */
+#define RULES_VERSION 2
+#define RULES_SETTINGS_ROOT "urules"
+#define RULES_KEY_LEN sizeof(RULES_SETTINGS_ROOT "/255")
+#define RULES_PAGE_LEN 8
+#define RULES_PAGE_COUNT DIV_ROUND_UP(CONFIG_GATEWAY_UPLINK_RULES_MAX, RULES_PAGE_LEN)
+#define RULE_STORED_LEN (3 + 2 + 4 + 10 + 1 + UPLINK_RULE_PREFIX_MAX)
+#define RULES_VALUE_MAX (1 + RULES_PAGE_LEN * RULE_STORED_LEN)
+
+#define MATCH_ALL (UPLINK_MATCH_OPCODE | UPLINK_MATCH_SRC | UPLINK_MATCH_DST | \
+		UPLINK_MATCH_APP_IDX | UPLINK_MATCH_PREFIX)
+
+
+LOG_MODULE_REGISTER(app_uplink_rules, CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL);
+
+/* A rule as evaluated, with its counters */
+struct compiled_rule {
+	struct uplink_rule rule;
+	uint32_t hit_count;
+	uint32_t sample_count;
+};
+
+static const char *const action_strs[] = {
+	[UPLINK_ACTION_FORWARD] = "forward",
+	[UPLINK_ACTION_DROP] = "drop",
+	[UPLINK_ACTION_SAMPLE] = "sample",
+	[UPLINK_ACTION_PRIORITY] = "priority",
+};
+
+BUILD_ASSERT(ARRAY_SIZE(action_strs) == UPLINK_ACTION_COUNT);
+
+/* rules_lock is taken in the mesh receive thread and only held to evaluate or swap the
+ * table. Updates are compiled and stored under update_lock. */
+K_MUTEX_DEFINE(rules_lock);
+K_MUTEX_DEFINE(update_lock);
+
+static struct compiled_rule rules[CONFIG_GATEWAY_UPLINK_RULES_MAX];
+static size_t rule_count;
+static struct compiled_rule staged[CONFIG_GATEWAY_UPLINK_RULES_MAX];
+/* Pages the table was last stored in */
+static size_t stored_pages;
+/* Slots of staged filled from settings, moved to rules once every page has been loaded */
+static uint8_t loaded[DIV_ROUND_UP(CONFIG_GATEWAY_UPLINK_RULES_MAX, 8)];
+static bool load_pending;
+
+static void rules_key(size_t page, char key[RULES_KEY_LEN])
+{
+	snprintk(key, RULES_KEY_LEN, RULES_SETTINGS_ROOT "/%u", (unsigned int)page);
+}
+
+/* Rejects rules that could never match or act. Fields a rule does not compare are cleared so
+ * that stored and listed rules only hold what was set. */
+static int compile(const struct uplink_rule *rule, struct compiled_rule *compiled)
+{
+	struct uplink_rule *out;
+
+	if ((rule->match & ~MATCH_ALL) || rule->action >= UPLINK_ACTION_COUNT ||
+	    (rule->flags & ~UPLINK_FLAG_DECODE)) {
+		return -EINVAL;
+	}
+
+	if (rule->action == UPLINK_ACTION_SAMPLE && rule->sample_rate == 0) {
+		return -EINVAL;
+	}
+
+	if (((rule->match & UPLINK_MATCH_SRC) && rule->src_first > rule->src_last) ||
+	    ((rule->match & UPLINK_MATCH_DST) && rule->dst_first > rule->dst_last)) {
+		return -EINVAL;
+	}
+
+	if ((rule->match & UPLINK_MATCH_PREFIX) &&
+	    (rule->prefix_len == 0 || rule->prefix_len > UPLINK_RULE_PREFIX_MAX)) {
+		return -EINVAL;
+	}
+
+	out = &compiled->rule;
+	memset(compiled, 0, sizeof(*compiled));
+	out->match = rule->match;
+	out->action = rule->action;
+	out->flags = rule->flags;
+	out->sample_rate = rule->action == UPLINK_ACTION_SAMPLE ? rule->sample_rate : 0;
+
+	if (rule->match & UPLINK_MATCH_OPCODE) {
+		out->opcode = rule->opcode;
+	}
+
+	if (rule->match & UPLINK_MATCH_SRC) {
+		out->src_first = rule->src_first;
+		out->src_last = rule->src_last;
+	}
+
+	if (rule->match & UPLINK_MATCH_DST) {
+		out->dst_first = rule->dst_first;
+		out->dst_last = rule->dst_last;
+	}
+
+	if (rule->match & UPLINK_MATCH_APP_IDX) {
+		out->app_idx = rule->app_idx;
+	}
+
+	if (rule->match & UPLINK_MATCH_PREFIX) {
+		out->prefix_len = rule->prefix_len;
+		memcpy(out->prefix, rule->prefix, rule->prefix_len);
+	}
+
+	return 0;
+}
+
+static bool rule_match(const struct uplink_rule *rule, uint32_t opcode,
+		const struct bt_mesh_msg_ctx *ctx, const struct net_buf_simple *buf)
+{
+	if ((rule->match & UPLINK_MATCH_OPCODE) && opcode != rule->opcode) {
+		return false;
+	}
+
+	if ((rule->match & UPLINK_MATCH_SRC) &&
+	    (ctx->addr < rule->src_first || ctx->addr > rule->src_last)) {
+		return false;
+	}
+
+	if ((rule->match & UPLINK_MATCH_DST) &&
+	    (ctx->recv_dst < rule->dst_first || ctx->recv_dst > rule->dst_last)) {
+		return false;
+	}
+
+	if ((rule->match & UPLINK_MATCH_APP_IDX) && ctx->app_idx != rule->app_idx) {
+		return false;
+	}
+
+	if ((rule->match & UPLINK_MATCH_PREFIX) &&
+	    (buf->len < rule->prefix_len || memcmp(buf->data, rule->prefix, rule->prefix_len))) {
+		return false;
+	}
+
+	return true;
+}
+
+/* Called with update_lock held */
+static int store(const struct compiled_rule *table, size_t count)
+{
+	int err;
+	size_t i;
+	size_t page;
+	size_t pages;
+	const struct uplink_rule *rule;
+	char key[RULES_KEY_LEN];
+
+	NET_BUF_SIMPLE_DEFINE(buf, RULES_VALUE_MAX);
+
+	pages = DIV_ROUND_UP(count, RULES_PAGE_LEN);
+
+	for (page = 0; page < pages; page++) {
+		net_buf_simple_reset(&buf);
+		net_buf_simple_add_u8(&buf, RULES_VERSION);
+
+		for (i = page * RULES_PAGE_LEN; i < MIN(count, (page + 1) * RULES_PAGE_LEN); i++) {
+			rule = &table[i].rule;
+			net_buf_simple_add_u8(&buf, rule->match);
+			net_buf_simple_add_u8(&buf, rule->action);
+			net_buf_simple_add_u8(&buf, rule->flags);
+			net_buf_simple_add_le16(&buf, rule->sample_rate);
+			net_buf_simple_add_le32(&buf, rule->opcode);
+			net_buf_simple_add_le16(&buf, rule->src_first);
+			net_buf_simple_add_le16(&buf, rule->src_last);
+			net_buf_simple_add_le16(&buf, rule->dst_first);
+			net_buf_simple_add_le16(&buf, rule->dst_last);
+			net_buf_simple_add_le16(&buf, rule->app_idx);
+			net_buf_simple_add_u8(&buf, rule->prefix_len);
+			net_buf_simple_add_mem(&buf, rule->prefix, UPLINK_RULE_PREFIX_MAX);
+		}
+
+		rules_key(page, key);
+		err = settings_save_one(key, buf.data, buf.len);
+
+		if (err) {
+			return err;
+		}
+	}
+
+	for (page = pages; page < stored_pages; page++) {
+		rules_key(page, key);
+		settings_delete(key);
+	}
+
+	stored_pages = pages;
+
+	return 0;
+}
+
+int uplink_rules_set(const struct uplink_rule *new_rules, size_t count)
+{
+	int err;
+	size_t i;
+
+	if (count > ARRAY_SIZE(rules)) {
+		return -ENOMEM;
+	}
+
+	k_mutex_lock(&update_lock, K_FOREVER);
+
+	/* Compiled aside so that a bad rule leaves the table as it was */
+	for (i = 0; i < count; i++) {
+		err = compile(&new_rules[i], &staged[i]);
+
+		if (err) {
+			k_mutex_unlock(&update_lock);
+			return err;
+		}
+	}
+
+	k_mutex_lock(&rules_lock, K_FOREVER);
+	memcpy(rules, staged, count * sizeof(rules[0]));
+	rule_count = count;
+	k_mutex_unlock(&rules_lock);
+
+	err = store(staged, count);
+	k_mutex_unlock(&update_lock);
+
+	if (err) {
+		LOG_ERR("Failed to store uplink rules: %d", err);
+	}
+
+	return err;
+}
+
+enum uplink_action uplink_rules_eval(uint32_t opcode, const struct bt_mesh_msg_ctx *ctx,
+		const struct net_buf_simple *buf, uint8_t *flags)
+{
+	size_t i;
+	enum uplink_action action;
+	struct compiled_rule *compiled;
+
+	action = UPLINK_ACTION_FORWARD;
+	*flags = 0;
+	k_mutex_lock(&rules_lock, K_FOREVER);
+
+	for (i = 0; i < rule_count; i++) {
+		compiled = &rules[i];
+
+		if (!rule_match(&compiled->rule, opcode, ctx, buf)) {
+			continue;
+		}
+
+		compiled->hit_count++;
+		action = compiled->rule.action;
+		*flags = compiled->rule.flags;
+
+		if (action == UPLINK_ACTION_SAMPLE) {
+			action = compiled->sample_count++ % compiled->rule.sample_rate ?
+				UPLINK_ACTION_DROP : UPLINK_ACTION_FORWARD;
+		}
+
+		break;
+	}
+
+	k_mutex_unlock(&rules_lock);
+
+	return action;
+}
+
+int uplink_rules_get(size_t idx, struct uplink_rule *rule, uint32_t *hit_count)
+{
+	int err;
+
+	k_mutex_lock(&rules_lock, K_FOREVER);
+	err = idx < rule_count ? 0 : -ENOENT;
+
+	if (!err) {
+		*rule = rules[idx].rule;
+		*hit_count = rules[idx].hit_count;
+	}
+
+	k_mutex_unlock(&rules_lock);
+
+	return err;
+}
+
+size_t uplink_rules_count(void)
+{
+	size_t ret;
+
+	k_mutex_lock(&rules_lock, K_FOREVER);
+	ret = rule_count;
+	k_mutex_unlock(&rules_lock);
+
+	return ret;
+}
+
+const char *uplink_action_str(enum uplink_action action)
+{
+	if (action >= UPLINK_ACTION_COUNT) {
+		return NULL;
+	}
+
+	return action_strs[action];
+}
+
+static int rules_set(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+	int err;
+	char *end;
+	size_t slot;
+	unsigned long page;
+	ssize_t read_len;
+	struct uplink_rule rule;
+
+	NET_BUF_SIMPLE_DEFINE(buf, RULES_VALUE_MAX);
+
+	page = strtoul(key, &end, 10);
+
+	if (*end != '\0' || page >= RULES_PAGE_COUNT) {
+		return -ENOENT;
+	}
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if (len > RULES_VALUE_MAX) {
+		return -EINVAL;
+	}
+
+	read_len = read_cb(cb_arg, net_buf_simple_add(&buf, len), len);
+
+	if (read_len < 0) {
+		return read_len;
+	}
+
+	if (read_len != len || (len - 1) % RULE_STORED_LEN ||
+	    net_buf_simple_pull_u8(&buf) != RULES_VERSION) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&update_lock, K_FOREVER);
+	stored_pages = MAX(stored_pages, page + 1);
+	load_pending = true;
+	err = 0;
+
+	for (slot = page * RULES_PAGE_LEN; buf.len && !err; slot++) {
+		rule.match = net_buf_simple_pull_u8(&buf);
+		rule.action = net_buf_simple_pull_u8(&buf);
+		rule.flags = net_buf_simple_pull_u8(&buf);
+		rule.sample_rate = net_buf_simple_pull_le16(&buf);
+		rule.opcode = net_buf_simple_pull_le32(&buf);
+		rule.src_first = net_buf_simple_pull_le16(&buf);
+		rule.src_last = net_buf_simple_pull_le16(&buf);
+		rule.dst_first = net_buf_simple_pull_le16(&buf);
+		rule.dst_last = net_buf_simple_pull_le16(&buf);
+		rule.app_idx = net_buf_simple_pull_le16(&buf);
+		rule.prefix_len = net_buf_simple_pull_u8(&buf);
+		memcpy(rule.prefix, net_buf_simple_pull_mem(&buf, UPLINK_RULE_PREFIX_MAX),
+				UPLINK_RULE_PREFIX_MAX);
+
+		err = slot < ARRAY_SIZE(staged) ? compile(&rule, &staged[slot]) : -EINVAL;
+
+		if (!err) {
+			loaded[slot / 8] |= BIT(slot % 8);
+		}
+	}
+
+	k_mutex_unlock(&update_lock);
+
+	return err;
+}
+
+/* Pages are loaded in any order and some may be missing or unreadable. The rules that did load
+ * are closed up in their stored order, so a gap never turns into an empty rule that matches
+ * every message. */
+static int rules_commit(void)
+{
+	size_t slot;
+	size_t last;
+
+	k_mutex_lock(&update_lock, K_FOREVER);
+
+	if (!load_pending) {
+		k_mutex_unlock(&update_lock);
+		return 0;
+	}
+
+	k_mutex_lock(&rules_lock, K_FOREVER);
+	rule_count = 0;
+	last = 0;
+
+	for (slot = 0; slot < ARRAY_SIZE(staged); slot++) {
+		if (loaded[slot / 8] & BIT(slot % 8)) {
+			rules[rule_count++] = staged[slot];
+			last = slot + 1;
+		}
+	}
+
+	k_mutex_unlock(&rules_lock);
+
+	if (rule_count != last) {
+		LOG_WRN("%u stored uplink rules missing, loaded %u",
+				(unsigned int)(last - rule_count), (unsigned int)rule_count);
+	}
+
+	memset(loaded, 0, sizeof(loaded));
+	load_pending = false;
+	k_mutex_unlock(&update_lock);
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(uplink_rules, RULES_SETTINGS_ROOT, NULL, rules_set,
+		rules_commit, NULL);
@@ -0,0 +1,74 @@
+#ifndef UPLINK_RULES_H_
+#define UPLINK_RULES_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+#include <bluetooth/mesh.h>
+
+#define UPLINK_RULE_PREFIX_MAX 8
+
+enum uplink_action {
+	UPLINK_ACTION_FORWARD,
+	UPLINK_ACTION_DROP,
+	/* Forward one in sample_rate of the matching messages, drop the rest */
+	UPLINK_ACTION_SAMPLE,
+	/* Forward through the priority lane of the receive bus */
+	UPLINK_ACTION_PRIORITY,
+	UPLINK_ACTION_COUNT
+};
+
+/* Fields a rule compares, the others match any message */
+#define UPLINK_MATCH_OPCODE BIT(0)
+#define UPLINK_MATCH_SRC BIT(1)
+#define UPLINK_MATCH_DST BIT(2)
+#define UPLINK_MATCH_APP_IDX BIT(3)
+#define UPLINK_MATCH_PREFIX BIT(4)
+
+/* Send the typed fields of SIG model status messages along with the raw payload */
+#define UPLINK_FLAG_DECODE BIT(0)
+
+struct uplink_rule {
+	uint8_t match;
+	uint8_t action;
+	uint8_t flags;
+	uint16_t sample_rate;
+	uint32_t opcode;
+	/* Inclusive address ranges */
+	uint16_t src_first;
+	uint16_t src_last;
+	uint16_t dst_first;
+	uint16_t dst_last;
+	uint16_t app_idx;
+	uint8_t prefix_len;
+	uint8_t prefix[UPLINK_RULE_PREFIX_MAX];
+};
+
+/* Replace the rule table and clear the hit counters. An empty table forwards everything. */
+int uplink_rules_set(const struct uplink_rule *rules, size_t count);
+
+/* Called from the mesh receive thread for every received model message that a consumer of
+ * the receive bus accepts, so the result applies to the shell as well as the cloud. Rules are
+ * checked in order and the first one that matches decides, messages that match none are
+ * forwarded with no flags. Sampling is resolved here, so the result is forward, drop or
+ * priority. */
+enum uplink_action uplink_rules_eval(uint32_t opcode, const struct bt_mesh_msg_ctx *ctx,
+		const struct net_buf_simple *buf, uint8_t *flags);
+
+/* Rules in table order, -ENOENT past the last one */
+int uplink_rules_get(size_t idx, struct uplink_rule *rule, uint32_t *hit_count);
+
+size_t uplink_rules_count(void);
+
+const char *uplink_action_str(enum uplink_action action);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* UPLINK_RULES_H_ */
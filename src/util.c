@@ -1,82 +1,160 @@
+#include <errno.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
-#include <stdlib.h>
 #include <string.h>
 
 #include "util.h"
 
-#define STR_LEN 33
+/* 32-bit FNV-1a */
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+/* Nybble value of every hex digit character tagged with HEX_OK. Every other character is 0,
+ * so a whole group of characters can be validated with one test on the AND of their table
+ * values. */
+#define HEX_OK 0x10
+
+static const uint8_t hex_val[256] = {
+    ['0'] = HEX_OK | 0x0, ['1'] = HEX_OK | 0x1, ['2'] = HEX_OK | 0x2, ['3'] = HEX_OK | 0x3,
+    ['4'] = HEX_OK | 0x4, ['5'] = HEX_OK | 0x5, ['6'] = HEX_OK | 0x6, ['7'] = HEX_OK | 0x7,
+    ['8'] = HEX_OK | 0x8, ['9'] = HEX_OK | 0x9,
+    ['A'] = HEX_OK | 0xA, ['B'] = HEX_OK | 0xB, ['C'] = HEX_OK | 0xC, ['D'] = HEX_OK | 0xD,
+    ['E'] = HEX_OK | 0xE, ['F'] = HEX_OK | 0xF,
+    ['a'] = HEX_OK | 0xA, ['b'] = HEX_OK | 0xB, ['c'] = HEX_OK | 0xC, ['d'] = HEX_OK | 0xD,
+    ['e'] = HEX_OK | 0xE, ['f'] = HEX_OK | 0xF,
+};
+
+static const char hex_digit[16] = "0123456789abcdef";
+
+/* Only called on input util_hex_valid() accepted */
+static inline uint8_t hex_byte(const uint8_t *hex)
+{
+    uint8_t hi = hex_val[hex[0]];
+    uint8_t lo = hex_val[hex[1]];
+
+    return ((hi & 0x0F) << 4) | (lo & 0x0F);
+}
 
-static bool util_valid(const char* str)
+bool util_hex_valid(const char *hex, size_t hex_len)
 {
-    uint8_t i;
+    size_t i;
+    uint8_t ok;
+    const uint8_t *src = (const uint8_t *)hex;
 
-    /* Check for valid characters 0-9, a-f, A-F */
-    for (i = 0; i < STR_LEN - 1; i++) {
-        if (str[i] >= '0' && str[i] <= '9') {
-            continue;
-        } else if (str[i] >= 'A' && str[i] <= 'F') {
-            continue;
-        } else if (str[i] >= 'a' && str[i] <= 'f') {
-            continue;
-        } else {
-            return false;
-        }
+    ok = HEX_OK;
+
+    for (i = 0; i + 4 <= hex_len; i += 4) {
+        ok &= hex_val[src[i]] & hex_val[src[i + 1]] & hex_val[src[i + 2]] &
+              hex_val[src[i + 3]];
     }
 
-    /* Check the length of the string is correct */
-    if (str[i] != '\0') {
-        return false;
+    for (; i < hex_len; i++) {
+        ok &= hex_val[src[i]];
     }
 
-    return true;
+    return ok & HEX_OK;
 }
 
-void util_uuid_cpy(uint8_t dest[UUID_LEN], uint8_t src[UUID_LEN])
+int util_hex2bin(const char *hex, size_t hex_len, uint8_t *bin, size_t bin_len)
 {
-    memcpy(dest, src, UUID_LEN);
+    size_t i;
+    size_t len;
+    const uint8_t *src = (const uint8_t *)hex;
+
+    if (hex_len % 2) {
+        return -EINVAL;
+    }
+
+    len = hex_len / 2;
+
+    if (len > bin_len) {
+        return -ENOBUFS;
+    }
+
+    /* Validate the whole input before the first write, so a bad character never leaves bin
+     * half decoded */
+    if (!util_hex_valid(hex, hex_len)) {
+        return -EINVAL;
+    }
+
+    /* Four output bytes per pass */
+    for (i = 0; i + 4 <= len; i += 4) {
+        bin[i] = hex_byte(&src[i * 2]);
+        bin[i + 1] = hex_byte(&src[(i * 2) + 2]);
+        bin[i + 2] = hex_byte(&src[(i * 2) + 4]);
+        bin[i + 3] = hex_byte(&src[(i * 2) + 6]);
+    }
+
+    for (src += i * 2; i < len; i++, src += 2) {
+        bin[i] = hex_byte(src);
+    }
+
+    return len;
 }
 
-int util_uuid_cmp(const uint8_t uuid_a[UUID_LEN], const uint8_t uuid_b[UUID_LEN])
+int util_bin2hex(const uint8_t *bin, size_t bin_len, char *hex, size_t hex_len)
 {
-    return memcmp(uuid_a, uuid_b, UUID_LEN);
+    size_t i;
+    uint32_t word;
+    char *dst = hex;
+
+    if (hex_len < (bin_len * 2) + 1) {
+        return -ENOBUFS;
+    }
+
+    /* Load four input bytes per pass and emit them most significant nybble first */
+    for (i = 0; i + 4 <= bin_len; i += 4) {
+        word = ((uint32_t)bin[i] << 24) | ((uint32_t)bin[i + 1] << 16) |
+               ((uint32_t)bin[i + 2] << 8) | bin[i + 3];
+        dst[0] = hex_digit[(word >> 28) & 0x0F];
+        dst[1] = hex_digit[(word >> 24) & 0x0F];
+        dst[2] = hex_digit[(word >> 20) & 0x0F];
+        dst[3] = hex_digit[(word >> 16) & 0x0F];
+        dst[4] = hex_digit[(word >> 12) & 0x0F];
+        dst[5] = hex_digit[(word >> 8) & 0x0F];
+        dst[6] = hex_digit[(word >> 4) & 0x0F];
+        dst[7] = hex_digit[word & 0x0F];
+        dst += 8;
+    }
+
+    for (; i < bin_len; i++) {
+        dst[0] = hex_digit[bin[i] >> 4];
+        dst[1] = hex_digit[bin[i] & 0x0F];
+        dst += 2;
+    }
+
+    *dst = '\0';
+    return bin_len * 2;
 }
 
-static void util_str2(const char str[STR_LEN], uint8_t arr[LEN])
+static bool util_valid(const char *str)
 {
-    uint8_t i;
-    char byte_str[2];
+    /* Exactly 32 hex characters, checked without reading past the terminator */
+    return str != NULL && strnlen(str, STR_LEN) == STR_LEN - 1 &&
+           util_hex_valid(str, STR_LEN - 1);
+}
 
-    for (i = 0; i < LEN; i++) {
-        byte_str[0] = str[i*2];
-        byte_str[1] = str[(i*2) + 1];
-        arr[i] = (uint8_t)strtoul(byte_str, NULL, LEN);
-    }
+void util_uuid_cpy(uint8_t dest[UUID_LEN], uint8_t src[UUID_LEN])
+{
+    memcpy(dest, src, UUID_LEN);
 }
 
-static void util_2str(const uint8_t arr[LEN], char str[STR_LEN])
+int util_uuid_cmp(const uint8_t uuid_a[UUID_LEN], const uint8_t uuid_b[UUID_LEN])
 {
-    uint8_t i;
-    uint8_t nyble;
+    return memcmp(uuid_a, uuid_b, UUID_LEN);
+}
 
-    for (i = 0; i < LEN; i++) {
-        /* Most significant nyble of byte */
-        nyble = (arr[i] & 0xF0) >> 4;
-        if (nyble < 10) {
-            str[i*2] = (char)(nyble + 48);  /* For characters 0-9 */
-        } else {
-            str[i*2] = (char)(nyble + 87);  /* For characters a-f */
-        }
+static int util_str2(const char *str, uint8_t arr[LEN])
+{
+    int len;
 
-        /* Least significant nyble of byte */
-        nyble = arr[i] & 0x0F;
-        if (nyble < 10) {
-            str[(i*2) + 1] = (char)(nyble + 48);
-        } else {
-            str[(i*2) + 1] = (char)(nyble + 87);
-        }
+    if (str == NULL || strnlen(str, STR_LEN) != STR_LEN - 1) {
+        return -EINVAL;
     }
-    str[32] = '\0';
+
+    len = util_hex2bin(str, STR_LEN - 1, arr, LEN);
+    return len < 0 ? len : 0;
 }
 
 bool util_uuid_valid(const char *uuid_str)
@@ -84,14 +162,14 @@ bool util_uuid_valid(const char *uuid_str)
     return util_valid(uuid_str);
 }
 
-void util_str2uuid(const char str[UUID_STR_LEN], uint8_t uuid[UUID_LEN])
+int util_str2uuid(const char *str, uint8_t uuid[UUID_LEN])
 {
-    util_str2(str, uuid);
+    return util_str2(str, uuid);
 }
 
 void util_uuid2str(const uint8_t uuid[UUID_LEN], char str[UUID_STR_LEN])
 {
-    util_2str(uuid, str);
+    util_bin2hex(uuid, UUID_LEN, str, UUID_STR_LEN);
 }
 
 bool util_key_valid(const char *key_str)
@@ -99,12 +177,71 @@ bool util_key_valid(const char *key_str)
     return util_valid(key_str);
 }
 
-void util_str2key(const char str[KEY_STR_LEN], uint8_t key[KEY_LEN])
+int util_str2key(const char *str, uint8_t key[KEY_LEN])
 {
-    util_str2(str, key);
+    return util_str2(str, key);
 }
 
 void util_key2str(const uint8_t key[KEY_LEN], char str[KEY_STR_LEN])
 {
-    util_2str(key, str);
+    util_bin2hex(key, KEY_LEN, str, KEY_STR_LEN);
+}
+
+uint32_t util_uuid_hash(const uint8_t uuid[UUID_LEN])
+{
+    size_t i;
+    uint32_t hash;
+
+    hash = FNV_OFFSET;
+
+    for (i = 0; i < UUID_LEN; i++) {
+        hash = (hash ^ uuid[i]) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+size_t util_uuid_search(const uint8_t *uuids, size_t stride, const uint16_t *sorted,
+                        size_t count, const uint8_t uuid[UUID_LEN], bool *found)
+{
+    int cmp;
+    size_t lo;
+    size_t hi;
+    size_t mid;
+
+    lo = 0;
+    hi = count;
+    *found = false;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        cmp = memcmp(uuids + sorted[mid] * stride, uuid, UUID_LEN);
+
+        if (cmp == 0) {
+            *found = true;
+            return mid;
+        }
+
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+uint32_t util_backoff(uint32_t first, uint32_t max, unsigned int attempt)
+{
+    uint64_t delay;
+
+    if (attempt == 0) {
+        return 0;
+    }
+
+    /* Past 16 doublings every sensible limit has been reached */
+    delay = (uint64_t)first << (attempt - 1 < 16 ? attempt - 1 : 16);
+
+    return delay < max ? (uint32_t)delay : max;
 }
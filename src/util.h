@@ -7,6 +7,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #define LEN 16          /* 128-bit length */
@@ -16,22 +17,48 @@ extern "C" {
 #define KEY_LEN LEN
 #define KEY_STR_LEN STR_LEN
 
+/* Check that the first hex_len characters of hex are all hexadecimal digits. */
+bool util_hex_valid(const char *hex, size_t hex_len);
+
+/* Decode hex_len hexadecimal characters into bin. hex does not need to be NUL terminated.
+ * Returns the number of bytes written, -EINVAL for an odd length or a non-hex character or
+ * -ENOBUFS if bin_len is too small. bin is not written on error. */
+int util_hex2bin(const char *hex, size_t hex_len, uint8_t *bin, size_t bin_len);
+
+/* Encode bin_len bytes as lower case hexadecimal and NUL terminate the result. Returns the
+ * number of characters written, not counting the terminator, or -ENOBUFS if hex_len is too
+ * small. */
+int util_bin2hex(const uint8_t *bin, size_t bin_len, char *hex, size_t hex_len);
+
 bool util_uuid_valid(const char *uuid_str);
 
 void util_uuid_cpy(uint8_t dest[UUID_LEN], uint8_t src[UUID_LEN]);
 
 int util_uuid_cmp(const uint8_t uuid_a[UUID_LEN], const uint8_t uuid_b[UUID_LEN]);
 
-void util_str2uuid(const char str[UUID_STR_LEN], uint8_t uuid[UUID_LEN]);
+int util_str2uuid(const char *str, uint8_t uuid[UUID_LEN]);
 
 void util_uuid2str(const uint8_t uuid[UUID_LEN], char str[UUID_STR_LEN]);
 
 bool util_key_valid(const char *key_str);
 
-void util_str2key(const char str[KEY_STR_LEN], uint8_t key[KEY_LEN]);
+int util_str2key(const char *str, uint8_t key[KEY_LEN]);
 
 void util_key2str(const uint8_t key[KEY_LEN], char str[KEY_STR_LEN]);
 
+/* 32-bit FNV-1a hash of a UUID, for hash tables keyed by UUID */
+uint32_t util_uuid_hash(const uint8_t uuid[UUID_LEN]);
+
+/* Binary search of a table kept in UUID order through an index array. The UUID of table
+ * entry i is at uuids + i * stride. Returns the position of uuid in sorted, or where it would
+ * be inserted, and sets found if it is there. */
+size_t util_uuid_search(const uint8_t *uuids, size_t stride, const uint16_t *sorted,
+                        size_t count, const uint8_t uuid[UUID_LEN], bool *found);
+
+/* Exponential backoff: first doubled for every attempt after the first (attempt counts from 1),
+ * limited to max. Returns 0 for attempt 0. */
+uint32_t util_backoff(uint32_t first, uint32_t max, unsigned int attempt);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,1321 @@
+/* Host benchmark of the cloud message codec. Every message type is encoded, or parsed from a
+ * request, once to check the result against the golden output and then timed. The cost of
+ * each type is reported as time, heap allocations and heap bytes per message, and compared
+ * against a baseline.
+ *
+ * bench_codec [-n iterations] [-g golden] [-b baseline] [-t percent] [-u]
+ *
+ * -t is the regression threshold in percent over the baseline. Allocations and bytes are the
+ * same on every host, time is only compared if the baseline has it, so a timing baseline has
+ * to be recorded with -u on the machine that runs the comparison. -u writes the golden output
+ * and the baseline instead of comparing against them. */
+
+#include <zephyr.h>
+#include <string.h>
+#include <unistd.h>
+#include <cJSON.h>
+
+#include "host.h"
+#include "codec.h"
+
+#define BUF_LEN 4096
+/* Small enough to split the paged lists */
+#define PAGE_LEN 600
+#define NAME_LEN 40
+
+#define REQUEST(op) "{\"id\":\"42\",\"type\":\"operation\",\"operation\":{" op "}}"
+
+struct bench_case {
+	const char *name;
+	/* Fills buf with the encoded message, or a description of the parsed request */
+	int (*run)(char *buf, size_t buf_len);
+};
+
+struct bench_result {
+	char name[NAME_LEN];
+	double ns;
+	double allocs;
+	double bytes;
+};
+
+static const uint8_t uuid[UUID_LEN] = {
+	0x4d, 0xf5, 0xfa, 0x66, 0xd7, 0xeb, 0x44, 0xb9,
+	0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+};
+
+/* Parse a request and return its operation object, *root is released by the caller */
+static cJSON *request_parse(const char *request, cJSON **root)
+{
+	*root = cJSON_Parse(request);
+	return cJSON_GetObjectItem(*root, "operation");
+}
+
+static int paged(char *buf, size_t buf_len,
+		int (*encode)(char *buf, size_t buf_len, struct codec_page *page))
+{
+	int err;
+	size_t len;
+	struct codec_page page;
+
+	memset(&page, 0, sizeof(page));
+	len = 0;
+
+	/* Every page of the list, one message per line */
+	do {
+		err = encode(&buf[len], MIN(PAGE_LEN, buf_len - len), &page);
+
+		if (err) {
+			return err;
+		}
+
+		len += strlen(&buf[len]);
+		page.index++;
+
+		if (page.more && len < buf_len - 1) {
+			buf[len++] = '\n';
+		}
+	} while (page.more && len < buf_len - 1);
+
+	return 0;
+}
+
+static int beacon_list(char *buf, size_t buf_len)
+{
+	return paged(buf, buf_len, codec_encode_beacon_list);
+}
+
+static int beacon_blocklist(char *buf, size_t buf_len)
+{
+	return paged(buf, buf_len, codec_encode_beacon_blocklist);
+}
+
+static int node_list(char *buf, size_t buf_len)
+{
+	return paged(buf, buf_len, codec_encode_node_list);
+}
+
+static int uplink_rules(char *buf, size_t buf_len)
+{
+	return paged(buf, buf_len, codec_encode_uplink_rules);
+}
+
+static int subscribe_list(char *buf, size_t buf_len)
+{
+	return paged(buf, buf_len, codec_encode_subscribe_list);
+}
+
+static int beacon_found(char *buf, size_t buf_len)
+{
+	size_t i;
+	struct beacon_event events[4];
+
+	memset(events, 0, sizeof(events));
+
+	for (i = 0; i < ARRAY_SIZE(events); i++) {
+		memcpy(events[i].beacon.uuid, uuid, UUID_LEN);
+		events[i].beacon.uuid[0] = i;
+		events[i].beacon.oob_info = BT_MESH_PROV_OOB_URI;
+		events[i].beacon.uri_hash_set = true;
+		events[i].beacon.uri_hash = 0xdeadbeef;
+		events[i].found = true;
+	}
+
+	return codec_encode_beacon_events(buf, buf_len, events, ARRAY_SIZE(events), true, false);
+}
+
+static int beacon_lost(char *buf, size_t buf_len)
+{
+	struct beacon_event events[2];
+
+	memset(events, 0, sizeof(events));
+	memcpy(events[0].beacon.uuid, uuid, UUID_LEN);
+	memcpy(events[1].beacon.uuid, uuid, UUID_LEN);
+	events[1].beacon.uuid[0] = 1;
+
+	return codec_encode_beacon_events(buf, buf_len, events, ARRAY_SIZE(events), false, true);
+}
+
+static int beacon_block_result(char *buf, size_t buf_len)
+{
+	return codec_encode_beacon_block_result(buf, buf_len, 0, 3, 7);
+}
+
+static int prov_result(char *buf, size_t buf_len)
+{
+	uint8_t dev_uuid[UUID_LEN];
+
+	memcpy(dev_uuid, uuid, UUID_LEN);
+	return codec_encode_prov_result(buf, buf_len, 0, 0x0000, dev_uuid, 0x0010, 3);
+}
+
+static int prov_queue_status(char *buf, size_t buf_len)
+{
+	struct prov_queue_stats stats = {
+		.queued = 12,
+		.retrying = 2,
+		.active = true,
+		.done = 40,
+		.failed = 3,
+		.retries = 5,
+		.avg_time_ms = 8200,
+		.batch_done = 10,
+		.batch_time_ms = 90000,
+	};
+
+	return codec_encode_prov_queue_status(buf, buf_len, &stats);
+}
+
+static int subnet_list(char *buf, size_t buf_len)
+{
+	return codec_encode_subnet_list(buf, buf_len);
+}
+
+static int app_key_list(char *buf, size_t buf_len)
+{
+	return codec_encode_app_key_list(buf, buf_len);
+}
+
+static uint16_t node_appkeys[] = { 0x0000, 0x0001 };
+static uint16_t node_subs[] = { 0xC000, 0xC001, 0xC002 };
+static uint16_t node_subnets[] = { 0x0000, 0x0001 };
+
+static struct btmesh_sig_model node_sig_models[] = {
+	{ .model_id = 0x0000 },
+	{ .model_id = 0x0002 },
+	{
+		.model_id = 0x1000,
+		.appkey_count = ARRAY_SIZE(node_appkeys),
+		.appkey_idxs = node_appkeys,
+		.sub_addr_count = ARRAY_SIZE(node_subs),
+		.sub_addrs = node_subs,
+		.pub = {
+			.addr = 0xC000,
+			.app_idx = 0x0000,
+			.ttl = 7,
+			.period = BT_MESH_PUB_PERIOD_SEC(10),
+			.transmit = BT_MESH_TRANSMIT(2, 20),
+		},
+	},
+	{
+		.model_id = 0x1001,
+		.appkey_count = 1,
+		.appkey_idxs = node_appkeys,
+	},
+};
+
+static struct btmesh_vnd_model node_vnd_models[] = {
+	{
+		.company_id = 0x0059,
+		.model_id = 0x000A,
+		.appkey_count = 1,
+		.appkey_idxs = &node_appkeys[1],
+	},
+};
+
+static struct btmesh_elem node_elems[] = {
+	{
+		.addr = 0x0010,
+		.loc = 0x0100,
+		.sig_model_count = 3,
+		.sig_models = node_sig_models,
+	},
+	{
+		.addr = 0x0011,
+		.loc = 0x0101,
+		.sig_model_count = 2,
+		.vnd_model_count = ARRAY_SIZE(node_vnd_models),
+		.sig_models = &node_sig_models[2],
+		.vnd_models = node_vnd_models,
+	},
+};
+
+static struct btmesh_node node = {
+	.net_idx = 0x0000,
+	.addr = 0x0010,
+	.cid = 0x0059,
+	.pid = 0x0001,
+	.vid = 0x0002,
+	.crpl = 0x0080,
+	.net_beacon_state = true,
+	.ttl = 7,
+	.hb_sub = { .src = 0x0002, .dst = 0x0010, .period = 4, .count = 2, .min = 1, .max = 3 },
+	.hb_pub = { .dst = 0xC000, .count = 0xFF, .period = 5, .ttl = 7, .feat = 1 },
+	.relay = { .state = true, .support = true, .count = 2, .interval = 20 },
+	.proxy = { .state = true, .support = true },
+	.friend = { .state = false, .support = true },
+	.lpn = false,
+	.cfg_version = 12,
+	.subnet_count = ARRAY_SIZE(node_subnets),
+	.subnet_idxs = node_subnets,
+	.elem_count = ARRAY_SIZE(node_elems),
+	.elems = node_elems,
+};
+
+/* Elements are not split, so discovery is paged at the gateway's page size */
+static int node_disc(char *buf, size_t buf_len)
+{
+	int err;
+	size_t len;
+	struct codec_page page;
+
+	memcpy(node.uuid, uuid, UUID_LEN);
+	memset(&page, 0, sizeof(page));
+	len = 0;
+
+	do {
+		err = codec_encode_node_disc(&buf[len], MIN(CONFIG_GATEWAY_PAGE_SIZE, buf_len - len),
+				&node, 0, 0, &page);
+
+		if (err) {
+			return err;
+		}
+
+		len += strlen(&buf[len]);
+		page.index++;
+
+		if (page.more && len < buf_len - 1) {
+			buf[len++] = '\n';
+		}
+	} while (page.more && len < buf_len - 1);
+
+	return 0;
+}
+
+static int node_cfg(char *buf, size_t buf_len)
+{
+	union btmesh_op_args args;
+	struct btmesh_model_state model = {
+		.elem_addr = 0x0010,
+		.model_id = 0x1000,
+		.company_id = BT_MESH_CID_NVAL,
+		.appkey_count = 1,
+		.appkey_idxs = { 0x0000 },
+		.sub_addr_count = 2,
+		.sub_addrs = { 0xC000, 0xC001 },
+		.pub = {
+			.addr = 0xC000,
+			.ttl = 7,
+			.period = BT_MESH_PUB_PERIOD_SEC(10),
+			.transmit = BT_MESH_TRANSMIT(2, 20),
+		},
+	};
+
+	memset(&args, 0, sizeof(args));
+	args.mod_app_bind.addr = 0x0010;
+	args.mod_app_bind.elem_addr = 0x0010;
+	args.mod_app_bind.mod_app_idx = 0x0000;
+	args.mod_app_bind.mod_id = 0x1000;
+
+	return codec_encode_node_cfg(buf, buf_len, 0x0010, BTMESH_OP_MOD_APP_BIND, &args, 0, 13,
+			&model);
+}
+
+static void txn_fill(struct cfg_txn *txn, struct cfg_txn_step *steps, size_t count)
+{
+	memset(steps, 0, count * sizeof(*steps));
+	steps[0].op.op = BTMESH_OP_MOD_APP_BIND;
+	steps[0].op.args.mod_app_bind.elem_addr = 0x0010;
+	steps[0].op.args.mod_app_bind.mod_id = 0x1000;
+	steps[0].has_rollback = true;
+	steps[0].rollback.op = BTMESH_OP_MOD_APP_UNBIND;
+	steps[0].state = CFG_TXN_STEP_ROLLED_BACK;
+	steps[1].op.op = BTMESH_OP_MOD_SUB_ADD;
+	steps[1].op.args.mod_sub_add.elem_addr = 0x0010;
+	steps[1].op.args.mod_sub_add.sub_addr = 0xC000;
+	steps[1].op.args.mod_sub_add.mod_id = 0x1000;
+	steps[1].op.args.mod_sub_add.status = 0x08;
+	steps[1].op.err = 0;
+	steps[1].state = CFG_TXN_STEP_FAILED;
+	steps[2].op.op = BTMESH_OP_MOD_PUB_SET;
+	steps[2].state = CFG_TXN_STEP_PENDING;
+
+	txn->addr = 0x0010;
+	txn->steps = steps;
+	txn->step_count = count;
+	txn->failed_step = 1;
+}
+
+static int node_cfg_txn(char *buf, size_t buf_len)
+{
+	struct cfg_txn txn;
+	struct cfg_txn_step steps[3];
+
+	txn_fill(&txn, steps, ARRAY_SIZE(steps));
+	return codec_encode_node_cfg_txn(buf, buf_len, &txn, -EIO, 14);
+}
+
+static int node_ready(char *buf, size_t buf_len)
+{
+	struct cfg_txn txn;
+	struct cfg_txn_step steps[3];
+
+	txn_fill(&txn, steps, ARRAY_SIZE(steps));
+	return codec_encode_node_ready(buf, buf_len, uuid, 0x0000, 0x0010, 2, "profile0", &txn,
+			-EIO, 14);
+}
+
+static int prov_profile_list(char *buf, size_t buf_len)
+{
+	return codec_encode_prov_profile_list(buf, buf_len);
+}
+
+static int prov_allow_list(char *buf, size_t buf_len)
+{
+	return codec_encode_prov_allow_list(buf, buf_len);
+}
+
+static int model_msg_raw(char *buf, size_t buf_len)
+{
+	uint8_t payload[] = { 0x01, 0x00, 0x0A };
+	struct bt_mesh_msg_ctx ctx = {
+		.net_idx = 0x0000,
+		.app_idx = 0x0000,
+		.addr = 0x0010,
+		.recv_dst = 0xC000,
+	};
+
+	return codec_encode_model_msg(buf, buf_len, 0x8204, &ctx, payload, sizeof(payload),
+			1500, NULL);
+}
+
+static int model_msg_decoded(char *buf, size_t buf_len)
+{
+	uint8_t payload[] = { 0x4d, 0x00, 0x10, 0x09, 0x42, 0x00, 0x00 };
+	struct bt_mesh_msg_ctx ctx = {
+		.net_idx = 0x0000,
+		.app_idx = 0x0000,
+		.addr = 0x0012,
+		.recv_dst = 0x0001,
+	};
+	struct model_decoded decoded;
+
+	memset(&decoded, 0, sizeof(decoded));
+	decoded.sensor_count = 2;
+	decoded.sensors[0].prop_id = 0x004d;
+	decoded.sensors[0].raw = &payload[2];
+	decoded.sensors[0].len = 3;
+	decoded.sensors[0].has_value = true;
+	decoded.sensors[0].value = 23.5;
+	decoded.sensors[0].has_desc = true;
+	decoded.sensors[0].desc.update_interval = 10;
+	decoded.sensors[1].prop_id = 0x0042;
+	decoded.sensors[1].raw = &payload[5];
+	decoded.sensors[1].len = 2;
+
+	return codec_encode_model_msg(buf, buf_len, 0x52, &ctx, payload, sizeof(payload), 2500,
+			&decoded);
+}
+
+static int model_msg_values(char *buf, size_t buf_len)
+{
+	uint8_t payload[] = { 0x00, 0x01, 0x0A };
+	struct bt_mesh_msg_ctx ctx = {
+		.net_idx = 0x0000,
+		.app_idx = 0x0000,
+		.addr = 0x0014,
+		.recv_dst = 0xC000,
+	};
+	struct model_decoded decoded;
+
+	memset(&decoded, 0, sizeof(decoded));
+	decoded.value_count = 3;
+	decoded.values[0] = (struct model_value){ "present", 0 };
+	decoded.values[1] = (struct model_value){ "target", 1 };
+	decoded.values[2] = (struct model_value){ "remainingTime", 1000 };
+
+	return codec_encode_model_msg(buf, buf_len, 0x8204, &ctx, payload, sizeof(payload), 3500,
+			&decoded);
+}
+
+static int hlth_faults_cur(char *buf, size_t buf_len)
+{
+	uint8_t faults[] = { 0x01, 0x05, 0x10 };
+
+	return codec_encode_hlth_faults_cur(buf, buf_len, 0x0010, 0x0059, 0, faults,
+			sizeof(faults), 4000);
+}
+
+static int hlth_faults_reg(char *buf, size_t buf_len)
+{
+	uint8_t faults[] = { 0x02 };
+
+	return codec_encode_hlth_faults_reg(buf, buf_len, 0x0010, 0x0000, 0x0059, 0, faults,
+			sizeof(faults));
+}
+
+static int hlth_period(char *buf, size_t buf_len)
+{
+	return codec_encode_hlth_period(buf, buf_len, 0x0010, 3);
+}
+
+static int hlth_attn(char *buf, size_t buf_len)
+{
+	return codec_encode_hlth_attn(buf, buf_len, 0x0010, 5);
+}
+
+static int hlth_timeout(char *buf, size_t buf_len)
+{
+	return codec_encode_hlth_timeout(buf, buf_len, 10000);
+}
+
+static int mesh_stats(char *buf, size_t buf_len)
+{
+	return codec_encode_mesh_stats(buf, buf_len);
+}
+
+static int sweep_progress(char *buf, size_t buf_len)
+{
+	struct sweep_status status = {
+		.state = SWEEP_RUNNING,
+		.total = 100,
+		.done = 40,
+		.failed = 2,
+		.active = 4,
+	};
+
+	return codec_encode_sweep_progress(buf, buf_len, &status, 3, 250, 0x0010, 0, 0);
+}
+
+static int fanout_node(char *buf, size_t buf_len)
+{
+	struct fanout_result res = {
+		.op = BTMESH_OP_MOD_SUB_ADD,
+		.addr = 0x0010,
+		.err = 0,
+		.status = 0,
+		.elem_count = 2,
+	};
+
+	return codec_encode_fanout_node(buf, buf_len, &res);
+}
+
+static int fanout_progress(char *buf, size_t buf_len)
+{
+	struct fanout_status status = {
+		.state = FANOUT_RUNNING,
+		.op = BTMESH_OP_MOD_SUB_ADD,
+		.total = 50,
+		.done = 20,
+		.failed = 1,
+		.skipped = 4,
+		.active = 4,
+	};
+
+	return codec_encode_fanout_progress(buf, buf_len, &status);
+}
+
+static int reconcile_status(char *buf, size_t buf_len)
+{
+	return codec_encode_reconcile_status(buf, buf_len);
+}
+
+static int parse_beacon_request(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	uint16_t cursor = 0;
+
+	err = codec_parse_cursor(request_parse(REQUEST("\"type\":\"beacon_request\","
+					"\"cursor\":12"), &root), &cursor);
+	snprintf(buf, buf_len, "err %d cursor %u", err, cursor);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_beacon_events(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	bool enable = false;
+
+	err = codec_parse_beacon_events(request_parse(REQUEST("\"type\":\"beacon_events_set\","
+					"\"state\":true"), &root), &enable);
+	snprintf(buf, buf_len, "err %d enable %d", err, enable);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_beacon_block(char *buf, size_t buf_len)
+{
+	int err;
+	size_t i;
+	size_t len;
+	size_t count = 0;
+	cJSON *root;
+	uint8_t (*uuids)[UUID_LEN] = NULL;
+
+	err = codec_parse_beacon_block(request_parse(REQUEST("\"type\":\"beacon_block\","
+					"\"uuids\":[\"4df5fa66d7eb44b98000000000000001\","
+					"\"4df5fa66d7eb44b98000000000000002\","
+					"\"4df5fa66d7eb44b98000000000000003\"]"), &root),
+			&uuids, &count);
+	len = snprintf(buf, buf_len, "err %d count %zu", err, count);
+
+	for (i = 0; i < count && len < buf_len; i++) {
+		len += snprintf(&buf[len], buf_len - len, " %02x%02x", uuids[i][0], uuids[i][15]);
+	}
+
+	k_free(uuids);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_prov(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	uint8_t dev_uuid[UUID_LEN];
+	uint16_t net_idx = 0;
+	uint16_t addr = 0;
+	uint8_t attn = 0;
+	char *profile = NULL;
+
+	err = codec_parse_prov(request_parse(REQUEST("\"type\":\"provision\","
+					"\"uuid\":\"4df5fa66d7eb44b98000000000000001\","
+					"\"netIndex\":0,\"address\":16,\"attention\":5,"
+					"\"profile\":\"light\""), &root),
+			dev_uuid, &net_idx, &addr, &attn, &profile);
+	snprintf(buf, buf_len, "err %d uuid %02x..%02x net %u addr %u attn %u profile %s", err,
+			dev_uuid[0], dev_uuid[15], net_idx, addr, attn, profile ? profile : "-");
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_prov_bulk(char *buf, size_t buf_len)
+{
+	int err;
+	size_t i;
+	size_t len;
+	size_t count = 0;
+	cJSON *root;
+	struct prov_queue_dev *devs = NULL;
+
+	err = codec_parse_prov_bulk(request_parse(REQUEST("\"type\":\"provision_bulk\","
+					"\"netIndex\":0,\"elementCount\":2,\"attention\":0,"
+					"\"profile\":\"light\",\"devices\":["
+					"{\"uuid\":\"4df5fa66d7eb44b98000000000000001\"},"
+					"{\"uuid\":\"4df5fa66d7eb44b98000000000000002\","
+					"\"address\":32,\"elementCount\":3},"
+					"{\"uuid\":\"4df5fa66d7eb44b98000000000000003\","
+					"\"netIndex\":1,\"profile\":\"switch\"}]"), &root),
+			&devs, &count);
+	len = snprintf(buf, buf_len, "err %d count %zu", err, count);
+
+	for (i = 0; i < count && len < buf_len; i++) {
+		len += snprintf(&buf[len], buf_len - len, " [%02x net %u addr %u elems %u %s]",
+				devs[i].uuid[15], devs[i].net_idx, devs[i].addr,
+				devs[i].elem_count, devs[i].profile);
+	}
+
+	k_free(devs);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_subnet_add(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	uint16_t net_idx = 0;
+	uint8_t net_key[KEY_LEN];
+
+	err = codec_parse_subnet_add(request_parse(REQUEST("\"type\":\"subnet_add\","
+					"\"netKey\":\"0953fa93e7caac9638f58820220a398e\","
+					"\"netIndex\":2"), &root), &net_idx, net_key);
+	snprintf(buf, buf_len, "err %d net %u key %02x..%02x", err, net_idx, net_key[0],
+			net_key[15]);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_app_key_add(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	uint16_t net_idx = 0;
+	uint16_t app_idx = 0;
+	uint8_t app_key[KEY_LEN];
+
+	err = codec_parse_app_key_add(request_parse(REQUEST("\"type\":\"app_key_add\","
+					"\"appKey\":\"8e2a0f10953fa93e7caac9638f588202\","
+					"\"appIndex\":3,\"netIndex\":1"), &root),
+			&net_idx, &app_idx, app_key);
+	snprintf(buf, buf_len, "err %d net %u app %u key %02x..%02x", err, net_idx, app_idx,
+			app_key[0], app_key[15]);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_node_disc(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	uint16_t addr = 0;
+	bool refresh = false;
+
+	err = codec_parse_node_disc(request_parse(REQUEST("\"type\":\"node_discover\","
+					"\"address\":16,\"refresh\":true"), &root), &addr, &refresh);
+	snprintf(buf, buf_len, "err %d addr %u refresh %d", err, addr, refresh);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_node_cfg(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	uint16_t addr = 0;
+	enum btmesh_op op = BTMESH_OP_COUNT;
+	union btmesh_op_args args;
+
+	memset(&args, 0, sizeof(args));
+	err = codec_parse_node_cfg(request_parse(REQUEST("\"type\":\"node_configure\","
+					"\"configuration\":\"publishParametersSet\","
+					"\"address\":16,\"elementAddress\":17,\"modelId\":4096,"
+					"\"publishAddress\":49152,\"appIndex\":0,"
+					"\"friendCredentialFlag\":false,\"timeToLive\":7,"
+					"\"period\":10,\"periodUnits\":\"1s\","
+					"\"retransmitCount\":2,\"retransmitInterval\":20"), &root),
+			&addr, &op, &args);
+	snprintf(buf, buf_len, "err %d addr %u op %d elem %u model %u pub %u ttl %u period %u "
+			"transmit %u", err, addr, op, args.mod_pub_set.elem_addr,
+			args.mod_pub_set.mod_id, args.mod_pub_set.pub.addr,
+			args.mod_pub_set.pub.ttl, args.mod_pub_set.pub.period,
+			args.mod_pub_set.pub.transmit);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_node_cfg_txn(char *buf, size_t buf_len)
+{
+	int err;
+	size_t i;
+	size_t len;
+	cJSON *root;
+	struct cfg_txn txn;
+
+	memset(&txn, 0, sizeof(txn));
+	err = codec_parse_node_cfg_txn(request_parse(REQUEST(
+					"\"type\":\"node_configure_transaction\","
+					"\"address\":16,\"steps\":["
+					"{\"configuration\":\"appKeyBind\",\"elementAddress\":16,"
+					"\"modelId\":4096,\"appIndex\":0,"
+					"\"rollback\":{\"configuration\":\"appKeyUnbind\","
+					"\"elementAddress\":16,\"modelId\":4096,\"appIndex\":0}},"
+					"{\"configuration\":\"subscribeAddressAdd\","
+					"\"elementAddress\":16,\"modelId\":4096,"
+					"\"subscribeAddress\":49152}]"), &root), &txn);
+	len = snprintf(buf, buf_len, "err %d addr %u steps %zu", err, txn.addr, txn.step_count);
+
+	for (i = 0; i < txn.step_count && len < buf_len; i++) {
+		len += snprintf(&buf[len], buf_len - len, " [op %d rollback %d %d]",
+				txn.steps[i].op.op, txn.steps[i].has_rollback,
+				txn.steps[i].rollback.op);
+	}
+
+	k_free(txn.steps);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_prov_profile(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	char *steps = NULL;
+	struct prov_profile_info info;
+
+	memset(&info, 0, sizeof(info));
+	err = codec_parse_prov_profile(request_parse(REQUEST("\"type\":\"provision_profile_set\","
+					"\"name\":\"light\",\"match\":{\"uuidPrefix\":\"4df5fa\","
+					"\"companyId\":89,\"productId\":1},\"steps\":["
+					"{\"configuration\":\"appKeyBind\",\"modelId\":4096,"
+					"\"appIndex\":0},"
+					"{\"configuration\":\"subscribeAddressAdd\","
+					"\"elementIndex\":1,\"modelId\":4096,"
+					"\"subscribeAddress\":49152}]"), &root), &info, &steps);
+	snprintf(buf, buf_len, "err %d name %s prefix %u cid %d:%u pid %d:%u steps %s", err,
+			info.name, info.match.uuid_prefix_len, info.match.cid_set, info.match.cid,
+			info.match.pid_set, info.match.pid, steps ? steps : "-");
+	cJSON_free(steps);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_prov_allow(char *buf, size_t buf_len)
+{
+	int err;
+	size_t i;
+	size_t len;
+	size_t count = 0;
+	cJSON *root;
+	struct prov_allow_entry *entries = NULL;
+
+	err = codec_parse_prov_allow(request_parse(REQUEST("\"type\":\"provision_allowlist_add\","
+					"\"devices\":["
+					"{\"uuid\":\"4df5fa66d7eb44b98000000000000001\","
+					"\"netIndex\":0,\"elementCount\":2},"
+					"{\"uuidPrefix\":\"4df5fa66\",\"netIndex\":1,"
+					"\"elementCount\":1}]"), &root), &entries, &count);
+	len = snprintf(buf, buf_len, "err %d count %zu", err, count);
+
+	for (i = 0; i < count && len < buf_len; i++) {
+		len += snprintf(&buf[len], buf_len - len, " [prefix %u net %u elems %u]",
+				entries[i].uuid_prefix_len, entries[i].net_idx,
+				entries[i].elem_count);
+	}
+
+	k_free(entries);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_uplink_rules(char *buf, size_t buf_len)
+{
+	int err;
+	size_t i;
+	size_t len;
+	size_t count = 0;
+	cJSON *root;
+	struct uplink_rule *rules = NULL;
+
+	err = codec_parse_uplink_rules(request_parse(REQUEST("\"type\":\"uplink_rules_set\","
+					"\"rules\":["
+					"{\"action\":\"priority\",\"decode\":true,\"opcode\":33284,"
+					"\"sourceAddress\":2,\"sourceLastAddress\":16},"
+					"{\"action\":\"sample\",\"sampleRate\":10,"
+					"\"payloadPrefix\":\"0102\"},"
+					"{\"action\":\"drop\",\"destinationAddress\":49152,"
+					"\"destinationLastAddress\":49407,\"appIndex\":1}]"), &root),
+			&rules, &count);
+	len = snprintf(buf, buf_len, "err %d count %zu", err, count);
+
+	for (i = 0; i < count && len < buf_len; i++) {
+		len += snprintf(&buf[len], buf_len - len, " [match %u action %u flags %u]",
+				rules[i].match, rules[i].action, rules[i].flags);
+	}
+
+	k_free(rules);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_subscribe(char *buf, size_t buf_len)
+{
+	int err;
+	size_t i;
+	size_t len;
+	size_t count = 0;
+	cJSON *root;
+	struct sub_range *ranges = NULL;
+
+	err = codec_parse_subscribe_addrs(request_parse(REQUEST("\"type\":\"subscribe\","
+					"\"addressList\":[{\"address\":49152},"
+					"{\"address\":49168,\"lastAddress\":49183},"
+					"{\"allGroups\":true}]"), &root), &ranges, &count);
+	len = snprintf(buf, buf_len, "err %d count %zu", err, count);
+
+	for (i = 0; i < count && len < buf_len; i++) {
+		len += snprintf(&buf[len], buf_len - len, " %04x-%04x", ranges[i].first,
+				ranges[i].last);
+	}
+
+	k_free(ranges);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_model_msg(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	struct bt_mesh_msg_ctx ctx;
+	NET_BUF_SIMPLE_DEFINE(msg, 32);
+
+	memset(&ctx, 0, sizeof(ctx));
+	err = codec_parse_model_msg(request_parse(REQUEST("\"type\":\"send_model_message\","
+					"\"netIndex\":0,\"appIndex\":0,\"address\":16,"
+					"\"opcode\":33282,\"payload\":[{\"byte\":1},{\"byte\":0}]"),
+				&root), &ctx, &msg);
+	snprintf(buf, buf_len, "err %d net %u app %u addr %u len %u", err, ctx.net_idx,
+			ctx.app_idx, ctx.addr, msg.len);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_hlth_fault_test(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	uint16_t addr = 0;
+	uint16_t app_idx = 0;
+	uint16_t cid = 0;
+	uint8_t test_id = 0;
+
+	err = codec_parse_hlth_fault_test(request_parse(REQUEST("\"type\":\"health_fault_test\","
+					"\"address\":16,\"appIndex\":0,\"companyId\":89,"
+					"\"testId\":1"), &root), &addr, &app_idx, &cid, &test_id);
+	snprintf(buf, buf_len, "err %d addr %u app %u cid %u test %u", err, addr, app_idx, cid,
+			test_id);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_hlth_period_set(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	uint16_t addr = 0;
+	uint16_t app_idx = 0;
+	uint8_t div = 0;
+
+	err = codec_parse_hlth_period_set(request_parse(REQUEST("\"type\":\"health_period_set\","
+					"\"address\":16,\"appIndex\":0,\"divisor\":3"), &root),
+			&addr, &app_idx, &div);
+	snprintf(buf, buf_len, "err %d addr %u app %u div %u", err, addr, app_idx, div);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_hlth_attn_set(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	uint16_t addr = 0;
+	uint16_t app_idx = 0;
+	uint8_t attn = 0;
+
+	err = codec_parse_hlth_attn_set(request_parse(REQUEST("\"type\":\"health_attention_set\","
+					"\"address\":16,\"appIndex\":0,\"attention\":5"), &root),
+			&addr, &app_idx, &attn);
+	snprintf(buf, buf_len, "err %d addr %u app %u attn %u", err, addr, app_idx, attn);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_hlth_timeout(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	int32_t timeout = 0;
+
+	err = codec_parse_hlth_timeout(request_parse(REQUEST(
+					"\"type\":\"health_client_timeout_set\","
+					"\"timeout\":10000"), &root), &timeout);
+	snprintf(buf, buf_len, "err %d timeout %d", err, timeout);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_mesh_stats(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	bool reset = false;
+
+	err = codec_parse_mesh_stats(request_parse(REQUEST("\"type\":\"mesh_stats_request\","
+					"\"reset\":true"), &root), &reset);
+	snprintf(buf, buf_len, "err %d reset %d", err, reset);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_sweep_start(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	struct sweep_params params;
+
+	memset(&params, 0, sizeof(params));
+	err = codec_parse_sweep_start(request_parse(REQUEST("\"type\":\"node_sweep_start\","
+					"\"concurrency\":4,\"interval\":500,"
+					"\"maximumLatency\":2000,\"maximumQueueDepth\":8,"
+					"\"refresh\":true"), &root), &params);
+	snprintf(buf, buf_len, "err %d concurrency %u interval %u latency %u queue %u refresh %d",
+			err, params.concurrency, params.interval_ms, params.max_latency_ms,
+			params.max_queue, params.refresh);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_fanout(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	struct fanout_req req;
+
+	memset(&req, 0, sizeof(req));
+	err = codec_parse_node_cfg_fanout(request_parse(REQUEST(
+					"\"type\":\"node_configure_fanout\","
+					"\"configuration\":\"subscribeAddressAdd\","
+					"\"modelId\":4096,\"subscribeAddress\":49152,"
+					"\"concurrency\":4,\"addressList\":[{\"address\":16},"
+					"{\"address\":18},{\"address\":20}],"
+					"\"filter\":{\"netIndex\":0,\"modelId\":4096,"
+					"\"companyId\":89}"), &root), &req);
+	snprintf(buf, buf_len, "err %d op %d nodes %zu concurrency %u filter %d%d%d", err, req.op,
+			req.addr_count, req.concurrency, req.filter.net_idx_set,
+			req.filter.model_id_set, req.filter.company_id_set);
+	k_free(req.addrs);
+	cJSON_Delete(root);
+	return err;
+}
+
+static int parse_reconcile_state(char *buf, size_t buf_len)
+{
+	int err;
+	cJSON *root;
+	uint16_t *addrs = NULL;
+	size_t addr_count = 0;
+	struct reconcile_state state;
+
+	memset(&state, 0, sizeof(state));
+	err = codec_parse_reconcile_state(request_parse(REQUEST(
+					"\"type\":\"node_desired_state_set\",\"name\":\"lights\","
+					"\"addressList\":[{\"address\":16},{\"address\":18}],"
+					"\"desiredState\":{\"networkBeaconState\":true,"
+					"\"timeToLive\":7,\"relayFeature\":{\"state\":true,"
+					"\"retransmitCount\":2,\"retransmitInterval\":20},"
+					"\"proxyFeature\":{\"state\":false},"
+					"\"friendFeature\":{\"state\":true},\"subnets\":[0,1],"
+					"\"models\":[{\"elementIndex\":0,\"modelId\":4096,"
+					"\"appIndexes\":[0],\"subscribeAddresses\":[49152,49153],"
+					"\"publishParameters\":{\"address\":49152,\"appIndex\":0,"
+					"\"friendCredentialFlag\":false,\"timeToLive\":7,"
+					"\"period\":10,\"periodUnits\":\"1s\","
+					"\"retransmitCount\":2,\"retransmitInterval\":20}}]}"),
+				&root), &state, &addrs, &addr_count);
+	snprintf(buf, buf_len, "err %d name %s nodes %zu ttl %d:%u relay %d:%d:%u subnets %zu "
+			"models %zu", err, state.name, addr_count, state.ttl_set, state.ttl,
+			state.relay_set, state.relay, state.relay_transmit, state.subnet_count,
+			state.model_count);
+	k_free(state.models);
+	k_free(addrs);
+	cJSON_Delete(root);
+	return err;
+}
+
+static const struct bench_case cases[] = {
+	{ "beacon_list", beacon_list },
+	{ "beacon_found", beacon_found },
+	{ "beacon_lost", beacon_lost },
+	{ "beacon_block_result", beacon_block_result },
+	{ "beacon_blocklist", beacon_blocklist },
+	{ "prov_result", prov_result },
+	{ "prov_queue_status", prov_queue_status },
+	{ "subnet_list", subnet_list },
+	{ "app_key_list", app_key_list },
+	{ "node_list", node_list },
+	{ "node_discover", node_disc },
+	{ "node_configure", node_cfg },
+	{ "node_configure_transaction", node_cfg_txn },
+	{ "node_ready", node_ready },
+	{ "provision_profile_list", prov_profile_list },
+	{ "provision_allowlist", prov_allow_list },
+	{ "uplink_rules", uplink_rules },
+	{ "subscribe_list", subscribe_list },
+	{ "model_message", model_msg_raw },
+	{ "model_message_sensor", model_msg_decoded },
+	{ "model_message_values", model_msg_values },
+	{ "health_faults_current", hlth_faults_cur },
+	{ "health_faults_registered", hlth_faults_reg },
+	{ "health_period", hlth_period },
+	{ "health_attention", hlth_attn },
+	{ "health_client_timeout", hlth_timeout },
+	{ "mesh_stats", mesh_stats },
+	{ "node_sweep_progress", sweep_progress },
+	{ "node_configure_fanout_node", fanout_node },
+	{ "node_configure_fanout_progress", fanout_progress },
+	{ "node_desired_state_status", reconcile_status },
+	{ "parse_beacon_request", parse_beacon_request },
+	{ "parse_beacon_events_set", parse_beacon_events },
+	{ "parse_beacon_block", parse_beacon_block },
+	{ "parse_provision", parse_prov },
+	{ "parse_provision_bulk", parse_prov_bulk },
+	{ "parse_subnet_add", parse_subnet_add },
+	{ "parse_app_key_add", parse_app_key_add },
+	{ "parse_node_discover", parse_node_disc },
+	{ "parse_node_configure", parse_node_cfg },
+	{ "parse_node_configure_transaction", parse_node_cfg_txn },
+	{ "parse_provision_profile_set", parse_prov_profile },
+	{ "parse_provision_allowlist_add", parse_prov_allow },
+	{ "parse_uplink_rules_set", parse_uplink_rules },
+	{ "parse_subscribe", parse_subscribe },
+	{ "parse_send_model_message", parse_model_msg },
+	{ "parse_health_fault_test", parse_hlth_fault_test },
+	{ "parse_health_period_set", parse_hlth_period_set },
+	{ "parse_health_attention_set", parse_hlth_attn_set },
+	{ "parse_health_client_timeout_set", parse_hlth_timeout },
+	{ "parse_mesh_stats_request", parse_mesh_stats },
+	{ "parse_node_sweep_start", parse_sweep_start },
+	{ "parse_node_configure_fanout", parse_fanout },
+	{ "parse_node_desired_state_set", parse_reconcile_state },
+};
+
+static char outputs[ARRAY_SIZE(cases)][BUF_LEN];
+static struct bench_result results[ARRAY_SIZE(cases)];
+
+/* Golden output has one message type per line, the name followed by a tab and the output with
+ * its line breaks escaped */
+static int golden_check(const char *path)
+{
+	FILE *f;
+	size_t i;
+	int failed;
+	char *tab;
+	char *nl;
+	static char line[2 * BUF_LEN];
+
+	f = fopen(path, "r");
+
+	if (f == NULL) {
+		fprintf(stderr, "Cannot open golden output %s\n", path);
+		return -ENOENT;
+	}
+
+	failed = 0;
+	i = 0;
+
+	while (fgets(line, sizeof(line), f) != NULL) {
+		nl = strchr(line, '\n');
+
+		if (nl != NULL) {
+			*nl = '\0';
+		}
+
+		tab = strchr(line, '\t');
+
+		if (tab == NULL) {
+			continue;
+		}
+
+		*tab++ = '\0';
+
+		if (i >= ARRAY_SIZE(cases) || strcmp(line, cases[i].name)) {
+			fprintf(stderr, "Golden output has %s, expected %s\n", line,
+					i < ARRAY_SIZE(cases) ? cases[i].name : "nothing");
+			failed = 1;
+			break;
+		}
+
+		if (strcmp(tab, outputs[i])) {
+			fprintf(stderr, "%s: output differs\n  expected: %s\n  got:      %s\n",
+					cases[i].name, tab, outputs[i]);
+			failed = 1;
+		}
+
+		i++;
+	}
+
+	fclose(f);
+
+	if (!failed && i != ARRAY_SIZE(cases)) {
+		fprintf(stderr, "Golden output has %zu of %zu message types\n", i,
+				ARRAY_SIZE(cases));
+		failed = 1;
+	}
+
+	return failed ? -EINVAL : 0;
+}
+
+static int golden_write(const char *path)
+{
+	FILE *f;
+	size_t i;
+
+	f = fopen(path, "w");
+
+	if (f == NULL) {
+		fprintf(stderr, "Cannot write golden output %s\n", path);
+		return -EIO;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(cases); i++) {
+		fprintf(f, "%s\t%s\n", cases[i].name, outputs[i]);
+	}
+
+	fclose(f);
+	return 0;
+}
+
+static bool regressed(const char *name, const char *metric, double value, double baseline,
+		int threshold)
+{
+	if (baseline <= 0 || value <= baseline * (100 + threshold) / 100) {
+		return false;
+	}
+
+	fprintf(stderr, "%s: %s/op %.1f is over the baseline %.1f by more than %d%%\n", name,
+			metric, value, baseline, threshold);
+	return true;
+}
+
+/* Baseline has one message type per line: name, ns/op, allocs/op and bytes/op. A time of 0
+ * skips the time comparison. */
+static int baseline_check(const char *path, int threshold)
+{
+	FILE *f;
+	size_t i;
+	int failed;
+	struct bench_result base;
+
+	f = fopen(path, "r");
+
+	if (f == NULL) {
+		fprintf(stderr, "Cannot open baseline %s\n", path);
+		return -ENOENT;
+	}
+
+	failed = 0;
+
+	while (fscanf(f, "%39s %lf %lf %lf", base.name, &base.ns, &base.allocs,
+				&base.bytes) == 4) {
+		for (i = 0; i < ARRAY_SIZE(cases); i++) {
+			if (!strcmp(base.name, results[i].name)) {
+				break;
+			}
+		}
+
+		if (i == ARRAY_SIZE(cases)) {
+			continue;
+		}
+
+		failed |= regressed(base.name, "ns", results[i].ns, base.ns, threshold);
+		failed |= regressed(base.name, "allocs", results[i].allocs, base.allocs,
+				threshold);
+		failed |= regressed(base.name, "bytes", results[i].bytes, base.bytes, threshold);
+	}
+
+	fclose(f);
+	return failed ? -EINVAL : 0;
+}
+
+static int baseline_write(const char *path)
+{
+	FILE *f;
+	size_t i;
+
+	f = fopen(path, "w");
+
+	if (f == NULL) {
+		fprintf(stderr, "Cannot write baseline %s\n", path);
+		return -EIO;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(cases); i++) {
+		fprintf(f, "%s %.0f %.1f %.1f\n", results[i].name, results[i].ns,
+				results[i].allocs, results[i].bytes);
+	}
+
+	fclose(f);
+	return 0;
+}
+
+static void escape_newlines(char *buf)
+{
+	char *nl;
+
+	/* Paged lists are one message per line, joined with a literal \n */
+	while ((nl = strchr(buf, '\n')) != NULL) {
+		memmove(nl + 2, nl + 1, strlen(nl + 1) + 1);
+		nl[0] = '\\';
+		nl[1] = 'n';
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int opt;
+	int err;
+	int failed;
+	size_t i;
+	long n;
+	long iterations = 1000;
+	int threshold = 10;
+	bool update = false;
+	const char *golden = NULL;
+	const char *baseline = NULL;
+	uint64_t start;
+	struct host_alloc_stats alloc;
+	static char buf[BUF_LEN];
+
+	while ((opt = getopt(argc, argv, "n:g:b:t:u")) != -1) {
+		switch (opt) {
+		case 'n':
+			iterations = strtol(optarg, NULL, 0);
+			break;
+		case 'g':
+			golden = optarg;
+			break;
+		case 'b':
+			baseline = optarg;
+			break;
+		case 't':
+			threshold = strtol(optarg, NULL, 0);
+			break;
+		case 'u':
+			update = true;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-n iterations] [-g golden] [-b baseline] "
+					"[-t percent] [-u]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (iterations < 1) {
+		iterations = 1;
+	}
+
+	host_alloc_hooks();
+	failed = 0;
+
+	/* Outputs first, in a fixed order, so message IDs are the same on every run */
+	for (i = 0; i < ARRAY_SIZE(cases); i++) {
+		err = cases[i].run(outputs[i], BUF_LEN - BUF_LEN / 4);
+
+		if (err) {
+			fprintf(stderr, "%s failed: %d\n", cases[i].name, err);
+			failed = 1;
+		}
+
+		escape_newlines(outputs[i]);
+	}
+
+	printf("%-34s %12s %10s %10s\n", "message", "ns/op", "allocs/op", "bytes/op");
+
+	for (i = 0; i < ARRAY_SIZE(cases); i++) {
+		alloc = host_alloc;
+		start = host_time_ns();
+
+		for (n = 0; n < iterations; n++) {
+			cases[i].run(buf, BUF_LEN - BUF_LEN / 4);
+		}
+
+		snprintf(results[i].name, sizeof(results[i].name), "%s", cases[i].name);
+		results[i].ns = (double)(host_time_ns() - start) / iterations;
+		results[i].allocs = (double)(host_alloc.count - alloc.count) / iterations;
+		results[i].bytes = (double)(host_alloc.bytes - alloc.bytes) / iterations;
+
+		printf("%-34s %12.0f %10.1f %10.1f\n", results[i].name, results[i].ns,
+				results[i].allocs, results[i].bytes);
+	}
+
+	if (update) {
+		if ((golden && golden_write(golden)) || (baseline && baseline_write(baseline))) {
+			failed = 1;
+		}
+
+		return failed;
+	}
+
+	if (golden && golden_check(golden)) {
+		failed = 1;
+	}
+
+	if (baseline && baseline_check(baseline, threshold)) {
+		failed = 1;
+	}
+
+	return failed;
+}
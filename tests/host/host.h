@@ -0,0 +1,32 @@
+#ifndef HOST_H_
+#define HOST_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Heap use since start, by k_malloc() and by cJSON once host_alloc_hooks() is installed */
+struct host_alloc_stats {
+	uint64_t count;
+	uint64_t bytes;
+};
+
+extern struct host_alloc_stats host_alloc;
+
+/* Route cJSON allocations through the counted heap */
+void host_alloc_hooks(void);
+
+/* Monotonic time in nanoseconds */
+uint64_t host_time_ns(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* HOST_H_ */
@@ -0,0 +1,39 @@
+#ifndef HOST_AUTOCONF_H_
+#define HOST_AUTOCONF_H_
+
+/* Kconfig values for the host build, from prj.conf and the Kconfig defaults. Every message
+ * type is enabled so all of them can be measured. */
+
+#define CONFIG_BT_MESH_SUBNET_COUNT 5
+#define CONFIG_BT_MESH_APP_KEY_COUNT 5
+#define CONFIG_BT_MESH_MODEL_GROUP_COUNT 5
+#define CONFIG_BT_MESH_CDB_NODE_COUNT 10
+#define CONFIG_BT_MESH_CDB_SUBNET_COUNT 5
+#define CONFIG_BT_MESH_CDB_APP_KEY_COUNT 5
+
+#define CONFIG_NRF_CLOUD_MESH_GATEWAY_LOG_LEVEL 0
+
+#define CONFIG_GATEWAY_BEACON_EVENTS 1
+#define CONFIG_GATEWAY_BEACON_EVENTS_BATCH 16
+#define CONFIG_GATEWAY_CFG_CLI_TIMEOUT_MS 5000
+#define CONFIG_GATEWAY_CFG_TXN_MAX_STEPS 16
+#define CONFIG_GATEWAY_CODEC_STATS 1
+#define CONFIG_GATEWAY_CODEC_STATS_WARN_US 0
+#define CONFIG_GATEWAY_FANOUT 1
+#define CONFIG_GATEWAY_FANOUT_WORKERS 4
+#define CONFIG_GATEWAY_MESH_RTO_INIT_MS 5000
+#define CONFIG_GATEWAY_MODEL_DECODE 1
+#define CONFIG_GATEWAY_PAGE_SIZE 2048
+#define CONFIG_GATEWAY_PROV_ALLOWLIST 1
+#define CONFIG_GATEWAY_PROV_ALLOWLIST_WINDOW_MS 2000
+#define CONFIG_GATEWAY_PROV_PROFILE 1
+#define CONFIG_GATEWAY_RECONCILE 1
+#define CONFIG_GATEWAY_RECONCILE_MAX_NODES 128
+#define CONFIG_GATEWAY_RECONCILE_REPORT_MAX 8
+#define CONFIG_GATEWAY_RX_BUS_PAYLOAD_MAX 64
+#define CONFIG_GATEWAY_SWEEP 1
+#define CONFIG_GATEWAY_UPLINK_COMPRESSION 1
+#define CONFIG_GATEWAY_UPLINK_COMPRESSION_DICT_SIZE 1024
+#define CONFIG_GATEWAY_UPLINK_RULES 1
+
+#endif /* HOST_AUTOCONF_H_ */
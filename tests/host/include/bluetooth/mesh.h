@@ -0,0 +1,139 @@
+#ifndef HOST_BLUETOOTH_MESH_H_
+#define HOST_BLUETOOTH_MESH_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The mesh types, constants and configuration database used by the codec. The database is
+ * filled in by the benchmark. */
+
+#include <zephyr.h>
+
+#define BT_MESH_ADDR_UNASSIGNED 0x0000
+#define BT_MESH_ADDR_IS_UNICAST(addr) ((addr) && (addr) < 0x8000)
+
+#define BT_MESH_KEY_UNUSED 0xffff
+#define BT_MESH_CID_NVAL 0xffff
+
+#define BT_MESH_FEAT_RELAY BIT(0)
+#define BT_MESH_FEAT_PROXY BIT(1)
+#define BT_MESH_FEAT_FRIEND BIT(2)
+#define BT_MESH_FEAT_LOW_POWER BIT(3)
+
+#define BT_MESH_BEACON_ENABLED 0x01
+#define BT_MESH_GATT_PROXY_ENABLED 0x01
+#define BT_MESH_FRIEND_ENABLED 0x01
+#define BT_MESH_RELAY_ENABLED 0x01
+
+#define BT_MESH_TRANSMIT(count, int_ms) ((count) | ((((int_ms) / 10) - 1) << 3))
+#define BT_MESH_TRANSMIT_COUNT(transmit) (((transmit) & (uint8_t)BIT_MASK(3)))
+#define BT_MESH_TRANSMIT_INT(transmit) ((((transmit) >> 3) + 1) * 10)
+
+#define BT_MESH_PUB_PERIOD_100MS(steps) ((uint8_t)(steps) & BIT_MASK(6))
+#define BT_MESH_PUB_PERIOD_SEC(steps) (((uint8_t)(steps) & BIT_MASK(6)) | (1 << 6))
+#define BT_MESH_PUB_PERIOD_10SEC(steps) (((uint8_t)(steps) & BIT_MASK(6)) | (2 << 6))
+#define BT_MESH_PUB_PERIOD_10MIN(steps) (((uint8_t)(steps) & BIT_MASK(6)) | (3 << 6))
+
+typedef enum {
+	BT_MESH_PROV_OOB_OTHER = BIT(0),
+	BT_MESH_PROV_OOB_URI = BIT(1),
+} bt_mesh_prov_oob_info_t;
+
+struct bt_mesh_msg_ctx {
+	uint16_t net_idx;
+	uint16_t app_idx;
+	uint16_t addr;
+	uint16_t recv_dst;
+	int8_t recv_rssi;
+	uint8_t recv_ttl;
+	bool send_rel;
+	uint8_t send_ttl;
+};
+
+struct bt_mesh_cfg_mod_pub {
+	uint16_t addr;
+	const uint8_t *uuid;
+	bool cred_flag;
+	uint16_t app_idx;
+	uint8_t ttl;
+	uint8_t period;
+	uint8_t transmit;
+};
+
+struct bt_mesh_cfg_hb_sub {
+	uint16_t src;
+	uint16_t dst;
+	uint8_t period;
+	uint8_t count;
+	uint8_t min;
+	uint8_t max;
+};
+
+struct bt_mesh_cfg_hb_pub {
+	uint16_t dst;
+	uint8_t count;
+	uint8_t period;
+	uint8_t ttl;
+	uint16_t feat;
+	uint16_t net_idx;
+};
+
+struct bt_mesh_cdb_node {
+	uint8_t uuid[16];
+	uint16_t addr;
+	uint16_t net_idx;
+	uint8_t num_elem;
+	uint8_t dev_key[16];
+};
+
+struct bt_mesh_cdb_subnet {
+	uint16_t net_idx;
+	bool kr_flag;
+	uint8_t kr_phase;
+	struct {
+		uint8_t net_key[16];
+	} keys[2];
+};
+
+struct bt_mesh_cdb_app_key {
+	uint16_t net_idx;
+	uint16_t app_idx;
+	struct {
+		uint8_t app_key[16];
+	} keys[2];
+};
+
+#define SUBNET_COUNT CONFIG_BT_MESH_CDB_SUBNET_COUNT
+#define APP_KEY_COUNT CONFIG_BT_MESH_CDB_APP_KEY_COUNT
+
+struct bt_mesh_cdb {
+	uint32_t iv_index;
+	struct bt_mesh_cdb_node nodes[CONFIG_BT_MESH_CDB_NODE_COUNT];
+	struct bt_mesh_cdb_subnet subnets[CONFIG_BT_MESH_CDB_SUBNET_COUNT];
+	struct bt_mesh_cdb_app_key app_keys[CONFIG_BT_MESH_CDB_APP_KEY_COUNT];
+};
+
+extern struct bt_mesh_cdb bt_mesh_cdb;
+
+enum {
+	BT_MESH_CDB_ITER_STOP = 0,
+	BT_MESH_CDB_ITER_CONTINUE,
+};
+
+typedef uint8_t (*bt_mesh_cdb_node_func_t)(struct bt_mesh_cdb_node *node, void *user_data);
+
+void bt_mesh_cdb_node_foreach(bt_mesh_cdb_node_func_t func, void *user_data);
+
+struct bt_mesh_cdb_subnet *bt_mesh_cdb_subnet_get(uint16_t net_idx);
+
+struct bt_mesh_cdb_app_key *bt_mesh_cdb_app_key_get(uint16_t app_idx);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* HOST_BLUETOOTH_MESH_H_ */
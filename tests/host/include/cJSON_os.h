@@ -0,0 +1,11 @@
+#ifndef HOST_CJSON_OS_H_
+#define HOST_CJSON_OS_H_
+
+#include <cJSON.h>
+
+static inline void cJSON_Init(void)
+{
+	cJSON_InitHooks(NULL);
+}
+
+#endif /* HOST_CJSON_OS_H_ */
@@ -0,0 +1,29 @@
+#ifndef HOST_LOGGING_LOG_H_
+#define HOST_LOGGING_LOG_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Logging is discarded on the host, the arguments are still evaluated and type checked */
+static inline __attribute__((format(printf, 1, 2))) void log_discard(const char *fmt, ...)
+{
+}
+
+#define LOG_MODULE_REGISTER(...)
+#define LOG_MODULE_DECLARE(...)
+#define LOG_ERR(...) log_discard(__VA_ARGS__)
+#define LOG_WRN(...) log_discard(__VA_ARGS__)
+#define LOG_INF(...) log_discard(__VA_ARGS__)
+#define LOG_DBG(...) log_discard(__VA_ARGS__)
+#define LOG_HEXDUMP_DBG(...)
+#define log_strdup(str) (str)
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* HOST_LOGGING_LOG_H_ */
@@ -0,0 +1,6 @@
+#ifndef HOST_POSIX_TIME_H_
+#define HOST_POSIX_TIME_H_
+
+#include <time.h>
+
+#endif /* HOST_POSIX_TIME_H_ */
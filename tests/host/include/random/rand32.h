@@ -0,0 +1,11 @@
+#ifndef HOST_RANDOM_RAND32_H_
+#define HOST_RANDOM_RAND32_H_
+
+#include <stdint.h>
+
+static inline uint32_t sys_rand32_get(void)
+{
+	return 4;
+}
+
+#endif /* HOST_RANDOM_RAND32_H_ */
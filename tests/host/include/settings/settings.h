@@ -0,0 +1,37 @@
+#ifndef HOST_SETTINGS_SETTINGS_H_
+#define HOST_SETTINGS_SETTINGS_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/* Nothing is persisted on the host */
+
+typedef ssize_t (*settings_read_cb)(void *cb_arg, void *data, size_t len);
+
+#define SETTINGS_STATIC_HANDLER_DEFINE(_hname, _tree, _get, _set, _commit, _export) \
+	const struct { \
+		int (*h_set)(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg); \
+	} settings_handler_##_hname = { .h_set = _set }
+
+static inline int settings_save_one(const char *name, const void *value, size_t val_len)
+{
+	return 0;
+}
+
+static inline int settings_delete(const char *name)
+{
+	return 0;
+}
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* HOST_SETTINGS_SETTINGS_H_ */
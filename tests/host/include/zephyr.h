@@ -0,0 +1,168 @@
+#ifndef HOST_ZEPHYR_H_
+#define HOST_ZEPHYR_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The part of the kernel API used by the modules built on the host. The benchmark runs on a
+ * single thread, so locks do nothing and work items run when submitted. */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BUILD_ASSERT(x) _Static_assert(x, #x)
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
+#define BIT(n) (1UL << (n))
+#define BIT_MASK(n) (BIT(n) - 1UL)
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define DIV_ROUND_UP(n, d) (((n) + (d) - 1) / (d))
+#define CONTAINER_OF(ptr, type, field) ((type *)(((char *)(ptr)) - offsetof(type, field)))
+#define MSEC_PER_SEC 1000
+#define USEC_PER_SEC 1000000
+
+#define snprintk snprintf
+
+typedef struct {
+	int64_t ms;
+} k_timeout_t;
+
+#define K_NO_WAIT ((k_timeout_t){ 0 })
+#define K_FOREVER ((k_timeout_t){ -1 })
+#define K_MSEC(ms) ((k_timeout_t){ (ms) })
+#define K_SECONDS(s) K_MSEC((s) * MSEC_PER_SEC)
+
+struct k_mutex {
+	int unused;
+};
+
+#define K_MUTEX_DEFINE(name) struct k_mutex name
+
+static inline int k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
+{
+	return 0;
+}
+
+static inline int k_mutex_unlock(struct k_mutex *mutex)
+{
+	return 0;
+}
+
+struct k_spinlock {
+	int unused;
+};
+
+typedef int k_spinlock_key_t;
+
+static inline k_spinlock_key_t k_spin_lock(struct k_spinlock *lock)
+{
+	return 0;
+}
+
+static inline void k_spin_unlock(struct k_spinlock *lock, k_spinlock_key_t key)
+{
+}
+
+struct k_work;
+typedef void (*k_work_handler_t)(struct k_work *work);
+
+struct k_work {
+	k_work_handler_t handler;
+};
+
+struct k_work_q {
+	int unused;
+};
+
+#define K_WORK_DEFINE(name, work_handler) struct k_work name = { .handler = work_handler }
+
+static inline int k_work_submit(struct k_work *work)
+{
+	work->handler(work);
+	return 0;
+}
+
+typedef long atomic_t;
+typedef long atomic_val_t;
+
+static inline atomic_val_t atomic_get(const atomic_t *target)
+{
+	return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_set(atomic_t *target, atomic_val_t value)
+{
+	return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_clear(atomic_t *target)
+{
+	return atomic_set(target, 0);
+}
+
+static inline atomic_val_t atomic_add(atomic_t *target, atomic_val_t value)
+{
+	return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_inc(atomic_t *target)
+{
+	return atomic_add(target, 1);
+}
+
+/* Uptime is fixed so encoded timestamps are the same on every run */
+static inline int64_t k_uptime_get(void)
+{
+	return 0;
+}
+
+/* One cycle per microsecond */
+uint32_t k_cycle_get_32(void);
+
+static inline uint32_t k_cyc_to_us_floor32(uint32_t cycles)
+{
+	return cycles;
+}
+
+/* Counted by the benchmark, see host.h */
+void *k_malloc(size_t size);
+void *k_calloc(size_t nmemb, size_t size);
+void k_free(void *ptr);
+
+struct net_buf_simple {
+	uint8_t *data;
+	uint16_t len;
+	uint16_t size;
+	uint8_t *__buf;
+};
+
+#define NET_BUF_SIMPLE_DEFINE(name, buf_size) \
+	uint8_t net_buf_data_##name[buf_size]; \
+	struct net_buf_simple name = { \
+		.data = net_buf_data_##name, \
+		.len = 0, \
+		.size = buf_size, \
+		.__buf = net_buf_data_##name, \
+	}
+
+void net_buf_simple_reset(struct net_buf_simple *buf);
+void *net_buf_simple_add(struct net_buf_simple *buf, size_t len);
+void *net_buf_simple_add_mem(struct net_buf_simple *buf, const void *mem, size_t len);
+void net_buf_simple_add_u8(struct net_buf_simple *buf, uint8_t val);
+void net_buf_simple_add_le16(struct net_buf_simple *buf, uint16_t val);
+void net_buf_simple_add_be16(struct net_buf_simple *buf, uint16_t val);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* HOST_ZEPHYR_H_ */
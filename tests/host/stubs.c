@@ -0,0 +1,540 @@
+/* Kernel, mesh stack and gateway module stand-ins for the host benchmark. Every accessor the
+ * codec calls returns the same fixed data on every run, so the encoded messages can be compared
+ * against the golden output. */
+
+#include <zephyr.h>
+#include <string.h>
+#include <time.h>
+#include <cJSON.h>
+#include <bluetooth/mesh.h>
+
+#include "host.h"
+#include "beacon_block.h"
+#include "beacon_table.h"
+#include "btmesh.h"
+#include "cfg_txn.h"
+#include "compress.h"
+#include "fanout.h"
+#include "gw_cloud.h"
+#include "mesh_retry.h"
+#include "prov_allow.h"
+#include "prov_profile.h"
+#include "reconcile.h"
+#include "sub_set.h"
+#include "sweep.h"
+#include "uplink_rules.h"
+
+struct host_alloc_stats host_alloc;
+
+void *k_malloc(size_t size)
+{
+	host_alloc.count++;
+	host_alloc.bytes += size;
+	return malloc(size);
+}
+
+void *k_calloc(size_t nmemb, size_t size)
+{
+	host_alloc.count++;
+	host_alloc.bytes += nmemb * size;
+	return calloc(nmemb, size);
+}
+
+void k_free(void *ptr)
+{
+	free(ptr);
+}
+
+void host_alloc_hooks(void)
+{
+	cJSON_Hooks hooks = {
+		.malloc_fn = k_malloc,
+		.free_fn = k_free,
+	};
+
+	cJSON_InitHooks(&hooks);
+}
+
+uint64_t host_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+uint32_t k_cycle_get_32(void)
+{
+	return (uint32_t)(host_time_ns() / 1000);
+}
+
+void net_buf_simple_reset(struct net_buf_simple *buf)
+{
+	buf->len = 0;
+	buf->data = buf->__buf;
+}
+
+void *net_buf_simple_add(struct net_buf_simple *buf, size_t len)
+{
+	uint8_t *tail = buf->data + buf->len;
+
+	if (buf->len + len > buf->size) {
+		abort();
+	}
+
+	buf->len += len;
+	return tail;
+}
+
+void *net_buf_simple_add_mem(struct net_buf_simple *buf, const void *mem, size_t len)
+{
+	return memcpy(net_buf_simple_add(buf, len), mem, len);
+}
+
+void net_buf_simple_add_u8(struct net_buf_simple *buf, uint8_t val)
+{
+	*(uint8_t *)net_buf_simple_add(buf, 1) = val;
+}
+
+void net_buf_simple_add_le16(struct net_buf_simple *buf, uint16_t val)
+{
+	uint8_t *dst = net_buf_simple_add(buf, 2);
+
+	dst[0] = val;
+	dst[1] = val >> 8;
+}
+
+void net_buf_simple_add_be16(struct net_buf_simple *buf, uint16_t val)
+{
+	uint8_t *dst = net_buf_simple_add(buf, 2);
+
+	dst[0] = val >> 8;
+	dst[1] = val;
+}
+
+/* Two subnets, two application keys and four nodes, the rest of the database is unused */
+struct bt_mesh_cdb bt_mesh_cdb;
+
+static void cdb_init(void)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(bt_mesh_cdb.subnets); i++) {
+		bt_mesh_cdb.subnets[i].net_idx = BT_MESH_KEY_UNUSED;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(bt_mesh_cdb.app_keys); i++) {
+		bt_mesh_cdb.app_keys[i].net_idx = BT_MESH_KEY_UNUSED;
+		bt_mesh_cdb.app_keys[i].app_idx = BT_MESH_KEY_UNUSED;
+	}
+
+	bt_mesh_cdb.subnets[0].net_idx = 0x0000;
+	bt_mesh_cdb.subnets[1].net_idx = 0x0001;
+	bt_mesh_cdb.app_keys[0].net_idx = 0x0000;
+	bt_mesh_cdb.app_keys[0].app_idx = 0x0000;
+	bt_mesh_cdb.app_keys[1].net_idx = 0x0001;
+	bt_mesh_cdb.app_keys[1].app_idx = 0x0001;
+
+	for (i = 0; i < 4; i++) {
+		memset(bt_mesh_cdb.nodes[i].uuid, 0xa0 + i, sizeof(bt_mesh_cdb.nodes[i].uuid));
+		bt_mesh_cdb.nodes[i].addr = 0x0002 + 2 * i;
+		bt_mesh_cdb.nodes[i].net_idx = 0x0000;
+		bt_mesh_cdb.nodes[i].num_elem = 2;
+	}
+}
+
+void bt_mesh_cdb_node_foreach(bt_mesh_cdb_node_func_t func, void *user_data)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(bt_mesh_cdb.nodes); i++) {
+		if (bt_mesh_cdb.nodes[i].addr == BT_MESH_ADDR_UNASSIGNED) {
+			continue;
+		}
+
+		if (func(&bt_mesh_cdb.nodes[i], user_data) == BT_MESH_CDB_ITER_STOP) {
+			return;
+		}
+	}
+}
+
+struct bt_mesh_cdb_subnet *bt_mesh_cdb_subnet_get(uint16_t net_idx)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(bt_mesh_cdb.subnets); i++) {
+		if (bt_mesh_cdb.subnets[i].net_idx == net_idx) {
+			return &bt_mesh_cdb.subnets[i];
+		}
+	}
+
+	return NULL;
+}
+
+struct bt_mesh_cdb_app_key *bt_mesh_cdb_app_key_get(uint16_t app_idx)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(bt_mesh_cdb.app_keys); i++) {
+		if (bt_mesh_cdb.app_keys[i].net_idx != BT_MESH_KEY_UNUSED &&
+				bt_mesh_cdb.app_keys[i].app_idx == app_idx) {
+			return &bt_mesh_cdb.app_keys[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* The CDB is filled in before the first encode */
+__attribute__((constructor)) static void stubs_init(void)
+{
+	cdb_init();
+}
+
+const char *gw_cloud_get_id(void)
+{
+	return "nrf-352656100000000";
+}
+
+const char *btmesh_get_op_str(enum btmesh_op op)
+{
+	switch (op) {
+	case BTMESH_OP_COMP_GET:
+		return "comp_get";
+	case BTMESH_OP_RELAY_SET:
+		return "relay_set";
+	case BTMESH_OP_APP_KEY_ADD:
+		return "app_key_add";
+	case BTMESH_OP_MOD_APP_BIND:
+		return "mod_app_bind";
+	case BTMESH_OP_MOD_APP_UNBIND:
+		return "mod_app_unbind";
+	case BTMESH_OP_MOD_PUB_SET:
+		return "mod_pub_set";
+	case BTMESH_OP_MOD_SUB_ADD:
+		return "mod_sub_add";
+	case BTMESH_OP_MOD_SUB_DEL:
+		return "mod_sub_del";
+	default:
+		return "op";
+	}
+}
+
+uint8_t btmesh_get_op_status(enum btmesh_op op, const union btmesh_op_args *args)
+{
+	switch (op) {
+	case BTMESH_OP_MOD_APP_BIND:
+		return args->mod_app_bind.status;
+	case BTMESH_OP_MOD_PUB_SET:
+		return args->mod_pub_set.status;
+	case BTMESH_OP_MOD_SUB_ADD:
+		return args->mod_sub_add.status;
+	default:
+		return 0;
+	}
+}
+
+const char *btmesh_get_oob_str(bt_mesh_prov_oob_info_t oob_info)
+{
+	switch (oob_info) {
+	case BT_MESH_PROV_OOB_OTHER:
+		return "OTHER";
+	case BT_MESH_PROV_OOB_URI:
+		return "URI";
+	default:
+		return NULL;
+	}
+}
+
+uint8_t btmesh_get_pub_period(uint8_t period)
+{
+	return period & 0x3F;
+}
+
+char *btmesh_get_pub_period_unit_str(uint8_t period)
+{
+	static char *const units[] = { "100ms", "1s", "10s", "10m" };
+
+	return units[period >> 6];
+}
+
+const char *cfg_txn_step_state_str(enum cfg_txn_step_state state)
+{
+	static const char *const states[] = {
+		[CFG_TXN_STEP_PENDING] = "pending",
+		[CFG_TXN_STEP_DONE] = "done",
+		[CFG_TXN_STEP_FAILED] = "failed",
+		[CFG_TXN_STEP_ROLLED_BACK] = "rolledBack",
+		[CFG_TXN_STEP_ROLLBACK_FAILED] = "rollbackFailed",
+	};
+
+	return states[state];
+}
+
+const char *fanout_state_str(enum fanout_state state)
+{
+	static const char *const states[] = {
+		[FANOUT_IDLE] = "idle",
+		[FANOUT_RUNNING] = "running",
+		[FANOUT_DONE] = "done",
+		[FANOUT_CANCELLED] = "cancelled",
+	};
+
+	return states[state];
+}
+
+const char *sweep_state_str(enum sweep_state state)
+{
+	static const char *const states[] = {
+		[SWEEP_IDLE] = "idle",
+		[SWEEP_RUNNING] = "running",
+		[SWEEP_PAUSED] = "paused",
+		[SWEEP_DONE] = "done",
+		[SWEEP_STOPPED] = "stopped",
+	};
+
+	return states[state];
+}
+
+const char *uplink_action_str(enum uplink_action action)
+{
+	static const char *const actions[] = {
+		[UPLINK_ACTION_FORWARD] = "forward",
+		[UPLINK_ACTION_DROP] = "drop",
+		[UPLINK_ACTION_SAMPLE] = "sample",
+		[UPLINK_ACTION_PRIORITY] = "priority",
+	};
+
+	return action < UPLINK_ACTION_COUNT ? actions[action] : NULL;
+}
+
+/* Sixteen beacons, so a beacon list spans more than one page with a small buffer */
+#define BEACON_COUNT 16
+
+int beacon_table_get(size_t idx, struct beacon_info *info)
+{
+	if (idx >= BEACON_COUNT) {
+		return -ENOENT;
+	}
+
+	memset(info, 0, sizeof(*info));
+	memset(info->uuid, 0x10 + idx, sizeof(info->uuid));
+	info->oob_info = (idx & 1) ? BT_MESH_PROV_OOB_URI : BT_MESH_PROV_OOB_OTHER;
+	info->uri_hash_set = idx & 1;
+	info->uri_hash = info->uri_hash_set ? 0x12345678 + idx : 0;
+	return 0;
+}
+
+size_t beacon_table_count(void)
+{
+	return BEACON_COUNT;
+}
+
+#define BLOCK_COUNT 4
+
+int beacon_block_get(size_t idx, uint8_t uuid[UUID_LEN])
+{
+	if (idx >= BLOCK_COUNT) {
+		return -ENOENT;
+	}
+
+	memset(uuid, 0xb0 + idx, UUID_LEN);
+	return 0;
+}
+
+size_t beacon_block_count(void)
+{
+	return BLOCK_COUNT;
+}
+
+static const struct sub_range sub_ranges[] = {
+	{ .first = 0xC000, .last = 0xC000 },
+	{ .first = 0xC010, .last = 0xC01F },
+	{ .first = 0xFFFF, .last = 0xFFFF },
+};
+
+int sub_set_get(enum btmesh_sub_type type, size_t idx, struct sub_range *range)
+{
+	if (idx >= ARRAY_SIZE(sub_ranges)) {
+		return -ENOENT;
+	}
+
+	*range = sub_ranges[idx];
+	return 0;
+}
+
+size_t sub_set_count(enum btmesh_sub_type type)
+{
+	return ARRAY_SIZE(sub_ranges);
+}
+
+static const struct uplink_rule uplink_rules[] = {
+	{
+		.match = UPLINK_MATCH_OPCODE | UPLINK_MATCH_SRC,
+		.action = UPLINK_ACTION_PRIORITY,
+		.flags = UPLINK_FLAG_DECODE,
+		.opcode = 0x8204,
+		.src_first = 0x0002,
+		.src_last = 0x0010,
+	},
+	{
+		.match = UPLINK_MATCH_PREFIX,
+		.action = UPLINK_ACTION_SAMPLE,
+		.sample_rate = 10,
+		.prefix_len = 2,
+		.prefix = { 0x01, 0x02 },
+	},
+	{
+		.match = UPLINK_MATCH_DST | UPLINK_MATCH_APP_IDX,
+		.action = UPLINK_ACTION_DROP,
+		.dst_first = 0xC000,
+		.dst_last = 0xC0FF,
+		.app_idx = 0x0001,
+	},
+};
+
+int uplink_rules_get(size_t idx, struct uplink_rule *rule, uint32_t *hit_count)
+{
+	if (idx >= ARRAY_SIZE(uplink_rules)) {
+		return -ENOENT;
+	}
+
+	*rule = uplink_rules[idx];
+	*hit_count = 100 * idx;
+	return 0;
+}
+
+size_t uplink_rules_count(void)
+{
+	return ARRAY_SIZE(uplink_rules);
+}
+
+/* Slot 1 of the allowlist and the profiles is unused */
+#define SLOT_COUNT 3
+
+int prov_allow_get(size_t idx, struct prov_allow_entry *entry)
+{
+	if (idx >= SLOT_COUNT) {
+		return -EINVAL;
+	}
+
+	if (idx == 1) {
+		return -ENOENT;
+	}
+
+	memset(entry, 0, sizeof(*entry));
+	memset(entry->uuid_prefix, 0xc0 + idx, sizeof(entry->uuid_prefix));
+	entry->uuid_prefix_len = idx ? 4 : UUID_LEN;
+	entry->elem_count = 1 + idx;
+	return 0;
+}
+
+int prov_profile_get(size_t idx, struct prov_profile_info *info)
+{
+	if (idx >= SLOT_COUNT) {
+		return -EINVAL;
+	}
+
+	if (idx == 1) {
+		return -ENOENT;
+	}
+
+	memset(info, 0, sizeof(*info));
+	snprintf(info->name, sizeof(info->name), "profile%zu", idx);
+	memset(info->match.uuid_prefix, 0xd0, 3);
+	info->match.uuid_prefix_len = 3;
+	info->match.cid_set = true;
+	info->match.cid = 0x0059;
+	info->match.pid_set = idx != 0;
+	info->match.pid = 0x0001;
+	return 0;
+}
+
+int reconcile_summary_get(size_t idx, struct reconcile_summary *summary)
+{
+	if (idx >= SLOT_COUNT) {
+		return -EINVAL;
+	}
+
+	if (idx == 1) {
+		return -ENOENT;
+	}
+
+	memset(summary, 0, sizeof(*summary));
+	snprintf(summary->name, sizeof(summary->name), "state%zu", idx);
+	summary->node_count = 10;
+	summary->converged = 7;
+	summary->pending = 2;
+	summary->failed = 1;
+	summary->drift = 3;
+	summary->ops = 42;
+	return 0;
+}
+
+int reconcile_node_get(size_t idx, struct reconcile_node_status *status)
+{
+	if (idx >= 4) {
+		return -EINVAL;
+	}
+
+	memset(status, 0, sizeof(*status));
+	status->addr = 0x0002 + 2 * idx;
+	status->state_idx = (idx & 1) ? 2 : 0;
+	status->state = (idx & 1) ? RECONCILE_FAILED : RECONCILE_CONVERGED;
+	status->err = (idx & 1) ? -ETIMEDOUT : 0;
+	status->failures = (idx & 1) ? 3 : 0;
+	return 0;
+}
+
+int mesh_retry_op_stats_get(size_t op, struct mesh_retry_op_stats *stats)
+{
+	if (op >= BTMESH_OP_COUNT) {
+		return -ENOENT;
+	}
+
+	memset(stats, 0, sizeof(*stats));
+
+	if (op == BTMESH_OP_COMP_GET || op == BTMESH_OP_MOD_APP_BIND) {
+		stats->count = 20;
+		stats->fail_count = 1;
+		stats->retry_count = 4;
+		stats->timeout_count = 3;
+		stats->total_ms = 12345;
+		stats->max_ms = 2400;
+	}
+
+	return 0;
+}
+
+int mesh_retry_node_get(size_t idx, struct mesh_retry_node *node)
+{
+	if (idx >= 8) {
+		return -ENOENT;
+	}
+
+	memset(node, 0, sizeof(*node));
+
+	if (idx < 4) {
+		node->addr = 0x0002 + 2 * idx;
+		node->srtt = 180 + idx;
+		node->rttvar = 40;
+		node->rto = 1000;
+		node->sample_count = 12;
+		node->timeout_count = idx;
+	}
+
+	return 0;
+}
+
+void compress_get_stats(struct compress_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+	stats->msg_count = 40;
+	stats->skip_count = 2;
+	stats->bytes_in = 12000;
+	stats->bytes_out = 4500;
+	stats->last_ratio = 36;
+	stats->last_us = 310;
+	stats->max_us = 820;
+	stats->total_us = 12600;
+}
@@ -0,0 +1,262 @@
+/* Host unit tests of the hex, UUID, UUID index and backoff helpers, followed by a throughput
+ * benchmark of the hex conversions.
+ *
+ * test_util [-n iterations]
+ *
+ * The benchmark only reports bytes per second, the tests decide the result. */
+
+#include <zephyr.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "host.h"
+#include "util.h"
+
+#define BENCH_LEN 1024
+
+static int failures;
+
+#define CHECK(cond)                                                                  \
+	do {                                                                         \
+		if (!(cond)) {                                                       \
+			fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond);   \
+			failures++;                                                  \
+		}                                                                    \
+	} while (0)
+
+static void test_hex_valid(void)
+{
+	CHECK(util_hex_valid("", 0));
+	CHECK(util_hex_valid("0123456789abcdefABCDEF", 22));
+	CHECK(!util_hex_valid("0123456789abcdefg", 17));
+	CHECK(!util_hex_valid("x", 1));
+	CHECK(!util_hex_valid("01 3", 4));
+	/* Only the first hex_len characters are checked */
+	CHECK(util_hex_valid("01zz", 2));
+	/* Every position of a word, and the tail after the last word */
+	CHECK(!util_hex_valid("G0000", 5));
+	CHECK(!util_hex_valid("0G000", 5));
+	CHECK(!util_hex_valid("00G00", 5));
+	CHECK(!util_hex_valid("000G0", 5));
+	CHECK(!util_hex_valid("0000G", 5));
+}
+
+static void test_hex2bin(void)
+{
+	size_t i;
+	uint8_t bin[8];
+	static const uint8_t expect[8] = { 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef };
+
+	CHECK(util_hex2bin("0123456789ABCDEF", 16, bin, sizeof(bin)) == 8);
+	CHECK(!memcmp(bin, expect, sizeof(expect)));
+
+	CHECK(util_hex2bin("0123456789abcdef", 16, bin, sizeof(bin)) == 8);
+	CHECK(!memcmp(bin, expect, sizeof(expect)));
+
+	/* Tail shorter than a word */
+	CHECK(util_hex2bin("a5c3f0", 6, bin, sizeof(bin)) == 3);
+	CHECK(bin[0] == 0xa5 && bin[1] == 0xc3 && bin[2] == 0xf0);
+
+	CHECK(util_hex2bin("", 0, bin, sizeof(bin)) == 0);
+	CHECK(util_hex2bin("012", 3, bin, sizeof(bin)) == -EINVAL);
+	CHECK(util_hex2bin("0123456789abcdef00", 18, bin, sizeof(bin)) == -ENOBUFS);
+
+	/* A bad character anywhere must leave bin untouched, even after whole valid words */
+	for (i = 0; i < 16; i++) {
+		char hex[17] = "0123456789abcdef";
+
+		hex[i] = 'x';
+		memset(bin, 0x5a, sizeof(bin));
+		CHECK(util_hex2bin(hex, 16, bin, sizeof(bin)) == -EINVAL);
+		CHECK(bin[0] == 0x5a && bin[7] == 0x5a);
+	}
+}
+
+static void test_bin2hex(void)
+{
+	char hex[20];
+	static const uint8_t bin[7] = { 0x00, 0x1f, 0xa0, 0xff, 0x12, 0x34, 0x56 };
+
+	CHECK(util_bin2hex(bin, sizeof(bin), hex, sizeof(hex)) == 14);
+	CHECK(!strcmp(hex, "001fa0ff123456"));
+
+	CHECK(util_bin2hex(bin, 0, hex, sizeof(hex)) == 0);
+	CHECK(hex[0] == '\0');
+
+	/* Needs room for the terminator */
+	CHECK(util_bin2hex(bin, sizeof(bin), hex, 14) == -ENOBUFS);
+	CHECK(util_bin2hex(bin, sizeof(bin), hex, 15) == 14);
+}
+
+static void test_uuid(void)
+{
+	uint8_t uuid[UUID_LEN];
+	uint8_t other[UUID_LEN];
+	char str[UUID_STR_LEN];
+
+	CHECK(util_uuid_valid("4df5fa66d7eb44b98000000000000001"));
+	CHECK(!util_uuid_valid("4df5fa66d7eb44b9800000000000000"));
+	CHECK(!util_uuid_valid("4df5fa66d7eb44b980000000000000011"));
+	CHECK(!util_uuid_valid("4df5fa66d7eb44b9800000000000000g"));
+	CHECK(!util_uuid_valid(NULL));
+
+	CHECK(util_str2uuid("4DF5FA66D7EB44B98000000000000001", uuid) == 0);
+	CHECK(uuid[0] == 0x4d && uuid[15] == 0x01);
+	util_uuid2str(uuid, str);
+	CHECK(!strcmp(str, "4df5fa66d7eb44b98000000000000001"));
+
+	memset(uuid, 0x5a, sizeof(uuid));
+	CHECK(util_str2uuid("4df5fa66d7eb44b9800000000000000g", uuid) == -EINVAL);
+	CHECK(uuid[0] == 0x5a);
+	CHECK(util_str2uuid("4df5", uuid) == -EINVAL);
+	CHECK(util_str2uuid(NULL, uuid) == -EINVAL);
+
+	util_str2uuid("4df5fa66d7eb44b98000000000000001", uuid);
+	util_uuid_cpy(other, uuid);
+	CHECK(util_uuid_cmp(uuid, other) == 0);
+	other[15]++;
+	CHECK(util_uuid_cmp(uuid, other) < 0);
+}
+
+static void test_uuid_index(void)
+{
+	bool found;
+	size_t i;
+	uint8_t uuid[UUID_LEN];
+	/* Stored out of order, with a stride wider than the UUID */
+	static uint8_t table[4][UUID_LEN + 3];
+	static const uint16_t sorted[4] = { 2, 0, 3, 1 };
+
+	for (i = 0; i < ARRAY_SIZE(sorted); i++) {
+		memset(table[sorted[i]], 0, sizeof(table[0]));
+		table[sorted[i]][UUID_LEN - 1] = (i + 1) * 2;
+	}
+
+	memset(uuid, 0, sizeof(uuid));
+	uuid[UUID_LEN - 1] = 6;
+	CHECK(util_uuid_search(table[0], sizeof(table[0]), sorted, 4, uuid, &found) == 2);
+	CHECK(found);
+
+	uuid[UUID_LEN - 1] = 5;
+	CHECK(util_uuid_search(table[0], sizeof(table[0]), sorted, 4, uuid, &found) == 2);
+	CHECK(!found);
+
+	uuid[UUID_LEN - 1] = 9;
+	CHECK(util_uuid_search(table[0], sizeof(table[0]), sorted, 4, uuid, &found) == 4);
+	CHECK(!found);
+	CHECK(util_uuid_search(table[0], sizeof(table[0]), sorted, 0, uuid, &found) == 0);
+	CHECK(!found);
+
+	/* FNV-1a of sixteen zero bytes */
+	memset(uuid, 0, sizeof(uuid));
+	CHECK(util_uuid_hash(uuid) == 0x69691905);
+}
+
+static void test_key(void)
+{
+	uint8_t key[KEY_LEN];
+	char str[KEY_STR_LEN];
+
+	CHECK(util_key_valid("0953fa93e7caac9638f58820220a398e"));
+	CHECK(!util_key_valid("0953fa93e7caac9638f58820220a398"));
+
+	CHECK(util_str2key("0953fa93e7caac9638f58820220a398e", key) == 0);
+	CHECK(key[0] == 0x09 && key[15] == 0x8e);
+	util_key2str(key, str);
+	CHECK(!strcmp(str, "0953fa93e7caac9638f58820220a398e"));
+}
+
+static void test_backoff(void)
+{
+	CHECK(util_backoff(10, 3600, 0) == 0);
+	CHECK(util_backoff(10, 3600, 1) == 10);
+	CHECK(util_backoff(10, 3600, 2) == 20);
+	CHECK(util_backoff(10, 3600, 5) == 160);
+	CHECK(util_backoff(10, 3600, 10) == 3600);
+	/* The shift stops growing, a large count neither overflows nor wraps around */
+	CHECK(util_backoff(10, 3600, 255) == 3600);
+	CHECK(util_backoff(1000, UINT32_MAX, 40) == 1000UL << 16);
+	CHECK(util_backoff(0xffffffff, UINT32_MAX, 17) == UINT32_MAX);
+	CHECK(util_backoff(500, 100, 1) == 100);
+}
+
+static void bench(long iterations)
+{
+	long n;
+	size_t i;
+	uint64_t start;
+	double secs;
+	static uint8_t bin[BENCH_LEN];
+	static char hex[(BENCH_LEN * 2) + 1];
+
+	for (i = 0; i < BENCH_LEN; i++) {
+		bin[i] = i * 7;
+	}
+
+	start = host_time_ns();
+
+	for (n = 0; n < iterations; n++) {
+		util_bin2hex(bin, BENCH_LEN, hex, sizeof(hex));
+	}
+
+	secs = (double)(host_time_ns() - start) / 1e9;
+	printf("%-10s %10.1f MB/s of binary\n", "bin2hex", BENCH_LEN * iterations / secs / 1e6);
+
+	start = host_time_ns();
+
+	for (n = 0; n < iterations; n++) {
+		util_hex2bin(hex, BENCH_LEN * 2, bin, BENCH_LEN);
+	}
+
+	secs = (double)(host_time_ns() - start) / 1e9;
+	printf("%-10s %10.1f MB/s of binary\n", "hex2bin", BENCH_LEN * iterations / secs / 1e6);
+
+	start = host_time_ns();
+
+	for (n = 0; n < iterations; n++) {
+		util_hex_valid(hex, BENCH_LEN * 2);
+	}
+
+	secs = (double)(host_time_ns() - start) / 1e9;
+	printf("%-10s %10.1f MB/s of hex\n", "hex_valid", BENCH_LEN * 2 * iterations / secs / 1e6);
+}
+
+int main(int argc, char **argv)
+{
+	int opt;
+	long iterations = 10000;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			iterations = strtol(optarg, NULL, 0);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-n iterations]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (iterations < 1) {
+		iterations = 1;
+	}
+
+	test_hex_valid();
+	test_hex2bin();
+	test_bin2hex();
+	test_uuid();
+	test_uuid_index();
+	test_key();
+	test_backoff();
+
+	if (failures) {
+		fprintf(stderr, "%d checks failed\n", failures);
+		return 1;
+	}
+
+	bench(iterations);
+	return 0;
+}